@@ -0,0 +1,374 @@
+/**
+ * @file CBasicKeyValueStorage.hpp
+ * @brief KeyValueStorage facade bound to one backend type at compile time
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * KeyValueStorage picks its backend at run time and reaches it through an
+ * IKvsBackend pointer. For a caller that always uses the same backend,
+ * BasicKeyValueStorage<Backend> holds the backend by value instead:
+ *
+ *   BasicKeyValueStorage< KvsMemoryBackend > scratch;
+ *   scratch.SetValue( "speed", 12.5f );
+ *   auto speed = scratch.GetValue< core::Float >( "speed" );
+ *
+ * Every call resolves to the backend's own member function: no virtual
+ * dispatch, and available() and notification checks inline to plain loads.
+ * Backend functions defined in headers inline completely: KvsMemoryBackend's
+ * get and set are, so its hot path compiles down to the map lookup. For the
+ * other backends (e.g. util::KvsPropertyBackend) the calls become direct
+ * calls into the library. The API is the same as KeyValueStorage's;
+ * KeyValueStorage stays the default for storages opened through
+ * OpenKeyValueStorage().
+ */
+#ifndef LAP_PERSISTENCY_BASICKEYVALUESTORAGE_HPP
+#define LAP_PERSISTENCY_BASICKEYVALUESTORAGE_HPP
+
+#include <type_traits>
+#include <utility>
+
+#include <lap/core/CMemory.hpp>
+
+#include "CDataType.hpp"
+#include "CKvsGroupCommit.hpp"
+#include "CKvsKey.hpp"
+#include "CKvsNotifier.hpp"
+#include "CKvsSnapshot.hpp"
+#include "IKvsBackend.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Key-value storage with a statically bound backend
+     * @tparam Backend Concrete IKvsBackend, declared final so calls through references devirtualize too
+     *
+     * Thread safety is the backend's, as with KeyValueStorage.
+     */
+    template< class Backend >
+    class BasicKeyValueStorage final
+    {
+        static_assert( ::std::is_base_of< IKvsBackend, Backend >::value, "Backend must implement IKvsBackend" );
+        static_assert( ::std::is_final< Backend >::value, "Backend must be final, or calls through it stay virtual" );
+
+    public:
+        IMP_OPERATOR_NEW(BasicKeyValueStorage)
+
+        using BackendType = Backend;
+
+        /// Constructs the backend in place from @p args; throws what the backend's constructor throws
+        template< class... Args >
+        explicit BasicKeyValueStorage( Args&&... args )
+            : m_backend( ::std::forward< Args >( args )... )
+        {
+            ;
+        }
+
+        BasicKeyValueStorage( const BasicKeyValueStorage& ) = delete;
+        BasicKeyValueStorage& operator=( const BasicKeyValueStorage& ) = delete;
+
+        inline core::Bool                                               available() const noexcept                          { return m_backend.available(); }
+        // Backend-specific extensions (statistics, options) without a cast
+        inline Backend&                                                 GetBackend() noexcept                               { return m_backend; }
+        inline const Backend&                                           GetBackend() const noexcept                         { return m_backend; }
+
+        core::Result< core::Vector< core::String > > GetAllKeys() const noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::Vector< core::String > >::FromError( PerErrc::kNotInitialized );
+            return m_backend.GetAllKeys();
+        }
+
+        core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+            return m_backend.KeyExists( key );
+        }
+
+        template< class T >
+        core::Result< T > GetValue( core::StringView key ) const noexcept
+        {
+            using result = core::Result< T >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.GetValue( key );
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+            return extract< T >( ::std::move( retValue.Value() ) );
+        }
+
+        template< class T >
+        core::Result< void > SetValue( core::StringView key, const T& value ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.SetValue( key, KvsDataType{ value } );
+            if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        // Rvalue set: the value's buffers are moved down to the backend instead of copied
+        template< class T, typename = ::std::enable_if_t< !::std::is_reference< T >::value > >
+        core::Result< void > SetValue( core::StringView key, T&& value ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.SetValue( key, KvsDataType{ ::std::move( value ) } );
+            if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        // Read into an existing object: strings, blobs and arrays keep their capacity
+        template< class T >
+        core::Result< void > GetValue( core::StringView key, T& out ) const noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            KvsDataType slot{ ::std::move( out ) };
+            auto assigned = m_backend.GetValueAssign( key, slot );
+            out = ::std::move( ::lap::core::get< T >( slot ) );
+            return assigned;
+        }
+
+        // Typed key access: precomputed hash, type fixed at compile time
+        template< class T >
+        core::Result< T > GetValue( const KvsKey< T >& key ) const noexcept
+        {
+            using result = core::Result< T >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.GetValueHashed( key.Name(), key.Hash() );
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+            return extract< T >( ::std::move( retValue.Value() ) );
+        }
+
+        template< class T >
+        core::Result< void > SetValue( const KvsKey< T >& key, const typename KvsKey< T >::ValueType& value ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.SetValueHashed( key.Name(), key.Hash(), KvsDataType{ value } );
+            if ( retValue.HasValue() ) notify( key.Name(), KvsChangeType::kSet );
+            return retValue;
+        }
+
+        // Resolved runtime key: caches the backend location, re-resolved after remove / reload
+        core::Result< KvsKeyHandle > Resolve( core::StringView key ) const noexcept
+        {
+            using result = core::Result< KvsKeyHandle >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            try {
+                KvsKeyHandle handle( key );
+                m_backend.ResolveKey( handle );
+                return result::FromValue( ::std::move( handle ) );
+            } catch ( const ::std::exception& ) {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+        }
+
+        template< class T >
+        core::Result< T > GetValue( const KvsKeyHandle& handle ) const noexcept
+        {
+            using result = core::Result< T >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.GetValueResolved( handle );
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+            return extract< T >( ::std::move( retValue.Value() ) );
+        }
+
+        template< class T >
+        core::Result< void > SetValue( const KvsKeyHandle& handle, const T& value ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.SetValueResolved( handle, KvsDataType{ value } );
+            if ( retValue.HasValue() ) notify( handle.Name(), KvsChangeType::kSet );
+            return retValue;
+        }
+
+        // Read a numeric array (or UInt8 blob) into caller memory without allocating, returns element count
+        template< class T >
+        core::Result< core::Size > GetValueInto( core::StringView key, core::Span< T > buffer ) const noexcept
+        {
+            using result = core::Result< core::Size >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.GetValueInto( key, KvsArrayType< T >::value,
+                                                    core::Span< core::Byte >( reinterpret_cast< core::Byte* >( buffer.data() ), buffer.size() * sizeof( T ) ) );
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+            return result::FromValue( retValue.Value() / sizeof( T ) );
+        }
+
+        // Atomic read-modify-write, each a single backend step (no external lock needed)
+        template< class T >
+        core::Result< T > FetchAdd( core::StringView key, const T& delta ) noexcept
+        {
+            using result = core::Result< T >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.FetchAdd( key, KvsDataType{ delta } );
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+
+            auto previous = extract< T >( ::std::move( retValue.Value() ) );
+            if ( previous.HasValue() ) notify( key, KvsChangeType::kSet );
+            return previous;
+        }
+
+        template< class T >
+        core::Result< core::Bool > CompareExchange( core::StringView key, const T& expected, const T& desired ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.CompareExchange( key, KvsDataType{ expected }, KvsDataType{ desired } );
+            if ( retValue.HasValue() && retValue.Value() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        template< class T >
+        core::Result< core::Bool > SetIfAbsent( core::StringView key, const T& value ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.SetIfAbsent( key, KvsDataType{ value } );
+            if ( retValue.HasValue() && retValue.Value() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        // Read-only view pinned to the current version
+        core::Result< KvsSnapshot > Snapshot() const noexcept
+        {
+            using result = core::Result< KvsSnapshot >;
+
+            if ( !m_backend.available() ) return result::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.CreateSnapshot();
+            if ( !retValue.HasValue() ) return result::FromError( retValue.Error() );
+            return result::FromValue( KvsSnapshot( ::std::move( retValue.Value() ) ) );
+        }
+
+        core::Result< void > RemoveKey( core::StringView key ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.RemoveKey( key );
+            if ( retValue.HasValue() ) notify( key, KvsChangeType::kRemove );
+            return retValue;
+        }
+
+        core::Result< void > RecoverKey( core::StringView key ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.RecoverKey( key );
+            if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        core::Result< void > ResetKey( core::StringView key ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.ResetKey( key );
+            if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+            return retValue;
+        }
+
+        core::Result< void > RemoveAllKeys() noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.RemoveAllKeys();
+            if ( retValue.HasValue() ) notify( "", KvsChangeType::kRemoveAll );
+            return retValue;
+        }
+
+        core::Result< void > SyncToStorage() noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+            return m_groupCommit.Sync( [this]() { return m_backend.SyncToStorage(); } );
+        }
+
+        core::Result< KvsSyncProgress > SyncToStorage( const KvsSyncBudget& budget ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< KvsSyncProgress >::FromError( PerErrc::kNotInitialized );
+
+            KvsSyncMeter meter( budget );
+            return m_backend.SyncToStorage( meter );
+        }
+
+        core::Result< core::UInt64 > Export( IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE ) const noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::UInt64 >::FromError( PerErrc::kNotInitialized );
+            return m_backend.Export( sink, batchSize );
+        }
+
+        core::Result< core::UInt64 > Import( IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions() ) noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< core::UInt64 >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.Import( source, options );
+            if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+            return retValue;
+        }
+
+        void                                                            SetGroupCommitWindow( core::UInt32 windowUs ) noexcept  { m_groupCommit.SetWindow( windowUs ); }
+        core::Result< KvsGroupCommitStatistics >                        GetGroupCommitStatistics() const noexcept
+        {
+            return core::Result< KvsGroupCommitStatistics >::FromValue( m_groupCommit.GetStatistics() );
+        }
+
+        core::Result< void > DiscardPendingChanges() noexcept
+        {
+            if ( !m_backend.available() ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+            auto retValue = m_backend.DiscardPendingChanges();
+            if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+            return retValue;
+        }
+
+        // Change notifications, same semantics as KeyValueStorage
+        core::Result< KvsSubscriptionId > Subscribe( core::StringView prefix, KvsChangeCallback callback ) noexcept
+        {
+            return m_notifier.Subscribe( prefix, ::std::move( callback ) );
+        }
+
+        core::Result< KvsSubscriptionId > Subscribe( const core::Vector< core::String >& keys, KvsChangeCallback callback ) noexcept
+        {
+            return m_notifier.Subscribe( keys, ::std::move( callback ) );
+        }
+
+        core::Result< void >                                            Unsubscribe( KvsSubscriptionId id ) noexcept        { return m_notifier.Unsubscribe( id ); }
+        void                                                            FlushNotifications() noexcept                       { m_notifier.Flush(); }
+
+    private:
+        // Index compare instead of a throwing get<T>()
+        template< class T >
+        static core::Result< T > extract( KvsDataType&& value ) noexcept
+        {
+            if ( ::lap::core::GetVariantIndex( value ) != KvsKey< T >::Index ) return core::Result< T >::FromError( PerErrc::kDataTypeMismatch );
+            return core::Result< T >::FromValue( ::lap::core::get< T >( ::std::move( value ) ) );
+        }
+
+        void notify( core::StringView key, KvsChangeType type ) noexcept
+        {
+            if ( m_notifier.HasSubscribers() ) m_notifier.Publish( key, type );
+        }
+
+    private:
+        Backend                                                         m_backend;
+        KvsNotifier                                                     m_notifier;
+        KvsGroupCommit                                                  m_groupCommit;
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_BASICKEYVALUESTORAGE_HPP
@@ -11,6 +11,9 @@
 #define LAP_PERSISTENCY_DATATYPE_HPP
 
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 // core
 #include <lap/core/CTypedef.hpp>
@@ -51,22 +54,78 @@ namespace per
     #define LAP_PER_LOG_CONTEXT_ID       "PM"
     #define LAP_PER_LOG_CONTEXT_DESC     "PM log ctx"
 
-    #define LAP_DEBUG
+    // Build-time log levels. Statements above LAP_PER_LOG_LEVEL compile to a
+    // dead branch: the stream operands are never evaluated.
+    #define LAP_PER_LOG_LEVEL_OFF        0
+    #define LAP_PER_LOG_LEVEL_FATAL      1
+    #define LAP_PER_LOG_LEVEL_ERROR      2
+    #define LAP_PER_LOG_LEVEL_WARN       3
+    #define LAP_PER_LOG_LEVEL_INFO       4
+    #define LAP_PER_LOG_LEVEL_DEBUG      5
+    #define LAP_PER_LOG_LEVEL_VERBOSE    6
+
+#ifndef LAP_PER_LOG_LEVEL
+  #ifdef LAP_DEBUG
+    #define LAP_PER_LOG_LEVEL            LAP_PER_LOG_LEVEL_VERBOSE
+  #else
+    #define LAP_PER_LOG_LEVEL            LAP_PER_LOG_LEVEL_WARN
+  #endif
+#endif
+
+    // LEVEL is pasted right here: an intermediate macro would expand it first,
+    // and a project-wide `-DDEBUG` or a platform `#define ERROR` would break the paste
+    #define LAP_PER_LOG_ENABLED( LEVEL ) ( LAP_PER_LOG_LEVEL >= LAP_PER_LOG_LEVEL_##LEVEL )
 
-#ifdef LAP_DEBUG
+#if LAP_PER_LOG_LEVEL >= LAP_PER_LOG_LEVEL_VERBOSE
     #define LAP_PER_LOG                  LAP_LOG( LAP_PER_LOG_CONTEXT_ID, LAP_PER_LOG_CONTEXT_DESC, ::lap::log::LogLevel::kVerbose )
-    #define LAP_PER_LOG_VERBOSE          LAP_PER_LOG.LogVerbose().WithLocation( __FILE__, __LINE__ )
-    #define LAP_PER_LOG_DEBUG            LAP_PER_LOG.LogDebug().WithLocation( __FILE__, __LINE__ )
-    #define LAP_PER_LOG_INFO             LAP_PER_LOG.LogInfo().WithLocation( __FILE__, __LINE__ )
+#elif LAP_PER_LOG_LEVEL >= LAP_PER_LOG_LEVEL_DEBUG
+    #define LAP_PER_LOG                  LAP_LOG( LAP_PER_LOG_CONTEXT_ID, LAP_PER_LOG_CONTEXT_DESC, ::lap::log::LogLevel::kDebug )
+#elif LAP_PER_LOG_LEVEL >= LAP_PER_LOG_LEVEL_INFO
+    #define LAP_PER_LOG                  LAP_LOG( LAP_PER_LOG_CONTEXT_ID, LAP_PER_LOG_CONTEXT_DESC, ::lap::log::LogLevel::kInfo )
 #else
     #define LAP_PER_LOG                  LAP_LOG( LAP_PER_LOG_CONTEXT_ID, LAP_PER_LOG_CONTEXT_DESC, ::lap::log::LogLevel::kWarn )
-    #define LAP_PER_LOG_VERBOSE          LAP_PER_LOG.LogOff()
-    #define LAP_PER_LOG_DEBUG            LAP_PER_LOG.LogOff()
-    #define LAP_PER_LOG_INFO             LAP_PER_LOG.LogOff()
 #endif
-    #define LAP_PER_LOG_WARN             LAP_PER_LOG.LogWarn().WithLocation( __FILE__, __LINE__ )
-    #define LAP_PER_LOG_ERROR            LAP_PER_LOG.LogError().WithLocation( __FILE__, __LINE__ )
-    #define LAP_PER_LOG_FATAL            LAP_PER_LOG.LogFatal().WithLocation( __FILE__, __LINE__ )
+
+    // `if ( disabled ) {} else <stream>` keeps `LAP_PER_LOG_X << a << b;` and
+    // `LAP_PER_LOG_X.logFormat(...)` syntax and is safe inside unbraced if/else
+    // Takes the numeric LAP_PER_LOG_LEVEL_* value, never a level name
+    #define LAP_PER_LOG_IF_LEVEL( LEVEL_VALUE, COND )   if ( !( LAP_PER_LOG_LEVEL >= ( LEVEL_VALUE ) && ( COND ) ) ) {} else
+
+    #define LAP_PER_LOG_VERBOSE          LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_VERBOSE, true ) LAP_PER_LOG.LogVerbose().WithLocation( __FILE__, __LINE__ )
+    #define LAP_PER_LOG_DEBUG            LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_DEBUG, true ) LAP_PER_LOG.LogDebug().WithLocation( __FILE__, __LINE__ )
+    #define LAP_PER_LOG_INFO             LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_INFO, true ) LAP_PER_LOG.LogInfo().WithLocation( __FILE__, __LINE__ )
+    #define LAP_PER_LOG_WARN             LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_WARN, true ) LAP_PER_LOG.LogWarn().WithLocation( __FILE__, __LINE__ )
+    #define LAP_PER_LOG_ERROR            LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_ERROR, true ) LAP_PER_LOG.LogError().WithLocation( __FILE__, __LINE__ )
+    #define LAP_PER_LOG_FATAL            LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_FATAL, true ) LAP_PER_LOG.LogFatal().WithLocation( __FILE__, __LINE__ )
+
+    // Hot-path logging: per call site, emit only every N-th hit / at most once per interval.
+    // Sampling state is only touched when LEVEL is compiled in.
+    #define LAP_PER_LOG_SITE_STATE( TYPE, INIT ) \
+        ( []() noexcept -> ::std::atomic< TYPE >& { static ::std::atomic< TYPE > s_state{ INIT }; return s_state; }() )
+
+    #define LAP_PER_LOG_EVERY_N( LEVEL, N ) \
+        LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_##LEVEL, ::lap::per::detail::logEveryN( LAP_PER_LOG_SITE_STATE( ::lap::core::UInt32, 0U ), ( N ) ) ) LAP_PER_LOG_##LEVEL
+
+    #define LAP_PER_LOG_EVERY_MS( LEVEL, MS ) \
+        LAP_PER_LOG_IF_LEVEL( LAP_PER_LOG_LEVEL_##LEVEL, ::lap::per::detail::logEveryMs( LAP_PER_LOG_SITE_STATE( ::lap::core::Int64, INT64_MIN ), ( MS ) ) ) LAP_PER_LOG_##LEVEL
+
+    namespace detail
+    {
+        inline core::Bool logEveryN( ::std::atomic< core::UInt32 >& counter, core::UInt32 n ) noexcept
+        {
+            return ( counter.fetch_add( 1U, ::std::memory_order_relaxed ) % ( n == 0U ? 1U : n ) ) == 0U;
+        }
+
+        inline core::Bool logEveryMs( ::std::atomic< core::Int64 >& lastMs, core::Int64 intervalMs ) noexcept
+        {
+            core::Int64 now = ::std::chrono::duration_cast< ::std::chrono::milliseconds >(
+                ::std::chrono::steady_clock::now().time_since_epoch() ).count();
+            core::Int64 last = lastMs.load( ::std::memory_order_relaxed );
+            if ( last != INT64_MIN && now - last < intervalMs ) return false;
+            // Only one thread wins the slot for this interval
+            return lastMs.compare_exchange_strong( last, now, ::std::memory_order_relaxed );
+        }
+    } // namespace detail
 
     // ========================================================================
     // AUTOSAR File Storage Default Configuration
@@ -243,6 +302,21 @@ namespace per
         return ::std::ios_base::beg;
     }
 
+    // Raw byte array value (calibration data, certificates, ...), stored natively by every backend
+    using KvsBlob = core::Vector< core::Byte >;
+
+    // Homogeneous numeric arrays (lookup tables, ...), stored as contiguous raw element bytes.
+    // UInt8 tables use KvsBlob (core::Byte may alias core::UInt8, a variant cannot hold both)
+    using KvsInt8Array      = core::Vector< core::Int8 >;
+    using KvsInt16Array     = core::Vector< core::Int16 >;
+    using KvsUInt16Array    = core::Vector< core::UInt16 >;
+    using KvsInt32Array     = core::Vector< core::Int32 >;
+    using KvsUInt32Array    = core::Vector< core::UInt32 >;
+    using KvsInt64Array     = core::Vector< core::Int64 >;
+    using KvsUInt64Array    = core::Vector< core::UInt64 >;
+    using KvsFloatArray     = core::Vector< core::Float >;
+    using KvsDoubleArray    = core::Vector< core::Double >;
+
     using KvsDataType = core::Variant< \
                             core::Int8, core::UInt8, \
                             core::Int16, core::UInt16, \
@@ -250,7 +324,13 @@ namespace per
                             core::Int64, core::UInt64, \
                             core::Bool, \
                             core::Float, core::Double, \
-                            core::String >;
+                            core::String, \
+                            KvsBlob, \
+                            KvsInt8Array, \
+                            KvsInt16Array, KvsUInt16Array, \
+                            KvsInt32Array, KvsUInt32Array, \
+                            KvsInt64Array, KvsUInt64Array, \
+                            KvsFloatArray, KvsDoubleArray >;
 
     enum class EKvsDataTypeIndicate : core::UInt32
     { 
@@ -266,6 +346,16 @@ namespace per
         DataType_float          = 9,
         DataType_double         = 10,
         DataType_string         = 11,
+        DataType_blob           = 12,
+        DataType_int8_array     = 13,
+        DataType_int16_array    = 14,
+        DataType_uint16_array   = 15,
+        DataType_int32_array    = 16,
+        DataType_uint32_array   = 17,
+        DataType_int64_array    = 18,
+        DataType_uint64_array   = 19,
+        DataType_float_array    = 20,
+        DataType_double_array   = 21,
     };
 
     constexpr core::Bool operator== ( EKvsDataTypeIndicate left, EKvsDataTypeIndicate right )
@@ -296,12 +386,75 @@ namespace per
     core::String kvsToStrig( const KvsDataType& value );
     KvsDataType kvsFromString( const core::String &value, const EKvsDataTypeIndicate &type );
 
+    // Base64 (RFC 4648) text form of a blob, used where a backend can only hold text
+    core::String kvsBlobToBase64( const core::Byte* data, core::Size size );
+    core::Bool kvsBlobFromBase64( core::StringView text, KvsBlob &blob );
+    core::Size kvsBase64DecodedSize( core::StringView text ) noexcept;
+    core::Bool kvsBase64DecodeInto( core::StringView text, core::Byte* out, core::Size capacity ) noexcept;
+
+    // Raw types (KvsBlob and the numeric arrays) are persisted as their contiguous
+    // element bytes in host byte order, so every backend can memcpy them in and out.
+    // The file backend's JSON text is the exception: it holds them little-endian
+    constexpr core::Bool isKvsRawType( EKvsDataTypeIndicate type ) noexcept
+    {
+        return static_cast< core::UInt32 >( type ) >= static_cast< core::UInt32 >( EKvsDataTypeIndicate::DataType_blob ) &&
+               static_cast< core::UInt32 >( type ) <= static_cast< core::UInt32 >( EKvsDataTypeIndicate::DataType_double_array );
+    }
+
+    // Element size of a raw type, 0 for scalar and string types
+    core::Size kvsRawElementSize( EKvsDataTypeIndicate type ) noexcept;
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr core::Bool KVS_LITTLE_ENDIAN_HOST = false;
+#else
+    constexpr core::Bool KVS_LITTLE_ENDIAN_HOST = true;
+#endif
+
+    // Swap the elements of raw bytes between host and little-endian order in place (its own inverse);
+    // a no-op on little-endian hosts and for single-byte elements
+    void kvsRawSwapLittleEndian( EKvsDataTypeIndicate type, core::Byte* data, core::Size size ) noexcept;
+
+    // Contiguous bytes of a raw value; returns false (and leaves outputs untouched) for other types
+    core::Bool kvsRawBytes( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept;
+
+    // Rebuild a raw value from its bytes; false if type is not raw or size is not a multiple of the element size
+    core::Bool kvsFromRawBytes( EKvsDataTypeIndicate type, const core::Byte* data, core::Size size, KvsDataType &value );
+
+    // Bytes of any value as the binary backends store them: scalars in host byte order,
+    // strings as their characters, raw types as for kvsRawBytes(). The view aliases value
+    core::Bool kvsValueBytes( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept;
+
+    // Inverse of kvsValueBytes(); false if size does not fit the type
+    core::Bool kvsValueFromBytes( EKvsDataTypeIndicate type, const core::Byte* data, core::Size size, KvsDataType &value );
+
+    // current + delta for integer and floating point values of the same type (integers wrap around);
+    // false for other types or mismatching alternatives. Shared by the backends' FetchAdd()
+    core::Bool kvsAddValues( const KvsDataType &current, const KvsDataType &delta, KvsDataType &sum ) noexcept;
+
+    // Zero of the same type as like, the start value of a counter created by FetchAdd(); false if not arithmetic
+    core::Bool kvsZeroValue( const KvsDataType &like, KvsDataType &zero ) noexcept;
+
+    // Array indicator for an element type, e.g. KvsArrayType< core::Float >::value == DataType_float_array
+    template < class T > struct KvsArrayType;
+    template <> struct KvsArrayType< core::Int8 >   { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_int8_array; };
+    template <> struct KvsArrayType< core::UInt8 >  { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_blob; };
+    template <> struct KvsArrayType< core::Int16 >  { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_int16_array; };
+    template <> struct KvsArrayType< core::UInt16 > { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_uint16_array; };
+    template <> struct KvsArrayType< core::Int32 >  { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_int32_array; };
+    template <> struct KvsArrayType< core::UInt32 > { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_uint32_array; };
+    template <> struct KvsArrayType< core::Int64 >  { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_int64_array; };
+    template <> struct KvsArrayType< core::UInt64 > { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_uint64_array; };
+    template <> struct KvsArrayType< core::Float >  { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_float_array; };
+    template <> struct KvsArrayType< core::Double > { static constexpr EKvsDataTypeIndicate value = EKvsDataTypeIndicate::DataType_double_array; };
+
     enum class KvsBackendType : core::UInt32 
     {
         kvsNone             = 0,        // No persistence backend (memory-only)
         kvsFile             = 1 << 16,
         kvsSqlite           = 1 << 17,
-        kvsProperty         = 1 << 18
+        kvsProperty         = 1 << 18,
+        kvsLsm              = 1 << 19,  // Log-structured merge tree, for write-heavy instances
+        kvsMmap             = 1 << 20   // Memory-mapped copy-on-write B+tree, for read-mostly instances
     };
 
     constexpr KvsBackendType operator| ( KvsBackendType left, KvsBackendType right )
@@ -328,6 +481,27 @@ namespace per
         kFileStorage = 1       // File storage
     };
 
+    // ========================================================================
+    // SQLite Tuning Structure
+    // ========================================================================
+    
+    /**
+     * @brief PRAGMAs a SQLite instance applies when its connection is opened
+     * Defaults are the settings every instance used before they were configurable.
+     * Strings are matched case-insensitively; an invalid value keeps the default.
+     */
+    struct KvsSqliteTuning {
+        core::String journalMode{"WAL"};        // WAL, DELETE, TRUNCATE or PERSIST; snapshots block writers unless WAL
+        core::String synchronous{"NORMAL"};     // OFF, NORMAL, FULL or EXTRA
+        core::Int64 cacheSize{-10000};          // > 0: pages, < 0: KiB of page cache
+        core::UInt64 mmapSize{64ul << 20};      // Bytes of memory-mapped I/O, 0 disables it
+        core::UInt32 pageSize{0};               // Database page size, new databases only; 0 keeps SQLite's default
+        core::UInt32 walAutocheckpoint{1000};   // WAL frames that trigger a passive checkpoint, 0 leaves it to syncs
+        core::String tempStore{"DEFAULT"};      // DEFAULT, FILE or MEMORY
+        core::Bool exclusiveLocking{false};     // locking_mode=EXCLUSIVE: no shared memory or lock calls per
+                                                // transaction, but no other connection (snapshots, other processes)
+    };
+
     // ========================================================================
     // Persistency Configuration Structure
     // ========================================================================
@@ -351,6 +525,19 @@ namespace per
             core::String dataSourceType{""};
             core::Size propertyBackendShmSize{1ul << 20};  // 1MB default for Property backend
             core::String propertyBackendPersistence{"file"};  // "file" or "sqlite"
+            core::Size propertyBackendMemoryBudget{0};  // > 0 evicts LRU Property values beyond this many segment bytes
+            core::UInt32 shardCount{1};  // > 1 splits File/SQLite instances into hash shards
+            core::Size memoryPoolSize{0};  // > 0 bounds File backend data to a preallocated pool of this size
+            core::UInt32 groupCommitWindowUs{0};  // Time concurrent SyncToStorage callers are collected into one sync
+            core::String sqliteSharedDatabase{""};  // Non-empty: SQLite instances share this database, one table each
+            KvsSqliteTuning sqlite;  // PRAGMAs of SQLite instances
+            core::Map< core::String, KvsSqliteTuning > sqliteInstances;  // Replaces sqlite for these identifiers
+
+            // Tuning of a SQLite instance, or of the shared database by its identifier
+            const KvsSqliteTuning& sqliteTuning( const core::String& identifier ) const noexcept {
+                auto it = sqliteInstances.find( identifier );
+                return it != sqliteInstances.end() ? it->second : sqlite;
+            }
         } kvs;
     };
 
@@ -0,0 +1,142 @@
+/**
+ * @file CFaultInjectionFileSystem.hpp
+ * @brief Fault Injection File System - IVirtualFileSystem decorator for robustness testing
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Wraps another IVirtualFileSystem and injects, per configuration:
+ * - Read/write latency (models slow flash / eMMC)
+ * - ENOSPC once a write byte budget is exhausted (prefix that fits is persisted)
+ * - Torn writes: only a prefix of the data reaches storage (power loss mid-write)
+ * - Halt: after a fault every mutation fails until Reset() (simulated crash)
+ *
+ * Each Write() through an OpenWriter() handle is faulted like one AppendFile().
+ *
+ * Faults are deterministic for a given seed and only hit paths containing
+ * FaultInjectionConfig::pathFilter (all paths if empty).
+ */
+
+#ifndef LAP_PERSISTENCY_FAULTINJECTIONFILESYSTEM_HPP
+#define LAP_PERSISTENCY_FAULTINJECTIONFILESYSTEM_HPP
+
+#include <functional>
+#include <random>
+#include <lap/core/CSync.hpp>
+
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Fault injection configuration
+     */
+    struct FaultInjectionConfig
+    {
+        core::UInt32    readLatencyUs{ 0 };             ///< Delay added to every read
+        core::UInt32    writeLatencyUs{ 0 };            ///< Delay added to every mutation
+        core::UInt64    writeBudgetBytes{ 0 };          ///< Bytes writable before ENOSPC (0 = unlimited)
+        core::UInt32    tornWriteAt{ 0 };               ///< Tear the N-th matching write, 1-based (0 = off)
+        core::Double    tornWriteProbability{ 0.0 };    ///< Probability of tearing any matching write
+        core::Double    tornWriteFraction{ 0.5 };       ///< Fraction of data persisted by a torn write
+        core::Bool      haltAfterFault{ false };        ///< Fail all mutations after the first fault
+        core::String    pathFilter;                     ///< Only inject on paths containing this
+        core::UInt32    seed{ 0 };                      ///< RNG seed for probabilistic faults
+    };
+
+    /**
+     * @brief Injected fault statistics
+     */
+    struct FaultInjectionStats
+    {
+        core::UInt64    reads{ 0 };
+        core::UInt64    writes{ 0 };
+        core::UInt64    bytesWritten{ 0 };
+        core::UInt64    tornWrites{ 0 };
+        core::UInt64    outOfSpaceErrors{ 0 };
+        core::UInt64    haltedOperations{ 0 };
+        core::UInt64    injectedDelayUs{ 0 };
+    };
+
+    class CFaultInjectionFileSystem final : public IVirtualFileSystem
+    {
+    public:
+        IMP_OPERATOR_NEW(CFaultInjectionFileSystem)
+
+    public:
+        core::Bool                                      Exists( core::StringView path ) const noexcept override;
+        core::Bool                                      IsDirectory( core::StringView path ) const noexcept override;
+        core::Result< core::UInt64 >                    GetFileSize( core::StringView path ) const noexcept override;
+        core::String                                    GetModificationTime( core::StringView path ) const noexcept override;
+        core::Vector< core::String >                    ListFiles( core::StringView dirPath ) const noexcept override;
+
+        core::Result< core::Vector< core::UInt8 > >     ReadFile( core::StringView path ) const noexcept override;
+        core::Result< core::Vector< core::UInt8 > >     ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept override;
+        core::Result< void >                            WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< void >                            RemoveFile( core::StringView path ) noexcept override;
+        core::Result< void >                            AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< core::UniqueHandle< IVirtualFileWriter > >  OpenWriter( core::StringView path ) noexcept override;
+        core::Result< void >                            RenameFile( core::StringView from, core::StringView to ) noexcept override;
+        core::Result< void >                            CopyFile( core::StringView from, core::StringView to ) noexcept override;
+
+        core::Result< void >                            CreateDirectory( core::StringView path ) noexcept override;
+
+        /**
+         * @brief Replace configuration and reset write counters, budget and halt state
+         */
+        void                                            SetConfig( const FaultInjectionConfig& config ) noexcept;
+        FaultInjectionConfig                            GetConfig() const noexcept;
+
+        /**
+         * @brief Clear halt state, statistics and counters (keeps configuration)
+         */
+        void                                            Reset() noexcept;
+
+        FaultInjectionStats                             GetStats() const noexcept;
+        core::Bool                                      IsHalted() const noexcept;
+        core::SharedHandle< IVirtualFileSystem >        GetInner() const noexcept { return m_pInner; }
+
+        explicit CFaultInjectionFileSystem( core::SharedHandle< IVirtualFileSystem > inner,
+                                            const FaultInjectionConfig& config = FaultInjectionConfig() ) noexcept;
+        ~CFaultInjectionFileSystem() noexcept override = default;
+
+    private:
+        class Writer;
+
+        enum class WriteFault : core::UInt8
+        {
+            kNone,
+            kTorn,
+            kOutOfSpace
+        };
+
+        core::Bool                                      matches( core::StringView path ) const noexcept;
+        core::UInt32                                    writeLatencyFor( core::StringView path ) const noexcept;
+        void                                            delay( core::UInt32 us ) const noexcept;
+        core::Result< void >                            checkHalted() const noexcept;
+        WriteFault                                      decideWrite( core::StringView path, core::Size size, core::Size& persisted ) noexcept;
+
+        /**
+         * @brief Apply the write fault model to @p size bytes; @p write stores the prefix that gets through
+         */
+        core::Result< void >                            injectWrite( core::StringView path, core::Size size, const core::Char* what,
+                                                                     const ::std::function< core::Result< void >( core::Size ) >& write ) noexcept;
+
+    private:
+        core::SharedHandle< IVirtualFileSystem >        m_pInner;
+        FaultInjectionConfig                            m_config;
+        mutable FaultInjectionStats                     m_stats;
+        core::UInt32                                    m_matchedWrites{ 0 };
+        core::UInt64                                    m_budgetUsed{ 0 };
+        core::Bool                                      m_bHalted{ false };
+        ::std::mt19937                                  m_rng;
+        mutable core::Mutex                             m_mutex;
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_FAULTINJECTIONFILESYSTEM_HPP
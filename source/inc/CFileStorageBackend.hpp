@@ -19,6 +19,7 @@
 #include <lap/core/CPath.hpp>
 #include <lap/core/CFile.hpp>
 #include "CDataType.hpp"
+#include "IVirtualFileSystem.hpp"
 
 namespace lap {
 namespace per {
@@ -50,9 +51,14 @@ public:
     /**
      * @brief Constructor
      * @param basePath Base storage path (e.g., /tmp/autosar_persistency_test/fs/instance1)
+     * @param vfs File system to operate on (nullptr = IVirtualFileSystem::getDefault())
      */
-    explicit CFileStorageBackend(const core::String& basePath) noexcept
-        : m_basePath(basePath) {}
+    explicit CFileStorageBackend(
+        const core::String& basePath,
+        core::SharedHandle<IVirtualFileSystem> vfs = nullptr
+    ) noexcept
+        : m_basePath(basePath)
+        , m_pVfs(vfs ? vfs : IVirtualFileSystem::getDefault()) {}
     
     /**
      * @brief Destructor
@@ -170,8 +176,16 @@ public:
         const core::String& toCategory
     ) noexcept;
     
+    /**
+     * @brief Get file system used by this backend
+     */
+    inline const core::SharedHandle<IVirtualFileSystem>& GetFileSystem() const noexcept {
+        return m_pVfs;
+    }
+    
 private:
     core::String m_basePath;  // Base storage path
+    core::SharedHandle<IVirtualFileSystem> m_pVfs;  // Injected file system
     
     // Helper methods
     core::String GetCategoryPath(const core::String& category) const noexcept;
@@ -10,9 +10,18 @@
 #ifndef LAP_PERSISTENCY_KEYVALUESTORAGE_HPP
 #define LAP_PERSISTENCY_KEYVALUESTORAGE_HPP
 
+#include <type_traits>
+
 #include <lap/core/CMemory.hpp>
 
 #include "CDataType.hpp"
+#include "CKvsGroupCommit.hpp"
+#include "CKvsKey.hpp"
+#include "CKvsMemoryResource.hpp"
+#include "CKvsNotifier.hpp"
+#include "CKvsRecordStream.hpp"
+#include "CKvsSnapshot.hpp"
+#include "CKvsSyncBudget.hpp"
 
 namespace lap
 {
@@ -40,14 +49,78 @@ namespace per
 
         template< class T >
         core::Result<void>                                              SetValue( core::StringView key, const T& value ) noexcept;
+        // Rvalue set: the value's buffers are moved down to the backend instead of copied
+        template< class T, typename = ::std::enable_if_t< !::std::is_reference< T >::value > >
+        core::Result<void>                                              SetValue( core::StringView key, T&& value ) noexcept;
+
+        // Read into an existing object: strings, blobs and arrays keep their capacity
+        template< class T >
+        core::Result<void>                                              GetValue( core::StringView key, T& out ) const noexcept;
+
+        // Typed key access: precomputed hash, type fixed at compile time
+        template< class T >
+        core::Result< T >                                               GetValue( const KvsKey< T >& key ) const noexcept;
+
+        template< class T >
+        core::Result<void>                                              SetValue( const KvsKey< T >& key, const typename KvsKey< T >::ValueType& value ) noexcept;
+
+        // Resolved runtime key: caches the backend location, re-resolved after remove / reload
+        core::Result< KvsKeyHandle >                                    Resolve( core::StringView key ) const noexcept;
+
+        template< class T >
+        core::Result< T >                                               GetValue( const KvsKeyHandle& handle ) const noexcept;
+
+        template< class T >
+        core::Result<void>                                              SetValue( const KvsKeyHandle& handle, const T& value ) noexcept;
+
+        // Read a numeric array (or UInt8 blob) into caller memory without allocating, returns element count
+        template< class T >
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, core::Span< T > buffer ) const noexcept;
+
+        // Atomic read-modify-write, each a single backend step (no external lock needed).
+        // FetchAdd returns the previous value and creates a missing key with value delta
+        template< class T >
+        core::Result< T >                                               FetchAdd( core::StringView key, const T& delta ) noexcept;
+
+        template< class T >
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const T& expected, const T& desired ) noexcept;
+
+        template< class T >
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const T& value ) noexcept;
+
+        // Read-only view pinned to the current version: consistent multi-key reads that never block writers
+        core::Result< KvsSnapshot >                                     Snapshot() const noexcept;
 
         core::Result<void>                                              RemoveKey( core::StringView key ) noexcept;
         core::Result<void>                                              RecoverKey( core::StringView key ) noexcept;
         core::Result<void>                                              ResetKey( core::StringView key ) noexcept;
         core::Result<void>                                              RemoveAllKeys() noexcept;
+        // Concurrent callers share one physical sync (group commit), see KvsGroupCommit
         core::Result<void>                                              SyncToStorage() const noexcept;
+        // At most the work of @p budget per call, resuming where the last call stopped; call until complete.
+        // Bypasses group commit, a caller with a deadline never waits for others
+        core::Result< KvsSyncProgress >                                 SyncToStorage( const KvsSyncBudget& budget ) const noexcept;
+        // Bulk transfer in batches of the shared record format (CKvsRecordStream.hpp), e.g. to convert a store
+        // between backends or provision it from a factory dataset. A successful Import reports a store-wide reload
+        core::Result< core::UInt64 >                                    Export( IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE ) const noexcept;
+        core::Result< core::UInt64 >                                    Import( IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions() ) noexcept;
         core::Result<void>                                              DiscardPendingChanges() noexcept;
 
+        // Change notifications, delivered asynchronously on a dispatcher thread and coalesced per key.
+        // Set / RemoveKey report the key; RemoveAllKeys and DiscardPendingChanges report a store-wide event
+        core::Result< KvsSubscriptionId >                               Subscribe( core::StringView prefix, KvsChangeCallback callback ) noexcept;
+        core::Result< KvsSubscriptionId >                               Subscribe( const core::Vector< core::String >& keys, KvsChangeCallback callback ) noexcept;
+        core::Result<void>                                              Unsubscribe( KvsSubscriptionId id ) noexcept;
+        // Wait until changes made so far have been delivered
+        void                                                            FlushNotifications() noexcept;
+
+        // Usage of the storage's memory pool (PersistencyConfig::kvs.memoryPoolSize), kUnsupported without one
+        core::Result< KvsMemoryStatistics >                             GetMemoryStatistics() const noexcept;
+
+        // Time the first of several concurrent SyncToStorage callers waits for the others (PersistencyConfig::kvs.groupCommitWindowUs)
+        void                                                            SetGroupCommitWindow( core::UInt32 windowUs ) noexcept;
+        core::Result< KvsGroupCommitStatistics >                        GetGroupCommitStatistics() const noexcept;
+
     protected:
         friend class CPersistencyManager;
 
@@ -95,11 +168,17 @@ namespace per
         core::Result< void >                            ResetKeyValueStorage() noexcept;
         core::Result< core::UInt64 >                    GetCurrentKeyValueStorageSize() noexcept;
 
+    private:
+        void                                            notify( core::StringView key, KvsChangeType type ) noexcept;
+
     private:
         core::Bool                                      m_bInitialized{ false };
         core::Bool                                      m_bResourceBusy{ false };
         core::StringView                                m_strPath;
+        core::UniqueHandle< KvsMemoryResource >         m_pMemory;              ///< Outlives m_pKvsBackend, which allocates from it
         core::UniqueHandle< IKvsBackend >               m_pKvsBackend;
+        core::UniqueHandle< KvsNotifier >               m_pNotifier{ ::std::make_unique< KvsNotifier >() };
+        core::UniqueHandle< KvsGroupCommit >            m_pGroupCommit{ ::std::make_unique< KvsGroupCommit >() };
     };
 
     core::Result< core::SharedHandle< KeyValueStorage > >               OpenKeyValueStorage( const core::InstanceSpecifier &, core::Bool, KvsBackendType ) noexcept;
@@ -0,0 +1,100 @@
+/**
+ * @file CKvsBloomFilter.hpp
+ * @brief Blocked Bloom filter for negative key lookups
+ * @version 1.0
+ * @date 2025-11-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Persistent backends consult the filter before touching storage: a key the
+ * filter has never seen is reported missing after probing a single cache line.
+ * The SQLite backend keeps the filter in memory only and rebuilds it from
+ * storage at load time, after many removals and when other writers may have
+ * changed the data behind it; the LSM backend stores one filter per immutable
+ * sorted run.
+ */
+
+#ifndef LAP_PERSISTENCY_KVSBLOOMFILTER_HPP
+#define LAP_PERSISTENCY_KVSBLOOMFILTER_HPP
+
+#include <lap/core/CTypedef.hpp>
+#include <lap/core/CMemory.hpp>
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Bloom filter counters of one backend instance
+     */
+    struct KvsBloomFilterStats
+    {
+        core::UInt64    lookups{ 0 };           ///< Lookups that consulted the filter
+        core::UInt64    negatives{ 0 };         ///< Misses answered by the filter alone
+        core::UInt64    falsePositives{ 0 };    ///< Lookups that passed the filter and then missed in storage
+        core::UInt64    bypassed{ 0 };          ///< Filter answers not trusted because another writer changed storage
+        core::UInt64    rebuilds{ 0 };          ///< Filter rebuilds from storage
+        core::UInt64    keys{ 0 };              ///< Keys added since the last rebuild
+        core::UInt64    bits{ 0 };              ///< Filter size
+        core::Double    fillRatio{ 0.0 };       ///< Fraction of bits set
+
+        /// Observed rate: false positives over all lookups of absent keys that the filter judged
+        core::Double    FalsePositiveRate() const noexcept
+        {
+            core::UInt64 misses = falsePositives + negatives;
+            return misses == 0 ? 0.0 : static_cast< core::Double >( falsePositives ) / static_cast< core::Double >( misses );
+        }
+    };
+
+    /**
+     * @brief Cache-line blocked Bloom filter over 64-bit key hashes (kvsKeyHash)
+     *
+     * Every key sets HASHES bits inside one 512-bit block, so a lookup touches one
+     * cache line. Sized for BITS_PER_KEY bits per expected key (about 1% false
+     * positives at capacity). Not thread safe, the owning backend serializes access.
+     */
+    class KvsBloomFilter final
+    {
+    public:
+        static constexpr core::UInt32   HASHES          = 7;
+        static constexpr core::UInt32   BITS_PER_KEY    = 10;
+        static constexpr core::Size     MIN_CAPACITY    = 256;
+
+        /// Clear the filter and size it for @p capacity keys
+        void                            Reset( core::Size capacity ) noexcept;
+        void                            Add( core::UInt64 hash ) noexcept;
+        core::Bool                      MayContain( core::UInt64 hash ) const noexcept;
+
+        /// More keys added than the filter was sized for, the false-positive rate climbs from here
+        core::Bool                      Saturated() const noexcept  { return m_count > m_capacity; }
+        core::Size                      Count() const noexcept      { return m_count; }
+        core::Size                      Capacity() const noexcept   { return m_capacity; }
+        core::UInt64                    Bits() const noexcept       { return m_blocks.size() * BLOCK_BITS; }
+        core::Double                    FillRatio() const noexcept;
+
+        /// Filter bits as persisted next to the keys they describe (LSM sorted runs), host byte order
+        const core::UInt8*              Data() const noexcept       { return reinterpret_cast< const core::UInt8* >( m_blocks.data() ); }
+        core::Size                      ByteSize() const noexcept   { return m_blocks.size() * sizeof( Block ); }
+        /// Adopt bytes produced by Data() of a filter holding @p count keys; false if @p size is no valid filter size
+        core::Bool                      Load( const core::UInt8* data, core::Size size, core::Size count ) noexcept;
+
+    private:
+        static constexpr core::UInt32   BLOCK_BITS      = 512;
+
+        struct alignas( 64 ) Block
+        {
+            core::UInt64                words[ BLOCK_BITS / 64 ];
+        };
+
+        const Block&                    block( core::UInt64 hash ) const noexcept;
+
+    private:
+        core::Vector< Block >           m_blocks;
+        core::Size                      m_count{ 0 };
+        core::Size                      m_capacity{ 0 };
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSBLOOMFILTER_HPP
@@ -33,13 +33,29 @@
 #include <lap/core/CSync.hpp>
 
 #include "CDataType.hpp"
+#include "CKvsMemoryResource.hpp"
 #include "IKvsBackend.hpp"
+#include "IVirtualFileSystem.hpp"
 
 namespace lap
 {
 namespace per
 {
     class KeyValueStorage;
+
+    /**
+     * @brief JSON document of the file backend
+     *
+     * Nodes, member names, strings and binary values all come from the resource
+     * of the KvsMemoryScope active on the calling thread. Every backend function
+     * that creates document content opens a scope on the backend's pool first; a
+     * KvsJson built outside any scope takes its memory from the global heap
+     * (still freed correctly, but not bounded by the pool). Blobs and arrays are
+     * held as binary values and become base64 text only in the file.
+     */
+    using KvsJsonString = ::std::basic_string< char, ::std::char_traits< char >, KvsScopedAllocator< char > >;
+    using KvsJson = nlohmann::basic_json< ::std::map, ::std::vector, KvsJsonString, bool, ::std::int64_t, ::std::uint64_t, double, KvsScopedAllocator,
+                                          nlohmann::adl_serializer, ::std::vector< ::std::uint8_t, KvsScopedAllocator< ::std::uint8_t > > >;
     
     /**
      * @brief JSON File Backend for Key-Value Storage
@@ -47,11 +63,11 @@ namespace per
      * This backend stores key-value pairs in a JSON file on disk.
      * Data is loaded into memory on construction and synchronized to disk on Sync().
      * 
-     * File Format:
+     * File Format (one member per line, blobs and little-endian arrays as base64 text):
      * ```json
      * {
-     *   "key1": "value1",
-     *   "key2": "value2"
+     *     "key1": {"type":"l","value":"value1"},
+     *     "key2": {"type":"m","value":"AAEC"}
      * }
      * ```
      * 
@@ -126,12 +142,67 @@ namespace per
         core::Result<core::Bool> KeyExists(core::StringView key) const noexcept override;
         core::Result<KvsDataType> GetValue(core::StringView key) const noexcept override;
         core::Result<void> SetValue(core::StringView key, const KvsDataType& value) noexcept override;
+        using IKvsBackend::SetValue;    // Rvalue set forwards here: values are copied into the document's pool
+
+        /**
+         * @brief Read into an existing value, strings, blobs and arrays are assigned in place
+         */
+        core::Result<void> GetValueAssign(core::StringView key, KvsDataType& out) const noexcept override;
+        core::Result<core::Size> GetValueInto(core::StringView key, EKvsDataTypeIndicate type, core::Span<core::Byte> buffer) const noexcept override;
+
+        /**
+         * @brief Resolved key handles cache the JSON object member of the key
+         */
+        void ResolveKey(const KvsKeyHandle& handle) const noexcept override;
+        core::Result<KvsDataType> GetValueResolved(const KvsKeyHandle& handle) const noexcept override;
+        core::Result<void> SetValueResolved(const KvsKeyHandle& handle, const KvsDataType& value) noexcept override;
+
+        /**
+         * @brief Read-modify-write under the exclusive lock
+         */
+        core::Result<KvsDataType> FetchAdd(core::StringView key, const KvsDataType& delta) noexcept override;
+        core::Result<core::Bool> CompareExchange(core::StringView key, const KvsDataType& expected, const KvsDataType& desired) noexcept override;
+        core::Result<core::Bool> SetIfAbsent(core::StringView key, const KvsDataType& value) noexcept override;
+
+        /**
+         * @brief Snapshot over a shared decoded base plus a layer of the keys changed since
+         * @note The base is copied in chunks, one shared lock each; see KvsSnapshotCache
+         */
+        core::Result<core::SharedHandle<IKvsSnapshot>> CreateSnapshot() const noexcept override;
         core::Result<void> RemoveKey(core::StringView key) noexcept override;
         core::Result<void> RemoveAllKeys() noexcept override;
         core::Result<void> SyncToStorage() noexcept override;
 
+        /**
+         * @brief Run the update workflow in units: serialize one member, or write, verify or copy one chunk
+         * @note The file holds the snapshot pinned when the sync started. Changes made while
+         *       the sync runs keep the backend dirty for the next sync. Each file of a phase is
+         *       written through one writer and flushed once, before the rename.
+         */
+        core::Result<KvsSyncProgress> SyncToStorage(KvsSyncMeter& meter) noexcept override;
+
+        /**
+         * @brief Stream the members in key order, one read lock per batch
+         */
+        core::Result<core::UInt64> Export(IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE) const noexcept override;
+
+        /**
+         * @brief Store a batch of records under one write lock
+         */
+        core::Result<core::UInt64> Import(IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions()) noexcept override;
+
         ~KvsFileBackend() noexcept override;
-        explicit KvsFileBackend( core::StringView ) noexcept;
+        /**
+         * @param vfs File system to operate on (nullptr = IVirtualFileSystem::getDefault())
+         * @param resource Pool for the JSON document, must outlive the backend (nullptr = global heap)
+         */
+        explicit KvsFileBackend( core::StringView, core::SharedHandle< IVirtualFileSystem > vfs = nullptr,
+                                 ::std::pmr::memory_resource* resource = nullptr ) noexcept;
+
+        /**
+         * @brief Get file system used by this backend
+         */
+        const core::SharedHandle< IVirtualFileSystem >& GetFileSystem() const noexcept { return m_pVfs; }
 
     protected:
         friend class KeyValueStorage;
@@ -198,18 +269,76 @@ namespace per
          */
         core::Result<void> atomicReplaceCurrentWithUpdate() noexcept;
 
+        /**
+         * @brief Create current/update/redundancy/recovery under the instance path
+         * @note AUTOSAR [SWS_PER_00500] - [SWS_PER_00503]
+         */
+        core::Result<void> createStorageStructure() noexcept;
+
+        /**
+         * @brief JSON member of a handle's key, re-resolved if the cached one is stale
+         * @return nullptr if the key doesn't exist
+         * @note Caller holds m_rwLock
+         */
+        KvsJson* locateNode(const KvsKeyHandle& handle) const;
+
+        /**
+         * @brief Write, verify or copy the next @p chunk bytes of the pending sync's phase
+         * @note Caller holds m_rwLock
+         */
+        core::Result<void> syncChunk(core::Size chunk) noexcept;
+
+        /**
+         * @brief Drop the pending sync and its partial update/ and temp files
+         */
+        void abandonPendingSync() noexcept;
+
         KvsFileBackend() = delete;
         KvsFileBackend( const KvsFileBackend& ) = delete;
         KvsFileBackend( KvsFileBackend&& ) = delete;
         KvsFileBackend& operator=( const KvsFileBackend& ) = delete;
 
+    private:
+        /**
+         * @brief Incremental sync in progress, the phases run in declaration order
+         */
+        struct PendingSync
+        {
+            enum class Phase : core::UInt8
+            {
+                kSerialize,         ///< Members into data
+                kWriteUpdate,       ///< data to update/
+                kVerifyUpdate,      ///< update/ read back and compared with data
+                kBackup,            ///< current/ copied to redundancy/
+                kWriteTemp,         ///< data to the temp file renamed over current/
+                kCommit
+            };
+
+            Phase                   phase{ Phase::kSerialize };
+            core::SharedHandle< const KvsMapSnapshot >  pSnapshot;      ///< State being written
+            core::UniqueHandle< IVirtualFileWriter >    pWriter;        ///< File of the current phase, open between chunks
+            ::std::string           data;                   ///< Serialized document
+            ::std::string           lastKey;                ///< Last member serialized
+            core::UInt64            serialized{ 0 };        ///< Members serialized
+            core::UInt64            offset{ 0 };            ///< Bytes of the current phase done
+            core::UInt64            backupSize{ 0 };        ///< Size of current/, 0 if there is nothing to back up
+            core::UInt64            version{ 0 };           ///< m_version when the sync started
+            core::UInt64            longestChunkNs{ 0 };    ///< Slowest chunk so far, predicts the next one
+        };
+
     private:
         core::Bool                                          m_bAvailable{ false };  ///< Backend availability flag
         core::String                                        m_strFile;              ///< JSON file path (current/ directory)
         core::String                                        m_instancePath;         ///< Instance base path
-        nlohmann::json                                      m_kvsRoot;              ///< In-memory JSON object
+        KvsJson                                             m_kvsRoot;              ///< In-memory JSON object, allocated from m_pResource
         core::Bool                                          m_dirty{false};         ///< True if there are unsaved changes
+        core::UInt64                                        m_generation{ nextGeneration() };  ///< Changes when JSON members may be freed
+        core::UInt64                                        m_version{ 0 };         ///< Bumped on every change, guarded by m_rwLock
+        mutable KvsSnapshotCache                            m_snapshots;            ///< Told of every change under m_rwLock
         mutable core::RWLock                                m_rwLock;               ///< Thread-safe access protection [SWS_PER_00309]
+        core::SharedHandle< IVirtualFileSystem >            m_pVfs;                 ///< Injected file system
+        ::std::pmr::memory_resource*                        m_pResource{ nullptr }; ///< Pool of the document, nullptr = global heap
+        core::UniqueHandle< PendingSync >                   m_pPendingSync;         ///< Unfinished SyncToStorage( meter ), guarded by m_rwLock
     };
 } // namespace per
 } // namespace lap
@@ -0,0 +1,91 @@
+/**
+ * @file CKvsGroupCommit.hpp
+ * @brief Group commit for concurrent SyncToStorage callers
+ * @version 1.0
+ * @date 2025-11-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A physical sync (file update, validate, backup and replace, or SQLite commit
+ * plus checkpoint) makes everything written before it durable, whoever asked.
+ * KvsGroupCommit lets concurrent callers share one: the first caller leads a
+ * batch, waits the configured window for others to join, then runs the sync
+ * once and releases every member of the batch with its result. Callers that
+ * arrive while a sync runs form the next batch, since their writes may have
+ * missed the running one.
+ *
+ * With a window of 0 only callers arriving during a running sync are
+ * coalesced, a lone caller syncs without delay.
+ */
+#ifndef LAP_PERSISTENCY_KVSGROUPCOMMIT_HPP
+#define LAP_PERSISTENCY_KVSGROUPCOMMIT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Sync requests and the physical syncs that served them
+     */
+    struct KvsGroupCommitStatistics
+    {
+        core::UInt64    requests{ 0 };          ///< SyncToStorage calls
+        core::UInt64    physicalSyncs{ 0 };     ///< Backend syncs run, one per batch
+    };
+
+    class KvsGroupCommit final
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsGroupCommit)
+
+        /**
+         * @param windowUs Time a batch leader waits for other callers, in microseconds
+         */
+        explicit KvsGroupCommit( core::UInt32 windowUs = 0 ) noexcept : m_windowUs( windowUs ) {}
+        ~KvsGroupCommit() noexcept = default;
+
+        void                                    SetWindow( core::UInt32 windowUs ) noexcept     { m_windowUs.store( windowUs, ::std::memory_order_relaxed ); }
+        core::UInt32                            GetWindow() const noexcept                      { return m_windowUs.load( ::std::memory_order_relaxed ); }
+
+        /**
+         * @brief Make the caller's writes durable, sharing one physical sync with concurrent callers
+         * @param sync Physical sync, run by the batch leader with no lock held
+         * @return Result of the sync that covered this call
+         */
+        core::Result< void >                    Sync( const ::std::function< core::Result< void >() >& sync ) noexcept;
+
+        KvsGroupCommitStatistics                GetStatistics() const noexcept;
+
+        KvsGroupCommit( const KvsGroupCommit& ) = delete;
+        KvsGroupCommit& operator=( const KvsGroupCommit& ) = delete;
+
+    private:
+        struct Batch
+        {
+            core::Bool                          done{ false };
+            core::Result< void >                result{ core::Result< void >::FromValue() };
+        };
+
+    private:
+        ::std::atomic< core::UInt32 >           m_windowUs;
+
+        mutable core::Mutex                     m_mutex;                    ///< Guards the members below
+        ::std::condition_variable_any           m_done;
+        core::SharedHandle< Batch >             m_pOpen;                    ///< Batch new callers join, created on demand
+        core::Bool                              m_leaderActive{ false };    ///< A leader is collecting or syncing
+        KvsGroupCommitStatistics                m_stats;
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSGROUPCOMMIT_HPP
@@ -0,0 +1,153 @@
+/**
+ * @file CKvsKey.hpp
+ * @brief Compile-time typed KVS keys with precomputed hashes
+ * @version 1.0
+ * @date 2025-11-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A KvsKey<T> bundles a key name, its FNV-1a hash and the static value type.
+ * Declared constexpr, the hash is computed by the compiler and the value type
+ * is checked against KvsDataType at compile time:
+ *
+ *   constexpr KvsKey< core::Float > kVehicleSpeed{ "vehicle.speed" };
+ *   kvs->SetValue( kVehicleSpeed, 12.5f );
+ *   auto speed = kvs->GetValue( kVehicleSpeed );   // Result< core::Float >
+ *
+ * Hash-indexed backends (Property) use the precomputed hash directly instead
+ * of rehashing the name on every access.
+ *
+ * For keys only known at run time, KeyValueStorage::Resolve() returns a
+ * KvsKeyHandle that additionally caches the backend location of the key.
+ */
+
+#ifndef LAP_PERSISTENCY_KVSKEY_HPP
+#define LAP_PERSISTENCY_KVSKEY_HPP
+
+#include <type_traits>
+
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    constexpr core::UInt64 KVS_KEY_HASH_SEED = 14695981039346656037ull;
+
+    /**
+     * @brief 64-bit FNV-1a hash of a key name
+     * @param seed Hash of the text before @p key: kvsKeyHash( b, kvsKeyHash( a ) ) == kvsKeyHash( a + b )
+     * @note Shared by KvsKey (compile time) and the backends (run time), so both sides agree
+     */
+    constexpr core::UInt64 kvsKeyHash( core::StringView key, core::UInt64 seed = KVS_KEY_HASH_SEED ) noexcept
+    {
+        core::UInt64 hash = seed;
+        for ( core::Size i = 0; i < key.size(); ++i ) {
+            hash ^= static_cast< core::UInt8 >( key[i] );
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    namespace detail
+    {
+        // Position of T in Ts..., sizeof...( Ts ) if absent
+        template < class T, class... Ts >
+        constexpr core::Size kvsTypeIndexOf() noexcept
+        {
+            constexpr core::Bool matches[] = { ::std::is_same< T, Ts >::value... };
+            for ( core::Size i = 0; i < sizeof...( Ts ); ++i ) {
+                if ( matches[i] ) return i;
+            }
+            return sizeof...( Ts );
+        }
+
+        template < class T, class V >
+        struct KvsTypeIndex;
+
+        template < class T, class... Ts >
+        struct KvsTypeIndex< T, core::Variant< Ts... > >
+        {
+            static constexpr core::Size value   = kvsTypeIndexOf< T, Ts... >();
+            static constexpr core::Size count   = sizeof...( Ts );
+        };
+    } // namespace detail
+
+    /**
+     * @brief Typed key descriptor
+     * @tparam T Value type, must be one of the KvsDataType alternatives
+     */
+    template < class T >
+    class KvsKey final
+    {
+    public:
+        static_assert( detail::KvsTypeIndex< T, KvsDataType >::value < detail::KvsTypeIndex< T, KvsDataType >::count,
+                       "KvsKey<T>: T is not a KvsDataType alternative" );
+
+        using ValueType = T;
+
+        /// Variant index of T, compared against the stored value instead of a runtime type switch
+        static constexpr core::Size             Index   = detail::KvsTypeIndex< T, KvsDataType >::value;
+        static constexpr EKvsDataTypeIndicate   Type    = static_cast< EKvsDataTypeIndicate >( Index );
+
+        /**
+         * @brief Construct from a key name
+         * @note The name is referenced, not copied: use string literals or storage that outlives the key
+         */
+        constexpr explicit KvsKey( core::StringView name ) noexcept
+            : m_name( name )
+            , m_hash( kvsKeyHash( name ) )
+        {
+        }
+
+        constexpr core::StringView              Name() const noexcept       { return m_name; }
+        constexpr core::UInt64                  Hash() const noexcept       { return m_hash; }
+
+    private:
+        core::StringView                        m_name;
+        core::UInt64                            m_hash;
+    };
+
+    class IKvsBackend;
+
+    /**
+     * @brief Resolved runtime key, see KeyValueStorage::Resolve()
+     *
+     * Caches the backend location of a key (the map node in the Property and
+     * File backends) so repeated access skips hashing and key comparison. The
+     * backend tags the location with a generation that changes whenever nodes
+     * may disappear (remove, clear, reload); a handle from an older generation
+     * falls back to a lookup by name and caches the new location.
+     *
+     * @note Not thread-safe: the cached location is updated on access, use one handle per thread
+     */
+    class KvsKeyHandle final
+    {
+    public:
+        KvsKeyHandle() noexcept = default;
+
+        explicit KvsKeyHandle( core::StringView name )
+            : m_name( name.data(), name.size() )
+            , m_hash( kvsKeyHash( name ) )
+        {
+        }
+
+        core::StringView                        Name() const noexcept       { return core::StringView( m_name.data(), m_name.size() ); }
+        core::UInt64                            Hash() const noexcept       { return m_hash; }
+
+        /// True while a backend location is cached (it may still be stale)
+        core::Bool                              IsResolved() const noexcept { return m_pNode != nullptr; }
+
+    private:
+        friend class IKvsBackend;
+
+        core::String                            m_name;
+        core::UInt64                            m_hash{ kvsKeyHash( core::StringView() ) };
+        mutable void*                           m_pNode{ nullptr };     ///< Backend-specific location
+        mutable core::UInt64                    m_generation{ 0 };      ///< Backend generation m_pNode belongs to
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSKEY_HPP
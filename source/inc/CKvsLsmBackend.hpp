@@ -0,0 +1,267 @@
+/**
+ * @file CKvsLsmBackend.hpp
+ * @brief Log-structured merge-tree KVS backend for write-heavy instances
+ * @version 1.0
+ * @date 2025-11-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Writes never rewrite existing files. SetValue()/RemoveKey() update an
+ * in-memory overlay; SyncToStorage() appends the overlay as one checksummed
+ * batch to the write-ahead log (a single sequential append + fdatasync) and
+ * folds it into the memtable. A memtable above KvsLsmOptions::memtableBytes is
+ * frozen and written by a background thread as an immutable sorted run on
+ * level 0. Leveled compaction merges level 0 into level 1 and level i into
+ * level i+1 once a level outgrows its budget, so levels >= 1 hold key-disjoint
+ * runs and a point read probes at most one run per level, each guarded by the
+ * run's Bloom filter and sparse index.
+ *
+ * Layout of {instance}/current/:
+ *   MANIFEST       live runs per level and the oldest WAL segment still needed
+ *   wal_<n>.log    [UInt32 length][UInt32 crc32][entries] per SyncToStorage()
+ *   run_<n>.sst    sorted entries | sparse index | Bloom filter | footer
+ *
+ * Multi-byte fields and values are host byte order, as SQLite BLOBs and the
+ * Mmap backend hold them (the File backend's JSON text is little-endian). WAL
+ * and run files are therefore not portable between hosts of different byte
+ * order; move an instance with kvs_bulk_tool instead of copying its files.
+ */
+#ifndef LAP_PERSISTENCY_KVSLSMBACKEND_HPP
+#define LAP_PERSISTENCY_KVSLSMBACKEND_HPP
+
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+#include "IKvsBackend.hpp"
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Tuning of one LSM backend instance
+     */
+    struct KvsLsmOptions
+    {
+        core::Size      memtableBytes{ 4ul << 20 };     ///< Memtable size that triggers a flush to level 0
+        core::UInt32    level0Runs{ 4 };                ///< Level-0 run count that triggers compaction into level 1
+        core::UInt64    level1Bytes{ 16ul << 20 };      ///< Size budget of level 1
+        core::UInt32    levelSizeRatio{ 10 };           ///< Budget growth from one level to the next
+        core::Size      runBytes{ 4ul << 20 };          ///< Target size of a compaction output run
+        core::UInt32    indexInterval{ 16 };            ///< Entries per sparse index entry, the span of one ranged read
+    };
+
+    /**
+     * @brief Write path counters of one LSM backend instance
+     */
+    struct KvsLsmStats
+    {
+        core::UInt64                    walBytes{ 0 };          ///< Bytes appended to the write-ahead log
+        core::UInt64                    flushBytes{ 0 };        ///< Bytes written as level-0 runs
+        core::UInt64                    compactionBytes{ 0 };   ///< Bytes rewritten by compaction
+        core::UInt64                    flushes{ 0 };
+        core::UInt64                    compactions{ 0 };
+        core::UInt64                    stalls{ 0 };            ///< Syncs that found the memtable full while the previous one was still being flushed
+        core::UInt64                    memtableBytes{ 0 };     ///< Encoded size of the active memtable
+        core::Vector< core::UInt32 >    runsPerLevel;
+
+        /// Bytes written to storage per byte logged, 0 before the first sync
+        core::Double                    WriteAmplification() const noexcept
+        {
+            return walBytes == 0 ? 0.0 : static_cast< core::Double >( walBytes + flushBytes + compactionBytes ) / static_cast< core::Double >( walBytes );
+        }
+    };
+
+    /**
+     * @brief KVS backend storing an instance as a log-structured merge tree
+     *
+     * Durability follows the KVS API: changes are durable once SyncToStorage()
+     * returns, DiscardPendingChanges() drops everything written since. After a
+     * crash the memtable is rebuilt from the WAL; a torn tail batch is dropped.
+     *
+     * Thread Safety:
+     * - m_rwLock guards the memtables and the current version; point reads only
+     *   hold it to probe the memtables, run files are read without it
+     * - SyncToStorage() holds the lock while it swaps and merges batches, not
+     *   while the WAL is written, so readers and writers proceed during the fdatasync
+     * - Flushes and compactions run on a background thread and publish a new
+     *   version atomically; files of replaced runs are deleted when the last
+     *   reader or snapshot using them lets go
+     */
+    class KvsLsmBackend final : public IKvsBackend
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsLsmBackend)
+
+        static constexpr core::UInt32 MAX_LEVELS = 7;
+
+        /**
+         * @param identifier KVS instance identifier, files are stored in "{instance}/current/"
+         * @param vfs File system to store the instance on, nullptr for the process default
+         * @param options Memtable, level and run sizing
+         */
+        explicit KvsLsmBackend( core::StringView identifier,
+                                core::SharedHandle< IVirtualFileSystem > vfs = nullptr,
+                                const KvsLsmOptions& options = KvsLsmOptions() ) noexcept;
+        ~KvsLsmBackend() noexcept override;
+
+        core::Bool                                                      available() const noexcept override { return m_bAvailable; }
+        KvsBackendType                                                  GetBackendType() const noexcept override { return KvsBackendType::kvsLsm; }
+        core::Bool                                                      SupportsPersistence() const noexcept override { return true; }
+
+        core::Result< core::Vector< core::String > >                    GetAllKeys() const noexcept override;
+        core::Result< core::Bool >                                      KeyExists( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValue( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept override;
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, KvsDataType &&value ) noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
+        core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
+        // Undoes a RemoveKey() that has not been synced yet
+        core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
+        // Same as RemoveKey(), the tombstone is purged when it reaches the bottom level
+        core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RemoveAllKeys() noexcept override;
+        core::Result< void >                                            SyncToStorage() noexcept override;
+        using IKvsBackend::SyncToStorage;                               // Budgeted variant runs a full sync
+        core::Result< void >                                            DiscardPendingChanges() noexcept override;
+        // Run files, WAL segments and manifest
+        core::Result< core::UInt64 >                                    GetSize() const noexcept override;
+        core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
+
+        KvsLsmStats                                                     GetStats() const noexcept;
+
+        /// Block until no flush or compaction is queued or running (tests, benchmarks)
+        void                                                            WaitForBackgroundWork() noexcept;
+
+    protected:
+        KvsLsmBackend() = delete;
+        KvsLsmBackend( const KvsLsmBackend& ) = delete;
+        KvsLsmBackend( KvsLsmBackend&& ) = delete;
+        KvsLsmBackend& operator=( const KvsLsmBackend& ) = delete;
+
+    private:
+        struct KeyLess
+        {
+            using is_transparent = void;
+
+            static core::StringView     view( const core::String& key ) noexcept    { return core::StringView( key.data(), key.size() ); }
+            static core::StringView     view( core::StringView key ) noexcept       { return key; }
+
+            template< class L, class R >
+            core::Bool                  operator()( const L& left, const R& right ) const noexcept { return view( left ) < view( right ); }
+        };
+
+        struct Record
+        {
+            core::Bool                  deleted{ false };
+            KvsDataType                 value;
+        };
+
+        using MemTable  = ::std::map< core::String, Record, KeyLess >;
+
+        struct Run;
+        struct Version;
+        class Snapshot;
+
+        using RunHandle = core::SharedHandle< Run >;
+
+        enum class Lookup : core::UInt8 { kMissing, kDeleted, kFound };
+
+        // Memtables from newest to oldest, as seen under m_rwLock
+        struct Tables
+        {
+            core::SharedHandle< const MemTable >    layers[ 4 ];
+            core::SharedHandle< const Version >     version;
+        };
+
+        // ---- read path (static parts are shared with Snapshot) ----
+        static Lookup                                                   findInTable( const MemTable* table, core::StringView key, KvsDataType* out );
+        static core::Result< Lookup >                                   findInRun( const Run& run, core::StringView key, core::UInt64 hash, KvsDataType* out ) noexcept;
+        static core::Result< Lookup >                                   findInVersion( const Version& version, core::StringView key, core::UInt64 hash, KvsDataType* out ) noexcept;
+        static core::Result< core::Vector< core::String > >             collectKeys( const Tables& tables ) noexcept;
+
+        Lookup                                                          findInMemory( core::StringView key, KvsDataType* out ) const;   ///< Caller holds m_rwLock
+        core::Result< Lookup >                                          find( core::StringView key, core::UInt64 hash, KvsDataType* out ) const noexcept;
+        core::Result< Lookup >                                          findLocked( core::StringView key, KvsDataType* out ) const noexcept;   ///< Caller holds m_rwLock
+        Tables                                                          pinTables() const;     ///< Caller holds m_rwLock
+
+        // ---- write path, caller holds m_rwLock exclusively ----
+        MemTable&                                                       pending();
+        MemTable&                                                       memtable();
+        void                                                            put( core::StringView key, Record&& record );
+        core::Bool                                                      rotateIfFull();     ///< Freeze a full memtable; true if the worker has a flush to do
+
+        // ---- storage ----
+        core::String                                                    dataPath( core::StringView name ) const;
+        core::String                                                    walPath( core::UInt64 segment ) const;
+        core::String                                                    runPath( core::UInt64 id ) const;
+        core::Result< void >                                            createStorageStructure() noexcept;
+        core::Result< void >                                            recover() noexcept;
+        core::Result< void >                                            replayWal( core::UInt64 segment, MemTable& table, core::Size& bytes ) noexcept;
+        core::Result< RunHandle >                                       openRun( core::UInt64 id ) const noexcept;
+        core::Result< RunHandle >                                       writeRun( const core::Vector< core::UInt8 >& file ) noexcept;
+        core::Result< void >                                            writeManifest( const Version& version, core::UInt64 walSegment ) noexcept;
+        void                                                            removeWalBefore( core::UInt64 segment ) noexcept;
+
+        // ---- background work, serialized by m_compactionMutex ----
+        void                                                            schedule() noexcept;
+        void                                                            workLoop() noexcept;
+        void                                                            doBackgroundWork() noexcept;
+        core::Result< void >                                            flushImmutable() noexcept;
+        core::Bool                                                      pickCompaction( const Version& version, core::UInt32& level ) const noexcept;
+        core::Result< void >                                            compact( core::UInt32 level ) noexcept;
+        core::UInt64                                                    levelBudget( core::UInt32 level ) const noexcept;
+
+    private:
+        core::String                                                    m_instancePath;
+        core::String                                                    m_dataPath;         ///< {instance}/current
+        core::SharedHandle< IVirtualFileSystem >                        m_pVfs;
+        KvsLsmOptions                                                   m_options;
+        core::Bool                                                      m_bAvailable{ false };
+
+        // Guarded by m_rwLock. A table shared with a snapshot is copied before it is modified
+        mutable core::RWLock                                            m_rwLock;
+        core::SharedHandle< MemTable >                                  m_pPending;         ///< Changes since the last sync
+        core::SharedHandle< MemTable >                                  m_pSyncing;         ///< Batch being written to the WAL
+        core::SharedHandle< MemTable >                                  m_pMemtable;        ///< Synced, not yet in a run
+        core::SharedHandle< MemTable >                                  m_pImmutable;       ///< Frozen, being flushed to level 0
+        core::SharedHandle< const Version >                             m_pVersion;
+        core::Size                                                      m_memtableBytes{ 0 };
+        core::UInt64                                                    m_walSegment{ 0 };  ///< Segment appended to by the next sync
+        core::UInt64                                                    m_memtableWal{ 0 }; ///< First segment holding m_pMemtable's batches
+
+        core::Mutex                                                     m_syncMutex;        ///< One WAL batch in flight at a time
+        core::Vector< core::UInt8 >                                     m_walBuffer;        ///< Guarded by m_syncMutex
+
+        core::Mutex                                                     m_compactionMutex;  ///< Held while a flush or compaction runs
+        core::UInt64                                                    m_nextRunId{ 1 };
+        core::UInt64                                                    m_manifestWal{ 0 }; ///< Oldest WAL segment the manifest still needs
+        core::String                                                    m_compactCursor[ MAX_LEVELS ];
+
+        mutable core::Mutex                                             m_statsMutex;
+        KvsLsmStats                                                     m_stats;
+
+        core::Mutex                                                     m_workMutex;
+        ::std::condition_variable_any                                   m_workCv;
+        ::std::condition_variable_any                                   m_idleCv;
+        core::Bool                                                      m_workQueued{ false };  ///< Guarded by m_workMutex
+        core::Bool                                                      m_workRunning{ false }; ///< Guarded by m_workMutex
+        core::Bool                                                      m_stop{ false };        ///< Guarded by m_workMutex
+        ::std::thread                                                   m_worker;
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSLSMBACKEND_HPP
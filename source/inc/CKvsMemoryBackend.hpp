@@ -0,0 +1,168 @@
+/**
+ * @file CKvsMemoryBackend.hpp
+ * @brief Process-local in-memory KVS backend
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Keeps the values of one storage in an ordered map of this process, nothing
+ * is persisted and nothing is shared with other processes (use the Property
+ * backend with kvsNone for that). Get and set are defined in this header, so
+ * behind BasicKeyValueStorage< KvsMemoryBackend > they inline into the caller:
+ *
+ *   BasicKeyValueStorage< KvsMemoryBackend > scratch;
+ *   scratch.SetValue( "frame.count", core::UInt32( 1 ) );
+ */
+#ifndef LAP_PERSISTENCY_KVSMEMORYBACKEND_HPP
+#define LAP_PERSISTENCY_KVSMEMORYBACKEND_HPP
+
+#include <functional>
+#include <map>
+#include <string_view>
+#include <utility>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+#include "IKvsBackend.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief KVS backend holding its values in process memory only
+     *
+     * Thread Safety:
+     * - Map access serialized by a reader/writer lock; FetchAdd, CompareExchange
+     *   and SetIfAbsent hold it exclusively for the whole update
+     *
+     * SyncToStorage() has nothing to write; DiscardPendingChanges() drops every
+     * value, there is no stored state to return to.
+     */
+    class KvsMemoryBackend final : public IKvsBackend
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsMemoryBackend)
+
+        KvsMemoryBackend() noexcept = default;
+        ~KvsMemoryBackend() noexcept override = default;
+
+        core::Bool                                                      available() const noexcept override { return true; }
+        KvsBackendType                                                  GetBackendType() const noexcept override { return KvsBackendType::kvsNone; }
+        core::Bool                                                      SupportsPersistence() const noexcept override { return false; }
+
+        // Hot path, inline so a statically bound caller pays for the lookup only
+        core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept override
+        {
+            core::ReadLockGuard lock( m_rwLock );
+            return core::Result< core::Bool >::FromValue( m_values.find( mapKey( key ) ) != m_values.end() );
+        }
+
+        core::Result< KvsDataType > GetValue( core::StringView key ) const noexcept override
+        {
+            using result = core::Result< KvsDataType >;
+
+            core::ReadLockGuard lock( m_rwLock );
+            auto it = m_values.find( mapKey( key ) );
+            if ( it == m_values.end() ) return result::FromError( PerErrc::kKeyNotFound );
+
+            try {
+                return result::FromValue( it->second );
+            } catch ( const ::std::bad_alloc& ) {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+        }
+
+        core::Result< void > GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept override
+        {
+            using result = core::Result< void >;
+
+            core::ReadLockGuard lock( m_rwLock );
+            auto it = m_values.find( mapKey( key ) );
+            if ( it == m_values.end() ) return result::FromError( PerErrc::kKeyNotFound );
+            if ( ::lap::core::GetVariantIndex( it->second ) != ::lap::core::GetVariantIndex( out ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+            try {
+                out = it->second;   // Same alternative: strings and vectors keep their capacity
+                return result::FromValue();
+            } catch ( const ::std::bad_alloc& ) {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+        }
+
+        core::Result< void > SetValue( core::StringView key, const KvsDataType &value ) noexcept override
+        {
+            return store( key, value );
+        }
+
+        core::Result< void > SetValue( core::StringView key, KvsDataType &&value ) noexcept override
+        {
+            return store( key, ::std::move( value ) );
+        }
+
+        core::Result< KvsDataType > GetValueHashed( core::StringView key, core::UInt64 ) const noexcept override
+        {
+            return GetValue( key );
+        }
+
+        core::Result< void > SetValueHashed( core::StringView key, core::UInt64, const KvsDataType &value ) noexcept override
+        {
+            return store( key, value );
+        }
+
+        core::Result< core::Vector< core::String > >                    GetAllKeys() const noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
+        core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RemoveAllKeys() noexcept override;
+        core::Result< void >                                            SyncToStorage() noexcept override;
+        core::Result< void >                                            DiscardPendingChanges() noexcept override;
+        core::Result< core::UInt64 >                                    GetSize() const noexcept override;
+        core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
+
+    protected:
+        KvsMemoryBackend( const KvsMemoryBackend& ) = delete;
+        KvsMemoryBackend( KvsMemoryBackend&& ) = delete;
+        KvsMemoryBackend& operator=( const KvsMemoryBackend& ) = delete;
+
+    private:
+        // Ordered for snapshot chunks, transparent so a lookup builds no String
+        using _mapValue = ::std::map< core::String, KvsDataType, ::std::less<> >;
+
+        static ::std::string_view                                       mapKey( core::StringView key ) noexcept { return ::std::string_view( key.data(), key.size() ); }
+
+        template< class Value >
+        core::Result< void > store( core::StringView key, Value&& value ) noexcept
+        {
+            core::WriteLockGuard lock( m_rwLock );
+            try {
+                auto it = m_values.lower_bound( mapKey( key ) );
+                if ( it != m_values.end() && it->first == mapKey( key ) ) {
+                    it->second = ::std::forward< Value >( value );
+                } else {
+                    m_values.emplace_hint( it, core::String( key.data(), key.size() ), ::std::forward< Value >( value ) );
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+            }
+            m_snapshots.Changed( key );
+            return core::Result< void >::FromValue();
+        }
+
+    private:
+        _mapValue                                                       m_values;           ///< Guarded by m_rwLock
+        mutable KvsSnapshotCache                                        m_snapshots;        ///< Told of every change under m_rwLock
+        mutable core::RWLock                                            m_rwLock;
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSMEMORYBACKEND_HPP
@@ -0,0 +1,182 @@
+/**
+ * @file CKvsMemoryResource.hpp
+ * @brief Per-storage memory pool for KVS backend data
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A KvsMemoryResource is a std::pmr pool resource owned by one storage. With a
+ * capacity the pool draws its chunks from an arena allocated once at
+ * construction and never from the global heap, so the data of the storage has
+ * a fixed upper bound: an allocation past it fails with std::bad_alloc, which
+ * backends report as PerErrc::kOutOfMemorySpace. Without a capacity the pool
+ * draws chunks from the heap and only saves the per-allocation cost.
+ *
+ * Containers that take a std::pmr allocator use the resource directly. The
+ * file backend's JSON document cannot carry a stateful allocator (nlohmann
+ * default-constructs it), so it uses KvsScopedAllocator: allocations go to the
+ * resource of the innermost KvsMemoryScope on the calling thread, and each
+ * block records the resource it came from so it can be freed from anywhere.
+ */
+#ifndef LAP_PERSISTENCY_KVSMEMORYRESOURCE_HPP
+#define LAP_PERSISTENCY_KVSMEMORYRESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <lap/core/CTypedef.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Usage counters of one memory resource
+     */
+    struct KvsMemoryStatistics
+    {
+        core::Size      capacity{ 0 };          ///< Arena size, 0 when chunks come from the heap
+        core::Size      bytesInUse{ 0 };        ///< Requested bytes not yet freed
+        core::Size      peakBytes{ 0 };         ///< Highest bytesInUse so far
+        core::UInt64    allocations{ 0 };       ///< Allocations served
+        core::UInt64    failedAllocations{ 0 }; ///< Allocations refused because the arena was exhausted
+    };
+
+    /**
+     * @brief Thread-safe pool resource, optionally bounded by a preallocated arena
+     *
+     * Blocks up to LARGEST_POOL_BLOCK bytes are kept on one free list per
+     * BLOCK_ALIGNMENT size class: allocation and release are a list pop and push,
+     * new blocks are cut from the arena. Freed blocks stay in their size class.
+     * Larger blocks come from the heap without a capacity; with one they are cut
+     * from the arena and only return to it when the resource is destroyed, so
+     * size the arena for the largest values kept.
+     */
+    class KvsMemoryResource final : public ::std::pmr::memory_resource
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsMemoryResource)
+
+        static constexpr core::Size     BLOCK_ALIGNMENT         = alignof( ::std::max_align_t );
+        static constexpr core::Size     LARGEST_POOL_BLOCK      = 1024;
+
+        /**
+         * @param capacity Arena size in bytes, 0 for an unbounded pool over the heap
+         */
+        explicit KvsMemoryResource( core::Size capacity = 0 ) noexcept;
+        ~KvsMemoryResource() noexcept override = default;
+
+        KvsMemoryStatistics                                             GetStatistics() const noexcept;
+
+    protected:
+        KvsMemoryResource( const KvsMemoryResource& ) = delete;
+        KvsMemoryResource& operator=( const KvsMemoryResource& ) = delete;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock*                  next;
+        };
+
+        void*                                                           do_allocate( core::Size bytes, core::Size alignment ) override;
+        void                                                            do_deallocate( void* p, core::Size bytes, core::Size alignment ) override;
+        core::Bool                                                      do_is_equal( const ::std::pmr::memory_resource& other ) const noexcept override;
+
+    private:
+        ::std::unique_ptr< core::Byte[] >                               m_pArena;
+        ::std::pmr::monotonic_buffer_resource                           m_arena;            ///< Cuts new blocks from the arena (or heap chunks), never frees
+        ::std::pmr::memory_resource*                                    m_pLarge;           ///< Source of blocks above LARGEST_POOL_BLOCK
+
+        mutable core::Mutex                                             m_mutex;            ///< Guards the members below
+        FreeBlock*                                                      m_freeLists[ LARGEST_POOL_BLOCK / BLOCK_ALIGNMENT ]{};
+        KvsMemoryStatistics                                             m_stats;
+    };
+
+    /**
+     * @brief Routes KvsScopedAllocator allocations of the calling thread while alive
+     *
+     * Scopes nest; a nullptr resource selects the global heap, and so does the
+     * absence of any scope. An allocation outside a scope therefore does not
+     * fail but bypasses the pool's capacity: code that builds data meant to live
+     * in a pool must open the scope itself, it is not inherited from a caller on
+     * another thread.
+     */
+    class KvsMemoryScope final
+    {
+    public:
+        explicit KvsMemoryScope( ::std::pmr::memory_resource* resource ) noexcept
+            : m_pPrevious( slot() )
+        {
+            slot() = resource;
+        }
+
+        ~KvsMemoryScope() noexcept                                      { slot() = m_pPrevious; }
+
+        /// Resource of the innermost scope, the heap outside any scope
+        static ::std::pmr::memory_resource*                             current() noexcept
+        {
+            auto* resource = slot();
+            return resource != nullptr ? resource : ::std::pmr::new_delete_resource();
+        }
+
+        KvsMemoryScope( const KvsMemoryScope& ) = delete;
+        KvsMemoryScope& operator=( const KvsMemoryScope& ) = delete;
+
+    private:
+        static ::std::pmr::memory_resource*&                            slot() noexcept
+        {
+            static thread_local ::std::pmr::memory_resource* s_pResource = nullptr;
+            return s_pResource;
+        }
+
+    private:
+        ::std::pmr::memory_resource*                                    m_pPrevious;
+    };
+
+    /**
+     * @brief Stateless allocator drawing from KvsMemoryScope::current()
+     *
+     * Each block is prefixed with the resource it was taken from, so any
+     * instance can free any block and all instances compare equal.
+     */
+    template< class T >
+    class KvsScopedAllocator
+    {
+    public:
+        using value_type = T;
+
+        KvsScopedAllocator() noexcept = default;
+        template< class U >
+        KvsScopedAllocator( const KvsScopedAllocator< U >& ) noexcept {}
+
+        T* allocate( core::Size count )
+        {
+            static_assert( alignof( T ) <= HEADER_SIZE, "over-aligned types are not supported" );
+
+            auto* resource  = KvsMemoryScope::current();
+            auto* block     = static_cast< core::Byte* >( resource->allocate( HEADER_SIZE + count * sizeof( T ), HEADER_SIZE ) );
+            *reinterpret_cast< ::std::pmr::memory_resource** >( block ) = resource;
+            return reinterpret_cast< T* >( block + HEADER_SIZE );
+        }
+
+        void deallocate( T* p, core::Size count ) noexcept
+        {
+            auto* block = reinterpret_cast< core::Byte* >( p ) - HEADER_SIZE;
+            ( *reinterpret_cast< ::std::pmr::memory_resource** >( block ) )->deallocate( block, HEADER_SIZE + count * sizeof( T ), HEADER_SIZE );
+        }
+
+        template< class U >
+        core::Bool operator==( const KvsScopedAllocator< U >& ) const noexcept      { return true; }
+        template< class U >
+        core::Bool operator!=( const KvsScopedAllocator< U >& ) const noexcept      { return false; }
+
+    private:
+        static constexpr core::Size     HEADER_SIZE     = alignof( ::std::max_align_t );
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSMEMORYRESOURCE_HPP
@@ -0,0 +1,194 @@
+/**
+ * @file CKvsMmapBackend.hpp
+ * @brief Memory-mapped copy-on-write B+tree KVS backend for read-mostly instances
+ * @version 1.0
+ * @date 2025-11-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The instance is one file, "{instance}/current/kvs_data.mdb", mapped read-only
+ * into the process. Committed data is a B+tree of 4 KiB pages, so a lookup is
+ * a binary search per level over mapped pages: nothing is parsed at open and a
+ * read costs no system call.
+ *
+ * SyncToStorage() never overwrites a page the last commit can reach. Changed
+ * leaves and their ancestors are written to free pages, then the commit becomes
+ * durable by writing one of two meta pages (root, page count, free-page list,
+ * CRC32), alternating between them. After a crash the newest meta page with a
+ * valid checksum names a complete tree, so there is no log to replay.
+ *
+ * File layout (host byte order):
+ *   page 0, 1      meta pages, the higher valid transaction id wins
+ *   leaf page      [header][UInt16 offsets][cells: UInt16 keyLen, UInt8 type, UInt8 flags, UInt32 valueLen, key, value]
+ *   branch page    [header][UInt16 offsets][cells: UInt16 keyLen, UInt64 child, key], the first key is implicit
+ *   overflow run   contiguous pages holding one value too large for a leaf
+ *   free-list page [header][UInt64 next][UInt64 page numbers]
+ */
+#ifndef LAP_PERSISTENCY_KVSMMAPBACKEND_HPP
+#define LAP_PERSISTENCY_KVSMMAPBACKEND_HPP
+
+#include <atomic>
+#include <deque>
+#include <map>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+#include "IKvsBackend.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Sizing of one memory-mapped backend instance
+     */
+    struct KvsMmapOptions
+    {
+        core::Size      mapSize{ 256ul << 20 };     ///< Address space reserved for the file and the most it can grow to
+    };
+
+    /**
+     * @brief KVS backend storing an instance as a memory-mapped copy-on-write B+tree
+     *
+     * Reads of committed data take no lock: a reader registers the transaction it
+     * reads in a per-process reader table (one atomic store), walks the mapped tree
+     * and decodes the value straight from the page; GetValueInto() copies raw values
+     * from the map into the caller's buffer. Changes made since the last sync live
+     * in a small overlay, only reads while the overlay is non-empty take its lock.
+     *
+     * Pages freed by a commit are reused once no reader of an older transaction is
+     * left, so a long-lived snapshot holds back page reuse, not writers.
+     *
+     * The file is mapped, so the backend works on the local file system directly
+     * instead of through IVirtualFileSystem. One instance per file: a second open
+     * fails with kResourceBusy.
+     */
+    class KvsMmapBackend final : public IKvsBackend
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsMmapBackend)
+
+        static constexpr core::Size     PAGE_SIZE       = 4096;
+        static constexpr core::Size     MAX_KEY_SIZE    = 511;      ///< Longer keys are rejected with kInvalidKey
+
+        /**
+         * @param identifier KVS instance identifier, the file is "{instance}/current/kvs_data.mdb"
+         * @param options Size of the mapping
+         */
+        explicit KvsMmapBackend( core::StringView identifier, const KvsMmapOptions& options = KvsMmapOptions() ) noexcept;
+        ~KvsMmapBackend() noexcept override;
+
+        core::Bool                                                      available() const noexcept override { return m_bAvailable; }
+        KvsBackendType                                                  GetBackendType() const noexcept override { return KvsBackendType::kvsMmap; }
+        core::Bool                                                      SupportsPersistence() const noexcept override { return true; }
+
+        core::Result< core::Vector< core::String > >                    GetAllKeys() const noexcept override;
+        core::Result< core::Bool >                                      KeyExists( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValue( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept override;
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, KvsDataType &&value ) noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
+        core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
+        // Undoes a RemoveKey() that has not been synced yet
+        core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
+        // Same as RemoveKey(), the pages are reused by later commits
+        core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RemoveAllKeys() noexcept override;
+        core::Result< void >                                            SyncToStorage() noexcept override;
+        using IKvsBackend::SyncToStorage;                               // Budgeted variant runs a full sync
+        core::Result< void >                                            DiscardPendingChanges() noexcept override;
+        core::Result< core::UInt64 >                                    GetSize() const noexcept override;
+        core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
+
+        /// Id of the last commit, 0 for a new file; each SyncToStorage() that changed the tree adds one
+        core::UInt64                                                    GetTransactionId() const noexcept;
+
+    protected:
+        KvsMmapBackend() = delete;
+        KvsMmapBackend( const KvsMmapBackend& ) = delete;
+        KvsMmapBackend( KvsMmapBackend&& ) = delete;
+        KvsMmapBackend& operator=( const KvsMmapBackend& ) = delete;
+
+    private:
+        struct KeyLess
+        {
+            using is_transparent = void;
+
+            static core::StringView     view( const core::String& key ) noexcept    { return core::StringView( key.data(), key.size() ); }
+            static core::StringView     view( core::StringView key ) noexcept       { return key; }
+
+            template< class L, class R >
+            core::Bool                  operator()( const L& left, const R& right ) const noexcept { return view( left ) < view( right ); }
+        };
+
+        struct Record
+        {
+            core::Bool                  deleted{ false };
+            KvsDataType                 value;
+        };
+
+        // Changes not yet in the tree; cleared means RemoveAllKeys() hides every committed key
+        struct Batch
+        {
+            core::Bool                                      cleared{ false };
+            ::std::map< core::String, Record, KeyLess >     records;
+
+            core::Bool                  empty() const noexcept { return !cleared && records.empty(); }
+        };
+
+        // Pages the writer may hand out; pending pages wait for readers of older transactions
+        struct FreePages
+        {
+            core::Vector< core::UInt64 >                                        reusable;
+            ::std::deque< ::std::pair< core::UInt64, core::Vector< core::UInt64 > > > pending;     ///< Freed by transaction first
+            core::Vector< core::UInt64 >                                        listPages;  ///< Pages holding the committed free list
+        };
+
+        struct Env;
+        class ReadTxn;
+        class WriteTxn;
+        class Snapshot;
+
+        enum class Lookup : core::UInt8 { kMissing, kDeleted, kFound };
+
+        // Overlay first (newer, then older batch), then the tree of one committed transaction
+        static Lookup                                                   findInBatches( const Batch* newer, const Batch* older, core::StringView key, KvsDataType* out );
+        static core::Result< Lookup >                                   findInTree( const Env& env, core::UInt64 root, core::UInt64 pageCount, core::StringView key, KvsDataType* out );
+        static core::Result< core::Vector< core::String > >             collectKeys( const Env& env, core::UInt64 root, core::UInt64 pageCount, const Batch* newer, const Batch* older ) noexcept;
+
+        core::Result< Lookup >                                          find( core::StringView key, KvsDataType* out ) const noexcept;
+        core::Result< Lookup >                                          findLocked( core::StringView key, KvsDataType* out ) const noexcept;  ///< Caller holds m_rwLock
+        Batch&                                                          pending();             ///< Caller holds m_rwLock exclusively
+        core::Result< void >                                            put( core::StringView key, Record&& record ) noexcept;
+        void                                                            updateOverlayFlag() noexcept;
+
+        core::Result< void >                                            open() noexcept;
+
+    private:
+        core::String                                                    m_instancePath;
+        core::String                                                    m_filePath;
+        KvsMmapOptions                                                  m_options;
+        core::Bool                                                      m_bAvailable{ false };
+        core::SharedHandle< Env >                                       m_pEnv;             ///< Mapping and reader table, shared with snapshots
+
+        // Guarded by m_rwLock. A batch shared with a snapshot is copied before it is modified
+        mutable core::RWLock                                            m_rwLock;
+        core::SharedHandle< Batch >                                     m_pPending;         ///< Changes since the last sync
+        core::SharedHandle< Batch >                                     m_pSyncing;         ///< Batch being committed
+        ::std::atomic< core::Bool >                                     m_bOverlay{ false }; ///< Either batch is non-empty; readers skip the lock otherwise
+
+        core::Mutex                                                     m_syncMutex;        ///< One writer transaction at a time
+        FreePages                                                       m_free;             ///< Guarded by m_syncMutex
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSMMAPBACKEND_HPP
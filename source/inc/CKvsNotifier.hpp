@@ -0,0 +1,182 @@
+/**
+ * @file CKvsNotifier.hpp
+ * @brief Change notifications for KeyValueStorage
+ * @version 1.0
+ * @date 2025-11-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Writers publish change events into a lock-free multi-producer / single-consumer
+ * queue; a dispatcher thread drains it, coalesces the events per key (only the
+ * latest change of a key since the previous dispatch is delivered) and invokes
+ * the matching subscriptions:
+ *
+ *   auto id = kvs->Subscribe( "net.", []( const KvsChangeEvent& ev ) { reload( ev.key ); } );
+ *   ...
+ *   kvs->Unsubscribe( id.Value() );
+ *
+ * The dispatcher thread is started by the first subscription; a storage without
+ * subscribers pays one atomic load per write.
+ *
+ * Only changes made through this KeyValueStorage object are published. Writes
+ * by other processes (e.g. another connection to the same SQLite database,
+ * which a SQLite snapshot does observe through data_version) raise no event.
+ */
+
+#ifndef LAP_PERSISTENCY_KVSNOTIFIER_HPP
+#define LAP_PERSISTENCY_KVSNOTIFIER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CString.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Kind of change reported to subscribers
+     */
+    enum class KvsChangeType : core::UInt8
+    {
+        kSet            = 0,    ///< Key created or overwritten
+        kRemove         = 1,    ///< Key removed
+        kRemoveAll      = 2,    ///< All keys removed (store-wide, key is empty)
+        kReload         = 3     ///< Pending changes discarded, state reloaded from storage (store-wide, key is empty)
+    };
+
+    /**
+     * @brief Change delivered to a subscription
+     * @note Store-wide events (kRemoveAll, kReload) carry an empty key and reach every subscription
+     */
+    struct KvsChangeEvent
+    {
+        core::String                            key;
+        KvsChangeType                           type;
+    };
+
+    using KvsChangeCallback     = ::std::function< void( const KvsChangeEvent& ) >;
+    using KvsSubscriptionId     = core::UInt64;
+
+    /**
+     * @brief Subscription registry and dispatcher of one KeyValueStorage
+     *
+     * Thread Safety:
+     * - Publish() is lock-free and may be called from any thread
+     * - Callbacks run on the dispatcher thread, one at a time
+     * - After Unsubscribe() returns, the callback is not invoked again (unless
+     *   Unsubscribe() is called from inside a callback, which is allowed)
+     *
+     * Out of memory:
+     * - Publish() drops the change if its queue node cannot be allocated
+     * - If the dispatcher cannot coalesce a drained batch, its per-key events are
+     *   replaced by one kReload; if it cannot even copy the subscription list,
+     *   the batch is dropped. Both are logged and count as delivered for Flush()
+     */
+    class KvsNotifier final
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsNotifier)
+
+        KvsNotifier() noexcept;
+        ~KvsNotifier() noexcept;
+
+        KvsNotifier( const KvsNotifier& ) = delete;
+        KvsNotifier& operator=( const KvsNotifier& ) = delete;
+
+        /**
+         * @brief Subscribe to every key starting with @p prefix (empty prefix: all keys)
+         * @retval PerErrc::kInvalidArgument if @p callback is empty
+         * @retval PerErrc::kResourceBusy if the dispatcher thread cannot be started
+         */
+        core::Result< KvsSubscriptionId >       Subscribe( core::StringView prefix, KvsChangeCallback callback ) noexcept;
+
+        /**
+         * @brief Subscribe to an explicit set of keys
+         */
+        core::Result< KvsSubscriptionId >       Subscribe( const core::Vector< core::String >& keys, KvsChangeCallback callback ) noexcept;
+
+        /**
+         * @retval PerErrc::kInvalidArgument if @p id is not an active subscription
+         */
+        core::Result< void >                    Unsubscribe( KvsSubscriptionId id ) noexcept;
+
+        /// True while at least one subscription exists; writers skip Publish() otherwise
+        core::Bool                              HasSubscribers() const noexcept     { return m_subscriberCount.load( ::std::memory_order_acquire ) > 0; }
+
+        /**
+         * @brief Queue a change for delivery
+         * @param key Changed key, empty for store-wide changes
+         */
+        void                                    Publish( core::StringView key, KvsChangeType type ) noexcept;
+
+        /**
+         * @brief Block until every change published before the call has been delivered
+         * @note Returns immediately when called from a callback
+         */
+        void                                    Flush() noexcept;
+
+    private:
+        struct Node
+        {
+            ::std::atomic< Node* >              next{ nullptr };
+            core::String                        key;
+            KvsChangeType                       type{ KvsChangeType::kSet };
+        };
+
+        struct Subscription
+        {
+            KvsSubscriptionId                   id;
+            core::Bool                          byPrefix;
+            core::String                        prefix;
+            core::Vector< core::String >        keys;           ///< Sorted, used when !byPrefix
+            KvsChangeCallback                   callback;
+            ::std::atomic< core::Bool >         active{ true };
+
+            core::Bool                          matches( const core::String& key ) const noexcept;
+        };
+
+        core::Result< KvsSubscriptionId >       addSubscription( core::SharedHandle< Subscription > subscription ) noexcept;
+        core::Bool                              startDispatcher() noexcept;
+        void                                    dispatchLoop() noexcept;
+
+        // Vyukov intrusive MPSC queue: producers swap m_head, the dispatcher owns m_tail
+        void                                    push( Node* node ) noexcept;
+        Node*                                   pop() noexcept;
+
+    private:
+        Node                                    m_stub;
+        ::std::atomic< Node* >                  m_head{ &m_stub };
+        Node*                                   m_tail{ &m_stub };
+
+        ::std::atomic< core::UInt32 >           m_subscriberCount{ 0 };
+        ::std::atomic< core::Bool >             m_signaled{ false };
+        ::std::atomic< core::UInt64 >           m_published{ 0 };
+        core::UInt64                            m_delivered{ 0 };           ///< Guarded by m_waitMutex
+        core::Bool                              m_stop{ false };            ///< Guarded by m_waitMutex
+
+        core::Mutex                             m_waitMutex;
+        ::std::condition_variable_any           m_wakeup;
+        ::std::condition_variable_any           m_drained;
+
+        core::Mutex                             m_subscriptionMutex;
+        core::Vector< core::SharedHandle< Subscription > >  m_subscriptions;
+        KvsSubscriptionId                       m_nextId{ 1 };
+
+        core::Mutex                             m_dispatchMutex;            ///< Held while callbacks run
+        ::std::thread                           m_dispatcher;               ///< Assigned under m_subscriptionMutex
+        ::std::atomic< ::std::thread::id >      m_dispatcherId{};           ///< Published once m_dispatcher runs
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSNOTIFIER_HPP
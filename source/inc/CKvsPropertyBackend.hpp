@@ -1,7 +1,11 @@
 #ifndef LAP_PERSISTENCY_KVSPROPERTYBACKEND_HPP_
 #define LAP_PERSISTENCY_KVSPROPERTYBACKEND_HPP_
 
+#include <atomic>
+#include <unordered_set>
+
 #include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
 
 #include "CDataType.hpp"
 #include "IKvsBackend.hpp"
@@ -13,6 +17,29 @@ namespace per
 namespace util
 {
     class KeyValueStorageBase;
+
+    /**
+     * @brief String interning counters of the shared memory segment
+     */
+    struct KvsInternStatistics
+    {
+        core::Size      strings{ 0 };           ///< Distinct interned key prefixes and long string values
+        core::UInt64    references{ 0 };        ///< Keys and values referring to them
+        core::Size      segmentBytesUsed{ 0 };  ///< Segment bytes allocated, map and pool included
+    };
+
+    /**
+     * @brief Counters of the memory budget, hit rate = hits / ( hits + misses )
+     */
+    struct KvsEvictionStatistics
+    {
+        core::Size      budget{ 0 };            ///< Segment bytes kept resident, 0 when eviction is off
+        core::Size      segmentBytesUsed{ 0 };  ///< Segment bytes allocated now
+        core::UInt64    hits{ 0 };              ///< Reads served from shared memory
+        core::UInt64    misses{ 0 };            ///< Reads faulted back from the persistence backend
+        core::UInt64    evictions{ 0 };         ///< Values dropped from shared memory
+        core::UInt64    writeBacks{ 0 };        ///< Evicted values not synced yet, staged for the next SyncToStorage
+    };
     
     /**
      * @brief Shared memory-based KVS backend with persistent storage support
@@ -23,6 +50,17 @@ namespace util
      * - Automatic load/sync with persistence backend
      * - High-performance read/write (no disk I/O per operation)
      * - Inter-process communication support
+     * - Map access serialized by a process-wide reader/writer lock; FetchAdd,
+     *   CompareExchange and SetIfAbsent hold it exclusively for the whole update
+     * - Snapshots share a decoded base plus layers of the keys changed since,
+     *   readers of a snapshot take no lock (see KvsSnapshotCache)
+     * - Key prefixes (up to the last '.' or '/') and string values too long for
+     *   inline storage are interned once per segment and reference counted
+     * - With a memory budget (PersistencyConfig::kvs.propertyBackendMemoryBudget)
+     *   the least recently used values beyond it are evicted to the persistence
+     *   backend and faulted back on access; keys stay in shared memory. Values
+     *   evicted before they were synced are staged in process memory: the next
+     *   SyncToStorage publishes them, DiscardPendingChanges drops them
      */
     class KvsPropertyBackend final : public ::lap::per::IKvsBackend
     {
@@ -41,15 +79,56 @@ namespace util
         core::Result< core::Bool >                                      KeyExists ( core::StringView key ) const noexcept override;
         core::Result< KvsDataType >                                     GetValue( core::StringView key ) const noexcept override;
         core::Result< void >                                            SetValue( core::StringView key, const KvsDataType &value ) noexcept override;
+        using IKvsBackend::SetValue;
+        core::Result< void >                                            GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept override;
+        core::Result< void >                                            SetValueHashed( core::StringView key, core::UInt64 hash, const KvsDataType &value ) noexcept override;
+        void                                                            ResolveKey( const KvsKeyHandle& handle ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueResolved( const KvsKeyHandle& handle ) const noexcept override;
+        core::Result< void >                                            SetValueResolved( const KvsKeyHandle& handle, const KvsDataType &value ) noexcept override;
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
         core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
         core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
         core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
         core::Result< void >                                            RemoveAllKeys() noexcept override;
         core::Result< void >                                            SyncToStorage() noexcept override;
+
+        /**
+         * @brief Stage dirty values one per unit, publish them with the removals as one change, then sync
+         *        the persistence backend with the same meter
+         * @note The scan resumes at the hash bucket it stopped in; a rehash restarts it. Nothing reaches
+         *       the persistence backend before the publish, an abandoned round leaves it untouched
+         */
+        core::Result< KvsSyncProgress >                                 SyncToStorage( KvsSyncMeter& meter ) noexcept override;
         core::Result< void >                                            DiscardPendingChanges() noexcept override;
+
+        /**
+         * @brief Stream the map, one shared lock per batch; evicted values are read through, not faulted in
+         */
+        core::Result< core::UInt64 >                                    Export( IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE ) const noexcept override;
+
+        /**
+         * @brief Store a batch of records under one exclusive lock
+         * @note Bulk load pre-sizes the map to the source's expected records
+         */
+        core::Result< core::UInt64 >                                    Import( IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions() ) noexcept override;
         core::Result< core::UInt64 >                                    GetSize() const noexcept override;
         core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
 
+        /**
+         * @brief Interned strings of the shared memory segment and what they save
+         */
+        core::Result< KvsInternStatistics >                             GetInternStatistics() const noexcept;
+
+        /**
+         * @brief Memory budget usage and the hit rate of the shared memory tier
+         */
+        core::Result< KvsEvictionStatistics >                           GetEvictionStatistics() const noexcept;
+
         /**
          * @brief Default shared memory size (1MB)
          */
@@ -89,6 +168,57 @@ namespace util
          */
         core::Result<void> saveToPersistence() noexcept;
 
+        /**
+         * @brief Drop the state of an unfinished SyncToStorage( meter )
+         */
+        void resetIncrementalSync() noexcept;
+
+        /**
+         * @brief Hand a scanned round to the persistence backend as one ApplyChanges()
+         * @note Called with the map lock held exclusively; throws on allocation failure
+         */
+        core::Result< void > publishRound();
+
+        /**
+         * @brief Shared memory map node of a handle's key, re-resolved if the cached one is stale
+         * @return nullptr if the key doesn't exist
+         */
+        void* locateNode( const KvsKeyHandle& handle ) const;
+
+        core::Bool evictionEnabled() const noexcept                     { return m_memoryBudget > 0 && m_pPersistenceBackend; }
+
+        /**
+         * @brief Count a read of a resident value and stamp it for the LRU order
+         * @param value Mapped value of the shared memory map
+         */
+        void noteHit( const void* value ) const noexcept;
+
+        /**
+         * @brief Value of an evicted key, staged or read from the persistence backend; counted as a miss
+         */
+        core::Result< KvsDataType > loadEvicted( core::StringView key ) const noexcept;
+
+        /**
+         * @brief Value of an evicted key, staged or read from the persistence backend
+         */
+        core::Result< KvsDataType > readEvicted( core::StringView key ) const noexcept;
+
+        /**
+         * @brief Bring an evicted value back into shared memory, takes the map lock exclusively
+         * @return The value, or kKeyNotFound if the key was removed meanwhile
+         */
+        core::Result< KvsDataType > faultIn( core::StringView key, core::UInt64 hash ) const noexcept;
+
+        /**
+         * @brief Evict least recently used values until the segment is back under the budget
+         * @note Called with the map lock held exclusively. Victims are popped from an order taken by
+         *       one scan of the map; values used since are skipped and ordered by the next scan
+         */
+        void enforceBudget() const;
+
+        // Resident values a scan must find at least once keys alone exceed the budget
+        static constexpr core::Size     EVICTION_RESCAN_MIN = 64;
+
     private:
         core::Bool                      m_bAvailable{ false };
         core::String                    m_strIdentifier;          // Instance identifier
@@ -97,6 +227,28 @@ namespace util
         KvsBackendType                  m_persistenceBackend;     // File or SQLite
         ::std::unique_ptr<IKvsBackend>  m_pPersistenceBackend;    // Actual persistence backend
         core::Bool                      m_bDirty{ false };        // Track if sync needed
+        core::Size                      m_memoryBudget{ 0 };      // Segment bytes kept resident, 0 for no eviction
+        mutable ::std::atomic< core::UInt64 >  m_hits{ 0 };
+        mutable ::std::atomic< core::UInt64 >  m_misses{ 0 };
+        mutable ::std::atomic< core::UInt64 >  m_evictions{ 0 };
+        mutable ::std::atomic< core::UInt64 >  m_writeBacks{ 0 };
+        // Values evicted before they were synced, guarded by the map lock; an entry is current while its key stays evicted
+        mutable _mapValue               m_evictedChanges;
+        // Eviction order of the last scan, guarded by the map lock: ( lastUse, map node ), the oldest at the back
+        mutable core::Vector< ::std::pair< core::UInt64, void* > >  m_victims;
+        mutable core::UInt64            m_victimsGeneration{ 0 }; // m_generation the nodes of m_victims belong to
+        mutable core::Size              m_rescanResident{ 0 };    // Resident values needed before the next scan
+        core::UInt64                    m_generation{ nextGeneration() };  // Changes when map nodes may be freed
+        // Incremental sync state, guarded by the map lock
+        ::std::unordered_set< core::String >  m_removedKeys;      // Removed since the last sync, may still be in the persistence backend
+        core::Bool                      m_bFlushing{ false };     // A flush round is scanning the map
+        core::Bool                      m_bFlushed{ false };      // The round finished, the persistence backend sync is pending
+        core::UInt64                    m_flushRound{ 0 };        // Id of the round, SHM_Value::syncRound of the values it staged
+        KvsRecordBatch                  m_flushValues;            // Dirty values staged by the round
+        core::Size                      m_flushBucket{ 0 };       // Next bucket of the round
+        core::Size                      m_flushBuckets{ 0 };      // Bucket count the round started with
+        core::UInt64                    m_flushScanned{ 0 };      // Entries in the buckets scanned
+        core::UInt64                    m_flushVersion{ 0 };      // Map version when the round started
     };
 } // util
 } // pm
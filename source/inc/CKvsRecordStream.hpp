@@ -0,0 +1,200 @@
+/**
+ * @file CKvsRecordStream.hpp
+ * @brief Batched record streams for bulk export and import between KVS backends
+ * @version 1.0
+ * @date 2025-12-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * IKvsBackend::Export() pushes all records of a backend into a sink and
+ * IKvsBackend::Import() pulls them from a source, a batch at a time, so a
+ * store is converted or provisioned without a GetValue / SetValue round trip
+ * per key:
+ *
+ *   KvsRecordFileWriter writer( vfs, "factory.kvr" );
+ *   sqlite.Export( writer );
+ *   KvsRecordFileReader reader( vfs, "factory.kvr" );
+ *   property.Import( reader );
+ *
+ * Stream format, shared by files and in-memory buffers (integers in host byte order):
+ *
+ *   [UInt32 magic "KVR1"][UInt32 format][UInt64 expected records]
+ *   per batch:   [UInt32 records][UInt32 payload bytes][UInt32 crc32 of payload][payload]
+ *   per record:  [UInt32 keyLength][UInt32 valueLength][UInt8 type][key][value as kvsValueBytes()]
+ *   end:         [UInt32 0][UInt32 8][UInt32 crc32][UInt64 total records]
+ *
+ * The expected count is a hint for pre-sizing (0 if unknown); the end block
+ * carries the exact count, a stream without it is truncated.
+ */
+#ifndef LAP_PERSISTENCY_KVSRECORDSTREAM_HPP
+#define LAP_PERSISTENCY_KVSRECORDSTREAM_HPP
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CString.hpp>
+#include <lap/core/CMemory.hpp>
+
+#include "CDataType.hpp"
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief One key-value pair of a record stream
+     */
+    struct KvsRecord
+    {
+        core::String            key;
+        KvsDataType             value;
+    };
+
+    using KvsRecordBatch = core::Vector< KvsRecord >;
+
+    /// Records per batch unless the caller asks otherwise
+    constexpr core::Size        KVS_RECORD_BATCH_SIZE = 4096;
+
+    /**
+     * @brief Options of IKvsBackend::Import()
+     */
+    struct KvsImportOptions
+    {
+        core::Size              batchSize{ KVS_RECORD_BATCH_SIZE };    ///< Records read from the source per batch
+        core::Bool              bulkLoad{ true };       ///< SQLite: one transaction, secondary indexes rebuilt after the load;
+                                                        ///< Property: map pre-sized to the expected records
+        core::Bool              clearFirst{ false };    ///< Remove all keys of the target before importing
+    };
+
+    /**
+     * @brief Receiver of the batches of an export
+     */
+    class IKvsRecordSink
+    {
+    public:
+        virtual ~IKvsRecordSink() noexcept = default;
+
+        /**
+         * @brief Called once before the first batch
+         * @param expectedRecords Records the exporter expects to write, 0 if unknown
+         */
+        virtual core::Result< void >    Begin( core::UInt64 expectedRecords ) noexcept  { static_cast< void >( expectedRecords ); return core::Result< void >::FromValue(); }
+        virtual core::Result< void >    Write( const KvsRecordBatch& batch ) noexcept = 0;
+
+        /**
+         * @brief Called once after the last batch of a successful export
+         */
+        virtual core::Result< void >    Finish() noexcept                               { return core::Result< void >::FromValue(); }
+    };
+
+    /**
+     * @brief Supplier of the batches of an import
+     */
+    class IKvsRecordSource
+    {
+    public:
+        virtual ~IKvsRecordSource() noexcept = default;
+
+        /**
+         * @brief Records the source expects to deliver, 0 if unknown
+         */
+        virtual core::UInt64            ExpectedRecords() const noexcept                { return 0; }
+
+        /**
+         * @brief Replace @p batch by the next records, at most @p maxRecords
+         * @return Records read, 0 once the source is exhausted
+         * @retval PerErrc::kIntegrityCorrupted if the stream is damaged or truncated
+         */
+        virtual core::Result< core::Size > Read( KvsRecordBatch& batch, core::Size maxRecords ) noexcept = 0;
+    };
+
+    /**
+     * @brief Record stream held in memory, written as a sink and read back as a source
+     *
+     * Keeps the encoded stream, not the decoded records, so a whole store fits in
+     * about the size of its keys and values. Used to convert between backends
+     * without a file.
+     */
+    class KvsRecordBuffer final : public IKvsRecordSink, public IKvsRecordSource
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsRecordBuffer)
+
+        core::Result< void >            Begin( core::UInt64 expectedRecords ) noexcept override;
+        core::Result< void >            Write( const KvsRecordBatch& batch ) noexcept override;
+        core::Result< void >            Finish() noexcept override;
+
+        core::UInt64                    ExpectedRecords() const noexcept override       { return m_expected; }
+        core::Result< core::Size >      Read( KvsRecordBatch& batch, core::Size maxRecords ) noexcept override;
+
+        const core::Vector< core::UInt8 >&  Data() const noexcept                       { return m_data; }
+
+    private:
+        core::Vector< core::UInt8 >     m_data;
+        core::UInt64                    m_expected{ 0 };
+        core::UInt64                    m_written{ 0 };
+        core::Size                      m_readPos{ 0 };             ///< Next block to read, 0 before the header
+        core::UInt64                    m_read{ 0 };
+        KvsRecordBatch                  m_pending;                  ///< Records of a block not handed out yet
+        core::Size                      m_pendingPos{ 0 };
+        core::Bool                      m_bEnd{ false };
+    };
+
+    /**
+     * @brief Sink writing a record stream file, one AppendFile() per batch
+     */
+    class KvsRecordFileWriter final : public IKvsRecordSink
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsRecordFileWriter)
+
+        /**
+         * @param vfs File system to write on, nullptr for the process default
+         * @param path Stream file, replaced by Begin()
+         */
+        KvsRecordFileWriter( core::SharedHandle< IVirtualFileSystem > vfs, core::StringView path ) noexcept;
+
+        core::Result< void >            Begin( core::UInt64 expectedRecords ) noexcept override;
+        core::Result< void >            Write( const KvsRecordBatch& batch ) noexcept override;
+        core::Result< void >            Finish() noexcept override;
+
+    private:
+        core::SharedHandle< IVirtualFileSystem >    m_pVfs;
+        core::String                    m_strPath;
+        core::Vector< core::UInt8 >     m_block;                    ///< Encode buffer, reused across batches
+        core::UInt64                    m_written{ 0 };
+    };
+
+    /**
+     * @brief Source reading a record stream file, one ReadFileRange() per block
+     */
+    class KvsRecordFileReader final : public IKvsRecordSource
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsRecordFileReader)
+
+        /**
+         * @param vfs File system to read from, nullptr for the process default
+         * @param path Stream file written by KvsRecordFileWriter or KvsRecordBuffer::Data()
+         */
+        KvsRecordFileReader( core::SharedHandle< IVirtualFileSystem > vfs, core::StringView path ) noexcept;
+
+        core::UInt64                    ExpectedRecords() const noexcept override;
+        core::Result< core::Size >      Read( KvsRecordBatch& batch, core::Size maxRecords ) noexcept override;
+
+    private:
+        core::Result< void >            readHeader() const noexcept;
+
+    private:
+        core::SharedHandle< IVirtualFileSystem >    m_pVfs;
+        core::String                    m_strPath;
+        mutable core::UInt64            m_expected{ 0 };
+        mutable core::UInt64            m_offset{ 0 };              ///< Next block, 0 before the header
+        core::UInt64                    m_read{ 0 };
+        KvsRecordBatch                  m_pending;
+        core::Size                      m_pendingPos{ 0 };
+        core::Bool                      m_bEnd{ false };
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSRECORDSTREAM_HPP
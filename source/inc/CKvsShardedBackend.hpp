@@ -0,0 +1,199 @@
+/**
+ * @file CKvsShardedBackend.hpp
+ * @brief Hash-sharded KVS backend
+ * @version 1.0
+ * @date 2025-11-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Splits one KVS instance into N shards by key hash. Each shard is a complete
+ * File or SQLite backend with its own lock and its own files, stored under
+ * {instance}/shard_<i>/, so writers of different shards never contend and a
+ * sync rewrites only the shards that changed, in parallel.
+ *
+ * Enabled through PersistencyConfig::kvs.shardCount (> 1). The shard count and
+ * backend are recorded in {instance}/shards.json: routing depends on them, so an
+ * instance opened with other values is refused. A non-sharded instance is
+ * migrated into the shards the first time it is opened sharded, and its files
+ * are removed once the manifest routes every open to the shards.
+ */
+#ifndef LAP_PERSISTENCY_KVSSHARDEDBACKEND_HPP
+#define LAP_PERSISTENCY_KVSSHARDEDBACKEND_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <memory_resource>
+#include <thread>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+#include "IKvsBackend.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief KVS backend routing every key to one of N independent backends
+     *
+     * Thread Safety:
+     * - Per-key operations lock only their shard
+     * - Writers hold m_snapshotGate shared, so they never wait for each other on it;
+     *   CreateSnapshot() holds it exclusively while it pins every shard, which keeps
+     *   snapshots consistent across shards
+     */
+    class KvsShardedBackend final : public IKvsBackend
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsShardedBackend)
+
+        /**
+         * @brief Upper bound for the shard count, one directory and lock per shard
+         */
+        static constexpr core::UInt32 MAX_SHARD_COUNT = 256;
+
+        /**
+         * @brief Shard manifest under the instance directory, written once the shards hold the instance
+         */
+        static constexpr const core::Char* MANIFEST_FILE = "shards.json";
+
+        /**
+         * @brief Upper bound for the sync threads, the caller of SyncToStorage() counts as one
+         */
+        static constexpr core::UInt32 MAX_SYNC_THREADS = 8;
+
+        /**
+         * @brief True if @p identifier has a shard manifest, so it must be opened sharded
+         */
+        static core::Bool                                               IsSharded( core::StringView identifier ) noexcept;
+
+        /**
+         * @brief Read the shard backend and count recorded for @p identifier, the only values it opens with
+         * @return kValidationFailed if it has no manifest, kIntegrityCorrupted if the manifest cannot be parsed
+         */
+        static core::Result< void >                                     ReadManifest( core::StringView identifier, KvsBackendType& shardBackend,
+                                                                                      core::UInt32& shardCount ) noexcept;
+
+        /**
+         * @param identifier KVS instance identifier, shard i uses "{identifier}/shard_<i>"
+         * @param shardBackend kvsFile or kvsSqlite (Property shares one process-wide map and falls back to kvsFile)
+         * @param shardCount Number of shards, clamped to [1, MAX_SHARD_COUNT]
+         * @param resource Pool shared by the documents of File shards, must outlive the backend (nullptr = global heap)
+         * @param tuning PRAGMAs of SQLite shards
+         */
+        KvsShardedBackend( core::StringView identifier, KvsBackendType shardBackend, core::UInt32 shardCount,
+                           ::std::pmr::memory_resource* resource = nullptr,
+                           const KvsSqliteTuning& tuning = KvsSqliteTuning() ) noexcept;
+        ~KvsShardedBackend() noexcept override;
+
+        core::Bool                                                      available() const noexcept override { return m_bAvailable; }
+        KvsBackendType                                                  GetBackendType() const noexcept override { return m_shardBackend; }
+        core::Bool                                                      SupportsPersistence() const noexcept override { return true; }
+
+        core::UInt32                                                    GetShardCount() const noexcept { return static_cast< core::UInt32 >( m_shards.size() ); }
+        core::UInt32                                                    GetShardIndex( core::StringView key ) const noexcept { return shardOf( kvsKeyHash( key ) ); }
+
+        // Merged over all shards, sorted by key
+        core::Result< core::Vector< core::String > >                    GetAllKeys() const noexcept override;
+        core::Result< core::Bool >                                      KeyExists( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValue( core::StringView key ) const noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< void >                                            SetValue( core::StringView key, KvsDataType &&value ) noexcept override;
+        core::Result< void >                                            GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept override;
+        core::Result< void >                                            SetValueHashed( core::StringView key, core::UInt64 hash, const KvsDataType &value ) noexcept override;
+        void                                                            ResolveKey( const KvsKeyHandle& handle ) const noexcept override;
+        core::Result< KvsDataType >                                     GetValueResolved( const KvsKeyHandle& handle ) const noexcept override;
+        core::Result< void >                                            SetValueResolved( const KvsKeyHandle& handle, const KvsDataType &value ) noexcept override;
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
+        core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
+        core::Result< void >                                            RemoveAllKeys() noexcept override;
+        // Shards written since their last sync are synced concurrently on the sync workers, clean ones are skipped
+        core::Result< void >                                            SyncToStorage() noexcept override;
+        // Dirty shards in turn, all drawing from the one budget
+        core::Result< KvsSyncProgress >                                 SyncToStorage( KvsSyncMeter& meter ) noexcept override;
+        core::Result< void >                                            DiscardPendingChanges() noexcept override;
+        core::Result< core::UInt64 >                                    GetSize() const noexcept override;
+        core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
+
+    protected:
+        KvsShardedBackend() = delete;
+        KvsShardedBackend( const KvsShardedBackend& ) = delete;
+        KvsShardedBackend( KvsShardedBackend&& ) = delete;
+        KvsShardedBackend& operator=( const KvsShardedBackend& ) = delete;
+
+    private:
+        core::UInt32                                                    shardOf( core::UInt64 hash ) const noexcept { return static_cast< core::UInt32 >( hash % m_shards.size() ); }
+        IKvsBackend&                                                    shard( core::StringView key ) const noexcept { return *m_shards[ shardOf( kvsKeyHash( key ) ) ]; }
+
+        // Raised after every write to shard @p index, so a sync never misses it
+        void                                                            touch( core::UInt32 index ) noexcept { m_pDirty[ index ].store( true, ::std::memory_order_release ); }
+        void                                                            touch( core::StringView key ) noexcept { touch( shardOf( kvsKeyHash( key ) ) ); }
+
+        /**
+         * @brief Check @p instancePath against its manifest, or against what is on disk when it has none
+         * @param recorded Set if the manifest exists
+         * @param legacy Set if a non-sharded instance must be migrated into the shards
+         */
+        core::Result< void >                                            checkManifest( const core::String& instancePath, core::UInt32 shardCount,
+                                                                                       core::Bool& recorded, core::Bool& legacy ) const noexcept;
+        core::Result< void >                                            writeManifest( const core::String& instancePath ) const noexcept;
+
+        /**
+         * @brief Copy every key of the non-sharded instance into the shards and sync them
+         */
+        core::Result< void >                                            migrate( core::StringView identifier, const KvsSqliteTuning& tuning ) noexcept;
+
+        /**
+         * @brief Remove the files of the migrated non-sharded instance, left behind if a crash hit between manifest and removal
+         */
+        void                                                            removeLegacy( const core::String& instancePath ) const noexcept;
+
+        /**
+         * @brief Sync shard @p index if it is dirty, on the calling thread
+         */
+        core::Result< void >                                            syncShard( core::Size index ) noexcept;
+
+        /**
+         * @brief Start the sync workers on the first concurrent sync, false if none could be started
+         */
+        core::Bool                                                      startWorkers() noexcept;
+        void                                                            workLoop() noexcept;
+
+        /**
+         * @brief Sync the shards of the current pass until none is left to claim
+         */
+        void                                                            claimShards() noexcept;
+
+    private:
+        core::Bool                                                      m_bAvailable{ false };
+        KvsBackendType                                                  m_shardBackend{ KvsBackendType::kvsFile };
+        core::Vector< core::UniqueHandle< IKvsBackend > >               m_shards;
+        core::UniqueHandle< ::std::atomic< core::Bool >[] >             m_pDirty;           ///< Per shard, written since its last SyncToStorage()
+        mutable core::RWLock                                            m_snapshotGate;     ///< Shared by writers, exclusive while a snapshot pins all shards
+
+        core::Mutex                                                     m_syncMutex;        ///< One concurrent sync pass at a time
+        core::Vector< core::Result< void > >                            m_syncResults;      ///< Per shard, guarded by m_syncMutex
+        ::std::atomic< core::Size >                                     m_syncCursor{ 0 };  ///< Next shard of the pass to claim
+
+        core::Mutex                                                     m_workMutex;
+        ::std::condition_variable_any                                   m_workCv;
+        ::std::condition_variable_any                                   m_idleCv;
+        core::UInt64                                                    m_syncPass{ 0 };    ///< Guarded by m_workMutex, raised to start a pass
+        core::Size                                                      m_workersBusy{ 0 }; ///< Guarded by m_workMutex
+        core::Bool                                                      m_stop{ false };    ///< Guarded by m_workMutex
+        core::Vector< ::std::thread >                                   m_workers;          ///< Started by the first concurrent sync
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSSHARDEDBACKEND_HPP
@@ -0,0 +1,233 @@
+/**
+ * @file CKvsSnapshot.hpp
+ * @brief Point-in-time read views of a KeyValueStorage
+ * @version 1.0
+ * @date 2025-11-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A snapshot pins the content of a storage at the moment it is taken. Reads
+ * through it see neither later writes nor each other's interleavings, and take
+ * no backend lock, so a reader walking many related keys never blocks writers:
+ *
+ *   auto snap = kvs->Snapshot().Value();
+ *   auto x = snap.GetValue< Double >( "pose.x" );
+ *   auto y = snap.GetValue< Double >( "pose.y" );     // same version as x
+ */
+
+#ifndef LAP_PERSISTENCY_KVSSNAPSHOT_HPP
+#define LAP_PERSISTENCY_KVSSNAPSHOT_HPP
+
+#include <functional>
+#include <unordered_set>
+#include <utility>
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CString.hpp>
+#include <lap/core/CMemory.hpp>
+#include <lap/core/CSync.hpp>
+
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Backend side of a snapshot
+     * @note Implementations must stay valid after the backend that created them is destroyed
+     */
+    class IKvsSnapshot
+    {
+    public:
+        IMP_OPERATOR_NEW(IKvsSnapshot)
+
+        virtual ~IKvsSnapshot() noexcept = default;
+
+        virtual core::Result< core::Vector< core::String > >    GetAllKeys() const noexcept = 0;
+        virtual core::Result< core::Bool >                      KeyExists( core::StringView key ) const noexcept = 0;
+        virtual core::Result< KvsDataType >                     GetValue( core::StringView key ) const noexcept = 0;
+        virtual core::Result< core::UInt32 >                    GetKeyCount() const noexcept = 0;
+    };
+
+    /**
+     * @brief Snapshot over a key-sorted base plus the changes made since it was built
+     *
+     * Base and layers are immutable and shared by every snapshot that includes them,
+     * so a snapshot taken after a few writes costs a layer of those keys, not a copy.
+     */
+    class KvsMapSnapshot final : public IKvsSnapshot
+    {
+    public:
+        IMP_OPERATOR_NEW(KvsMapSnapshot)
+
+        using Entry     = ::std::pair< core::String, KvsDataType >;
+        using Entries   = core::Vector< Entry >;
+
+        /// New value of a key, or its removal
+        struct Change
+        {
+            core::String                                        key;
+            core::Bool                                          removed{ false };
+            KvsDataType                                         value;
+        };
+        using Changes   = core::Vector< Change >;                                   ///< Sorted by key, one per key
+        using Layers    = core::Vector< core::SharedHandle< const Changes > >;      ///< Oldest first
+
+        /// Sort @p entries by key, ready to be shared by KvsMapSnapshot instances
+        static void                                             SortEntries( Entries& entries ) noexcept;
+
+        /// Sort @p changes by key
+        static void                                             SortChanges( Changes& changes ) noexcept;
+
+        KvsMapSnapshot( core::SharedHandle< const Entries > base, Layers layers, core::UInt32 count ) noexcept
+            : m_pBase( ::std::move( base ) )
+            , m_layers( ::std::move( layers ) )
+            , m_count( count )
+        {
+            ;
+        }
+
+        core::Result< core::Vector< core::String > >            GetAllKeys() const noexcept override;
+        core::Result< core::Bool >                              KeyExists( core::StringView key ) const noexcept override;
+        core::Result< KvsDataType >                             GetValue( core::StringView key ) const noexcept override;
+        core::Result< core::UInt32 >                            GetKeyCount() const noexcept override;
+
+        /**
+         * @brief Walks the keys of a snapshot in order, base and layers merged
+         * @note The snapshot must outlive the cursor
+         */
+        class Cursor final
+        {
+        public:
+            explicit Cursor( const KvsMapSnapshot& snapshot );
+
+            /// Continue after @p key
+            void                                                Seek( core::StringView key ) noexcept;
+
+            /// Next live entry, false at the end
+            core::Bool                                          Next( core::StringView& key, const KvsDataType*& value ) noexcept;
+
+        private:
+            core::StringView                                    keyAt( core::Size source ) const noexcept;
+
+        private:
+            const KvsMapSnapshot&                               m_snapshot;
+            core::Vector< core::Size >                          m_positions;    ///< Base first, then each layer
+        };
+
+    private:
+        friend class KvsSnapshotCache;
+
+        /// Value of @p key as of this snapshot, nullptr if absent
+        const KvsDataType*                                      find( core::StringView key ) const noexcept;
+
+    private:
+        core::SharedHandle< const Entries >                     m_pBase;
+        Layers                                                  m_layers;
+        core::UInt32                                            m_count;
+    };
+
+    /**
+     * @brief Snapshot state of an in-memory backend, kept current from the keys its writers change
+     *
+     * Writers report each change under the backend's exclusive lock. The next Acquire()
+     * decodes only those keys under the shared lock and adds them as a layer over the shared
+     * base; layers are merged into a new base after the backend lock is released.
+     *
+     * There is no base until the first Acquire(), nor after Invalidate() or once more keys
+     * changed than a quarter of the map: the map is then copied in chunks of CHUNK_ENTRIES,
+     * with the backend lock released between chunks and the keys changed meanwhile applied
+     * on top. The backend lock is never held for a copy of the whole map.
+     */
+    class KvsSnapshotCache final
+    {
+    public:
+        /// Append the next entries of the map to @p out, from the start when it is empty; true once the map is done
+        using ChunkReader   = ::std::function< core::Result< core::Bool >( KvsMapSnapshot::Entries& out, core::Size limit ) >;
+        /// Decode the value of @p key into @p out; false if the key doesn't exist
+        using KeyReader     = ::std::function< core::Result< core::Bool >( core::StringView key, KvsDataType& out ) >;
+
+        static constexpr core::Size CHUNK_ENTRIES   = 1024;     ///< Entries copied per shared lock while building a base
+        static constexpr core::Size MAX_LAYERS      = 8;        ///< Layers kept before they are merged into the base
+
+        /**
+         * @brief Record a change of @p key
+         * @note Caller holds the backend lock exclusively
+         */
+        void                                                    Changed( core::StringView key ) noexcept;
+
+        /**
+         * @brief Record the removal of all keys
+         * @note Caller holds the backend lock exclusively
+         */
+        void                                                    Cleared() noexcept;
+
+        /**
+         * @brief Forget the tracked state after the map was replaced, e.g. by a reload
+         * @note Caller holds the backend lock exclusively
+         */
+        void                                                    Invalidate() noexcept;
+
+        /**
+         * @brief Snapshot of the current map
+         * @param lock The backend lock, taken shared by this call
+         * @param readChunk Called under @p lock while a base is built
+         * @param readKey Called under @p lock for each changed key
+         * @note Caller holds no backend lock
+         */
+        core::Result< core::SharedHandle< IKvsSnapshot > >      Acquire( core::RWLock& lock, const ChunkReader& readChunk,
+                                                                         const KeyReader& readKey ) noexcept;
+
+    private:
+        core::Result< void >                                    rebuild( core::RWLock& lock, const ChunkReader& readChunk,
+                                                                         const KeyReader& readKey );
+        core::Result< core::Bool >                              update( core::RWLock& lock, const KeyReader& readKey );
+        core::Result< void >                                    readChanges( const KeyReader& readKey, KvsMapSnapshot::Changes& changes );
+        void                                                    addLayer( KvsMapSnapshot::Changes&& changes );
+        void                                                    compact() noexcept;
+
+    private:
+        // Guarded by the backend lock: written by writers, and by Acquire() under the shared lock
+        core::Bool                                              m_bTracking{ false };   ///< A base exists or is being built
+        core::Bool                                              m_bLost{ false };       ///< Changes were not recorded, a new base is needed
+        core::Bool                                              m_bCleared{ false };    ///< All keys were removed before m_changed
+        core::Size                                              m_trackLimit{ 0 };      ///< m_changed size beyond which a rebuild is cheaper
+        ::std::unordered_set< core::String >                    m_changed;
+
+        // Guarded by m_mutex, taken before the backend lock
+        core::Mutex                                             m_mutex;
+        core::SharedHandle< KvsMapSnapshot >                    m_pCurrent;             ///< Latest snapshot, never modified once published
+    };
+
+    /**
+     * @brief Read-only view of a KeyValueStorage pinned to one version
+     *
+     * Cheap to copy; all copies share the pinned state, which is released with the
+     * last copy. Safe to read from several threads.
+     */
+    class KvsSnapshot final
+    {
+    public:
+        KvsSnapshot() noexcept = default;
+        explicit KvsSnapshot( core::SharedHandle< IKvsSnapshot > snapshot ) noexcept
+            : m_pSnapshot( ::std::move( snapshot ) )
+        {
+            ;
+        }
+
+        core::Result< core::Vector< core::String > >            GetAllKeys() const noexcept;
+        core::Result< core::Bool >                              KeyExists( core::StringView key ) const noexcept;
+        core::Result< core::UInt32 >                            GetKeyCount() const noexcept;
+
+        template< class T >
+        core::Result< T >                                       GetValue( core::StringView key ) const noexcept;
+
+    private:
+        core::SharedHandle< IKvsSnapshot >                      m_pSnapshot;
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSSNAPSHOT_HPP
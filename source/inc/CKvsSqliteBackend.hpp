@@ -17,6 +17,7 @@
 
 #include "CDataType.hpp"
 #include "IKvsBackend.hpp"
+#include "CKvsBloomFilter.hpp"
 
 namespace lap
 {
@@ -37,17 +38,54 @@ namespace per
         core::Result< core::Bool >                                      KeyExists ( core::StringView key ) const noexcept override;
         core::Result< KvsDataType >                                     GetValue( core::StringView key ) const noexcept override;
         core::Result< void >                                            SetValue( core::StringView key, const KvsDataType &value ) noexcept override;
+        using IKvsBackend::SetValue;
+        core::Result< void >                                            GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept override;
+        core::Result< core::Size >                                      GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept override;
+        core::Result< KvsDataType >                                     FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept override;
+        core::Result< core::Bool >                                      CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept override;
+        core::Result< core::Bool >                                      SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept override;
+        // Read transaction on a connection owned by the snapshot, writers are never blocked (WAL)
+        core::Result< core::SharedHandle< IKvsSnapshot > >              CreateSnapshot() const noexcept override;
         core::Result< void >                                            RemoveKey( core::StringView key ) noexcept override;
         core::Result< void >                                            RecoverKey( core::StringView key ) noexcept override;
         core::Result< void >                                            ResetKey( core::StringView key ) noexcept override;
         core::Result< void >                                            RemoveAllKeys() noexcept override;
         core::Result< void >                                            SyncToStorage() noexcept override;
+        // Commit, then a passive checkpoint if the WAL frames left fit the budget (cost predicted from the last checkpoint)
+        core::Result< KvsSyncProgress >                                 SyncToStorage( KvsSyncMeter& meter ) noexcept override;
         core::Result< void >                                            DiscardPendingChanges() noexcept override;
+        // Primary key order, one statement per batch; the connection mutex is released between batches
+        core::Result< core::UInt64 >                                    Export( IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE ) const noexcept override;
+        // Bulk load: one transaction, secondary indexes built once after the load if it outgrows the table.
+        // Otherwise one transaction per batch
+        core::Result< core::UInt64 >                                    Import( IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions() ) noexcept override;
+        // One transaction: the removals and values commit together or not at all
+        core::Result< void >                                            ApplyChanges( const KvsRecordBatch& values, const core::Vector< core::String >& removedKeys ) noexcept override;
         core::Result< core::UInt64 >                                    GetSize() const noexcept override;
         core::Result< core::UInt32 >                                    GetKeyCount() const noexcept override;
 
+        /**
+         * @brief Counters of the negative-lookup filter
+         * @note KeyExists() and key misses in the Get* paths are answered from the filter
+         *       when it rules the key out and no other connection has committed since it was built
+         */
+        KvsBloomFilterStats                                             GetBloomFilterStats() const noexcept;
+
+        /**
+         * @brief True if the instance lives in a database shared with other instances
+         */
+        core::Bool                                                      IsShared() const noexcept { return m_bShared; }
+
         ~KvsSqliteBackend();
-        explicit KvsSqliteBackend( core::StringView );
+        /**
+         * @param identifier Instance identifier
+         * @param sharedDatabase Empty: the instance has its own database file. Otherwise the identifier of
+         *        a database shared by all instances naming it: each instance gets a table of its own in that
+         *        file, and the process holds one connection to it (one page cache, one WAL, one checkpoint)
+         * @param tuning PRAGMAs of the connection; in a shared database those of the instance that opened it
+         */
+        explicit KvsSqliteBackend( core::StringView identifier, core::StringView sharedDatabase = core::StringView(),
+                                   const KvsSqliteTuning& tuning = KvsSqliteTuning() );
         KvsSqliteBackend( KvsSqliteBackend&& );
 
     protected:
@@ -59,6 +97,8 @@ namespace per
 
     private:
         // Helper functions
+        // Statement texts on this instance's table and indexes, per instance in a shared database
+        void                                buildSql();
         core::Result< void >                initializeDatabase() noexcept;
         core::Result< void >                prepareStatements() noexcept;
         void                                finalizeStatements() noexcept;
@@ -69,16 +109,51 @@ namespace per
         // Type encoding/decoding (optimized with separate type column)
         core::Int32                         getTypeIndex( const KvsDataType& value ) const noexcept;
         core::String                        encodeValue( const KvsDataType& value ) const noexcept;
-        core::Result< KvsDataType >         decodeValue( core::Int32 typeIndex, core::StringView valueStr ) const noexcept;
+        static core::Result< KvsDataType >  decodeValue( core::Int32 typeIndex, core::StringView valueStr ) noexcept;
+        // Decode the (type, value) columns 0 and 1 of the current row of stmt
+        static core::Result< KvsDataType >  decodeRow( sqlite3_stmt* stmt, core::StringView key ) noexcept;
+        void                                bindValue( sqlite3_stmt* stmt, core::Int32 index, const KvsDataType& value, core::String& encoded ) const noexcept;
+        
+        // Statement steps shared by the public operations, caller holds the connection mutex
+        core::Result< KvsDataType >         selectValue( core::StringView key ) const noexcept;
+        core::Result< core::Bool >          insertIfAbsent( core::StringView key, const KvsDataType& value ) noexcept;
+        core::Result< core::Bool >          compareSwap( core::StringView key, const KvsDataType& expected, const KvsDataType& desired ) noexcept;
+        
+        // Negative-lookup filter, caller holds the connection mutex
+        void                                rebuildBloom() const noexcept;
+        core::Bool                          bloomExcludes( core::StringView key ) const noexcept;
+        void                                bloomMissed() const noexcept;
+        void                                bloomAdd( core::StringView key ) noexcept;
+        core::Bool                          readDataVersion( core::Int64& version ) const noexcept;
         
         // Error handling
-        core::ErrorCode                     makeErrorCode( core::Int32 sqliteCode ) const noexcept;
+        static core::ErrorCode              makeErrorCode( core::Int32 sqliteCode ) noexcept;
+        
+        // Conditional writes lost to other connections before FetchAdd gives up
+        static constexpr core::UInt32       MAX_RMW_ATTEMPTS = 16;
+        // Unfiltered lookups (or removals) tolerated before the filter is rebuilt, at least this many
+        static constexpr core::UInt64       BLOOM_MIN_REBUILD_INTERVAL = 64;
+        
+        class Snapshot;
+        class Connection;
+        
+        // SQL of the instance, built once by buildSql() from its table and index names
+        struct Sql
+        {
+            core::String    createTable, createDeletedIndex, createTypeIndex, dropIndexes;
+            core::String    insert, update, select, exists, remove, getAll, insertIfAbsent, compareSwap;
+            core::String    recover, reset, removeAll, purgeDeleted, exportBatch, countRows, countLive, liveSize;
+        };
         
     private:
         core::Bool                          m_bAvailable{ false };
+        core::Bool                          m_bShared{ false };
         core::String                        m_strFile;
-        sqlite3*                            m_pDB{ nullptr };
-        mutable core::Mutex                 m_mutex;
+        core::String                        m_strInstance;              ///< Names the instance's table in a shared database
+        Sql                                 m_sql;
+        // Connection with its mutex, transaction and WAL state; shared by all instances of a shared database
+        core::SharedHandle< Connection >    m_pConnection;
+        sqlite3*                            m_pDB{ nullptr };           ///< Handle of m_pConnection
         
         // Prepared statements for performance
         sqlite3_stmt*                       m_pStmtInsert{ nullptr };
@@ -87,9 +162,22 @@ namespace per
         sqlite3_stmt*                       m_pStmtExists{ nullptr };
         sqlite3_stmt*                       m_pStmtDelete{ nullptr };
         sqlite3_stmt*                       m_pStmtGetAll{ nullptr };
+        sqlite3_stmt*                       m_pStmtInsertIfAbsent{ nullptr };
+        sqlite3_stmt*                       m_pStmtCompareSwap{ nullptr };
+        sqlite3_stmt*                       m_pStmtDataVersion{ nullptr };
         
-        // Transaction management
-        core::Bool                          m_bInTransaction{ false };
+        // Negative-lookup filter over live keys, guarded by the connection mutex (lookups rebuild it lazily)
+        mutable KvsBloomFilter              m_bloom;
+        mutable KvsBloomFilterStats         m_bloomStats;
+        mutable core::Int64                 m_bloomDataVersion{ -1 };   ///< PRAGMA data_version the filter is current for
+        mutable core::Bool                  m_bloomValid{ false };
+        mutable core::Bool                  m_bloomPassed{ false };     ///< Last lookup passed the filter
+        mutable core::UInt64                m_bloomUnfiltered{ 0 };     ///< Lookups served without the filter since it went stale
+        mutable core::UInt64                m_bloomRemoved{ 0 };        ///< Removals since the last rebuild
+        // Shared database: inserts into this instance by all its backends on the connection, which
+        // data_version does not report; the filter is current for m_bloomInserts of them
+        core::UInt64*                       m_pInserts{ nullptr };
+        mutable core::UInt64                m_bloomInserts{ 0 };
     };
 } // pm
 } // ara
@@ -0,0 +1,101 @@
+/**
+ * @file CKvsSyncBudget.hpp
+ * @brief Work limits for incremental SyncToStorage calls
+ * @version 1.0
+ * @date 2025-11-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * SyncToStorage( budget ) does at most the given amount of work and returns,
+ * resuming where it stopped on the next call, so a caller with a deadline
+ * (a cyclic control task) can persist its state in slices:
+ *
+ *   KvsSyncBudget budget;
+ *   budget.microseconds = 2000;
+ *   auto progress = kvs->SyncToStorage( budget );   // once per cycle until complete
+ *
+ * Backends split a sync into units (one record serialized or flushed, one
+ * chunk written or verified, one commit or checkpoint) and run a unit only if
+ * the budget still covers it. The time of a unit is predicted from the
+ * longest unit of the call so far, or from what the backend knows of its cost
+ * (earlier chunks of the same sync, the last SQLite checkpoint). The first
+ * unit of a call always runs, so the sync keeps moving even if one unit (a
+ * checkpoint cannot be split) is larger than the budget; only such a unit
+ * makes a call overrun.
+ * A backend that syncs through another one passes its meter on, both draw
+ * from the same budget.
+ */
+#ifndef LAP_PERSISTENCY_KVSSYNCBUDGET_HPP
+#define LAP_PERSISTENCY_KVSSYNCBUDGET_HPP
+
+#include <chrono>
+#include <limits>
+
+#include <lap/core/CTypedef.hpp>
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief Work allowed for one SyncToStorage( budget ) call, 0 = no limit for that measure
+     */
+    struct KvsSyncBudget
+    {
+        core::UInt64    bytes{ 0 };             ///< Bytes written, verified or checkpointed
+        core::UInt64    records{ 0 };           ///< Records serialized, flushed or committed
+        core::UInt64    microseconds{ 0 };      ///< Wall time spent in the call
+    };
+
+    /**
+     * @brief State of an incremental sync after a SyncToStorage( budget ) call
+     */
+    struct KvsSyncProgress
+    {
+        core::Bool      complete{ true };       ///< All changes before the sync started are durable
+        core::UInt64    remainingRecords{ 0 };  ///< Records still to serialize, flush or commit
+        core::UInt64    remainingBytes{ 0 };    ///< Bytes still to write, verify or checkpoint, as far as known yet
+    };
+
+    /**
+     * @brief Tracks the work of one SyncToStorage( budget ) call against its budget
+     */
+    class KvsSyncMeter final
+    {
+    public:
+        using Clock = ::std::chrono::steady_clock;
+
+        static constexpr core::UInt64   UNLIMITED   = ::std::numeric_limits< core::UInt64 >::max();
+
+        explicit KvsSyncMeter( const KvsSyncBudget& budget ) noexcept;
+
+        /**
+         * @brief True if a unit of @p records and @p bytes still fits the budget
+         * @param estimateNs Expected time of the unit, the longest unit so far is used if it is larger
+         */
+        core::Bool                      admit( core::UInt64 records, core::UInt64 bytes, core::UInt64 estimateNs = 0 ) const noexcept;
+
+        /**
+         * @brief Account a finished unit, its time is measured since the previous one
+         */
+        void                            spend( core::UInt64 records, core::UInt64 bytes ) noexcept;
+
+        core::UInt64                    bytesLeft() const noexcept;
+        core::UInt64                    recordsLeft() const noexcept;
+
+    private:
+        core::UInt64                    elapsedNs() const noexcept;
+
+    private:
+        KvsSyncBudget                   m_budget;
+        Clock::time_point               m_start;
+        Clock::time_point               m_unitStart;
+        core::UInt64                    m_units{ 0 };
+        core::UInt64                    m_bytes{ 0 };
+        core::UInt64                    m_records{ 0 };
+        core::UInt64                    m_longestUnitNs{ 0 };
+    };
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_KVSSYNCBUDGET_HPP
@@ -0,0 +1,88 @@
+/**
+ * @file CMemoryFileSystem.hpp
+ * @brief In-Memory File System - IVirtualFileSystem kept entirely in process memory
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Used by unit tests and simulations to run the file-based backends without
+ * touching the disk. Content is lost when the last handle is released.
+ */
+
+#ifndef LAP_PERSISTENCY_MEMORYFILESYSTEM_HPP
+#define LAP_PERSISTENCY_MEMORYFILESYSTEM_HPP
+
+#include <map>
+#include <set>
+#include <lap/core/CSync.hpp>
+
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    class CMemoryFileSystem final : public IVirtualFileSystem
+    {
+    public:
+        IMP_OPERATOR_NEW(CMemoryFileSystem)
+
+    public:
+        core::Bool                                      Exists( core::StringView path ) const noexcept override;
+        core::Bool                                      IsDirectory( core::StringView path ) const noexcept override;
+        core::Result< core::UInt64 >                    GetFileSize( core::StringView path ) const noexcept override;
+        core::String                                    GetModificationTime( core::StringView path ) const noexcept override;
+        core::Vector< core::String >                    ListFiles( core::StringView dirPath ) const noexcept override;
+
+        core::Result< core::Vector< core::UInt8 > >     ReadFile( core::StringView path ) const noexcept override;
+        core::Result< core::Vector< core::UInt8 > >     ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept override;
+        core::Result< void >                            WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< void >                            RemoveFile( core::StringView path ) noexcept override;
+        core::Result< void >                            AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< core::UniqueHandle< IVirtualFileWriter > >  OpenWriter( core::StringView path ) noexcept override;
+        core::Result< void >                            RenameFile( core::StringView from, core::StringView to ) noexcept override;
+        core::Result< void >                            CopyFile( core::StringView from, core::StringView to ) noexcept override;
+
+        core::Result< void >                            CreateDirectory( core::StringView path ) noexcept override;
+
+        /**
+         * @brief Total number of bytes held by all files
+         */
+        core::UInt64                                    GetTotalBytes() const noexcept;
+
+        /**
+         * @brief Number of regular files
+         */
+        core::Size                                      GetFileCount() const noexcept;
+
+        /**
+         * @brief Drop all files and directories
+         */
+        void                                            Clear() noexcept;
+
+        CMemoryFileSystem() noexcept = default;
+        ~CMemoryFileSystem() noexcept override = default;
+
+    private:
+        struct MemoryFile
+        {
+            core::Vector< core::UInt8 >     data;
+            core::UInt64                    mtime{ 0 };     ///< Logical modification clock
+        };
+
+        static core::String                             normalize( core::StringView path ) noexcept;
+        static core::String                             parentOf( const core::String& path ) noexcept;
+        void                                            addDirectories( const core::String& dirPath ) noexcept;
+
+    private:
+        ::std::map< core::String, MemoryFile >          m_files;
+        ::std::set< core::String >                      m_dirs;
+        core::UInt64                                    m_clock{ 0 };
+        mutable core::Mutex                             m_mutex;
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_MEMORYFILESYSTEM_HPP
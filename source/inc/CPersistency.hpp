@@ -13,8 +13,6 @@
 #include <lap/core/CCore.hpp>
 #include <lap/log/CLog.hpp>
 
-#define LAP_DEBUG
-
 // per common
 #include "CDataType.hpp"
 #include "CPerErrorDomain.hpp"
@@ -28,6 +26,8 @@
 
 // kv
 #include "CKeyValueStorage.hpp"
+#include "CBasicKeyValueStorage.hpp"
+#include "CKvsMemoryBackend.hpp"
 
 #include "CPersistencyManager.hpp"
 
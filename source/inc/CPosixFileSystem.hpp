@@ -0,0 +1,52 @@
+/**
+ * @file CPosixFileSystem.hpp
+ * @brief POSIX File System - IVirtualFileSystem backed by the real file system
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Thin adapter over core::File::Util and core::Path. This is the file system
+ * used by all backends unless another one is injected.
+ */
+
+#ifndef LAP_PERSISTENCY_POSIXFILESYSTEM_HPP
+#define LAP_PERSISTENCY_POSIXFILESYSTEM_HPP
+
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    class CPosixFileSystem final : public IVirtualFileSystem
+    {
+    public:
+        IMP_OPERATOR_NEW(CPosixFileSystem)
+
+    public:
+        core::Bool                                      Exists( core::StringView path ) const noexcept override;
+        core::Bool                                      IsDirectory( core::StringView path ) const noexcept override;
+        core::Result< core::UInt64 >                    GetFileSize( core::StringView path ) const noexcept override;
+        core::String                                    GetModificationTime( core::StringView path ) const noexcept override;
+        core::Vector< core::String >                    ListFiles( core::StringView dirPath ) const noexcept override;
+
+        core::Result< core::Vector< core::UInt8 > >     ReadFile( core::StringView path ) const noexcept override;
+        core::Result< core::Vector< core::UInt8 > >     ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept override;
+        core::Result< void >                            WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< void >                            RemoveFile( core::StringView path ) noexcept override;
+        core::Result< void >                            AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept override;
+        core::Result< core::UniqueHandle< IVirtualFileWriter > >  OpenWriter( core::StringView path ) noexcept override;
+        core::Result< void >                            RenameFile( core::StringView from, core::StringView to ) noexcept override;
+        core::Result< void >                            CopyFile( core::StringView from, core::StringView to ) noexcept override;
+
+        core::Result< void >                            CreateDirectory( core::StringView path ) noexcept override;
+
+        CPosixFileSystem() noexcept = default;
+        ~CPosixFileSystem() noexcept override = default;
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_POSIXFILESYSTEM_HPP
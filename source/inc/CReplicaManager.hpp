@@ -17,6 +17,7 @@
 #include <lap/core/CPath.hpp>
 #include <lap/core/CCrypto.hpp>
 #include "CDataType.hpp"
+#include "IVirtualFileSystem.hpp"
 
 namespace lap {
 namespace per {
@@ -66,12 +67,14 @@ public:
      * @param replicaCount Total number of replicas (N)
      * @param minValidReplicas Minimum valid replicas required (M)
      * @param checksumType Algorithm for integrity verification
+     * @param vfs File system holding the replicas (nullptr = IVirtualFileSystem::getDefault())
      */
     explicit CReplicaManager(
         const core::String& baseStoragePath,
         core::UInt32 replicaCount = LAP_PER_DEFAULT_REPLICA_COUNT,
         core::UInt32 minValidReplicas = LAP_PER_MIN_VALID_REPLICAS,
-        ChecksumType checksumType = ChecksumType::kCRC32
+        ChecksumType checksumType = ChecksumType::kCRC32,
+        core::SharedHandle<IVirtualFileSystem> vfs = nullptr
     ) noexcept;
 
     ~CReplicaManager() = default;
@@ -234,6 +237,7 @@ private:
     core::UInt32 m_replicaCount;        // N: Total replicas
     core::UInt32 m_minValidReplicas;    // M: Minimum valid required
     ChecksumType m_checksumType;        // Checksum algorithm
+    core::SharedHandle<IVirtualFileSystem> m_pVfs;  // Injected file system
 };
 
 } // namespace per
@@ -23,6 +23,10 @@
 #include <lap/core/CMemory.hpp>
 
 #include "CDataType.hpp"
+#include "CKvsKey.hpp"
+#include "CKvsRecordStream.hpp"
+#include "CKvsSnapshot.hpp"
+#include "CKvsSyncBudget.hpp"
 
 namespace lap
 {
@@ -185,7 +189,7 @@ namespace per
         /**
          * @brief Get backend type identifier
          * 
-         * @return KvsBackendType Backend type (kvsFile, kvsSqlite, or kvsProperty)
+         * @return KvsBackendType Backend type (kvsFile, kvsSqlite, kvsProperty, kvsLsm or kvsMmap)
          * 
          * @note Used for backend identification and factory creation
          */
@@ -227,8 +231,159 @@ namespace per
         virtual core::Result<void> SetValue(core::StringView key, const KvsDataType& value) noexcept = 0;
 
         /**
-         * @brief Remove a key-value pair
+         * @brief Set value, taking ownership of its buffers
+         * 
+         * @param key The key to set
+         * @param value The value to set (moved from)
+         * @return core::Result<void> Success or error code
+         * 
+         * @note Default forwards to SetValue( key, const KvsDataType& ); backends whose
+         *       representation can adopt the value (LSM, Mmap) move strings instead of copying
+         */
+        virtual core::Result<void> SetValue(core::StringView key, KvsDataType&& value) noexcept;
+
+        /**
+         * @brief Read a value into an existing KvsDataType, reusing its buffer
+         * 
+         * @param key The key to lookup
+         * @param out Holds the expected alternative on entry; a String, blob or array
+         *            keeps its capacity and is assigned in place
+         * @return core::Result<void> Success or error code
+         * 
+         * @retval PerErrc::kDataTypeMismatch if the stored value is of another type, @p out is left untouched
+         * @note Default implementation goes through GetValue() and moves the result into @p out
+         */
+        virtual core::Result<void> GetValueAssign(core::StringView key, KvsDataType& out) const noexcept;
+
+        /**
+         * @brief Get value using a precomputed key hash
+         * 
+         * @param key The key to lookup
+         * @param hash kvsKeyHash( key ), e.g. taken from a constexpr KvsKey<T>
+         * @return core::Result<KvsDataType> Value or error code
+         * 
+         * @note Default ignores the hash; hash-indexed backends use it to skip rehashing the key
+         */
+        virtual core::Result<KvsDataType> GetValueHashed(core::StringView key, core::UInt64 hash) const noexcept;
+
+        /**
+         * @brief Set value using a precomputed key hash
+         * 
+         * @param key The key to set
+         * @param hash kvsKeyHash( key ), e.g. taken from a constexpr KvsKey<T>
+         * @param value The value to set
+         * @return core::Result<void> Success or error code
+         * 
+         * @note Default ignores the hash; hash-indexed backends use it to skip rehashing the key
+         */
+        virtual core::Result<void> SetValueHashed(core::StringView key, core::UInt64 hash, const KvsDataType& value) noexcept;
+
+        /**
+         * @brief Cache the backend location of a key in a handle
+         * 
+         * @param handle Handle created by KeyValueStorage::Resolve()
+         * 
+         * @note Default does nothing; node-based backends (Property, File) cache the map node.
+         *       Missing keys are resolved lazily on first access through the handle
+         */
+        virtual void ResolveKey(const KvsKeyHandle& handle) const noexcept;
+
+        /**
+         * @brief Get value through a resolved key handle
+         * 
+         * @param handle Handle created by KeyValueStorage::Resolve()
+         * @return core::Result<KvsDataType> Value or error code
+         * 
+         * @note Default falls back to GetValueHashed(); a stale handle is re-resolved
+         */
+        virtual core::Result<KvsDataType> GetValueResolved(const KvsKeyHandle& handle) const noexcept;
+
+        /**
+         * @brief Set value through a resolved key handle
+         * 
+         * @param handle Handle created by KeyValueStorage::Resolve()
+         * @param value The value to set
+         * @return core::Result<void> Success or error code
+         * 
+         * @note Default falls back to SetValueHashed(); a stale handle is re-resolved
+         */
+        virtual core::Result<void> SetValueResolved(const KvsKeyHandle& handle, const KvsDataType& value) noexcept;
+
+        /**
+         * @brief Copy a blob or numeric array value into a caller-provided buffer
          * 
+         * @param key The key to lookup
+         * @param type Expected raw type (DataType_blob or DataType_*_array)
+         * @param buffer Destination buffer
+         * @return core::Result<core::Size> Number of bytes written
+         * 
+         * @retval PerErrc::kDataTypeMismatch if the stored value is not of @p type
+         * @retval PerErrc::kWrongDataSize if @p buffer is smaller than the stored value
+         * @note Default implementation goes through GetValue(); backends override it
+         *       to copy straight from their storage without allocating
+         */
+        virtual core::Result<core::Size> GetValueInto(core::StringView key,
+                                                      EKvsDataTypeIndicate type,
+                                                      core::Span<core::Byte> buffer) const noexcept;
+
+        // ==================== Atomic Read-Modify-Write ====================
+        // Each call is a single step inside the backend (one lock / one statement),
+        // so concurrent callers never observe or overwrite an intermediate state
+
+        /**
+         * @brief Add @p delta to a numeric value and return the previous value
+         *
+         * @param key The key to update
+         * @param delta Amount to add, its type selects the value type
+         * @return core::Result<KvsDataType> Value before the addition
+         *
+         * @retval PerErrc::kDataTypeMismatch if the stored value is of another type, or @p delta is not
+         *         an integer or floating point type
+         * @note A missing key is created with value @p delta, the returned previous value is zero
+         * @note Integers wrap around on overflow
+         */
+        virtual core::Result<KvsDataType> FetchAdd(core::StringView key, const KvsDataType& delta) noexcept = 0;
+
+        /**
+         * @brief Replace a value only if it currently equals @p expected
+         *
+         * @param key The key to update
+         * @param expected Value the key must hold (type and value)
+         * @param desired New value
+         * @return core::Result<core::Bool> True if the value was replaced
+         *
+         * @retval PerErrc::kKeyNotFound if key doesn't exist
+         */
+        virtual core::Result<core::Bool> CompareExchange(core::StringView key,
+                                                         const KvsDataType& expected,
+                                                         const KvsDataType& desired) noexcept = 0;
+
+        /**
+         * @brief Set a value only if the key doesn't exist yet
+         *
+         * @param key The key to set
+         * @param value The value to set
+         * @return core::Result<core::Bool> True if the key was created, false if it already existed
+         */
+        virtual core::Result<core::Bool> SetIfAbsent(core::StringView key, const KvsDataType& value) noexcept = 0;
+
+        // ==================== Snapshots ====================
+
+        /**
+         * @brief Take a read-only view pinned to the current version
+         *
+         * @return core::Result<core::SharedHandle<IKvsSnapshot>> Snapshot, independent of the backend's lifetime
+         *
+         * @note Reads through the snapshot take no backend lock and never see later writes
+         * @note In-memory backends share an immutable base and add a layer of the keys changed
+         *       since (KvsSnapshotCache); database backends pin a read transaction on a connection
+         *       of their own
+         */
+        virtual core::Result<core::SharedHandle<IKvsSnapshot>> CreateSnapshot() const noexcept = 0;
+
+        /**
+         * @brief Remove a key-value pair
+         *
          * @param key The key to remove
          * @return core::Result<void> Success or error code
          * 
@@ -256,6 +411,61 @@ namespace per
          */
         virtual core::Result<void> SyncToStorage() noexcept = 0;
 
+        /**
+         * @brief Synchronize changes in slices, doing at most the work @p meter allows
+         *
+         * @param meter Budget of the calling SyncToStorage( budget ), shared with nested backends
+         * @return core::Result<KvsSyncProgress> Whether the sync completed and the work left
+         *
+         * @note Resumes the sync an earlier call left unfinished; SyncToStorage() and
+         *       DiscardPendingChanges() abandon it
+         * @note Default: a full SyncToStorage(), for backends without incremental sync
+         */
+        virtual core::Result<KvsSyncProgress> SyncToStorage(KvsSyncMeter& meter) noexcept;
+
+        // ==================== Bulk Transfer ====================
+
+        /**
+         * @brief Stream all records into @p sink, a batch at a time
+         *
+         * @param sink Receives Begin( key count ), the batches and Finish()
+         * @param batchSize Records per Write()
+         * @return core::Result<core::UInt64> Records exported
+         *
+         * @note Default: GetAllKeys(), then GetValue() per key; backends override it to read
+         *       a batch under one lock or statement
+         * @note Keys written during the export may or may not be included
+         */
+        virtual core::Result<core::UInt64> Export(IKvsRecordSink& sink, core::Size batchSize = KVS_RECORD_BATCH_SIZE) const noexcept;
+
+        /**
+         * @brief Store all records of @p source, overwriting existing keys
+         *
+         * @param source Supplies the records, its ExpectedRecords() pre-sizes the target
+         * @param options Batch size, bulk-load mode, clearing the target first
+         * @return core::Result<core::UInt64> Records imported
+         *
+         * @note Default: SetValue() per record; backends override it to store a batch
+         *       under one lock or transaction
+         * @note Like SetValue(), the records are durable after the next SyncToStorage()
+         * @note On error the records of the batches before it stay imported, except
+         *       for a SQLite bulk load, which is one transaction
+         */
+        virtual core::Result<core::UInt64> Import(IKvsRecordSource& source, const KvsImportOptions& options = KvsImportOptions()) noexcept;
+
+        /**
+         * @brief Remove keys and store values as one change
+         *
+         * @param values Records to store, overwriting existing keys
+         * @param removedKeys Keys to remove first, missing ones are skipped
+         * @return core::Result<void> Success or error code
+         *
+         * @note Default: RemoveKey() and SetValue() in turn; SQLite runs them in one
+         *       transaction, so a failure or crash leaves all of them or none
+         * @note Like SetValue(), the changes are durable after the next SyncToStorage()
+         */
+        virtual core::Result<void> ApplyChanges(const KvsRecordBatch& values, const core::Vector<core::String>& removedKeys) noexcept;
+
         // ==================== Static Utility Methods ====================
 
         /**
@@ -297,6 +507,26 @@ namespace per
         // Protected constructor - interface cannot be instantiated directly
         IKvsBackend() noexcept = default;
 
+        // ==================== Key Handle Support ====================
+
+        /**
+         * @brief Allocate a generation number for cached key locations
+         * 
+         * @note Unique per process, so a handle can never match a generation of another
+         *       (or a destroyed) backend instance
+         */
+        static core::UInt64 nextGeneration() noexcept;
+
+        /**
+         * @brief Cached location of @p handle, nullptr unless it was cached in @p generation
+         */
+        static void* cachedNode(const KvsKeyHandle& handle, core::UInt64 generation) noexcept;
+
+        /**
+         * @brief Store @p node as the location of @p handle for @p generation
+         */
+        static void cacheNode(const KvsKeyHandle& handle, void* node, core::UInt64 generation) noexcept;
+
         // Disable copy and move
         IKvsBackend(const IKvsBackend&) = delete;
         IKvsBackend(IKvsBackend&&) = delete;
@@ -0,0 +1,196 @@
+/**
+ * @file IVirtualFileSystem.hpp
+ * @brief Virtual File System Interface - Storage I/O abstraction for persistency backends
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * This file defines the abstract file system used by the file-based backends
+ * (KvsFileBackend, CFileStorageBackend, CReplicaManager). Implementations:
+ * - CPosixFileSystem:          Real file system via core::File / core::Path (default)
+ * - CMemoryFileSystem:         Process-local in-memory tree for tests and simulation
+ * - CFaultInjectionFileSystem: Decorator injecting latency, ENOSPC and torn writes
+ *
+ * @note This interface follows Core module constraints:
+ * - Uses core::String, core::Vector, core::Result types
+ * - No exceptions thrown
+ * - Thread-safe operations
+ */
+
+#ifndef LAP_PERSISTENCY_IVIRTUALFILESYSTEM_HPP
+#define LAP_PERSISTENCY_IVIRTUALFILESYSTEM_HPP
+
+#include <lap/core/CResult.hpp>
+#include <lap/core/CString.hpp>
+#include <lap/core/CMemory.hpp>
+
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    /**
+     * @brief File kept open for writing across calls
+     *
+     * Write() appends without flushing; Sync() makes everything written durable. A
+     * writer destroyed without Sync() leaves its data to the OS cache.
+     */
+    class IVirtualFileWriter
+    {
+    public:
+        IMP_OPERATOR_NEW(IVirtualFileWriter)
+
+        virtual ~IVirtualFileWriter() noexcept = default;
+
+        /**
+         * @brief Append data to the file
+         */
+        virtual core::Result<void> Write(const core::UInt8* data, core::Size size) noexcept = 0;
+
+        /**
+         * @brief Flush the file to the device
+         */
+        virtual core::Result<void> Sync() noexcept = 0;
+    };
+
+    /**
+     * @brief Abstract interface for file system access
+     *
+     * Paths are absolute, '/' separated strings. Directory semantics follow
+     * POSIX: WriteFile() creates missing parent directories, RenameFile()
+     * atomically replaces an existing destination.
+     *
+     * Error Handling:
+     * - Missing source files:     PerErrc::kFileNotFound
+     * - Device out of space:      PerErrc::kOutOfStorageSpace
+     * - Any other I/O failure:    PerErrc::kPhysicalStorageFailure
+     */
+    class IVirtualFileSystem
+    {
+    public:
+        IMP_OPERATOR_NEW(IVirtualFileSystem)
+
+        /**
+         * @brief Virtual destructor
+         */
+        virtual ~IVirtualFileSystem() noexcept = default;
+
+        // ==================== Query ====================
+
+        /**
+         * @brief Check if a file or directory exists
+         */
+        virtual core::Bool Exists(core::StringView path) const noexcept = 0;
+
+        /**
+         * @brief Check if path is a directory
+         */
+        virtual core::Bool IsDirectory(core::StringView path) const noexcept = 0;
+
+        /**
+         * @brief Get file size in bytes
+         * @retval PerErrc::kFileNotFound if file doesn't exist
+         */
+        virtual core::Result<core::UInt64> GetFileSize(core::StringView path) const noexcept = 0;
+
+        /**
+         * @brief Get last modification timestamp (implementation-defined format)
+         * @return Empty string if file doesn't exist
+         */
+        virtual core::String GetModificationTime(core::StringView path) const noexcept = 0;
+
+        /**
+         * @brief List regular files (names only, no path) in a directory
+         * @return Empty vector if directory doesn't exist
+         */
+        virtual core::Vector<core::String> ListFiles(core::StringView dirPath) const noexcept = 0;
+
+        // ==================== File I/O ====================
+
+        /**
+         * @brief Read whole file content
+         * @retval PerErrc::kFileNotFound if file doesn't exist or cannot be read
+         */
+        virtual core::Result<core::Vector<core::UInt8>> ReadFile(core::StringView path) const noexcept = 0;
+
+        /**
+         * @brief Read @p size bytes starting at byte @p offset
+         * @retval PerErrc::kFileNotFound if file doesn't exist or cannot be read
+         * @retval PerErrc::kWrongDataSize if the range extends past the end of the file
+         */
+        virtual core::Result<core::Vector<core::UInt8>> ReadFileRange(core::StringView path,
+                                                                      core::UInt64 offset,
+                                                                      core::Size size) const noexcept = 0;
+
+        /**
+         * @brief Create or truncate a file and write data to it
+         * @note Missing parent directories are created
+         */
+        virtual core::Result<void> WriteFile(core::StringView path,
+                                             const core::UInt8* data,
+                                             core::Size size) noexcept = 0;
+
+        /**
+         * @brief Remove a file
+         * @retval PerErrc::kFileNotFound if file doesn't exist
+         */
+        virtual core::Result<void> RemoveFile(core::StringView path) noexcept = 0;
+
+        /**
+         * @brief Append data to the end of a file and flush it to the device
+         * @note The file and missing parent directories are created
+         */
+        virtual core::Result<void> AppendFile(core::StringView path,
+                                              const core::UInt8* data,
+                                              core::Size size) noexcept = 0;
+
+        /**
+         * @brief Create or truncate a file and keep it open for writing
+         * @note Missing parent directories are created. Use it to write a file in pieces
+         *       with one flush at the end, where AppendFile() would flush every piece
+         */
+        virtual core::Result<core::UniqueHandle<IVirtualFileWriter>> OpenWriter(core::StringView path) noexcept = 0;
+
+        /**
+         * @brief Atomically rename a file, replacing the destination if present
+         */
+        virtual core::Result<void> RenameFile(core::StringView from, core::StringView to) noexcept = 0;
+
+        /**
+         * @brief Copy a file, replacing the destination if present
+         */
+        virtual core::Result<void> CopyFile(core::StringView from, core::StringView to) noexcept = 0;
+
+        // ==================== Directory ====================
+
+        /**
+         * @brief Create a directory including missing parents
+         * @note Succeeds if directory already exists
+         */
+        virtual core::Result<void> CreateDirectory(core::StringView path) noexcept = 0;
+
+        // ==================== Static Utility Methods ====================
+
+        /**
+         * @brief Get process-wide default file system (CPosixFileSystem)
+         * @note Used by backends when no file system is injected
+         */
+        static core::SharedHandle<IVirtualFileSystem> getDefault() noexcept;
+
+    protected:
+        // Protected constructor - interface cannot be instantiated directly
+        IVirtualFileSystem() noexcept = default;
+
+        // Disable copy and move
+        IVirtualFileSystem(const IVirtualFileSystem&) = delete;
+        IVirtualFileSystem(IVirtualFileSystem&&) = delete;
+        IVirtualFileSystem& operator=(const IVirtualFileSystem&) = delete;
+        IVirtualFileSystem& operator=(IVirtualFileSystem&&) = delete;
+    };
+
+} // namespace per
+} // namespace lap
+
+#endif // LAP_PERSISTENCY_IVIRTUALFILESYSTEM_HPP
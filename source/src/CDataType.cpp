@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
 #include "CDataType.hpp"
+#include "CKvsKey.hpp"
 
 namespace lap 
 {
@@ -11,8 +18,142 @@ namespace per
         return left;
     }
 
+    namespace
+    {
+        template < class V >
+        core::Bool rawView( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept
+        {
+            const V& vec = ::lap::core::get< V >( value );
+            data = reinterpret_cast< const core::Byte* >( vec.data() );
+            size = vec.size() * sizeof( typename V::value_type );
+            return true;
+        }
+
+        template < class V >
+        core::Bool rawAssign( const core::Byte* data, core::Size size, KvsDataType &value )
+        {
+            if ( size % sizeof( typename V::value_type ) != 0 ) return false;
+
+            // Assign in place when value already holds a V, so its capacity is reused
+            if ( ::lap::core::GetVariantIndex( value ) != KvsKey< V >::Index ) {
+                value = V();
+            }
+            auto &vec = ::lap::core::get< V >( value );
+            vec.resize( size / sizeof( typename V::value_type ) );
+            if ( size > 0 ) ::std::memcpy( vec.data(), data, size );
+            return true;
+        }
+
+        template < class T >
+        core::Bool scalarBytes( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept
+        {
+            data = reinterpret_cast< const core::Byte* >( &::lap::core::get< T >( value ) );
+            size = sizeof( T );
+            return true;
+        }
+
+        template < class T >
+        core::Bool scalarFromBytes( const core::Byte* data, core::Size size, KvsDataType &value ) noexcept
+        {
+            if ( size != sizeof( T ) ) return false;
+            T scalar;
+            ::std::memcpy( &scalar, data, sizeof( T ) );
+            value = scalar;
+            return true;
+        }
+
+        template < class T >
+        core::Bool addScalar( const KvsDataType &current, const KvsDataType &delta, KvsDataType &sum ) noexcept
+        {
+            const T lhs = ::lap::core::get< T >( current );
+            const T rhs = ::lap::core::get< T >( delta );
+            if constexpr ( ::std::is_integral< T >::value ) {
+                // Unsigned arithmetic wraps instead of overflowing, like a hardware counter
+                using U = ::std::make_unsigned_t< T >;
+                sum = static_cast< T >( static_cast< U >( static_cast< U >( lhs ) + static_cast< U >( rhs ) ) );
+            } else {
+                sum = static_cast< T >( lhs + rhs );
+            }
+            return true;
+        }
+
+        template < class T >
+        core::Bool zeroScalar( KvsDataType &zero ) noexcept
+        {
+            zero = T{};
+            return true;
+        }
+
+        template < class T >
+        void appendElements( ::std::ostringstream &oss, const core::Byte* data, core::Size size )
+        {
+            for ( core::Size offset = 0; offset + sizeof( T ) <= size; offset += sizeof( T ) ) {
+                T element;
+                ::std::memcpy( &element, data + offset, sizeof( T ) );
+                if ( offset > 0 ) oss << ',';
+                // Promote 8-bit integers so they print as numbers, not characters
+                oss << +element;
+            }
+        }
+
+        template < class V >
+        KvsDataType parseElements( const core::String &text )
+        {
+            using T = typename V::value_type;
+
+            V vec;
+            core::String body = text;
+            if ( !body.empty() && body.front() == '[' ) body.erase( 0, 1 );
+            if ( !body.empty() && body.back() == ']' ) body.pop_back();
+
+            ::std::istringstream iss( body );
+            core::String item;
+            while ( ::std::getline( iss, item, ',' ) ) {
+                if ( ::std::is_floating_point< T >::value ) {
+                    vec.push_back( static_cast< T >( ::std::stod( item ) ) );
+                } else if ( ::std::is_signed< T >::value ) {
+                    vec.push_back( static_cast< T >( ::std::stoll( item ) ) );
+                } else {
+                    vec.push_back( static_cast< T >( ::std::stoull( item ) ) );
+                }
+            }
+            return vec;
+        }
+
+        // "[e0,e1,...]" with round-trip precision for floating point elements
+        core::String arrayToString( EKvsDataTypeIndicate type, const core::Byte* data, core::Size size )
+        {
+            ::std::ostringstream oss;
+            oss << ::std::setprecision( ::std::numeric_limits< core::Double >::max_digits10 ) << '[';
+
+            switch ( type ) {
+            case EKvsDataTypeIndicate::DataType_int8_array:   appendElements< core::Int8 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_int16_array:  appendElements< core::Int16 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_uint16_array: appendElements< core::UInt16 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_int32_array:  appendElements< core::Int32 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_uint32_array: appendElements< core::UInt32 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_int64_array:  appendElements< core::Int64 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_uint64_array: appendElements< core::UInt64 >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_float_array:  appendElements< core::Float >( oss, data, size ); break;
+            case EKvsDataTypeIndicate::DataType_double_array: appendElements< core::Double >( oss, data, size ); break;
+            default: break;
+            }
+
+            oss << ']';
+            return oss.str();
+        }
+    }
+
     core::String kvsToStrig( const KvsDataType& value )
     {
+        // Numeric arrays share one formatter working on the raw element bytes
+        const auto type = static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( value ) );
+        const core::Byte* rawData = nullptr;
+        core::Size rawSize = 0;
+        if ( type > EKvsDataTypeIndicate::DataType_blob && kvsRawBytes( value, rawData, rawSize ) ) {
+            return arrayToString( type, rawData, rawSize );
+        }
+
 #if __cplusplus >= 201703L
         // C++17: std::variant uses index() instead of which()
         switch( static_cast< EKvsDataTypeIndicate >( value.index() ) ) {
@@ -40,6 +181,13 @@ namespace per
             return ::std::to_string( ::std::get< core::Double >( value ) );
         case EKvsDataTypeIndicate::DataType_string: // String
             return "\"" + ::std::get< core::String >( value ) + "\"";
+        case EKvsDataTypeIndicate::DataType_blob: // Blob
+        {
+            const auto& blob = ::std::get< KvsBlob >( value );
+            return kvsBlobToBase64( blob.data(), blob.size() );
+        }
+        default:
+            break;
         }
 #else
         // C++14: boost::variant uses which()
@@ -68,6 +216,13 @@ namespace per
             return ::std::to_string( ::boost::get< core::Double >( value ) );
         case EKvsDataTypeIndicate::DataType_string: // String
             return "\"" + ::boost::get< core::String >( value ) + "\"";
+        case EKvsDataTypeIndicate::DataType_blob: // Blob
+        {
+            const auto& blob = ::boost::get< KvsBlob >( value );
+            return kvsBlobToBase64( blob.data(), blob.size() );
+        }
+        default:
+            break;
         }
 #endif
 
@@ -101,9 +256,264 @@ namespace per
             return ::std::stod( value.c_str() );
         case EKvsDataTypeIndicate::DataType_string: // String
             return core::String( value.c_str() );
+        case EKvsDataTypeIndicate::DataType_blob: // Blob
+        {
+            KvsBlob blob;
+            if ( !kvsBlobFromBase64( value, blob ) ) {
+                throw ::std::invalid_argument( "kvsFromString: invalid base64 blob" );
+            }
+            return blob;
+        }
+        case EKvsDataTypeIndicate::DataType_int8_array:
+            return parseElements< KvsInt8Array >( value );
+        case EKvsDataTypeIndicate::DataType_int16_array:
+            return parseElements< KvsInt16Array >( value );
+        case EKvsDataTypeIndicate::DataType_uint16_array:
+            return parseElements< KvsUInt16Array >( value );
+        case EKvsDataTypeIndicate::DataType_int32_array:
+            return parseElements< KvsInt32Array >( value );
+        case EKvsDataTypeIndicate::DataType_uint32_array:
+            return parseElements< KvsUInt32Array >( value );
+        case EKvsDataTypeIndicate::DataType_int64_array:
+            return parseElements< KvsInt64Array >( value );
+        case EKvsDataTypeIndicate::DataType_uint64_array:
+            return parseElements< KvsUInt64Array >( value );
+        case EKvsDataTypeIndicate::DataType_float_array:
+            return parseElements< KvsFloatArray >( value );
+        case EKvsDataTypeIndicate::DataType_double_array:
+            return parseElements< KvsDoubleArray >( value );
         }
 
         return "";
     }
+
+    core::String kvsBlobToBase64( const core::Byte* data, core::Size size )
+    {
+        static constexpr core::Char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        core::String text;
+        text.reserve( ( ( size + 2 ) / 3 ) * 4 );
+
+        core::Size i = 0;
+        for ( ; i + 3 <= size; i += 3 ) {
+            core::UInt32 triple = ( static_cast< core::UInt32 >( data[i] ) << 16 ) |
+                                  ( static_cast< core::UInt32 >( data[i + 1] ) << 8 ) |
+                                  static_cast< core::UInt32 >( data[i + 2] );
+            text.push_back( kAlphabet[ ( triple >> 18 ) & 0x3F ] );
+            text.push_back( kAlphabet[ ( triple >> 12 ) & 0x3F ] );
+            text.push_back( kAlphabet[ ( triple >> 6 ) & 0x3F ] );
+            text.push_back( kAlphabet[ triple & 0x3F ] );
+        }
+
+        if ( i < size ) {
+            core::UInt32 triple = static_cast< core::UInt32 >( data[i] ) << 16;
+            if ( i + 1 < size ) triple |= static_cast< core::UInt32 >( data[i + 1] ) << 8;
+
+            text.push_back( kAlphabet[ ( triple >> 18 ) & 0x3F ] );
+            text.push_back( kAlphabet[ ( triple >> 12 ) & 0x3F ] );
+            text.push_back( ( i + 1 < size ) ? kAlphabet[ ( triple >> 6 ) & 0x3F ] : '=' );
+            text.push_back( '=' );
+        }
+
+        return text;
+    }
+
+    core::Size kvsBase64DecodedSize( core::StringView text ) noexcept
+    {
+        if ( text.empty() || text.size() % 4 != 0 ) return 0;
+
+        core::Size padding = ( text[text.size() - 1] == '=' ) ? ( text[text.size() - 2] == '=' ? 2 : 1 ) : 0;
+        return ( text.size() / 4 ) * 3 - padding;
+    }
+
+    core::Bool kvsBase64DecodeInto( core::StringView text, core::Byte* out, core::Size capacity ) noexcept
+    {
+        auto decode = []( core::Char c ) -> core::Int32 {
+            if ( c >= 'A' && c <= 'Z' ) return c - 'A';
+            if ( c >= 'a' && c <= 'z' ) return c - 'a' + 26;
+            if ( c >= '0' && c <= '9' ) return c - '0' + 52;
+            if ( c == '+' ) return 62;
+            if ( c == '/' ) return 63;
+            return -1;
+        };
+
+        if ( text.size() % 4 != 0 || capacity < kvsBase64DecodedSize( text ) ) return false;
+
+        for ( core::Size i = 0; i < text.size(); i += 4 ) {
+            const core::Bool last = ( i + 4 == text.size() );
+            const core::Int32 pad = ( last && text[i + 3] == '=' ) ? ( text[i + 2] == '=' ? 2 : 1 ) : 0;
+
+            core::UInt32 triple = 0;
+            for ( core::Size j = 0; j < 4 - static_cast< core::Size >( pad ); ++j ) {
+                core::Int32 sextet = decode( text[i + j] );
+                if ( sextet < 0 ) return false;
+                triple |= static_cast< core::UInt32 >( sextet ) << ( 18 - 6 * j );
+            }
+
+            *out++ = static_cast< core::Byte >( ( triple >> 16 ) & 0xFF );
+            if ( pad < 2 ) *out++ = static_cast< core::Byte >( ( triple >> 8 ) & 0xFF );
+            if ( pad < 1 ) *out++ = static_cast< core::Byte >( triple & 0xFF );
+        }
+
+        return true;
+    }
+
+    core::Bool kvsBlobFromBase64( core::StringView text, KvsBlob &blob )
+    {
+        if ( text.size() % 4 != 0 ) return false;
+
+        blob.resize( kvsBase64DecodedSize( text ) );
+        return kvsBase64DecodeInto( text, blob.data(), blob.size() );
+    }
+
+    core::Size kvsRawElementSize( EKvsDataTypeIndicate type ) noexcept
+    {
+        switch ( type ) {
+        case EKvsDataTypeIndicate::DataType_blob:         return sizeof( core::Byte );
+        case EKvsDataTypeIndicate::DataType_int8_array:   return sizeof( core::Int8 );
+        case EKvsDataTypeIndicate::DataType_int16_array:  return sizeof( core::Int16 );
+        case EKvsDataTypeIndicate::DataType_uint16_array: return sizeof( core::UInt16 );
+        case EKvsDataTypeIndicate::DataType_int32_array:  return sizeof( core::Int32 );
+        case EKvsDataTypeIndicate::DataType_uint32_array: return sizeof( core::UInt32 );
+        case EKvsDataTypeIndicate::DataType_int64_array:  return sizeof( core::Int64 );
+        case EKvsDataTypeIndicate::DataType_uint64_array: return sizeof( core::UInt64 );
+        case EKvsDataTypeIndicate::DataType_float_array:  return sizeof( core::Float );
+        case EKvsDataTypeIndicate::DataType_double_array: return sizeof( core::Double );
+        default:                                          return 0;
+        }
+    }
+
+    void kvsRawSwapLittleEndian( EKvsDataTypeIndicate type, core::Byte* data, core::Size size ) noexcept
+    {
+        if ( KVS_LITTLE_ENDIAN_HOST ) return;
+
+        const core::Size width = kvsRawElementSize( type );
+        for ( core::Size i = 0; width > 1 && i + width <= size; i += width ) {
+            ::std::reverse( data + i, data + i + width );
+        }
+    }
+
+    core::Bool kvsRawBytes( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept
+    {
+        switch ( static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( value ) ) ) {
+        case EKvsDataTypeIndicate::DataType_blob:         return rawView< KvsBlob >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int8_array:   return rawView< KvsInt8Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int16_array:  return rawView< KvsInt16Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint16_array: return rawView< KvsUInt16Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int32_array:  return rawView< KvsInt32Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint32_array: return rawView< KvsUInt32Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int64_array:  return rawView< KvsInt64Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint64_array: return rawView< KvsUInt64Array >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_float_array:  return rawView< KvsFloatArray >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_double_array: return rawView< KvsDoubleArray >( value, data, size );
+        default:                                          return false;
+        }
+    }
+
+    core::Bool kvsFromRawBytes( EKvsDataTypeIndicate type, const core::Byte* data, core::Size size, KvsDataType &value )
+    {
+        switch ( type ) {
+        case EKvsDataTypeIndicate::DataType_blob:         return rawAssign< KvsBlob >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int8_array:   return rawAssign< KvsInt8Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int16_array:  return rawAssign< KvsInt16Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint16_array: return rawAssign< KvsUInt16Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int32_array:  return rawAssign< KvsInt32Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint32_array: return rawAssign< KvsUInt32Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int64_array:  return rawAssign< KvsInt64Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint64_array: return rawAssign< KvsUInt64Array >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_float_array:  return rawAssign< KvsFloatArray >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_double_array: return rawAssign< KvsDoubleArray >( data, size, value );
+        default:                                          return false;
+        }
+    }
+
+    core::Bool kvsValueBytes( const KvsDataType &value, const core::Byte* &data, core::Size &size ) noexcept
+    {
+        if ( kvsRawBytes( value, data, size ) ) return true;
+
+        switch ( static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( value ) ) ) {
+        case EKvsDataTypeIndicate::DataType_int8_t:       return scalarBytes< core::Int8 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint8_t:      return scalarBytes< core::UInt8 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int16_t:      return scalarBytes< core::Int16 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint16_t:     return scalarBytes< core::UInt16 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int32_t:      return scalarBytes< core::Int32 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint32_t:     return scalarBytes< core::UInt32 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_int64_t:      return scalarBytes< core::Int64 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_uint64_t:     return scalarBytes< core::UInt64 >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_bool:         return scalarBytes< core::Bool >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_float:        return scalarBytes< core::Float >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_double:       return scalarBytes< core::Double >( value, data, size );
+        case EKvsDataTypeIndicate::DataType_string:
+        {
+            const auto& text = ::lap::core::get< core::String >( value );
+            data = reinterpret_cast< const core::Byte* >( text.data() );
+            size = text.size();
+            return true;
+        }
+        default:                                          return false;
+        }
+    }
+
+    core::Bool kvsValueFromBytes( EKvsDataTypeIndicate type, const core::Byte* data, core::Size size, KvsDataType &value )
+    {
+        if ( isKvsRawType( type ) ) return kvsFromRawBytes( type, data, size, value );
+
+        switch ( type ) {
+        case EKvsDataTypeIndicate::DataType_int8_t:       return scalarFromBytes< core::Int8 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint8_t:      return scalarFromBytes< core::UInt8 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int16_t:      return scalarFromBytes< core::Int16 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint16_t:     return scalarFromBytes< core::UInt16 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int32_t:      return scalarFromBytes< core::Int32 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint32_t:     return scalarFromBytes< core::UInt32 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_int64_t:      return scalarFromBytes< core::Int64 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_uint64_t:     return scalarFromBytes< core::UInt64 >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_float:        return scalarFromBytes< core::Float >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_double:       return scalarFromBytes< core::Double >( data, size, value );
+        case EKvsDataTypeIndicate::DataType_bool:
+            if ( size != 1 ) return false;
+            value = ( static_cast< core::UInt8 >( data[0] ) != 0 );
+            return true;
+        case EKvsDataTypeIndicate::DataType_string:
+            value = core::String( reinterpret_cast< const char* >( data ), size );
+            return true;
+        default:                                          return false;
+        }
+    }
+
+    core::Bool kvsAddValues( const KvsDataType &current, const KvsDataType &delta, KvsDataType &sum ) noexcept
+    {
+        if ( ::lap::core::GetVariantIndex( current ) != ::lap::core::GetVariantIndex( delta ) ) return false;
+
+        switch ( static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( delta ) ) ) {
+        case EKvsDataTypeIndicate::DataType_int8_t:       return addScalar< core::Int8 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_uint8_t:      return addScalar< core::UInt8 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_int16_t:      return addScalar< core::Int16 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_uint16_t:     return addScalar< core::UInt16 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_int32_t:      return addScalar< core::Int32 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_uint32_t:     return addScalar< core::UInt32 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_int64_t:      return addScalar< core::Int64 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_uint64_t:     return addScalar< core::UInt64 >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_float:        return addScalar< core::Float >( current, delta, sum );
+        case EKvsDataTypeIndicate::DataType_double:       return addScalar< core::Double >( current, delta, sum );
+        default:                                          return false;
+        }
+    }
+
+    core::Bool kvsZeroValue( const KvsDataType &like, KvsDataType &zero ) noexcept
+    {
+        switch ( static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( like ) ) ) {
+        case EKvsDataTypeIndicate::DataType_int8_t:       return zeroScalar< core::Int8 >( zero );
+        case EKvsDataTypeIndicate::DataType_uint8_t:      return zeroScalar< core::UInt8 >( zero );
+        case EKvsDataTypeIndicate::DataType_int16_t:      return zeroScalar< core::Int16 >( zero );
+        case EKvsDataTypeIndicate::DataType_uint16_t:     return zeroScalar< core::UInt16 >( zero );
+        case EKvsDataTypeIndicate::DataType_int32_t:      return zeroScalar< core::Int32 >( zero );
+        case EKvsDataTypeIndicate::DataType_uint32_t:     return zeroScalar< core::UInt32 >( zero );
+        case EKvsDataTypeIndicate::DataType_int64_t:      return zeroScalar< core::Int64 >( zero );
+        case EKvsDataTypeIndicate::DataType_uint64_t:     return zeroScalar< core::UInt64 >( zero );
+        case EKvsDataTypeIndicate::DataType_float:        return zeroScalar< core::Float >( zero );
+        case EKvsDataTypeIndicate::DataType_double:       return zeroScalar< core::Double >( zero );
+        default:                                          return false;
+        }
+    }
 } // pm
 } // ara
@@ -0,0 +1,329 @@
+/**
+ * @file CFaultInjectionFileSystem.cpp
+ * @brief Fault Injection File System Implementation
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <chrono>
+#include <thread>
+#include "CFaultInjectionFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    CFaultInjectionFileSystem::CFaultInjectionFileSystem( core::SharedHandle< IVirtualFileSystem > inner,
+                                                          const FaultInjectionConfig& config ) noexcept
+        : m_pInner( inner ? inner : IVirtualFileSystem::getDefault() )
+        , m_config( config )
+        , m_rng( config.seed )
+    {
+        ;
+    }
+
+    // ==================== Configuration ====================
+
+    void CFaultInjectionFileSystem::SetConfig( const FaultInjectionConfig& config ) noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        m_config = config;
+        m_matchedWrites = 0;
+        m_budgetUsed = 0;
+        m_bHalted = false;
+        m_rng.seed( config.seed );
+    }
+
+    FaultInjectionConfig CFaultInjectionFileSystem::GetConfig() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return m_config;
+    }
+
+    void CFaultInjectionFileSystem::Reset() noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        m_stats = FaultInjectionStats();
+        m_matchedWrites = 0;
+        m_budgetUsed = 0;
+        m_bHalted = false;
+        m_rng.seed( m_config.seed );
+    }
+
+    FaultInjectionStats CFaultInjectionFileSystem::GetStats() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return m_stats;
+    }
+
+    core::Bool CFaultInjectionFileSystem::IsHalted() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return m_bHalted;
+    }
+
+    // ==================== Fault Decisions ====================
+
+    core::Bool CFaultInjectionFileSystem::matches( core::StringView path ) const noexcept
+    {
+        return m_config.pathFilter.empty() || path.find( m_config.pathFilter ) != core::StringView::npos;
+    }
+
+    core::UInt32 CFaultInjectionFileSystem::writeLatencyFor( core::StringView path ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return matches( path ) ? m_config.writeLatencyUs : 0;
+    }
+
+    void CFaultInjectionFileSystem::delay( core::UInt32 us ) const noexcept
+    {
+        if ( us == 0 ) return;
+        {
+            core::LockGuard lock( m_mutex );
+            m_stats.injectedDelayUs += us;
+        }
+        // Sleep outside the lock so concurrent callers are delayed independently
+        ::std::this_thread::sleep_for( ::std::chrono::microseconds( us ) );
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::checkHalted() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        if ( m_bHalted ) {
+            ++m_stats.haltedOperations;
+            return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    CFaultInjectionFileSystem::WriteFault CFaultInjectionFileSystem::decideWrite( core::StringView path,
+                                                                                 core::Size size,
+                                                                                 core::Size& persisted ) noexcept
+    {
+        persisted = size;
+        if ( !matches( path ) ) return WriteFault::kNone;
+
+        ++m_matchedWrites;
+
+        // ENOSPC: only the bytes remaining in the budget reach storage
+        if ( m_config.writeBudgetBytes != 0 && m_budgetUsed + size > m_config.writeBudgetBytes ) {
+            persisted = static_cast< core::Size >( m_config.writeBudgetBytes - m_budgetUsed );
+            m_budgetUsed = m_config.writeBudgetBytes;
+            ++m_stats.outOfSpaceErrors;
+            return WriteFault::kOutOfSpace;
+        }
+
+        core::Bool torn = ( m_config.tornWriteAt != 0 && m_matchedWrites == m_config.tornWriteAt );
+        if ( !torn && m_config.tornWriteProbability > 0.0 ) {
+            ::std::uniform_real_distribution< core::Double > dist( 0.0, 1.0 );
+            torn = dist( m_rng ) < m_config.tornWriteProbability;
+        }
+
+        if ( torn ) {
+            core::Double fraction = m_config.tornWriteFraction;
+            if ( fraction < 0.0 ) fraction = 0.0;
+            if ( fraction > 1.0 ) fraction = 1.0;
+            persisted = static_cast< core::Size >( static_cast< core::Double >( size ) * fraction );
+            if ( persisted >= size && size > 0 ) persisted = size - 1;     // A torn write is never complete
+            m_budgetUsed += persisted;
+            ++m_stats.tornWrites;
+            return WriteFault::kTorn;
+        }
+
+        m_budgetUsed += size;
+        return WriteFault::kNone;
+    }
+
+    // ==================== Query (pass-through) ====================
+
+    core::Bool CFaultInjectionFileSystem::Exists( core::StringView path ) const noexcept
+    {
+        return m_pInner->Exists( path );
+    }
+
+    core::Bool CFaultInjectionFileSystem::IsDirectory( core::StringView path ) const noexcept
+    {
+        return m_pInner->IsDirectory( path );
+    }
+
+    core::Result< core::UInt64 > CFaultInjectionFileSystem::GetFileSize( core::StringView path ) const noexcept
+    {
+        return m_pInner->GetFileSize( path );
+    }
+
+    core::String CFaultInjectionFileSystem::GetModificationTime( core::StringView path ) const noexcept
+    {
+        return m_pInner->GetModificationTime( path );
+    }
+
+    core::Vector< core::String > CFaultInjectionFileSystem::ListFiles( core::StringView dirPath ) const noexcept
+    {
+        return m_pInner->ListFiles( dirPath );
+    }
+
+    // ==================== File I/O ====================
+
+    core::Result< core::Vector< core::UInt8 > > CFaultInjectionFileSystem::ReadFile( core::StringView path ) const noexcept
+    {
+        core::UInt32 latency = 0;
+        {
+            core::LockGuard lock( m_mutex );
+            ++m_stats.reads;
+            if ( matches( path ) ) latency = m_config.readLatencyUs;
+        }
+        delay( latency );
+        return m_pInner->ReadFile( path );
+    }
+
+    core::Result< core::Vector< core::UInt8 > > CFaultInjectionFileSystem::ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept
+    {
+        core::UInt32 latency = 0;
+        {
+            core::LockGuard lock( m_mutex );
+            ++m_stats.reads;
+            if ( matches( path ) ) latency = m_config.readLatencyUs;
+        }
+        delay( latency );
+        return m_pInner->ReadFileRange( path, offset, size );
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::injectWrite( core::StringView path, core::Size size, const core::Char* what,
+                                                                  const ::std::function< core::Result< void >( core::Size ) >& write ) noexcept
+    {
+        auto halted = checkHalted();
+        if ( !halted.HasValue() ) return halted;
+
+        WriteFault fault = WriteFault::kNone;
+        core::Size persisted = size;
+        core::UInt32 latency = 0;
+        {
+            core::LockGuard lock( m_mutex );
+            ++m_stats.writes;
+            fault = decideWrite( path, size, persisted );
+            m_stats.bytesWritten += persisted;
+            if ( fault != WriteFault::kNone && m_config.haltAfterFault ) m_bHalted = true;
+            if ( matches( path ) ) latency = m_config.writeLatencyUs;
+        }
+        delay( latency );
+
+        auto writeResult = write( persisted );
+        if ( !writeResult.HasValue() ) return writeResult;
+
+        switch ( fault ) {
+            case WriteFault::kTorn:
+                LAP_PER_LOG_WARN << "CFaultInjectionFileSystem: torn " << what << " " << persisted << "/" << size << " bytes: " << core::String( path );
+                return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+            case WriteFault::kOutOfSpace:
+                LAP_PER_LOG_WARN << "CFaultInjectionFileSystem: ENOSPC after " << persisted << "/" << size << " bytes: " << core::String( path );
+                return core::Result< void >::FromError( PerErrc::kOutOfStorageSpace );
+            default:
+                return writeResult;
+        }
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        return injectWrite( path, size, "write", [&]( core::Size persisted ) { return m_pInner->WriteFile( path, data, persisted ); } );
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::RemoveFile( core::StringView path ) noexcept
+    {
+        auto halted = checkHalted();
+        if ( !halted.HasValue() ) return halted;
+
+        delay( writeLatencyFor( path ) );
+        return m_pInner->RemoveFile( path );
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        // Same fault model as WriteFile: a torn append leaves a prefix of the data at the end of the file
+        return injectWrite( path, size, "append", [&]( core::Size persisted ) { return m_pInner->AppendFile( path, data, persisted ); } );
+    }
+
+    // Faults each piece like an append; Sync() fails once halted, as any mutation
+    class CFaultInjectionFileSystem::Writer final : public IVirtualFileWriter
+    {
+    public:
+        IMP_OPERATOR_NEW(Writer)
+
+        Writer( CFaultInjectionFileSystem& fs, core::String path, core::UniqueHandle< IVirtualFileWriter > inner ) noexcept
+            : m_fs( fs )
+            , m_path( ::std::move( path ) )
+            , m_pInner( ::std::move( inner ) )
+        {
+            ;
+        }
+
+        core::Result< void > Write( const core::UInt8* data, core::Size size ) noexcept override
+        {
+            return m_fs.injectWrite( m_path, size, "write", [&]( core::Size persisted ) { return m_pInner->Write( data, persisted ); } );
+        }
+
+        core::Result< void > Sync() noexcept override
+        {
+            auto halted = m_fs.checkHalted();
+            if ( !halted.HasValue() ) return halted;
+
+            return m_pInner->Sync();
+        }
+
+    private:
+        CFaultInjectionFileSystem&                      m_fs;
+        core::String                                    m_path;
+        core::UniqueHandle< IVirtualFileWriter >        m_pInner;
+    };
+
+    core::Result< core::UniqueHandle< IVirtualFileWriter > > CFaultInjectionFileSystem::OpenWriter( core::StringView path ) noexcept
+    {
+        using result = core::Result< core::UniqueHandle< IVirtualFileWriter > >;
+
+        auto halted = checkHalted();
+        if ( !halted.HasValue() ) return result::FromError( halted.Error() );
+
+        delay( writeLatencyFor( path ) );
+        auto inner = m_pInner->OpenWriter( path );
+        if ( !inner.HasValue() ) return inner;
+
+        try {
+            core::UniqueHandle< IVirtualFileWriter > writer( ::std::make_unique< Writer >( *this, core::String( path ), ::std::move( inner.Value() ) ) );
+            return result::FromValue( ::std::move( writer ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::RenameFile( core::StringView from, core::StringView to ) noexcept
+    {
+        auto halted = checkHalted();
+        if ( !halted.HasValue() ) return halted;
+
+        // Rename is metadata-only and atomic, it is never torn
+        delay( writeLatencyFor( to ) );
+        return m_pInner->RenameFile( from, to );
+    }
+
+    core::Result< void > CFaultInjectionFileSystem::CopyFile( core::StringView from, core::StringView to ) noexcept
+    {
+        // Route through WriteFile so copies are subject to the same faults
+        auto readResult = m_pInner->ReadFile( from );
+        if ( !readResult.HasValue() ) return core::Result< void >::FromError( readResult.Error() );
+
+        const auto& data = readResult.Value();
+        return WriteFile( to, data.data(), data.size() );
+    }
+
+    // ==================== Directory ====================
+
+    core::Result< void > CFaultInjectionFileSystem::CreateDirectory( core::StringView path ) noexcept
+    {
+        auto halted = checkHalted();
+        if ( !halted.HasValue() ) return halted;
+
+        return m_pInner->CreateDirectory( path );
+    }
+
+} // namespace per
+} // namespace lap
@@ -5,7 +5,7 @@
  * @date 2025-11-14
  * 
  * Architecture: Phase 2.1 Refactoring
- * - Uses Core::File::Util for all file operations (no std::fstream)
+ * - All file operations go through the injected IVirtualFileSystem
  * - Uses Core::Path for path operations
  * - Pure file operations, no lifecycle management
  */
@@ -13,7 +13,6 @@
 #include "CFileStorageBackend.hpp"
 #include "CPerErrorDomain.hpp"
 #include <lap/core/CPath.hpp>
-#include <lap/core/CFile.hpp>
 
 namespace lap {
 namespace per {
@@ -30,9 +29,8 @@ Result<Vector<Byte>> CFileStorageBackend::ReadFile(
 ) noexcept {
     auto filePath = GetFilePath(fileName, category);
     
-    // Use Core::File::Util to read binary data
-    Vector<UInt8> fileData;
-    if (!File::Util::ReadBinary(filePath, fileData)) {
+    auto readResult = m_pVfs->ReadFile(filePath);
+    if (!readResult.HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to read file: " << filePath;
         return Result<Vector<Byte>>::FromError(
             MakeErrorCode(PerErrc::kFileNotFound, 0)
@@ -40,6 +38,7 @@ Result<Vector<Byte>> CFileStorageBackend::ReadFile(
     }
     
     // Convert UInt8 to Byte
+    const auto& fileData = readResult.Value();
     Vector<Byte> result;
     result.reserve(fileData.size());
     for (auto byte : fileData) {
@@ -58,8 +57,8 @@ Result<void> CFileStorageBackend::WriteFile(
     
     // Ensure category directory exists
     auto categoryPath = GetCategoryPath(category);
-    if (!Path::isDirectory(categoryPath)) {
-        if (!Path::createDirectory(categoryPath)) {
+    if (!m_pVfs->IsDirectory(categoryPath)) {
+        if (!m_pVfs->CreateDirectory(categoryPath).HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to create category directory: " << categoryPath;
             return Result<void>::FromError(
                 MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
@@ -74,24 +73,11 @@ Result<void> CFileStorageBackend::WriteFile(
         fileData.push_back(static_cast<UInt8>(byte));
     }
     
-    // Special handling for empty files - Core::File::Util::WriteBinary requires size > 0
-    if (fileData.empty()) {
-        // Create empty file using standard API
-        if (!File::Util::create(filePath)) {
-            LAP_PER_LOG_ERROR << "Failed to create empty file: " << filePath;
-            return Result<void>::FromError(
-                MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
-            );
-        }
-        return Result<void>::FromValue();
-    }
-    
-    // Use Core::File::Util to write binary data (createDirectories=true)
-    if (!File::Util::WriteBinary(filePath, fileData.data(), fileData.size(), true)) {
+    // Empty files are valid - the file system creates a zero-length file
+    auto writeResult = m_pVfs->WriteFile(filePath, fileData.data(), fileData.size());
+    if (!writeResult.HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to write file: " << filePath;
-        return Result<void>::FromError(
-            MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
-        );
+        return writeResult;
     }
     
     return Result<void>::FromValue();
@@ -103,14 +89,14 @@ Result<void> CFileStorageBackend::DeleteFile(
 ) noexcept {
     auto filePath = GetFilePath(fileName, category);
     
-    if (!File::Util::exists(filePath)) {
+    if (!m_pVfs->Exists(filePath)) {
         LAP_PER_LOG_WARN << "File does not exist: " << filePath;
         return Result<void>::FromError(
             MakeErrorCode(PerErrc::kFileNotFound, 0)
         );
     }
     
-    if (!File::Util::remove(filePath)) {
+    if (!m_pVfs->RemoveFile(filePath).HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to delete file: " << fileName;
         return Result<void>::FromError(
             MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
@@ -125,11 +111,11 @@ Result<Vector<String>> CFileStorageBackend::ListFiles(
 ) noexcept {
     auto categoryPath = GetCategoryPath(category);
     
-    if (!Path::isDirectory(categoryPath)) {
+    if (!m_pVfs->IsDirectory(categoryPath)) {
         return Result<Vector<String>>::FromValue(Vector<String>());
     }
     
-    auto files = Path::listFiles(categoryPath);
+    auto files = m_pVfs->ListFiles(categoryPath);
     Vector<String> result;
     result.reserve(files.size());
     
@@ -145,7 +131,7 @@ Bool CFileStorageBackend::FileExists(
     const String& category
 ) const noexcept {
     auto filePath = GetFilePath(fileName, category);
-    return File::Util::exists(filePath);
+    return m_pVfs->Exists(filePath);
 }
 
 Result<UInt64> CFileStorageBackend::GetFileSize(
@@ -154,21 +140,14 @@ Result<UInt64> CFileStorageBackend::GetFileSize(
 ) const noexcept {
     auto filePath = GetFilePath(fileName, category);
     
-    if (!File::Util::exists(filePath)) {
+    auto sizeResult = m_pVfs->GetFileSize(filePath);
+    if (!sizeResult.HasValue()) {
         return Result<UInt64>::FromError(
             MakeErrorCode(PerErrc::kFileNotFound, 0)
         );
     }
     
-    // Read file to get size (Core::File::Util doesn't have direct getFileSize)
-    Vector<UInt8> fileData;
-    if (!File::Util::ReadBinary(filePath, fileData)) {
-        return Result<UInt64>::FromError(
-            MakeErrorCode(PerErrc::kFileNotFound, 0)
-        );
-    }
-    
-    return Result<UInt64>::FromValue(static_cast<UInt64>(fileData.size()));
+    return sizeResult;
 }
 
 // ============================================================================
@@ -194,7 +173,7 @@ Result<void> CFileStorageBackend::CopyFile(
     auto srcPath = GetFilePath(fileName, fromCategory);
     auto dstPath = GetFilePath(fileName, toCategory);
     
-    if (!File::Util::exists(srcPath)) {
+    if (!m_pVfs->Exists(srcPath)) {
         LAP_PER_LOG_ERROR << "Source file does not exist: " << srcPath;
         return Result<void>::FromError(
             MakeErrorCode(PerErrc::kFileNotFound, 0)
@@ -203,8 +182,8 @@ Result<void> CFileStorageBackend::CopyFile(
     
     // Ensure destination category directory exists
     auto dstCategoryPath = GetCategoryPath(toCategory);
-    if (!Path::isDirectory(dstCategoryPath)) {
-        if (!Path::createDirectory(dstCategoryPath)) {
+    if (!m_pVfs->IsDirectory(dstCategoryPath)) {
+        if (!m_pVfs->CreateDirectory(dstCategoryPath).HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to create destination category directory";
             return Result<void>::FromError(
                 MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
@@ -212,11 +191,10 @@ Result<void> CFileStorageBackend::CopyFile(
         }
     }
     
-    if (!File::Util::copy(srcPath, dstPath)) {
+    auto copyResult = m_pVfs->CopyFile(srcPath, dstPath);
+    if (!copyResult.HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to copy file: " << fileName;
-        return Result<void>::FromError(
-            MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0)
-        );
+        return copyResult;
     }
     
     return Result<void>::FromValue();
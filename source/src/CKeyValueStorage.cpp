@@ -3,6 +3,9 @@
 #include "CKvsFileBackend.hpp"
 #include "CKvsSqliteBackend.hpp"
 #include "CKvsPropertyBackend.hpp"
+#include "CKvsShardedBackend.hpp"
+#include "CKvsLsmBackend.hpp"
+#include "CKvsMmapBackend.hpp"
 #include "CPersistencyManager.hpp"
 
 namespace lap
@@ -10,8 +13,7 @@ namespace lap
 namespace per
 {
     KeyValueStorage::KeyValueStorage ( core::StringView strIdentifier ) noexcept
-        : m_strPath( strIdentifier )
-        , m_pKvsBackend( ::std::make_unique< KvsFileBackend >( strIdentifier ) )       // default
+        : KeyValueStorage( strIdentifier, KvsBackendType::kvsFile )                     // default
     {
         ;
     }
@@ -20,11 +22,25 @@ namespace per
         : m_strPath( strIdentifier )
     {
         try {
-            if ( type & KvsBackendType::kvsFile ) {
+            if ( ( type & ( KvsBackendType::kvsFile | KvsBackendType::kvsSqlite ) ) && KvsShardedBackend::IsSharded( strIdentifier ) ) {
+                // A sharded instance is never opened as one backend: without a config, open the layout its manifest records
+                KvsBackendType shardBackend = type;
+                core::UInt32 shardCount = 0;
+                auto manifest = KvsShardedBackend::ReadManifest( strIdentifier, shardBackend, shardCount );
+                if ( manifest.HasValue() ) {
+                    m_pKvsBackend = ::std::make_unique< KvsShardedBackend >( strIdentifier, type, shardCount );
+                } else {
+                    LAP_PER_LOG_ERROR << "Kvs shard manifest unreadable, instance not opened: " << strIdentifier;
+                }
+            } else if ( type & KvsBackendType::kvsFile ) {
                 m_pKvsBackend = ::std::make_unique< KvsFileBackend >( strIdentifier );
             } else if ( type & KvsBackendType::kvsSqlite ) {
                 // SQLite backend now fully implements IKvsBackend interface
                 m_pKvsBackend = ::std::make_unique< KvsSqliteBackend >( strIdentifier );
+            } else if ( type & KvsBackendType::kvsLsm ) {
+                m_pKvsBackend = ::std::make_unique< KvsLsmBackend >( strIdentifier );
+            } else if ( type & KvsBackendType::kvsMmap ) {
+                m_pKvsBackend = ::std::make_unique< KvsMmapBackend >( strIdentifier );
             } else if ( type & KvsBackendType::kvsProperty ) {
                 // Property backend with configurable persistence (File or SQLite)
                 // Default to File backend for persistence
@@ -45,10 +61,37 @@ namespace per
         : m_strPath( strIdentifier )
     {
         try {
-            if ( type & KvsBackendType::kvsFile ) {
-                m_pKvsBackend = ::std::make_unique< KvsFileBackend >( strIdentifier );
+            if ( config != nullptr && m_pGroupCommit ) {
+                m_pGroupCommit->SetWindow( config->kvs.groupCommitWindowUs );
+            }
+
+            if ( config != nullptr && config->kvs.memoryPoolSize > 0 ) {
+                if ( type & KvsBackendType::kvsFile ) {
+                    m_pMemory = ::std::make_unique< KvsMemoryResource >( config->kvs.memoryPoolSize );
+                } else {
+                    // Other backends keep their data in SQLite, shared memory or mapped pages
+                    LAP_PER_LOG_WARN << "Kvs memory pool applies to File backends only, ignored for: " << strIdentifier;
+                }
+            }
+
+            // A sharded instance is never opened as one backend, KvsShardedBackend refuses a shard count it was not written with
+            const core::UInt32 shardCount = config != nullptr ? config->kvs.shardCount : 1;
+            if ( ( shardCount > 1 || KvsShardedBackend::IsSharded( strIdentifier ) ) && ( type & ( KvsBackendType::kvsFile | KvsBackendType::kvsSqlite ) ) ) {
+                m_pKvsBackend = ::std::make_unique< KvsShardedBackend >( strIdentifier, type, shardCount, m_pMemory.get(),
+                                                                         config != nullptr ? config->kvs.sqliteTuning( core::String( strIdentifier ) ) : KvsSqliteTuning() );
+            } else if ( type & KvsBackendType::kvsFile ) {
+                m_pKvsBackend = ::std::make_unique< KvsFileBackend >( strIdentifier, nullptr, m_pMemory.get() );
             } else if ( type & KvsBackendType::kvsSqlite ) {
-                m_pKvsBackend = ::std::make_unique< KvsSqliteBackend >( strIdentifier );
+                // A shared database is tuned by its own identifier, it has one connection for all instances
+                const KvsSqliteTuning tuning = config != nullptr
+                    ? config->kvs.sqliteTuning( config->kvs.sqliteSharedDatabase.empty() ? core::String( strIdentifier ) : config->kvs.sqliteSharedDatabase )
+                    : KvsSqliteTuning();
+                m_pKvsBackend = ::std::make_unique< KvsSqliteBackend >( strIdentifier, config != nullptr ? core::StringView( config->kvs.sqliteSharedDatabase ) : core::StringView(),
+                                                                        tuning );
+            } else if ( type & KvsBackendType::kvsLsm ) {
+                m_pKvsBackend = ::std::make_unique< KvsLsmBackend >( strIdentifier );
+            } else if ( type & KvsBackendType::kvsMmap ) {
+                m_pKvsBackend = ::std::make_unique< KvsMmapBackend >( strIdentifier );
             } else if ( type & KvsBackendType::kvsProperty ) {
                 // Property backend with config support
                 KvsBackendType persistenceBackend = KvsBackendType::kvsFile;
@@ -87,7 +130,10 @@ namespace per
 
     KeyValueStorage::KeyValueStorage( KeyValueStorage&& kvs ) noexcept
         : m_strPath( kvs.m_strPath )
+        , m_pMemory( ::std::move( kvs.m_pMemory ) )
         , m_pKvsBackend( ::std::move( kvs.m_pKvsBackend ) )
+        , m_pNotifier( ::std::move( kvs.m_pNotifier ) )
+        , m_pGroupCommit( ::std::move( kvs.m_pGroupCommit ) )
     {
         ;
     }
@@ -96,7 +142,10 @@ namespace per
     {
         m_strPath = kvs.m_strPath;
 
-        m_pKvsBackend = ::std::move( kvs.m_pKvsBackend );
+        m_pKvsBackend = ::std::move( kvs.m_pKvsBackend );     // Frees the old data before its pool
+        m_pMemory = ::std::move( kvs.m_pMemory );
+        m_pNotifier = ::std::move( kvs.m_pNotifier );
+        m_pGroupCommit = ::std::move( kvs.m_pGroupCommit );
 
         return *this;
     }
@@ -146,7 +195,7 @@ namespace per
         if ( retValue.HasValue() ) {
             // Attempt to extract the requested type from the variant in a cross-compat manner
             try {
-                return result::FromValue( ::lap::core::get< T >( retValue.Value() ) );
+                return result::FromValue( ::lap::core::get< T >( ::std::move( retValue.Value() ) ) );
             } catch ( const std::exception& ) {
                 return result::FromError( PerErrc::kDataTypeMismatch );
             }
@@ -167,6 +216,16 @@ namespace per
     template core::Result< core::Float > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
     template core::Result< core::Double > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
     template core::Result< core::String > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsBlob > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsInt8Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsInt16Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsUInt16Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsInt32Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsUInt32Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsInt64Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsUInt64Array > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsFloatArray > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
+    template core::Result< KvsDoubleArray > KeyValueStorage::GetValue( core::StringView key ) const noexcept;
 
     template<class T>
     core::Result<void> KeyValueStorage::SetValue( core::StringView key, const T &value ) noexcept
@@ -174,7 +233,10 @@ namespace per
         using result = core::Result<void>;
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->SetValue( key, KvsDataType{ value } );
+        auto retValue = m_pKvsBackend->SetValue( key, KvsDataType{ value } );
+        if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
     }
 
     template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const core::Int8& ) noexcept;
@@ -189,61 +251,553 @@ namespace per
     template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const core::Float& ) noexcept;
     template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const core::Double& ) noexcept;
     template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const core::String&  ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsBlob& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsInt8Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsUInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsUInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsUInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsFloatArray& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView key, const KvsDoubleArray& ) noexcept;
+
+    template< class T, typename >
+    core::Result<void> KeyValueStorage::SetValue( core::StringView key, T&& value ) noexcept
+    {
+        using result = core::Result<void>;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->SetValue( key, KvsDataType{ ::std::move( value ) } );
+        if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
+    }
+
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Int8&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::UInt8&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Int16&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::UInt16&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Int32&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::UInt32&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Int64&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::UInt64&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Bool&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Float&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::Double&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, core::String&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsBlob&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsInt8Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsInt16Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsUInt16Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsInt32Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsUInt32Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsInt64Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsUInt64Array&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsFloatArray&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsDoubleArray&& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( core::StringView, KvsDataType&& ) noexcept;
+
+    template< class T >
+    core::Result<void> KeyValueStorage::GetValue( core::StringView key, T& out ) const noexcept
+    {
+        using result = core::Result<void>;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        // Lend out's buffer to the backend and take it back afterwards: no allocation when it is large enough
+        KvsDataType slot{ ::std::move( out ) };
+        auto assigned = m_pKvsBackend->GetValueAssign( key, slot );
+        out = ::std::move( ::lap::core::get< T >( slot ) );
+
+        return assigned;
+    }
+
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Int8& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::UInt8& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Int16& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::UInt16& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Int32& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::UInt32& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Int64& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::UInt64& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Bool& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Float& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::Double& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, core::String& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsBlob& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsInt8Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsInt16Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsUInt16Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsInt32Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsUInt32Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsInt64Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsUInt64Array& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsFloatArray& ) const noexcept;
+    template core::Result<void> KeyValueStorage::GetValue( core::StringView, KvsDoubleArray& ) const noexcept;
+
+    template< class T >
+    core::Result< T > KeyValueStorage::GetValue( const KvsKey< T >& key ) const noexcept
+    {
+        using result = core::Result< T >;
+
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->GetValueHashed( key.Name(), key.Hash() );
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+
+        // Static type: a single index compare, get<T>() below can no longer throw
+        if ( ::lap::core::GetVariantIndex( retValue.Value() ) != KvsKey< T >::Index ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+
+        return result::FromValue( ::lap::core::get< T >( ::std::move( retValue.Value() ) ) );
+    }
+
+    template< class T >
+    core::Result<void> KeyValueStorage::SetValue( const KvsKey< T >& key, const typename KvsKey< T >::ValueType& value ) noexcept
+    {
+        using result = core::Result<void>;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->SetValueHashed( key.Name(), key.Hash(), KvsDataType{ value } );
+        if ( retValue.HasValue() ) notify( key.Name(), KvsChangeType::kSet );
+
+        return retValue;
+    }
+
+    template core::Result< core::Int8 > KeyValueStorage::GetValue( const KvsKey< core::Int8 >& ) const noexcept;
+    template core::Result< core::UInt8 > KeyValueStorage::GetValue( const KvsKey< core::UInt8 >& ) const noexcept;
+    template core::Result< core::Int16 > KeyValueStorage::GetValue( const KvsKey< core::Int16 >& ) const noexcept;
+    template core::Result< core::UInt16 > KeyValueStorage::GetValue( const KvsKey< core::UInt16 >& ) const noexcept;
+    template core::Result< core::Int32 > KeyValueStorage::GetValue( const KvsKey< core::Int32 >& ) const noexcept;
+    template core::Result< core::UInt32 > KeyValueStorage::GetValue( const KvsKey< core::UInt32 >& ) const noexcept;
+    template core::Result< core::Int64 > KeyValueStorage::GetValue( const KvsKey< core::Int64 >& ) const noexcept;
+    template core::Result< core::UInt64 > KeyValueStorage::GetValue( const KvsKey< core::UInt64 >& ) const noexcept;
+    template core::Result< core::Bool > KeyValueStorage::GetValue( const KvsKey< core::Bool >& ) const noexcept;
+    template core::Result< core::Float > KeyValueStorage::GetValue( const KvsKey< core::Float >& ) const noexcept;
+    template core::Result< core::Double > KeyValueStorage::GetValue( const KvsKey< core::Double >& ) const noexcept;
+    template core::Result< core::String > KeyValueStorage::GetValue( const KvsKey< core::String >& ) const noexcept;
+    template core::Result< KvsBlob > KeyValueStorage::GetValue( const KvsKey< KvsBlob >& ) const noexcept;
+    template core::Result< KvsInt8Array > KeyValueStorage::GetValue( const KvsKey< KvsInt8Array >& ) const noexcept;
+    template core::Result< KvsInt16Array > KeyValueStorage::GetValue( const KvsKey< KvsInt16Array >& ) const noexcept;
+    template core::Result< KvsUInt16Array > KeyValueStorage::GetValue( const KvsKey< KvsUInt16Array >& ) const noexcept;
+    template core::Result< KvsInt32Array > KeyValueStorage::GetValue( const KvsKey< KvsInt32Array >& ) const noexcept;
+    template core::Result< KvsUInt32Array > KeyValueStorage::GetValue( const KvsKey< KvsUInt32Array >& ) const noexcept;
+    template core::Result< KvsInt64Array > KeyValueStorage::GetValue( const KvsKey< KvsInt64Array >& ) const noexcept;
+    template core::Result< KvsUInt64Array > KeyValueStorage::GetValue( const KvsKey< KvsUInt64Array >& ) const noexcept;
+    template core::Result< KvsFloatArray > KeyValueStorage::GetValue( const KvsKey< KvsFloatArray >& ) const noexcept;
+    template core::Result< KvsDoubleArray > KeyValueStorage::GetValue( const KvsKey< KvsDoubleArray >& ) const noexcept;
+
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Int8 >&, const core::Int8& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::UInt8 >&, const core::UInt8& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Int16 >&, const core::Int16& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::UInt16 >&, const core::UInt16& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Int32 >&, const core::Int32& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::UInt32 >&, const core::UInt32& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Int64 >&, const core::Int64& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::UInt64 >&, const core::UInt64& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Bool >&, const core::Bool& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Float >&, const core::Float& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::Double >&, const core::Double& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< core::String >&, const core::String& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsBlob >&, const KvsBlob& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsInt8Array >&, const KvsInt8Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsInt16Array >&, const KvsInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsUInt16Array >&, const KvsUInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsInt32Array >&, const KvsInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsUInt32Array >&, const KvsUInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsInt64Array >&, const KvsInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsUInt64Array >&, const KvsUInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsFloatArray >&, const KvsFloatArray& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKey< KvsDoubleArray >&, const KvsDoubleArray& ) noexcept;
+
+    core::Result< KvsKeyHandle > KeyValueStorage::Resolve( core::StringView key ) const noexcept
+    {
+        using result = core::Result< KvsKeyHandle >;
+
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        try {
+            KvsKeyHandle handle( key );
+            m_pKvsBackend->ResolveKey( handle );
+            return result::FromValue( ::std::move( handle ) );
+        } catch ( const std::exception& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    template< class T >
+    core::Result< T > KeyValueStorage::GetValue( const KvsKeyHandle& handle ) const noexcept
+    {
+        using result = core::Result< T >;
+
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->GetValueResolved( handle );
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+
+        if ( ::lap::core::GetVariantIndex( retValue.Value() ) != KvsKey< T >::Index ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+
+        return result::FromValue( ::lap::core::get< T >( ::std::move( retValue.Value() ) ) );
+    }
+
+    template< class T >
+    core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle& handle, const T& value ) noexcept
+    {
+        using result = core::Result<void>;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->SetValueResolved( handle, KvsDataType{ value } );
+        if ( retValue.HasValue() ) notify( handle.Name(), KvsChangeType::kSet );
+
+        return retValue;
+    }
+
+    template core::Result< core::Int8 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::UInt8 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Int16 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::UInt16 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Int32 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::UInt32 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Int64 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::UInt64 > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Bool > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Float > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::Double > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< core::String > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsBlob > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsInt8Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsInt16Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsUInt16Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsInt32Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsUInt32Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsInt64Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsUInt64Array > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsFloatArray > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+    template core::Result< KvsDoubleArray > KeyValueStorage::GetValue( const KvsKeyHandle& ) const noexcept;
+
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Int8& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::UInt8& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Int16& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::UInt16& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Int32& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::UInt32& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Int64& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::UInt64& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Bool& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Float& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::Double& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const core::String& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsBlob& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsInt8Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsUInt16Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsUInt32Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsUInt64Array& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsFloatArray& ) noexcept;
+    template core::Result<void> KeyValueStorage::SetValue( const KvsKeyHandle&, const KvsDoubleArray& ) noexcept;
+
+    template< class T >
+    core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< T > buffer ) const noexcept
+    {
+        using result = core::Result< core::Size >;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->GetValueInto( key, KvsArrayType< T >::value,
+                                                     core::Span< core::Byte >( reinterpret_cast< core::Byte* >( buffer.data() ), buffer.size() * sizeof( T ) ) );
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+
+        return result::FromValue( retValue.Value() / sizeof( T ) );
+    }
+
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Int8 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::UInt8 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Int16 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::UInt16 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Int32 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::UInt32 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Int64 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::UInt64 > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Float > ) const noexcept;
+    template core::Result< core::Size > KeyValueStorage::GetValueInto( core::StringView key, core::Span< core::Double > ) const noexcept;
+
+    template< class T >
+    core::Result< T > KeyValueStorage::FetchAdd( core::StringView key, const T& delta ) noexcept
+    {
+        using result = core::Result< T >;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->FetchAdd( key, KvsDataType{ delta } );
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+        if ( ::lap::core::GetVariantIndex( retValue.Value() ) != KvsKey< T >::Index ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        notify( key, KvsChangeType::kSet );
+
+        return result::FromValue( ::lap::core::get< T >( retValue.Value() ) );
+    }
+
+    template core::Result< core::Int8 > KeyValueStorage::FetchAdd( core::StringView, const core::Int8& ) noexcept;
+    template core::Result< core::UInt8 > KeyValueStorage::FetchAdd( core::StringView, const core::UInt8& ) noexcept;
+    template core::Result< core::Int16 > KeyValueStorage::FetchAdd( core::StringView, const core::Int16& ) noexcept;
+    template core::Result< core::UInt16 > KeyValueStorage::FetchAdd( core::StringView, const core::UInt16& ) noexcept;
+    template core::Result< core::Int32 > KeyValueStorage::FetchAdd( core::StringView, const core::Int32& ) noexcept;
+    template core::Result< core::UInt32 > KeyValueStorage::FetchAdd( core::StringView, const core::UInt32& ) noexcept;
+    template core::Result< core::Int64 > KeyValueStorage::FetchAdd( core::StringView, const core::Int64& ) noexcept;
+    template core::Result< core::UInt64 > KeyValueStorage::FetchAdd( core::StringView, const core::UInt64& ) noexcept;
+    template core::Result< core::Float > KeyValueStorage::FetchAdd( core::StringView, const core::Float& ) noexcept;
+    template core::Result< core::Double > KeyValueStorage::FetchAdd( core::StringView, const core::Double& ) noexcept;
+
+    template< class T >
+    core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView key, const T& expected, const T& desired ) noexcept
+    {
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->CompareExchange( key, KvsDataType{ expected }, KvsDataType{ desired } );
+        if ( retValue.HasValue() && retValue.Value() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
+    }
+
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Int8&, const core::Int8& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::UInt8&, const core::UInt8& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Int16&, const core::Int16& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::UInt16&, const core::UInt16& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Int32&, const core::Int32& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::UInt32&, const core::UInt32& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Int64&, const core::Int64& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::UInt64&, const core::UInt64& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Bool&, const core::Bool& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Float&, const core::Float& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::Double&, const core::Double& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const core::String&, const core::String& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsBlob&, const KvsBlob& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsInt8Array&, const KvsInt8Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsInt16Array&, const KvsInt16Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsUInt16Array&, const KvsUInt16Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsInt32Array&, const KvsInt32Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsUInt32Array&, const KvsUInt32Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsInt64Array&, const KvsInt64Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsUInt64Array&, const KvsUInt64Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsFloatArray&, const KvsFloatArray& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::CompareExchange( core::StringView, const KvsDoubleArray&, const KvsDoubleArray& ) noexcept;
+
+    template< class T >
+    core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView key, const T& value ) noexcept
+    {
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->SetIfAbsent( key, KvsDataType{ value } );
+        if ( retValue.HasValue() && retValue.Value() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
+    }
+
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Int8& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::UInt8& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Int16& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::UInt16& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Int32& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::UInt32& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Int64& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::UInt64& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Bool& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Float& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::Double& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const core::String& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsBlob& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsInt8Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsInt16Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsUInt16Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsInt32Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsUInt32Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsInt64Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsUInt64Array& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsFloatArray& ) noexcept;
+    template core::Result< core::Bool > KeyValueStorage::SetIfAbsent( core::StringView, const KvsDoubleArray& ) noexcept;
+
+    core::Result< KvsSnapshot > KeyValueStorage::Snapshot() const noexcept
+    {
+        using result = core::Result< KvsSnapshot >;
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->CreateSnapshot();
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+
+        return result::FromValue( KvsSnapshot( ::std::move( retValue.Value() ) ) );
+    }
 
     core::Result<void> KeyValueStorage::RemoveKey( core::StringView key ) noexcept
     {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->RemoveKey( key );
+        auto retValue = m_pKvsBackend->RemoveKey( key );
+        if ( retValue.HasValue() ) notify( key, KvsChangeType::kRemove );
+
+        return retValue;
     }
 
     core::Result<void> KeyValueStorage::RecoverKey( core::StringView key ) noexcept
     {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->RecoverKey( key );
+        auto retValue = m_pKvsBackend->RecoverKey( key );
+        if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
     }
 
     core::Result<void> KeyValueStorage::ResetKey( core::StringView key ) noexcept
 {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->ResetKey( key );
+        auto retValue = m_pKvsBackend->ResetKey( key );
+        if ( retValue.HasValue() ) notify( key, KvsChangeType::kSet );
+
+        return retValue;
     }
 
     core::Result<void> KeyValueStorage::RemoveAllKeys() noexcept
     {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->RemoveAllKeys();
+        auto retValue = m_pKvsBackend->RemoveAllKeys();
+        if ( retValue.HasValue() ) notify( "", KvsChangeType::kRemoveAll );
+
+        return retValue;
     }
 
     core::Result<void> KeyValueStorage::SyncToStorage() const noexcept
     {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
+        if ( !m_pGroupCommit ) return m_pKvsBackend->SyncToStorage();
 
-        return m_pKvsBackend->SyncToStorage();
+        return m_pGroupCommit->Sync( [this]() { return m_pKvsBackend->SyncToStorage(); } );
+    }
+
+    core::Result< KvsSyncProgress > KeyValueStorage::SyncToStorage( const KvsSyncBudget& budget ) const noexcept
+    {
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result< KvsSyncProgress >::FromError( PerErrc::kNotInitialized );
+
+        KvsSyncMeter meter( budget );
+        return m_pKvsBackend->SyncToStorage( meter );
+    }
+
+    core::Result< core::UInt64 > KeyValueStorage::Export( IKvsRecordSink& sink, core::Size batchSize ) const noexcept
+    {
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result< core::UInt64 >::FromError( PerErrc::kNotInitialized );
+
+        return m_pKvsBackend->Export( sink, batchSize );
+    }
+
+    core::Result< core::UInt64 > KeyValueStorage::Import( IKvsRecordSource& source, const KvsImportOptions& options ) noexcept
+    {
+        if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result< core::UInt64 >::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pKvsBackend->Import( source, options );
+        if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+
+        return retValue;
     }
 
     core::Result<void> KeyValueStorage::DiscardPendingChanges() noexcept
     {
         if ( !m_pKvsBackend || !m_pKvsBackend->available() ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
 
-        return m_pKvsBackend->DiscardPendingChanges();
+        auto retValue = m_pKvsBackend->DiscardPendingChanges();
+        if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+
+        return retValue;
+    }
+
+    core::Result< KvsSubscriptionId > KeyValueStorage::Subscribe( core::StringView prefix, KvsChangeCallback callback ) noexcept
+    {
+        if ( !m_pNotifier ) return core::Result< KvsSubscriptionId >::FromError( PerErrc::kNotInitialized );
+
+        return m_pNotifier->Subscribe( prefix, ::std::move( callback ) );
+    }
+
+    core::Result< KvsSubscriptionId > KeyValueStorage::Subscribe( const core::Vector< core::String >& keys, KvsChangeCallback callback ) noexcept
+    {
+        if ( !m_pNotifier ) return core::Result< KvsSubscriptionId >::FromError( PerErrc::kNotInitialized );
+
+        return m_pNotifier->Subscribe( keys, ::std::move( callback ) );
+    }
+
+    core::Result<void> KeyValueStorage::Unsubscribe( KvsSubscriptionId id ) noexcept
+    {
+        if ( !m_pNotifier ) return core::Result<void>::FromError( PerErrc::kNotInitialized );
+
+        return m_pNotifier->Unsubscribe( id );
+    }
+
+    void KeyValueStorage::FlushNotifications() noexcept
+    {
+        if ( m_pNotifier ) m_pNotifier->Flush();
+    }
+
+    core::Result< KvsMemoryStatistics > KeyValueStorage::GetMemoryStatistics() const noexcept
+    {
+        using result = core::Result< KvsMemoryStatistics >;
+
+        if ( !m_pMemory ) return result::FromError( PerErrc::kUnsupported );
+
+        return result::FromValue( m_pMemory->GetStatistics() );
+    }
+
+    void KeyValueStorage::SetGroupCommitWindow( core::UInt32 windowUs ) noexcept
+    {
+        if ( m_pGroupCommit ) m_pGroupCommit->SetWindow( windowUs );
+    }
+
+    core::Result< KvsGroupCommitStatistics > KeyValueStorage::GetGroupCommitStatistics() const noexcept
+    {
+        using result = core::Result< KvsGroupCommitStatistics >;
+
+        if ( !m_pGroupCommit ) return result::FromError( PerErrc::kNotInitialized );
+
+        return result::FromValue( m_pGroupCommit->GetStatistics() );
+    }
+
+    void KeyValueStorage::notify( core::StringView key, KvsChangeType type ) noexcept
+    {
+        if ( m_pNotifier && m_pNotifier->HasSubscribers() ) m_pNotifier->Publish( key, type );
     }
 
     core::Result< void > KeyValueStorage::RecoverKeyValueStorage() noexcept
     {
         using result = core::Result< void >;
 
-        return result::FromValue();
+        // Changes nothing yet; kReload only tells subscribers to re-read
+        auto retValue = result::FromValue();
+        if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+
+        return retValue;
     }
 
     core::Result< void > KeyValueStorage::ResetKeyValueStorage() noexcept
     {
         using result = core::Result< void >;
 
-        return result::FromValue();
+        // Changes nothing yet: no key is removed, so kReload rather than kRemoveAll
+        auto retValue = result::FromValue();
+        if ( retValue.HasValue() ) notify( "", KvsChangeType::kReload );
+
+        return retValue;
     }
 
     core::Result< core::UInt64 > KeyValueStorage::GetCurrentKeyValueStorageSize() noexcept
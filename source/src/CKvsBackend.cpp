@@ -89,9 +89,7 @@ namespace per
     void KvsBackend::formatKey( core::String &key, EKvsDataTypeIndicate valueType )
     {
         if ( key.size() >= 2 && key[ DEF_KVS_MAGIC_KEY_INDEX ] == DEF_KVS_MAGIC_KEY ) {
-#ifdef LAP_DEBUG
-            LAP_PER_LOG_INFO << "Key is already format";
-#endif
+            LAP_PER_LOG_VERBOSE << "Key is already format";
             return;
         }
 
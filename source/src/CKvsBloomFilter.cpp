@@ -0,0 +1,122 @@
+/**
+ * @file CKvsBloomFilter.cpp
+ * @brief Blocked Bloom filter for negative key lookups
+ * @version 1.0
+ * @date 2025-11-25
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+#include "CKvsBloomFilter.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        // MurmurHash3 finalizer: spreads FNV-1a's weak low bits over the whole word
+        constexpr core::UInt64 mix( core::UInt64 hash ) noexcept
+        {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        constexpr core::UInt64 BLOCK_SEED = 0x9e3779b97f4a7c15ull;
+    }
+
+    void KvsBloomFilter::Reset( core::Size capacity ) noexcept
+    {
+        capacity = ::std::max( capacity, MIN_CAPACITY );
+
+        // Power-of-two block count, so a block is picked with a mask
+        core::Size blocks = 1;
+        while ( blocks * BLOCK_BITS < capacity * BITS_PER_KEY ) blocks <<= 1;
+
+        try {
+            m_blocks.assign( blocks, Block{} );
+        } catch ( const ::std::bad_alloc& ) {
+            // Keep the current size, only the false-positive rate suffers
+            ::std::fill( m_blocks.begin(), m_blocks.end(), Block{} );
+            capacity = m_blocks.size() * BLOCK_BITS / BITS_PER_KEY;
+        }
+
+        m_count     = 0;
+        m_capacity  = capacity;
+    }
+
+    core::Bool KvsBloomFilter::Load( const core::UInt8* data, core::Size size, core::Size count ) noexcept
+    {
+        const core::Size blocks = size / sizeof( Block );
+        if ( blocks == 0 || size % sizeof( Block ) != 0 || ( blocks & ( blocks - 1 ) ) != 0 ) return false;
+
+        try {
+            m_blocks.resize( blocks );
+        } catch ( const ::std::bad_alloc& ) {
+            return false;
+        }
+        ::std::memcpy( m_blocks.data(), data, size );
+
+        m_count     = count;
+        m_capacity  = blocks * BLOCK_BITS / BITS_PER_KEY;
+        return true;
+    }
+
+    const KvsBloomFilter::Block& KvsBloomFilter::block( core::UInt64 hash ) const noexcept
+    {
+        return m_blocks[ mix( hash ^ BLOCK_SEED ) & ( m_blocks.size() - 1 ) ];
+    }
+
+    void KvsBloomFilter::Add( core::UInt64 hash ) noexcept
+    {
+        if ( m_blocks.empty() ) return;
+
+        Block& target = const_cast< Block& >( block( hash ) );
+
+        // HASHES 9-bit slices of one mixed word select the bits inside the block
+        core::UInt64 bits = mix( hash );
+        for ( core::UInt32 i = 0; i < HASHES; ++i, bits >>= 9 ) {
+            core::UInt32 bit = static_cast< core::UInt32 >( bits & ( BLOCK_BITS - 1 ) );
+            target.words[ bit >> 6 ] |= 1ull << ( bit & 63 );
+        }
+
+        ++m_count;
+    }
+
+    core::Bool KvsBloomFilter::MayContain( core::UInt64 hash ) const noexcept
+    {
+        if ( m_blocks.empty() ) return true;
+
+        const Block& target = block( hash );
+
+        core::UInt64 bits = mix( hash );
+        for ( core::UInt32 i = 0; i < HASHES; ++i, bits >>= 9 ) {
+            core::UInt32 bit = static_cast< core::UInt32 >( bits & ( BLOCK_BITS - 1 ) );
+            if ( ( target.words[ bit >> 6 ] & ( 1ull << ( bit & 63 ) ) ) == 0 ) return false;
+        }
+
+        return true;
+    }
+
+    core::Double KvsBloomFilter::FillRatio() const noexcept
+    {
+        if ( m_blocks.empty() ) return 0.0;
+
+        core::UInt64 set = 0;
+        for ( const auto& b : m_blocks ) {
+            for ( auto word : b.words ) set += ::std::bitset< 64 >( word ).count();
+        }
+
+        return static_cast< core::Double >( set ) / static_cast< core::Double >( Bits() );
+    }
+
+} // namespace per
+} // namespace lap
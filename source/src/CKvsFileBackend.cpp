@@ -7,14 +7,17 @@
  * @copyright Copyright (c) 2025
  * 
  * @note This implementation follows Core module constraints:
- * - Uses core::File::ReadAllBytes/WriteAllBytes (no std::ifstream/ofstream)
+ * - All file I/O goes through the injected IVirtualFileSystem (no std::ifstream/ofstream)
  * - Uses core::Path for path operations
  * - Uses core::Result for error handling
  * - Uses nlohmann/json for proper JSON type support
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 #include <nlohmann/json.hpp>
-#include <lap/core/CFile.hpp>
 #include <lap/core/CPath.hpp>
 #include "CKvsFileBackend.hpp"
 #include "CStoragePathManager.hpp"
@@ -23,6 +26,223 @@ namespace lap
 {
 namespace per
 {
+namespace
+{
+    // Member lookups compare against the pool-allocated names without allocating a key
+    ::std::string_view jsonKey( core::StringView key ) noexcept
+    {
+        return ::std::string_view( key.data(), key.size() );
+    }
+
+    // Convert a stored JSON entry to KvsDataType (may throw nlohmann::json exceptions)
+    core::Result< KvsDataType > decodeJsonValue( const KvsJson& jsonValue )
+    {
+        using result = core::Result< KvsDataType >;
+
+        // Convert JSON value to KvsDataType based on stored type
+        if (jsonValue.is_object() && jsonValue.contains("type") && jsonValue.contains("value")) {
+            // Structured format: {"type": "d", "value": 123}
+            const auto& typeStr = jsonValue["type"].get_ref<const KvsJsonString&>();
+            char typeChar = typeStr.empty() ? 'k' : typeStr[0];
+            
+            // Convert based on type marker
+            switch (static_cast<EKvsDataTypeIndicate>(typeChar - 'a')) {
+                case EKvsDataTypeIndicate::DataType_int8_t:
+                    return result::FromValue(KvsDataType{static_cast<core::Int8>(jsonValue["value"].get<int>())});
+                case EKvsDataTypeIndicate::DataType_uint8_t:
+                    return result::FromValue(KvsDataType{static_cast<core::UInt8>(jsonValue["value"].get<unsigned>())});
+                case EKvsDataTypeIndicate::DataType_int16_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int16>()});
+                case EKvsDataTypeIndicate::DataType_uint16_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt16>()});
+                case EKvsDataTypeIndicate::DataType_int32_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int32>()});
+                case EKvsDataTypeIndicate::DataType_uint32_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt32>()});
+                case EKvsDataTypeIndicate::DataType_int64_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int64>()});
+                case EKvsDataTypeIndicate::DataType_uint64_t:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt64>()});
+                case EKvsDataTypeIndicate::DataType_bool:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<bool>()});
+                case EKvsDataTypeIndicate::DataType_float:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::Float>()});
+                case EKvsDataTypeIndicate::DataType_double:
+                    return result::FromValue(KvsDataType{jsonValue["value"].get<core::Double>()});
+                case EKvsDataTypeIndicate::DataType_string: {
+                    // Single copy out of the JSON document, size-aware
+                    const auto& text = jsonValue["value"].get_ref<const KvsJsonString&>();
+                    return result::FromValue(KvsDataType{core::String(text.data(), text.size())});
+                }
+                case EKvsDataTypeIndicate::DataType_blob:
+                case EKvsDataTypeIndicate::DataType_int8_array:
+                case EKvsDataTypeIndicate::DataType_int16_array:
+                case EKvsDataTypeIndicate::DataType_uint16_array:
+                case EKvsDataTypeIndicate::DataType_int32_array:
+                case EKvsDataTypeIndicate::DataType_uint32_array:
+                case EKvsDataTypeIndicate::DataType_int64_array:
+                case EKvsDataTypeIndicate::DataType_uint64_array:
+                case EKvsDataTypeIndicate::DataType_float_array:
+                case EKvsDataTypeIndicate::DataType_double_array: {
+                    // Blob and arrays are binary values in host byte order, base64 only in the file
+                    const auto& bytes = jsonValue["value"].get_binary();
+                    KvsDataType raw;
+                    if (!kvsFromRawBytes(static_cast<EKvsDataTypeIndicate>(typeChar - 'a'), bytes.data(), bytes.size(), raw)) {
+                        return result::FromError( PerErrc::kIntegrityCorrupted );
+                    }
+                    return result::FromValue(::std::move(raw));
+                }
+                default:
+                    return result::FromValue(KvsDataType{core::String(jsonValue["value"].get_ref<const KvsJsonString&>().c_str())});
+            }
+        } else {
+            // Legacy format or direct value - treat as string
+            if (jsonValue.is_string()) {
+                return result::FromValue(KvsDataType{core::String(jsonValue.get_ref<const KvsJsonString&>().c_str())});
+            } else if (jsonValue.is_number_integer()) {
+                return result::FromValue(KvsDataType{jsonValue.get<core::Int32>()});
+            } else if (jsonValue.is_number_float()) {
+                return result::FromValue(KvsDataType{jsonValue.get<core::Double>()});
+            } else if (jsonValue.is_boolean()) {
+                return result::FromValue(KvsDataType{jsonValue.get<bool>()});
+            }
+        }
+        
+        return result::FromError( PerErrc::kDataTypeMismatch );
+    }
+
+    // Convert a value to its stored JSON entry: {"type": "x", "value": actual_value}
+    KvsJson encodeJsonValue( const KvsDataType& value )
+    {
+        char typeMarker = static_cast<char>('a' + ::lap::core::GetVariantIndex(value));
+        KvsJson jsonValue = KvsJson::object();
+        jsonValue["type"] = KvsJsonString(1, typeMarker);
+        
+        // Store actual value with correct JSON type
+        switch (static_cast<EKvsDataTypeIndicate>(::lap::core::GetVariantIndex(value))) {
+            case EKvsDataTypeIndicate::DataType_int8_t:
+                jsonValue["value"] = static_cast<int>(::lap::core::get<core::Int8>(value));
+                break;
+            case EKvsDataTypeIndicate::DataType_uint8_t:
+                jsonValue["value"] = static_cast<unsigned>(::lap::core::get<core::UInt8>(value));
+                break;
+            case EKvsDataTypeIndicate::DataType_int16_t:
+                jsonValue["value"] = ::lap::core::get<core::Int16>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_uint16_t:
+                jsonValue["value"] = ::lap::core::get<core::UInt16>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_int32_t:
+                jsonValue["value"] = ::lap::core::get<core::Int32>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_uint32_t:
+                jsonValue["value"] = ::lap::core::get<core::UInt32>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_int64_t:
+                jsonValue["value"] = ::lap::core::get<core::Int64>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_uint64_t:
+                jsonValue["value"] = ::lap::core::get<core::UInt64>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_bool:
+                jsonValue["value"] = ::lap::core::get<core::Bool>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_float:
+                jsonValue["value"] = ::lap::core::get<core::Float>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_double:
+                jsonValue["value"] = ::lap::core::get<core::Double>(value);
+                break;
+            case EKvsDataTypeIndicate::DataType_string: {
+                // One copy into the document's pool
+                const auto& text = ::lap::core::get<core::String>(value);
+                jsonValue["value"] = KvsJsonString(text.data(), text.size());
+                break;
+            }
+            default: {
+                // Blob and arrays: binary value of the contiguous raw bytes
+                const core::Byte* rawData = nullptr;
+                core::Size rawSize = 0;
+                if (kvsRawBytes(value, rawData, rawSize)) {
+                    jsonValue["value"] = KvsJson::binary(KvsJson::binary_t::container_type(rawData, rawData + rawSize));
+                }
+                break;
+            }
+        }
+
+        return jsonValue;
+    }
+
+    // Type of a stored entry, false if it carries no valid type marker
+    core::Bool entryType( const KvsJson& entry, EKvsDataTypeIndicate& type )
+    {
+        if (!entry.is_object()) return false;
+        auto marker = entry.find("type");
+        if (marker == entry.end() || !marker->is_string() || marker->get_ref<const KvsJsonString&>().size() != 1) return false;
+
+        const core::UInt32 index = static_cast<core::UInt32>(marker->get_ref<const KvsJsonString&>()[0] - 'a');
+        if (index > static_cast<core::UInt32>(EKvsDataTypeIndicate::DataType_double_array)) return false;
+        type = static_cast<EKvsDataTypeIndicate>(index);
+        return true;
+    }
+
+    // Turn the base64 text of a parsed document's raw members into binary values, once per load.
+    // The file holds array elements little-endian, memory in host byte order
+    core::Bool loadBinaryMembers( KvsJson& root )
+    {
+        if (!root.is_object()) return root.is_null();
+
+        for (auto& member : root.items()) {
+            EKvsDataTypeIndicate type;
+            auto& entry = member.value();
+            if (!entryType(entry, type) || !isKvsRawType(type)) continue;
+
+            auto value = entry.find("value");
+            if (value == entry.end() || !value->is_string()) return false;
+
+            const auto& text = value->get_ref<const KvsJsonString&>();
+            KvsJson::binary_t::container_type bytes(kvsBase64DecodedSize(::std::string_view(text)));
+            if (text.size() % 4 != 0 || !kvsBase64DecodeInto(text, bytes.data(), bytes.size()) ||
+                bytes.size() % kvsRawElementSize(type) != 0) return false;
+            kvsRawSwapLittleEndian(type, bytes.data(), bytes.size());
+            *value = KvsJson::binary(::std::move(bytes));
+        }
+        return true;
+    }
+
+    // Append one member as it is written to the file: binary values as base64 text
+    void appendMember( ::std::string& out, const KvsJsonString& key, const KvsJson& entry )
+    {
+        out += KvsJson(key).dump();
+        out += ": ";
+
+        auto value = entry.is_object() ? entry.find("value") : entry.end();
+        if (value == entry.end() || !value->is_binary()) {
+            out += entry.dump();
+            return;
+        }
+
+        const auto& bytes = value->get_binary();
+        const core::Byte* data = bytes.data();
+        KvsBlob swapped;
+        EKvsDataTypeIndicate type;
+        if (!KVS_LITTLE_ENDIAN_HOST && entryType(entry, type) && kvsRawElementSize(type) > 1) {
+            swapped.assign(bytes.begin(), bytes.end());
+            kvsRawSwapLittleEndian(type, swapped.data(), swapped.size());
+            data = swapped.data();
+        }
+
+        out += "{\"type\":";
+        out += entry["type"].dump();
+        out += ",\"value\":\"";
+        out += kvsBlobToBase64(data, bytes.size());
+        out += "\"}";
+    }
+
+    // Largest piece of a file written, verified or copied by one incremental sync unit
+    constexpr core::UInt64 SYNC_CHUNK_SIZE = 64 * 1024;
+} // namespace
+
     // ==================== IKvsBackend Interface Implementation ====================
 
     core::Result<core::Vector<core::String>> KvsFileBackend::GetAllKeys() const noexcept
@@ -36,7 +256,7 @@ namespace per
         core::Vector<core::String> keys;
         if (m_kvsRoot.is_object()) {
             for (auto it = m_kvsRoot.begin(); it != m_kvsRoot.end(); ++it) {
-                keys.emplace_back(it.key().c_str());
+                keys.emplace_back(it.key().data(), it.key().size());
             }
         }
 
@@ -51,19 +271,17 @@ namespace per
 
         if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
 
-        // Get file size using core::File
-        if (!core::File::Util::exists(m_strFile.c_str())) {
+        if (!m_pVfs->Exists(m_strFile)) {
             return result::FromValue(static_cast<core::UInt64>(0));
         }
 
-        // Use core::File::Util to get file size
-        core::Vector<core::UInt8> fileData;
-        if (!core::File::Util::ReadBinary(m_strFile, fileData)) {
-            LAP_PER_LOG_WARN << "KvsFileBackend::GetSize failed to read file: " << m_strFile;
+        auto sizeResult = m_pVfs->GetFileSize(m_strFile);
+        if (!sizeResult.HasValue()) {
+            LAP_PER_LOG_WARN << "KvsFileBackend::GetSize failed to stat file: " << m_strFile;
             return result::FromError(PerErrc::kFileNotFound);
         }
 
-        return result::FromValue(static_cast<core::UInt64>(fileData.size()));
+        return sizeResult;
     }
 
     core::Result<core::UInt32> KvsFileBackend::GetKeyCount() const noexcept
@@ -84,61 +302,12 @@ namespace per
         core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
         
         try {
-            if (!m_kvsRoot.contains(key.data())) {
+            auto it = m_kvsRoot.find( jsonKey( key ) );
+            if (it == m_kvsRoot.end()) {
                 return result::FromError( PerErrc::kKeyNotFound );
             }
             
-            const auto& jsonValue = m_kvsRoot[key.data()];
-            
-            // Convert JSON value to KvsDataType based on stored type
-            if (jsonValue.is_object() && jsonValue.contains("type") && jsonValue.contains("value")) {
-                // Structured format: {"type": "d", "value": 123}
-                core::String typeStr = jsonValue["type"].get<std::string>();
-                char typeChar = typeStr.empty() ? 'k' : typeStr[0];
-                
-                // Convert based on type marker
-                switch (static_cast<EKvsDataTypeIndicate>(typeChar - 'a')) {
-                    case EKvsDataTypeIndicate::DataType_int8_t:
-                        return result::FromValue(KvsDataType{static_cast<core::Int8>(jsonValue["value"].get<int>())});
-                    case EKvsDataTypeIndicate::DataType_uint8_t:
-                        return result::FromValue(KvsDataType{static_cast<core::UInt8>(jsonValue["value"].get<unsigned>())});
-                    case EKvsDataTypeIndicate::DataType_int16_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int16>()});
-                    case EKvsDataTypeIndicate::DataType_uint16_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt16>()});
-                    case EKvsDataTypeIndicate::DataType_int32_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int32>()});
-                    case EKvsDataTypeIndicate::DataType_uint32_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt32>()});
-                    case EKvsDataTypeIndicate::DataType_int64_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::Int64>()});
-                    case EKvsDataTypeIndicate::DataType_uint64_t:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::UInt64>()});
-                    case EKvsDataTypeIndicate::DataType_bool:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<bool>()});
-                    case EKvsDataTypeIndicate::DataType_float:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::Float>()});
-                    case EKvsDataTypeIndicate::DataType_double:
-                        return result::FromValue(KvsDataType{jsonValue["value"].get<core::Double>()});
-                    case EKvsDataTypeIndicate::DataType_string:
-                        return result::FromValue(KvsDataType{core::String(jsonValue["value"].get<std::string>().c_str())});
-                    default:
-                        return result::FromValue(KvsDataType{core::String(jsonValue["value"].get<std::string>().c_str())});
-                }
-            } else {
-                // Legacy format or direct value - treat as string
-                if (jsonValue.is_string()) {
-                    return result::FromValue(KvsDataType{core::String(jsonValue.get<std::string>().c_str())});
-                } else if (jsonValue.is_number_integer()) {
-                    return result::FromValue(KvsDataType{jsonValue.get<core::Int32>()});
-                } else if (jsonValue.is_number_float()) {
-                    return result::FromValue(KvsDataType{jsonValue.get<core::Double>()});
-                } else if (jsonValue.is_boolean()) {
-                    return result::FromValue(KvsDataType{jsonValue.get<bool>()});
-                }
-            }
-            
-            return result::FromError( PerErrc::kDataTypeMismatch );
+            return decodeJsonValue( *it );
         } catch (const std::exception& e) {
             LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::GetValue with key[%s] failed: %s!", key.data(), e.what() );
             return result::FromError( PerErrc::kKeyNotFound );
@@ -152,55 +321,16 @@ namespace per
         if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
 
         core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
+        KvsMemoryScope scope(m_pResource);
         
         try {
-            // Store with type information: {"type": "x", "value": actual_value}
-            char typeMarker = static_cast<char>('a' + ::lap::core::GetVariantIndex(value));
-            nlohmann::json jsonValue = nlohmann::json::object();
-            jsonValue["type"] = std::string(1, typeMarker);
-            
-            // Store actual value with correct JSON type
-            switch (static_cast<EKvsDataTypeIndicate>(::lap::core::GetVariantIndex(value))) {
-                case EKvsDataTypeIndicate::DataType_int8_t:
-                    jsonValue["value"] = static_cast<int>(::lap::core::get<core::Int8>(value));
-                    break;
-                case EKvsDataTypeIndicate::DataType_uint8_t:
-                    jsonValue["value"] = static_cast<unsigned>(::lap::core::get<core::UInt8>(value));
-                    break;
-                case EKvsDataTypeIndicate::DataType_int16_t:
-                    jsonValue["value"] = ::lap::core::get<core::Int16>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_uint16_t:
-                    jsonValue["value"] = ::lap::core::get<core::UInt16>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_int32_t:
-                    jsonValue["value"] = ::lap::core::get<core::Int32>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_uint32_t:
-                    jsonValue["value"] = ::lap::core::get<core::UInt32>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_int64_t:
-                    jsonValue["value"] = ::lap::core::get<core::Int64>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_uint64_t:
-                    jsonValue["value"] = ::lap::core::get<core::UInt64>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_bool:
-                    jsonValue["value"] = ::lap::core::get<core::Bool>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_float:
-                    jsonValue["value"] = ::lap::core::get<core::Float>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_double:
-                    jsonValue["value"] = ::lap::core::get<core::Double>(value);
-                    break;
-                case EKvsDataTypeIndicate::DataType_string:
-                    jsonValue["value"] = ::lap::core::get<core::String>(value).c_str();
-                    break;
-            }
-            
-            m_kvsRoot[key.data()] = jsonValue;
+            m_kvsRoot[jsonKey( key )] = encodeJsonValue( value );
             m_dirty = true;
+            ++m_version;
+            m_snapshots.Changed( key );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetValue with key[%s] failed: memory pool exhausted!", key.data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
         } catch (const std::exception& e) {
             LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetValue with ( %s, %s ) failed: %s!", key.data(), kvsToStrig( value ).c_str(), e.what() );
             return result::FromError( PerErrc::kIllegalWriteAccess );
@@ -209,6 +339,322 @@ namespace per
         return result::FromValue();
     }
 
+    core::Result<void> KvsFileBackend::GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept
+    {
+        using result = core::Result<void>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
+
+        try {
+            auto it = m_kvsRoot.find( jsonKey( key ) );
+            if ( it == m_kvsRoot.end() ) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+
+            const auto type = static_cast<EKvsDataTypeIndicate>( ::lap::core::GetVariantIndex( out ) );
+            const auto& jsonValue = *it;
+            if ( !jsonValue.is_object() || !jsonValue.contains("type") || !jsonValue.contains("value") ||
+                 jsonValue["type"].get_ref<const KvsJsonString&>() != KvsJsonString(1, static_cast<char>('a' + static_cast<core::UInt32>(type))) ) {
+                return result::FromError( PerErrc::kDataTypeMismatch );
+            }
+
+            if ( type == EKvsDataTypeIndicate::DataType_string ) {
+                // Assign into the caller's string, reusing its capacity
+                const auto& text = jsonValue["value"].get_ref<const KvsJsonString&>();
+                ::lap::core::get<core::String>( out ).assign( text.data(), text.size() );
+                return result::FromValue();
+            }
+
+            if ( isKvsRawType( type ) ) {
+                // Copy the binary value into the caller's vector, reusing its capacity
+                const auto& bytes = jsonValue["value"].get_binary();
+                if ( !kvsFromRawBytes( type, bytes.data(), bytes.size(), out ) ) {
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                return result::FromValue();
+            }
+
+            auto decoded = decodeJsonValue( jsonValue );
+            if ( !decoded.HasValue() ) {
+                return result::FromError( decoded.Error() );
+            }
+            out = ::std::move( decoded.Value() );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::GetValueAssign with key[%s] failed: %s!", key.data(), e.what() );
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+
+        return result::FromValue();
+    }
+
+    KvsJson* KvsFileBackend::locateNode( const KvsKeyHandle& handle ) const
+    {
+        auto* node = static_cast< KvsJson* >( cachedNode( handle, m_generation ) );
+        if ( nullptr == node ) {
+            auto it = m_kvsRoot.find( jsonKey( handle.Name() ) );
+            if ( it == m_kvsRoot.end() ) {
+                return nullptr;
+            }
+            // JSON objects are std::map based: element addresses survive inserts, only erase frees them
+            node = const_cast< KvsJson* >( &*it );
+            cacheNode( handle, node, m_generation );
+        }
+        return node;
+    }
+
+    void KvsFileBackend::ResolveKey( const KvsKeyHandle& handle ) const noexcept
+    {
+        if ( !m_bAvailable ) return;
+
+        core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
+
+        try {
+            locateNode( handle );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::ResolveKey with key[%s] failed: %s!", handle.Name().data(), e.what() );
+        }
+    }
+
+    core::Result< KvsDataType > KvsFileBackend::GetValueResolved( const KvsKeyHandle& handle ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
+
+        try {
+            const auto* node = locateNode( handle );
+            if ( nullptr == node ) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+
+            return decodeJsonValue( *node );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::GetValueResolved with key[%s] failed: %s!", handle.Name().data(), e.what() );
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+    }
+
+    core::Result<void> KvsFileBackend::SetValueResolved( const KvsKeyHandle& handle, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result<void>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
+        KvsMemoryScope scope(m_pResource);
+
+        try {
+            auto* node = locateNode( handle );
+            if ( nullptr == node ) {
+                // New key: insert by name and cache the fresh node
+                node = &m_kvsRoot[jsonKey( handle.Name() )];
+                cacheNode( handle, node, m_generation );
+            }
+
+            *node = encodeJsonValue( value );
+            m_dirty = true;
+            ++m_version;
+            m_snapshots.Changed( handle.Name() );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetValueResolved with key[%s] failed: memory pool exhausted!", handle.Name().data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetValueResolved with ( %s, %s ) failed: %s!", handle.Name().data(), kvsToStrig( value ).c_str(), e.what() );
+            return result::FromError( PerErrc::kIllegalWriteAccess );
+        }
+
+        return result::FromValue();
+    }
+
+    core::Result<core::Size> KvsFileBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span<core::Byte> buffer ) const noexcept
+    {
+        using result = core::Result<core::Size>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
+
+        try {
+            auto it = m_kvsRoot.find( jsonKey( key ) );
+            if (it == m_kvsRoot.end()) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+
+            const auto& jsonValue = *it;
+            if (!jsonValue.is_object() || !jsonValue.contains("type") || !jsonValue.contains("value") ||
+                jsonValue["type"].get_ref<const KvsJsonString&>() != KvsJsonString(1, static_cast<char>('a' + static_cast<core::UInt32>(type))) ||
+                !isKvsRawType(type)) {
+                return result::FromError( PerErrc::kDataTypeMismatch );
+            }
+
+            // Binary values are copied straight into the caller's buffer
+            const auto& bytes = jsonValue["value"].get_binary();
+            if (bytes.size() > buffer.size()) {
+                return result::FromError( PerErrc::kWrongDataSize );
+            }
+            if (!bytes.empty()) ::std::memcpy(buffer.data(), bytes.data(), bytes.size());
+
+            return result::FromValue( bytes.size() );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::GetValueInto with key[%s] failed: %s!", key.data(), e.what() );
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+    }
+
+    // ==================== Atomic Read-Modify-Write ====================
+
+    core::Result< KvsDataType > KvsFileBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType previous;
+        if ( !kvsZeroValue( delta, previous ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        core::WriteLockGuard lock(m_rwLock);  // Read and write under one exclusive lock
+        KvsMemoryScope scope(m_pResource);
+
+        try {
+            const auto name = jsonKey( key );
+            auto it = m_kvsRoot.find( name );
+            if ( it != m_kvsRoot.end() ) {
+                auto current = decodeJsonValue( *it );
+                if ( !current.HasValue() ) {
+                    return result::FromError( current.Error() );
+                }
+                previous = ::std::move( current.Value() );
+            }
+
+            KvsDataType sum;
+            if ( !kvsAddValues( previous, delta, sum ) ) {
+                return result::FromError( PerErrc::kDataTypeMismatch );
+            }
+
+            // Inserting into the object keeps existing members (and cached handles) in place
+            m_kvsRoot[name] = encodeJsonValue( ::std::move( sum ) );
+            m_dirty = true;
+            ++m_version;
+            m_snapshots.Changed( key );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::FetchAdd with key[%s] failed: memory pool exhausted!", key.data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::FetchAdd with key[%s] failed: %s!", key.data(), e.what() );
+            return result::FromError( PerErrc::kIllegalWriteAccess );
+        }
+
+        return result::FromValue( ::std::move( previous ) );
+    }
+
+    core::Result<core::Bool> KvsFileBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        using result = core::Result<core::Bool>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock(m_rwLock);  // Read and write under one exclusive lock
+        KvsMemoryScope scope(m_pResource);
+
+        try {
+            auto it = m_kvsRoot.find( jsonKey( key ) );
+            if ( it == m_kvsRoot.end() ) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+
+            auto current = decodeJsonValue( *it );
+            if ( !current.HasValue() ) {
+                return result::FromError( current.Error() );
+            }
+            if ( !( current.Value() == expected ) ) {
+                return result::FromValue( false );
+            }
+
+            *it = encodeJsonValue( desired );
+            m_dirty = true;
+            ++m_version;
+            m_snapshots.Changed( key );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::CompareExchange with key[%s] failed: memory pool exhausted!", key.data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::CompareExchange with key[%s] failed: %s!", key.data(), e.what() );
+            return result::FromError( PerErrc::kIllegalWriteAccess );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result<core::Bool> KvsFileBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result<core::Bool>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock(m_rwLock);  // Read and write under one exclusive lock
+        KvsMemoryScope scope(m_pResource);
+
+        try {
+            const auto name = jsonKey( key );
+            if ( m_kvsRoot.contains( name ) ) {
+                return result::FromValue( false );
+            }
+
+            m_kvsRoot[name] = encodeJsonValue( value );
+            m_dirty = true;
+            ++m_version;
+            m_snapshots.Changed( key );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetIfAbsent with key[%s] failed: memory pool exhausted!", key.data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::SetIfAbsent with ( %s, %s ) failed: %s!", key.data(), kvsToStrig( value ).c_str(), e.what() );
+            return result::FromError( PerErrc::kIllegalWriteAccess );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsFileBackend::CreateSnapshot() const noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        // Members are ordered by key: a chunk resumes after the last key copied
+        auto readChunk = [this]( KvsMapSnapshot::Entries& out, core::Size limit ) -> core::Result< core::Bool > {
+            if ( !m_kvsRoot.is_object() ) return core::Result< core::Bool >::FromValue( true );
+
+            const auto& members = m_kvsRoot.get_ref< const KvsJson::object_t& >();
+            auto it = out.empty() ? members.begin() : members.upper_bound( jsonKey( out.back().first ) );
+            for ( ; it != members.end() && limit > 0; ++it, --limit ) {
+                auto value = decodeJsonValue( it->second );
+                if ( !value.HasValue() ) return core::Result< core::Bool >::FromError( value.Error() );
+                out.emplace_back( core::String( it->first.data(), it->first.size() ), ::std::move( value.Value() ) );
+            }
+            return core::Result< core::Bool >::FromValue( it == members.end() );
+        };
+        auto readKey = [this]( core::StringView key, KvsDataType& out ) -> core::Result< core::Bool > {
+            auto it = m_kvsRoot.find( jsonKey( key ) );
+            if ( it == m_kvsRoot.end() ) return core::Result< core::Bool >::FromValue( false );
+
+            auto value = decodeJsonValue( *it );
+            if ( !value.HasValue() ) return core::Result< core::Bool >::FromError( value.Error() );
+            out = ::std::move( value.Value() );
+            return core::Result< core::Bool >::FromValue( true );
+        };
+
+        auto snapshot = m_snapshots.Acquire( m_rwLock, readChunk, readKey );
+        if ( !snapshot.HasValue() ) {
+            LAP_PER_LOG_WARN << "KvsFileBackend::CreateSnapshot failed: " << snapshot.Error().Message();
+        }
+        return snapshot;
+    }
+
     // ==================== AUTOSAR Key-Value Storage API ====================
 
     core::Result<core::Bool> KvsFileBackend::KeyExists(core::StringView key) const noexcept
@@ -218,7 +664,7 @@ namespace per
         if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
 
         core::ReadLockGuard lock(m_rwLock);  // Shared lock for read [SWS_PER_00309]
-        return result::FromValue(m_kvsRoot.contains(key.data()));
+        return result::FromValue(m_kvsRoot.contains(jsonKey(key)));
     }
 
     core::Result<void> KvsFileBackend::RemoveKey(core::StringView key) noexcept
@@ -229,8 +675,12 @@ namespace per
 
         core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
         
-        m_kvsRoot.erase( key.data() );
+        if ( m_kvsRoot.is_object() && m_kvsRoot.erase( jsonKey( key ) ) > 0 ) {
+            m_generation = nextGeneration();  // Invalidate cached nodes
+        }
         m_dirty = true;  // Mark as dirty
+        ++m_version;
+        m_snapshots.Changed( key );
 
         return result::FromValue();
     }
@@ -262,15 +712,115 @@ namespace per
         core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
         
         m_kvsRoot.clear();
+        m_generation = nextGeneration();  // Invalidate cached nodes
         m_dirty = true;  // Mark as dirty
+        ++m_version;
+        m_snapshots.Cleared();
 
         return result::FromValue();
     }
 
+    core::Result<core::UInt64> KvsFileBackend::Export( IKvsRecordSink& sink, core::Size batchSize ) const noexcept
+    {
+        using result = core::Result<core::UInt64>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+        if ( batchSize == 0 ) batchSize = KVS_RECORD_BATCH_SIZE;
+
+        core::UInt64 expected = 0;
+        {
+            core::ReadLockGuard lock(m_rwLock);
+            expected = m_kvsRoot.is_object() ? m_kvsRoot.size() : 0;
+        }
+        auto begun = sink.Begin( expected );
+        if ( !begun.HasValue() ) return result::FromError( begun.Error() );
+
+        core::UInt64 exported = 0;
+        try {
+            KvsRecordBatch batch;
+            ::std::string lastKey;
+            for (;;) {
+                batch.clear();
+                {
+                    // Members in key order, each batch resumes after the last one; writers interleave between batches
+                    core::ReadLockGuard lock(m_rwLock);
+                    const auto* members = m_kvsRoot.is_object() ? m_kvsRoot.get_ptr<const KvsJson::object_t*>() : nullptr;
+                    if ( members != nullptr ) {
+                        for ( auto it = exported == 0 ? members->begin() : members->upper_bound( ::std::string_view( lastKey ) );
+                              it != members->end() && batch.size() < batchSize; ++it ) {
+                            auto value = decodeJsonValue( it->second );
+                            if ( !value.HasValue() ) return result::FromError( value.Error() );
+                            batch.push_back( KvsRecord{ core::String( it->first.data(), it->first.size() ), ::std::move( value.Value() ) } );
+                        }
+                    }
+                }
+                if ( batch.empty() ) break;
+
+                auto written = sink.Write( batch );
+                if ( !written.HasValue() ) return result::FromError( written.Error() );
+                exported += batch.size();
+                lastKey.assign( batch.back().key.data(), batch.back().key.size() );
+                if ( batch.size() < batchSize ) break;
+            }
+        } catch (const std::bad_alloc&) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        auto finished = sink.Finish();
+        if ( !finished.HasValue() ) return result::FromError( finished.Error() );
+        return result::FromValue( exported );
+    }
+
+    core::Result<core::UInt64> KvsFileBackend::Import( IKvsRecordSource& source, const KvsImportOptions& options ) noexcept
+    {
+        using result = core::Result<core::UInt64>;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        if ( options.clearFirst ) {
+            auto cleared = RemoveAllKeys();
+            if ( !cleared.HasValue() ) return result::FromError( cleared.Error() );
+        }
+
+        core::UInt64 imported = 0;
+        KvsRecordBatch batch;
+        for (;;) {
+            auto read = source.Read( batch, options.batchSize );
+            if ( !read.HasValue() ) return result::FromError( read.Error() );
+            if ( read.Value() == 0 ) break;
+
+            // One exclusive lock per batch instead of one per key
+            core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
+            KvsMemoryScope scope(m_pResource);
+            try {
+                for ( auto& record : batch ) {
+                    m_snapshots.Changed( record.key );
+                    m_kvsRoot[jsonKey( record.key )] = encodeJsonValue( record.value );
+                }
+            } catch (const std::bad_alloc&) {
+                LAP_PER_LOG_WARN << "KvsFileBackend::Import failed after " << imported << " records: memory pool exhausted!";
+                m_dirty = true;
+                ++m_version;
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            } catch (const std::exception& e) {
+                LAP_PER_LOG_WARN << "KvsFileBackend::Import failed after " << imported << " records: " << e.what();
+                m_dirty = true;
+                ++m_version;
+                return result::FromError( PerErrc::kIllegalWriteAccess );
+            }
+            m_dirty = true;
+            ++m_version;
+            imported += batch.size();
+        }
+
+        return result::FromValue( imported );
+    }
+
     core::Result<void> KvsFileBackend::SyncToStorage() noexcept
     {
         core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
         
+        m_pPendingSync.reset();  // A full sync supersedes an unfinished incremental one
         if (!m_dirty) {
             return core::Result<void>::FromValue();  // No changes to sync
         }
@@ -278,7 +828,7 @@ namespace per
         // ==================== AUTOSAR Update Workflow [SWS_PER_00600] ====================
         // Phase 1: Save to update/ directory (not current/)
         core::String updatePath = getUpdatePath();
-        LAP_PER_LOG_INFO << "AUTOSAR Workflow - Phase 1: Saving to update/ directory";
+        LAP_PER_LOG_VERBOSE << "AUTOSAR Workflow - Phase 1: Saving to update/ directory";
         auto saveResult = saveToFile(updatePath);
         if (!saveResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to save to update/ directory";
@@ -286,39 +836,248 @@ namespace per
         }
         
         // Phase 2: Validate data integrity [SWS_PER_00800]
-        LAP_PER_LOG_INFO << "AUTOSAR Workflow - Phase 2: Validating data integrity";
+        LAP_PER_LOG_VERBOSE << "AUTOSAR Workflow - Phase 2: Validating data integrity";
         auto validateResult = validateDataIntegrity(updatePath);
         if (!validateResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Integrity validation failed, aborting commit";
-            core::File::Util::remove(updatePath.data()); // Cleanup invalid update file
+            m_pVfs->RemoveFile(updatePath); // Cleanup invalid update file
             return validateResult;
         }
         
         // Phase 3: Backup current/ to redundancy/ [SWS_PER_00502]
-        LAP_PER_LOG_INFO << "AUTOSAR Workflow - Phase 3: Backing up to redundancy/";
+        LAP_PER_LOG_VERBOSE << "AUTOSAR Workflow - Phase 3: Backing up to redundancy/";
         auto backupResult = backupToRedundancy();
         if (!backupResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Backup to redundancy failed, aborting commit";
-            core::File::Util::remove(updatePath.data()); // Cleanup update file
+            m_pVfs->RemoveFile(updatePath); // Cleanup update file
             return backupResult;
         }
         
         // Phase 4: Atomic replace [SWS_PER_00600]
-        LAP_PER_LOG_INFO << "AUTOSAR Workflow - Phase 4: Atomic commit (update/ -> current/)";
+        LAP_PER_LOG_VERBOSE << "AUTOSAR Workflow - Phase 4: Atomic commit (update/ -> current/)";
         auto replaceResult = atomicReplaceCurrentWithUpdate();
         if (!replaceResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Atomic replace failed - system state preserved";
             // Note: Rollback can be implemented using DiscardPendingChanges()
-            core::File::Util::remove(updatePath.data()); // Cleanup update file
+            m_pVfs->RemoveFile(updatePath); // Cleanup update file
             return replaceResult;
         }
         
-        // Success: Mark clean and log completion
+        // Success: Mark clean and log completion (at most once per second)
         m_dirty = false;
-        LAP_PER_LOG_INFO << "AUTOSAR Workflow - Complete: Data committed successfully";
+        LAP_PER_LOG_EVERY_MS( INFO, 1000 ) << "AUTOSAR Workflow - Complete: Data committed successfully";
         return core::Result<void>::FromValue();
     }
 
+    core::Result<KvsSyncProgress> KvsFileBackend::SyncToStorage(KvsSyncMeter& meter) noexcept
+    {
+        using result = core::Result<KvsSyncProgress>;
+        using Phase = PendingSync::Phase;
+
+        // Pin the state a new sync writes before taking the write lock: the snapshot takes shared locks
+        // itself. The version is read first, so at worst it is older than the pin and the backend stays dirty.
+        core::SharedHandle<const KvsMapSnapshot> pinned;
+        core::UInt64 pinnedVersion = 0;
+        core::Bool needPin = false;
+        {
+            core::ReadLockGuard lock(m_rwLock);
+            needPin = !m_pPendingSync && m_dirty;
+            pinnedVersion = m_version;
+        }
+        if (needPin) {
+            auto snapshot = CreateSnapshot();
+            if (!snapshot.HasValue()) return result::FromError(snapshot.Error());
+            pinned = ::std::static_pointer_cast<const KvsMapSnapshot>(snapshot.Value());
+        }
+
+        core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
+
+        try {
+            if (!m_pPendingSync) {
+                if (!m_dirty) {
+                    return result::FromValue(KvsSyncProgress{});  // No changes to sync
+                }
+                if (!pinned) {
+                    // Became dirty after the check above, the next call pins it
+                    KvsSyncProgress progress;
+                    progress.complete = false;
+                    return result::FromValue(progress);
+                }
+                m_pPendingSync = ::std::make_unique<PendingSync>();
+                m_pPendingSync->pSnapshot = ::std::move(pinned);
+                m_pPendingSync->version = pinnedVersion;
+                m_pPendingSync->data = "{";
+            }
+            auto& sync = *m_pPendingSync;
+
+            // Serialize members in key order, all as of the pinned snapshot
+            while (sync.phase == Phase::kSerialize && meter.admit(1, 0)) {
+                KvsMapSnapshot::Cursor cursor(*sync.pSnapshot);
+                if (sync.serialized > 0) cursor.Seek(sync.lastKey);
+                core::StringView key;
+                const KvsDataType* value = nullptr;
+                if (!cursor.Next(key, value)) {
+                    sync.data += sync.serialized > 0 ? "\n}" : "}";
+                    auto sizeResult = m_pVfs->Exists(getCurrentPath()) ? m_pVfs->GetFileSize(getCurrentPath())
+                                                                       : core::Result<core::UInt64>::FromValue(0);
+                    sync.backupSize = sizeResult.HasValue() ? sizeResult.Value() : 0;
+                    sync.phase = Phase::kWriteUpdate;
+                    meter.spend(0, 0);
+                    break;
+                }
+                sync.data += sync.serialized > 0 ? ",\n    " : "\n    ";
+                appendMember(sync.data, KvsJsonString(key.data(), key.size()), encodeJsonValue(*value));
+                sync.lastKey.assign(key.data(), key.size());
+                ++sync.serialized;
+                meter.spend(1, 0);
+            }
+
+            // Write, verify or copy one chunk per unit
+            while (sync.phase != Phase::kSerialize && sync.phase != Phase::kCommit) {
+                const core::UInt64 total = sync.phase == Phase::kBackup ? sync.backupSize : sync.data.size();
+                if (sync.offset >= total) {
+                    sync.phase = static_cast<Phase>(static_cast<core::UInt8>(sync.phase) + 1);
+                    sync.offset = 0;
+                    continue;
+                }
+                const auto chunk = ::std::min({ SYNC_CHUNK_SIZE, total - sync.offset, meter.bytesLeft() });
+                // File I/O varies most: predict from the slowest chunk of the whole sync, not only of this call
+                if (chunk == 0 || !meter.admit(0, chunk, sync.longestChunkNs)) break;
+
+                const auto chunkStart = ::std::chrono::steady_clock::now();
+                auto chunkResult = syncChunk(static_cast<core::Size>(chunk));
+                if (!chunkResult.HasValue()) {
+                    abandonPendingSync();
+                    return result::FromError(chunkResult.Error());
+                }
+                sync.offset += chunk;
+                sync.longestChunkNs = ::std::max<core::UInt64>(sync.longestChunkNs,
+                    ::std::chrono::duration_cast<::std::chrono::nanoseconds>(::std::chrono::steady_clock::now() - chunkStart).count());
+                meter.spend(0, chunk);
+            }
+
+            // Phase 4: Atomic replace [SWS_PER_00600]
+            if (sync.phase == Phase::kCommit && meter.admit(0, 0)) {
+                const core::String tempPath = getCurrentPath() + ".tmp";
+                if (!m_pVfs->RenameFile(tempPath, getCurrentPath()).HasValue()) {
+                    LAP_PER_LOG_ERROR << "Atomic rename failed: " << tempPath.data();
+                    abandonPendingSync();
+                    return result::FromError(PerErrc::kPhysicalStorageFailure);
+                }
+                meter.spend(0, 0);
+
+                // Changes made while the sync ran may have missed it
+                if (sync.version == m_version) m_dirty = false;
+                m_pPendingSync.reset();
+                LAP_PER_LOG_EVERY_MS( INFO, 1000 ) << "AUTOSAR Workflow - Complete: Data committed incrementally";
+                return result::FromValue(KvsSyncProgress{});
+            }
+
+            KvsSyncProgress progress;
+            progress.complete = false;
+            if (sync.phase == Phase::kSerialize) {
+                auto countResult = sync.pSnapshot->GetKeyCount();
+                const core::UInt64 count = countResult.HasValue() ? countResult.Value() : 0;
+                progress.remainingRecords = count > sync.serialized ? count - sync.serialized : 0;
+            } else {
+                for (auto phase = sync.phase; phase != Phase::kCommit;
+                     phase = static_cast<Phase>(static_cast<core::UInt8>(phase) + 1)) {
+                    const core::UInt64 total = phase == Phase::kBackup ? sync.backupSize : sync.data.size();
+                    progress.remainingBytes += total - (phase == sync.phase ? ::std::min(sync.offset, total) : 0);
+                }
+            }
+            return result::FromValue(progress);
+        } catch (const std::bad_alloc&) {
+            abandonPendingSync();
+            return result::FromError(PerErrc::kOutOfMemorySpace);
+        } catch (const std::exception& e) {
+            LAP_PER_LOG_WARN << "KvsFileBackend incremental sync failed with exception: " << e.what();
+            abandonPendingSync();
+            return result::FromError(PerErrc::kPhysicalStorageFailure);
+        }
+    }
+
+    core::Result<void> KvsFileBackend::syncChunk(core::Size chunk) noexcept
+    {
+        using result = core::Result<void>;
+        using Phase = PendingSync::Phase;
+
+        auto& sync = *m_pPendingSync;
+        const auto* data = reinterpret_cast<const core::UInt8*>(sync.data.data()) + sync.offset;
+
+        // One writer per phase: the first chunk creates or truncates the file, the last one flushes it once
+        auto writeChunk = [this, &sync, chunk](core::StringView path, const core::UInt8* bytes, core::Size size) {
+            if (sync.offset == 0) {
+                auto writer = m_pVfs->OpenWriter(path);
+                if (!writer.HasValue()) return result::FromError(writer.Error());
+                sync.pWriter = ::std::move(writer.Value());
+            }
+            auto writeResult = sync.pWriter->Write(bytes, size);
+            if (!writeResult.HasValue()) return writeResult;
+
+            const core::UInt64 total = sync.phase == Phase::kBackup ? sync.backupSize : sync.data.size();
+            if (sync.offset + chunk < total) return writeResult;
+            auto flushResult = sync.pWriter->Sync();
+            sync.pWriter.reset();
+            return flushResult;
+        };
+
+        switch (sync.phase) {
+            case Phase::kWriteUpdate: {
+                // Phase 1: Save to update/ directory (not current/)
+                auto writeResult = writeChunk(getUpdatePath(), data, chunk);
+                if (!writeResult.HasValue()) {
+                    LAP_PER_LOG_ERROR << "Failed to save to update/ directory";
+                    if (static_cast<PerErrc>(writeResult.Error().Value()) == PerErrc::kOutOfStorageSpace) return writeResult;
+                    return result::FromError(PerErrc::kFileNotFound);
+                }
+                break;
+            }
+            case Phase::kVerifyUpdate: {
+                // Phase 2: Validate data integrity [SWS_PER_00800], byte by byte against what was written
+                auto sizeResult = m_pVfs->GetFileSize(getUpdatePath());
+                auto readResult = m_pVfs->ReadFileRange(getUpdatePath(), sync.offset, chunk);
+                if (!sizeResult.HasValue() || sizeResult.Value() != sync.data.size() || !readResult.HasValue()
+                    || !::std::equal(readResult.Value().begin(), readResult.Value().end(), data)) {
+                    LAP_PER_LOG_ERROR << "Integrity validation failed, aborting commit";
+                    return result::FromError(PerErrc::kIntegrityCorrupted);
+                }
+                break;
+            }
+            case Phase::kBackup: {
+                // Phase 3: Backup current/ to redundancy/ [SWS_PER_00502]
+                auto readResult = m_pVfs->ReadFileRange(getCurrentPath(), sync.offset, chunk);
+                if (!readResult.HasValue() || !writeChunk(getRedundancyPath(), readResult.Value().data(), chunk).HasValue()) {
+                    LAP_PER_LOG_ERROR << "Backup to redundancy failed, aborting commit";
+                    return result::FromError(PerErrc::kPhysicalStorageFailure);
+                }
+                break;
+            }
+            case Phase::kWriteTemp: {
+                // Phase 4 preparation: the copy of update/ that gets renamed over current/
+                if (!writeChunk(getCurrentPath() + ".tmp", data, chunk).HasValue()) {
+                    LAP_PER_LOG_ERROR << "Failed to write temp file: " << getCurrentPath() << ".tmp";
+                    return result::FromError(PerErrc::kPhysicalStorageFailure);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        return result::FromValue();
+    }
+
+    void KvsFileBackend::abandonPendingSync() noexcept
+    {
+        // A torn update or temp file must never become current
+        if (m_pPendingSync && m_pPendingSync->phase != PendingSync::Phase::kSerialize) {
+            m_pPendingSync->pWriter.reset();
+            m_pVfs->RemoveFile(getUpdatePath());
+            m_pVfs->RemoveFile(getCurrentPath() + ".tmp");
+        }
+        m_pPendingSync.reset();
+    }
+
     core::Result<void> KvsFileBackend::DiscardPendingChanges() noexcept
     {
         using result = core::Result<void>;
@@ -327,6 +1086,7 @@ namespace per
 
         core::WriteLockGuard lock(m_rwLock);  // Exclusive lock for write [SWS_PER_00309]
         
+        m_pPendingSync.reset();
         auto loadResult = parseFromFile( m_strFile );
         if (loadResult.HasValue()) {
             m_dirty = false;  // Clear dirty flag after reload
@@ -340,30 +1100,44 @@ namespace per
     {
         using result = core::Result<void>;
 
-        // Check if file exists using core::File
-        if (!core::File::Util::exists(strFile.data())) {
+        if (!m_pVfs->Exists(strFile)) {
             LAP_PER_LOG_INFO << "KvsFileBackend::parseFromFile file not found (first run): " << strFile.data();
             // Not an error for first run, just initialize empty
             m_kvsRoot.clear();
+            m_generation = nextGeneration();  // Invalidate cached nodes
+            ++m_version;
+            m_snapshots.Cleared();
             return result::FromValue();
         }
 
-        // ✅ Use core::File::Util::ReadBinary instead of std::ifstream
-        core::Vector<core::UInt8> fileData;
-        if (!core::File::Util::ReadBinary(strFile.data(), fileData)) {
+        auto readResult = m_pVfs->ReadFile(strFile);
+        if (!readResult.HasValue()) {
             LAP_PER_LOG_WARN << "KvsFileBackend::parseFromFile failed to read file: " << strFile.data();
             return result::FromError( PerErrc::kFileNotFound );
         }
 
         // Convert byte vector to string for nlohmann::json
+        const auto& fileData = readResult.Value();
         core::String jsonContent(fileData.begin(), fileData.end());
 
         try {
-            // Parse JSON using nlohmann::json
-            m_kvsRoot = nlohmann::json::parse(jsonContent.c_str());
-        } catch (const nlohmann::json::parse_error& e) {
+            // Parse JSON using nlohmann::json, the document is allocated from the backend's pool
+            KvsMemoryScope scope(m_pResource);
+            KvsJson document = KvsJson::parse(jsonContent.c_str());
+            if (!loadBinaryMembers(document)) {
+                LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::parseFromFile %s holds an invalid binary value!", strFile.data() );
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            m_kvsRoot = ::std::move(document);
+            m_generation = nextGeneration();  // Invalidate cached nodes
+            ++m_version;
+            m_snapshots.Invalidate();
+        } catch (const KvsJson::parse_error& e) {
             LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::parseFromFile parse JSON %s failed with exception: %s!!!", strFile.data(), e.what() );
             return result::FromError( PerErrc::kFileNotFound );
+        } catch (const std::bad_alloc&) {
+            LAP_PER_LOG_WARN.logFormat( "KvsFileBackend::parseFromFile JSON %s does not fit the memory pool!", strFile.data() );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
         }
         
         return result::FromValue();
@@ -374,27 +1148,35 @@ namespace per
         using result = core::Result<void>;
 
         try {
-            // Ensure parent directory exists using core::Path
+            // Ensure parent directory exists
             core::String filePathStr(strFile.data());
             auto lastSlashPos = filePathStr.rfind('/');
             
             if (lastSlashPos != core::String::npos) {
                 core::String dirPath = filePathStr.substr(0, lastSlashPos);
-                if (!core::Path::createDirectory(dirPath)) {
+                if (!m_pVfs->CreateDirectory(dirPath).HasValue()) {
                     LAP_PER_LOG_WARN << "KvsFileBackend::saveToFile failed to create directory: " << dirPath;
                     return result::FromError( PerErrc::kFileNotFound );
                 }
             }
             
-            // Serialize JSON using nlohmann::json with 4-space indentation
-            std::string jsonContent = m_kvsRoot.dump(4);
+            // One member per line, in key order: the same text the incremental sync writes
+            std::string jsonContent = "{";
+            if (m_kvsRoot.is_object()) {
+                for (auto it = m_kvsRoot.begin(); it != m_kvsRoot.end(); ++it) {
+                    jsonContent += it == m_kvsRoot.begin() ? "\n    " : ",\n    ";
+                    appendMember(jsonContent, it.key(), it.value());
+                }
+            }
+            jsonContent += m_kvsRoot.empty() ? "}" : "\n}";
             
-            // Write using core::File
-            if (!core::File::Util::WriteBinary(strFile.data(), 
+            auto writeResult = m_pVfs->WriteFile(strFile,
                 reinterpret_cast<const core::UInt8*>(jsonContent.data()), 
-                jsonContent.size(), 
-                true)) {  // createDirectories = true
+                jsonContent.size());
+            if (!writeResult.HasValue()) {
                 LAP_PER_LOG_WARN << "KvsFileBackend::saveToFile failed to write file: " << strFile.data();
+                // Surface out-of-space distinctly, everything else keeps the legacy code
+                if (static_cast<PerErrc>(writeResult.Error().Value()) == PerErrc::kOutOfStorageSpace) return writeResult;
                 return result::FromError( PerErrc::kFileNotFound );
             }
             
@@ -412,17 +1194,18 @@ namespace per
         using result = core::Result<void>;
         
         // Check 1: File existence
-        if (!core::File::Util::exists(filePath.data())) {
+        if (!m_pVfs->Exists(filePath)) {
             LAP_PER_LOG_ERROR << "Integrity check failed: File not found - " << filePath.data();
             return result::FromError(PerErrc::kFileNotFound);
         }
         
         // Check 2: File size (not empty, not too large)
-        core::Vector<core::UInt8> fileData;
-        if (!core::File::Util::ReadBinary(filePath.data(), fileData)) {
+        auto readResult = m_pVfs->ReadFile(filePath);
+        if (!readResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Integrity check failed: Cannot read file - " << filePath.data();
             return result::FromError(PerErrc::kIntegrityCorrupted);
         }
+        const auto& fileData = readResult.Value();
         
         if (fileData.empty()) {
             LAP_PER_LOG_ERROR << "Integrity check failed: File is empty - " << filePath.data();
@@ -432,10 +1215,11 @@ namespace per
         // Check 3: JSON format validation
         try {
             core::String jsonContent(fileData.begin(), fileData.end());
+            // Plain heap document: the check must not compete with m_kvsRoot for the pool
             nlohmann::json testJson = nlohmann::json::parse(jsonContent.c_str());
             
             // Successfully parsed - JSON is valid
-            LAP_PER_LOG_INFO << "Integrity check passed for: " << filePath.data();
+            LAP_PER_LOG_VERBOSE << "Integrity check passed for: " << filePath.data();
             
         } catch (const nlohmann::json::parse_error& e) {
             LAP_PER_LOG_ERROR << "Integrity check failed: Invalid JSON format - " 
@@ -457,29 +1241,19 @@ namespace per
         core::String redundancyPath = getRedundancyPath();
         
         // Check if current file exists
-        if (!core::File::Util::exists(currentPath.data())) {
+        if (!m_pVfs->Exists(currentPath)) {
             // No current file to backup (might be first run)
-            LAP_PER_LOG_INFO << "No current file to backup, skipping redundancy backup";
+            LAP_PER_LOG_DEBUG << "No current file to backup, skipping redundancy backup";
             return result::FromValue();
         }
         
-        // Read current file
-        core::Vector<core::UInt8> fileData;
-        if (!core::File::Util::ReadBinary(currentPath.data(), fileData)) {
-            LAP_PER_LOG_ERROR << "Failed to read current file for backup: " << currentPath.data();
-            return result::FromError(PerErrc::kPhysicalStorageFailure);
-        }
-        
-        // Write to redundancy
-        if (!core::File::Util::WriteBinary(redundancyPath.data(), 
-                                           fileData.data(), 
-                                           fileData.size(), 
-                                           true)) {
+        // Copy current file to redundancy
+        if (!m_pVfs->CopyFile(currentPath, redundancyPath).HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to write redundancy backup: " << redundancyPath.data();
             return result::FromError(PerErrc::kPhysicalStorageFailure);
         }
         
-        LAP_PER_LOG_INFO << "Backup created: " << redundancyPath.data();
+        LAP_PER_LOG_VERBOSE << "Backup created: " << redundancyPath.data();
         return result::FromValue();
     }
     
@@ -492,35 +1266,35 @@ namespace per
         core::String tempPath = currentPath + ".tmp";
         
         // Step 1: Check update file exists
-        if (!core::File::Util::exists(updatePath.data())) {
+        if (!m_pVfs->Exists(updatePath)) {
             LAP_PER_LOG_ERROR << "Update file not found: " << updatePath.data();
             return result::FromError(PerErrc::kFileNotFound);
         }
         
         // Step 2: Copy update to temp location
-        core::Vector<core::UInt8> updateData;
-        if (!core::File::Util::ReadBinary(updatePath.data(), updateData)) {
+        auto readResult = m_pVfs->ReadFile(updatePath);
+        if (!readResult.HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to read update file: " << updatePath.data();
             return result::FromError(PerErrc::kPhysicalStorageFailure);
         }
         
-        if (!core::File::Util::WriteBinary(tempPath.data(), 
-                                           updateData.data(), 
-                                           updateData.size(), 
-                                           true)) {
+        const auto& updateData = readResult.Value();
+        if (!m_pVfs->WriteFile(tempPath, updateData.data(), updateData.size()).HasValue()) {
             LAP_PER_LOG_ERROR << "Failed to write temp file: " << tempPath.data();
+            // A torn temp file must never become current
+            m_pVfs->RemoveFile(tempPath);
             return result::FromError(PerErrc::kPhysicalStorageFailure);
         }
         
         // Step 3: Atomic rename (POSIX rename is atomic)
-        if (rename(tempPath.c_str(), currentPath.c_str()) != 0) {
-            LAP_PER_LOG_ERROR << "Atomic rename failed: " << strerror(errno);
+        if (!m_pVfs->RenameFile(tempPath, currentPath).HasValue()) {
+            LAP_PER_LOG_ERROR << "Atomic rename failed: " << tempPath.data();
             // Cleanup temp file on failure
-            core::File::Util::remove(tempPath.data());
+            m_pVfs->RemoveFile(tempPath);
             return result::FromError(PerErrc::kPhysicalStorageFailure);
         }
         
-        LAP_PER_LOG_INFO << "Atomic replace successful: update/ -> current/";
+        LAP_PER_LOG_VERBOSE << "Atomic replace successful: update/ -> current/";
         return result::FromValue();
     }
 
@@ -541,9 +1315,12 @@ namespace per
         }
     }
 
-    KvsFileBackend::KvsFileBackend( core::StringView strFile ) noexcept
+    KvsFileBackend::KvsFileBackend( core::StringView strFile, core::SharedHandle< IVirtualFileSystem > vfs,
+                                    ::std::pmr::memory_resource* resource ) noexcept
         : m_strFile( strFile )
         , m_dirty(false)
+        , m_pVfs( vfs ? vfs : IVirtualFileSystem::getDefault() )
+        , m_pResource( resource )
     {
         // Use StoragePathManager to get standard KVS path
         core::String instancePath(strFile.data());
@@ -561,7 +1338,7 @@ namespace per
         LAP_PER_LOG_INFO << "  recovery/ : " << getRecoveryPath();
         
         // Create AUTOSAR 4-layer directory structure
-        auto createResult = CStoragePathManager::createStorageStructure(instancePath, "kvs");
+        auto createResult = createStorageStructure();
         if (!createResult.HasValue()) {
             LAP_PER_LOG_WARN << "Failed to create KVS directory structure for: " << instancePath;
             m_bAvailable = false;
@@ -581,6 +1358,22 @@ namespace per
     
     // ==================== AUTOSAR 4-Layer Directory Path Helpers ====================
     
+    core::Result<void> KvsFileBackend::createStorageStructure() noexcept
+    {
+        // Same layout as CStoragePathManager::createStorageStructure(instance, "kvs"),
+        // created through the injected file system
+        static const char* const s_subdirs[] = { "current", "update", "redundancy", "recovery" };
+        for (const auto* subdir : s_subdirs) {
+            core::String fullPath = core::Path::appendString(m_instancePath, subdir);
+            auto result = m_pVfs->CreateDirectory(fullPath);
+            if (!result.HasValue()) {
+                LAP_PER_LOG_ERROR << "Failed to create subdirectory: " << fullPath;
+                return result;
+            }
+        }
+        return core::Result<void>::FromValue();
+    }
+
     core::String KvsFileBackend::getCurrentPath() const noexcept
     {
         core::String currentDir = core::Path::appendString(m_instancePath, "current");
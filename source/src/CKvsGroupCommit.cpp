@@ -0,0 +1,67 @@
+/**
+ * @file CKvsGroupCommit.cpp
+ * @brief Group commit for concurrent SyncToStorage callers
+ * @version 1.0
+ * @date 2025-11-29
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <chrono>
+#include <new>
+
+#include "CKvsGroupCommit.hpp"
+
+namespace lap
+{
+namespace per
+{
+    core::Result< void > KvsGroupCommit::Sync( const ::std::function< core::Result< void >() >& sync ) noexcept
+    {
+        using result = core::Result< void >;
+
+        ::std::unique_lock< core::Mutex > lock( m_mutex );
+        ++m_stats.requests;
+
+        try {
+            if ( !m_pOpen ) m_pOpen = ::std::make_shared< Batch >();
+            auto batch = m_pOpen;
+
+            while ( !batch->done ) {
+                if ( m_leaderActive ) {
+                    m_done.wait( lock );
+                    continue;
+                }
+
+                // Lead this batch: let others join, close it, sync once for all of them
+                m_leaderActive = true;
+                const auto window = m_windowUs.load( ::std::memory_order_relaxed );
+                if ( window > 0 ) {
+                    m_done.wait_for( lock, ::std::chrono::microseconds( window ), []() { return false; } );
+                }
+                m_pOpen = nullptr;  // Later callers start the next batch
+
+                lock.unlock();
+                auto syncResult = sync();
+                lock.lock();
+
+                batch->result = syncResult;
+                batch->done = true;
+                m_leaderActive = false;
+                ++m_stats.physicalSyncs;
+                m_done.notify_all();
+            }
+
+            return batch->result;
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    KvsGroupCommitStatistics KvsGroupCommit::GetStatistics() const noexcept
+    {
+        core::LockGuard< core::Mutex > lock( m_mutex );
+        return m_stats;
+    }
+} // namespace per
+} // namespace lap
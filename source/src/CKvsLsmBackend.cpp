@@ -0,0 +1,1647 @@
+/**
+ * @file CKvsLsmBackend.cpp
+ * @brief Log-structured merge-tree KVS backend for write-heavy instances
+ * @version 1.0
+ * @date 2025-11-26
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <sstream>
+
+#include <lap/core/CCrypto.hpp>
+#include <lap/core/CPath.hpp>
+
+#include "CKvsLsmBackend.hpp"
+#include "CKvsBloomFilter.hpp"
+#include "CStoragePathManager.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        constexpr core::UInt32  RUN_MAGIC           = 0x314d534c;   // "LSM1"
+        constexpr core::UInt32  MANIFEST_FORMAT     = 1;
+        constexpr core::Size    ENTRY_HEADER_SIZE   = 10;           // key length, value length, flags, type
+        constexpr core::Size    WAL_HEADER_SIZE     = 8;            // batch length, crc32
+        constexpr core::Size    FOOTER_SIZE         = 32;           // index offset, bloom offset, entries, crc32, magic
+        constexpr core::UInt8   FLAG_DELETED        = 0x01;
+        constexpr const char*   MANIFEST_NAME       = "MANIFEST";
+        constexpr const char*   MANIFEST_TMP_NAME   = "MANIFEST.tmp";
+
+        template< class T >
+        void append( core::Vector< core::UInt8 >& out, T value )
+        {
+            const auto* bytes = reinterpret_cast< const core::UInt8* >( &value );
+            out.insert( out.end(), bytes, bytes + sizeof( T ) );
+        }
+
+        template< class T >
+        T load( const core::UInt8* data ) noexcept
+        {
+            T value;
+            ::std::memcpy( &value, data, sizeof( T ) );
+            return value;
+        }
+
+        core::UInt32 crc32( const core::UInt8* data, core::Size size ) noexcept
+        {
+            return core::Crypto::Util::computeCrc32( data, size );
+        }
+
+        /**
+         * @brief Bounds-checked sequential reader over a loaded file region
+         */
+        struct Reader
+        {
+            const core::UInt8*  pos;
+            const core::UInt8*  end;
+
+            template< class T >
+            core::Bool read( T& value ) noexcept
+            {
+                if ( static_cast< core::Size >( end - pos ) < sizeof( T ) ) return false;
+                value = load< T >( pos );
+                pos += sizeof( T );
+                return true;
+            }
+
+            core::Bool read( core::String& text )
+            {
+                core::UInt32 length = 0;
+                if ( !read( length ) || static_cast< core::Size >( end - pos ) < length ) return false;
+                text.assign( reinterpret_cast< const char* >( pos ), length );
+                pos += length;
+                return true;
+            }
+        };
+
+        // ==================== Entry encoding ====================
+        // [UInt32 keyLength][UInt32 valueLength][UInt8 flags][UInt8 type][key][value], value as kvsValueBytes()
+
+        void valueView( const KvsDataType& value, const core::UInt8*& data, core::Size& size ) noexcept
+        {
+            const core::Byte* bytes = nullptr;
+            size = 0;
+            kvsValueBytes( value, bytes, size );
+            data = reinterpret_cast< const core::UInt8* >( bytes );
+        }
+
+        core::Bool valueFrom( EKvsDataTypeIndicate type, const core::UInt8* data, core::Size size, KvsDataType& value )
+        {
+            return kvsValueFromBytes( type, reinterpret_cast< const core::Byte* >( data ), size, value );
+        }
+
+        struct EntryView
+        {
+            core::StringView        key;
+            core::Bool              deleted{ false };
+            EKvsDataTypeIndicate    type{ EKvsDataTypeIndicate::DataType_int8_t };
+            const core::UInt8*      value{ nullptr };
+            core::Size              valueSize{ 0 };
+            core::Size              size{ 0 };                  ///< Whole encoded entry
+        };
+
+        core::Bool parseEntry( const core::UInt8* data, core::Size available, EntryView& entry ) noexcept
+        {
+            if ( available < ENTRY_HEADER_SIZE ) return false;
+
+            const core::Size keySize    = load< core::UInt32 >( data );
+            const core::Size valueSize  = load< core::UInt32 >( data + 4 );
+            if ( available - ENTRY_HEADER_SIZE < keySize + valueSize ) return false;
+
+            entry.deleted   = ( data[8] & FLAG_DELETED ) != 0;
+            entry.type      = static_cast< EKvsDataTypeIndicate >( data[9] );
+            entry.key       = core::StringView( reinterpret_cast< const char* >( data + ENTRY_HEADER_SIZE ), keySize );
+            entry.value     = data + ENTRY_HEADER_SIZE + keySize;
+            entry.valueSize = valueSize;
+            entry.size      = ENTRY_HEADER_SIZE + keySize + valueSize;
+            return true;
+        }
+
+        template< class R >
+        core::Size entrySize( core::StringView key, const R& record ) noexcept
+        {
+            const core::UInt8* data = nullptr;
+            core::Size size = 0;
+            if ( !record.deleted ) valueView( record.value, data, size );
+            return ENTRY_HEADER_SIZE + key.size() + size;
+        }
+
+        template< class R >
+        void appendEntry( core::Vector< core::UInt8 >& out, core::StringView key, const R& record )
+        {
+            const core::UInt8* data = nullptr;
+            core::Size size = 0;
+            if ( !record.deleted ) valueView( record.value, data, size );
+
+            append< core::UInt32 >( out, static_cast< core::UInt32 >( key.size() ) );
+            append< core::UInt32 >( out, static_cast< core::UInt32 >( size ) );
+            out.push_back( record.deleted ? FLAG_DELETED : 0 );
+            out.push_back( static_cast< core::UInt8 >( ::lap::core::GetVariantIndex( record.value ) ) );
+            out.insert( out.end(), key.data(), key.data() + key.size() );
+            if ( size > 0 ) out.insert( out.end(), data, data + size );
+        }
+
+        template< class R >
+        core::Bool decodeEntry( const EntryView& entry, R& record )
+        {
+            record.deleted = entry.deleted;
+            if ( entry.deleted ) {
+                record.value = KvsDataType();
+                return true;
+            }
+            return valueFrom( entry.type, entry.value, entry.valueSize, record.value );
+        }
+
+        // Insert or replace, keeping the encoded size of the table in @p bytes
+        template< class Table, class R >
+        void mergeInto( Table& table, core::StringView key, R&& record, core::Size& bytes )
+        {
+            const core::Size size = entrySize( key, record );
+
+            auto it = table.find( key );
+            if ( it == table.end() ) {
+                table.emplace( core::String( key.data(), key.size() ), ::std::forward< R >( record ) );
+            } else {
+                bytes -= ::std::min( bytes, entrySize( key, it->second ) );
+                it->second = ::std::forward< R >( record );
+            }
+            bytes += size;
+        }
+
+        // "<prefix><number><suffix>"
+        core::Bool parseFileName( const core::String& name, core::StringView prefix, core::StringView suffix, core::UInt64& number ) noexcept
+        {
+            if ( name.size() <= prefix.size() + suffix.size() ) return false;
+            if ( name.compare( 0, prefix.size(), prefix.data(), prefix.size() ) != 0 ) return false;
+            if ( name.compare( name.size() - suffix.size(), suffix.size(), suffix.data(), suffix.size() ) != 0 ) return false;
+
+            number = 0;
+            for ( core::Size i = prefix.size(); i < name.size() - suffix.size(); ++i ) {
+                if ( name[i] < '0' || name[i] > '9' ) return false;
+                number = number * 10 + static_cast< core::UInt64 >( name[i] - '0' );
+            }
+            return true;
+        }
+
+        /**
+         * @brief Builds one sorted run file: entries | sparse index | Bloom filter | footer
+         *
+         * Index: [UInt32 largestKeyLength][largestKey][UInt32 count] and per block
+         * [UInt32 keyLength][firstKey][UInt64 offset][UInt32 crc32 of the block].
+         */
+        class RunBuilder final
+        {
+        public:
+            explicit RunBuilder( core::UInt32 indexInterval ) noexcept
+                : m_interval( ::std::max( indexInterval, core::UInt32( 1 ) ) )
+            {
+                ;
+            }
+
+            // Keys arrive in ascending order; encode appends the entry bytes
+            template< class Encode >
+            void Add( core::StringView key, Encode&& encode )
+            {
+                if ( m_count % m_interval == 0 ) m_index.emplace_back( core::String( key.data(), key.size() ), m_data.size() );
+                encode( m_data );
+                m_hashes.push_back( kvsKeyHash( key ) );
+                m_largest.assign( key.data(), key.size() );
+                ++m_count;
+            }
+
+            core::Bool                  Empty() const noexcept      { return m_count == 0; }
+            core::Size                  DataSize() const noexcept   { return m_data.size(); }
+
+            core::Vector< core::UInt8 > Finish()
+            {
+                core::Vector< core::UInt8 > file( ::std::move( m_data ) );
+                const core::UInt64 indexOffset = file.size();
+
+                append< core::UInt32 >( file, static_cast< core::UInt32 >( m_largest.size() ) );
+                file.insert( file.end(), m_largest.begin(), m_largest.end() );
+                append< core::UInt32 >( file, static_cast< core::UInt32 >( m_index.size() ) );
+                for ( core::Size i = 0; i < m_index.size(); ++i ) {
+                    const core::UInt64 begin    = m_index[i].second;
+                    const core::UInt64 end      = ( i + 1 < m_index.size() ) ? m_index[i + 1].second : indexOffset;
+                    const core::UInt32 crc      = crc32( file.data() + begin, end - begin );
+
+                    append< core::UInt32 >( file, static_cast< core::UInt32 >( m_index[i].first.size() ) );
+                    file.insert( file.end(), m_index[i].first.begin(), m_index[i].first.end() );
+                    append< core::UInt64 >( file, begin );
+                    append< core::UInt32 >( file, crc );
+                }
+
+                const core::UInt64 bloomOffset = file.size();
+                KvsBloomFilter bloom;
+                bloom.Reset( m_hashes.size() );
+                for ( auto hash : m_hashes ) bloom.Add( hash );
+                file.insert( file.end(), bloom.Data(), bloom.Data() + bloom.ByteSize() );
+
+                const core::UInt32 metaCrc = crc32( file.data() + indexOffset, file.size() - indexOffset );
+                append< core::UInt64 >( file, indexOffset );
+                append< core::UInt64 >( file, bloomOffset );
+                append< core::UInt64 >( file, m_count );
+                append< core::UInt32 >( file, metaCrc );
+                append< core::UInt32 >( file, RUN_MAGIC );
+
+                m_data.clear();
+                m_index.clear();
+                m_hashes.clear();
+                m_largest.clear();
+                m_count = 0;
+                return file;
+            }
+
+        private:
+            core::UInt32                                                m_interval;
+            core::UInt64                                                m_count{ 0 };
+            core::Vector< core::UInt8 >                                 m_data;
+            core::Vector< ::std::pair< core::String, core::UInt64 > >   m_index;
+            core::Vector< core::UInt64 >                                m_hashes;
+            core::String                                                m_largest;
+        };
+    }
+
+    /**
+     * @brief Immutable sorted run, its index and Bloom filter are held in memory
+     */
+    struct KvsLsmBackend::Run
+    {
+        core::SharedHandle< IVirtualFileSystem >    vfs;
+        core::String                                path;
+        core::UInt64                                id{ 0 };
+        core::UInt64                                fileSize{ 0 };
+        core::UInt64                                dataSize{ 0 };      ///< Entries end here, the index starts
+        core::UInt64                                entries{ 0 };
+        core::String                                smallest;
+        core::String                                largest;
+        core::Vector< core::String >                indexKeys;          ///< First key of every indexed block
+        core::Vector< core::UInt64 >                indexOffsets;
+        core::Vector< core::UInt32 >                indexCrcs;
+        KvsBloomFilter                              bloom;
+        ::std::atomic< core::Bool >                 obsolete{ false };  ///< Replaced by compaction, the file goes with the last reference
+
+        core::UInt64 blockEnd( core::Size block ) const noexcept
+        {
+            return block + 1 < indexOffsets.size() ? indexOffsets[block + 1] : dataSize;
+        }
+
+        ~Run() noexcept
+        {
+            if ( obsolete.load() ) vfs->RemoveFile( path );
+        }
+    };
+
+    struct KvsLsmBackend::Version
+    {
+        core::Vector< RunHandle >                   levels[ MAX_LEVELS ];   ///< Level 0 newest first, deeper levels key-disjoint and sorted
+    };
+
+    /**
+     * @brief Snapshot pinning the memtables and the run set of one moment
+     *
+     * Writers copy a pinned memtable before changing it, compaction keeps the
+     * files of pinned runs until the snapshot is released.
+     */
+    class KvsLsmBackend::Snapshot final : public IKvsSnapshot
+    {
+    public:
+        explicit Snapshot( Tables tables ) noexcept
+            : m_tables( ::std::move( tables ) )
+        {
+            ;
+        }
+
+        core::Result< core::Vector< core::String > > GetAllKeys() const noexcept override
+        {
+            return collectKeys( m_tables );
+        }
+
+        core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept override
+        {
+            auto state = lookup( key, nullptr );
+            if ( !state.HasValue() ) return core::Result< core::Bool >::FromError( state.Error() );
+            return core::Result< core::Bool >::FromValue( state.Value() == Lookup::kFound );
+        }
+
+        core::Result< KvsDataType > GetValue( core::StringView key ) const noexcept override
+        {
+            using result = core::Result< KvsDataType >;
+
+            KvsDataType value;
+            auto state = lookup( key, &value );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+            return result::FromValue( ::std::move( value ) );
+        }
+
+        core::Result< core::UInt32 > GetKeyCount() const noexcept override
+        {
+            auto keys = collectKeys( m_tables );
+            if ( !keys.HasValue() ) return core::Result< core::UInt32 >::FromError( keys.Error() );
+            return core::Result< core::UInt32 >::FromValue( static_cast< core::UInt32 >( keys.Value().size() ) );
+        }
+
+    private:
+        core::Result< Lookup > lookup( core::StringView key, KvsDataType* out ) const noexcept
+        {
+            try {
+                for ( const auto& table : m_tables.layers ) {
+                    Lookup state = findInTable( table.get(), key, out );
+                    if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+            }
+            return findInVersion( *m_tables.version, key, kvsKeyHash( key ), out );
+        }
+
+    private:
+        Tables      m_tables;
+    };
+
+    // ==================== Construction ====================
+
+    KvsLsmBackend::KvsLsmBackend( core::StringView identifier, core::SharedHandle< IVirtualFileSystem > vfs, const KvsLsmOptions& options ) noexcept
+        : m_pVfs( vfs ? vfs : IVirtualFileSystem::getDefault() )
+        , m_options( options )
+    {
+        try {
+            m_instancePath  = CStoragePathManager::getKvsInstancePath( identifier );
+            m_dataPath      = core::Path::appendString( m_instancePath, "current" );
+        } catch ( const ::std::bad_alloc& ) {
+            LAP_PER_LOG_ERROR << "Kvs LSM backend create failed, out of memory: " << identifier;
+            return;
+        }
+
+        if ( !createStorageStructure().HasValue() ) {
+            LAP_PER_LOG_WARN << "Failed to create KVS directory structure for: " << identifier;
+            return;
+        }
+
+        auto recovered = recover();
+        if ( !recovered.HasValue() ) {
+            LAP_PER_LOG_ERROR << "Kvs LSM backend recovery failed: " << m_dataPath;
+            return;
+        }
+
+        m_bAvailable = true;
+
+        try {
+            m_worker = ::std::thread( &KvsLsmBackend::workLoop, this );
+        } catch ( const ::std::system_error& e ) {
+            // schedule() then flushes and compacts on the syncing thread
+            LAP_PER_LOG_WARN << "Kvs LSM background thread start failed: " << e.what();
+        }
+
+        // A replayed WAL may already exceed the memtable budget, an interrupted compaction may be due
+        core::Bool rotated = false;
+        try {
+            core::WriteLockGuard lock( m_rwLock );
+            rotated = rotateIfFull();
+        } catch ( const ::std::bad_alloc& ) {
+            ;
+        }
+        core::UInt32 level = 0;
+        if ( rotated || pickCompaction( *m_pVersion, level ) ) schedule();
+
+        LAP_PER_LOG_INFO << "Kvs LSM backend initialized: " << m_dataPath;
+    }
+
+    KvsLsmBackend::~KvsLsmBackend() noexcept
+    {
+        if ( m_bAvailable ) {
+            core::Bool dirty = false;
+            {
+                core::ReadLockGuard lock( m_rwLock );
+                dirty = !m_pPending->empty();
+            }
+            if ( dirty && !SyncToStorage().HasValue() ) {
+                LAP_PER_LOG_WARN << "KvsLsmBackend::~KvsLsmBackend auto-sync failed";
+            }
+        }
+
+        if ( m_worker.joinable() ) {
+            {
+                core::LockGuard< core::Mutex > lock( m_workMutex );
+                m_stop = true;
+            }
+            m_workCv.notify_all();
+            m_idleCv.notify_all();
+            m_worker.join();
+        }
+    }
+
+    core::Result< void > KvsLsmBackend::createStorageStructure() noexcept
+    {
+        // Same layout as the File backend, the LSM files live in current/
+        static const char* const s_subdirs[] = { "current", "update", "redundancy", "recovery" };
+        for ( const auto* subdir : s_subdirs ) {
+            auto result = m_pVfs->CreateDirectory( core::Path::appendString( m_instancePath, subdir ) );
+            if ( !result.HasValue() ) return result;
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::String KvsLsmBackend::dataPath( core::StringView name ) const
+    {
+        return core::Path::appendString( m_dataPath, core::String( name.data(), name.size() ) );
+    }
+
+    core::String KvsLsmBackend::walPath( core::UInt64 segment ) const
+    {
+        return dataPath( "wal_" + ::std::to_string( segment ) + ".log" );
+    }
+
+    core::String KvsLsmBackend::runPath( core::UInt64 id ) const
+    {
+        return dataPath( "run_" + ::std::to_string( id ) + ".sst" );
+    }
+
+    // ==================== Recovery ====================
+
+    core::Result< void > KvsLsmBackend::recover() noexcept
+    {
+        using result = core::Result< void >;
+
+        try {
+            auto version = ::std::make_shared< Version >();
+            core::UInt64 walFirst   = 0;
+            core::UInt64 nextRunId  = 1;
+            core::Vector< core::UInt64 > liveRuns;
+
+            const core::String manifestPath = dataPath( MANIFEST_NAME );
+            if ( m_pVfs->Exists( manifestPath ) ) {
+                auto text = m_pVfs->ReadFile( manifestPath );
+                if ( !text.HasValue() ) return result::FromError( text.Error() );
+
+                ::std::istringstream in( core::String( text.Value().begin(), text.Value().end() ) );
+                core::String tag;
+                core::UInt32 format = 0;
+                if ( !( in >> tag >> format ) || tag != "lsm" || format != MANIFEST_FORMAT ) {
+                    LAP_PER_LOG_ERROR << "Kvs LSM manifest is not readable: " << manifestPath;
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+
+                while ( in >> tag ) {
+                    if ( tag == "wal" ) {
+                        in >> walFirst;
+                    } else if ( tag == "next" ) {
+                        in >> nextRunId;
+                    } else if ( tag == "run" ) {
+                        core::UInt32 level = 0;
+                        core::UInt64 id = 0;
+                        if ( !( in >> level >> id ) || level >= MAX_LEVELS ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+                        auto run = openRun( id );
+                        if ( !run.HasValue() ) {
+                            LAP_PER_LOG_ERROR << "Kvs LSM run is missing or corrupted: " << runPath( id );
+                            return result::FromError( run.Error() );
+                        }
+                        version->levels[level].push_back( ::std::move( run.Value() ) );
+                        liveRuns.push_back( id );
+                    } else {
+                        return result::FromError( PerErrc::kIntegrityCorrupted );
+                    }
+                    if ( !in ) return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+            }
+
+            for ( core::UInt32 level = 1; level < MAX_LEVELS; ++level ) {
+                ::std::sort( version->levels[level].begin(), version->levels[level].end(),
+                             []( const RunHandle& left, const RunHandle& right ) { return left->smallest < right->smallest; } );
+            }
+
+            // Runs of an interrupted flush or compaction, WAL segments already stored in runs
+            core::Vector< core::UInt64 > segments;
+            for ( const auto& name : m_pVfs->ListFiles( m_dataPath ) ) {
+                core::UInt64 number = 0;
+                if ( parseFileName( name, "run_", ".sst", number ) ) {
+                    nextRunId = ::std::max( nextRunId, number + 1 );
+                    if ( ::std::find( liveRuns.begin(), liveRuns.end(), number ) == liveRuns.end() ) {
+                        LAP_PER_LOG_INFO << "Kvs LSM removing orphaned run: " << name;
+                        m_pVfs->RemoveFile( dataPath( name ) );
+                    }
+                } else if ( parseFileName( name, "wal_", ".log", number ) ) {
+                    if ( number < walFirst ) {
+                        m_pVfs->RemoveFile( dataPath( name ) );
+                    } else {
+                        segments.push_back( number );
+                    }
+                } else if ( name == MANIFEST_TMP_NAME ) {
+                    m_pVfs->RemoveFile( dataPath( name ) );
+                }
+            }
+            ::std::sort( segments.begin(), segments.end() );
+
+            auto table = ::std::make_shared< MemTable >();
+            core::Size bytes = 0;
+            for ( auto segment : segments ) {
+                auto replayed = replayWal( segment, *table, bytes );
+                if ( !replayed.HasValue() ) return replayed;
+            }
+
+            m_pPending      = ::std::make_shared< MemTable >();
+            m_pMemtable     = ::std::move( table );
+            m_pVersion      = ::std::move( version );
+            m_memtableBytes = bytes;
+            m_memtableWal   = walFirst;
+            m_manifestWal   = walFirst;
+            // Never append behind a tail that may be torn
+            m_walSegment    = segments.empty() ? walFirst : segments.back() + 1;
+            m_nextRunId     = nextRunId;
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::replayWal( core::UInt64 segment, MemTable& table, core::Size& bytes ) noexcept
+    {
+        using result = core::Result< void >;
+
+        const core::String path = walPath( segment );
+        auto content = m_pVfs->ReadFile( path );
+        if ( !content.HasValue() ) return result::FromError( content.Error() );
+
+        const core::UInt8* data = content.Value().data();
+        const core::Size size   = content.Value().size();
+        core::Size pos          = 0;
+
+        try {
+            while ( size - pos >= WAL_HEADER_SIZE ) {
+                const core::Size batchSize  = load< core::UInt32 >( data + pos );
+                const core::UInt32 crc      = load< core::UInt32 >( data + pos + 4 );
+                if ( size - pos - WAL_HEADER_SIZE < batchSize || crc32( data + pos + WAL_HEADER_SIZE, batchSize ) != crc ) break;
+
+                const core::UInt8* batch = data + pos + WAL_HEADER_SIZE;
+                for ( core::Size offset = 0; offset < batchSize; ) {
+                    EntryView entry;
+                    Record record;
+                    if ( !parseEntry( batch + offset, batchSize - offset, entry ) || !decodeEntry( entry, record ) ) {
+                        LAP_PER_LOG_ERROR << "Kvs LSM WAL batch does not decode: " << path;
+                        return result::FromError( PerErrc::kIntegrityCorrupted );
+                    }
+                    mergeInto( table, entry.key, ::std::move( record ), bytes );
+                    offset += entry.size;
+                }
+                pos += WAL_HEADER_SIZE + batchSize;
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        if ( pos != size ) {
+            // The sync writing this batch never returned, so the batch was never acknowledged
+            LAP_PER_LOG_WARN << "Kvs LSM dropped torn WAL tail: " << path << " (" << ( size - pos ) << " bytes)";
+        }
+        return result::FromValue();
+    }
+
+    // ==================== Run files ====================
+
+    core::Result< KvsLsmBackend::RunHandle > KvsLsmBackend::openRun( core::UInt64 id ) const noexcept
+    {
+        using result = core::Result< RunHandle >;
+
+        try {
+            auto run    = ::std::make_shared< Run >();
+            run->vfs    = m_pVfs;
+            run->path   = runPath( id );
+            run->id     = id;
+
+            auto fileSize = m_pVfs->GetFileSize( run->path );
+            if ( !fileSize.HasValue() ) return result::FromError( fileSize.Error() );
+            if ( fileSize.Value() < FOOTER_SIZE ) return result::FromError( PerErrc::kIntegrityCorrupted );
+            const core::UInt64 metaEnd = fileSize.Value() - FOOTER_SIZE;
+
+            auto footer = m_pVfs->ReadFileRange( run->path, metaEnd, FOOTER_SIZE );
+            if ( !footer.HasValue() ) return result::FromError( footer.Error() );
+
+            const core::UInt8* tail             = footer.Value().data();
+            const core::UInt64 indexOffset      = load< core::UInt64 >( tail );
+            const core::UInt64 bloomOffset      = load< core::UInt64 >( tail + 8 );
+            const core::UInt64 entries          = load< core::UInt64 >( tail + 16 );
+            const core::UInt32 metaCrc          = load< core::UInt32 >( tail + 24 );
+            if ( load< core::UInt32 >( tail + 28 ) != RUN_MAGIC || indexOffset > bloomOffset || bloomOffset > metaEnd ) {
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+
+            auto meta = m_pVfs->ReadFileRange( run->path, indexOffset, metaEnd - indexOffset );
+            if ( !meta.HasValue() ) return result::FromError( meta.Error() );
+            if ( crc32( meta.Value().data(), meta.Value().size() ) != metaCrc ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+            Reader reader{ meta.Value().data(), meta.Value().data() + ( bloomOffset - indexOffset ) };
+            core::UInt32 blocks = 0;
+            if ( !reader.read( run->largest ) || !reader.read( blocks ) || blocks == 0 ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+            run->indexKeys.resize( blocks );
+            run->indexOffsets.resize( blocks );
+            run->indexCrcs.resize( blocks );
+            for ( core::UInt32 i = 0; i < blocks; ++i ) {
+                if ( !reader.read( run->indexKeys[i] ) || !reader.read( run->indexOffsets[i] ) || !reader.read( run->indexCrcs[i] ) ) {
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+            }
+            if ( reader.pos != reader.end || run->indexOffsets[0] != 0 ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+            if ( !run->bloom.Load( reader.end, meta.Value().size() - ( bloomOffset - indexOffset ), entries ) ) {
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+
+            run->smallest   = run->indexKeys[0];
+            run->fileSize   = fileSize.Value();
+            run->dataSize   = indexOffset;
+            run->entries    = entries;
+            return result::FromValue( ::std::move( run ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< KvsLsmBackend::RunHandle > KvsLsmBackend::writeRun( const core::Vector< core::UInt8 >& file ) noexcept
+    {
+        const core::UInt64 id = m_nextRunId++;
+
+        auto written = m_pVfs->WriteFile( runPath( id ), file.data(), file.size() );
+        if ( !written.HasValue() ) return core::Result< RunHandle >::FromError( written.Error() );
+
+        auto run = openRun( id );
+        if ( !run.HasValue() ) m_pVfs->RemoveFile( runPath( id ) );
+        return run;
+    }
+
+    core::Result< void > KvsLsmBackend::writeManifest( const Version& version, core::UInt64 walSegment ) noexcept
+    {
+        using result = core::Result< void >;
+
+        core::String text;
+        try {
+            ::std::ostringstream out;
+            out << "lsm " << MANIFEST_FORMAT << "\n";
+            out << "wal " << walSegment << "\n";
+            out << "next " << m_nextRunId << "\n";
+            for ( core::UInt32 level = 0; level < MAX_LEVELS; ++level ) {
+                for ( const auto& run : version.levels[level] ) out << "run " << level << " " << run->id << "\n";
+            }
+            text = out.str();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        // Replace atomically, a crash leaves either the old or the new run set
+        const core::String tmpPath = dataPath( MANIFEST_TMP_NAME );
+        auto written = m_pVfs->WriteFile( tmpPath, reinterpret_cast< const core::UInt8* >( text.data() ), text.size() );
+        if ( !written.HasValue() ) return written;
+
+        return m_pVfs->RenameFile( tmpPath, dataPath( MANIFEST_NAME ) );
+    }
+
+    void KvsLsmBackend::removeWalBefore( core::UInt64 segment ) noexcept
+    {
+        for ( const auto& name : m_pVfs->ListFiles( m_dataPath ) ) {
+            core::UInt64 number = 0;
+            if ( parseFileName( name, "wal_", ".log", number ) && number < segment ) m_pVfs->RemoveFile( dataPath( name ) );
+        }
+    }
+
+    // ==================== Read path ====================
+
+    KvsLsmBackend::Lookup KvsLsmBackend::findInTable( const MemTable* table, core::StringView key, KvsDataType* out )
+    {
+        if ( nullptr == table ) return Lookup::kMissing;
+
+        auto it = table->find( key );
+        if ( it == table->end() ) return Lookup::kMissing;
+        if ( it->second.deleted ) return Lookup::kDeleted;
+
+        if ( nullptr != out ) *out = it->second.value;
+        return Lookup::kFound;
+    }
+
+    core::Result< KvsLsmBackend::Lookup > KvsLsmBackend::findInRun( const Run& run, core::StringView key, core::UInt64 hash, KvsDataType* out ) noexcept
+    {
+        using result = core::Result< Lookup >;
+
+        if ( key < KeyLess::view( run.smallest ) || KeyLess::view( run.largest ) < key || !run.bloom.MayContain( hash ) ) {
+            return result::FromValue( Lookup::kMissing );
+        }
+
+        // Last block starting at or before the key; key >= smallest, so there is one
+        const core::Size block  = static_cast< core::Size >( ::std::upper_bound( run.indexKeys.begin(), run.indexKeys.end(), key, KeyLess{} ) - run.indexKeys.begin() ) - 1;
+        const core::UInt64 begin = run.indexOffsets[block];
+
+        auto bytes = run.vfs->ReadFileRange( run.path, begin, run.blockEnd( block ) - begin );
+        if ( !bytes.HasValue() ) return result::FromError( bytes.Error() );
+
+        const core::UInt8* data = bytes.Value().data();
+        const core::Size size   = bytes.Value().size();
+        if ( crc32( data, size ) != run.indexCrcs[block] ) {
+            LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs LSM run block checksum mismatch: " << run.path;
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+
+        try {
+            EntryView entry;
+            for ( core::Size pos = 0; pos < size && parseEntry( data + pos, size - pos, entry ); pos += entry.size ) {
+                const int order = entry.key.compare( key );
+                if ( order > 0 ) break;
+                if ( order < 0 ) continue;
+
+                if ( entry.deleted ) return result::FromValue( Lookup::kDeleted );
+                if ( nullptr != out && !valueFrom( entry.type, entry.value, entry.valueSize, *out ) ) {
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                return result::FromValue( Lookup::kFound );
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( Lookup::kMissing );
+    }
+
+    core::Result< KvsLsmBackend::Lookup > KvsLsmBackend::findInVersion( const Version& version, core::StringView key, core::UInt64 hash, KvsDataType* out ) noexcept
+    {
+        // Level-0 runs may overlap, newest first
+        for ( const auto& run : version.levels[0] ) {
+            auto state = findInRun( *run, key, hash, out );
+            if ( !state.HasValue() || state.Value() != Lookup::kMissing ) return state;
+        }
+
+        // Deeper levels are key-disjoint: at most one candidate run each
+        for ( core::UInt32 level = 1; level < MAX_LEVELS; ++level ) {
+            const auto& runs = version.levels[level];
+            auto it = ::std::lower_bound( runs.begin(), runs.end(), key,
+                                          []( const RunHandle& run, core::StringView k ) { return KeyLess::view( run->largest ) < k; } );
+            if ( it == runs.end() ) continue;
+
+            auto state = findInRun( **it, key, hash, out );
+            if ( !state.HasValue() || state.Value() != Lookup::kMissing ) return state;
+        }
+
+        return core::Result< Lookup >::FromValue( Lookup::kMissing );
+    }
+
+    core::Result< core::Vector< core::String > > KvsLsmBackend::collectKeys( const Tables& tables ) noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        try {
+            // Newest source first: the first occurrence of a key decides whether it is live
+            ::std::map< core::String, core::Bool, KeyLess > seen;
+            for ( const auto& table : tables.layers ) {
+                if ( !table ) continue;
+                for ( const auto& item : *table ) seen.emplace( item.first, !item.second.deleted );
+            }
+
+            for ( core::UInt32 level = 0; level < MAX_LEVELS; ++level ) {
+                for ( const auto& run : tables.version->levels[level] ) {
+                    auto bytes = run->vfs->ReadFileRange( run->path, 0, run->dataSize );
+                    if ( !bytes.HasValue() ) return result::FromError( bytes.Error() );
+
+                    const core::UInt8* data = bytes.Value().data();
+                    for ( core::Size block = 0; block < run->indexOffsets.size(); ++block ) {
+                        const core::UInt64 begin    = run->indexOffsets[block];
+                        const core::UInt64 end      = run->blockEnd( block );
+                        if ( end > run->dataSize || crc32( data + begin, end - begin ) != run->indexCrcs[block] ) {
+                            return result::FromError( PerErrc::kIntegrityCorrupted );
+                        }
+
+                        EntryView entry;
+                        for ( core::UInt64 pos = begin; pos < end; pos += entry.size ) {
+                            if ( !parseEntry( data + pos, end - pos, entry ) ) return result::FromError( PerErrc::kIntegrityCorrupted );
+                            seen.emplace( core::String( entry.key.data(), entry.key.size() ), !entry.deleted );
+                        }
+                    }
+                }
+            }
+
+            core::Vector< core::String > keys;
+            for ( auto& item : seen ) {
+                if ( item.second ) keys.push_back( item.first );
+            }
+            return result::FromValue( ::std::move( keys ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    KvsLsmBackend::Lookup KvsLsmBackend::findInMemory( core::StringView key, KvsDataType* out ) const
+    {
+        for ( const MemTable* table : { m_pPending.get(), m_pSyncing.get(), m_pMemtable.get(), m_pImmutable.get() } ) {
+            Lookup state = findInTable( table, key, out );
+            if ( state != Lookup::kMissing ) return state;
+        }
+        return Lookup::kMissing;
+    }
+
+    core::Result< KvsLsmBackend::Lookup > KvsLsmBackend::find( core::StringView key, core::UInt64 hash, KvsDataType* out ) const noexcept
+    {
+        core::SharedHandle< const Version > version;
+        try {
+            core::ReadLockGuard lock( m_rwLock );
+            Lookup state = findInMemory( key, out );
+            if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+            version = m_pVersion;
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        // Runs never change, read them without the lock
+        return findInVersion( *version, key, hash, out );
+    }
+
+    core::Result< KvsLsmBackend::Lookup > KvsLsmBackend::findLocked( core::StringView key, KvsDataType* out ) const noexcept
+    {
+        try {
+            Lookup state = findInMemory( key, out );
+            if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return findInVersion( *m_pVersion, key, kvsKeyHash( key ), out );
+    }
+
+    KvsLsmBackend::Tables KvsLsmBackend::pinTables() const
+    {
+        Tables tables;
+        tables.layers[0]    = m_pPending;
+        tables.layers[1]    = m_pSyncing;
+        tables.layers[2]    = m_pMemtable;
+        tables.layers[3]    = m_pImmutable;
+        tables.version      = m_pVersion;
+        return tables;
+    }
+
+    core::Result< core::Vector< core::String > > KvsLsmBackend::GetAllKeys() const noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        Tables tables;
+        {
+            core::ReadLockGuard lock( m_rwLock );
+            tables = pinTables();
+        }
+        return collectKeys( tables );
+    }
+
+    core::Result< core::UInt32 > KvsLsmBackend::GetKeyCount() const noexcept
+    {
+        auto keys = GetAllKeys();
+        if ( !keys.HasValue() ) return core::Result< core::UInt32 >::FromError( keys.Error() );
+        return core::Result< core::UInt32 >::FromValue( static_cast< core::UInt32 >( keys.Value().size() ) );
+    }
+
+    core::Result< core::Bool > KvsLsmBackend::KeyExists( core::StringView key ) const noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto state = find( key, kvsKeyHash( key ), nullptr );
+        if ( !state.HasValue() ) return result::FromError( state.Error() );
+        return result::FromValue( state.Value() == Lookup::kFound );
+    }
+
+    core::Result< KvsDataType > KvsLsmBackend::GetValue( core::StringView key ) const noexcept
+    {
+        return GetValueHashed( key, kvsKeyHash( key ) );
+    }
+
+    core::Result< KvsDataType > KvsLsmBackend::GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType value;
+        auto state = find( key, hash, &value );
+        if ( !state.HasValue() ) return result::FromError( state.Error() );
+        if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+
+        return result::FromValue( ::std::move( value ) );
+    }
+
+    core::Result< core::Size > KvsLsmBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept
+    {
+        using result = core::Result< core::Size >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType value;
+        auto state = find( key, kvsKeyHash( key ), &value );
+        if ( !state.HasValue() ) return result::FromError( state.Error() );
+        if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+
+        const core::Byte* data = nullptr;
+        core::Size size = 0;
+        if ( !isKvsRawType( type ) || ::lap::core::GetVariantIndex( value ) != static_cast< core::Size >( type ) || !kvsRawBytes( value, data, size ) ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        if ( size > buffer.size() ) return result::FromError( PerErrc::kWrongDataSize );
+
+        if ( size > 0 ) ::std::memcpy( buffer.data(), data, size );
+        return result::FromValue( size );
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsLsmBackend::CreateSnapshot() const noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        try {
+            core::ReadLockGuard lock( m_rwLock );  // Pins handles only, no copy
+            return result::FromValue( ::std::make_shared< Snapshot >( pinTables() ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::UInt64 > KvsLsmBackend::GetSize() const noexcept
+    {
+        using result = core::Result< core::UInt64 >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::UInt64 total = 0;
+        for ( const auto& name : m_pVfs->ListFiles( m_dataPath ) ) {
+            auto size = m_pVfs->GetFileSize( dataPath( name ) );
+            if ( size.HasValue() ) total += size.Value();
+        }
+        return result::FromValue( total );
+    }
+
+    // ==================== Write path ====================
+
+    KvsLsmBackend::MemTable& KvsLsmBackend::pending()
+    {
+        if ( m_pPending.use_count() > 1 ) m_pPending = ::std::make_shared< MemTable >( *m_pPending );
+        return *m_pPending;
+    }
+
+    KvsLsmBackend::MemTable& KvsLsmBackend::memtable()
+    {
+        if ( m_pMemtable.use_count() > 1 ) m_pMemtable = ::std::make_shared< MemTable >( *m_pMemtable );
+        return *m_pMemtable;
+    }
+
+    void KvsLsmBackend::put( core::StringView key, Record&& record )
+    {
+        MemTable& table = pending();
+
+        auto it = table.find( key );
+        if ( it == table.end() ) {
+            table.emplace( core::String( key.data(), key.size() ), ::std::move( record ) );
+        } else {
+            it->second = ::std::move( record );
+        }
+    }
+
+    core::Result< void > KvsLsmBackend::SetValue( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        try {
+            put( key, Record{ false, value } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::SetValue( core::StringView key, KvsDataType &&value ) noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        try {
+            put( key, Record{ false, ::std::move( value ) } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::RemoveKey( core::StringView key ) noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        try {
+            put( key, Record{ true, KvsDataType() } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::RecoverKey( core::StringView key ) noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+
+        auto it = m_pPending->find( key );
+        if ( it == m_pPending->end() || !it->second.deleted ) return result::FromError( PerErrc::kKeyNotFound );
+
+        try {
+            MemTable& table = pending();
+            table.erase( table.find( key ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::ResetKey( core::StringView key ) noexcept
+    {
+        return RemoveKey( key );
+    }
+
+    core::Result< void > KvsLsmBackend::RemoveAllKeys() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+
+        // One tombstone per live key keeps the removal revocable by DiscardPendingChanges()
+        core::Result< core::Vector< core::String > > keys = collectKeys( pinTables() );
+        if ( !keys.HasValue() ) return result::FromError( keys.Error() );
+
+        try {
+            for ( const auto& key : keys.Value() ) put( key, Record{ true, KvsDataType() } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    // ==================== Atomic Read-Modify-Write ====================
+
+    core::Result< KvsDataType > KvsLsmBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType previous;
+        if ( !kvsZeroValue( delta, previous ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            KvsDataType current;
+            auto state = findLocked( key, &current );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() == Lookup::kFound ) previous = ::std::move( current );
+
+            KvsDataType sum;
+            if ( !kvsAddValues( previous, delta, sum ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+            put( key, Record{ false, ::std::move( sum ) } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( ::std::move( previous ) );
+    }
+
+    core::Result< core::Bool > KvsLsmBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            KvsDataType current;
+            auto state = findLocked( key, &current );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+            if ( !( current == expected ) ) return result::FromValue( false );
+
+            put( key, Record{ false, desired } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::Bool > KvsLsmBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            auto state = findLocked( key, nullptr );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() == Lookup::kFound ) return result::FromValue( false );
+
+            put( key, Record{ false, value } );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( true );
+    }
+
+    // ==================== Sync ====================
+
+    core::Bool KvsLsmBackend::rotateIfFull()
+    {
+        if ( m_memtableBytes < m_options.memtableBytes ) return false;
+
+        if ( m_pImmutable ) {
+            // Flush still running: keep filling the memtable rather than blocking the writer
+            core::LockGuard< core::Mutex > lock( m_statsMutex );
+            ++m_stats.stalls;
+            return false;
+        }
+
+        auto fresh      = ::std::make_shared< MemTable >();
+        m_pImmutable    = ::std::move( m_pMemtable );
+        m_pMemtable     = ::std::move( fresh );
+        m_memtableBytes = 0;
+        m_memtableWal   = ++m_walSegment;
+        return true;
+    }
+
+    core::Result< void > KvsLsmBackend::SyncToStorage() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::LockGuard< core::Mutex > syncLock( m_syncMutex );  // One batch in flight, WAL batches stay in order
+
+        core::String path;
+        try {
+            core::WriteLockGuard lock( m_rwLock );
+            if ( m_pPending->empty() ) return result::FromValue();  // No changes to sync
+
+            auto fresh  = ::std::make_shared< MemTable >();
+            path        = walPath( m_walSegment );
+            m_pSyncing  = ::std::move( m_pPending );
+            m_pPending  = ::std::move( fresh );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        // m_pSyncing no longer changes: encode and log it while readers and writers go on
+        core::Result< void > logged = result::FromValue();
+        try {
+            m_walBuffer.assign( WAL_HEADER_SIZE, 0 );
+            for ( const auto& item : *m_pSyncing ) appendEntry( m_walBuffer, item.first, item.second );
+
+            const core::UInt32 batchSize    = static_cast< core::UInt32 >( m_walBuffer.size() - WAL_HEADER_SIZE );
+            const core::UInt32 crc          = crc32( m_walBuffer.data() + WAL_HEADER_SIZE, batchSize );
+            ::std::memcpy( m_walBuffer.data(), &batchSize, sizeof( batchSize ) );
+            ::std::memcpy( m_walBuffer.data() + 4, &crc, sizeof( crc ) );
+
+            logged = m_pVfs->AppendFile( path, m_walBuffer.data(), m_walBuffer.size() );
+        } catch ( const ::std::bad_alloc& ) {
+            logged = result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        core::Bool rotated = false;
+        try {
+            core::WriteLockGuard lock( m_rwLock );
+
+            if ( !logged.HasValue() ) {
+                // Keep the batch pending; changes made meanwhile are newer and win
+                MemTable& table = pending();
+                for ( const auto& item : *m_pSyncing ) table.emplace( item.first, item.second );
+                m_pSyncing.reset();
+                // A failed append may have left a torn batch, later batches go to a fresh segment
+                ++m_walSegment;
+                LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs LSM WAL append failed: " << path;
+                return logged;
+            }
+
+            MemTable& table = memtable();
+            const core::Bool owned = m_pSyncing.use_count() == 1;
+            for ( auto& item : *m_pSyncing ) {
+                if ( owned ) {
+                    mergeInto( table, item.first, ::std::move( item.second ), m_memtableBytes );
+                } else {
+                    mergeInto( table, item.first, Record( item.second ), m_memtableBytes );
+                }
+            }
+            m_pSyncing.reset();
+
+            rotated = rotateIfFull();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        {
+            core::LockGuard< core::Mutex > lock( m_statsMutex );
+            m_stats.walBytes += m_walBuffer.size();
+        }
+
+        if ( rotated ) schedule();
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsLsmBackend::DiscardPendingChanges() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromValue();
+
+        core::LockGuard< core::Mutex > syncLock( m_syncMutex );
+        core::WriteLockGuard lock( m_rwLock );
+
+        try {
+            if ( m_pPending.use_count() > 1 ) {
+                m_pPending = ::std::make_shared< MemTable >();
+            } else {
+                m_pPending->clear();
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue();
+    }
+
+    // ==================== Background flush and compaction ====================
+
+    void KvsLsmBackend::schedule() noexcept
+    {
+        if ( !m_worker.joinable() ) {
+            doBackgroundWork();
+            return;
+        }
+
+        {
+            core::LockGuard< core::Mutex > lock( m_workMutex );
+            m_workQueued = true;
+        }
+        m_workCv.notify_one();
+    }
+
+    void KvsLsmBackend::WaitForBackgroundWork() noexcept
+    {
+        if ( !m_worker.joinable() ) return;
+
+        ::std::unique_lock< core::Mutex > lock( m_workMutex );
+        m_idleCv.wait( lock, [this]() { return m_stop || ( !m_workQueued && !m_workRunning ); } );
+    }
+
+    void KvsLsmBackend::workLoop() noexcept
+    {
+        for ( ;; ) {
+            {
+                ::std::unique_lock< core::Mutex > lock( m_workMutex );
+                m_workCv.wait( lock, [this]() { return m_stop || m_workQueued; } );
+                if ( m_stop ) break;
+
+                m_workQueued    = false;
+                m_workRunning   = true;
+            }
+
+            doBackgroundWork();
+
+            {
+                core::LockGuard< core::Mutex > lock( m_workMutex );
+                m_workRunning = false;
+            }
+            m_idleCv.notify_all();
+        }
+    }
+
+    void KvsLsmBackend::doBackgroundWork() noexcept
+    {
+        core::LockGuard< core::Mutex > lock( m_compactionMutex );
+
+        auto flushed = flushImmutable();
+        if ( !flushed.HasValue() ) {
+            LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs LSM memtable flush failed: " << m_dataPath;
+            return;
+        }
+
+        // Only this function replaces m_pVersion, reading it here needs no lock
+        core::UInt32 level = 0;
+        while ( pickCompaction( *m_pVersion, level ) ) {
+            {
+                core::LockGuard< core::Mutex > workLock( m_workMutex );
+                if ( m_stop ) return;
+            }
+            if ( !compact( level ).HasValue() ) {
+                LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs LSM compaction of level " << level << " failed: " << m_dataPath;
+                return;
+            }
+        }
+    }
+
+    core::Result< void > KvsLsmBackend::flushImmutable() noexcept
+    {
+        using result = core::Result< void >;
+
+        core::SharedHandle< const MemTable > table;
+        core::UInt64 walSegment = 0;
+        {
+            core::ReadLockGuard lock( m_rwLock );
+            table       = m_pImmutable;
+            walSegment  = m_memtableWal;    // Stable while an immutable memtable exists
+        }
+        if ( !table ) return result::FromValue();
+
+        RunHandle run;
+        core::UInt64 written = 0;
+        core::SharedHandle< Version > version;
+        try {
+            version = ::std::make_shared< Version >( *m_pVersion );
+
+            if ( !table->empty() ) {
+                RunBuilder builder( m_options.indexInterval );
+                for ( const auto& item : *table ) {
+                    builder.Add( item.first, [&item]( core::Vector< core::UInt8 >& out ) { appendEntry( out, item.first, item.second ); } );
+                }
+                auto file = builder.Finish();
+
+                auto created = writeRun( file );
+                if ( !created.HasValue() ) return result::FromError( created.Error() );
+
+                run     = ::std::move( created.Value() );
+                written = file.size();
+                version->levels[0].insert( version->levels[0].begin(), run );
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            if ( run ) run->obsolete = true;
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        auto manifest = writeManifest( *version, walSegment );
+        if ( !manifest.HasValue() ) {
+            if ( run ) run->obsolete = true;
+            return manifest;
+        }
+
+        {
+            core::WriteLockGuard lock( m_rwLock );
+            m_pVersion = ::std::move( version );
+            m_pImmutable.reset();
+        }
+        m_manifestWal = walSegment;
+        removeWalBefore( walSegment );
+
+        core::LockGuard< core::Mutex > lock( m_statsMutex );
+        ++m_stats.flushes;
+        m_stats.flushBytes += written;
+        return result::FromValue();
+    }
+
+    core::UInt64 KvsLsmBackend::levelBudget( core::UInt32 level ) const noexcept
+    {
+        core::UInt64 budget = ::std::max( m_options.level1Bytes, core::UInt64( 1 ) );
+        const core::UInt64 ratio = ::std::max( m_options.levelSizeRatio, core::UInt32( 2 ) );
+        for ( core::UInt32 i = 1; i < level && budget < ( UINT64_MAX / ratio ); ++i ) budget *= ratio;
+        return budget;
+    }
+
+    core::Bool KvsLsmBackend::pickCompaction( const Version& version, core::UInt32& level ) const noexcept
+    {
+        if ( !version.levels[0].empty() && version.levels[0].size() >= m_options.level0Runs ) {
+            level = 0;
+            return true;
+        }
+
+        // The last level has no budget, it takes whatever is pushed down
+        for ( core::UInt32 i = 1; i + 1 < MAX_LEVELS; ++i ) {
+            core::UInt64 bytes = 0;
+            for ( const auto& run : version.levels[i] ) bytes += run->fileSize;
+            if ( bytes > levelBudget( i ) ) {
+                level = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    core::Result< void > KvsLsmBackend::compact( core::UInt32 level ) noexcept
+    {
+        using result = core::Result< void >;
+
+        const core::SharedHandle< const Version > current = m_pVersion;
+        const core::UInt32 target = level + 1;
+
+        core::Vector< RunHandle > outputs;
+        core::UInt64 written = 0;
+        auto discardOutputs = [&outputs]() {
+            for ( auto& run : outputs ) run->obsolete = true;
+        };
+
+        try {
+            // Inputs ordered newest first: the first occurrence of a key wins the merge
+            core::Vector< RunHandle > inputs;
+            if ( level == 0 ) {
+                inputs = current->levels[0];
+            } else {
+                // Round-robin over the key space, so every run of the level is pushed down in turn
+                const auto& runs    = current->levels[level];
+                auto& cursor        = m_compactCursor[level];
+                auto it = ::std::find_if( runs.begin(), runs.end(), [&cursor]( const RunHandle& run ) { return cursor < run->smallest; } );
+                if ( it == runs.end() ) it = runs.begin();
+                inputs.push_back( *it );
+                cursor = ( *it )->largest;
+            }
+            const core::Size upperCount = inputs.size();
+
+            core::String smallest = inputs.front()->smallest;
+            core::String largest  = inputs.front()->largest;
+            for ( const auto& run : inputs ) {
+                smallest    = ::std::min( smallest, run->smallest );
+                largest     = ::std::max( largest, run->largest );
+            }
+            for ( const auto& run : current->levels[target] ) {
+                if ( !( run->largest < smallest || largest < run->smallest ) ) inputs.push_back( run );
+            }
+
+            // Tombstones only shadow older data below the target level
+            core::Bool bottom = true;
+            for ( core::UInt32 i = target + 1; i < MAX_LEVELS; ++i ) bottom = bottom && current->levels[i].empty();
+
+            if ( upperCount == 1 && inputs.size() == 1 ) {
+                // Nothing to merge with: move the run down without rewriting it
+                outputs.push_back( inputs.front() );
+            } else {
+                core::Vector< core::Vector< core::UInt8 > > buffers( inputs.size() );
+                for ( core::Size i = 0; i < inputs.size(); ++i ) {
+                    auto bytes = m_pVfs->ReadFileRange( inputs[i]->path, 0, inputs[i]->dataSize );
+                    if ( !bytes.HasValue() ) return result::FromError( bytes.Error() );
+                    buffers[i] = ::std::move( bytes.Value() );
+
+                    for ( core::Size block = 0; block < inputs[i]->indexOffsets.size(); ++block ) {
+                        const core::UInt64 begin = inputs[i]->indexOffsets[block];
+                        if ( crc32( buffers[i].data() + begin, inputs[i]->blockEnd( block ) - begin ) != inputs[i]->indexCrcs[block] ) {
+                            LAP_PER_LOG_ERROR << "Kvs LSM run block checksum mismatch: " << inputs[i]->path;
+                            return result::FromError( PerErrc::kIntegrityCorrupted );
+                        }
+                    }
+                }
+
+                struct Cursor
+                {
+                    core::Size  input;
+                    core::Size  pos;
+                    EntryView   entry;
+                };
+                auto later = []( const Cursor& left, const Cursor& right ) {
+                    const int order = left.entry.key.compare( right.entry.key );
+                    return order != 0 ? order > 0 : left.input > right.input;
+                };
+                ::std::priority_queue< Cursor, core::Vector< Cursor >, decltype( later ) > heap( later );
+
+                auto advance = [&buffers, &heap]( Cursor cursor ) -> core::Bool {
+                    const auto& buffer = buffers[cursor.input];
+                    if ( cursor.pos >= buffer.size() ) return true;
+                    if ( !parseEntry( buffer.data() + cursor.pos, buffer.size() - cursor.pos, cursor.entry ) ) return false;
+                    heap.push( cursor );
+                    return true;
+                };
+                for ( core::Size i = 0; i < inputs.size(); ++i ) {
+                    if ( !advance( Cursor{ i, 0, EntryView() } ) ) return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+
+                RunBuilder builder( m_options.indexInterval );
+                auto finishRun = [&]() -> core::Result< void > {
+                    if ( builder.Empty() ) return result::FromValue();
+                    auto file = builder.Finish();
+                    auto run = writeRun( file );
+                    if ( !run.HasValue() ) return result::FromError( run.Error() );
+                    outputs.push_back( ::std::move( run.Value() ) );
+                    written += file.size();
+                    return result::FromValue();
+                };
+
+                core::StringView lastKey;
+                core::Bool first = true;
+                while ( !heap.empty() ) {
+                    Cursor cursor = heap.top();
+                    heap.pop();
+
+                    if ( first || cursor.entry.key != lastKey ) {
+                        first   = false;
+                        lastKey = cursor.entry.key;
+
+                        if ( !( cursor.entry.deleted && bottom ) ) {
+                            if ( builder.DataSize() >= m_options.runBytes ) {
+                                auto finished = finishRun();
+                                if ( !finished.HasValue() ) {
+                                    discardOutputs();
+                                    return finished;
+                                }
+                            }
+                            const core::UInt8* bytes = buffers[cursor.input].data() + cursor.pos;
+                            const core::Size size = cursor.entry.size;
+                            builder.Add( cursor.entry.key, [bytes, size]( core::Vector< core::UInt8 >& out ) { out.insert( out.end(), bytes, bytes + size ); } );
+                        }
+                    }
+
+                    cursor.pos += cursor.entry.size;
+                    if ( !advance( cursor ) ) {
+                        discardOutputs();
+                        return result::FromError( PerErrc::kIntegrityCorrupted );
+                    }
+                }
+
+                auto finished = finishRun();
+                if ( !finished.HasValue() ) {
+                    discardOutputs();
+                    return finished;
+                }
+            }
+
+            auto next = ::std::make_shared< Version >( *current );
+            auto isInput = [&inputs]( const RunHandle& run ) { return ::std::find( inputs.begin(), inputs.end(), run ) != inputs.end(); };
+            for ( auto* runs : { &next->levels[level], &next->levels[target] } ) {
+                runs->erase( ::std::remove_if( runs->begin(), runs->end(), isInput ), runs->end() );
+            }
+            next->levels[target].insert( next->levels[target].end(), outputs.begin(), outputs.end() );
+            ::std::sort( next->levels[target].begin(), next->levels[target].end(),
+                         []( const RunHandle& left, const RunHandle& right ) { return left->smallest < right->smallest; } );
+
+            auto manifest = writeManifest( *next, m_manifestWal );
+            if ( !manifest.HasValue() ) {
+                if ( written > 0 ) discardOutputs();
+                return manifest;
+            }
+
+            {
+                core::WriteLockGuard lock( m_rwLock );
+                m_pVersion = ::std::move( next );
+            }
+
+            // Readers still holding the old version keep the files until they let go
+            for ( auto& run : inputs ) {
+                if ( ::std::find( outputs.begin(), outputs.end(), run ) == outputs.end() ) run->obsolete = true;
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            if ( written > 0 ) discardOutputs();
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        core::LockGuard< core::Mutex > lock( m_statsMutex );
+        ++m_stats.compactions;
+        m_stats.compactionBytes += written;
+        return result::FromValue();
+    }
+
+    KvsLsmStats KvsLsmBackend::GetStats() const noexcept
+    {
+        KvsLsmStats stats;
+        {
+            core::LockGuard< core::Mutex > lock( m_statsMutex );
+            stats.walBytes          = m_stats.walBytes;
+            stats.flushBytes        = m_stats.flushBytes;
+            stats.compactionBytes   = m_stats.compactionBytes;
+            stats.flushes           = m_stats.flushes;
+            stats.compactions       = m_stats.compactions;
+            stats.stalls            = m_stats.stalls;
+        }
+
+        core::ReadLockGuard lock( m_rwLock );
+        stats.memtableBytes = m_memtableBytes;
+        if ( m_pVersion ) {
+            try {
+                for ( core::UInt32 level = 0; level < MAX_LEVELS; ++level ) {
+                    stats.runsPerLevel.push_back( static_cast< core::UInt32 >( m_pVersion->levels[level].size() ) );
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                stats.runsPerLevel.clear();
+            }
+        }
+        return stats;
+    }
+
+} // namespace per
+} // namespace lap
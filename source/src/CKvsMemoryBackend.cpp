@@ -0,0 +1,188 @@
+/**
+ * @file CKvsMemoryBackend.cpp
+ * @brief Process-local in-memory KVS backend
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "CKvsMemoryBackend.hpp"
+
+namespace lap
+{
+namespace per
+{
+    core::Result< core::Vector< core::String > > KvsMemoryBackend::GetAllKeys() const noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        core::ReadLockGuard lock( m_rwLock );
+        try {
+            core::Vector< core::String > keys;
+            keys.reserve( m_values.size() );
+            for ( const auto& entry : m_values ) keys.push_back( entry.first );
+            return result::FromValue( ::std::move( keys ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    // ==================== Atomic Read-Modify-Write ====================
+
+    core::Result< KvsDataType > KvsMemoryBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        KvsDataType previous;
+        if ( !kvsZeroValue( delta, previous ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+        try {
+            auto it = m_values.lower_bound( mapKey( key ) );
+            const core::Bool found = it != m_values.end() && it->first == mapKey( key );
+            if ( found ) previous = it->second;
+
+            KvsDataType sum;
+            if ( !kvsAddValues( previous, delta, sum ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+            if ( found ) {
+                it->second = ::std::move( sum );
+            } else {
+                m_values.emplace_hint( it, core::String( key.data(), key.size() ), ::std::move( sum ) );
+            }
+            m_snapshots.Changed( key );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( ::std::move( previous ) );
+    }
+
+    core::Result< core::Bool > KvsMemoryBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+        auto it = m_values.find( mapKey( key ) );
+        if ( it == m_values.end() ) return result::FromError( PerErrc::kKeyNotFound );
+        if ( !( it->second == expected ) ) return result::FromValue( false );
+
+        try {
+            it->second = desired;
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_snapshots.Changed( key );
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::Bool > KvsMemoryBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+        try {
+            auto it = m_values.lower_bound( mapKey( key ) );
+            if ( it != m_values.end() && it->first == mapKey( key ) ) return result::FromValue( false );
+
+            m_values.emplace_hint( it, core::String( key.data(), key.size() ), value );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_snapshots.Changed( key );
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsMemoryBackend::CreateSnapshot() const noexcept
+    {
+        // The map is ordered by key: a chunk resumes after the last key copied
+        auto readChunk = [this]( KvsMapSnapshot::Entries& out, core::Size limit ) -> core::Result< core::Bool > {
+            auto it = out.empty() ? m_values.begin() : m_values.upper_bound( mapKey( out.back().first ) );
+            for ( ; it != m_values.end() && limit > 0; ++it, --limit ) {
+                out.emplace_back( it->first, it->second );
+            }
+            return core::Result< core::Bool >::FromValue( it == m_values.end() );
+        };
+        auto readKey = [this]( core::StringView key, KvsDataType& out ) -> core::Result< core::Bool > {
+            auto it = m_values.find( mapKey( key ) );
+            if ( it == m_values.end() ) return core::Result< core::Bool >::FromValue( false );
+
+            out = it->second;
+            return core::Result< core::Bool >::FromValue( true );
+        };
+
+        auto snapshot = m_snapshots.Acquire( m_rwLock, readChunk, readKey );
+        if ( !snapshot.HasValue() ) {
+            LAP_PER_LOG_WARN << "KvsMemoryBackend::CreateSnapshot failed: " << snapshot.Error().Message();
+        }
+        return snapshot;
+    }
+
+    core::Result< void > KvsMemoryBackend::RemoveKey( core::StringView key ) noexcept
+    {
+        core::WriteLockGuard lock( m_rwLock );
+        auto it = m_values.find( mapKey( key ) );
+        if ( it != m_values.end() ) {
+            m_values.erase( it );
+            m_snapshots.Changed( key );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsMemoryBackend::RecoverKey( core::StringView ) noexcept
+    {
+        // Nothing stored to recover from, same as the Property backend without persistence
+        LAP_PER_LOG_WARN << "RecoverKey not supported by the memory backend";
+        return core::Result< void >::FromError( PerErrc::kUnsupported );
+    }
+
+    core::Result< void > KvsMemoryBackend::ResetKey( core::StringView ) noexcept
+    {
+        LAP_PER_LOG_WARN << "ResetKey not supported by the memory backend";
+        return core::Result< void >::FromError( PerErrc::kUnsupported );
+    }
+
+    core::Result< void > KvsMemoryBackend::RemoveAllKeys() noexcept
+    {
+        core::WriteLockGuard lock( m_rwLock );
+        m_values.clear();
+        m_snapshots.Cleared();
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsMemoryBackend::SyncToStorage() noexcept
+    {
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsMemoryBackend::DiscardPendingChanges() noexcept
+    {
+        // No stored state to reload: what was never synced is dropped
+        return RemoveAllKeys();
+    }
+
+    core::Result< core::UInt64 > KvsMemoryBackend::GetSize() const noexcept
+    {
+        core::ReadLockGuard lock( m_rwLock );
+        core::UInt64 size = 0;
+        for ( const auto& entry : m_values ) {
+            const core::Byte* data = nullptr;
+            core::Size bytes = 0;
+            size += entry.first.size();
+            if ( kvsValueBytes( entry.second, data, bytes ) ) size += bytes;
+        }
+
+        return core::Result< core::UInt64 >::FromValue( size );
+    }
+
+    core::Result< core::UInt32 > KvsMemoryBackend::GetKeyCount() const noexcept
+    {
+        core::ReadLockGuard lock( m_rwLock );
+        return core::Result< core::UInt32 >::FromValue( static_cast< core::UInt32 >( m_values.size() ) );
+    }
+
+} // namespace per
+} // namespace lap
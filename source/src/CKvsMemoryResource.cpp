@@ -0,0 +1,101 @@
+/**
+ * @file CKvsMemoryResource.cpp
+ * @brief Per-storage memory pool for KVS backend data
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <new>
+
+#include "CKvsMemoryResource.hpp"
+#include "CDataType.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        constexpr core::Size sizeClassOf( core::Size bytes ) noexcept
+        {
+            return ( ::std::max( bytes, core::Size( 1 ) ) - 1 ) / KvsMemoryResource::BLOCK_ALIGNMENT;
+        }
+
+        constexpr core::Bool isPooled( core::Size bytes, core::Size alignment ) noexcept
+        {
+            return bytes <= KvsMemoryResource::LARGEST_POOL_BLOCK && alignment <= KvsMemoryResource::BLOCK_ALIGNMENT;
+        }
+    }
+
+    KvsMemoryResource::KvsMemoryResource( core::Size capacity ) noexcept
+        : m_pArena( capacity > 0 ? new ( ::std::nothrow ) core::Byte[ capacity ] : nullptr )
+        , m_arena( capacity > 0 ? ::std::pmr::monotonic_buffer_resource( m_pArena.get(), m_pArena ? capacity : 0, ::std::pmr::null_memory_resource() )
+                                : ::std::pmr::monotonic_buffer_resource( ::std::pmr::new_delete_resource() ) )
+        , m_pLarge( capacity > 0 ? static_cast< ::std::pmr::memory_resource* >( &m_arena ) : ::std::pmr::new_delete_resource() )
+    {
+        m_stats.capacity = m_pArena ? capacity : 0;
+        if ( capacity > 0 && !m_pArena ) {
+            // Every allocation fails, the storage reports kOutOfMemorySpace instead of using the heap
+            LAP_PER_LOG_ERROR << "Kvs memory arena of " << capacity << " bytes could not be allocated";
+        }
+    }
+
+    KvsMemoryStatistics KvsMemoryResource::GetStatistics() const noexcept
+    {
+        core::LockGuard< core::Mutex > lock( m_mutex );
+        return m_stats;
+    }
+
+    void* KvsMemoryResource::do_allocate( core::Size bytes, core::Size alignment )
+    {
+        core::LockGuard< core::Mutex > lock( m_mutex );
+
+        void* p = nullptr;
+        if ( isPooled( bytes, alignment ) ) {
+            auto& freeList = m_freeLists[ sizeClassOf( bytes ) ];
+            if ( freeList != nullptr ) {
+                p           = freeList;
+                freeList    = freeList->next;
+            }
+        }
+
+        if ( p == nullptr ) {
+            try {
+                p = isPooled( bytes, alignment )
+                    ? m_arena.allocate( ( sizeClassOf( bytes ) + 1 ) * BLOCK_ALIGNMENT, BLOCK_ALIGNMENT )
+                    : m_pLarge->allocate( bytes, alignment );
+            } catch ( const ::std::bad_alloc& ) {
+                ++m_stats.failedAllocations;
+                LAP_PER_LOG_EVERY_N( WARN, 1024 ) << "Kvs memory pool exhausted, " << bytes << " bytes requested";
+                throw;
+            }
+        }
+
+        ++m_stats.allocations;
+        m_stats.bytesInUse  += bytes;
+        m_stats.peakBytes   = ::std::max( m_stats.peakBytes, m_stats.bytesInUse );
+        return p;
+    }
+
+    void KvsMemoryResource::do_deallocate( void* p, core::Size bytes, core::Size alignment )
+    {
+        core::LockGuard< core::Mutex > lock( m_mutex );
+
+        if ( isPooled( bytes, alignment ) ) {
+            auto& freeList  = m_freeLists[ sizeClassOf( bytes ) ];
+            freeList        = ::new ( p ) FreeBlock{ freeList };
+        } else {
+            m_pLarge->deallocate( p, bytes, alignment );
+        }
+        m_stats.bytesInUse -= bytes;
+    }
+
+    core::Bool KvsMemoryResource::do_is_equal( const ::std::pmr::memory_resource& other ) const noexcept
+    {
+        return this == &other;
+    }
+} // namespace per
+} // namespace lap
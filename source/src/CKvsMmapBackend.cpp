@@ -0,0 +1,1677 @@
+/**
+ * @file CKvsMmapBackend.cpp
+ * @brief Memory-mapped copy-on-write B+tree KVS backend for read-mostly instances
+ * @version 1.0
+ * @date 2025-11-27
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <thread>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lap/core/CCrypto.hpp>
+#include <lap/core/CPath.hpp>
+
+#include "CKvsMmapBackend.hpp"
+#include "CStoragePathManager.hpp"
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        constexpr core::UInt32  META_MAGIC          = 0x3154424d;   // "MBT1"
+        constexpr core::UInt32  META_FORMAT         = 1;
+        constexpr core::Size    META_CRC_OFFSET     = 56;
+        constexpr core::Size    META_SIZE           = 60;
+        constexpr core::UInt16  PAGE_LEAF           = 0x01;
+        constexpr core::UInt16  PAGE_BRANCH         = 0x02;
+        constexpr core::UInt16  PAGE_OVERFLOW       = 0x04;
+        constexpr core::UInt16  PAGE_FREELIST       = 0x08;
+        constexpr core::Size    PAGE_HEADER         = 8;            // UInt16 flags, UInt16 count, UInt32 overflow pages
+        constexpr core::Size    LEAF_CELL_HEADER    = 8;            // UInt16 keyLen, UInt8 type, UInt8 flags, UInt32 valueLen
+        constexpr core::Size    BRANCH_CELL_HEADER  = 10;           // UInt16 keyLen, UInt64 child
+        constexpr core::UInt8   CELL_OVERFLOW       = 0x01;
+        constexpr core::UInt64  FIRST_DATA_PAGE     = 2;
+        constexpr core::Size    READER_SLOTS        = 126;
+        constexpr core::UInt64  SLOT_FREE           = 0;
+        constexpr core::UInt64  SLOT_CLAIMED        = UINT64_MAX;
+        constexpr core::UInt32  MAX_DEPTH           = 32;
+        constexpr core::Size    PAGE_SIZE           = KvsMmapBackend::PAGE_SIZE;
+        constexpr core::Size    NODE_CAPACITY       = PAGE_SIZE - PAGE_HEADER;
+        constexpr core::Size    MAX_INLINE_CELL     = PAGE_SIZE / 4;    // At least four cells per page, so a split always makes progress
+        constexpr core::Size    FREELIST_PER_PAGE   = ( PAGE_SIZE - PAGE_HEADER - 8 ) / 8;
+        constexpr const char*   DATA_FILE_NAME      = "kvs_data.mdb";
+
+        template< class T >
+        T load( const core::UInt8* data ) noexcept
+        {
+            T value;
+            ::std::memcpy( &value, data, sizeof( T ) );
+            return value;
+        }
+
+        template< class T >
+        void store( core::UInt8* data, T value ) noexcept
+        {
+            ::std::memcpy( data, &value, sizeof( T ) );
+        }
+
+        inline PerErrc errnoToPerErrc( int err ) noexcept
+        {
+            switch ( err ) {
+                case ENOSPC:
+                case EDQUOT:    return PerErrc::kOutOfStorageSpace;
+                case ENOENT:    return PerErrc::kFileNotFound;
+                default:        return PerErrc::kPhysicalStorageFailure;
+            }
+        }
+
+        core::Result< void > writeAll( int fd, const core::UInt8* data, core::Size size, core::UInt64 offset ) noexcept
+        {
+            while ( size > 0 ) {
+                ssize_t n = ::pwrite( fd, data, size, static_cast< off_t >( offset ) );
+                if ( n < 0 && errno == EINTR ) continue;
+                if ( n <= 0 ) return core::Result< void >::FromError( n < 0 ? errnoToPerErrc( errno ) : PerErrc::kPhysicalStorageFailure );
+                data    += n;
+                size    -= static_cast< core::Size >( n );
+                offset  += static_cast< core::UInt64 >( n );
+            }
+            return core::Result< void >::FromValue();
+        }
+
+        core::Result< void > syncFile( int fd ) noexcept
+        {
+            if ( ::fdatasync( fd ) != 0 ) return core::Result< void >::FromError( errnoToPerErrc( errno ) );
+            return core::Result< void >::FromValue();
+        }
+
+        // ==================== Meta page ====================
+        // [UInt32 magic][UInt32 format][UInt32 pageSize][UInt32 reserved]
+        // [UInt64 txn][UInt64 root][UInt64 pageCount][UInt64 freeList][UInt64 entries][UInt32 crc32]
+
+        struct Meta
+        {
+            core::UInt64    txn{ 0 };
+            core::UInt64    root{ 0 };                  ///< 0 while the tree is empty
+            core::UInt64    pageCount{ FIRST_DATA_PAGE };
+            core::UInt64    freeList{ 0 };              ///< First free-list page, 0 if none
+            core::UInt64    entries{ 0 };
+        };
+
+        void encodeMeta( const Meta& meta, core::UInt8* out ) noexcept
+        {
+            ::std::memset( out, 0, META_SIZE );
+            store< core::UInt32 >( out, META_MAGIC );
+            store< core::UInt32 >( out + 4, META_FORMAT );
+            store< core::UInt32 >( out + 8, static_cast< core::UInt32 >( PAGE_SIZE ) );
+            store< core::UInt64 >( out + 16, meta.txn );
+            store< core::UInt64 >( out + 24, meta.root );
+            store< core::UInt64 >( out + 32, meta.pageCount );
+            store< core::UInt64 >( out + 40, meta.freeList );
+            store< core::UInt64 >( out + 48, meta.entries );
+            store< core::UInt32 >( out + META_CRC_OFFSET, core::Crypto::Util::computeCrc32( out, META_CRC_OFFSET ) );
+        }
+
+        core::Bool decodeMeta( const core::UInt8* data, Meta& meta ) noexcept
+        {
+            if ( load< core::UInt32 >( data ) != META_MAGIC || load< core::UInt32 >( data + 4 ) != META_FORMAT ) return false;
+            if ( load< core::UInt32 >( data + 8 ) != PAGE_SIZE ) return false;
+            if ( load< core::UInt32 >( data + META_CRC_OFFSET ) != core::Crypto::Util::computeCrc32( data, META_CRC_OFFSET ) ) return false;
+
+            meta.txn        = load< core::UInt64 >( data + 16 );
+            meta.root       = load< core::UInt64 >( data + 24 );
+            meta.pageCount  = load< core::UInt64 >( data + 32 );
+            meta.freeList   = load< core::UInt64 >( data + 40 );
+            meta.entries    = load< core::UInt64 >( data + 48 );
+            return meta.pageCount >= FIRST_DATA_PAGE && meta.root < meta.pageCount && meta.freeList < meta.pageCount;
+        }
+
+        // ==================== Node pages ====================
+
+        core::Size overflowPages( core::Size valueSize ) noexcept
+        {
+            return ( PAGE_HEADER + valueSize + PAGE_SIZE - 1 ) / PAGE_SIZE;
+        }
+
+        /**
+         * @brief Bounds-checked view of one leaf or branch page, mapped or a writer's copy
+         */
+        struct NodeView
+        {
+            const core::UInt8*  page;
+
+            core::UInt16    flags() const noexcept      { return load< core::UInt16 >( page ); }
+            core::UInt16    count() const noexcept      { return load< core::UInt16 >( page + 2 ); }
+            core::Bool      leaf() const noexcept       { return flags() == PAGE_LEAF; }
+            core::Size      offset( core::Size i ) const noexcept { return load< core::UInt16 >( page + PAGE_HEADER + 2 * i ); }
+
+            core::Bool valid() const noexcept
+            {
+                return ( flags() == PAGE_LEAF || flags() == PAGE_BRANCH ) && count() > 0 && PAGE_HEADER + 2 * count() <= PAGE_SIZE;
+            }
+
+            core::Bool key( core::Size i, core::StringView& key ) const noexcept
+            {
+                const core::Size at     = offset( i );
+                const core::Size header = leaf() ? LEAF_CELL_HEADER : BRANCH_CELL_HEADER;
+                if ( at + header > PAGE_SIZE ) return false;
+                const core::Size length = load< core::UInt16 >( page + at );
+                if ( at + header + length > PAGE_SIZE ) return false;
+                key = core::StringView( reinterpret_cast< const char* >( page + at + header ), length );
+                return true;
+            }
+
+            core::UInt64    child( core::Size i ) const noexcept { return load< core::UInt64 >( page + offset( i ) + 2 ); }
+        };
+
+        struct LeafCell
+        {
+            core::StringView        key;
+            EKvsDataTypeIndicate    type{ EKvsDataTypeIndicate::DataType_int8_t };
+            core::UInt8             flags{ 0 };
+            core::UInt32            valueSize{ 0 };
+            const core::UInt8*      stored{ nullptr };      ///< Inline value, or the UInt64 first overflow page
+        };
+
+        core::Bool readLeafCell( const NodeView& node, core::Size i, LeafCell& cell ) noexcept
+        {
+            if ( !node.key( i, cell.key ) ) return false;
+
+            const core::UInt8* at   = node.page + node.offset( i );
+            cell.type               = static_cast< EKvsDataTypeIndicate >( at[2] );
+            cell.flags              = at[3];
+            cell.valueSize          = load< core::UInt32 >( at + 4 );
+            cell.stored             = at + LEAF_CELL_HEADER + cell.key.size();
+
+            const core::Size storedSize = ( cell.flags & CELL_OVERFLOW ) ? sizeof( core::UInt64 ) : cell.valueSize;
+            return static_cast< core::Size >( cell.stored - node.page ) + storedSize <= PAGE_SIZE;
+        }
+
+        /**
+         * @brief Lock-free read access to one committed tree through the mapping
+         */
+        struct TreeReader
+        {
+            const core::UInt8*  base;
+            core::UInt64        pageCount;
+
+            core::Bool node( core::UInt64 pgno, NodeView& view ) const noexcept
+            {
+                if ( pgno < FIRST_DATA_PAGE || pgno >= pageCount ) return false;
+                view.page = base + pgno * PAGE_SIZE;
+                return view.valid();
+            }
+
+            // Returns false on a damaged page; found tells whether cell was filled
+            core::Bool find( core::UInt64 root, core::StringView key, LeafCell& cell, core::Bool& found ) const noexcept
+            {
+                found = false;
+                if ( root == 0 ) return true;
+
+                NodeView view{ nullptr };
+                core::UInt64 pgno = root;
+                for ( core::UInt32 depth = 0; depth < MAX_DEPTH; ++depth ) {
+                    if ( !node( pgno, view ) ) return false;
+
+                    if ( !view.leaf() ) {
+                        // Last child whose separator is <= key; the first separator is implicit
+                        core::Size low = 1, high = view.count();
+                        while ( low < high ) {
+                            const core::Size mid = ( low + high ) / 2;
+                            core::StringView separator;
+                            if ( !view.key( mid, separator ) ) return false;
+                            if ( separator <= key ) low = mid + 1; else high = mid;
+                        }
+                        pgno = view.child( low - 1 );
+                        continue;
+                    }
+
+                    core::Size low = 0, high = view.count();
+                    while ( low < high ) {
+                        const core::Size mid = ( low + high ) / 2;
+                        core::StringView candidate;
+                        if ( !view.key( mid, candidate ) ) return false;
+                        const int order = candidate.compare( key );
+                        if ( order == 0 ) {
+                            found = true;
+                            return readLeafCell( view, mid, cell );
+                        }
+                        if ( order < 0 ) low = mid + 1; else high = mid;
+                    }
+                    return true;
+                }
+                return false;
+            }
+
+            // The value bytes in the mapping, contiguous also for overflow runs
+            const core::UInt8* value( const LeafCell& cell ) const noexcept
+            {
+                if ( !( cell.flags & CELL_OVERFLOW ) ) return cell.stored;
+
+                const core::UInt64 first = load< core::UInt64 >( cell.stored );
+                if ( first < FIRST_DATA_PAGE || first + overflowPages( cell.valueSize ) > pageCount ) return nullptr;
+                return base + first * PAGE_SIZE + PAGE_HEADER;
+            }
+
+            core::Bool forEachKey( core::UInt64 pgno, const ::std::function< void( core::StringView ) >& visit, core::UInt32 depth = 0 ) const
+            {
+                NodeView view{ nullptr };
+                if ( depth >= MAX_DEPTH || !node( pgno, view ) ) return false;
+
+                for ( core::Size i = 0; i < view.count(); ++i ) {
+                    if ( view.leaf() ) {
+                        core::StringView key;
+                        if ( !view.key( i, key ) ) return false;
+                        visit( key );
+                    } else if ( !forEachKey( view.child( i ), visit, depth + 1 ) ) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+    }
+
+    // ==================== Environment ====================
+
+    /**
+     * @brief File, mapping and reader table of one instance
+     *
+     * The committed state is published through a sequence lock, so readers see
+     * root, page count and transaction of the same commit without locking.
+     */
+    struct KvsMmapBackend::Env
+    {
+        struct State
+        {
+            core::UInt64    txn{ 0 };
+            core::UInt64    root{ 0 };
+            core::UInt64    pageCount{ FIRST_DATA_PAGE };
+            core::UInt64    entries{ 0 };
+        };
+
+        struct alignas( 64 ) Slot
+        {
+            ::std::atomic< core::UInt64 >   txn{ SLOT_FREE };
+        };
+
+        int                                 fd{ -1 };
+        const core::UInt8*                  base{ nullptr };
+        core::Size                          mapSize{ 0 };
+        core::UInt64                        fileSize{ 0 };      ///< Writer only, under the backend's sync mutex
+
+        ::std::atomic< core::UInt64 >       seq{ 0 };
+        ::std::atomic< core::UInt64 >       txn{ 0 };
+        ::std::atomic< core::UInt64 >       root{ 0 };
+        ::std::atomic< core::UInt64 >       pageCount{ FIRST_DATA_PAGE };
+        ::std::atomic< core::UInt64 >       entries{ 0 };
+
+        Slot                                slots[ READER_SLOTS ];
+        core::Mutex                         pinMutex;
+        ::std::multiset< core::UInt64 >     pinned;             ///< Snapshots, and readers that found no free slot
+
+        ~Env() noexcept
+        {
+            if ( base != nullptr ) ::munmap( const_cast< core::UInt8* >( base ), mapSize );
+            if ( fd >= 0 ) ::close( fd );   // Also drops the flock
+        }
+
+        State load() const noexcept
+        {
+            for ( ;; ) {
+                const core::UInt64 before = seq.load( ::std::memory_order_acquire );
+                if ( before & 1 ) {
+                    ::std::this_thread::yield();
+                    continue;
+                }
+
+                State state;
+                state.txn       = txn.load( ::std::memory_order_relaxed );
+                state.root      = root.load( ::std::memory_order_relaxed );
+                state.pageCount = pageCount.load( ::std::memory_order_relaxed );
+                state.entries   = entries.load( ::std::memory_order_relaxed );
+                ::std::atomic_thread_fence( ::std::memory_order_acquire );
+                if ( seq.load( ::std::memory_order_relaxed ) == before ) return state;
+            }
+        }
+
+        void publish( const State& state ) noexcept
+        {
+            const core::UInt64 current = seq.load( ::std::memory_order_relaxed );
+            seq.store( current + 1, ::std::memory_order_relaxed );
+            ::std::atomic_thread_fence( ::std::memory_order_release );
+            root.store( state.root, ::std::memory_order_relaxed );
+            pageCount.store( state.pageCount, ::std::memory_order_relaxed );
+            entries.store( state.entries, ::std::memory_order_relaxed );
+            txn.store( state.txn );     // seq_cst: pairs with the reader's slot store and re-check
+            seq.store( current + 2, ::std::memory_order_release );
+        }
+
+        // Oldest transaction a reader may still walk; current if there is none
+        core::UInt64 oldestReader( core::UInt64 current ) noexcept
+        {
+            ::std::atomic_thread_fence( ::std::memory_order_seq_cst );
+
+            core::UInt64 oldest = current;
+            for ( const auto& slot : slots ) {
+                // A claimed slot belongs to a reader still registering, it ends up on current or later
+                const core::UInt64 value = slot.txn.load();
+                if ( value != SLOT_FREE && value != SLOT_CLAIMED ) oldest = ::std::min( oldest, value );
+            }
+
+            core::LockGuard< core::Mutex > lock( pinMutex );
+            if ( !pinned.empty() ) oldest = ::std::min( oldest, *pinned.begin() );
+            return oldest;
+        }
+    };
+
+    /**
+     * @brief Registers the committed transaction a reader walks, so its pages are not reused
+     */
+    class KvsMmapBackend::ReadTxn final
+    {
+    public:
+        /// @param pin Register in the pinned set instead of a slot (long-lived snapshots); may throw bad_alloc
+        explicit ReadTxn( Env& env, core::Bool pin = false )
+            : m_env( env )
+        {
+            if ( !pin ) {
+                thread_local core::Size t_hint = ::std::hash< ::std::thread::id >()( ::std::this_thread::get_id() ) % READER_SLOTS;
+                for ( core::Size i = 0; i < READER_SLOTS && m_pSlot == nullptr; ++i ) {
+                    const core::Size index = ( t_hint + i ) % READER_SLOTS;
+                    core::UInt64 expected = SLOT_FREE;
+                    if ( env.slots[index].txn.compare_exchange_strong( expected, SLOT_CLAIMED ) ) {
+                        m_pSlot = &env.slots[index].txn;
+                        t_hint  = index;
+                    }
+                }
+            }
+
+            if ( m_pSlot != nullptr ) {
+                // A writer publishing after our store sees the slot; one that published before makes us retry
+                for ( ;; ) {
+                    m_state = env.load();
+                    m_pSlot->store( m_state.txn );
+                    if ( env.txn.load() == m_state.txn ) break;
+                }
+                return;
+            }
+
+            core::LockGuard< core::Mutex > lock( env.pinMutex );
+            m_state = env.load();
+            m_pin   = env.pinned.insert( m_state.txn );
+            m_bPinned = true;
+        }
+
+        ~ReadTxn() noexcept
+        {
+            if ( m_pSlot != nullptr ) {
+                m_pSlot->store( SLOT_FREE, ::std::memory_order_release );
+            } else if ( m_bPinned ) {
+                core::LockGuard< core::Mutex > lock( m_env.pinMutex );
+                m_env.pinned.erase( m_pin );
+            }
+        }
+
+        ReadTxn( const ReadTxn& ) = delete;
+        ReadTxn& operator=( const ReadTxn& ) = delete;
+
+        const Env::State&                               State() const noexcept  { return m_state; }
+        TreeReader                                      Tree() const noexcept   { return TreeReader{ m_env.base, m_state.pageCount }; }
+
+    private:
+        Env&                                            m_env;
+        Env::State                                      m_state;
+        ::std::atomic< core::UInt64 >*                  m_pSlot{ nullptr };
+        ::std::multiset< core::UInt64 >::iterator       m_pin;
+        core::Bool                                      m_bPinned{ false };
+    };
+
+    // ==================== Writer transaction ====================
+
+    /**
+     * @brief Applies one batch to a private copy of the changed pages and commits it
+     *
+     * Every node on the path to a changed key is rewritten to a free page; the
+     * committed tree is never touched. Works on a copy of the free-page state, so
+     * a failed commit leaves the backend as it was.
+     */
+    class KvsMmapBackend::WriteTxn final
+    {
+    public:
+        WriteTxn( Env& env, const Env::State& base, const FreePages& free )
+            : m_env( env )
+            , m_state( base )
+            , m_free( free )
+        {
+            // Descending, so single pages come from the front of the file and runs are found by one scan
+            ::std::sort( m_free.reusable.begin(), m_free.reusable.end(), ::std::greater< core::UInt64 >() );
+        }
+
+        core::Result< void > Apply( const Batch& batch ) noexcept
+        {
+            try {
+                if ( batch.cleared && m_state.root != 0 ) {
+                    auto freed = freeTree( m_state.root, 0 );
+                    if ( !freed.HasValue() ) return freed;
+                    m_state.root    = 0;
+                    m_state.entries = 0;
+                }
+                if ( batch.records.empty() ) return core::Result< void >::FromValue();
+
+                core::Result< core::Vector< Child > > children = core::Vector< Child >();
+                if ( m_state.root == 0 ) {
+                    core::Vector< Cell > cells;
+                    for ( const auto& item : batch.records ) {
+                        if ( item.second.deleted ) continue;
+                        auto cell = makeLeafCell( item.first, item.second.value );
+                        if ( !cell.HasValue() ) return core::Result< void >::FromError( cell.Error() );
+                        cells.push_back( ::std::move( cell.Value() ) );
+                        ++m_state.entries;
+                    }
+                    children = writeNodes( true, cells );
+                } else {
+                    children = applyNode( m_state.root, core::String(), batch.records.begin(), batch.records.end(), 0 );
+                }
+                if ( !children.HasValue() ) return core::Result< void >::FromError( children.Error() );
+
+                auto root = buildRoot( ::std::move( children.Value() ) );
+                if ( !root.HasValue() ) return core::Result< void >::FromError( root.Error() );
+                m_state.root = root.Value();
+
+                // Deletes may leave a root with a single child
+                while ( m_state.root != 0 ) {
+                    auto data = pageData( m_state.root );
+                    if ( !data.HasValue() ) return core::Result< void >::FromError( data.Error() );
+                    NodeView view{ data.Value() };
+                    if ( view.leaf() || view.count() != 1 ) break;
+                    const core::UInt64 child = view.child( 0 );
+                    freePage( m_state.root );
+                    m_state.root = child;
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+            }
+            return core::Result< void >::FromValue();
+        }
+
+        core::Result< void > Commit() noexcept
+        {
+            using result = core::Result< void >;
+
+            if ( !m_bChanged ) return result::FromValue();
+
+            core::Vector< core::UInt64 > listPages;
+            try {
+                const core::UInt64 txn = m_state.txn + 1;
+
+                // Unlinked pages and the old free list stay readable for readers of older transactions
+                m_freed.insert( m_freed.end(), m_free.listPages.begin(), m_free.listPages.end() );
+                m_free.pending.emplace_back( txn, ::std::move( m_freed ) );
+                m_freed.clear();
+                m_free.reusable.insert( m_free.reusable.end(), m_spare.begin(), m_spare.end() );
+                m_spare.clear();
+
+                // Allocating list pages from the pool only shrinks the list
+                auto freeCount = [this]() {
+                    core::Size count = m_free.reusable.size();
+                    for ( const auto& batch : m_free.pending ) count += batch.second.size();
+                    return count;
+                };
+                while ( listPages.size() * FREELIST_PER_PAGE < freeCount() ) {
+                    auto page = allocPage();
+                    if ( !page.HasValue() ) return result::FromError( page.Error() );
+                    listPages.push_back( page.Value() );
+                }
+
+                core::Vector< core::UInt64 > all( m_free.reusable );
+                for ( const auto& batch : m_free.pending ) all.insert( all.end(), batch.second.begin(), batch.second.end() );
+                for ( core::Size i = 0; i < listPages.size(); ++i ) {
+                    core::Vector< core::UInt8 > page( PAGE_SIZE, 0 );
+                    const core::Size begin  = i * FREELIST_PER_PAGE;
+                    const core::Size count  = ::std::min( FREELIST_PER_PAGE, all.size() - begin );
+                    store< core::UInt16 >( page.data(), PAGE_FREELIST );
+                    store< core::UInt16 >( page.data() + 2, static_cast< core::UInt16 >( count ) );
+                    store< core::UInt64 >( page.data() + PAGE_HEADER, i + 1 < listPages.size() ? listPages[i + 1] : 0 );
+                    ::std::memcpy( page.data() + PAGE_HEADER + 8, all.data() + begin, count * sizeof( core::UInt64 ) );
+                    m_dirty[ listPages[i] ] = ::std::move( page );
+                }
+
+                // Pages first, then the meta page that makes them reachable
+                for ( const auto& item : m_dirty ) {
+                    auto written = writeAll( m_env.fd, item.second.data(), item.second.size(), item.first * PAGE_SIZE );
+                    if ( !written.HasValue() ) return written;
+                    m_env.fileSize = ::std::max< core::UInt64 >( m_env.fileSize, item.first * PAGE_SIZE + item.second.size() );
+                }
+                if ( m_env.fileSize < m_state.pageCount * PAGE_SIZE ) {
+                    // Pages allocated and released again were never written
+                    if ( ::ftruncate( m_env.fd, static_cast< off_t >( m_state.pageCount * PAGE_SIZE ) ) != 0 ) {
+                        return result::FromError( errnoToPerErrc( errno ) );
+                    }
+                    m_env.fileSize = m_state.pageCount * PAGE_SIZE;
+                }
+                auto synced = syncFile( m_env.fd );
+                if ( !synced.HasValue() ) return synced;
+
+                Meta meta;
+                meta.txn        = txn;
+                meta.root       = m_state.root;
+                meta.pageCount  = m_state.pageCount;
+                meta.freeList   = listPages.empty() ? 0 : listPages.front();
+                meta.entries    = m_state.entries;
+
+                core::UInt8 metaBytes[ META_SIZE ];
+                encodeMeta( meta, metaBytes );
+                auto written = writeAll( m_env.fd, metaBytes, META_SIZE, ( txn % 2 ) * PAGE_SIZE );
+                if ( !written.HasValue() ) return written;
+                synced = syncFile( m_env.fd );
+                if ( !synced.HasValue() ) return synced;
+
+                m_state.txn         = txn;
+                m_free.listPages    = ::std::move( listPages );
+            } catch ( const ::std::bad_alloc& ) {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+
+            m_env.publish( m_state );
+            return result::FromValue();
+        }
+
+        FreePages&                                      Free() noexcept     { return m_free; }
+
+    private:
+        struct Cell
+        {
+            core::String                    key;
+            core::UInt64                    child{ 0 };         ///< Branch cells
+            core::UInt8                     type{ 0 };          ///< Leaf cells from here on
+            core::UInt8                     flags{ 0 };
+            core::UInt32                    valueSize{ 0 };
+            core::Vector< core::UInt8 >     stored;             ///< Inline value, or the first overflow page
+
+            core::Size size( core::Bool leaf ) const noexcept
+            {
+                return 2 + key.size() + ( leaf ? LEAF_CELL_HEADER + stored.size() : BRANCH_CELL_HEADER );
+            }
+        };
+
+        // One node written by this transaction, as its parent will reference it
+        struct Child
+        {
+            core::String                    key;
+            core::UInt64                    page{ 0 };
+            core::Size                      bytes{ 0 };
+        };
+
+        using RecordIter = ::std::map< core::String, Record, KeyLess >::const_iterator;
+
+        core::Result< const core::UInt8* > pageData( core::UInt64 pgno ) const noexcept
+        {
+            auto it = m_dirty.find( pgno );
+            if ( it != m_dirty.end() ) return core::Result< const core::UInt8* >::FromValue( it->second.data() );
+            if ( pgno < FIRST_DATA_PAGE || pgno >= m_state.pageCount ) return core::Result< const core::UInt8* >::FromError( PerErrc::kIntegrityCorrupted );
+            return core::Result< const core::UInt8* >::FromValue( m_env.base + pgno * PAGE_SIZE );
+        }
+
+        core::Result< core::UInt64 > allocPage() noexcept
+        {
+            m_bChanged = true;
+            for ( auto* pool : { &m_spare, &m_free.reusable } ) {
+                if ( !pool->empty() ) {
+                    const core::UInt64 pgno = pool->back();
+                    pool->pop_back();
+                    return core::Result< core::UInt64 >::FromValue( pgno );
+                }
+            }
+            return allocRun( 1 );
+        }
+
+        // Overflow runs must be contiguous: a run of free pages, else the end of the file
+        core::Result< core::UInt64 > allocRun( core::Size pages ) noexcept
+        {
+            m_bChanged = true;
+            auto& pool = m_free.reusable;
+            for ( core::Size length = 1, i = 1; pages > 1 && i < pool.size(); ++i ) {
+                length = ( pool[i] + 1 == pool[i - 1] ) ? length + 1 : 1;
+                if ( length == pages ) {
+                    const core::UInt64 first = pool[i];
+                    pool.erase( pool.begin() + static_cast< ::std::ptrdiff_t >( i + 1 - pages ), pool.begin() + static_cast< ::std::ptrdiff_t >( i + 1 ) );
+                    return core::Result< core::UInt64 >::FromValue( first );
+                }
+            }
+
+            if ( ( m_state.pageCount + pages ) * PAGE_SIZE > m_env.mapSize ) {
+                LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "KvsMmapBackend: map size exhausted, " << m_env.mapSize << " bytes";
+                return core::Result< core::UInt64 >::FromError( PerErrc::kOutOfStorageSpace );
+            }
+            const core::UInt64 first = m_state.pageCount;
+            m_state.pageCount += pages;
+            return core::Result< core::UInt64 >::FromValue( first );
+        }
+
+        void freeRun( core::UInt64 first, core::Size pages )
+        {
+            m_bChanged = true;
+            // Written by this transaction: never visible to anyone, reuse right away
+            auto& target = m_dirty.erase( first ) > 0 ? m_spare : m_freed;
+            for ( core::Size i = 0; i < pages; ++i ) target.push_back( first + i );
+        }
+
+        void freePage( core::UInt64 pgno )
+        {
+            freeRun( pgno, 1 );
+        }
+
+        void releaseCell( const Cell& cell )
+        {
+            if ( cell.flags & CELL_OVERFLOW ) freeRun( load< core::UInt64 >( cell.stored.data() ), overflowPages( cell.valueSize ) );
+        }
+
+        core::Result< void > decode( core::UInt64 pgno, const core::String& lowKey, core::Bool& leaf, core::Vector< Cell >& cells ) const
+        {
+            auto data = pageData( pgno );
+            if ( !data.HasValue() ) return core::Result< void >::FromError( data.Error() );
+
+            NodeView view{ data.Value() };
+            if ( !view.valid() ) return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+
+            leaf = view.leaf();
+            cells.resize( view.count() );
+            for ( core::Size i = 0; i < cells.size(); ++i ) {
+                Cell& cell = cells[i];
+                if ( leaf ) {
+                    LeafCell parsed;
+                    if ( !readLeafCell( view, i, parsed ) ) return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+                    const core::Size storedSize = ( parsed.flags & CELL_OVERFLOW ) ? sizeof( core::UInt64 ) : parsed.valueSize;
+                    cell.key.assign( parsed.key.data(), parsed.key.size() );
+                    cell.type       = static_cast< core::UInt8 >( parsed.type );
+                    cell.flags      = parsed.flags;
+                    cell.valueSize  = parsed.valueSize;
+                    cell.stored.assign( parsed.stored, parsed.stored + storedSize );
+                } else {
+                    core::StringView key;
+                    if ( !view.key( i, key ) ) return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+                    cell.key    = ( i == 0 ) ? lowKey : core::String( key.data(), key.size() );
+                    cell.child  = view.child( i );
+                }
+            }
+            return core::Result< void >::FromValue();
+        }
+
+        core::Result< Cell > makeLeafCell( core::StringView key, const KvsDataType& value )
+        {
+            const core::Byte* data = nullptr;
+            core::Size size = 0;
+            if ( !kvsValueBytes( value, data, size ) || size > UINT32_MAX ) return core::Result< Cell >::FromError( PerErrc::kWrongDataSize );
+
+            Cell cell;
+            cell.key.assign( key.data(), key.size() );
+            cell.type       = static_cast< core::UInt8 >( ::lap::core::GetVariantIndex( value ) );
+            cell.valueSize  = static_cast< core::UInt32 >( size );
+
+            if ( 2 + LEAF_CELL_HEADER + key.size() + size <= MAX_INLINE_CELL ) {
+                const auto* bytes = reinterpret_cast< const core::UInt8* >( data );
+                cell.stored.assign( bytes, bytes + size );
+                return core::Result< Cell >::FromValue( ::std::move( cell ) );
+            }
+
+            const core::Size pages = overflowPages( size );
+            auto first = allocRun( pages );
+            if ( !first.HasValue() ) return core::Result< Cell >::FromError( first.Error() );
+
+            core::Vector< core::UInt8 > run( pages * PAGE_SIZE, 0 );
+            store< core::UInt16 >( run.data(), PAGE_OVERFLOW );
+            store< core::UInt32 >( run.data() + 4, static_cast< core::UInt32 >( pages ) );
+            if ( size > 0 ) ::std::memcpy( run.data() + PAGE_HEADER, data, size );
+            m_dirty[ first.Value() ] = ::std::move( run );
+
+            cell.flags = CELL_OVERFLOW;
+            cell.stored.resize( sizeof( core::UInt64 ) );
+            store< core::UInt64 >( cell.stored.data(), first.Value() );
+            return core::Result< Cell >::FromValue( ::std::move( cell ) );
+        }
+
+        // Packs cells into as few, evenly filled pages as fit
+        core::Result< core::Vector< Child > > writeNodes( core::Bool leaf, const core::Vector< Cell >& cells )
+        {
+            core::Vector< Child > children;
+            if ( cells.empty() ) return core::Result< core::Vector< Child > >::FromValue( ::std::move( children ) );
+
+            core::Size total = 0;
+            for ( const auto& cell : cells ) total += cell.size( leaf );
+            const core::Size pages  = ( total + NODE_CAPACITY - 1 ) / NODE_CAPACITY;
+            const core::Size target = total / pages;
+
+            for ( core::Size begin = 0; begin < cells.size(); ) {
+                core::Size end = begin, used = 0;
+                while ( end < cells.size() ) {
+                    const core::Size size = cells[end].size( leaf );
+                    if ( used > 0 && ( used + size > NODE_CAPACITY || used >= target ) ) break;
+                    used += size;
+                    ++end;
+                }
+
+                auto pgno = allocPage();
+                if ( !pgno.HasValue() ) return core::Result< core::Vector< Child > >::FromError( pgno.Error() );
+
+                core::Vector< core::UInt8 > page( PAGE_SIZE, 0 );
+                store< core::UInt16 >( page.data(), leaf ? PAGE_LEAF : PAGE_BRANCH );
+                store< core::UInt16 >( page.data() + 2, static_cast< core::UInt16 >( end - begin ) );
+
+                core::Size at = PAGE_HEADER + 2 * ( end - begin );
+                for ( core::Size i = begin; i < end; ++i ) {
+                    const Cell& cell = cells[i];
+                    // The first separator of a branch is implied by the parent
+                    const core::Size keySize = ( !leaf && i == begin ) ? 0 : cell.key.size();
+                    core::UInt8* out = page.data() + at;
+
+                    store< core::UInt16 >( page.data() + PAGE_HEADER + 2 * ( i - begin ), static_cast< core::UInt16 >( at ) );
+                    store< core::UInt16 >( out, static_cast< core::UInt16 >( keySize ) );
+                    if ( leaf ) {
+                        out[2] = cell.type;
+                        out[3] = cell.flags;
+                        store< core::UInt32 >( out + 4, cell.valueSize );
+                        ::std::memcpy( out + LEAF_CELL_HEADER, cell.key.data(), keySize );
+                        if ( !cell.stored.empty() ) ::std::memcpy( out + LEAF_CELL_HEADER + keySize, cell.stored.data(), cell.stored.size() );
+                        at += LEAF_CELL_HEADER + keySize + cell.stored.size();
+                    } else {
+                        store< core::UInt64 >( out + 2, cell.child );
+                        ::std::memcpy( out + BRANCH_CELL_HEADER, cell.key.data(), keySize );
+                        at += BRANCH_CELL_HEADER + keySize;
+                    }
+                }
+
+                m_dirty[ pgno.Value() ] = ::std::move( page );
+                children.push_back( Child{ cells[begin].key, pgno.Value(), at - PAGE_HEADER } );
+                begin = end;
+            }
+            return core::Result< core::Vector< Child > >::FromValue( ::std::move( children ) );
+        }
+
+        // Rewrites the subtree under pgno with the records in [first, last); returns its replacement nodes
+        core::Result< core::Vector< Child > > applyNode( core::UInt64 pgno, const core::String& lowKey, RecordIter first, RecordIter last, core::UInt32 depth )
+        {
+            using result = core::Result< core::Vector< Child > >;
+
+            if ( depth >= MAX_DEPTH ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+            core::Bool leaf = false;
+            core::Vector< Cell > cells;
+            auto decoded = decode( pgno, lowKey, leaf, cells );
+            if ( !decoded.HasValue() ) return result::FromError( decoded.Error() );
+            freePage( pgno );
+
+            if ( leaf ) {
+                core::Vector< Cell > merged;
+                merged.reserve( cells.size() );
+                auto it = cells.begin();
+                for ( auto item = first; item != last; ++item ) {
+                    const core::StringView key = KeyLess::view( item->first );
+                    while ( it != cells.end() && KeyLess::view( it->key ) < key ) merged.push_back( ::std::move( *it++ ) );
+
+                    const core::Bool exists = it != cells.end() && KeyLess::view( it->key ) == key;
+                    if ( exists ) {
+                        releaseCell( *it );
+                        ++it;
+                        if ( item->second.deleted ) --m_state.entries;
+                    }
+                    if ( !item->second.deleted ) {
+                        auto cell = makeLeafCell( key, item->second.value );
+                        if ( !cell.HasValue() ) return result::FromError( cell.Error() );
+                        merged.push_back( ::std::move( cell.Value() ) );
+                        if ( !exists ) ++m_state.entries;
+                    }
+                }
+                while ( it != cells.end() ) merged.push_back( ::std::move( *it++ ) );
+                return writeNodes( true, merged );
+            }
+
+            core::Vector< Cell > out;
+            core::Vector< core::Bool > underfull;
+            auto item = first;
+            for ( core::Size i = 0; i < cells.size(); ++i ) {
+                auto end = item;
+                if ( i + 1 == cells.size() ) {
+                    end = last;
+                } else {
+                    while ( end != last && KeyLess::view( end->first ) < KeyLess::view( cells[i + 1].key ) ) ++end;
+                }
+
+                if ( item == end ) {
+                    out.push_back( ::std::move( cells[i] ) );
+                    underfull.push_back( false );
+                    continue;
+                }
+
+                auto children = applyNode( cells[i].child, cells[i].key, item, end, depth + 1 );
+                if ( !children.HasValue() ) return children;
+                for ( core::Size k = 0; k < children.Value().size(); ++k ) {
+                    Cell cell;
+                    cell.key    = ( k == 0 ) ? cells[i].key : ::std::move( children.Value()[k].key );
+                    cell.child  = children.Value()[k].page;
+                    out.push_back( ::std::move( cell ) );
+                    underfull.push_back( children.Value()[k].bytes < NODE_CAPACITY / 4 );
+                }
+                item = end;
+            }
+
+            auto merged = mergeUnderfull( out, underfull );
+            if ( !merged.HasValue() ) return result::FromError( merged.Error() );
+            return writeNodes( false, out );
+        }
+
+        // Joins each underfull child with a sibling, so deletes do not leave a sparse tree
+        core::Result< void > mergeUnderfull( core::Vector< Cell >& cells, core::Vector< core::Bool >& underfull )
+        {
+            for ( core::Size i = 0; i < cells.size() && cells.size() > 1; ) {
+                if ( !underfull[i] ) {
+                    ++i;
+                    continue;
+                }
+
+                const core::Size left = ( i + 1 < cells.size() ) ? i : i - 1;
+                core::Bool leafLeft = false, leafRight = false;
+                core::Vector< Cell > joined, right;
+                auto decoded = decode( cells[left].child, cells[left].key, leafLeft, joined );
+                if ( decoded.HasValue() ) decoded = decode( cells[left + 1].child, cells[left + 1].key, leafRight, right );
+                if ( !decoded.HasValue() ) return decoded;
+                if ( leafLeft != leafRight ) return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+
+                freePage( cells[left].child );
+                freePage( cells[left + 1].child );
+                for ( auto& cell : right ) joined.push_back( ::std::move( cell ) );
+
+                auto children = writeNodes( leafLeft, joined );
+                if ( !children.HasValue() ) return core::Result< void >::FromError( children.Error() );
+
+                core::Vector< Cell > replacement( children.Value().size() );
+                for ( core::Size k = 0; k < replacement.size(); ++k ) {
+                    replacement[k].key      = ( k == 0 ) ? cells[left].key : ::std::move( children.Value()[k].key );
+                    replacement[k].child    = children.Value()[k].page;
+                }
+
+                cells.erase( cells.begin() + left, cells.begin() + left + 2 );
+                underfull.erase( underfull.begin() + left, underfull.begin() + left + 2 );
+                cells.insert( cells.begin() + left, ::std::make_move_iterator( replacement.begin() ), ::std::make_move_iterator( replacement.end() ) );
+                underfull.insert( underfull.begin() + left, replacement.size(), false );
+                i = left + replacement.size();
+            }
+            return core::Result< void >::FromValue();
+        }
+
+        core::Result< core::UInt64 > buildRoot( core::Vector< Child >&& children )
+        {
+            while ( children.size() > 1 ) {
+                core::Vector< Cell > cells( children.size() );
+                for ( core::Size i = 0; i < children.size(); ++i ) {
+                    cells[i].key    = ::std::move( children[i].key );
+                    cells[i].child  = children[i].page;
+                }
+                auto parents = writeNodes( false, cells );
+                if ( !parents.HasValue() ) return core::Result< core::UInt64 >::FromError( parents.Error() );
+                children = ::std::move( parents.Value() );
+            }
+            return core::Result< core::UInt64 >::FromValue( children.empty() ? 0 : children.front().page );
+        }
+
+        core::Result< void > freeTree( core::UInt64 pgno, core::UInt32 depth )
+        {
+            if ( depth >= MAX_DEPTH ) return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+
+            core::Bool leaf = false;
+            core::Vector< Cell > cells;
+            auto decoded = decode( pgno, core::String(), leaf, cells );
+            if ( !decoded.HasValue() ) return decoded;
+
+            for ( const auto& cell : cells ) {
+                if ( leaf ) {
+                    releaseCell( cell );
+                } else {
+                    auto freed = freeTree( cell.child, depth + 1 );
+                    if ( !freed.HasValue() ) return freed;
+                }
+            }
+            freePage( pgno );
+            return core::Result< void >::FromValue();
+        }
+
+    private:
+        Env&                                            m_env;
+        Env::State                                      m_state;
+        FreePages                                       m_free;
+        ::std::map< core::UInt64, core::Vector< core::UInt8 > > m_dirty;    ///< New pages by number, written in file order
+        core::Vector< core::UInt64 >                    m_freed;            ///< Committed pages this transaction unlinks
+        core::Vector< core::UInt64 >                    m_spare;            ///< Pages allocated and released again
+        core::Bool                                      m_bChanged{ false };
+    };
+
+    // ==================== Snapshot ====================
+
+    class KvsMmapBackend::Snapshot final : public IKvsSnapshot
+    {
+    public:
+        Snapshot( core::SharedHandle< Env > env, core::SharedHandle< const Batch > newer, core::SharedHandle< const Batch > older )
+            : m_pEnv( ::std::move( env ) )
+            , m_txn( *m_pEnv, true )
+            , m_pNewer( ::std::move( newer ) )
+            , m_pOlder( ::std::move( older ) )
+        {
+            ;
+        }
+
+        core::Result< core::Vector< core::String > > GetAllKeys() const noexcept override
+        {
+            return collectKeys( *m_pEnv, m_txn.State().root, m_txn.State().pageCount, m_pNewer.get(), m_pOlder.get() );
+        }
+
+        core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept override
+        {
+            auto state = lookup( key, nullptr );
+            if ( !state.HasValue() ) return core::Result< core::Bool >::FromError( state.Error() );
+            return core::Result< core::Bool >::FromValue( state.Value() == Lookup::kFound );
+        }
+
+        core::Result< KvsDataType > GetValue( core::StringView key ) const noexcept override
+        {
+            using result = core::Result< KvsDataType >;
+
+            KvsDataType value;
+            auto state = lookup( key, &value );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+            return result::FromValue( ::std::move( value ) );
+        }
+
+        core::Result< core::UInt32 > GetKeyCount() const noexcept override
+        {
+            if ( !m_pNewer && !m_pOlder ) return core::Result< core::UInt32 >::FromValue( static_cast< core::UInt32 >( m_txn.State().entries ) );
+
+            auto keys = GetAllKeys();
+            if ( !keys.HasValue() ) return core::Result< core::UInt32 >::FromError( keys.Error() );
+            return core::Result< core::UInt32 >::FromValue( static_cast< core::UInt32 >( keys.Value().size() ) );
+        }
+
+    private:
+        core::Result< Lookup > lookup( core::StringView key, KvsDataType* out ) const noexcept
+        {
+            try {
+                Lookup state = findInBatches( m_pNewer.get(), m_pOlder.get(), key, out );
+                if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+                return findInTree( *m_pEnv, m_txn.State().root, m_txn.State().pageCount, key, out );
+            } catch ( const ::std::bad_alloc& ) {
+                return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+            }
+        }
+
+    private:
+        core::SharedHandle< Env >                       m_pEnv;     ///< Outlives m_txn and the mapping it reads
+        ReadTxn                                         m_txn;
+        core::SharedHandle< const Batch >               m_pNewer;
+        core::SharedHandle< const Batch >               m_pOlder;
+    };
+
+    // ==================== Construction ====================
+
+    KvsMmapBackend::KvsMmapBackend( core::StringView identifier, const KvsMmapOptions& options ) noexcept
+        : m_options( options )
+    {
+        try {
+            m_instancePath  = CStoragePathManager::getKvsInstancePath( identifier );
+            m_filePath      = core::Path::appendString( core::Path::appendString( m_instancePath, "current" ), DATA_FILE_NAME );
+            m_pPending      = ::std::make_shared< Batch >();
+        } catch ( const ::std::bad_alloc& ) {
+            LAP_PER_LOG_ERROR << "Kvs mmap backend create failed, out of memory: " << identifier;
+            return;
+        }
+
+        // Same layout as the File backend
+        auto vfs = IVirtualFileSystem::getDefault();
+        static const char* const s_subdirs[] = { "current", "update", "redundancy", "recovery" };
+        for ( const auto* subdir : s_subdirs ) {
+            if ( !vfs->CreateDirectory( core::Path::appendString( m_instancePath, subdir ) ).HasValue() ) {
+                LAP_PER_LOG_WARN << "Failed to create KVS directory structure for: " << identifier;
+                return;
+            }
+        }
+
+        if ( !open().HasValue() ) return;
+
+        m_bAvailable = true;
+        LAP_PER_LOG_INFO << "Kvs mmap backend initialized: " << m_filePath << " (transaction " << GetTransactionId() << ")";
+    }
+
+    KvsMmapBackend::~KvsMmapBackend() noexcept
+    {
+        if ( m_bAvailable && m_bOverlay.load() && !SyncToStorage().HasValue() ) {
+            LAP_PER_LOG_WARN << "KvsMmapBackend::~KvsMmapBackend auto-sync failed";
+        }
+    }
+
+    core::Result< void > KvsMmapBackend::open() noexcept
+    {
+        using result = core::Result< void >;
+
+        core::SharedHandle< Env > env;
+        try {
+            env = ::std::make_shared< Env >();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        env->fd = ::open( m_filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+        if ( env->fd < 0 ) {
+            LAP_PER_LOG_ERROR << "Kvs mmap backend cannot open " << m_filePath << ": " << ::strerror( errno );
+            return result::FromError( errnoToPerErrc( errno ) );
+        }
+        // Free-page tracking is per instance, a second writer would hand out the same pages
+        if ( ::flock( env->fd, LOCK_EX | LOCK_NB ) != 0 ) {
+            LAP_PER_LOG_ERROR << "Kvs mmap backend file is in use by another instance: " << m_filePath;
+            return result::FromError( PerErrc::kResourceBusy );
+        }
+
+        struct stat info;
+        if ( ::fstat( env->fd, &info ) != 0 ) return result::FromError( errnoToPerErrc( errno ) );
+        env->fileSize = static_cast< core::UInt64 >( info.st_size );
+
+        if ( env->fileSize == 0 ) {
+            core::UInt8 initial[ 2 * PAGE_SIZE ] = {};
+            encodeMeta( Meta(), initial );
+            encodeMeta( Meta(), initial + PAGE_SIZE );
+            auto written = writeAll( env->fd, initial, sizeof( initial ), 0 );
+            if ( written.HasValue() ) written = syncFile( env->fd );
+            if ( !written.HasValue() ) return written;
+            env->fileSize = sizeof( initial );
+        }
+
+        // The newest meta page with a valid checksum names the last complete commit
+        Meta meta;
+        core::Bool found = false;
+        for ( core::UInt64 slot = 0; slot < 2 && env->fileSize >= 2 * PAGE_SIZE; ++slot ) {
+            core::UInt8 bytes[ META_SIZE ];
+            Meta candidate;
+            if ( ::pread( env->fd, bytes, META_SIZE, static_cast< off_t >( slot * PAGE_SIZE ) ) != static_cast< ssize_t >( META_SIZE ) ) continue;
+            if ( !decodeMeta( bytes, candidate ) ) {
+                LAP_PER_LOG_WARN << "Kvs mmap backend ignores damaged meta page " << slot << ": " << m_filePath;
+                continue;
+            }
+            if ( !found || candidate.txn > meta.txn ) meta = candidate;
+            found = true;
+        }
+        if ( !found || meta.pageCount * PAGE_SIZE > env->fileSize ) {
+            LAP_PER_LOG_ERROR << "Kvs mmap backend file is corrupted: " << m_filePath;
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+
+        env->mapSize = ( ::std::max( m_options.mapSize, static_cast< core::Size >( env->fileSize ) ) + PAGE_SIZE - 1 ) / PAGE_SIZE * PAGE_SIZE;
+        void* base = ::mmap( nullptr, env->mapSize, PROT_READ, MAP_SHARED, env->fd, 0 );
+        if ( base == MAP_FAILED ) {
+            LAP_PER_LOG_ERROR << "Kvs mmap backend cannot map " << env->mapSize << " bytes of " << m_filePath << ": " << ::strerror( errno );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        env->base = static_cast< const core::UInt8* >( base );
+        ::madvise( base, env->mapSize, MADV_RANDOM );   // Point lookups, read-ahead only wastes page cache
+
+        FreePages free;
+        try {
+            core::UInt64 pgno = meta.freeList;
+            while ( pgno != 0 ) {
+                if ( pgno < FIRST_DATA_PAGE || pgno >= meta.pageCount || free.listPages.size() > meta.pageCount ) {
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                const core::UInt8* page = env->base + pgno * PAGE_SIZE;
+                const core::Size count  = load< core::UInt16 >( page + 2 );
+                if ( load< core::UInt16 >( page ) != PAGE_FREELIST || count > FREELIST_PER_PAGE ) return result::FromError( PerErrc::kIntegrityCorrupted );
+
+                for ( core::Size i = 0; i < count; ++i ) free.reusable.push_back( load< core::UInt64 >( page + PAGE_HEADER + 8 + i * 8 ) );
+                free.listPages.push_back( pgno );
+                pgno = load< core::UInt64 >( page + PAGE_HEADER );
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        Env::State state;
+        state.txn       = meta.txn;
+        state.root      = meta.root;
+        state.pageCount = meta.pageCount;
+        state.entries   = meta.entries;
+        env->publish( state );
+
+        m_free  = ::std::move( free );
+        m_pEnv  = ::std::move( env );
+        return result::FromValue();
+    }
+
+    // ==================== Read path ====================
+
+    KvsMmapBackend::Lookup KvsMmapBackend::findInBatches( const Batch* newer, const Batch* older, core::StringView key, KvsDataType* out )
+    {
+        for ( const Batch* batch : { newer, older } ) {
+            if ( nullptr == batch ) continue;
+
+            auto it = batch->records.find( key );
+            if ( it != batch->records.end() ) {
+                if ( it->second.deleted ) return Lookup::kDeleted;
+                if ( nullptr != out ) *out = it->second.value;
+                return Lookup::kFound;
+            }
+            if ( batch->cleared ) return Lookup::kDeleted;
+        }
+        return Lookup::kMissing;
+    }
+
+    core::Result< KvsMmapBackend::Lookup > KvsMmapBackend::findInTree( const Env& env, core::UInt64 root, core::UInt64 pageCount, core::StringView key, KvsDataType* out )
+    {
+        using result = core::Result< Lookup >;
+
+        TreeReader tree{ env.base, pageCount };
+        LeafCell cell;
+        core::Bool found = false;
+        if ( !tree.find( root, key, cell, found ) ) {
+            LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs mmap backend found a damaged page";
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+        if ( !found ) return result::FromValue( Lookup::kMissing );
+
+        if ( nullptr != out ) {
+            // Decoded straight from the mapped page
+            const core::UInt8* data = tree.value( cell );
+            if ( nullptr == data || !kvsValueFromBytes( cell.type, reinterpret_cast< const core::Byte* >( data ), cell.valueSize, *out ) ) {
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+        }
+        return result::FromValue( Lookup::kFound );
+    }
+
+    core::Result< core::Vector< core::String > > KvsMmapBackend::collectKeys( const Env& env, core::UInt64 root, core::UInt64 pageCount, const Batch* newer, const Batch* older ) noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        try {
+            ::std::set< core::String, KeyLess > keys;
+
+            const core::Bool treeHidden = ( newer && newer->cleared ) || ( older && older->cleared );
+            if ( !treeHidden && root != 0 ) {
+                TreeReader tree{ env.base, pageCount };
+                if ( !tree.forEachKey( root, [&keys]( core::StringView key ) { keys.emplace_hint( keys.end(), key.data(), key.size() ); } ) ) {
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+            }
+
+            // Oldest layer first; a cleared layer already hid everything below it
+            for ( const Batch* batch : { older, newer } ) {
+                if ( nullptr == batch ) continue;
+                if ( batch->cleared ) keys.clear();
+                for ( const auto& item : batch->records ) {
+                    if ( item.second.deleted ) {
+                        auto it = keys.find( item.first );
+                        if ( it != keys.end() ) keys.erase( it );
+                    } else {
+                        keys.insert( item.first );
+                    }
+                }
+            }
+
+            return result::FromValue( core::Vector< core::String >( keys.begin(), keys.end() ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< KvsMmapBackend::Lookup > KvsMmapBackend::find( core::StringView key, KvsDataType* out ) const noexcept
+    {
+        try {
+            // Overlay before tree: a batch leaves the overlay only after its commit is published
+            if ( m_bOverlay.load( ::std::memory_order_acquire ) ) {
+                core::ReadLockGuard lock( m_rwLock );
+                Lookup state = findInBatches( m_pPending.get(), m_pSyncing.get(), key, out );
+                if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+            }
+
+            ReadTxn txn( *m_pEnv );
+            return findInTree( *m_pEnv, txn.State().root, txn.State().pageCount, key, out );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< KvsMmapBackend::Lookup > KvsMmapBackend::findLocked( core::StringView key, KvsDataType* out ) const noexcept
+    {
+        try {
+            Lookup state = findInBatches( m_pPending.get(), m_pSyncing.get(), key, out );
+            if ( state != Lookup::kMissing ) return core::Result< Lookup >::FromValue( state );
+
+            ReadTxn txn( *m_pEnv );
+            return findInTree( *m_pEnv, txn.State().root, txn.State().pageCount, key, out );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< Lookup >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::Vector< core::String > > KvsMmapBackend::GetAllKeys() const noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        try {
+            core::SharedHandle< const Batch > newer, older;
+            {
+                core::ReadLockGuard lock( m_rwLock );
+                newer = m_pPending;
+                older = m_pSyncing;
+            }
+
+            ReadTxn txn( *m_pEnv );
+            return collectKeys( *m_pEnv, txn.State().root, txn.State().pageCount, newer.get(), older.get() );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::UInt32 > KvsMmapBackend::GetKeyCount() const noexcept
+    {
+        using result = core::Result< core::UInt32 >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        // The meta page counts committed keys, pending changes need a merge
+        if ( !m_bOverlay.load( ::std::memory_order_acquire ) ) {
+            return result::FromValue( static_cast< core::UInt32 >( m_pEnv->load().entries ) );
+        }
+
+        auto keys = GetAllKeys();
+        if ( !keys.HasValue() ) return result::FromError( keys.Error() );
+        return result::FromValue( static_cast< core::UInt32 >( keys.Value().size() ) );
+    }
+
+    core::Result< core::Bool > KvsMmapBackend::KeyExists( core::StringView key ) const noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto state = find( key, nullptr );
+        if ( !state.HasValue() ) return result::FromError( state.Error() );
+        return result::FromValue( state.Value() == Lookup::kFound );
+    }
+
+    core::Result< KvsDataType > KvsMmapBackend::GetValue( core::StringView key ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType value;
+        auto state = find( key, &value );
+        if ( !state.HasValue() ) return result::FromError( state.Error() );
+        if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+
+        return result::FromValue( ::std::move( value ) );
+    }
+
+    core::Result< KvsDataType > KvsMmapBackend::GetValueHashed( core::StringView key, core::UInt64 ) const noexcept
+    {
+        // The tree is ordered by key, a hash does not shorten the search
+        return GetValue( key );
+    }
+
+    core::Result< core::Size > KvsMmapBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept
+    {
+        using result = core::Result< core::Size >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+        if ( !isKvsRawType( type ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        try {
+            if ( m_bOverlay.load( ::std::memory_order_acquire ) ) {
+                core::ReadLockGuard lock( m_rwLock );
+                KvsDataType value;
+                Lookup state = findInBatches( m_pPending.get(), m_pSyncing.get(), key, &value );
+                if ( state == Lookup::kDeleted ) return result::FromError( PerErrc::kKeyNotFound );
+                if ( state == Lookup::kFound ) {
+                    const core::Byte* data = nullptr;
+                    core::Size size = 0;
+                    if ( ::lap::core::GetVariantIndex( value ) != static_cast< core::Size >( type ) || !kvsRawBytes( value, data, size ) ) {
+                        return result::FromError( PerErrc::kDataTypeMismatch );
+                    }
+                    if ( size > buffer.size() ) return result::FromError( PerErrc::kWrongDataSize );
+                    if ( size > 0 ) ::std::memcpy( buffer.data(), data, size );
+                    return result::FromValue( size );
+                }
+            }
+
+            // Committed value: one copy from the mapped page into the caller's buffer
+            ReadTxn txn( *m_pEnv );
+            TreeReader tree = txn.Tree();
+            LeafCell cell;
+            core::Bool found = false;
+            if ( !tree.find( txn.State().root, key, cell, found ) ) return result::FromError( PerErrc::kIntegrityCorrupted );
+            if ( !found ) return result::FromError( PerErrc::kKeyNotFound );
+            if ( cell.type != type ) return result::FromError( PerErrc::kDataTypeMismatch );
+            if ( cell.valueSize > buffer.size() ) return result::FromError( PerErrc::kWrongDataSize );
+
+            const core::UInt8* data = tree.value( cell );
+            if ( nullptr == data ) return result::FromError( PerErrc::kIntegrityCorrupted );
+            if ( cell.valueSize > 0 ) ::std::memcpy( buffer.data(), data, cell.valueSize );
+            return result::FromValue( static_cast< core::Size >( cell.valueSize ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsMmapBackend::CreateSnapshot() const noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        try {
+            core::SharedHandle< const Batch > newer, older;
+            {
+                core::ReadLockGuard lock( m_rwLock );  // Pins handles only, no copy
+                if ( !m_pPending->empty() ) newer = m_pPending;
+                older = m_pSyncing;
+            }
+            // Pinned after the overlay, so a batch committed meanwhile is seen in one place or both
+            return result::FromValue( ::std::make_shared< Snapshot >( m_pEnv, ::std::move( newer ), ::std::move( older ) ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::UInt64 > KvsMmapBackend::GetSize() const noexcept
+    {
+        if ( !m_bAvailable ) return core::Result< core::UInt64 >::FromError( PerErrc::kNotInitialized );
+
+        struct stat info;
+        if ( ::fstat( m_pEnv->fd, &info ) != 0 ) return core::Result< core::UInt64 >::FromError( errnoToPerErrc( errno ) );
+        return core::Result< core::UInt64 >::FromValue( static_cast< core::UInt64 >( info.st_size ) );
+    }
+
+    core::UInt64 KvsMmapBackend::GetTransactionId() const noexcept
+    {
+        return m_pEnv ? m_pEnv->txn.load() : 0;
+    }
+
+    // ==================== Write path ====================
+
+    KvsMmapBackend::Batch& KvsMmapBackend::pending()
+    {
+        if ( m_pPending.use_count() > 1 ) m_pPending = ::std::make_shared< Batch >( *m_pPending );
+        return *m_pPending;
+    }
+
+    void KvsMmapBackend::updateOverlayFlag() noexcept
+    {
+        m_bOverlay.store( !m_pPending->empty() || ( m_pSyncing && !m_pSyncing->empty() ), ::std::memory_order_release );
+    }
+
+    core::Result< void > KvsMmapBackend::put( core::StringView key, Record&& record ) noexcept
+    {
+        if ( key.size() > MAX_KEY_SIZE ) return core::Result< void >::FromError( PerErrc::kInvalidKey );
+
+        try {
+            auto& records = pending().records;
+            auto it = records.find( key );
+            if ( it == records.end() ) {
+                records.emplace( core::String( key.data(), key.size() ), ::std::move( record ) );
+            } else {
+                it->second = ::std::move( record );
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        m_bOverlay.store( true, ::std::memory_order_release );
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsMmapBackend::SetValue( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        if ( !m_bAvailable ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        try {
+            return put( key, Record{ false, value } );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > KvsMmapBackend::SetValue( core::StringView key, KvsDataType &&value ) noexcept
+    {
+        if ( !m_bAvailable ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        return put( key, Record{ false, ::std::move( value ) } );
+    }
+
+    core::Result< void > KvsMmapBackend::RemoveKey( core::StringView key ) noexcept
+    {
+        if ( !m_bAvailable ) return core::Result< void >::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        return put( key, Record{ true, KvsDataType() } );
+    }
+
+    core::Result< void > KvsMmapBackend::RecoverKey( core::StringView key ) noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+
+        auto it = m_pPending->records.find( key );
+        if ( it == m_pPending->records.end() || !it->second.deleted ) return result::FromError( PerErrc::kKeyNotFound );
+
+        try {
+            auto& records = pending().records;
+            records.erase( records.find( key ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        updateOverlayFlag();
+        return result::FromValue();
+    }
+
+    core::Result< void > KvsMmapBackend::ResetKey( core::StringView key ) noexcept
+    {
+        return RemoveKey( key );
+    }
+
+    core::Result< void > KvsMmapBackend::RemoveAllKeys() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );
+        try {
+            Batch& batch = pending();
+            batch.records.clear();
+            batch.cleared = true;
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_bOverlay.store( true, ::std::memory_order_release );
+        return result::FromValue();
+    }
+
+    // ==================== Atomic Read-Modify-Write ====================
+
+    core::Result< KvsDataType > KvsMmapBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        KvsDataType previous;
+        if ( !kvsZeroValue( delta, previous ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            KvsDataType current;
+            auto state = findLocked( key, &current );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() == Lookup::kFound ) previous = ::std::move( current );
+
+            KvsDataType sum;
+            if ( !kvsAddValues( previous, delta, sum ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+            auto stored = put( key, Record{ false, ::std::move( sum ) } );
+            if ( !stored.HasValue() ) return result::FromError( stored.Error() );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( ::std::move( previous ) );
+    }
+
+    core::Result< core::Bool > KvsMmapBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            KvsDataType current;
+            auto state = findLocked( key, &current );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() != Lookup::kFound ) return result::FromError( PerErrc::kKeyNotFound );
+            if ( !( current == expected ) ) return result::FromValue( false );
+
+            auto stored = put( key, Record{ false, desired } );
+            if ( !stored.HasValue() ) return result::FromError( stored.Error() );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::Bool > KvsMmapBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::WriteLockGuard lock( m_rwLock );  // Read and write under one exclusive lock
+
+        try {
+            auto state = findLocked( key, nullptr );
+            if ( !state.HasValue() ) return result::FromError( state.Error() );
+            if ( state.Value() == Lookup::kFound ) return result::FromValue( false );
+
+            auto stored = put( key, Record{ false, value } );
+            if ( !stored.HasValue() ) return result::FromError( stored.Error() );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        return result::FromValue( true );
+    }
+
+    // ==================== Commit ====================
+
+    core::Result< void > KvsMmapBackend::SyncToStorage() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromError( PerErrc::kNotInitialized );
+
+        core::LockGuard< core::Mutex > syncLock( m_syncMutex );
+
+        try {
+            core::WriteLockGuard lock( m_rwLock );
+            if ( m_pPending->empty() ) return result::FromValue();  // No changes to sync
+
+            auto fresh  = ::std::make_shared< Batch >();
+            m_pSyncing  = ::std::move( m_pPending );
+            m_pPending  = ::std::move( fresh );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        // m_pSyncing no longer changes: build the new tree while readers and writers go on
+        Env& env = *m_pEnv;
+        const Env::State base = env.load();
+
+        const core::UInt64 oldest = env.oldestReader( base.txn );
+        while ( !m_free.pending.empty() && m_free.pending.front().first <= oldest ) {
+            auto& released = m_free.pending.front().second;
+            m_free.reusable.insert( m_free.reusable.end(), released.begin(), released.end() );
+            m_free.pending.pop_front();
+        }
+
+        result committed = result::FromValue();
+        try {
+            WriteTxn txn( env, base, m_free );
+            committed = txn.Apply( *m_pSyncing );
+            if ( committed.HasValue() ) committed = txn.Commit();
+            if ( committed.HasValue() ) m_free = ::std::move( txn.Free() );
+        } catch ( const ::std::bad_alloc& ) {
+            committed = result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        core::WriteLockGuard lock( m_rwLock );
+        if ( !committed.HasValue() ) {
+            // Keep the batch pending; changes made meanwhile are newer and win
+            try {
+                Batch& batch = pending();
+                if ( !batch.cleared ) {
+                    for ( const auto& item : m_pSyncing->records ) batch.records.emplace( item.first, item.second );
+                    batch.cleared = m_pSyncing->cleared;
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                LAP_PER_LOG_ERROR << "Kvs mmap backend lost a failed batch, out of memory: " << m_filePath;
+            }
+            LAP_PER_LOG_EVERY_N( ERROR, 16 ) << "Kvs mmap backend commit failed: " << m_filePath;
+        }
+        m_pSyncing.reset();
+        updateOverlayFlag();
+        return committed;
+    }
+
+    core::Result< void > KvsMmapBackend::DiscardPendingChanges() noexcept
+    {
+        using result = core::Result< void >;
+
+        if ( !m_bAvailable ) return result::FromValue();
+
+        core::LockGuard< core::Mutex > syncLock( m_syncMutex );
+        core::WriteLockGuard lock( m_rwLock );
+
+        try {
+            if ( m_pPending.use_count() > 1 ) {
+                m_pPending = ::std::make_shared< Batch >();
+            } else {
+                m_pPending->records.clear();
+                m_pPending->cleared = false;
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        updateOverlayFlag();
+        return result::FromValue();
+    }
+
+} // namespace per
+} // namespace lap
@@ -0,0 +1,303 @@
+/**
+ * @file CKvsNotifier.cpp
+ * @brief Change notifications for KeyValueStorage
+ * @version 1.0
+ * @date 2025-11-22
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <memory>
+
+#include "CKvsNotifier.hpp"
+
+namespace lap
+{
+namespace per
+{
+    core::Bool KvsNotifier::Subscription::matches( const core::String& key ) const noexcept
+    {
+        if ( key.empty() ) return true;         // store-wide change
+
+        if ( byPrefix ) return key.compare( 0, prefix.size(), prefix ) == 0;
+
+        return ::std::binary_search( keys.begin(), keys.end(), key );
+    }
+
+    KvsNotifier::KvsNotifier() noexcept
+    {
+        ;
+    }
+
+    KvsNotifier::~KvsNotifier() noexcept
+    {
+        {
+            core::LockGuard< core::Mutex > lock( m_waitMutex );
+            m_stop = true;
+        }
+        m_wakeup.notify_all();
+
+        if ( m_dispatcher.joinable() ) m_dispatcher.join();
+
+        while ( Node* node = pop() ) delete node;
+    }
+
+    core::Result< KvsSubscriptionId > KvsNotifier::Subscribe( core::StringView prefix, KvsChangeCallback callback ) noexcept
+    {
+        using result = core::Result< KvsSubscriptionId >;
+
+        if ( !callback ) return result::FromError( PerErrc::kInvalidArgument );
+
+        try {
+            auto subscription = ::std::make_shared< Subscription >();
+            subscription->byPrefix  = true;
+            subscription->prefix.assign( prefix.data(), prefix.size() );
+            subscription->callback  = ::std::move( callback );
+
+            return addSubscription( ::std::move( subscription ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< KvsSubscriptionId > KvsNotifier::Subscribe( const core::Vector< core::String >& keys, KvsChangeCallback callback ) noexcept
+    {
+        using result = core::Result< KvsSubscriptionId >;
+
+        if ( !callback || keys.empty() ) return result::FromError( PerErrc::kInvalidArgument );
+
+        try {
+            auto subscription = ::std::make_shared< Subscription >();
+            subscription->byPrefix  = false;
+            subscription->keys      = keys;
+            subscription->callback  = ::std::move( callback );
+            ::std::sort( subscription->keys.begin(), subscription->keys.end() );
+
+            return addSubscription( ::std::move( subscription ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< KvsSubscriptionId > KvsNotifier::addSubscription( core::SharedHandle< Subscription > subscription ) noexcept
+    {
+        using result = core::Result< KvsSubscriptionId >;
+
+        core::LockGuard< core::Mutex > lock( m_subscriptionMutex );
+
+        if ( !m_dispatcher.joinable() && !startDispatcher() ) return result::FromError( PerErrc::kResourceBusy );
+
+        try {
+            subscription->id = m_nextId++;
+            m_subscriptions.push_back( subscription );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        m_subscriberCount.fetch_add( 1, ::std::memory_order_release );
+
+        return result::FromValue( subscription->id );
+    }
+
+    core::Result< void > KvsNotifier::Unsubscribe( KvsSubscriptionId id ) noexcept
+    {
+        using result = core::Result< void >;
+
+        {
+            core::LockGuard< core::Mutex > lock( m_subscriptionMutex );
+
+            auto it = ::std::find_if( m_subscriptions.begin(), m_subscriptions.end(),
+                                      [id]( const core::SharedHandle< Subscription >& s ) { return s->id == id; } );
+            if ( it == m_subscriptions.end() ) return result::FromError( PerErrc::kInvalidArgument );
+
+            ( *it )->active.store( false, ::std::memory_order_release );
+            m_subscriptions.erase( it );
+            m_subscriberCount.fetch_sub( 1, ::std::memory_order_release );
+        }
+
+        // Wait out a dispatch that may already hold the subscription; a callback
+        // unsubscribing itself must not wait for its own dispatch
+        if ( ::std::this_thread::get_id() != m_dispatcherId.load( ::std::memory_order_acquire ) ) {
+            core::LockGuard< core::Mutex > lock( m_dispatchMutex );
+        }
+
+        return result::FromValue();
+    }
+
+    void KvsNotifier::Publish( core::StringView key, KvsChangeType type ) noexcept
+    {
+        Node* node = nullptr;
+        try {
+            node = new Node;
+            node->key.assign( key.data(), key.size() );
+            node->type = type;
+        } catch ( const ::std::bad_alloc& ) {
+            delete node;
+            LAP_PER_LOG_EVERY_N( WARN, 64 ) << "Kvs change notification dropped, out of memory";
+            return;
+        }
+
+        m_published.fetch_add( 1, ::std::memory_order_relaxed );
+        push( node );
+
+        if ( !m_signaled.exchange( true, ::std::memory_order_acq_rel ) ) {
+            core::LockGuard< core::Mutex > lock( m_waitMutex );
+            m_wakeup.notify_one();
+        }
+    }
+
+    void KvsNotifier::Flush() noexcept
+    {
+        const ::std::thread::id dispatcher = m_dispatcherId.load( ::std::memory_order_acquire );
+        if ( dispatcher == ::std::thread::id() || ::std::this_thread::get_id() == dispatcher ) return;
+
+        const core::UInt64 target = m_published.load( ::std::memory_order_relaxed );
+
+        ::std::unique_lock< core::Mutex > lock( m_waitMutex );
+        m_drained.wait( lock, [this, target]() { return m_stop || m_delivered >= target; } );
+    }
+
+    core::Bool KvsNotifier::startDispatcher() noexcept
+    {
+        try {
+            m_dispatcher = ::std::thread( &KvsNotifier::dispatchLoop, this );
+            m_dispatcherId.store( m_dispatcher.get_id(), ::std::memory_order_release );
+        } catch ( const ::std::system_error& e ) {
+            LAP_PER_LOG_ERROR << "Kvs notifier thread start failed: " << e.what();
+            return false;
+        }
+
+        return true;
+    }
+
+    void KvsNotifier::push( Node* node ) noexcept
+    {
+        node->next.store( nullptr, ::std::memory_order_relaxed );
+        Node* prev = m_head.exchange( node, ::std::memory_order_acq_rel );
+        prev->next.store( node, ::std::memory_order_release );
+    }
+
+    KvsNotifier::Node* KvsNotifier::pop() noexcept
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load( ::std::memory_order_acquire );
+
+        if ( tail == &m_stub ) {
+            if ( next == nullptr ) return nullptr;
+            m_tail  = next;
+            tail    = next;
+            next    = next->next.load( ::std::memory_order_acquire );
+        }
+
+        if ( next != nullptr ) {
+            m_tail = next;
+            return tail;
+        }
+
+        // tail is the last linked node: leave it in place unless no producer is mid-push
+        if ( tail != m_head.load( ::std::memory_order_acquire ) ) return nullptr;
+
+        push( &m_stub );
+
+        next = tail->next.load( ::std::memory_order_acquire );
+        if ( next != nullptr ) {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    void KvsNotifier::dispatchLoop() noexcept
+    {
+        core::Vector< KvsChangeEvent >                  batch;
+        core::UnorderedMap< core::String, core::Size >  position;
+        core::Vector< core::SharedHandle< Subscription > > targets;
+
+        for ( ;; ) {
+            {
+                ::std::unique_lock< core::Mutex > lock( m_waitMutex );
+                m_wakeup.wait( lock, [this]() { return m_stop || m_signaled.load( ::std::memory_order_acquire ); } );
+                if ( m_stop ) break;
+            }
+
+            m_signaled.exchange( false, ::std::memory_order_acq_rel );
+
+            // Coalesce: the latest change of a key wins, a store-wide change supersedes earlier ones
+            core::UInt64 drained = 0;
+            batch.clear();
+            position.clear();
+            try {
+                while ( Node* raw = pop() ) {
+                    ::std::unique_ptr< Node > node( raw );     // Freed on every path, bad_alloc included
+                    ++drained;
+                    if ( node->key.empty() ) {
+                        batch.clear();
+                        position.clear();
+                        batch.push_back( KvsChangeEvent{ ::std::move( node->key ), node->type } );
+                    } else {
+                        auto it = position.find( node->key );
+                        if ( it != position.end() ) {
+                            batch[ it->second ].type = node->type;
+                        } else {
+                            position.emplace( node->key, batch.size() );
+                            batch.push_back( KvsChangeEvent{ ::std::move( node->key ), node->type } );
+                        }
+                    }
+                }
+
+                {
+                    core::LockGuard< core::Mutex > lock( m_subscriptionMutex );
+                    targets = m_subscriptions;
+                }
+            } catch ( const ::std::bad_alloc& ) {
+                // The per-key events of this drain are lost: replace them by one store-wide kReload,
+                // which tells every subscriber to re-read. Needs no allocation once batch has capacity.
+                while ( Node* raw = pop() ) {
+                    delete raw;
+                    ++drained;
+                }
+                batch.clear();
+                position.clear();
+                if ( batch.capacity() > 0 ) batch.push_back( KvsChangeEvent{ core::String(), KvsChangeType::kReload } );
+                try {
+                    core::LockGuard< core::Mutex > lock( m_subscriptionMutex );
+                    targets = m_subscriptions;
+                } catch ( const ::std::bad_alloc& ) {
+                    targets.clear();
+                }
+                LAP_PER_LOG_EVERY_N( WARN, 64 ) << "Kvs change notifications coalesced into a reload, out of memory";
+            }
+
+            {
+                core::LockGuard< core::Mutex > lock( m_dispatchMutex );
+                for ( const auto& event : batch ) {
+                    for ( const auto& subscription : targets ) {
+                        if ( !subscription->active.load( ::std::memory_order_acquire ) || !subscription->matches( event.key ) ) continue;
+
+                        try {
+                            subscription->callback( event );
+                        } catch ( const ::std::exception& e ) {
+                            LAP_PER_LOG_WARN << "Kvs change callback threw: " << e.what();
+                        } catch ( ... ) {
+                            LAP_PER_LOG_WARN << "Kvs change callback threw";
+                        }
+                    }
+                }
+            }
+            targets.clear();
+
+            {
+                core::LockGuard< core::Mutex > lock( m_waitMutex );
+                m_delivered += drained;
+            }
+            m_drained.notify_all();
+        }
+
+        // Release Flush() waiters on shutdown
+        m_drained.notify_all();
+    }
+
+} // namespace per
+} // namespace lap
@@ -5,16 +5,22 @@
 #include <boost/interprocess/allocators/allocator.hpp>
 #include <boost/functional/hash.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <unistd.h>  // for getpid()
 #include <cctype>    // for std::isalnum()
 
+#include <lap/core/CSync.hpp>
+
 #include "IKvsBackend.hpp"
 #include "CKvsPropertyBackend.hpp"
 #include "CKvsFileBackend.hpp"
 #include "CKvsSqliteBackend.hpp"
+#include "CKvsKey.hpp"
 
 namespace lap
 {
@@ -38,16 +44,105 @@ namespace util
         using SHM_Map = ::boost::unordered_map< K, V, Hash, Cmp, SHM_Alloc< std::pair< K const, V > > >;
 
         // Solution B: Simplified hash/equal - no prefix handling needed
+        // FNV-1a (kvsKeyHash) so a KvsKey's compile-time hash addresses the same bucket
         struct SHM_Hash : boost::hash_detail::hash_base< SHM_String >
         {
             core::Size operator()( SHM_String const& val ) const
             {
                 // Direct hash - no need to skip prefix
-                return ::boost::hash_range( val.begin(), val.end() );
+                return static_cast< core::Size >( kvsKeyHash( core::StringView( val.data(), val.size() ) ) );
+            }
+        };
+
+        // Interned text: key prefixes and long string values, stored once per map and reference counted
+        struct SHM_Interned
+        {
+            core::UInt64                        refs{ 0 };
+            core::UInt64                        hash{ 0 };  // kvsKeyHash of the text, continued by key suffixes
+        };
+
+        using SHM_StringPool = SHM_Map< SHM_String, SHM_Interned, SHM_Hash >;
+        using SHM_PoolEntry = SHM_StringPool::value_type;
+
+        // Stored keys: "\x01" + handle of the interned prefix + suffix, or the key itself
+        // ("\x00" escaped when it starts with either marker). One form per key, so stored keys
+        // compare equal exactly when the keys do
+        constexpr core::Char KEY_PREFIXED = '\x01';
+        constexpr core::Char KEY_ESCAPED = '\x00';
+        // Stored values: '@' + handle of the interned text for long strings, '#' alone for a value
+        // evicted to the persistence backend, the encoding otherwise
+        constexpr core::Char VALUE_INTERNED = '@';
+        constexpr core::Char VALUE_EVICTED = '#';
+
+        using SHM_Handle = SHM_Segment::handle_t;
+        constexpr core::Size HANDLE_SIZE = sizeof( SHM_Handle );
+        // Segment strings keep up to 22 characters inline; longer text is a separate block
+        constexpr core::Size INLINE_CAPACITY = 22;
+
+        struct SHM_KeyParts
+        {
+            const SHM_PoolEntry*                prefix{ nullptr };
+            core::StringView                    rest;       // Suffix, or the whole key without a prefix
+        };
+
+        SHM_KeyParts keyParts( SHM_String const& stored );
+
+        struct SHM_KeyHash : boost::hash_detail::hash_base< SHM_String >
+        {
+            core::Size operator()( SHM_String const& stored ) const
+            {
+                auto parts = keyParts( stored );
+                return static_cast< core::Size >( parts.prefix != nullptr ? kvsKeyHash( parts.rest, parts.prefix->second.hash )
+                                                                          : kvsKeyHash( parts.rest ) );
             }
         };
 
-        using SHM_MapValue = SHM_Map< SHM_String, SHM_String, SHM_Hash >;
+        // Mapped value: stored form plus the eviction bookkeeping of a memory budget
+        struct SHM_Value
+        {
+            SHM_Value( SHM_String&& stored ) noexcept : data( ::std::move( stored ) ) {}
+            SHM_Value( SHM_Value&& other ) noexcept : data( ::std::move( other.data ) ), lastUse( other.lastUse.load() ), dirty( other.dirty ), syncRound( other.syncRound ) {}
+            SHM_Value( const SHM_Value& other ) : data( other.data ), lastUse( other.lastUse.load() ), dirty( other.dirty ), syncRound( other.syncRound ) {}
+
+            SHM_String                          data;
+            mutable ::std::atomic< core::UInt64 > lastUse{ 0 };    // Access tick, stamped by readers under the shared lock
+            core::Bool                          dirty{ true };      // Not yet in the persistence backend
+            core::UInt64                        syncRound{ 0 };     // Incremental sync round that staged this value, 0 once changed
+        };
+
+        using SHM_MapValue = SHM_Map< SHM_String, SHM_Value, SHM_KeyHash >;
+
+        // Heterogeneous lookup: probe with a StringView and a known hash, no key copy into the segment
+        struct SHM_KnownHash
+        {
+            core::UInt64                        hash;
+            core::Size operator()( core::StringView ) const     { return static_cast< core::Size >( hash ); }
+        };
+
+        struct SHM_TextEqual
+        {
+            core::Bool operator()( core::StringView lhs, SHM_String const& rhs ) const
+            {
+                return lhs.size() == rhs.size() && ::std::memcmp( lhs.data(), rhs.data(), lhs.size() ) == 0;
+            }
+            core::Bool operator()( SHM_String const& lhs, core::StringView rhs ) const  { return ( *this )( rhs, lhs ); }
+        };
+
+        struct SHM_ViewEqual
+        {
+            core::Bool operator()( core::StringView lhs, SHM_String const& rhs ) const
+            {
+                auto parts = keyParts( rhs );
+                if ( parts.prefix == nullptr ) {
+                    return lhs == parts.rest;
+                }
+                const auto& prefix = parts.prefix->first;
+                return lhs.size() == prefix.size() + parts.rest.size() &&
+                       ::std::memcmp( lhs.data(), prefix.data(), prefix.size() ) == 0 &&
+                       lhs.substr( prefix.size() ) == parts.rest;
+            }
+            core::Bool operator()( SHM_String const& lhs, core::StringView rhs ) const  { return ( *this )( rhs, lhs ); }
+        };
 
         struct SHMContext
         {
@@ -55,7 +150,226 @@ namespace util
             core::String                        shmName;  // Generated from strFile
             SHM_Segment                         segment;
             SHM_MapValue*                       mapValue{ nullptr };
+            SHM_StringPool*                     strings{ nullptr };    // Interned text referenced by mapValue
+            core::RWLock                        rwLock;     // Guards mapValue and strings, shared by all instances of the process
+            core::UInt64                        version{ 0 };   // Bumped on every mapValue change, guarded by rwLock
+            KvsSnapshotCache                    snapshots;      // Told of every mapValue change under rwLock
+            ::std::atomic< core::UInt64 >       clock{ 0 };     // Source of SHM_Value::lastUse, per process
+            core::Size                          resident{ 0 };  // Values of mapValue not evicted, guarded by rwLock
         } context;
+
+        inline const SHM_PoolEntry* entryOf( const core::Char* handle )
+        {
+            SHM_Handle offset;
+            ::std::memcpy( &offset, handle, HANDLE_SIZE );
+            return static_cast< const SHM_PoolEntry* >( context.segment.get_address_from_handle( offset ) );
+        }
+
+        inline void appendHandle( SHM_String& out, const SHM_PoolEntry& entry )
+        {
+            SHM_Handle offset = context.segment.get_handle_from_address( &entry );
+            out.append( reinterpret_cast< const core::Char* >( &offset ), HANDLE_SIZE );
+        }
+
+        SHM_KeyParts keyParts( SHM_String const& stored )
+        {
+            if ( !stored.empty() && stored[0] == KEY_PREFIXED ) {
+                return { entryOf( stored.data() + 1 ), core::StringView( stored.data() + 1 + HANDLE_SIZE, stored.size() - 1 - HANDLE_SIZE ) };
+            }
+            if ( !stored.empty() && stored[0] == KEY_ESCAPED ) {
+                return { nullptr, core::StringView( stored.data() + 1, stored.size() - 1 ) };
+            }
+            return { nullptr, core::StringView( stored.data(), stored.size() ) };
+        }
+
+        inline core::String keyString( SHM_String const& stored )
+        {
+            auto parts = keyParts( stored );
+            core::String key;
+            if ( parts.prefix != nullptr ) {
+                key.reserve( parts.prefix->first.size() + parts.rest.size() );
+                key.assign( parts.prefix->first.data(), parts.prefix->first.size() );
+            }
+            key.append( parts.rest.data(), parts.rest.size() );
+            return key;
+        }
+
+        // Take a reference to the interned copy of text, interning it on first use
+        inline const SHM_PoolEntry& acquire( core::StringView text )
+        {
+            const core::UInt64 hash = kvsKeyHash( text );
+            auto it = context.strings->find( text, SHM_KnownHash{ hash }, SHM_TextEqual{} );
+            if ( it == context.strings->end() ) {
+                it = context.strings->emplace( SHM_String( text.data(), text.size(), context.segment.get_segment_manager() ),
+                                               SHM_Interned{ 0, hash } ).first;
+            }
+            ++it->second.refs;
+            return *it;
+        }
+
+        inline void release( const SHM_PoolEntry& entry )
+        {
+            auto& refs = const_cast< SHM_PoolEntry& >( entry ).second.refs;
+            if ( --refs == 0 ) {
+                context.strings->erase( context.strings->find( core::StringView( entry.first.data(), entry.first.size() ),
+                                                               SHM_KnownHash{ entry.second.hash }, SHM_TextEqual{} ) );
+            }
+        }
+
+        // Stored form of a new key, holding a reference to its prefix when it has a long one
+        SHM_String makeKey( core::StringView key )
+        {
+            SHM_String stored( context.segment.get_segment_manager() );
+            const auto separator = key.find_last_of( "./" );
+            if ( separator != core::StringView::npos && separator + 1 > HANDLE_SIZE ) {
+                const auto& prefix = acquire( key.substr( 0, separator + 1 ) );
+                try {
+                    const auto suffix = key.substr( separator + 1 );
+                    stored.reserve( 1 + HANDLE_SIZE + suffix.size() );
+                    stored.push_back( KEY_PREFIXED );
+                    appendHandle( stored, prefix );
+                    stored.append( suffix.data(), suffix.size() );
+                } catch ( ... ) {
+                    release( prefix );
+                    throw;
+                }
+            } else {
+                if ( !key.empty() && ( key[0] == KEY_PREFIXED || key[0] == KEY_ESCAPED ) ) {
+                    stored.push_back( KEY_ESCAPED );
+                }
+                stored.append( key.data(), key.size() );
+            }
+            return stored;
+        }
+
+        inline void releaseKey( SHM_String const& stored )
+        {
+            auto parts = keyParts( stored );
+            if ( parts.prefix != nullptr ) release( *parts.prefix );
+        }
+
+        inline void releaseValue( SHM_String const& stored )
+        {
+            if ( !stored.empty() && stored[0] == VALUE_INTERNED ) release( *entryOf( stored.data() + 1 ) );
+        }
+
+        // Type marker and, for strings, the text of a stored value
+        inline core::Char valueMarker( SHM_String const& stored )
+        {
+            if ( stored.empty() ) return '\0';
+            return stored[0] == VALUE_INTERNED ? static_cast< core::Char >( 'a' + static_cast< core::UInt32 >( EKvsDataTypeIndicate::DataType_string ) ) : stored[0];
+        }
+
+        inline core::StringView stringText( SHM_String const& stored )
+        {
+            if ( stored[0] == VALUE_INTERNED ) {
+                const auto& text = entryOf( stored.data() + 1 )->first;
+                return core::StringView( text.data(), text.size() );
+            }
+            return core::StringView( stored.data() + 1, stored.size() - 1 );
+        }
+
+        inline SHM_MapValue::iterator findKey( core::StringView key, core::UInt64 hash )
+        {
+            return context.mapValue->find( key, SHM_KnownHash{ hash }, SHM_ViewEqual{} );
+        }
+
+        SHM_String encodeValue( const KvsDataType &value );
+
+        // Stored form of a value: long strings become a reference to their interned text
+        SHM_String storedValue( const KvsDataType &value )
+        {
+            if ( ::lap::core::GetVariantIndex( value ) == static_cast< core::Size >( EKvsDataTypeIndicate::DataType_string ) ) {
+                const auto& text = ::lap::core::get< core::String >( value );
+                if ( 1 + text.size() > INLINE_CAPACITY ) {
+                    const auto& entry = acquire( core::StringView( text.data(), text.size() ) );
+                    SHM_String stored( context.segment.get_segment_manager() );
+                    stored.push_back( VALUE_INTERNED );
+                    appendHandle( stored, entry );      // Fits inline, cannot throw
+                    return stored;
+                }
+            }
+            return encodeValue( value );
+        }
+
+        inline void touch( const SHM_Value& slot )
+        {
+            slot.lastUse.store( context.clock.fetch_add( 1, ::std::memory_order_relaxed ) + 1, ::std::memory_order_relaxed );
+        }
+
+        inline core::Bool isEvicted( const SHM_Value& slot )
+        {
+            return slot.data.size() == 1 && slot.data[0] == VALUE_EVICTED;
+        }
+
+        // Replace a stored value, the old one's reference is dropped only once the new one exists
+        inline void assignValue( SHM_Value& slot, const KvsDataType &value )
+        {
+            SHM_String stored = storedValue( value );
+            if ( isEvicted( slot ) ) ++context.resident;
+            releaseValue( slot.data );
+            slot.data = ::std::move( stored );
+            slot.dirty = true;
+            slot.syncRound = 0;
+            touch( slot );
+        }
+
+        // Drop a value from the segment, the persistence backend holds it
+        inline void evictValue( SHM_Value& slot )
+        {
+            releaseValue( slot.data );
+            slot.data.assign( 1, VALUE_EVICTED );     // Fits inline, cannot throw
+            --context.resident;
+        }
+
+        inline void eraseEntry( SHM_MapValue::iterator it )
+        {
+            if ( !isEvicted( it->second ) ) --context.resident;
+            releaseKey( it->first );
+            releaseValue( it->second.data );
+            context.mapValue->erase( it );
+        }
+
+        inline void clearEntries()
+        {
+            context.mapValue->clear();
+            context.strings->clear();
+            context.resident = 0;
+        }
+
+        inline core::Size segmentBytesUsed()
+        {
+            return context.segment.get_size() - context.segment.get_free_memory();
+        }
+
+        // Store a value, copying the key into the segment only for a new key
+        inline SHM_Value& storeValue( core::StringView key, core::UInt64 hash, const KvsDataType &value )
+        {
+            auto&& it = findKey( key, hash );
+            if ( it != context.mapValue->end() ) {
+                assignValue( it->second, value );
+                return it->second;
+            }
+
+            // Buckets first: once both strings exist only the node allocation can fail, before they are moved
+            context.mapValue->reserve( context.mapValue->size() + 1 );
+            SHM_String stored = storedValue( value );
+            try {
+                SHM_String storedKey = makeKey( key );
+                try {
+                    auto& slot = context.mapValue->emplace( ::std::move( storedKey ), ::std::move( stored ) ).first->second;
+                    ++context.resident;
+                    touch( slot );
+                    return slot;
+                } catch ( ... ) {
+                    releaseKey( storedKey );
+                    throw;
+                }
+            } catch ( ... ) {
+                releaseValue( stored );
+                throw;
+            }
+        }
         
         // Generate shared memory name from file parameter
         inline core::String generateShmName(core::StringView strFile) {
@@ -87,6 +401,22 @@ namespace util
         // This eliminates the need for type prefix in key names
         SHM_String encodeValue( const KvsDataType &value )
         {
+            // Blob / arrays: [type_byte][UInt32 byte length, little-endian][raw bytes] written straight into shared memory
+            const core::Byte* rawData = nullptr;
+            core::Size rawSize = 0;
+            if ( kvsRawBytes( value, rawData, rawSize ) ) {
+                const core::UInt32 length = static_cast< core::UInt32 >( rawSize );
+
+                SHM_String encoded( shm::context.segment.get_segment_manager() );
+                encoded.reserve( 1 + sizeof( length ) + rawSize );
+                encoded.push_back( static_cast< core::Char >( 'a' + ::lap::core::GetVariantIndex( value ) ) );
+                for ( core::UInt32 shift = 0; shift < 32; shift += 8 ) {
+                    encoded.push_back( static_cast< core::Char >( ( length >> shift ) & 0xFF ) );
+                }
+                encoded.append( reinterpret_cast< const core::Char* >( rawData ), rawSize );
+                return encoded;
+            }
+
             std::ostringstream oss;
             
             // 1. Write type marker (1 byte: 'a' + type_index)
@@ -135,9 +465,29 @@ namespace util
             case EKvsDataTypeIndicate::DataType_string: // String
                 oss << ::lap::core::get< core::String >( value );
                 break;
+            default: // Blob / arrays (handled above)
+                break;
             }
             
-            return SHM_String( oss.str().c_str(), shm::context.segment.get_segment_manager() );
+            const std::string encoded = oss.str();
+            return SHM_String( encoded.data(), encoded.size(), shm::context.segment.get_segment_manager() );
+        }
+
+        // Locate the payload of a length-prefixed raw value, returns its byte length
+        core::Size rawPayload( const SHM_String &encoded, const core::Byte* &bytes )
+        {
+            if ( encoded.size() < 1 + sizeof( core::UInt32 ) ) {
+                throw std::runtime_error("Truncated raw value header");
+            }
+            core::UInt32 length = 0;
+            for ( core::UInt32 i = 0; i < sizeof( length ); ++i ) {
+                length |= static_cast< core::UInt32 >( static_cast< core::UInt8 >( encoded[1 + i] ) ) << ( 8 * i );
+            }
+            if ( encoded.size() - 1 - sizeof( length ) != length ) {
+                throw std::runtime_error("Raw value length mismatch");
+            }
+            bytes = reinterpret_cast< const core::Byte* >( encoded.data() + 1 + sizeof( length ) );
+            return length;
         }
 
         // New decoding function: Extract type marker and parse data
@@ -148,11 +498,29 @@ namespace util
             }
             
             // 1. Extract type marker (first byte)
-            char typeMarker = encoded[0];
+            char typeMarker = valueMarker( encoded );
             EKvsDataTypeIndicate type = static_cast<EKvsDataTypeIndicate>(typeMarker - 'a');
             
-            // 2. Extract data string (skip first byte)
-            std::string dataStr(encoded.c_str() + 1);
+            // Blob / arrays: length-prefixed raw bytes
+            if ( isKvsRawType( type ) ) {
+                const core::Byte* bytes = nullptr;
+                core::Size length = rawPayload( encoded, bytes );
+
+                KvsDataType value;
+                if ( !kvsFromRawBytes( type, bytes, length, value ) ) {
+                    throw std::runtime_error("Array length mismatch");
+                }
+                return value;
+            }
+
+            // Strings: build the value straight from the payload, no temporary
+            if ( type == EKvsDataTypeIndicate::DataType_string ) {
+                auto text = stringText( encoded );
+                return core::String( text.data(), text.size() );
+            }
+
+            // 2. Extract data string (skip first byte, size-aware so embedded NULs survive)
+            std::string dataStr(encoded.data() + 1, encoded.size() - 1);
             
             // 3. Parse according to type
             switch( type ) {
@@ -178,25 +546,71 @@ namespace util
                 return ::std::stof( dataStr );
             case EKvsDataTypeIndicate::DataType_double: // Double
                 return ::std::stod( dataStr );
-            case EKvsDataTypeIndicate::DataType_string: // String
-                return core::String( dataStr );
+            default: // String / blob / arrays (handled above)
+                break;
             }
 
             return false;
         }
     }
 
+    namespace
+    {
+        /**
+         * @brief Stores the batches exported by the persistence backend straight into shared memory
+         * @note The caller holds the map lock exclusively, or owns the segment during construction
+         */
+        class ShmLoadSink final : public IKvsRecordSink
+        {
+        public:
+            // budget: segment bytes kept resident, values beyond it are stored evicted; 0 for no limit
+            explicit ShmLoadSink( core::Size budget ) noexcept : m_budget( budget ) {}
+
+            core::Result< void > Begin( core::UInt64 expectedRecords ) noexcept override
+            {
+                try {
+                    // One rehash up front instead of one per doubling
+                    shm::context.mapValue->reserve( shm::context.mapValue->size() + expectedRecords );
+                } catch ( const std::exception& ) {
+                    // Buckets for every key don't fit the segment: grow on demand, storeValue() reports a real shortage
+                }
+                return core::Result< void >::FromValue();
+            }
+
+            core::Result< void > Write( const KvsRecordBatch& batch ) noexcept override
+            {
+                try {
+                    for ( const auto& record : batch ) {
+                        auto& slot = shm::storeValue( record.key, kvsKeyHash( record.key ), record.value );
+                        slot.dirty = false;
+                        if ( m_budget > 0 && shm::segmentBytesUsed() > m_budget ) {
+                            shm::evictValue( slot );  // Keys beyond the budget start cold
+                        }
+                    }
+                } catch( const std::exception& e ) {
+                    LAP_PER_LOG_ERROR << "Exception during load from persistence: " << e.what();
+                    return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+                }
+                return core::Result< void >::FromValue();
+            }
+
+        private:
+            core::Size  m_budget;
+        };
+    } // namespace
+
     // Remove all commented remote namespace code
     
     core::Result< core::Vector< core::String > > KvsPropertyBackend::GetAllKeys() const noexcept
     {
         using result = core::Result< core::Vector< core::String > >;
+        core::ReadLockGuard lock( shm::context.rwLock );
 
         core::Vector< core::String > value;
         try {
             // Solution B: No need to skip prefix, key names are original
             for ( auto&& it = shm::context.mapValue->begin(); it != shm::context.mapValue->end(); ++it ) {
-                value.emplace_back( it->first.c_str() );  // Direct return, no +2 offset
+                value.emplace_back( shm::keyString( it->first ) );
             }
         } catch( const std::exception& e ) {
             LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetAllKeys: " << core::StringView(e.what());
@@ -209,9 +623,9 @@ namespace util
     core::Result< core::Bool > KvsPropertyBackend::KeyExists ( core::StringView key ) const noexcept
     {
         using result = core::Result< core::Bool >;
+        core::ReadLockGuard lock( shm::context.rwLock );
         try {
-            auto&& shmKey = shm::SHM_String( key.data(), shm::context.segment.get_segment_manager() );
-            auto&& it = shm::context.mapValue->find( shmKey );
+            auto&& it = shm::findKey( key, kvsKeyHash( key ) );
 
             if ( it != shm::context.mapValue->end() ) {
                 return result::FromValue( true );
@@ -225,43 +639,258 @@ namespace util
     }
 
     core::Result< KvsDataType > KvsPropertyBackend::GetValue( core::StringView key ) const noexcept
+    {
+        return GetValueHashed( key, kvsKeyHash( key ) );
+    }
+
+    core::Result< KvsDataType > KvsPropertyBackend::GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept
     {
         using result = core::Result< KvsDataType >;
+        {
+            core::ReadLockGuard lock( shm::context.rwLock );
 
-        try {
-            // Use original key name (no type prefix needed)
-            auto&& it = shm::context.mapValue->find( shm::SHM_String( key.data(), shm::context.segment.get_segment_manager() ) );
+            try {
+                // Use original key name (no type prefix needed)
+                auto&& it = shm::findKey( key, hash );
 
+                if ( it == shm::context.mapValue->end() ) {
+                    return core::Result<KvsDataType>::FromError( PerErrc::kKeyNotFound );
+                }
+
+                if ( !shm::isEvicted( it->second ) ) {
+                    noteHit( &it->second );
+                    // Decode value (type is stored in value itself)
+                    return result::FromValue( shm::decodeValue( it->second.data ) );
+                }
+            } catch(const std::exception& e) {
+                LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetValue: " << core::StringView(e.what());
+                return result::FromError( PerErrc::kNotInitialized );
+            }
+        }
+
+        return faultIn( key, hash );
+    }
+
+    void* KvsPropertyBackend::locateNode( const KvsKeyHandle& handle ) const
+    {
+        void* node = cachedNode( handle, m_generation );
+        if ( nullptr == node ) {
+            auto&& it = shm::findKey( handle.Name(), handle.Hash() );
             if ( it == shm::context.mapValue->end() ) {
-                return core::Result<KvsDataType>::FromError( PerErrc::kKeyNotFound );
+                return nullptr;
             }
-            
-            // Decode value (type is stored in value itself)
-            return result::FromValue( shm::decodeValue( it->second ) );
+            // unordered_map nodes keep their address across rehash, only erase frees them
+            node = &*it;
+            cacheNode( handle, node, m_generation );
+        }
+        return node;
+    }
+
+    void KvsPropertyBackend::ResolveKey( const KvsKeyHandle& handle ) const noexcept
+    {
+        core::ReadLockGuard lock( shm::context.rwLock );
+
+        try {
+            locateNode( handle );
         } catch(const std::exception& e) {
-            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetValue: " << core::StringView(e.what());
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::ResolveKey: " << core::StringView(e.what());
+        }
+    }
+
+    core::Result< KvsDataType > KvsPropertyBackend::GetValueResolved( const KvsKeyHandle& handle ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+        {
+            core::ReadLockGuard lock( shm::context.rwLock );
+
+            try {
+                auto* node = static_cast< shm::SHM_MapValue::value_type* >( locateNode( handle ) );
+                if ( nullptr == node ) {
+                    return result::FromError( PerErrc::kKeyNotFound );
+                }
+
+                if ( !shm::isEvicted( node->second ) ) {
+                    noteHit( &node->second );
+                    return result::FromValue( shm::decodeValue( node->second.data ) );
+                }
+            } catch(const std::exception& e) {
+                LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetValueResolved: " << core::StringView(e.what());
+                return result::FromError( PerErrc::kNotInitialized );
+            }
+        }
+
+        return faultIn( handle.Name(), handle.Hash() );
+    }
+
+    core::Result<void> KvsPropertyBackend::SetValueResolved( const KvsKeyHandle& handle, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result<void>;
+        core::WriteLockGuard lock( shm::context.rwLock );
+
+        try {
+            auto* node = static_cast< shm::SHM_MapValue::value_type* >( locateNode( handle ) );
+            if ( nullptr == node ) {
+                // New key: insert by name, the next access caches the node
+                shm::storeValue( handle.Name(), handle.Hash(), value );
+                m_bDirty = true;
+                ++shm::context.version;
+                shm::context.snapshots.Changed( handle.Name() );
+                enforceBudget();
+                return result::FromValue();
+            }
+
+            shm::assignValue( node->second, value );
+            m_bDirty = true;  // Mark as dirty for sync
+            ++shm::context.version;
+            shm::context.snapshots.Changed( handle.Name() );
+            enforceBudget();
+        } catch(const std::exception& e) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::SetValueResolved: " << core::StringView(e.what());
             return result::FromError( PerErrc::kNotInitialized );
         }
+        return result::FromValue();
+    }
+
+    core::Result<void> KvsPropertyBackend::GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept
+    {
+        using result = core::Result<void>;
+        const auto type = static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( out ) );
+        const core::UInt64 hash = kvsKeyHash( key );
+        {
+            core::ReadLockGuard lock( shm::context.rwLock );
+
+            try {
+                auto&& it = shm::findKey( key, hash );
+
+                if ( it == shm::context.mapValue->end() ) {
+                    return result::FromError( PerErrc::kKeyNotFound );
+                }
+
+                if ( !shm::isEvicted( it->second ) ) {
+                    noteHit( &it->second );
+
+                    const auto& encoded = it->second.data;
+                    if ( shm::valueMarker( encoded ) != static_cast< core::Char >( 'a' + static_cast< core::UInt32 >( type ) ) ) {
+                        return result::FromError( PerErrc::kDataTypeMismatch );
+                    }
+
+                    // Strings and raw values are assigned in place, keeping the caller's capacity
+                    if ( type == EKvsDataTypeIndicate::DataType_string ) {
+                        auto text = shm::stringText( encoded );
+                        ::lap::core::get< core::String >( out ).assign( text.data(), text.size() );
+                    } else if ( isKvsRawType( type ) ) {
+                        const core::Byte* bytes = nullptr;
+                        core::Size length = shm::rawPayload( encoded, bytes );
+                        if ( !kvsFromRawBytes( type, bytes, length, out ) ) {
+                            return result::FromError( PerErrc::kIntegrityCorrupted );
+                        }
+                    } else {
+                        out = shm::decodeValue( encoded );
+                    }
+                    return result::FromValue();
+                }
+            } catch(const std::exception& e) {
+                LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetValueAssign: " << core::StringView(e.what());
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+        }
+
+        auto value = faultIn( key, hash );
+        if ( !value.HasValue() ) {
+            return result::FromError( value.Error() );
+        }
+        if ( ::lap::core::GetVariantIndex( value.Value() ) != static_cast< core::Size >( type ) ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        out = ::std::move( value ).Value();
+        return result::FromValue();
+    }
+
+    core::Result< core::Size > KvsPropertyBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept
+    {
+        using result = core::Result< core::Size >;
+        const core::UInt64 hash = kvsKeyHash( key );
+        {
+            core::ReadLockGuard lock( shm::context.rwLock );
+
+            try {
+                auto&& it = shm::findKey( key, hash );
+
+                if ( it == shm::context.mapValue->end() ) {
+                    return result::FromError( PerErrc::kKeyNotFound );
+                }
+
+                if ( !shm::isEvicted( it->second ) ) {
+                    noteHit( &it->second );
+
+                    const auto& encoded = it->second.data;
+                    if ( !isKvsRawType( type ) || encoded.empty() ||
+                         encoded[0] != static_cast< core::Char >( 'a' + static_cast< core::UInt32 >( type ) ) ) {
+                        return result::FromError( PerErrc::kDataTypeMismatch );
+                    }
+
+                    // Copy the payload straight out of shared memory
+                    const core::Byte* bytes = nullptr;
+                    core::Size length = shm::rawPayload( encoded, bytes );
+                    if ( length > buffer.size() ) {
+                        return result::FromError( PerErrc::kWrongDataSize );
+                    }
+                    if ( length > 0 ) {
+                        ::std::memcpy( buffer.data(), bytes, length );
+                    }
+
+                    return result::FromValue( length );
+                }
+            } catch(const std::exception& e) {
+                LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::GetValueInto: " << core::StringView(e.what());
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+        }
+
+        auto value = faultIn( key, hash );
+        if ( !value.HasValue() ) {
+            return result::FromError( value.Error() );
+        }
+        const core::Byte* bytes = nullptr;
+        core::Size length = 0;
+        if ( !isKvsRawType( type ) || ::lap::core::GetVariantIndex( value.Value() ) != static_cast< core::Size >( type ) ||
+             !kvsRawBytes( value.Value(), bytes, length ) ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        if ( length > buffer.size() ) {
+            return result::FromError( PerErrc::kWrongDataSize );
+        }
+        if ( length > 0 ) {
+            ::std::memcpy( buffer.data(), bytes, length );
+        }
+        return result::FromValue( length );
     }
 
     core::Result<void> KvsPropertyBackend::SetValue( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        return SetValueHashed( key, kvsKeyHash( key ), value );
+    }
+
+    core::Result<void> KvsPropertyBackend::SetValueHashed( core::StringView key, core::UInt64 hash, const KvsDataType &value ) noexcept
     {
         using result = core::Result<void>;
+        core::WriteLockGuard lock( shm::context.rwLock );
         try {
             // Solution B: Use original key name directly
             // No need to remove old type variants - key names have no type prefix
             // Type is stored in the value itself, so setting a new value automatically overwrites
             
-            auto&& shmKey = shm::SHM_String( key.data(), shm::context.segment.get_segment_manager() );
-            auto&& shmValue = shm::encodeValue( value );  // Encode type into value
-            shm::context.mapValue->operator[]( shmKey ) = shmValue;
+            shm::storeValue( key, hash, value );  // Encode type into value
             
             m_bDirty = true;  // Mark as dirty for sync
+            
+            ++shm::context.version;
+            shm::context.snapshots.Changed( key );
+            enforceBudget();
 
-#ifdef LAP_DEBUG
-            LAP_PER_LOG_DEBUG.logFormat( "KvsPropertyBackend::SetValue with( %s , [type:%c] )", 
+            // Hot path: sampled so a bulk load doesn't format one line per key
+            LAP_PER_LOG_EVERY_N( DEBUG, 1024 ).logFormat( "KvsPropertyBackend::SetValue with( %s , [type:%c] )", 
                                        key.data(), static_cast<char>('a' + ::lap::core::GetVariantIndex( value )) );
-#endif
             
         } catch(const std::exception& e) {
             LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::SetValue: " << core::StringView(e.what());
@@ -270,16 +899,172 @@ namespace util
         return result::FromValue();
     }
 
+    // Values are text-encoded in the segment, so read-modify-write runs under the exclusive
+    // map lock and replaces the node's value in place (no key copy, no rehash)
+    core::Result< KvsDataType > KvsPropertyBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        KvsDataType previous;
+        if ( !kvsZeroValue( delta, previous ) ) return result::FromError( PerErrc::kDataTypeMismatch );
+
+        core::WriteLockGuard lock( shm::context.rwLock );
+        try {
+            const core::UInt64 hash = kvsKeyHash( key );
+            auto&& it = shm::findKey( key, hash );
+            if ( it != shm::context.mapValue->end() ) {
+                if ( shm::isEvicted( it->second ) ) {
+                    auto loaded = loadEvicted( key );
+                    if ( !loaded.HasValue() ) return loaded;
+                    previous = ::std::move( loaded ).Value();
+                } else {
+                    previous = shm::decodeValue( it->second.data );
+                }
+            }
+
+            KvsDataType sum;
+            if ( !kvsAddValues( previous, delta, sum ) ) {
+                return result::FromError( PerErrc::kDataTypeMismatch );
+            }
+
+            if ( it != shm::context.mapValue->end() ) {
+                shm::assignValue( it->second, sum );
+            } else {
+                shm::storeValue( key, hash, sum );
+            }
+            m_bDirty = true;  // Mark as dirty for sync
+            ++shm::context.version;
+            shm::context.snapshots.Changed( key );
+            enforceBudget();
+        } catch(const std::exception& e) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::FetchAdd: " << core::StringView(e.what());
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        return result::FromValue( ::std::move( previous ) );
+    }
+
+    core::Result< core::Bool > KvsPropertyBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+        core::WriteLockGuard lock( shm::context.rwLock );
+
+        try {
+            auto&& it = shm::findKey( key, kvsKeyHash( key ) );
+            if ( it == shm::context.mapValue->end() ) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+
+            KvsDataType current;
+            if ( shm::isEvicted( it->second ) ) {
+                auto loaded = loadEvicted( key );
+                if ( !loaded.HasValue() ) return result::FromError( loaded.Error() );
+                current = ::std::move( loaded ).Value();
+            } else {
+                current = shm::decodeValue( it->second.data );
+            }
+            if ( !( current == expected ) ) {
+                return result::FromValue( false );
+            }
+
+            shm::assignValue( it->second, desired );
+            m_bDirty = true;  // Mark as dirty for sync
+            ++shm::context.version;
+            shm::context.snapshots.Changed( key );
+            enforceBudget();
+        } catch(const std::exception& e) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::CompareExchange: " << core::StringView(e.what());
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::Bool > KvsPropertyBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+        core::WriteLockGuard lock( shm::context.rwLock );
+
+        try {
+            const core::UInt64 hash = kvsKeyHash( key );
+            if ( shm::findKey( key, hash ) != shm::context.mapValue->end() ) {
+                return result::FromValue( false );
+            }
+
+            shm::storeValue( key, hash, value );
+            m_bDirty = true;  // Mark as dirty for sync
+            ++shm::context.version;
+            shm::context.snapshots.Changed( key );
+            enforceBudget();
+        } catch(const std::exception& e) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::SetIfAbsent: " << core::StringView(e.what());
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        return result::FromValue( true );
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsPropertyBackend::CreateSnapshot() const noexcept
+    {
+        // Evicted values are read through, a snapshot doesn't pull the whole store back into shared memory
+        auto readValue = [this]( const shm::SHM_MapValue::value_type& node, const core::String& key ) -> core::Result< KvsDataType > {
+            if ( shm::isEvicted( node.second ) ) return loadEvicted( key );
+            return core::Result< KvsDataType >::FromValue( shm::decodeValue( node.second.data ) );
+        };
+
+        // Chunks end on bucket boundaries, the copy restarts when a rehash moved entries between buckets
+        core::Size bucket = 0;
+        core::Size buckets = 0;
+        auto readChunk = [&]( KvsMapSnapshot::Entries& out, core::Size limit ) -> core::Result< core::Bool > {
+            const auto& map = *shm::context.mapValue;
+            if ( out.empty() || buckets != map.bucket_count() ) {
+                out.clear();
+                bucket = 0;
+                buckets = map.bucket_count();
+            }
+            for ( const core::Size end = out.size() + limit; bucket < buckets && out.size() < end; ++bucket ) {
+                for ( auto it = map.begin( bucket ); it != map.end( bucket ); ++it ) {
+                    auto key = shm::keyString( it->first );
+                    auto value = readValue( *it, key );
+                    if ( !value.HasValue() ) return core::Result< core::Bool >::FromError( value.Error() );
+                    out.emplace_back( ::std::move( key ), ::std::move( value ).Value() );
+                }
+            }
+            return core::Result< core::Bool >::FromValue( bucket >= buckets );
+        };
+        auto readKey = [&]( core::StringView key, KvsDataType& out ) -> core::Result< core::Bool > {
+            auto it = shm::findKey( key, kvsKeyHash( key ) );
+            if ( it == shm::context.mapValue->end() ) return core::Result< core::Bool >::FromValue( false );
+
+            auto value = readValue( *it, core::String( key ) );
+            if ( !value.HasValue() ) return core::Result< core::Bool >::FromError( value.Error() );
+            out = ::std::move( value ).Value();
+            return core::Result< core::Bool >::FromValue( true );
+        };
+
+        auto snapshot = shm::context.snapshots.Acquire( shm::context.rwLock, readChunk, readKey );
+        if ( !snapshot.HasValue() ) {
+            LAP_PER_LOG_ERROR << "KvsPropertyBackend::CreateSnapshot failed: " << snapshot.Error().Message();
+        }
+        return snapshot;
+    }
+
     core::Result<void> KvsPropertyBackend::RemoveKey( core::StringView key ) noexcept
     {
         using result = core::Result<void>;
+        core::WriteLockGuard lock( shm::context.rwLock );
 
         try {
-            auto it = shm::context.mapValue->find( shm::SHM_String( key.data(), shm::context.segment.get_segment_manager() ) );
+            auto it = shm::findKey( key, kvsKeyHash( key ) );
 
             if ( it != shm::context.mapValue->end() ) {
-                shm::context.mapValue->erase( it );
+                if ( m_pPersistenceBackend ) m_removedKeys.emplace( key.data(), key.size() );
+                m_evictedChanges.erase( core::String( key ) );
+                shm::eraseEntry( it );
+                m_generation = nextGeneration();  // Invalidate cached nodes
                 m_bDirty = true;  // Mark as dirty for sync
+                ++shm::context.version;
+                shm::context.snapshots.Changed( key );
             }
            
         } catch(const std::exception& e) {
@@ -313,9 +1098,20 @@ namespace util
     core::Result<void> KvsPropertyBackend::RemoveAllKeys() noexcept
     {
         using result = core::Result<void>;
+        core::WriteLockGuard lock( shm::context.rwLock );
         try {
-            shm::context.mapValue->clear();
+            if ( m_pPersistenceBackend ) {
+                // An incremental sync removes them from the persistence backend one by one
+                for ( const auto& entry : *shm::context.mapValue ) {
+                    m_removedKeys.insert( shm::keyString( entry.first ) );
+                }
+            }
+            shm::clearEntries();
+            m_evictedChanges.clear();
+            m_generation = nextGeneration();  // Invalidate cached nodes
             m_bDirty = true;  // Mark as dirty for sync
+            ++shm::context.version;
+            shm::context.snapshots.Cleared();
         } catch(const std::exception& e) {
             return result::FromError( PerErrc::kNotInitialized );
         }
@@ -325,6 +1121,8 @@ namespace util
 
     core::Result<void> KvsPropertyBackend::SyncToStorage() noexcept
     {
+        core::WriteLockGuard lock( shm::context.rwLock );
+
         // Save shared memory data to persistence backend
         if (m_bDirty && m_pPersistenceBackend && m_pPersistenceBackend->available()) {
             auto result = saveToPersistence();
@@ -336,13 +1134,224 @@ namespace util
         return core::Result<void>::FromValue();
     }
 
+    core::Result< KvsSyncProgress > KvsPropertyBackend::SyncToStorage( KvsSyncMeter& meter ) noexcept
+    {
+        using result = core::Result< KvsSyncProgress >;
+        core::WriteLockGuard lock( shm::context.rwLock );
+
+        if ( !m_pPersistenceBackend || !m_pPersistenceBackend->available() ) {
+            return result::FromValue( KvsSyncProgress{} );  // Memory-only mode, nothing to persist
+        }
+
+        try {
+            auto& map = *shm::context.mapValue;
+
+            if ( !m_bFlushed && ( m_bDirty || m_bFlushing ) ) {
+                if ( !m_bFlushing ) {
+                    // A fresh id: values staged by an abandoned round don't count as staged
+                    m_flushRound    = nextGeneration();
+                    m_flushVersion  = shm::context.version;
+                }
+                if ( !m_bFlushing || m_flushBuckets != map.bucket_count() ) {
+                    // Start a round, or restart the scan after a rehash moved entries between buckets
+                    m_bFlushing     = true;
+                    m_flushBucket   = 0;
+                    m_flushBuckets  = map.bucket_count();
+                    m_flushScanned  = 0;
+                }
+
+                // Dirty values bucket by bucket into the stage, a bucket cut short is scanned again.
+                // Nothing reaches the persistence backend before the round is published
+                core::Bool stopped = false;
+                while ( !stopped && m_flushBucket < m_flushBuckets && meter.admit( 0, 0 ) ) {
+                    for ( auto it = map.begin( m_flushBucket ); it != map.end( m_flushBucket ); ++it ) {
+                        auto& slot = it->second;
+                        if ( !slot.dirty || shm::isEvicted( slot ) || slot.syncRound == m_flushRound ) continue;
+                        if ( !meter.admit( 1, 0 ) ) {
+                            stopped = true;
+                            break;
+                        }
+                        m_flushValues.push_back( KvsRecord{ shm::keyString( it->first ), shm::decodeValue( slot.data ) } );
+                        slot.syncRound = m_flushRound;
+                        meter.spend( 1, 0 );
+                    }
+                    if ( !stopped ) {
+                        m_flushScanned += map.bucket_size( m_flushBucket );
+                        ++m_flushBucket;
+                    }
+                }
+
+                // Removals, staged values and evictions as one change, like the File backend's commit phase
+                if ( m_flushBucket >= m_flushBuckets && meter.admit( 1, 0 ) ) {
+                    auto publishResult = publishRound();
+                    if ( !publishResult.HasValue() ) {
+                        return result::FromError( publishResult.Error() );
+                    }
+                    meter.spend( 1, 0 );
+                }
+            }
+
+            KvsSyncProgress progress;
+            if ( m_bFlushed ) {
+                auto syncResult = m_pPersistenceBackend->SyncToStorage( meter );
+                if ( !syncResult.HasValue() ) {
+                    return syncResult;
+                }
+                progress = syncResult.Value();
+                m_bFlushed = !progress.complete;
+            } else if ( m_bFlushing ) {
+                const core::UInt64 entries = map.size();
+                progress.complete           = false;
+                progress.remainingRecords   = 1 + ( entries > m_flushScanned ? entries - m_flushScanned : 0 );  // Scan, then the publish
+            }
+            return result::FromValue( progress );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch ( const ::std::exception& e ) {
+            LAP_PER_LOG_ERROR << "Exception during incremental save to persistence: " << e.what();
+            return result::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+    }
+
+    core::Result< core::UInt64 > KvsPropertyBackend::Export( IKvsRecordSink& sink, core::Size batchSize ) const noexcept
+    {
+        using result = core::Result< core::UInt64 >;
+
+        if ( batchSize == 0 ) batchSize = KVS_RECORD_BATCH_SIZE;
+
+        auto keys = GetAllKeys();
+        if ( !keys.HasValue() ) {
+            return result::FromError( keys.Error() );
+        }
+        auto begun = sink.Begin( keys.Value().size() );
+        if ( !begun.HasValue() ) {
+            return result::FromError( begun.Error() );
+        }
+
+        core::UInt64 exported = 0;
+        try {
+            KvsRecordBatch batch;
+            const auto& all = keys.Value();
+            for ( core::Size first = 0; first < all.size(); first += batchSize ) {
+                batch.clear();
+                {
+                    // One shared lock per batch; keys removed since GetAllKeys() are skipped
+                    core::ReadLockGuard lock( shm::context.rwLock );
+                    for ( core::Size i = first; i < ::std::min( first + batchSize, all.size() ); ++i ) {
+                        auto&& it = shm::findKey( all[i], kvsKeyHash( all[i] ) );
+                        if ( it == shm::context.mapValue->end() ) {
+                            continue;
+                        }
+                        if ( !shm::isEvicted( it->second ) ) {
+                            batch.push_back( KvsRecord{ all[i], shm::decodeValue( it->second.data ) } );
+                            continue;
+                        }
+                        // Read through without faulting in or counting a miss, an export must not displace the working set
+                        auto value = readEvicted( all[i] );
+                        if ( !value.HasValue() ) {
+                            return result::FromError( value.Error() );
+                        }
+                        batch.push_back( KvsRecord{ all[i], ::std::move( value.Value() ) } );
+                    }
+                }
+
+                auto written = sink.Write( batch );
+                if ( !written.HasValue() ) {
+                    return result::FromError( written.Error() );
+                }
+                exported += batch.size();
+            }
+        } catch( const std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch( const std::exception& e ) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::Export: " << core::StringView( e.what() );
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        auto finished = sink.Finish();
+        if ( !finished.HasValue() ) {
+            return result::FromError( finished.Error() );
+        }
+        return result::FromValue( exported );
+    }
+
+    core::Result< core::UInt64 > KvsPropertyBackend::Import( IKvsRecordSource& source, const KvsImportOptions& options ) noexcept
+    {
+        using result = core::Result< core::UInt64 >;
+
+        if ( options.clearFirst ) {
+            auto cleared = RemoveAllKeys();
+            if ( !cleared.HasValue() ) {
+                return result::FromError( cleared.Error() );
+            }
+        }
+
+        const auto expected = source.ExpectedRecords();
+        if ( options.bulkLoad && expected > 0 ) {
+            core::WriteLockGuard lock( shm::context.rwLock );
+            try {
+                // Pre-size the buckets: one rehash instead of one per doubling while the map fills
+                shm::context.mapValue->reserve( shm::context.mapValue->size() + expected );
+            } catch( const std::exception& ) {
+                LAP_PER_LOG_WARN << "KvsPropertyBackend::Import: buckets for " << expected << " keys don't fit the segment, growing on demand";
+            }
+        }
+
+        core::UInt64 imported = 0;
+        KvsRecordBatch batch;
+        for (;;) {
+            auto read = source.Read( batch, options.batchSize );
+            if ( !read.HasValue() ) {
+                return result::FromError( read.Error() );
+            }
+            if ( read.Value() == 0 ) {
+                break;
+            }
+
+            // One exclusive lock per batch instead of one per key
+            core::WriteLockGuard lock( shm::context.rwLock );
+            m_bDirty = true;
+            ++shm::context.version;
+            try {
+                for ( const auto& record : batch ) {
+                    shm::context.snapshots.Changed( record.key );
+                    shm::storeValue( record.key, kvsKeyHash( record.key ), record.value );
+                    ++imported;
+                }
+                enforceBudget();
+            } catch( const std::bad_alloc& ) {
+                LAP_PER_LOG_ERROR << "KvsPropertyBackend::Import: shared memory exhausted after " << imported << " records";
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            } catch( const std::exception& e ) {
+                LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::Import: " << core::StringView( e.what() );
+                return result::FromError( PerErrc::kNotInitialized );
+            }
+        }
+
+        return result::FromValue( imported );
+    }
+
     core::Result<void> KvsPropertyBackend::DiscardPendingChanges() noexcept
     {
         using result = core::Result<void>;
+        core::WriteLockGuard lock( shm::context.rwLock );
         
         // Clear shared memory and reload from persistence
         try {
-            shm::context.mapValue->clear();
+            const core::Bool published = m_bFlushed;
+            resetIncrementalSync();
+            if ( published ) {
+                // A published round the persistence backend has not synced yet (File)
+                auto discardResult = m_pPersistenceBackend->DiscardPendingChanges();
+                if ( !discardResult.HasValue() ) {
+                    return discardResult;
+                }
+            }
+            shm::clearEntries();
+            m_evictedChanges.clear();  // Never reached the persistence backend
+            m_generation = nextGeneration();  // Invalidate cached nodes
+            ++shm::context.version;
+            shm::context.snapshots.Invalidate();
             
             if (m_pPersistenceBackend && m_pPersistenceBackend->available()) {
                 auto loadResult = loadFromPersistence();
@@ -370,6 +1379,7 @@ namespace util
         
         // Estimate shared memory size if no persistence backend
         try {
+            core::ReadLockGuard lock( shm::context.rwLock );
             core::UInt64 estimatedSize = shm::context.mapValue->size() * 64;  // Rough estimate
             return result::FromValue(estimatedSize);
         } catch(const std::exception& e) {
@@ -382,12 +1392,180 @@ namespace util
         using result = core::Result<core::UInt32>;
         
         try {
+            core::ReadLockGuard lock( shm::context.rwLock );
             return result::FromValue(static_cast<core::UInt32>(shm::context.mapValue->size()));
         } catch(const std::exception& e) {
             return result::FromError(PerErrc::kNotInitialized);
         }
     }
 
+    core::Result< KvsInternStatistics > KvsPropertyBackend::GetInternStatistics() const noexcept
+    {
+        using result = core::Result< KvsInternStatistics >;
+
+        try {
+            core::ReadLockGuard lock( shm::context.rwLock );
+            KvsInternStatistics stats;
+            stats.strings = shm::context.strings->size();
+            for ( const auto& entry : *shm::context.strings ) {
+                stats.references += entry.second.refs;
+            }
+            stats.segmentBytesUsed = shm::segmentBytesUsed();
+            return result::FromValue( stats );
+        } catch(const std::exception& e) {
+            return result::FromError(PerErrc::kNotInitialized);
+        }
+    }
+
+    core::Result< KvsEvictionStatistics > KvsPropertyBackend::GetEvictionStatistics() const noexcept
+    {
+        using result = core::Result< KvsEvictionStatistics >;
+
+        try {
+            KvsEvictionStatistics stats;
+            stats.budget = evictionEnabled() ? m_memoryBudget : 0;
+            stats.hits = m_hits.load( ::std::memory_order_relaxed );
+            stats.misses = m_misses.load( ::std::memory_order_relaxed );
+            stats.evictions = m_evictions.load( ::std::memory_order_relaxed );
+            stats.writeBacks = m_writeBacks.load( ::std::memory_order_relaxed );
+            core::ReadLockGuard lock( shm::context.rwLock );
+            stats.segmentBytesUsed = shm::segmentBytesUsed();
+            return result::FromValue( stats );
+        } catch(const std::exception& e) {
+            return result::FromError(PerErrc::kNotInitialized);
+        }
+    }
+
+    // ==================== Memory Budget ====================
+
+    void KvsPropertyBackend::noteHit( const void* value ) const noexcept
+    {
+        if ( evictionEnabled() ) {
+            shm::touch( *static_cast< const shm::SHM_Value* >( value ) );
+            m_hits.fetch_add( 1, ::std::memory_order_relaxed );
+        }
+    }
+
+    core::Result< KvsDataType > KvsPropertyBackend::loadEvicted( core::StringView key ) const noexcept
+    {
+        m_misses.fetch_add( 1, ::std::memory_order_relaxed );
+        auto value = readEvicted( key );
+        if ( !value.HasValue() ) {
+            LAP_PER_LOG_ERROR << "KvsPropertyBackend: evicted key missing from persistence backend: " << key;
+            return core::Result< KvsDataType >::FromError( PerErrc::kIntegrityCorrupted );
+        }
+        return value;
+    }
+
+    core::Result< KvsDataType > KvsPropertyBackend::readEvicted( core::StringView key ) const noexcept
+    {
+        try {
+            auto staged = m_evictedChanges.find( core::String( key ) );
+            if ( staged != m_evictedChanges.end() ) {
+                return core::Result< KvsDataType >::FromValue( staged->second );
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< KvsDataType >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return m_pPersistenceBackend->GetValue( key );
+    }
+
+    core::Result< KvsDataType > KvsPropertyBackend::faultIn( core::StringView key, core::UInt64 hash ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+        core::WriteLockGuard lock( shm::context.rwLock );
+
+        try {
+            auto&& it = shm::findKey( key, hash );
+            if ( it == shm::context.mapValue->end() ) {
+                return result::FromError( PerErrc::kKeyNotFound );
+            }
+            if ( !shm::isEvicted( it->second ) ) {
+                // Another reader faulted it in first
+                noteHit( &it->second );
+                return result::FromValue( shm::decodeValue( it->second.data ) );
+            }
+
+            auto value = loadEvicted( key );
+            if ( !value.HasValue() ) {
+                return value;
+            }
+            shm::assignValue( it->second, value.Value() );
+            // A staged value is not in the persistence backend yet, it comes back dirty
+            auto staged = m_evictedChanges.find( core::String( key ) );
+            if ( staged != m_evictedChanges.end() ) {
+                m_evictedChanges.erase( staged );
+            } else {
+                it->second.dirty = false;
+            }
+            enforceBudget();  // Newest now, evicted last
+            return value;
+        } catch(const std::exception& e) {
+            LAP_PER_LOG_ERROR << "Exception in KvsPropertyBackend::faultIn: " << core::StringView(e.what());
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+    }
+
+    void KvsPropertyBackend::enforceBudget() const
+    {
+        if ( !evictionEnabled() || shm::segmentBytesUsed() <= m_memoryBudget ) {
+            return;
+        }
+
+        if ( m_victimsGeneration != m_generation ) {
+            m_victims.clear();  // Their nodes may have been freed
+            m_victimsGeneration = m_generation;
+        }
+
+        // Oldest first, down to 7/8 of the budget so a full tier doesn't evict on every write
+        const core::Size target = m_memoryBudget - m_memoryBudget / 8;
+        while ( shm::segmentBytesUsed() > target ) {
+            if ( m_victims.empty() ) {
+                if ( shm::context.resident == 0 || shm::context.resident < m_rescanResident ) {
+                    break;
+                }
+                // One scan orders every resident value, later calls pop from the back
+                m_victims.reserve( shm::context.resident );
+                for ( auto&& it = shm::context.mapValue->begin(); it != shm::context.mapValue->end(); ++it ) {
+                    if ( !shm::isEvicted( it->second ) ) {
+                        m_victims.emplace_back( it->second.lastUse.load( ::std::memory_order_relaxed ), &*it );
+                    }
+                }
+                ::std::sort( m_victims.begin(), m_victims.end(),
+                             []( const auto& lhs, const auto& rhs ) { return lhs.first > rhs.first; } );
+                if ( m_victims.empty() ) {
+                    break;
+                }
+            }
+
+            const auto victim = m_victims.back();
+            m_victims.pop_back();
+            auto* node = static_cast< shm::SHM_MapValue::value_type* >( victim.second );
+            auto& slot = node->second;
+            if ( shm::isEvicted( slot ) || slot.lastUse.load( ::std::memory_order_relaxed ) != victim.first ) {
+                continue;  // Evicted meanwhile, or used again: ordered anew by the next scan
+            }
+            if ( slot.dirty ) {
+                // Staged until the next sync: a write to the persistence backend (SQLite commits it) would outlive a discard
+                m_evictedChanges[ shm::keyString( node->first ) ] = shm::decodeValue( slot.data );
+                slot.dirty = false;
+                m_writeBacks.fetch_add( 1, ::std::memory_order_relaxed );
+            }
+            shm::evictValue( slot );
+            m_evictions.fetch_add( 1, ::std::memory_order_relaxed );
+        }
+
+        if ( shm::segmentBytesUsed() > m_memoryBudget ) {
+            // Keys alone exceed the budget: rescan once a batch of new values can be evicted, not on every write
+            if ( m_victims.empty() ) {
+                m_rescanResident = shm::context.resident + ::std::max< core::Size >( EVICTION_RESCAN_MIN, shm::context.mapValue->size() / 16 );
+            }
+            LAP_PER_LOG_EVERY_N( WARN, 1024 ) << "KvsPropertyBackend: keys alone exceed the memory budget of " << m_memoryBudget << " bytes";
+        } else {
+            m_rescanResident = 0;
+        }
+    }
+
     // ==================== Load/Save to Persistence Backend ====================
     
     core::Result<void> KvsPropertyBackend::loadFromPersistence() noexcept
@@ -399,36 +1577,79 @@ namespace util
             return result::FromValue();  // Not an error, just no data to load
         }
         
-        try {
-            // Get all keys from persistence backend
-            auto keysResult = m_pPersistenceBackend->GetAllKeys();
-            if (!keysResult.HasValue()) {
-                LAP_PER_LOG_WARN << "Failed to get keys from persistence backend";
-                return result::FromValue();  // Empty backend is OK
-            }
-            
-            const auto& keys = keysResult.Value();
-            LAP_PER_LOG_INFO << "Loading " << keys.size() << " keys from persistence backend";
-            
-            // Load each key-value pair into shared memory
-            for (const auto& key : keys) {
-                auto valueResult = m_pPersistenceBackend->GetValue(key);
-                if (valueResult.HasValue()) {
-                    auto shmKey = shm::SHM_String(key.c_str(), shm::context.segment.get_segment_manager());
-                    auto shmValue = shm::encodeValue(valueResult.Value());
-                    shm::context.mapValue->operator[](shmKey) = shmValue;
-                }
-            }
-            
-            LAP_PER_LOG_INFO << "Successfully loaded data from persistence backend";
-        } catch(const std::exception& e) {
-            LAP_PER_LOG_ERROR << "Exception during load from persistence: " << e.what();
-            return result::FromError(PerErrc::kPhysicalStorageFailure);
+        // Batches streamed by the persistence backend, no GetValue() round trip per key
+        ShmLoadSink sink( evictionEnabled() ? m_memoryBudget : 0 );
+        auto loaded = m_pPersistenceBackend->Export( sink );
+        ++shm::context.version;
+        shm::context.snapshots.Invalidate();
+        if ( !loaded.HasValue() ) {
+            LAP_PER_LOG_WARN << "Failed to load from persistence backend";
+            return result::FromError( loaded.Error() );
         }
         
+        LAP_PER_LOG_INFO << "Loaded " << loaded.Value() << " keys from persistence backend";
         return result::FromValue();
     }
     
+    void KvsPropertyBackend::resetIncrementalSync() noexcept
+    {
+        m_removedKeys.clear();
+        m_flushValues.clear();
+        m_flushRound = 0;
+        m_bFlushing = false;
+        m_bFlushed  = false;
+    }
+
+    core::Result<void> KvsPropertyBackend::publishRound()
+    {
+        auto& map = *shm::context.mapValue;
+        auto present = [&map]( const core::String& key ) { return shm::findKey( key, kvsKeyHash( key ) ) != map.end(); };
+
+        // The round is consumed here: if the publish fails, the next one scans again and finds
+        // the values staged by this one still dirty; removals stay pending
+        KvsRecordBatch values;
+        values.swap( m_flushValues );
+        const core::UInt64 round = m_flushRound;
+        m_flushRound = 0;
+        m_bFlushing  = false;
+        m_bDirty     = true;
+
+        // Keys removed and not set again; staged values of keys removed since are dropped
+        core::Vector< core::String > removed;
+        for ( const auto& key : m_removedKeys ) {
+            if ( !present( key ) ) removed.push_back( key );
+        }
+        values.erase( ::std::remove_if( values.begin(), values.end(), [&present]( const KvsRecord& record ) { return !present( record.key ); } ),
+                      values.end() );
+        // Evicted after the scan staged them, or never scanned: applied after the staged copy, which they may replace
+        for ( const auto& staged : m_evictedChanges ) {
+            auto it = shm::findKey( staged.first, kvsKeyHash( staged.first ) );
+            if ( it != map.end() && shm::isEvicted( it->second ) ) {
+                values.push_back( KvsRecord{ staged.first, staged.second } );
+            }
+        }
+
+        auto applyResult = m_pPersistenceBackend->ApplyChanges( values, removed );
+        if ( !applyResult.HasValue() ) {
+            return applyResult;
+        }
+
+        // Values changed since they were staged keep their dirty flag for the next round
+        for ( const auto& record : values ) {
+            auto it = shm::findKey( record.key, kvsKeyHash( record.key ) );
+            if ( it != map.end() && it->second.syncRound == round ) {
+                it->second.dirty = false;
+            }
+        }
+        m_evictedChanges.clear();
+        m_removedKeys.clear();
+
+        // Changes made during the round may sit in buckets it had already passed
+        m_bFlushed = true;
+        m_bDirty   = shm::context.version != m_flushVersion;
+        return core::Result<void>::FromValue();
+    }
+
     core::Result<void> KvsPropertyBackend::saveToPersistence() noexcept
     {
         using result = core::Result<void>;
@@ -439,24 +1660,63 @@ namespace util
         }
         
         try {
-            LAP_PER_LOG_INFO << "Saving " << shm::context.mapValue->size() << " keys to persistence backend";
+            LAP_PER_LOG_EVERY_MS( INFO, 1000 ) << "Saving " << shm::context.mapValue->size() << " keys to persistence backend";
+            resetIncrementalSync();  // The full save handles removals and all dirty values itself
             
-            // Clear persistence backend first (full sync)
-            auto clearResult = m_pPersistenceBackend->RemoveAllKeys();
-            if (!clearResult.HasValue()) {
-                LAP_PER_LOG_ERROR << "Failed to clear persistence backend before sync";
-                return clearResult;
-            }
-            
-            // Save all key-value pairs from shared memory to persistence
-            for (const auto& pair : *shm::context.mapValue) {
-                core::String key(pair.first.c_str());
-                KvsDataType value = shm::decodeValue(pair.second);
+            if ( evictionEnabled() ) {
+                // Evicted values exist only in the persistence backend or the stage: drop removed keys
+                // instead of clearing it, and publish them with the staged and dirty values as one change
+                auto keysResult = m_pPersistenceBackend->GetAllKeys();
+                if ( !keysResult.HasValue() ) {
+                    return result::FromError( keysResult.Error() );
+                }
+                core::Vector< core::String > removed;
+                for ( auto& key : keysResult.Value() ) {
+                    if ( shm::findKey( key, kvsKeyHash( key ) ) == shm::context.mapValue->end() ) {
+                        removed.emplace_back( ::std::move( key ) );
+                    }
+                }
+                KvsRecordBatch values;
+                for ( const auto& staged : m_evictedChanges ) {
+                    auto it = shm::findKey( staged.first, kvsKeyHash( staged.first ) );
+                    if ( it != shm::context.mapValue->end() && shm::isEvicted( it->second ) ) {
+                        values.push_back( KvsRecord{ staged.first, staged.second } );
+                    }
+                }
+                for ( const auto& pair : *shm::context.mapValue ) {
+                    if ( pair.second.dirty && !shm::isEvicted( pair.second ) ) {
+                        values.push_back( KvsRecord{ shm::keyString( pair.first ), shm::decodeValue( pair.second.data ) } );
+                    }
+                }
+
+                auto applyResult = m_pPersistenceBackend->ApplyChanges( values, removed );
+                if ( !applyResult.HasValue() ) {
+                    LAP_PER_LOG_ERROR << "Failed to publish " << values.size() << " values to persistence backend";
+                    return applyResult;
+                }
+                for ( auto& pair : *shm::context.mapValue ) {
+                    pair.second.dirty = false;
+                }
+                m_evictedChanges.clear();
+            } else {
+                // Clear persistence backend first (full sync)
+                auto clearResult = m_pPersistenceBackend->RemoveAllKeys();
+                if (!clearResult.HasValue()) {
+                    LAP_PER_LOG_ERROR << "Failed to clear persistence backend before sync";
+                    return clearResult;
+                }
                 
-                auto setResult = m_pPersistenceBackend->SetValue(key, value);
-                if (!setResult.HasValue()) {
-                    LAP_PER_LOG_ERROR << "Failed to set key '" << key << "' in persistence backend";
-                    return setResult;
+                // Save all key-value pairs from shared memory to persistence
+                for (auto& pair : *shm::context.mapValue) {
+                    core::String key = shm::keyString( pair.first );
+                    KvsDataType value = shm::decodeValue(pair.second.data);
+                    
+                    auto setResult = m_pPersistenceBackend->SetValue(key, value);
+                    if (!setResult.HasValue()) {
+                        LAP_PER_LOG_ERROR << "Failed to set key '" << key << "' in persistence backend";
+                        return setResult;
+                    }
+                    pair.second.dirty = false;
                 }
             }
             
@@ -467,7 +1727,7 @@ namespace util
                 return syncResult;
             }
             
-            LAP_PER_LOG_INFO << "Successfully saved data to persistence backend";
+            LAP_PER_LOG_DEBUG << "Successfully saved data to persistence backend";
         } catch(const std::exception& e) {
             LAP_PER_LOG_ERROR << "Exception during save to persistence: " << e.what();
             return result::FromError(PerErrc::kPhysicalStorageFailure);
@@ -495,6 +1755,8 @@ namespace util
                                  << (m_shmSize / 1024) << " KB";
             }
             
+            m_memoryBudget = config->kvs.propertyBackendMemoryBudget;
+
             // Use configured persistence backend type
             if (!config->kvs.propertyBackendPersistence.empty()) {
                 if (config->kvs.propertyBackendPersistence == "sqlite") {
@@ -515,7 +1777,11 @@ namespace util
                 m_pPersistenceBackend = ::std::make_unique<KvsFileBackend>(identifier);
                 LAP_PER_LOG_INFO << "Property backend using File backend for persistence";
             } else if (m_persistenceBackend == KvsBackendType::kvsSqlite) {
-                m_pPersistenceBackend = ::std::make_unique<KvsSqliteBackend>(identifier);
+                const KvsSqliteTuning tuning = config != nullptr
+                    ? config->kvs.sqliteTuning(config->kvs.sqliteSharedDatabase.empty() ? core::String(identifier) : config->kvs.sqliteSharedDatabase)
+                    : KvsSqliteTuning();
+                m_pPersistenceBackend = ::std::make_unique<KvsSqliteBackend>(identifier,
+                    config != nullptr ? core::StringView(config->kvs.sqliteSharedDatabase) : core::StringView(), tuning);
                 LAP_PER_LOG_INFO << "Property backend using SQLite backend for persistence";
             } else if (m_persistenceBackend == KvsBackendType::kvsNone) {
                 m_pPersistenceBackend = nullptr;
@@ -525,6 +1791,10 @@ namespace util
                 throw PerException(PerErrc::kInitValueNotAvailable);
             }
             
+            if ( m_memoryBudget > 0 && !m_pPersistenceBackend ) {
+                LAP_PER_LOG_WARN << "Property backend memory budget needs a persistence backend, ignored for: " << identifier;
+            }
+
             // 2. Generate shared memory name from identifier
             shm::context.shmName = shm::generateShmName(identifier);
             
@@ -540,16 +1810,24 @@ namespace util
                 throw PerException( PerErrc::kInitValueNotAvailable );
             }
             
-            // 4. Open or create the map in shared memory
+            // 4. Open or create the map and its string pool in shared memory
             shm::context.mapValue = shm::context.segment.find_or_construct< shm::SHM_MapValue >( 
                 identifier.data() 
             )( shm::context.segment.get_segment_manager() );
+            shm::context.strings = shm::context.segment.find_or_construct< shm::SHM_StringPool >(
+                ( core::String( identifier ) + ".strings" ).c_str()
+            )( shm::context.segment.get_segment_manager() );
 
-            if ( nullptr == shm::context.mapValue ) {
+            if ( nullptr == shm::context.mapValue || nullptr == shm::context.strings ) {
                 LAP_PER_LOG_ERROR << "KvsPropertyBackend: failed to find/create shared memory map";
                 throw PerException( PerErrc::kInitValueNotAvailable );
             }
             
+            shm::context.resident = 0;
+            for ( const auto& entry : *shm::context.mapValue ) {
+                if ( !shm::isEvicted( entry.second ) ) ++shm::context.resident;
+            }
+
             // 5. Load existing data from persistence backend to shared memory (skip if kvsNone)
             auto loadResult = loadFromPersistence();
             if (!loadResult.HasValue()) {
@@ -0,0 +1,404 @@
+/**
+ * @file CKvsRecordStream.cpp
+ * @brief Batched record streams for bulk export and import between KVS backends
+ * @version 1.0
+ * @date 2025-12-01
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include <lap/core/CCrypto.hpp>
+
+#include "CKvsRecordStream.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        constexpr core::UInt32  STREAM_MAGIC        = 0x3152564b;   // "KVR1"
+        constexpr core::UInt32  STREAM_FORMAT       = 1;
+        constexpr core::Size    HEADER_SIZE         = 16;           // magic, format, expected records
+        constexpr core::Size    BLOCK_HEADER_SIZE   = 12;           // records, payload bytes, crc32
+        constexpr core::Size    RECORD_HEADER_SIZE  = 9;            // key length, value length, type
+        constexpr core::Size    END_PAYLOAD_SIZE    = 8;            // total records
+
+        template< class T >
+        void append( core::Vector< core::UInt8 >& out, T value )
+        {
+            const auto* bytes = reinterpret_cast< const core::UInt8* >( &value );
+            out.insert( out.end(), bytes, bytes + sizeof( T ) );
+        }
+
+        template< class T >
+        T load( const core::UInt8* data ) noexcept
+        {
+            T value;
+            ::std::memcpy( &value, data, sizeof( T ) );
+            return value;
+        }
+
+        template< class T >
+        void store( core::UInt8* data, T value ) noexcept
+        {
+            ::std::memcpy( data, &value, sizeof( T ) );
+        }
+
+        void appendHeader( core::Vector< core::UInt8 >& out, core::UInt64 expected )
+        {
+            append< core::UInt32 >( out, STREAM_MAGIC );
+            append< core::UInt32 >( out, STREAM_FORMAT );
+            append< core::UInt64 >( out, expected );
+        }
+
+        core::Result< core::UInt64 > parseHeader( const core::UInt8* data ) noexcept
+        {
+            if ( load< core::UInt32 >( data ) != STREAM_MAGIC || load< core::UInt32 >( data + 4 ) != STREAM_FORMAT ) {
+                LAP_PER_LOG_ERROR << "KvsRecordStream: not a record stream or unsupported format";
+                return core::Result< core::UInt64 >::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            return core::Result< core::UInt64 >::FromValue( load< core::UInt64 >( data + 8 ) );
+        }
+
+        // Block of one batch appended to out: header patched once the payload is known
+        core::Result< void > appendBlock( core::Vector< core::UInt8 >& out, const KvsRecordBatch& batch )
+        {
+            const core::Size start = out.size();
+            out.resize( start + BLOCK_HEADER_SIZE );
+
+            for ( const auto& record : batch ) {
+                const core::Byte* data = nullptr;
+                core::Size size = 0;
+                if ( !kvsValueBytes( record.value, data, size ) ) {
+                    return core::Result< void >::FromError( PerErrc::kDataTypeMismatch );
+                }
+                if ( record.key.size() > UINT32_MAX || size > UINT32_MAX ) {
+                    return core::Result< void >::FromError( PerErrc::kWrongDataSize );
+                }
+                append< core::UInt32 >( out, static_cast< core::UInt32 >( record.key.size() ) );
+                append< core::UInt32 >( out, static_cast< core::UInt32 >( size ) );
+                append< core::UInt8 >( out, static_cast< core::UInt8 >( ::lap::core::GetVariantIndex( record.value ) ) );
+                out.insert( out.end(), record.key.begin(), record.key.end() );
+                const auto* bytes = reinterpret_cast< const core::UInt8* >( data );
+                out.insert( out.end(), bytes, bytes + size );
+            }
+
+            const core::Size payload = out.size() - start - BLOCK_HEADER_SIZE;
+            if ( batch.size() > UINT32_MAX || payload > UINT32_MAX ) {
+                return core::Result< void >::FromError( PerErrc::kWrongDataSize );
+            }
+            store< core::UInt32 >( out.data() + start, static_cast< core::UInt32 >( batch.size() ) );
+            store< core::UInt32 >( out.data() + start + 4, static_cast< core::UInt32 >( payload ) );
+            store< core::UInt32 >( out.data() + start + 8,
+                                   core::Crypto::Util::computeCrc32( out.data() + start + BLOCK_HEADER_SIZE, payload ) );
+            return core::Result< void >::FromValue();
+        }
+
+        void appendEnd( core::Vector< core::UInt8 >& out, core::UInt64 total )
+        {
+            core::UInt8 payload[ END_PAYLOAD_SIZE ];
+            store< core::UInt64 >( payload, total );
+            append< core::UInt32 >( out, 0 );
+            append< core::UInt32 >( out, static_cast< core::UInt32 >( END_PAYLOAD_SIZE ) );
+            append< core::UInt32 >( out, core::Crypto::Util::computeCrc32( payload, END_PAYLOAD_SIZE ) );
+            out.insert( out.end(), payload, payload + END_PAYLOAD_SIZE );
+        }
+
+        struct BlockHeader
+        {
+            core::UInt32    records;
+            core::UInt32    payload;
+            core::UInt32    crc;
+        };
+
+        BlockHeader parseBlockHeader( const core::UInt8* data ) noexcept
+        {
+            return BlockHeader{ load< core::UInt32 >( data ), load< core::UInt32 >( data + 4 ), load< core::UInt32 >( data + 8 ) };
+        }
+
+        /**
+         * @brief Decode the payload of a block into @p records, or check the end block against @p read
+         * @param end Set if this was the end block
+         */
+        core::Result< void > decodeBlock( const BlockHeader& header, const core::UInt8* payload,
+                                          KvsRecordBatch& records, core::UInt64& read, core::Bool& end )
+        {
+            using result = core::Result< void >;
+
+            if ( core::Crypto::Util::computeCrc32( payload, header.payload ) != header.crc ) {
+                LAP_PER_LOG_ERROR << "KvsRecordStream: block checksum mismatch after " << read << " records";
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+
+            if ( header.records == 0 ) {
+                if ( header.payload != END_PAYLOAD_SIZE || load< core::UInt64 >( payload ) != read ) {
+                    LAP_PER_LOG_ERROR << "KvsRecordStream: end block does not match the " << read << " records read";
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                end = true;
+                return result::FromValue();
+            }
+
+            records.clear();
+            records.reserve( header.records );
+            const core::UInt8* pos      = payload;
+            const core::UInt8* limit    = payload + header.payload;
+            for ( core::UInt32 i = 0; i < header.records; ++i ) {
+                if ( static_cast< core::Size >( limit - pos ) < RECORD_HEADER_SIZE ) break;
+                const core::Size keySize    = load< core::UInt32 >( pos );
+                const core::Size valueSize  = load< core::UInt32 >( pos + 4 );
+                const auto type             = static_cast< EKvsDataTypeIndicate >( pos[8] );
+                pos += RECORD_HEADER_SIZE;
+                if ( static_cast< core::Size >( limit - pos ) < keySize + valueSize ) break;
+
+                KvsRecord record;
+                record.key.assign( reinterpret_cast< const char* >( pos ), keySize );
+                if ( !kvsValueFromBytes( type, reinterpret_cast< const core::Byte* >( pos + keySize ), valueSize, record.value ) ) break;
+                pos += keySize + valueSize;
+                records.emplace_back( ::std::move( record ) );
+            }
+
+            if ( records.size() != header.records || pos != limit ) {
+                LAP_PER_LOG_ERROR << "KvsRecordStream: malformed record in block after " << read << " records";
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            read += header.records;
+            return result::FromValue();
+        }
+
+        // Hand out records of the decoded block until batch is full or the block is used up
+        void takePending( KvsRecordBatch& pending, core::Size& pos, KvsRecordBatch& batch, core::Size maxRecords )
+        {
+            while ( pos < pending.size() && batch.size() < maxRecords ) {
+                batch.emplace_back( ::std::move( pending[ pos++ ] ) );
+            }
+        }
+    } // namespace
+
+    // ==================== KvsRecordBuffer ====================
+
+    core::Result< void > KvsRecordBuffer::Begin( core::UInt64 expectedRecords ) noexcept
+    {
+        try {
+            m_data.clear();
+            appendHeader( m_data, expectedRecords );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_expected  = expectedRecords;
+        m_written   = 0;
+        m_readPos   = 0;
+        m_read      = 0;
+        m_pending.clear();
+        m_pendingPos = 0;
+        m_bEnd      = false;
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsRecordBuffer::Write( const KvsRecordBatch& batch ) noexcept
+    {
+        if ( batch.empty() ) return core::Result< void >::FromValue();
+        if ( m_data.empty() ) {
+            auto begun = Begin( 0 );
+            if ( !begun.HasValue() ) return begun;
+        }
+
+        try {
+            auto appended = appendBlock( m_data, batch );
+            if ( !appended.HasValue() ) return appended;
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_written += batch.size();
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsRecordBuffer::Finish() noexcept
+    {
+        if ( m_data.empty() ) {
+            auto begun = Begin( 0 );
+            if ( !begun.HasValue() ) return begun;
+        }
+
+        try {
+            appendEnd( m_data, m_written );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< core::Size > KvsRecordBuffer::Read( KvsRecordBatch& batch, core::Size maxRecords ) noexcept
+    {
+        using result = core::Result< core::Size >;
+
+        if ( maxRecords == 0 ) maxRecords = KVS_RECORD_BATCH_SIZE;
+
+        try {
+            batch.clear();
+            if ( m_readPos == 0 ) {
+                if ( m_data.size() < HEADER_SIZE ) return result::FromError( PerErrc::kIntegrityCorrupted );
+                auto header = parseHeader( m_data.data() );
+                if ( !header.HasValue() ) return result::FromError( header.Error() );
+                m_readPos = HEADER_SIZE;
+            }
+
+            while ( batch.size() < maxRecords ) {
+                if ( m_pendingPos < m_pending.size() ) {
+                    takePending( m_pending, m_pendingPos, batch, maxRecords );
+                    continue;
+                }
+                if ( m_bEnd ) break;
+
+                if ( m_data.size() - m_readPos < BLOCK_HEADER_SIZE ) {
+                    LAP_PER_LOG_ERROR << "KvsRecordBuffer: stream truncated after " << m_read << " records";
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                const auto header = parseBlockHeader( m_data.data() + m_readPos );
+                if ( m_data.size() - m_readPos - BLOCK_HEADER_SIZE < header.payload ) {
+                    LAP_PER_LOG_ERROR << "KvsRecordBuffer: stream truncated after " << m_read << " records";
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+
+                auto decoded = decodeBlock( header, m_data.data() + m_readPos + BLOCK_HEADER_SIZE, m_pending, m_read, m_bEnd );
+                if ( !decoded.HasValue() ) return result::FromError( decoded.Error() );
+                m_readPos   += BLOCK_HEADER_SIZE + header.payload;
+                m_pendingPos = 0;
+                if ( m_bEnd ) m_pending.clear();
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue( batch.size() );
+    }
+
+    // ==================== KvsRecordFileWriter ====================
+
+    KvsRecordFileWriter::KvsRecordFileWriter( core::SharedHandle< IVirtualFileSystem > vfs, core::StringView path ) noexcept
+        : m_pVfs( vfs ? vfs : IVirtualFileSystem::getDefault() )
+        , m_strPath( path )
+    {
+    }
+
+    core::Result< void > KvsRecordFileWriter::Begin( core::UInt64 expectedRecords ) noexcept
+    {
+        try {
+            m_block.clear();
+            appendHeader( m_block, expectedRecords );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        m_written = 0;
+        return m_pVfs->WriteFile( m_strPath, m_block.data(), m_block.size() );
+    }
+
+    core::Result< void > KvsRecordFileWriter::Write( const KvsRecordBatch& batch ) noexcept
+    {
+        if ( batch.empty() ) return core::Result< void >::FromValue();
+
+        try {
+            m_block.clear();
+            auto appended = appendBlock( m_block, batch );
+            if ( !appended.HasValue() ) return appended;
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        auto written = m_pVfs->AppendFile( m_strPath, m_block.data(), m_block.size() );
+        if ( written.HasValue() ) m_written += batch.size();
+        return written;
+    }
+
+    core::Result< void > KvsRecordFileWriter::Finish() noexcept
+    {
+        try {
+            m_block.clear();
+            appendEnd( m_block, m_written );
+        } catch ( const ::std::bad_alloc& ) {
+            return core::Result< void >::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return m_pVfs->AppendFile( m_strPath, m_block.data(), m_block.size() );
+    }
+
+    // ==================== KvsRecordFileReader ====================
+
+    KvsRecordFileReader::KvsRecordFileReader( core::SharedHandle< IVirtualFileSystem > vfs, core::StringView path ) noexcept
+        : m_pVfs( vfs ? vfs : IVirtualFileSystem::getDefault() )
+        , m_strPath( path )
+    {
+    }
+
+    core::Result< void > KvsRecordFileReader::readHeader() const noexcept
+    {
+        if ( m_offset != 0 ) return core::Result< void >::FromValue();
+
+        auto data = m_pVfs->ReadFileRange( m_strPath, 0, HEADER_SIZE );
+        if ( !data.HasValue() ) {
+            LAP_PER_LOG_ERROR << "KvsRecordFileReader: cannot read " << m_strPath;
+            if ( static_cast< PerErrc >( data.Error().Value() ) == PerErrc::kWrongDataSize ) {
+                return core::Result< void >::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            return core::Result< void >::FromError( data.Error() );
+        }
+        auto expected = parseHeader( data.Value().data() );
+        if ( !expected.HasValue() ) return core::Result< void >::FromError( expected.Error() );
+
+        m_expected  = expected.Value();
+        m_offset    = HEADER_SIZE;
+        return core::Result< void >::FromValue();
+    }
+
+    core::UInt64 KvsRecordFileReader::ExpectedRecords() const noexcept
+    {
+        return readHeader().HasValue() ? m_expected : 0;
+    }
+
+    core::Result< core::Size > KvsRecordFileReader::Read( KvsRecordBatch& batch, core::Size maxRecords ) noexcept
+    {
+        using result = core::Result< core::Size >;
+
+        if ( maxRecords == 0 ) maxRecords = KVS_RECORD_BATCH_SIZE;
+
+        auto opened = readHeader();
+        if ( !opened.HasValue() ) return result::FromError( opened.Error() );
+
+        try {
+            batch.clear();
+            while ( batch.size() < maxRecords ) {
+                if ( m_pendingPos < m_pending.size() ) {
+                    takePending( m_pending, m_pendingPos, batch, maxRecords );
+                    continue;
+                }
+                if ( m_bEnd ) break;
+
+                auto headerData = m_pVfs->ReadFileRange( m_strPath, m_offset, BLOCK_HEADER_SIZE );
+                if ( !headerData.HasValue() ) {
+                    LAP_PER_LOG_ERROR << "KvsRecordFileReader: " << m_strPath << " truncated after " << m_read << " records";
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+                const auto header = parseBlockHeader( headerData.Value().data() );
+                auto payload = m_pVfs->ReadFileRange( m_strPath, m_offset + BLOCK_HEADER_SIZE, header.payload );
+                if ( !payload.HasValue() ) {
+                    LAP_PER_LOG_ERROR << "KvsRecordFileReader: " << m_strPath << " truncated after " << m_read << " records";
+                    if ( static_cast< PerErrc >( payload.Error().Value() ) == PerErrc::kOutOfMemorySpace ) return result::FromError( PerErrc::kOutOfMemorySpace );
+                    return result::FromError( PerErrc::kIntegrityCorrupted );
+                }
+
+                auto decoded = decodeBlock( header, payload.Value().data(), m_pending, m_read, m_bEnd );
+                if ( !decoded.HasValue() ) return result::FromError( decoded.Error() );
+                m_offset    += BLOCK_HEADER_SIZE + header.payload;
+                m_pendingPos = 0;
+                if ( m_bEnd ) m_pending.clear();
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        return result::FromValue( batch.size() );
+    }
+} // namespace per
+} // namespace lap
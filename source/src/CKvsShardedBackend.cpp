@@ -0,0 +1,683 @@
+/**
+ * @file CKvsShardedBackend.cpp
+ * @brief Hash-sharded KVS backend
+ * @version 1.0
+ * @date 2025-11-24
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "CKvsShardedBackend.hpp"
+#include "CKvsFileBackend.hpp"
+#include "CKvsSqliteBackend.hpp"
+#include "CKvsKey.hpp"
+#include "CStoragePathManager.hpp"
+#include "IVirtualFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        /**
+         * @brief Snapshot composed of one pinned snapshot per shard, taken under the same gate
+         */
+        class ShardedSnapshot final : public IKvsSnapshot
+        {
+        public:
+            explicit ShardedSnapshot( core::Vector< core::SharedHandle< IKvsSnapshot > > shards ) noexcept
+                : m_shards( ::std::move( shards ) )
+            {
+                ;
+            }
+
+            core::Result< core::Vector< core::String > > GetAllKeys() const noexcept override
+            {
+                using result = core::Result< core::Vector< core::String > >;
+
+                try {
+                    core::Vector< core::String > keys;
+                    for ( const auto& shard : m_shards ) {
+                        auto shardKeys = shard->GetAllKeys();
+                        if ( !shardKeys.HasValue() ) return result::FromError( shardKeys.Error() );
+
+                        keys.insert( keys.end(), ::std::make_move_iterator( shardKeys.Value().begin() ),
+                                                 ::std::make_move_iterator( shardKeys.Value().end() ) );
+                    }
+                    ::std::sort( keys.begin(), keys.end() );
+                    return result::FromValue( ::std::move( keys ) );
+                } catch ( const ::std::bad_alloc& ) {
+                    return result::FromError( PerErrc::kOutOfMemorySpace );
+                }
+            }
+
+            core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept override
+            {
+                return shard( key ).KeyExists( key );
+            }
+
+            core::Result< KvsDataType > GetValue( core::StringView key ) const noexcept override
+            {
+                return shard( key ).GetValue( key );
+            }
+
+            core::Result< core::UInt32 > GetKeyCount() const noexcept override
+            {
+                core::UInt32 count = 0;
+                for ( const auto& shard : m_shards ) {
+                    auto shardCount = shard->GetKeyCount();
+                    if ( !shardCount.HasValue() ) return shardCount;
+                    count += shardCount.Value();
+                }
+                return core::Result< core::UInt32 >::FromValue( count );
+            }
+
+        private:
+            const IKvsSnapshot& shard( core::StringView key ) const noexcept
+            {
+                return *m_shards[ kvsKeyHash( key ) % m_shards.size() ];
+            }
+
+        private:
+            core::Vector< core::SharedHandle< IKvsSnapshot > > m_shards;
+        };
+
+        // Recorded in the manifest, the hash is fixed by kvsKeyHash
+        const core::Char* shardBackendName( KvsBackendType shardBackend ) noexcept
+        {
+            return shardBackend == KvsBackendType::kvsSqlite ? "sqlite" : "file";
+        }
+
+        core::Result< void > parseManifest( const core::String& manifestPath, ::std::string& shardBackend, core::UInt32& shardCount )
+        {
+            using result = core::Result< void >;
+
+            auto content = IVirtualFileSystem::getDefault()->ReadFile( manifestPath );
+            if ( !content.HasValue() ) return result::FromError( content.Error() );
+
+            auto manifest = nlohmann::json::parse( content.Value().begin(), content.Value().end(), nullptr, false );
+            if ( manifest.is_discarded() || !manifest.is_object() ) {
+                LAP_PER_LOG_ERROR << "Kvs shard manifest is corrupted: " << manifestPath;
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+
+            shardCount      = manifest.value( "shardCount", core::UInt32( 0 ) );
+            shardBackend    = manifest.value( "shardBackend", ::std::string() );
+            return result::FromValue();
+        }
+    }
+
+    core::Bool KvsShardedBackend::IsSharded( core::StringView identifier ) noexcept
+    {
+        try {
+            return IVirtualFileSystem::getDefault()->Exists( CStoragePathManager::getKvsInstancePath( identifier ) + "/" + MANIFEST_FILE );
+        } catch ( const ::std::bad_alloc& ) {
+            return false;
+        }
+    }
+
+    core::Result< void > KvsShardedBackend::ReadManifest( core::StringView identifier, KvsBackendType& shardBackend,
+                                                          core::UInt32& shardCount ) noexcept
+    {
+        using result = core::Result< void >;
+
+        try {
+            const core::String manifestPath = CStoragePathManager::getKvsInstancePath( identifier ) + "/" + MANIFEST_FILE;
+            if ( !IVirtualFileSystem::getDefault()->Exists( manifestPath ) ) return result::FromError( PerErrc::kValidationFailed );
+
+            ::std::string backend;
+            core::UInt32 count = 0;
+            auto parsed = parseManifest( manifestPath, backend, count );
+            if ( !parsed.HasValue() ) return parsed;
+
+            if ( count == 0 || count > MAX_SHARD_COUNT || ( backend != "file" && backend != "sqlite" ) ) {
+                LAP_PER_LOG_ERROR << "Kvs shard manifest records " << count << " " << backend << " shards: " << manifestPath;
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+
+            shardBackend    = backend == "sqlite" ? KvsBackendType::kvsSqlite : KvsBackendType::kvsFile;
+            shardCount      = count;
+            return result::FromValue();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    KvsShardedBackend::KvsShardedBackend( core::StringView identifier, KvsBackendType shardBackend, core::UInt32 shardCount,
+                                          ::std::pmr::memory_resource* resource, const KvsSqliteTuning& tuning ) noexcept
+    {
+        if ( !( shardBackend & KvsBackendType::kvsFile ) && !( shardBackend & KvsBackendType::kvsSqlite ) ) {
+            // Property backends share one process-wide map and lock, sharding them would not split anything
+            LAP_PER_LOG_WARN << "Kvs sharding supports File and SQLite shards only, using File shards for: " << identifier;
+            shardBackend = KvsBackendType::kvsFile;
+        }
+        m_shardBackend  = ( shardBackend & KvsBackendType::kvsSqlite ) ? KvsBackendType::kvsSqlite : KvsBackendType::kvsFile;
+        shardCount      = ::std::min( ::std::max( shardCount, core::UInt32( 1 ) ), MAX_SHARD_COUNT );
+
+        try {
+            // Routing depends on the shard count: never open shards laid out for another one
+            const core::String instancePath = CStoragePathManager::getKvsInstancePath( identifier );
+            core::Bool recorded = false;
+            core::Bool legacy = false;
+            if ( !checkManifest( instancePath, shardCount, recorded, legacy ).HasValue() ) return;
+
+            m_pDirty = ::std::make_unique< ::std::atomic< core::Bool >[] >( shardCount );
+            m_shards.reserve( shardCount );
+            for ( core::UInt32 i = 0; i < shardCount; ++i ) {
+                core::String shardIdentifier( identifier.data(), identifier.size() );
+                shardIdentifier += "/shard_" + ::std::to_string( i );
+
+                if ( m_shardBackend == KvsBackendType::kvsSqlite ) {
+                    m_shards.push_back( ::std::make_unique< KvsSqliteBackend >( shardIdentifier, core::StringView(), tuning ) );
+                } else {
+                    m_shards.push_back( ::std::make_unique< KvsFileBackend >( shardIdentifier, nullptr, resource ) );
+                }
+
+                if ( !m_shards.back()->available() ) {
+                    LAP_PER_LOG_ERROR << "Kvs shard " << i << " is not available: " << identifier;
+                    return;
+                }
+            }
+
+            if ( legacy && !migrate( identifier, tuning ).HasValue() ) {
+                LAP_PER_LOG_ERROR << "Kvs migration into " << shardCount << " shards failed: " << identifier;
+                return;
+            }
+            if ( !recorded && !writeManifest( instancePath ).HasValue() ) {
+                LAP_PER_LOG_ERROR << "Kvs shard manifest write failed: " << identifier;
+                return;
+            }
+            removeLegacy( instancePath );
+        } catch ( const ::std::bad_alloc& ) {
+            LAP_PER_LOG_ERROR << "Kvs sharded backend create failed, out of memory: " << identifier;
+            return;
+        }
+
+        m_bAvailable = true;
+        LAP_PER_LOG_INFO << "Kvs sharded backend initialized: " << identifier << " (" << shardCount << " shards)";
+    }
+
+    KvsShardedBackend::~KvsShardedBackend() noexcept
+    {
+        {
+            core::LockGuard< core::Mutex > lock( m_workMutex );
+            m_stop = true;
+        }
+        m_workCv.notify_all();
+        for ( auto& worker : m_workers ) worker.join();
+    }
+
+    core::Result< void > KvsShardedBackend::checkManifest( const core::String& instancePath, core::UInt32 shardCount,
+                                                           core::Bool& recorded, core::Bool& legacy ) const noexcept
+    {
+        using result = core::Result< void >;
+
+        auto pVfs = IVirtualFileSystem::getDefault();
+        try {
+            const core::String manifestPath = instancePath + "/" + MANIFEST_FILE;
+            recorded = pVfs->Exists( manifestPath );
+            if ( recorded ) {
+                ::std::string backend;
+                core::UInt32 count = 0;
+                auto parsed = parseManifest( manifestPath, backend, count );
+                if ( !parsed.HasValue() ) return parsed;
+
+                if ( count != shardCount || backend != shardBackendName( m_shardBackend ) ) {
+                    LAP_PER_LOG_ERROR << "Kvs instance has " << count << " " << backend << " shards, refused to open it with "
+                                      << shardCount << " " << shardBackendName( m_shardBackend ) << " shards: " << instancePath;
+                    return result::FromError( PerErrc::kValidationFailed );
+                }
+                return result::FromValue();
+            }
+
+            // No manifest: a non-sharded instance is migrated, shards of an older release must match the count
+            legacy = pVfs->Exists( instancePath + ( m_shardBackend == KvsBackendType::kvsSqlite ? "/current/db.sqlite" : "/current/kvs_data.json" ) );
+            if ( legacy ) return result::FromValue();
+
+            core::UInt32 existing = 0;
+            while ( existing <= MAX_SHARD_COUNT && pVfs->IsDirectory( instancePath + "/shard_" + ::std::to_string( existing ) ) ) ++existing;
+            if ( existing != 0 && existing != shardCount ) {
+                LAP_PER_LOG_ERROR << "Kvs instance has " << existing << " shards, refused to open it with " << shardCount << ": " << instancePath;
+                return result::FromError( PerErrc::kValidationFailed );
+            }
+            return result::FromValue();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > KvsShardedBackend::writeManifest( const core::String& instancePath ) const noexcept
+    {
+        using result = core::Result< void >;
+
+        auto pVfs = IVirtualFileSystem::getDefault();
+        try {
+            nlohmann::json manifest;
+            manifest["shardCount"]      = static_cast< core::UInt32 >( m_shards.size() );
+            manifest["shardBackend"]    = shardBackendName( m_shardBackend );
+            const ::std::string text    = manifest.dump( 4 );
+
+            // Renamed into place: a torn manifest would make the instance unreadable
+            const core::String manifestPath = instancePath + "/" + MANIFEST_FILE;
+            const core::String tempPath = manifestPath + ".tmp";
+            auto writeResult = pVfs->WriteFile( tempPath, reinterpret_cast< const core::UInt8* >( text.data() ), text.size() );
+            if ( !writeResult.HasValue() ) return writeResult;
+            return pVfs->RenameFile( tempPath, manifestPath );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    void KvsShardedBackend::removeLegacy( const core::String& instancePath ) const noexcept
+    {
+        // Written by the non-sharded File (and Property) or SQLite backend, the manifest makes them unreachable
+        static const char* const s_fileLegacy[]     = { "/current/kvs_data.json", "/update/kvs_data.json",
+                                                        "/redundancy/kvs_data.json.bak", "/recovery/deleted_keys.json" };
+        static const char* const s_sqliteLegacy[]   = { "/current/db.sqlite", "/current/db.sqlite-wal",
+                                                        "/current/db.sqlite-shm", "/current/db.sqlite-journal" };
+
+        auto pVfs = IVirtualFileSystem::getDefault();
+        try {
+            for ( const auto* file : ( m_shardBackend == KvsBackendType::kvsSqlite ? s_sqliteLegacy : s_fileLegacy ) ) {
+                const core::String path = instancePath + file;
+                if ( !pVfs->Exists( path ) ) continue;
+
+                // Retried by the next open, a leftover only costs disk space
+                if ( !pVfs->RemoveFile( path ).HasValue() ) {
+                    LAP_PER_LOG_WARN << "Kvs migrated instance file removal failed: " << path;
+                }
+            }
+        } catch ( const ::std::bad_alloc& ) {
+            ;
+        }
+    }
+
+    core::Result< void > KvsShardedBackend::migrate( core::StringView identifier, const KvsSqliteTuning& tuning ) noexcept
+    {
+        using result = core::Result< void >;
+
+        try {
+            core::UniqueHandle< IKvsBackend > pLegacy;
+            if ( m_shardBackend == KvsBackendType::kvsSqlite ) {
+                pLegacy = ::std::make_unique< KvsSqliteBackend >( identifier, core::StringView(), tuning );
+            } else {
+                pLegacy = ::std::make_unique< KvsFileBackend >( identifier );
+            }
+            if ( !pLegacy->available() ) return result::FromError( PerErrc::kStorageNotFound );
+
+            auto keys = pLegacy->GetAllKeys();
+            if ( !keys.HasValue() ) return result::FromError( keys.Error() );
+
+            // Shards left by an interrupted migration are refilled from scratch
+            for ( core::UInt32 i = 0; i < m_shards.size(); ++i ) {
+                auto clearResult = m_shards[i]->RemoveAllKeys();
+                if ( !clearResult.HasValue() ) return clearResult;
+                touch( i );
+            }
+            for ( const auto& key : keys.Value() ) {
+                auto value = pLegacy->GetValue( key );
+                if ( !value.HasValue() ) return result::FromError( value.Error() );
+
+                auto setResult = shard( key ).SetValue( key, ::std::move( value.Value() ) );
+                if ( !setResult.HasValue() ) return setResult;
+            }
+
+            // The legacy files stay until the manifest is written, a crash before that migrates again
+            LAP_PER_LOG_INFO << "Kvs instance migrated into " << m_shards.size() << " shards: " << identifier << " (" << keys.Value().size() << " keys)";
+            return SyncToStorage();
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::Vector< core::String > > KvsShardedBackend::GetAllKeys() const noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        try {
+            core::Vector< core::String > keys;
+            for ( const auto& pShard : m_shards ) {
+                auto shardKeys = pShard->GetAllKeys();
+                if ( !shardKeys.HasValue() ) return result::FromError( shardKeys.Error() );
+
+                keys.insert( keys.end(), ::std::make_move_iterator( shardKeys.Value().begin() ),
+                                         ::std::make_move_iterator( shardKeys.Value().end() ) );
+            }
+            ::std::sort( keys.begin(), keys.end() );
+            return result::FromValue( ::std::move( keys ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::Bool > KvsShardedBackend::KeyExists( core::StringView key ) const noexcept
+    {
+        return shard( key ).KeyExists( key );
+    }
+
+    core::Result< KvsDataType > KvsShardedBackend::GetValue( core::StringView key ) const noexcept
+    {
+        return shard( key ).GetValue( key );
+    }
+
+    core::Result< void > KvsShardedBackend::SetValue( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).SetValue( key, value );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< void > KvsShardedBackend::SetValue( core::StringView key, KvsDataType &&value ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).SetValue( key, ::std::move( value ) );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< void > KvsShardedBackend::GetValueAssign( core::StringView key, KvsDataType &out ) const noexcept
+    {
+        return shard( key ).GetValueAssign( key, out );
+    }
+
+    core::Result< KvsDataType > KvsShardedBackend::GetValueHashed( core::StringView key, core::UInt64 hash ) const noexcept
+    {
+        return m_shards[ shardOf( hash ) ]->GetValueHashed( key, hash );
+    }
+
+    core::Result< void > KvsShardedBackend::SetValueHashed( core::StringView key, core::UInt64 hash, const KvsDataType &value ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = m_shards[ shardOf( hash ) ]->SetValueHashed( key, hash, value );
+        touch( shardOf( hash ) );
+        return retValue;
+    }
+
+    void KvsShardedBackend::ResolveKey( const KvsKeyHandle& handle ) const noexcept
+    {
+        m_shards[ shardOf( handle.Hash() ) ]->ResolveKey( handle );
+    }
+
+    core::Result< KvsDataType > KvsShardedBackend::GetValueResolved( const KvsKeyHandle& handle ) const noexcept
+    {
+        return m_shards[ shardOf( handle.Hash() ) ]->GetValueResolved( handle );
+    }
+
+    core::Result< void > KvsShardedBackend::SetValueResolved( const KvsKeyHandle& handle, const KvsDataType &value ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = m_shards[ shardOf( handle.Hash() ) ]->SetValueResolved( handle, value );
+        touch( shardOf( handle.Hash() ) );
+        return retValue;
+    }
+
+    core::Result< core::Size > KvsShardedBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept
+    {
+        return shard( key ).GetValueInto( key, type, buffer );
+    }
+
+    core::Result< KvsDataType > KvsShardedBackend::FetchAdd( core::StringView key, const KvsDataType &delta ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).FetchAdd( key, delta );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< core::Bool > KvsShardedBackend::CompareExchange( core::StringView key, const KvsDataType &expected, const KvsDataType &desired ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).CompareExchange( key, expected, desired );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< core::Bool > KvsShardedBackend::SetIfAbsent( core::StringView key, const KvsDataType &value ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).SetIfAbsent( key, value );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsShardedBackend::CreateSnapshot() const noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+
+        try {
+            core::Vector< core::SharedHandle< IKvsSnapshot > > shards;
+            shards.reserve( m_shards.size() );
+
+            // No write is in flight on any shard while the gate is held exclusively
+            core::WriteLockGuard gate( m_snapshotGate );
+            for ( const auto& pShard : m_shards ) {
+                auto snapshot = pShard->CreateSnapshot();
+                if ( !snapshot.HasValue() ) return result::FromError( snapshot.Error() );
+
+                shards.push_back( ::std::move( snapshot.Value() ) );
+            }
+
+            return result::FromValue( ::std::make_shared< ShardedSnapshot >( ::std::move( shards ) ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > KvsShardedBackend::RemoveKey( core::StringView key ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).RemoveKey( key );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< void > KvsShardedBackend::RecoverKey( core::StringView key ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).RecoverKey( key );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< void > KvsShardedBackend::ResetKey( core::StringView key ) noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        auto retValue = shard( key ).ResetKey( key );
+        touch( key );
+        return retValue;
+    }
+
+    core::Result< void > KvsShardedBackend::RemoveAllKeys() noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        for ( core::UInt32 i = 0; i < m_shards.size(); ++i ) {
+            auto retValue = m_shards[i]->RemoveAllKeys();
+            touch( i );
+            if ( !retValue.HasValue() ) return retValue;
+        }
+
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > KvsShardedBackend::syncShard( core::Size index ) noexcept
+    {
+        if ( !m_pDirty[index].exchange( false, ::std::memory_order_acq_rel ) ) return core::Result< void >::FromValue();
+
+        auto retValue = m_shards[index]->SyncToStorage();
+        if ( !retValue.HasValue() ) {
+            m_pDirty[index].store( true, ::std::memory_order_release );  // Retried by the next sync
+            LAP_PER_LOG_ERROR << "Kvs shard " << index << " sync failed";
+        }
+        return retValue;
+    }
+
+    core::Bool KvsShardedBackend::startWorkers() noexcept
+    {
+        if ( !m_workers.empty() ) return true;
+
+        // The caller syncs too, so one thread less than the shards that could run at once
+        const core::Size hardware = ::std::max( ::std::thread::hardware_concurrency(), 1u );
+        const core::Size count = ::std::min( { m_shards.size(), hardware, core::Size( MAX_SYNC_THREADS ) } ) - 1;
+        try {
+            m_workers.reserve( count );
+            while ( m_workers.size() < count ) m_workers.emplace_back( &KvsShardedBackend::workLoop, this );
+        } catch ( const ::std::exception& e ) {
+            // Out of threads: the ones started carry the load, or the caller alone
+            LAP_PER_LOG_EVERY_N( WARN, 16 ) << "Kvs shard sync thread start failed: " << e.what();
+        }
+        return !m_workers.empty();
+    }
+
+    void KvsShardedBackend::workLoop() noexcept
+    {
+        core::UInt64 pass = 0;
+        for ( ;; ) {
+            {
+                ::std::unique_lock< core::Mutex > lock( m_workMutex );
+                m_workCv.wait( lock, [this, pass]() { return m_stop || m_syncPass != pass; } );
+                if ( m_stop ) break;
+
+                pass = m_syncPass;
+                ++m_workersBusy;
+            }
+
+            claimShards();
+
+            {
+                core::LockGuard< core::Mutex > lock( m_workMutex );
+                --m_workersBusy;
+            }
+            m_idleCv.notify_all();
+        }
+    }
+
+    void KvsShardedBackend::claimShards() noexcept
+    {
+        for ( ;; ) {
+            const core::Size i = m_syncCursor.fetch_add( 1, ::std::memory_order_acq_rel );
+            if ( i >= m_shards.size() ) break;
+            m_syncResults[i] = syncShard( i );
+        }
+    }
+
+    core::Result< void > KvsShardedBackend::SyncToStorage() noexcept
+    {
+        auto syncInTurn = [this]() noexcept {
+            for ( core::Size i = 0; i < m_shards.size(); ++i ) {
+                auto retValue = syncShard( i );
+                if ( !retValue.HasValue() ) return retValue;
+            }
+            return core::Result< void >::FromValue();
+        };
+
+        core::Size dirty = 0;
+        for ( core::Size i = 0; i < m_shards.size(); ++i ) {
+            if ( m_pDirty[i].load( ::std::memory_order_acquire ) ) ++dirty;
+        }
+        if ( dirty <= 1 ) return syncInTurn();
+
+        core::LockGuard< core::Mutex > syncLock( m_syncMutex );
+        try {
+            m_syncResults.assign( m_shards.size(), core::Result< void >::FromValue() );
+        } catch ( const ::std::bad_alloc& ) {
+            // No memory for the results: sync on the caller's thread
+            return syncInTurn();
+        }
+        if ( !startWorkers() ) return syncInTurn();
+
+        {
+            core::LockGuard< core::Mutex > lock( m_workMutex );
+            m_syncCursor.store( 0, ::std::memory_order_release );
+            ++m_syncPass;
+        }
+        m_workCv.notify_all();
+
+        claimShards();
+        {
+            // A worker woken late finds nothing left to claim
+            ::std::unique_lock< core::Mutex > lock( m_workMutex );
+            m_idleCv.wait( lock, [this]() { return m_workersBusy == 0; } );
+        }
+
+        for ( const auto& retValue : m_syncResults ) {
+            if ( !retValue.HasValue() ) return retValue;
+        }
+
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< KvsSyncProgress > KvsShardedBackend::SyncToStorage( KvsSyncMeter& meter ) noexcept
+    {
+        using result = core::Result< KvsSyncProgress >;
+
+        // One dirty shard after the other, a finished one passes the budget on
+        KvsSyncProgress progress;
+        for ( core::Size i = 0; i < m_shards.size(); ++i ) {
+            // Cleared up front like syncShard() does, so a write racing the slice raises it again
+            if ( !m_pDirty[i].exchange( false, ::std::memory_order_acq_rel ) ) continue;
+
+            auto shardResult = m_shards[i]->SyncToStorage( meter );
+            if ( !shardResult.HasValue() ) {
+                m_pDirty[i].store( true, ::std::memory_order_release );
+                LAP_PER_LOG_ERROR << "Kvs shard " << i << " sync failed";
+                return shardResult;
+            }
+            if ( !shardResult.Value().complete ) m_pDirty[i].store( true, ::std::memory_order_release );
+
+            progress.complete           = progress.complete && shardResult.Value().complete;
+            progress.remainingRecords   += shardResult.Value().remainingRecords;
+            progress.remainingBytes     += shardResult.Value().remainingBytes;
+        }
+
+        return result::FromValue( progress );
+    }
+
+    core::Result< void > KvsShardedBackend::DiscardPendingChanges() noexcept
+    {
+        core::ReadLockGuard gate( m_snapshotGate );
+        for ( core::Size i = 0; i < m_shards.size(); ++i ) {
+            // A discarded shard matches its storage again, a write racing the discard raises the flag again
+            m_pDirty[i].store( false, ::std::memory_order_release );
+            auto retValue = m_shards[i]->DiscardPendingChanges();
+            if ( !retValue.HasValue() ) {
+                m_pDirty[i].store( true, ::std::memory_order_release );
+                return retValue;
+            }
+        }
+
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< core::UInt64 > KvsShardedBackend::GetSize() const noexcept
+    {
+        core::UInt64 size = 0;
+        for ( const auto& pShard : m_shards ) {
+            auto shardSize = pShard->GetSize();
+            if ( !shardSize.HasValue() ) return shardSize;
+            size += shardSize.Value();
+        }
+
+        return core::Result< core::UInt64 >::FromValue( size );
+    }
+
+    core::Result< core::UInt32 > KvsShardedBackend::GetKeyCount() const noexcept
+    {
+        core::UInt32 count = 0;
+        for ( const auto& pShard : m_shards ) {
+            auto shardCount = pShard->GetKeyCount();
+            if ( !shardCount.HasValue() ) return shardCount;
+            count += shardCount.Value();
+        }
+
+        return core::Result< core::UInt32 >::FromValue( count );
+    }
+
+} // namespace per
+} // namespace lap
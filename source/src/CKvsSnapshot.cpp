@@ -0,0 +1,452 @@
+/**
+ * @file CKvsSnapshot.cpp
+ * @brief Point-in-time read views of a KeyValueStorage
+ * @version 1.0
+ * @date 2025-11-23
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "CKvsSnapshot.hpp"
+#include "CKvsKey.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        inline core::StringView keyOf( const KvsMapSnapshot::Entry& entry ) noexcept
+        {
+            return core::StringView( entry.first.data(), entry.first.size() );
+        }
+
+        inline core::StringView keyOf( const KvsMapSnapshot::Change& change ) noexcept
+        {
+            return core::StringView( change.key.data(), change.key.size() );
+        }
+
+        struct KeyLess
+        {
+            template< class T >
+            core::Bool operator()( const T& lhs, core::StringView rhs ) const noexcept      { return keyOf( lhs ) < rhs; }
+            template< class T >
+            core::Bool operator()( core::StringView lhs, const T& rhs ) const noexcept      { return lhs < keyOf( rhs ); }
+            template< class T >
+            core::Bool operator()( const T& lhs, const T& rhs ) const noexcept              { return keyOf( lhs ) < keyOf( rhs ); }
+        };
+
+        template< class Items >
+        core::Size seekAfter( const Items& items, core::StringView key ) noexcept
+        {
+            return static_cast< core::Size >( ::std::upper_bound( items.begin(), items.end(), key, KeyLess{} ) - items.begin() );
+        }
+    }
+
+    // ==================== KvsMapSnapshot ====================
+
+    void KvsMapSnapshot::SortEntries( Entries& entries ) noexcept
+    {
+        ::std::sort( entries.begin(), entries.end(), KeyLess{} );
+    }
+
+    void KvsMapSnapshot::SortChanges( Changes& changes ) noexcept
+    {
+        ::std::sort( changes.begin(), changes.end(), KeyLess{} );
+    }
+
+    const KvsDataType* KvsMapSnapshot::find( core::StringView key ) const noexcept
+    {
+        // Newest layer first, the base last
+        for ( auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer ) {
+            auto it = ::std::lower_bound( ( *layer )->begin(), ( *layer )->end(), key, KeyLess{} );
+            if ( it != ( *layer )->end() && keyOf( *it ) == key ) return it->removed ? nullptr : &it->value;
+        }
+
+        auto it = ::std::lower_bound( m_pBase->begin(), m_pBase->end(), key, KeyLess{} );
+        if ( it == m_pBase->end() || keyOf( *it ) != key ) return nullptr;
+
+        return &it->second;
+    }
+
+    core::Result< core::Vector< core::String > > KvsMapSnapshot::GetAllKeys() const noexcept
+    {
+        using result = core::Result< core::Vector< core::String > >;
+
+        try {
+            core::Vector< core::String > keys;
+            keys.reserve( m_count );
+
+            Cursor cursor( *this );
+            core::StringView key;
+            const KvsDataType* value = nullptr;
+            while ( cursor.Next( key, value ) ) {
+                keys.emplace_back( key.data(), key.size() );
+            }
+            return result::FromValue( ::std::move( keys ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::Bool > KvsMapSnapshot::KeyExists( core::StringView key ) const noexcept
+    {
+        return core::Result< core::Bool >::FromValue( find( key ) != nullptr );
+    }
+
+    core::Result< KvsDataType > KvsMapSnapshot::GetValue( core::StringView key ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        auto* value = find( key );
+        if ( nullptr == value ) return result::FromError( PerErrc::kKeyNotFound );
+
+        try {
+            return result::FromValue( *value );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< core::UInt32 > KvsMapSnapshot::GetKeyCount() const noexcept
+    {
+        return core::Result< core::UInt32 >::FromValue( m_count );
+    }
+
+    // ==================== KvsMapSnapshot::Cursor ====================
+
+    KvsMapSnapshot::Cursor::Cursor( const KvsMapSnapshot& snapshot )
+        : m_snapshot( snapshot )
+        , m_positions( snapshot.m_layers.size() + 1, 0 )
+    {
+        ;
+    }
+
+    void KvsMapSnapshot::Cursor::Seek( core::StringView key ) noexcept
+    {
+        m_positions[0] = seekAfter( *m_snapshot.m_pBase, key );
+        for ( core::Size layer = 0; layer < m_snapshot.m_layers.size(); ++layer ) {
+            m_positions[layer + 1] = seekAfter( *m_snapshot.m_layers[layer], key );
+        }
+    }
+
+    core::StringView KvsMapSnapshot::Cursor::keyAt( core::Size source ) const noexcept
+    {
+        const core::Size position = m_positions[source];
+        if ( source == 0 ) {
+            return position < m_snapshot.m_pBase->size() ? keyOf( ( *m_snapshot.m_pBase )[position] ) : core::StringView();
+        }
+        const auto& layer = *m_snapshot.m_layers[source - 1];
+        return position < layer.size() ? keyOf( layer[position] ) : core::StringView();
+    }
+
+    core::Bool KvsMapSnapshot::Cursor::Next( core::StringView& key, const KvsDataType*& value ) noexcept
+    {
+        for ( ;; ) {
+            // Smallest key at the sources' heads; the newest source holding it decides
+            core::Size winner = m_positions.size();
+            for ( core::Size source = 0; source < m_positions.size(); ++source ) {
+                const core::Size size = source == 0 ? m_snapshot.m_pBase->size() : m_snapshot.m_layers[source - 1]->size();
+                if ( m_positions[source] >= size ) continue;
+                if ( winner == m_positions.size() || keyAt( source ) <= key ) {
+                    key = keyAt( source );
+                    winner = source;
+                }
+            }
+            if ( winner == m_positions.size() ) return false;
+
+            core::Bool removed = false;
+            if ( winner == 0 ) {
+                value = &( *m_snapshot.m_pBase )[m_positions[0]].second;
+            } else {
+                const auto& change = ( *m_snapshot.m_layers[winner - 1] )[m_positions[winner]];
+                removed = change.removed;
+                value = &change.value;
+            }
+
+            for ( core::Size source = 0; source <= winner; ++source ) {
+                const core::Size size = source == 0 ? m_snapshot.m_pBase->size() : m_snapshot.m_layers[source - 1]->size();
+                if ( m_positions[source] < size && keyAt( source ) == key ) ++m_positions[source];
+            }
+            if ( !removed ) return true;
+        }
+    }
+
+    // ==================== KvsSnapshotCache ====================
+
+    void KvsSnapshotCache::Changed( core::StringView key ) noexcept
+    {
+        if ( !m_bTracking || m_bLost ) return;
+
+        try {
+            m_changed.emplace( key.data(), key.size() );
+        } catch ( const ::std::bad_alloc& ) {
+            m_bLost = true;
+        }
+        if ( m_bLost || m_changed.size() > m_trackLimit ) {
+            // Decoding this many keys under the shared lock would cost more than a new base
+            m_bLost = true;
+            m_changed.clear();
+        }
+    }
+
+    void KvsSnapshotCache::Cleared() noexcept
+    {
+        if ( !m_bTracking ) return;
+
+        // The map is known again: empty, plus whatever changes next
+        m_bLost = false;
+        m_bCleared = true;
+        m_changed.clear();
+    }
+
+    void KvsSnapshotCache::Invalidate() noexcept
+    {
+        if ( !m_bTracking ) return;
+
+        m_bLost = true;
+        m_bCleared = false;
+        m_changed.clear();
+    }
+
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsSnapshotCache::Acquire( core::RWLock& lock, const ChunkReader& readChunk,
+                                                                                  const KeyReader& readKey ) noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+
+        core::LockGuard< core::Mutex > guard( m_mutex );
+
+        try {
+            auto updated = m_pCurrent ? update( lock, readKey ) : core::Result< core::Bool >::FromValue( false );
+            if ( !updated.HasValue() ) return result::FromError( updated.Error() );
+
+            if ( !updated.Value() ) {
+                auto built = rebuild( lock, readChunk, readKey );
+                if ( !built.HasValue() ) return result::FromError( built.Error() );
+            }
+
+            compact();
+            return result::FromValue( core::SharedHandle< IKvsSnapshot >( m_pCurrent ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        } catch ( const ::std::exception& ) {
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+    }
+
+    core::Result< void > KvsSnapshotCache::readChanges( const KeyReader& readKey, KvsMapSnapshot::Changes& changes )
+    {
+        using result = core::Result< void >;
+
+        changes.reserve( changes.size() + m_changed.size() );
+        for ( const auto& key : m_changed ) {
+            KvsMapSnapshot::Change change;
+            change.key = key;
+            auto found = readKey( core::StringView( key.data(), key.size() ), change.value );
+            if ( !found.HasValue() ) return result::FromError( found.Error() );
+
+            change.removed = !found.Value();
+            changes.push_back( ::std::move( change ) );
+        }
+        m_changed.clear();
+
+        return result::FromValue();
+    }
+
+    core::Result< core::Bool > KvsSnapshotCache::update( core::RWLock& lock, const KeyReader& readKey )
+    {
+        using result = core::Result< core::Bool >;
+
+        KvsMapSnapshot::Changes changes;
+        core::Bool cleared = false;
+        {
+            core::ReadLockGuard shared( lock );
+            if ( m_bLost ) return result::FromValue( false );
+            if ( !m_bCleared && m_changed.empty() ) return result::FromValue( true );
+
+            auto read = readChanges( readKey, changes );
+            if ( !read.HasValue() ) return result::FromError( read.Error() );
+
+            cleared = m_bCleared;
+            m_bCleared = false;
+            m_trackLimit = ::std::max( CHUNK_ENTRIES, ( static_cast< core::Size >( m_pCurrent->m_count ) + changes.size() ) / 4 );
+        }
+
+        // The rest works on immutable state only, writers may go on
+        if ( cleared ) {
+            m_pCurrent = ::std::make_shared< KvsMapSnapshot >( ::std::make_shared< const KvsMapSnapshot::Entries >(),
+                                                               KvsMapSnapshot::Layers(), 0 );
+        }
+        addLayer( ::std::move( changes ) );
+
+        return result::FromValue( true );
+    }
+
+    core::Result< void > KvsSnapshotCache::rebuild( core::RWLock& lock, const ChunkReader& readChunk, const KeyReader& readKey )
+    {
+        using result = core::Result< void >;
+
+        m_pCurrent.reset();
+
+        auto entries = ::std::make_shared< KvsMapSnapshot::Entries >();
+        KvsMapSnapshot::Changes changes;
+        core::Bool started = false;
+        for ( ;; ) {
+            core::ReadLockGuard shared( lock );
+            if ( !started || m_bLost ) {
+                // Record changes from the first chunk on; when some went unrecorded, copy again
+                m_bTracking = true;
+                m_bLost = false;
+                m_bCleared = false;
+                m_changed.clear();
+                m_trackLimit = ::std::numeric_limits< core::Size >::max();
+                entries->clear();
+                started = true;
+            } else if ( m_bCleared ) {
+                m_bCleared = false;
+                entries->clear();
+            }
+
+            auto done = readChunk( *entries, CHUNK_ENTRIES );
+            if ( done.HasValue() && done.Value() ) {
+                // Keys changed behind the copy, decoded under the same lock as the last chunk
+                auto read = readChanges( readKey, changes );
+                if ( read.HasValue() ) {
+                    m_trackLimit = ::std::max( CHUNK_ENTRIES, ( entries->size() + changes.size() ) / 4 );
+                    break;
+                }
+                done = core::Result< core::Bool >::FromError( read.Error() );
+            }
+            if ( !done.HasValue() ) {
+                m_bLost = true;
+                m_changed.clear();
+                return result::FromError( done.Error() );
+            }
+        }
+
+        KvsMapSnapshot::SortEntries( *entries );
+        const auto count = static_cast< core::UInt32 >( entries->size() );
+        m_pCurrent = ::std::make_shared< KvsMapSnapshot >( ::std::move( entries ), KvsMapSnapshot::Layers(), count );
+        if ( !changes.empty() ) {
+            addLayer( ::std::move( changes ) );
+        }
+
+        return result::FromValue();
+    }
+
+    void KvsSnapshotCache::addLayer( KvsMapSnapshot::Changes&& changes )
+    {
+        KvsMapSnapshot::SortChanges( changes );
+
+        const auto& current = *m_pCurrent;
+        core::UInt32 count = current.m_count;
+        for ( const auto& change : changes ) {
+            const core::Bool existed = current.find( keyOf( change ) ) != nullptr;
+            if ( change.removed && existed ) {
+                --count;
+            } else if ( !change.removed && !existed ) {
+                ++count;
+            }
+        }
+
+        auto layers = current.m_layers;
+        layers.push_back( ::std::make_shared< const KvsMapSnapshot::Changes >( ::std::move( changes ) ) );
+        m_pCurrent = ::std::make_shared< KvsMapSnapshot >( current.m_pBase, ::std::move( layers ), count );
+    }
+
+    void KvsSnapshotCache::compact() noexcept
+    {
+        const auto& current = *m_pCurrent;
+
+        core::Size changed = 0;
+        for ( const auto& layer : current.m_layers ) {
+            changed += layer->size();
+        }
+        if ( current.m_layers.size() <= MAX_LAYERS && changed * 4 <= current.m_pBase->size() ) return;
+
+        // Snapshots already handed out keep the old base and layers alive
+        try {
+            auto base = ::std::make_shared< KvsMapSnapshot::Entries >();
+            base->reserve( current.m_count );
+
+            KvsMapSnapshot::Cursor cursor( current );
+            core::StringView key;
+            const KvsDataType* value = nullptr;
+            while ( cursor.Next( key, value ) ) {
+                base->emplace_back( core::String( key.data(), key.size() ), *value );
+            }
+            m_pCurrent = ::std::make_shared< KvsMapSnapshot >( ::std::move( base ), KvsMapSnapshot::Layers(), current.m_count );
+        } catch ( const ::std::bad_alloc& ) {
+            // Keep the layers, the next snapshot tries again
+        }
+    }
+
+    // ==================== KvsSnapshot ====================
+
+    core::Result< core::Vector< core::String > > KvsSnapshot::GetAllKeys() const noexcept
+    {
+        if ( !m_pSnapshot ) return core::Result< core::Vector< core::String > >::FromError( PerErrc::kNotInitialized );
+
+        return m_pSnapshot->GetAllKeys();
+    }
+
+    core::Result< core::Bool > KvsSnapshot::KeyExists( core::StringView key ) const noexcept
+    {
+        if ( !m_pSnapshot ) return core::Result< core::Bool >::FromError( PerErrc::kNotInitialized );
+
+        return m_pSnapshot->KeyExists( key );
+    }
+
+    core::Result< core::UInt32 > KvsSnapshot::GetKeyCount() const noexcept
+    {
+        if ( !m_pSnapshot ) return core::Result< core::UInt32 >::FromError( PerErrc::kNotInitialized );
+
+        return m_pSnapshot->GetKeyCount();
+    }
+
+    template< class T >
+    core::Result< T > KvsSnapshot::GetValue( core::StringView key ) const noexcept
+    {
+        using result = core::Result< T >;
+
+        if ( !m_pSnapshot ) return result::FromError( PerErrc::kNotInitialized );
+
+        auto retValue = m_pSnapshot->GetValue( key );
+        if ( !retValue.HasValue() ) {
+            return result::FromError( retValue.Error() );
+        }
+        if ( ::lap::core::GetVariantIndex( retValue.Value() ) != KvsKey< T >::Index ) {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+
+        return result::FromValue( ::lap::core::get< T >( ::std::move( retValue.Value() ) ) );
+    }
+
+    template core::Result< core::Int8 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::UInt8 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Int16 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::UInt16 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Int32 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::UInt32 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Int64 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::UInt64 > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Bool > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Float > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::Double > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< core::String > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsBlob > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsInt8Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsInt16Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsUInt16Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsInt32Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsUInt32Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsInt64Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsUInt64Array > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsFloatArray > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+    template core::Result< KvsDoubleArray > KvsSnapshot::GetValue( core::StringView ) const noexcept;
+
+} // namespace per
+} // namespace lap
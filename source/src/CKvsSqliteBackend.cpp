@@ -1,20 +1,272 @@
 #include "CKvsSqliteBackend.hpp"
 #include "CStoragePathManager.hpp"
+#include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <map>
 
 namespace lap
 {
 namespace per
 {
+namespace
+{
+    // Quoted identifier "name:instance", quotes inside doubled
+    core::String quoteScopedName( core::StringView name, core::StringView instance )
+    {
+        core::String quoted( "\"" );
+        quoted.append( name.data(), name.size() );
+        quoted += ':';
+        for( char c : instance )
+        {
+            if( c == '"' ) quoted += '"';
+            quoted += c;
+        }
+        quoted += '"';
+        return quoted;
+    }
+    
+    // The keyword of keywords that value names (any case), else fallback
+    template < core::Size N >
+    const char* pragmaKeyword( const char* pragma, const core::String& value, const char* const ( &keywords )[ N ], const char* fallback ) noexcept
+    {
+        for( const char* keyword : keywords )
+        {
+            if( value.size() == ::std::strlen( keyword ) &&
+                ::std::equal( value.begin(), value.end(), keyword, []( char a, char b ) {
+                    return ::std::toupper( static_cast< unsigned char >( a ) ) == b;
+                } ) )
+            {
+                return keyword;
+            }
+        }
+        LAP_PER_LOG_WARN << "Invalid SQLite " << pragma << " '" << core::StringView( value ) << "', using " << fallback;
+        return fallback;
+    }
+} // namespace
+
+    // ==================== Connection ====================
+    
+    /**
+     * @brief Database connection with its transaction and WAL state
+     *
+     * Owned by one backend, or by all instances of a shared database in the process:
+     * they serialize on its mutex and share its page cache, WAL and checkpoints.
+     */
+    class KvsSqliteBackend::Connection final
+    {
+    public:
+        IMP_OPERATOR_NEW(Connection)
+        
+        ~Connection() noexcept
+        {
+            if( m_pDB )
+            {
+                sqlite3_close( m_pDB );
+                LAP_PER_LOG_DEBUG << "SQLite database closed: " << core::StringView( m_strFile );
+            }
+        }
+        
+        /**
+         * @brief Open a connection of its own to @p file
+         */
+        static core::Result< core::SharedHandle< Connection > > open( const core::String& file, const KvsSqliteTuning& tuning ) noexcept
+        {
+            using result = core::Result< core::SharedHandle< Connection > >;
+            
+            core::SharedHandle< Connection > connection;
+            try
+            {
+                connection = ::std::make_shared< Connection >();
+                connection->m_strFile = file;
+            }
+            catch( const ::std::bad_alloc& )
+            {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+            
+            auto opened = connection->configure( tuning );
+            if( !opened.HasValue() )
+            {
+                return result::FromError( opened.Error() );
+            }
+            return result::FromValue( ::std::move( connection ) );
+        }
+        
+        /**
+         * @brief The process-wide connection to the shared database @p file, opened by its first user
+         * @note Configured with the tuning of that user, later users get it as it is
+         */
+        static core::Result< core::SharedHandle< Connection > > share( const core::String& file, const KvsSqliteTuning& tuning ) noexcept
+        {
+            using result = core::Result< core::SharedHandle< Connection > >;
+            
+            static core::Mutex registryMutex;
+            static ::std::map< core::String, ::std::weak_ptr< Connection > > registry;
+            
+            core::LockGuard lock( registryMutex );
+            try
+            {
+                auto& entry = registry[ file ];
+                if( auto connection = entry.lock() )
+                {
+                    return result::FromValue( ::std::move( connection ) );
+                }
+                
+                auto opened = open( file, tuning );
+                if( opened.HasValue() )
+                {
+                    entry = opened.Value();
+                }
+                return opened;
+            }
+            catch( const ::std::bad_alloc& )
+            {
+                return result::FromError( PerErrc::kOutOfMemorySpace );
+            }
+        }
+        
+        sqlite3*                            db() const noexcept                 { return m_pDB; }
+        
+        /**
+         * @brief Reset the statements of all users still stepping, caller holds mutex
+         * @note Lookups return after their first row and stay pending until the next reset,
+         *       an active statement on the connection would lock a checkpoint out
+         */
+        void resetPendingStatements() noexcept
+        {
+            for( sqlite3_stmt* stmt = sqlite3_next_stmt( m_pDB, nullptr ); stmt; stmt = sqlite3_next_stmt( m_pDB, stmt ) )
+            {
+                if( sqlite3_stmt_busy( stmt ) ) sqlite3_reset( stmt );
+            }
+        }
+        
+        void noteCheckpoint( core::Int32 log, core::Int32 checkpointed ) noexcept
+        {
+            // -1 when the database is not in WAL mode
+            walFrames = static_cast< core::UInt64 >( ::std::max( log, 0 ) );
+            walCheckpointed = ::std::min( static_cast< core::UInt64 >( ::std::max( checkpointed, 0 ) ), walFrames );
+        }
+        
+    public:
+        mutable core::Mutex                 mutex;                      ///< Guards the connection, its statements and the fields below
+        core::Bool                          inTransaction{ false };
+        
+        // WAL state
+        core::UInt64                        pageSize{ 4096 };
+        core::UInt64                        walFrames{ 0 };             ///< Frames in the WAL after the last commit or checkpoint
+        core::UInt64                        walCheckpointed{ 0 };       ///< Frames of those copied back into the database
+        core::UInt64                        checkpointNsPerFrame{ 0 };  ///< Cost of the last checkpoint, 0 until one copied frames
+        core::UInt32                        walAutocheckpoint{ 0 };     ///< KvsSqliteTuning::walAutocheckpoint
+        
+        // Inserts per instance of a shared database, see KvsSqliteBackend::m_pInserts
+        ::std::map< core::String, core::UInt64 >    inserts;
+        
+    private:
+        core::Result< void > configure( const KvsSqliteTuning& tuning ) noexcept
+        {
+            // Open database with proper flags
+            core::Int32 flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
+            core::Int32 rc = sqlite3_open_v2( m_strFile.c_str(), &m_pDB, flags, nullptr );
+            
+            if( rc != SQLITE_OK )
+            {
+                LAP_PER_LOG_ERROR << "Failed to open SQLite database: " << sqlite3_errmsg( m_pDB );
+                if( m_pDB )
+                {
+                    sqlite3_close( m_pDB );
+                    m_pDB = nullptr;
+                }
+                return core::Result< void >::FromError( makeErrorCode( rc ) );
+            }
+            
+            static constexpr const char* JOURNAL_MODES[]    = { "WAL", "DELETE", "TRUNCATE", "PERSIST" };
+            static constexpr const char* SYNCHRONOUS[]      = { "OFF", "NORMAL", "FULL", "EXTRA" };
+            static constexpr const char* TEMP_STORES[]      = { "DEFAULT", "FILE", "MEMORY" };
+            
+            // Keywords are validated, numbers formatted: nothing from the configuration reaches SQL verbatim
+            ::std::ostringstream pragmas;
+            // Before the first write fixes it; a database in WAL mode keeps the size it was created with
+            if( tuning.pageSize != 0 )
+            {
+                pragmas << "PRAGMA page_size=" << tuning.pageSize << ";";
+            }
+            // Exclusive locking first, so WAL mode uses no shared memory index
+            if( tuning.exclusiveLocking )
+            {
+                pragmas << "PRAGMA locking_mode=EXCLUSIVE;";
+            }
+            pragmas << "PRAGMA journal_mode=" << pragmaKeyword( "journal_mode", tuning.journalMode, JOURNAL_MODES, "WAL" ) << ";"
+                    << "PRAGMA synchronous=" << pragmaKeyword( "synchronous", tuning.synchronous, SYNCHRONOUS, "NORMAL" ) << ";"
+                    << "PRAGMA cache_size=" << tuning.cacheSize << ";"
+                    << "PRAGMA mmap_size=" << tuning.mmapSize << ";"
+                    << "PRAGMA temp_store=" << pragmaKeyword( "temp_store", tuning.tempStore, TEMP_STORES, "DEFAULT" ) << ";";
+            
+            // Each PRAGMA on its own, one that fails is logged and the others still apply
+            const ::std::string statements = pragmas.str();
+            for( core::Size begin = 0, end; begin < statements.size(); begin = end + 1 )
+            {
+                end = statements.find( ';', begin );
+                const ::std::string pragma = statements.substr( begin, end - begin + 1 );
+                char* errMsg = nullptr;
+                rc = sqlite3_exec( m_pDB, pragma.c_str(), nullptr, nullptr, &errMsg );
+                if( rc != SQLITE_OK )
+                {
+                    LAP_PER_LOG_WARN << "Failed to apply " << core::StringView( pragma ) << ": " << ( errMsg ? errMsg : "unknown error" );
+                }
+                if( errMsg ) sqlite3_free( errMsg );
+            }
+            
+            // Track the WAL size for incremental syncs; the hook takes over SQLite's auto-checkpoint
+            walAutocheckpoint = tuning.walAutocheckpoint;
+            sqlite3_wal_hook( m_pDB, &Connection::walHook, this );
+            rc = sqlite3_exec( m_pDB, "PRAGMA page_size;",
+                               []( void* pageSize, core::Int32 columns, char** values, char** ) {
+                                   if( columns > 0 && values[0] ) *static_cast< core::UInt64* >( pageSize ) = ::std::strtoull( values[0], nullptr, 10 );
+                                   return 0;
+                               }, &pageSize, nullptr );
+            
+            return core::Result< void >::FromValue();
+        }
+        
+        // Called by the committing operation, with mutex held
+        static core::Int32 walHook( void* connection, sqlite3* db, const char* name, core::Int32 frames ) noexcept
+        {
+            auto* self = static_cast< Connection* >( connection );
+            
+            // A WAL that restarted from its beginning has nothing checkpointed yet
+            self->walFrames = static_cast< core::UInt64 >( frames );
+            if( self->walCheckpointed > self->walFrames ) self->walCheckpointed = 0;
+            
+            if( self->walAutocheckpoint != 0 && static_cast< core::UInt32 >( frames ) >= self->walAutocheckpoint )
+            {
+                core::Int32 log = 0;
+                core::Int32 checkpointed = 0;
+                if( sqlite3_wal_checkpoint_v2( db, name, SQLITE_CHECKPOINT_PASSIVE, &log, &checkpointed ) == SQLITE_OK )
+                {
+                    self->noteCheckpoint( log, checkpointed );
+                }
+            }
+            return SQLITE_OK;
+        }
+        
+    private:
+        core::String                        m_strFile;
+        sqlite3*                            m_pDB{ nullptr };
+    };
+
     // ==================== Constructor/Destructor ====================
     
-    KvsSqliteBackend::KvsSqliteBackend( core::StringView identifier )
-        : m_strFile()
+    KvsSqliteBackend::KvsSqliteBackend( core::StringView identifier, core::StringView sharedDatabase, const KvsSqliteTuning& tuning )
+        : m_bShared( !sharedDatabase.empty() )
+        , m_strFile()
     {
-        // Use AUTOSAR 4-layer directory structure with /current/db.sqlite
-        core::String instancePath = CStoragePathManager::getKvsInstancePath( identifier );
+        // Use AUTOSAR 4-layer directory structure with /current/db.sqlite, the shared database's in shared mode
+        core::String instancePath = CStoragePathManager::getKvsInstancePath( m_bShared ? sharedDatabase : identifier );
         
         // Ensure directory exists - create the 4-layer structure
         if (!core::Path::createDirectory(instancePath + "/current") ||
@@ -28,6 +280,44 @@ namespace per
         
         // Database file in /current directory
         m_strFile = instancePath + "/current/db.sqlite";
+        try
+        {
+            if( m_bShared )
+            {
+                m_strInstance = core::String( identifier );
+            }
+            buildSql();
+        }
+        catch( const ::std::bad_alloc& )
+        {
+            LAP_PER_LOG_ERROR << "Failed to build statements for: " << identifier;
+            return;
+        }
+        
+        {
+            auto connection = m_bShared ? Connection::share( m_strFile, tuning ) : Connection::open( m_strFile, tuning );
+            if( !connection.HasValue() )
+            {
+                LAP_PER_LOG_ERROR << "Failed to open database: " << identifier;
+                return;
+            }
+            m_pConnection = ::std::move( connection.Value() );
+            m_pDB = m_pConnection->db();
+        }
+        
+        if( m_bShared )
+        {
+            core::LockGuard lock( m_pConnection->mutex );
+            try
+            {
+                m_pInserts = &m_pConnection->inserts[ m_strInstance ];
+            }
+            catch( const ::std::bad_alloc& )
+            {
+                LAP_PER_LOG_ERROR << "Failed to register instance in shared database: " << identifier;
+                return;
+            }
+        }
         
         {
             auto result = initializeDatabase();
@@ -47,13 +337,23 @@ namespace per
             }
         }
         
+        {
+            core::LockGuard lock( m_pConnection->mutex );
+            rebuildBloom();
+        }
+        
         m_bAvailable = true;
-        LAP_PER_LOG_INFO << "SQLite backend initialized successfully: " << identifier << " -> " << core::StringView(m_strFile);
+        LAP_PER_LOG_INFO << "SQLite backend initialized successfully: " << identifier << " -> " << core::StringView(m_strFile)
+                         << ( m_bShared ? " (shared)" : "" );
     }
 
     KvsSqliteBackend::KvsSqliteBackend( KvsSqliteBackend&& kvs )
         : m_bAvailable( kvs.m_bAvailable )
+        , m_bShared( kvs.m_bShared )
         , m_strFile( ::std::move( kvs.m_strFile ) )
+        , m_strInstance( ::std::move( kvs.m_strInstance ) )
+        , m_sql( ::std::move( kvs.m_sql ) )
+        , m_pConnection( ::std::move( kvs.m_pConnection ) )
         , m_pDB( kvs.m_pDB )
         , m_pStmtInsert( kvs.m_pStmtInsert )
         , m_pStmtUpdate( kvs.m_pStmtUpdate )
@@ -61,7 +361,17 @@ namespace per
         , m_pStmtExists( kvs.m_pStmtExists )
         , m_pStmtDelete( kvs.m_pStmtDelete )
         , m_pStmtGetAll( kvs.m_pStmtGetAll )
-        , m_bInTransaction( kvs.m_bInTransaction )
+        , m_pStmtInsertIfAbsent( kvs.m_pStmtInsertIfAbsent )
+        , m_pStmtCompareSwap( kvs.m_pStmtCompareSwap )
+        , m_pStmtDataVersion( kvs.m_pStmtDataVersion )
+        , m_bloom( ::std::move( kvs.m_bloom ) )
+        , m_bloomStats( kvs.m_bloomStats )
+        , m_bloomDataVersion( kvs.m_bloomDataVersion )
+        , m_bloomValid( kvs.m_bloomValid )
+        , m_bloomUnfiltered( kvs.m_bloomUnfiltered )
+        , m_bloomRemoved( kvs.m_bloomRemoved )
+        , m_pInserts( kvs.m_pInserts )
+        , m_bloomInserts( kvs.m_bloomInserts )
     {
         kvs.m_pDB = nullptr;
         kvs.m_pStmtInsert = nullptr;
@@ -70,93 +380,83 @@ namespace per
         kvs.m_pStmtExists = nullptr;
         kvs.m_pStmtDelete = nullptr;
         kvs.m_pStmtGetAll = nullptr;
+        kvs.m_pStmtInsertIfAbsent = nullptr;
+        kvs.m_pStmtCompareSwap = nullptr;
+        kvs.m_pStmtDataVersion = nullptr;
+        kvs.m_bloomValid = false;
         kvs.m_bAvailable = false;
-        kvs.m_bInTransaction = false;
     }
 
     KvsSqliteBackend::~KvsSqliteBackend()
     {
-        if( m_bInTransaction )
+        if( !m_pConnection )
         {
-            rollbackTransaction();
+            return;
         }
         
-        finalizeStatements();
-        
-        if( m_pDB )
+        // Other instances of a shared database keep using the connection
+        core::LockGuard lock( m_pConnection->mutex );
+        if( m_pConnection->inTransaction )
         {
-            sqlite3_close( m_pDB );
-            m_pDB = nullptr;
-            LAP_PER_LOG_DEBUG << "SQLite database closed: " << core::StringView(m_strFile);
+            rollbackTransaction();
         }
+        
+        finalizeStatements();
     }
 
     // ==================== Database Initialization ====================
     
-    core::Result< void > KvsSqliteBackend::initializeDatabase() noexcept
+    void KvsSqliteBackend::buildSql()
     {
-        core::LockGuard lock( m_mutex );
-        
-        // Open database with proper flags
-        core::Int32 flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
-        core::Int32 rc = sqlite3_open_v2( m_strFile.c_str(), &m_pDB, flags, nullptr );
-        
-        if( rc != SQLITE_OK )
-        {
-            LAP_PER_LOG_ERROR << "Failed to open SQLite database: " << sqlite3_errmsg( m_pDB );
-            if( m_pDB )
-            {
-                sqlite3_close( m_pDB );
-                m_pDB = nullptr;
-            }
-            return core::Result< void >::FromError( makeErrorCode( rc ) );
-        }
-        
-        // Enable WAL mode for better concurrency and performance
-        char* errMsg = nullptr;
-        rc = sqlite3_exec( m_pDB, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg );
-        if( rc != SQLITE_OK )
-        {
-            LAP_PER_LOG_WARN << "Failed to enable WAL mode: " << ( errMsg ? errMsg : "unknown error" );
-            if( errMsg ) sqlite3_free( errMsg );
-        }
-        
-        // Set synchronous to NORMAL for better performance (still safe with WAL)
-        rc = sqlite3_exec( m_pDB, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, &errMsg );
-        if( rc != SQLITE_OK )
-        {
-            LAP_PER_LOG_WARN << "Failed to set synchronous mode: " << ( errMsg ? errMsg : "unknown error" );
-            if( errMsg ) sqlite3_free( errMsg );
-        }
-        
-        // Increase cache size (default is ~2MB, we use 10MB)
-        rc = sqlite3_exec( m_pDB, "PRAGMA cache_size=-10000;", nullptr, nullptr, &errMsg );
-        if( rc != SQLITE_OK )
-        {
-            LAP_PER_LOG_WARN << "Failed to set cache size: " << ( errMsg ? errMsg : "unknown error" );
-            if( errMsg ) sqlite3_free( errMsg );
-        }
+        // The instance's own table and indexes in a shared database, quoted as "name:instance"
+        const core::String table        = m_bShared ? quoteScopedName( "kvs_data", m_strInstance ) : core::String( "kvs_data" );
+        const core::String deletedIndex = m_bShared ? quoteScopedName( "idx_deleted", m_strInstance ) : core::String( "idx_deleted" );
+        const core::String typeIndex    = m_bShared ? quoteScopedName( "idx_type", m_strInstance ) : core::String( "idx_type" );
         
-        // Enable memory-mapped I/O (64MB)
-        rc = sqlite3_exec( m_pDB, "PRAGMA mmap_size=67108864;", nullptr, nullptr, &errMsg );
-        if( rc != SQLITE_OK )
-        {
-            LAP_PER_LOG_WARN << "Failed to set mmap size: " << ( errMsg ? errMsg : "unknown error" );
-            if( errMsg ) sqlite3_free( errMsg );
-        }
+        // Type mapping: 0=Int8, 1=UInt8, 2=Int16, 3=UInt16, 4=Int32, 5=UInt32,
+        //               6=Int64, 7=UInt64, 8=Bool, 9=Float, 10=Double, 11=String, 12=Blob, 13..21=numeric arrays
+        m_sql.createTable           = "CREATE TABLE IF NOT EXISTS " + table + " ("
+                                      "    key TEXT PRIMARY KEY NOT NULL,"
+                                      "    type INTEGER NOT NULL,"      // Type as INTEGER, not prefix
+                                      "    value TEXT NOT NULL,"       // Blob values keep BLOB storage class (no affinity conversion)
+                                      "    deleted INTEGER DEFAULT 0"
+                                      ") WITHOUT ROWID;";  // WITHOUT ROWID for better performance with TEXT primary key
+        
+        // Secondary indexes, a bulk import drops them and builds them once after the load
+        m_sql.createDeletedIndex    = "CREATE INDEX IF NOT EXISTS " + deletedIndex + " ON " + table + "(deleted);";
+        m_sql.createTypeIndex       = "CREATE INDEX IF NOT EXISTS " + typeIndex + " ON " + table + "(type) WHERE deleted = 0;";
+        m_sql.dropIndexes           = "DROP INDEX IF EXISTS " + deletedIndex + "; DROP INDEX IF EXISTS " + typeIndex + ";";
+        
+        m_sql.insert                = "INSERT OR REPLACE INTO " + table + " (key, type, value, deleted) VALUES (?, ?, ?, 0);";
+        m_sql.update                = "UPDATE " + table + " SET type = ?, value = ?, deleted = 0 WHERE key = ?;";
+        m_sql.select                = "SELECT type, value FROM " + table + " WHERE key = ? AND deleted = 0;";
+        m_sql.exists                = "SELECT 1 FROM " + table + " WHERE key = ? AND deleted = 0 LIMIT 1;";
+        m_sql.remove                = "UPDATE " + table + " SET deleted = 1 WHERE key = ?;";
+        m_sql.getAll                = "SELECT key FROM " + table + " WHERE deleted = 0;";
+        // UPSERT: only revives a soft-deleted row, never overwrites a live one
+        m_sql.insertIfAbsent        = "INSERT INTO " + table + " (key, type, value, deleted) VALUES (?, ?, ?, 0) "
+                                      "ON CONFLICT(key) DO UPDATE SET type = excluded.type, value = excluded.value, deleted = 0 "
+                                      "WHERE deleted = 1;";
+        // New type/value, key, expected type/value
+        m_sql.compareSwap           = "UPDATE " + table + " SET type = ?, value = ? "
+                                      "WHERE key = ? AND deleted = 0 AND type = ? AND value = ?;";
+        m_sql.recover               = "UPDATE " + table + " SET deleted = 0 WHERE key = ?;";
+        m_sql.reset                 = "DELETE FROM " + table + " WHERE key = ?;";
+        m_sql.removeAll             = "UPDATE " + table + " SET deleted = 1;";
+        m_sql.purgeDeleted          = "DELETE FROM " + table + " WHERE deleted = 1;";
+        m_sql.exportBatch           = "SELECT type, value, key FROM " + table + " WHERE deleted = 0 AND key >= ? ORDER BY key LIMIT ?;";
+        m_sql.countRows             = "SELECT COUNT(*) FROM " + table + ";";
+        m_sql.countLive             = "SELECT COUNT(*) FROM " + table + " WHERE deleted = 0;";
+        m_sql.liveSize              = "SELECT COALESCE( SUM( LENGTH( key ) + LENGTH( value ) ), 0 ) FROM " + table + " WHERE deleted = 0;";
+    }
+    
+    core::Result< void > KvsSqliteBackend::initializeDatabase() noexcept
+    {
+        core::LockGuard lock( m_pConnection->mutex );
         
         // Create table with optimized schema (type as separate INTEGER column)
-        // Type mapping: 0=Int8, 1=UInt8, 2=Int16, 3=UInt16, 4=Int32, 5=UInt32,
-        //               6=Int64, 7=UInt64, 8=Bool, 9=Float, 10=Double, 11=String
-        const char* createTableSQL = 
-            "CREATE TABLE IF NOT EXISTS kvs_data ("
-            "    key TEXT PRIMARY KEY NOT NULL,"
-            "    type INTEGER NOT NULL,"      // Type as INTEGER, not prefix
-            "    value TEXT NOT NULL,"
-            "    deleted INTEGER DEFAULT 0"
-            ") WITHOUT ROWID;";  // WITHOUT ROWID for better performance with TEXT primary key
-        
-        rc = sqlite3_exec( m_pDB, createTableSQL, nullptr, nullptr, &errMsg );
+        char* errMsg = nullptr;
+        core::Int32 rc = sqlite3_exec( m_pDB, m_sql.createTable.c_str(), nullptr, nullptr, &errMsg );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to create table: " << ( errMsg ? errMsg : "unknown error" );
@@ -165,8 +465,7 @@ namespace per
         }
         
         // Create index on deleted column for faster queries
-        const char* createIndexSQL = "CREATE INDEX IF NOT EXISTS idx_deleted ON kvs_data(deleted);";
-        rc = sqlite3_exec( m_pDB, createIndexSQL, nullptr, nullptr, &errMsg );
+        rc = sqlite3_exec( m_pDB, m_sql.createDeletedIndex.c_str(), nullptr, nullptr, &errMsg );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_WARN << "Failed to create index: " << ( errMsg ? errMsg : "unknown error" );
@@ -174,8 +473,7 @@ namespace per
         }
         
         // Create index on type column for type-based queries
-        const char* createTypeIndexSQL = "CREATE INDEX IF NOT EXISTS idx_type ON kvs_data(type) WHERE deleted = 0;";
-        rc = sqlite3_exec( m_pDB, createTypeIndexSQL, nullptr, nullptr, &errMsg );
+        rc = sqlite3_exec( m_pDB, m_sql.createTypeIndex.c_str(), nullptr, nullptr, &errMsg );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_WARN << "Failed to create type index: " << ( errMsg ? errMsg : "unknown error" );
@@ -189,13 +487,12 @@ namespace per
     
     core::Result< void > KvsSqliteBackend::prepareStatements() noexcept
     {
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
         core::Int32 rc;
         
         // INSERT OR REPLACE statement (now includes type column)
-        const char* insertSQL = "INSERT OR REPLACE INTO kvs_data (key, type, value, deleted) VALUES (?, ?, ?, 0);";
-        rc = sqlite3_prepare_v2( m_pDB, insertSQL, -1, &m_pStmtInsert, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.insert.c_str(), -1, &m_pStmtInsert, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare insert statement: " << sqlite3_errmsg( m_pDB );
@@ -203,8 +500,7 @@ namespace per
         }
         
         // UPDATE statement (now includes type column)
-        const char* updateSQL = "UPDATE kvs_data SET type = ?, value = ?, deleted = 0 WHERE key = ?;";
-        rc = sqlite3_prepare_v2( m_pDB, updateSQL, -1, &m_pStmtUpdate, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.update.c_str(), -1, &m_pStmtUpdate, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare update statement: " << sqlite3_errmsg( m_pDB );
@@ -212,8 +508,7 @@ namespace per
         }
         
         // SELECT statement (now retrieves both type and value)
-        const char* selectSQL = "SELECT type, value FROM kvs_data WHERE key = ? AND deleted = 0;";
-        rc = sqlite3_prepare_v2( m_pDB, selectSQL, -1, &m_pStmtSelect, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.select.c_str(), -1, &m_pStmtSelect, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare select statement: " << sqlite3_errmsg( m_pDB );
@@ -221,8 +516,7 @@ namespace per
         }
         
         // EXISTS statement
-        const char* existsSQL = "SELECT 1 FROM kvs_data WHERE key = ? AND deleted = 0 LIMIT 1;";
-        rc = sqlite3_prepare_v2( m_pDB, existsSQL, -1, &m_pStmtExists, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.exists.c_str(), -1, &m_pStmtExists, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare exists statement: " << sqlite3_errmsg( m_pDB );
@@ -230,8 +524,7 @@ namespace per
         }
         
         // DELETE statement (soft delete by setting deleted flag)
-        const char* deleteSQL = "UPDATE kvs_data SET deleted = 1 WHERE key = ?;";
-        rc = sqlite3_prepare_v2( m_pDB, deleteSQL, -1, &m_pStmtDelete, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.remove.c_str(), -1, &m_pStmtDelete, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare delete statement: " << sqlite3_errmsg( m_pDB );
@@ -239,14 +532,38 @@ namespace per
         }
         
         // GET ALL statement
-        const char* getAllSQL = "SELECT key FROM kvs_data WHERE deleted = 0;";
-        rc = sqlite3_prepare_v2( m_pDB, getAllSQL, -1, &m_pStmtGetAll, nullptr );
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.getAll.c_str(), -1, &m_pStmtGetAll, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare getall statement: " << sqlite3_errmsg( m_pDB );
             return core::Result< void >::FromError( makeErrorCode( rc ) );
         }
         
+        // INSERT IF ABSENT statement (UPSERT: only revives a soft-deleted row, never overwrites a live one)
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.insertIfAbsent.c_str(), -1, &m_pStmtInsertIfAbsent, nullptr );
+        if( rc != SQLITE_OK )
+        {
+            LAP_PER_LOG_ERROR << "Failed to prepare insert-if-absent statement: " << sqlite3_errmsg( m_pDB );
+            return core::Result< void >::FromError( makeErrorCode( rc ) );
+        }
+        
+        // COMPARE AND SWAP statement (new type/value, key, expected type/value)
+        rc = sqlite3_prepare_v2( m_pDB, m_sql.compareSwap.c_str(), -1, &m_pStmtCompareSwap, nullptr );
+        if( rc != SQLITE_OK )
+        {
+            LAP_PER_LOG_ERROR << "Failed to prepare compare-swap statement: " << sqlite3_errmsg( m_pDB );
+            return core::Result< void >::FromError( makeErrorCode( rc ) );
+        }
+        
+        // DATA VERSION statement (changes whenever another connection commits)
+        const char* dataVersionSQL = "PRAGMA data_version;";
+        rc = sqlite3_prepare_v2( m_pDB, dataVersionSQL, -1, &m_pStmtDataVersion, nullptr );
+        if( rc != SQLITE_OK )
+        {
+            LAP_PER_LOG_ERROR << "Failed to prepare data-version statement: " << sqlite3_errmsg( m_pDB );
+            return core::Result< void >::FromError( makeErrorCode( rc ) );
+        }
+        
         return core::Result< void >::FromValue();
     }
 
@@ -258,13 +575,16 @@ namespace per
         if( m_pStmtExists ) { sqlite3_finalize( m_pStmtExists ); m_pStmtExists = nullptr; }
         if( m_pStmtDelete ) { sqlite3_finalize( m_pStmtDelete ); m_pStmtDelete = nullptr; }
         if( m_pStmtGetAll ) { sqlite3_finalize( m_pStmtGetAll ); m_pStmtGetAll = nullptr; }
+        if( m_pStmtInsertIfAbsent ) { sqlite3_finalize( m_pStmtInsertIfAbsent ); m_pStmtInsertIfAbsent = nullptr; }
+        if( m_pStmtCompareSwap ) { sqlite3_finalize( m_pStmtCompareSwap ); m_pStmtCompareSwap = nullptr; }
+        if( m_pStmtDataVersion ) { sqlite3_finalize( m_pStmtDataVersion ); m_pStmtDataVersion = nullptr; }
     }
 
     // ==================== Transaction Management ====================
     
     core::Result< void > KvsSqliteBackend::beginTransaction() noexcept
     {
-        if( m_bInTransaction )
+        if( m_pConnection->inTransaction )
         {
             return core::Result< void >::FromValue();
         }
@@ -279,13 +599,13 @@ namespace per
             return core::Result< void >::FromError( makeErrorCode( rc ) );
         }
         
-        m_bInTransaction = true;
+        m_pConnection->inTransaction = true;
         return core::Result< void >::FromValue();
     }
 
     core::Result< void > KvsSqliteBackend::commitTransaction() noexcept
     {
-        if( !m_bInTransaction )
+        if( !m_pConnection->inTransaction )
         {
             return core::Result< void >::FromValue();
         }
@@ -300,13 +620,13 @@ namespace per
             return core::Result< void >::FromError( makeErrorCode( rc ) );
         }
         
-        m_bInTransaction = false;
+        m_pConnection->inTransaction = false;
         return core::Result< void >::FromValue();
     }
 
     core::Result< void > KvsSqliteBackend::rollbackTransaction() noexcept
     {
-        if( !m_bInTransaction )
+        if( !m_pConnection->inTransaction )
         {
             return core::Result< void >::FromValue();
         }
@@ -321,7 +641,7 @@ namespace per
             return core::Result< void >::FromError( makeErrorCode( rc ) );
         }
         
-        m_bInTransaction = false;
+        m_pConnection->inTransaction = false;
         return core::Result< void >::FromValue();
     }
 
@@ -354,7 +674,9 @@ namespace per
             case 9:  oss << ::lap::core::get<core::Float>( value );   break;
             case 10: oss << ::lap::core::get<core::Double>( value );  break;
             case 11: return ::lap::core::get<core::String>( value );  // String directly, no conversion needed
+            case 12: return "";  // Blob and arrays are bound natively via sqlite3_bind_blob()
             default:
+                if( isKvsRawType( static_cast< EKvsDataTypeIndicate >( ::lap::core::GetVariantIndex( value ) ) ) ) return "";
                 LAP_PER_LOG_ERROR << "Unknown variant type: " << ::lap::core::GetVariantIndex( value );
                 return "";
         }
@@ -363,7 +685,7 @@ namespace per
     }
 
     // Decode value from string using separate type index (no prefix parsing)
-    core::Result< KvsDataType > KvsSqliteBackend::decodeValue( core::Int32 typeIndex, core::StringView valueStr ) const noexcept
+    core::Result< KvsDataType > KvsSqliteBackend::decodeValue( core::Int32 typeIndex, core::StringView valueStr ) noexcept
     {
         try
         {
@@ -393,6 +715,35 @@ namespace per
         }
     }
 
+    void KvsSqliteBackend::bindValue( sqlite3_stmt* stmt, core::Int32 index, const KvsDataType& value, core::String& encoded ) const noexcept
+    {
+        const core::Byte* rawData = nullptr;
+        core::Size rawSize = 0;
+        if( kvsRawBytes( value, rawData, rawSize ) )
+        {
+            // Bind raw bytes straight from the caller's buffer (stepped before returning)
+            if( rawSize == 0 )
+            {
+                sqlite3_bind_zeroblob( stmt, index, 0 );  // NULL data pointer would bind SQL NULL
+            }
+            else
+            {
+                sqlite3_bind_blob( stmt, index, rawData, static_cast< core::Int32 >( rawSize ), SQLITE_STATIC );
+            }
+        }
+        else if( getTypeIndex( value ) == static_cast< core::Int32 >( EKvsDataTypeIndicate::DataType_string ) )
+        {
+            // Bind straight from the caller's string, no intermediate copy (stepped before returning)
+            const auto& text = ::lap::core::get< core::String >( value );
+            sqlite3_bind_text( stmt, index, text.data(), static_cast< core::Int32 >( text.size() ), SQLITE_STATIC );
+        }
+        else
+        {
+            encoded = encodeValue( value );
+            sqlite3_bind_text( stmt, index, encoded.c_str(), encoded.size(), SQLITE_STATIC );
+        }
+    }
+
     // ==================== Public API Implementation ====================
     
     core::Result< core::Vector< core::String > > KvsSqliteBackend::GetAllKeys() const noexcept
@@ -404,7 +755,7 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
         core::Vector< core::String > keys;
         
@@ -438,7 +789,12 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        if( bloomExcludes( key ) )
+        {
+            return result::FromValue( false );
+        }
         
         sqlite3_reset( m_pStmtExists );
         sqlite3_bind_text( m_pStmtExists, 1, key.data(), key.size(), SQLITE_STATIC );
@@ -451,6 +807,7 @@ namespace per
         }
         else if( rc == SQLITE_DONE )
         {
+            bloomMissed();
             return result::FromValue( false );
         }
         else
@@ -469,7 +826,18 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
+        return selectValue( key );
+    }
+
+    core::Result< KvsDataType > KvsSqliteBackend::selectValue( core::StringView key ) const noexcept
+    {
+        using result = core::Result< KvsDataType >;
+        
+        if( bloomExcludes( key ) )
+        {
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
         
         sqlite3_reset( m_pStmtSelect );
         sqlite3_bind_text( m_pStmtSelect, 1, key.data(), key.size(), SQLITE_STATIC );
@@ -478,22 +846,11 @@ namespace per
         
         if( rc == SQLITE_ROW )
         {
-            // Get type from column 0 (INTEGER)
-            core::Int32 typeIndex = sqlite3_column_int( m_pStmtSelect, 0 );
-            
-            // Get value from column 1 (TEXT)
-            const char* valueStr = reinterpret_cast<const char*>( sqlite3_column_text( m_pStmtSelect, 1 ) );
-            if( !valueStr )
-            {
-                LAP_PER_LOG_ERROR << "NULL value returned for key: " << key;
-                return result::FromError( PerErrc::kIntegrityCorrupted );
-            }
-            
-            // Decode using separate type index
-            return decodeValue( typeIndex, valueStr );
+            return decodeRow( m_pStmtSelect, key );
         }
         else if( rc == SQLITE_DONE )
         {
+            bloomMissed();
             return result::FromError( PerErrc::kKeyNotFound );
         }
         else
@@ -503,38 +860,40 @@ namespace per
         }
     }
 
-    core::Result< void > KvsSqliteBackend::SetValue( core::StringView key, const KvsDataType& value ) noexcept
+    core::Result< KvsDataType > KvsSqliteBackend::decodeRow( sqlite3_stmt* stmt, core::StringView key ) noexcept
     {
-        using result = core::Result< void >;
+        using result = core::Result< KvsDataType >;
         
-        if( !m_bAvailable )
+        // Get type from column 0 (INTEGER)
+        core::Int32 typeIndex = sqlite3_column_int( stmt, 0 );
+        
+        // Blob and array values are stored natively (BLOB storage class), no decoding
+        if( isKvsRawType( static_cast< EKvsDataTypeIndicate >( typeIndex ) ) )
         {
-            return result::FromError( PerErrc::kNotInitialized );
+            const core::Byte* bytes = static_cast< const core::Byte* >( sqlite3_column_blob( stmt, 1 ) );
+            core::Int32 length = sqlite3_column_bytes( stmt, 1 );
+            KvsDataType value;
+            if( !kvsFromRawBytes( static_cast< EKvsDataTypeIndicate >( typeIndex ), bytes, static_cast< core::Size >( length ), value ) )
+            {
+                LAP_PER_LOG_ERROR << "Corrupted array value for key: " << key;
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            return result::FromValue( ::std::move( value ) );
         }
         
-        core::LockGuard lock( m_mutex );
-        
-        // Get type index and encode value separately
-        core::Int32 typeIndex = getTypeIndex( value );
-        core::String encodedValue = encodeValue( value );
-        
-        sqlite3_reset( m_pStmtInsert );
-        sqlite3_bind_text( m_pStmtInsert, 1, key.data(), key.size(), SQLITE_STATIC );
-        sqlite3_bind_int( m_pStmtInsert, 2, typeIndex );  // Bind type as INTEGER
-        sqlite3_bind_text( m_pStmtInsert, 3, encodedValue.c_str(), encodedValue.size(), SQLITE_TRANSIENT );
-        
-        core::Int32 rc = sqlite3_step( m_pStmtInsert );
-        
-        if( rc != SQLITE_DONE )
+        // Get value from column 1 (TEXT)
+        const char* valueStr = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 1 ) );
+        if( !valueStr )
         {
-            LAP_PER_LOG_ERROR << "Failed to set value for key '" << key << "': " << sqlite3_errmsg( m_pDB );
-            return result::FromError( makeErrorCode( rc ) );
+            LAP_PER_LOG_ERROR << "NULL value returned for key: " << key;
+            return result::FromError( PerErrc::kIntegrityCorrupted );
         }
         
-        return result::FromValue();
+        // Decode using separate type index
+        return decodeValue( typeIndex, core::StringView( valueStr, sqlite3_column_bytes( stmt, 1 ) ) );
     }
 
-    core::Result< void > KvsSqliteBackend::RemoveKey( core::StringView key ) noexcept
+    core::Result< void > KvsSqliteBackend::GetValueAssign( core::StringView key, KvsDataType& out ) const noexcept
     {
         using result = core::Result< void >;
         
@@ -543,38 +902,343 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
-        sqlite3_reset( m_pStmtDelete );
-        sqlite3_bind_text( m_pStmtDelete, 1, key.data(), key.size(), SQLITE_STATIC );
+        if( bloomExcludes( key ) )
+        {
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
         
-        core::Int32 rc = sqlite3_step( m_pStmtDelete );
+        sqlite3_reset( m_pStmtSelect );
+        sqlite3_bind_text( m_pStmtSelect, 1, key.data(), key.size(), SQLITE_STATIC );
         
-        if( rc != SQLITE_DONE )
+        core::Int32 rc = sqlite3_step( m_pStmtSelect );
+        
+        if( rc == SQLITE_DONE )
         {
-            LAP_PER_LOG_ERROR << "Failed to remove key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            bloomMissed();
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+        else if( rc != SQLITE_ROW )
+        {
+            LAP_PER_LOG_ERROR << "Failed to get value for key '" << key << "': " << sqlite3_errmsg( m_pDB );
             return result::FromError( makeErrorCode( rc ) );
         }
         
+        core::Int32 typeIndex = sqlite3_column_int( m_pStmtSelect, 0 );
+        if( typeIndex != static_cast< core::Int32 >( ::lap::core::GetVariantIndex( out ) ) )
+        {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        
+        core::Size length = static_cast< core::Size >( sqlite3_column_bytes( m_pStmtSelect, 1 ) );
+        if( isKvsRawType( static_cast< EKvsDataTypeIndicate >( typeIndex ) ) )
+        {
+            // Copy the row's bytes into the existing vector
+            const core::Byte* bytes = static_cast< const core::Byte* >( sqlite3_column_blob( m_pStmtSelect, 1 ) );
+            if( !kvsFromRawBytes( static_cast< EKvsDataTypeIndicate >( typeIndex ), bytes, length, out ) )
+            {
+                LAP_PER_LOG_ERROR << "Corrupted array value for key: " << key;
+                return result::FromError( PerErrc::kIntegrityCorrupted );
+            }
+            return result::FromValue();
+        }
+        
+        const char* valueStr = reinterpret_cast<const char*>( sqlite3_column_text( m_pStmtSelect, 1 ) );
+        if( !valueStr )
+        {
+            LAP_PER_LOG_ERROR << "NULL value returned for key: " << key;
+            return result::FromError( PerErrc::kIntegrityCorrupted );
+        }
+        
+        if( typeIndex == static_cast< core::Int32 >( EKvsDataTypeIndicate::DataType_string ) )
+        {
+            // Assign into the caller's string, reusing its capacity
+            ::lap::core::get< core::String >( out ).assign( valueStr, length );
+            return result::FromValue();
+        }
+        
+        auto decoded = decodeValue( typeIndex, core::StringView( valueStr, length ) );
+        if( !decoded.HasValue() )
+        {
+            return result::FromError( decoded.Error() );
+        }
+        out = decoded.Value();
         return result::FromValue();
     }
 
-    core::Result<void> KvsSqliteBackend::RecoverKey( core::StringView key ) noexcept
+    core::Result< core::Size > KvsSqliteBackend::GetValueInto( core::StringView key, EKvsDataTypeIndicate type, core::Span< core::Byte > buffer ) const noexcept
     {
-        using result = core::Result< void >;
+        using result = core::Result< core::Size >;
         
         if( !m_bAvailable )
         {
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        if( bloomExcludes( key ) )
+        {
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+        
+        sqlite3_reset( m_pStmtSelect );
+        sqlite3_bind_text( m_pStmtSelect, 1, key.data(), key.size(), SQLITE_STATIC );
+        
+        core::Int32 rc = sqlite3_step( m_pStmtSelect );
+        
+        if( rc == SQLITE_DONE )
+        {
+            bloomMissed();
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+        else if( rc != SQLITE_ROW )
+        {
+            LAP_PER_LOG_ERROR << "Failed to get value for key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
+        if( sqlite3_column_int( m_pStmtSelect, 0 ) != type || !isKvsRawType( type ) )
+        {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+        
+        // Copy from SQLite's row buffer straight into the caller's buffer
+        const void* bytes = sqlite3_column_blob( m_pStmtSelect, 1 );
+        core::Size length = static_cast< core::Size >( sqlite3_column_bytes( m_pStmtSelect, 1 ) );
+        if( length > buffer.size() )
+        {
+            return result::FromError( PerErrc::kWrongDataSize );
+        }
+        if( length > 0 )
+        {
+            ::std::memcpy( buffer.data(), bytes, length );
+        }
+        
+        return result::FromValue( length );
+    }
+
+    core::Result< void > KvsSqliteBackend::SetValue( core::StringView key, const KvsDataType& value ) noexcept
+    {
+        using result = core::Result< void >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        // Get type index and encode value separately
+        core::String encodedValue;
+        
+        sqlite3_reset( m_pStmtInsert );
+        sqlite3_bind_text( m_pStmtInsert, 1, key.data(), key.size(), SQLITE_STATIC );
+        sqlite3_bind_int( m_pStmtInsert, 2, getTypeIndex( value ) );  // Bind type as INTEGER
+        bindValue( m_pStmtInsert, 3, value, encodedValue );
+        
+        core::Int32 rc = sqlite3_step( m_pStmtInsert );
+        
+        if( rc != SQLITE_DONE )
+        {
+            LAP_PER_LOG_ERROR << "Failed to set value for key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
+        bloomAdd( key );
+        return result::FromValue();
+    }
+
+    // ==================== Atomic Read-Modify-Write ====================
+
+    core::Result< core::Bool > KvsSqliteBackend::insertIfAbsent( core::StringView key, const KvsDataType& value ) noexcept
+    {
+        core::String encodedValue;
+
+        sqlite3_reset( m_pStmtInsertIfAbsent );
+        sqlite3_bind_text( m_pStmtInsertIfAbsent, 1, key.data(), key.size(), SQLITE_STATIC );
+        sqlite3_bind_int( m_pStmtInsertIfAbsent, 2, getTypeIndex( value ) );
+        bindValue( m_pStmtInsertIfAbsent, 3, value, encodedValue );
+
+        core::Int32 rc = sqlite3_step( m_pStmtInsertIfAbsent );
+        if( rc != SQLITE_DONE )
+        {
+            LAP_PER_LOG_ERROR << "Failed to insert key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            return core::Result< core::Bool >::FromError( makeErrorCode( rc ) );
+        }
+
+        // A live row makes the UPSERT a no-op
+        core::Bool inserted = ( sqlite3_changes( m_pDB ) == 1 );
+        if( inserted )
+        {
+            bloomAdd( key );
+        }
+        return core::Result< core::Bool >::FromValue( inserted );
+    }
+
+    core::Result< core::Bool > KvsSqliteBackend::compareSwap( core::StringView key, const KvsDataType& expected, const KvsDataType& desired ) noexcept
+    {
+        core::String encodedDesired;
+        core::String encodedExpected;
+
+        sqlite3_reset( m_pStmtCompareSwap );
+        sqlite3_bind_int( m_pStmtCompareSwap, 1, getTypeIndex( desired ) );
+        bindValue( m_pStmtCompareSwap, 2, desired, encodedDesired );
+        sqlite3_bind_text( m_pStmtCompareSwap, 3, key.data(), key.size(), SQLITE_STATIC );
+        sqlite3_bind_int( m_pStmtCompareSwap, 4, getTypeIndex( expected ) );
+        bindValue( m_pStmtCompareSwap, 5, expected, encodedExpected );
+
+        core::Int32 rc = sqlite3_step( m_pStmtCompareSwap );
+        if( rc != SQLITE_DONE )
+        {
+            LAP_PER_LOG_ERROR << "Failed to compare-swap key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            return core::Result< core::Bool >::FromError( makeErrorCode( rc ) );
+        }
+
+        return core::Result< core::Bool >::FromValue( sqlite3_changes( m_pDB ) == 1 );
+    }
+
+    core::Result< KvsDataType > KvsSqliteBackend::FetchAdd( core::StringView key, const KvsDataType& delta ) noexcept
+    {
+        using result = core::Result< KvsDataType >;
+
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        KvsDataType zero;
+        if( !kvsZeroValue( delta, zero ) )
+        {
+            return result::FromError( PerErrc::kDataTypeMismatch );
+        }
+
+        core::LockGuard lock( m_pConnection->mutex );
+
+        // The sum is computed here so it is encoded exactly like SetValue() would; the write is
+        // conditional on the value just read, so a concurrent writer on another connection
+        // makes it a no-op and the update is retried on the new value
+        for( core::UInt32 attempt = 0; attempt < MAX_RMW_ATTEMPTS; ++attempt )
+        {
+            auto current = selectValue( key );
+            if( !current.HasValue() && static_cast< PerErrc >( current.Error().Value() ) != PerErrc::kKeyNotFound )
+            {
+                return result::FromError( current.Error() );
+            }
+
+            const KvsDataType& previous = current.HasValue() ? current.Value() : zero;
+            KvsDataType sum;
+            if( !kvsAddValues( previous, delta, sum ) )
+            {
+                return result::FromError( PerErrc::kDataTypeMismatch );
+            }
+
+            auto written = current.HasValue() ? compareSwap( key, previous, sum ) : insertIfAbsent( key, sum );
+            if( !written.HasValue() )
+            {
+                return result::FromError( written.Error() );
+            }
+            if( written.Value() )
+            {
+                return result::FromValue( previous );
+            }
+        }
+
+        LAP_PER_LOG_WARN << "FetchAdd on key '" << key << "' kept conflicting with other writers";
+        return result::FromError( PerErrc::kResourceBusy );
+    }
+
+    core::Result< core::Bool > KvsSqliteBackend::CompareExchange( core::StringView key, const KvsDataType& expected, const KvsDataType& desired ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        core::LockGuard lock( m_pConnection->mutex );
+
+        // One conditional UPDATE; only a miss needs a second look to tell mismatch from missing key
+        auto swapped = compareSwap( key, expected, desired );
+        if( !swapped.HasValue() || swapped.Value() )
+        {
+            return swapped;
+        }
+
+        sqlite3_reset( m_pStmtExists );
+        sqlite3_bind_text( m_pStmtExists, 1, key.data(), key.size(), SQLITE_STATIC );
+
+        core::Int32 rc = sqlite3_step( m_pStmtExists );
+        if( rc == SQLITE_DONE )
+        {
+            return result::FromError( PerErrc::kKeyNotFound );
+        }
+        else if( rc != SQLITE_ROW )
+        {
+            LAP_PER_LOG_ERROR << "Failed to check key existence: " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+
+        return result::FromValue( false );
+    }
+
+    core::Result< core::Bool > KvsSqliteBackend::SetIfAbsent( core::StringView key, const KvsDataType& value ) noexcept
+    {
+        using result = core::Result< core::Bool >;
+
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+
+        core::LockGuard lock( m_pConnection->mutex );
+        return insertIfAbsent( key, value );
+    }
+
+    core::Result< void > KvsSqliteBackend::RemoveKey( core::StringView key ) noexcept
+    {
+        using result = core::Result< void >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        sqlite3_reset( m_pStmtDelete );
+        sqlite3_bind_text( m_pStmtDelete, 1, key.data(), key.size(), SQLITE_STATIC );
+        
+        core::Int32 rc = sqlite3_step( m_pStmtDelete );
+        
+        if( rc != SQLITE_DONE )
+        {
+            LAP_PER_LOG_ERROR << "Failed to remove key '" << key << "': " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
+        // Filter bits cannot be cleared, the key stays a (rare) false positive until the next rebuild
+        ++m_bloomRemoved;
+        return result::FromValue();
+    }
+
+    core::Result<void> KvsSqliteBackend::RecoverKey( core::StringView key ) noexcept
+    {
+        using result = core::Result< void >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::LockGuard lock( m_pConnection->mutex );
         
         // Recovery: set deleted flag to 0
-        const char* recoverySQL = "UPDATE kvs_data SET deleted = 0 WHERE key = ?;";
         sqlite3_stmt* stmt = nullptr;
         
-        core::Int32 rc = sqlite3_prepare_v2( m_pDB, recoverySQL, -1, &stmt, nullptr );
+        core::Int32 rc = sqlite3_prepare_v2( m_pDB, m_sql.recover.c_str(), -1, &stmt, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare recovery statement: " << sqlite3_errmsg( m_pDB );
@@ -591,6 +1255,7 @@ namespace per
             return result::FromError( makeErrorCode( rc ) );
         }
         
+        bloomAdd( key );
         return result::FromValue();
     }
 
@@ -604,12 +1269,11 @@ namespace per
         }
         
         // Reset: physically delete the key
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
-        const char* resetSQL = "DELETE FROM kvs_data WHERE key = ?;";
         sqlite3_stmt* stmt = nullptr;
         
-        core::Int32 rc = sqlite3_prepare_v2( m_pDB, resetSQL, -1, &stmt, nullptr );
+        core::Int32 rc = sqlite3_prepare_v2( m_pDB, m_sql.reset.c_str(), -1, &stmt, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare reset statement: " << sqlite3_errmsg( m_pDB );
@@ -626,6 +1290,7 @@ namespace per
             return result::FromError( makeErrorCode( rc ) );
         }
         
+        ++m_bloomRemoved;
         return result::FromValue();
     }
 
@@ -638,11 +1303,11 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
         // Soft delete all keys
         char* errMsg = nullptr;
-        core::Int32 rc = sqlite3_exec( m_pDB, "UPDATE kvs_data SET deleted = 1;", nullptr, nullptr, &errMsg );
+        core::Int32 rc = sqlite3_exec( m_pDB, m_sql.removeAll.c_str(), nullptr, nullptr, &errMsg );
         
         if( rc != SQLITE_OK )
         {
@@ -651,6 +1316,9 @@ namespace per
             return result::FromError( makeErrorCode( rc ) );
         }
         
+        // No live key left: an empty filter of the same size is exact for this connection's view
+        m_bloom.Reset( m_bloom.Capacity() );
+        m_bloomRemoved = 0;
         return result::FromValue();
     }
 
@@ -663,10 +1331,10 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
         // Commit any pending transaction
-        if( m_bInTransaction )
+        if( m_pConnection->inTransaction )
         {
             auto commitResult = commitTransaction();
             if( !commitResult.HasValue() )
@@ -675,8 +1343,22 @@ namespace per
             }
         }
         
+        // An active statement on the connection, of any instance sharing it, would lock the checkpoint out
+        m_pConnection->resetPendingStatements();
+        
         // Force WAL checkpoint
-        core::Int32 rc = sqlite3_wal_checkpoint_v2( m_pDB, nullptr, SQLITE_CHECKPOINT_FULL, nullptr, nullptr );
+        core::Int32 log = 0;
+        core::Int32 checkpointed = 0;
+        core::Int32 rc = sqlite3_wal_checkpoint_v2( m_pDB, nullptr, SQLITE_CHECKPOINT_FULL, &log, &checkpointed );
+        m_pConnection->noteCheckpoint( log, checkpointed );
+        
+        // An open snapshot still reads older WAL frames: the commits are in the WAL,
+        // the copy back into the database file completes on a later sync
+        if( rc == SQLITE_BUSY )
+        {
+            LAP_PER_LOG_DEBUG << "WAL checkpoint deferred, snapshot readers active";
+            rc = SQLITE_OK;
+        }
         
         if( rc != SQLITE_OK )
         {
@@ -689,7 +1371,7 @@ namespace per
         if( ++syncCount % 100 == 0 )  // Every 100 syncs
         {
             char* errMsg = nullptr;
-            rc = sqlite3_exec( m_pDB, "DELETE FROM kvs_data WHERE deleted = 1;", nullptr, nullptr, &errMsg );
+            rc = sqlite3_exec( m_pDB, m_sql.purgeDeleted.c_str(), nullptr, nullptr, &errMsg );
             if( rc != SQLITE_OK )
             {
                 LAP_PER_LOG_WARN << "Failed to cleanup deleted records: " << ( errMsg ? errMsg : "unknown error" );
@@ -697,9 +1379,87 @@ namespace per
             }
         }
         
+        // Drop the bits of removed keys once they are a noticeable share of the filter
+        if( m_bloomRemoved >= ::std::max< core::UInt64 >( BLOOM_MIN_REBUILD_INTERVAL, m_bloom.Count() / 4 ) )
+        {
+            rebuildBloom();
+        }
+        
         return result::FromValue();
     }
 
+    core::Result< KvsSyncProgress > KvsSqliteBackend::SyncToStorage( KvsSyncMeter& meter ) noexcept
+    {
+        using result = core::Result< KvsSyncProgress >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        KvsSyncProgress progress;
+        progress.complete = false;
+        
+        // Commit any pending transaction
+        if( m_pConnection->inTransaction )
+        {
+            if( !meter.admit( 1, 0 ) )
+            {
+                progress.remainingRecords = 1;
+                progress.remainingBytes = ( m_pConnection->walFrames - m_pConnection->walCheckpointed ) * m_pConnection->pageSize;
+                return result::FromValue( progress );
+            }
+            auto commitResult = commitTransaction();
+            if( !commitResult.HasValue() )
+            {
+                return result::FromError( commitResult.Error() );
+            }
+            meter.spend( 1, 0 );
+        }
+        
+        // Checkpoint only if the frames not yet copied back fit what is left of the budget
+        const core::UInt64 frames = m_pConnection->walFrames - m_pConnection->walCheckpointed;
+        if( frames > 0 )
+        {
+            if( !meter.admit( 0, frames * m_pConnection->pageSize, frames * m_pConnection->checkpointNsPerFrame ) )
+            {
+                progress.remainingBytes = frames * m_pConnection->pageSize;
+                return result::FromValue( progress );
+            }
+            
+            // An active statement on the connection would lock the checkpoint out, see SyncToStorage()
+            m_pConnection->resetPendingStatements();
+            
+            // Passive: never waits for readers, frames an open snapshot still reads stay in the WAL
+            const auto start = ::std::chrono::steady_clock::now();
+            core::Int32 log = 0;
+            core::Int32 checkpointed = 0;
+            core::Int32 rc = sqlite3_wal_checkpoint_v2( m_pDB, nullptr, SQLITE_CHECKPOINT_PASSIVE, &log, &checkpointed );
+            if( rc != SQLITE_OK && rc != SQLITE_BUSY )
+            {
+                LAP_PER_LOG_ERROR << "Failed to sync to storage: " << sqlite3_errmsg( m_pDB );
+                return result::FromError( makeErrorCode( rc ) );
+            }
+            
+            const core::UInt64 copied = static_cast< core::UInt64 >( checkpointed ) > m_pConnection->walCheckpointed
+                                      ? checkpointed - m_pConnection->walCheckpointed : 0;
+            if( copied > 0 )
+            {
+                const auto elapsed = ::std::chrono::duration_cast< ::std::chrono::nanoseconds >( ::std::chrono::steady_clock::now() - start ).count();
+                m_pConnection->checkpointNsPerFrame = static_cast< core::UInt64 >( elapsed ) / copied;
+            }
+            m_pConnection->noteCheckpoint( log, checkpointed );
+            meter.spend( 0, copied * m_pConnection->pageSize );
+        }
+        
+        // The checkpoint synced the WAL: frames held back by snapshot readers are durable, only not copied yet
+        progress.complete = true;
+        progress.remainingBytes = ( m_pConnection->walFrames - m_pConnection->walCheckpointed ) * m_pConnection->pageSize;
+        return result::FromValue( progress );
+    }
+
     core::Result<void> KvsSqliteBackend::DiscardPendingChanges() noexcept
     {
         using result = core::Result< void >;
@@ -709,9 +1469,9 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
-        if( m_bInTransaction )
+        if( m_pConnection->inTransaction )
         {
             return rollbackTransaction();
         }
@@ -719,6 +1479,632 @@ namespace per
         return result::FromValue();
     }
 
+    // ==================== Bulk Transfer ====================
+    
+    core::Result< core::UInt64 > KvsSqliteBackend::Export( IKvsRecordSink& sink, core::Size batchSize ) const noexcept
+    {
+        using result = core::Result< core::UInt64 >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        if( batchSize == 0 ) batchSize = KVS_RECORD_BATCH_SIZE;
+        
+        auto count = GetKeyCount();
+        if( !count.HasValue() )
+        {
+            return result::FromError( count.Error() );
+        }
+        auto begun = sink.Begin( count.Value() );
+        if( !begun.HasValue() )
+        {
+            return result::FromError( begun.Error() );
+        }
+        
+        // Primary key order, each batch resumes at the last key of the previous one (which it skips)
+        sqlite3_stmt* stmt = nullptr;
+        core::Int32 rc = sqlite3_prepare_v2( m_pDB, m_sql.exportBatch.c_str(), -1, &stmt, nullptr );
+        if( rc != SQLITE_OK )
+        {
+            LAP_PER_LOG_ERROR << "Failed to prepare export statement: " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        ::std::unique_ptr< sqlite3_stmt, decltype( &sqlite3_finalize ) > finalizer( stmt, &sqlite3_finalize );
+        
+        core::UInt64 exported = 0;
+        try
+        {
+            KvsRecordBatch batch;
+            core::String lastKey;
+            core::Bool done = false;
+            while( !done )
+            {
+                batch.clear();
+                {
+                    // The lock is released between batches, writers interleave with a long export
+                    core::LockGuard lock( m_pConnection->mutex );
+                    sqlite3_reset( stmt );
+                    sqlite3_bind_text( stmt, 1, lastKey.data(), lastKey.size(), SQLITE_STATIC );
+                    sqlite3_bind_int64( stmt, 2, static_cast< sqlite3_int64 >( batchSize ) + 1 );
+                    
+                    while( batch.size() < batchSize && ( rc = sqlite3_step( stmt ) ) == SQLITE_ROW )
+                    {
+                        const char* text = reinterpret_cast< const char* >( sqlite3_column_text( stmt, 2 ) );
+                        core::StringView key( text ? text : "", static_cast< core::Size >( sqlite3_column_bytes( stmt, 2 ) ) );
+                        if( exported > 0 && key == lastKey )
+                        {
+                            continue;
+                        }
+                        
+                        auto value = decodeRow( stmt, key );
+                        if( !value.HasValue() )
+                        {
+                            sqlite3_reset( stmt );
+                            return result::FromError( value.Error() );
+                        }
+                        batch.push_back( KvsRecord{ core::String( key ), ::std::move( value.Value() ) } );
+                    }
+                    done = ( rc != SQLITE_ROW );
+                    sqlite3_reset( stmt );  // Ends the statement's read transaction before the lock is released
+                }
+                
+                if( done && rc != SQLITE_DONE )
+                {
+                    LAP_PER_LOG_ERROR << "Failed to export: " << sqlite3_errmsg( m_pDB );
+                    return result::FromError( makeErrorCode( rc ) );
+                }
+                if( batch.empty() )
+                {
+                    break;
+                }
+                
+                auto written = sink.Write( batch );
+                if( !written.HasValue() )
+                {
+                    return result::FromError( written.Error() );
+                }
+                exported += batch.size();
+                lastKey = batch.back().key;
+            }
+        }
+        catch( const ::std::bad_alloc& )
+        {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        
+        auto finished = sink.Finish();
+        if( !finished.HasValue() )
+        {
+            return result::FromError( finished.Error() );
+        }
+        return result::FromValue( exported );
+    }
+    
+    core::Result< core::UInt64 > KvsSqliteBackend::Import( IKvsRecordSource& source, const KvsImportOptions& options ) noexcept
+    {
+        using result = core::Result< core::UInt64 >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        const core::UInt64 expected = source.ExpectedRecords();
+        ::std::unique_lock< core::Mutex > lock( m_pConnection->mutex );
+        
+        auto run = [this]( const core::String& sql ) -> core::Int32
+        {
+            char* errMsg = nullptr;
+            core::Int32 rc = sqlite3_exec( m_pDB, sql.c_str(), nullptr, nullptr, &errMsg );
+            if( rc != SQLITE_OK )
+            {
+                LAP_PER_LOG_ERROR << "Import failed on '" << core::StringView( sql ) << "': " << ( errMsg ? errMsg : "unknown error" );
+                if( errMsg ) sqlite3_free( errMsg );
+            }
+            return rc;
+        };
+        auto fail = [this]( core::ErrorCode error )
+        {
+            rollbackTransaction();
+            return result::FromError( error );
+        };
+        
+        // Lookups stay pending until their next reset and would hold a read transaction open
+        m_pConnection->resetPendingStatements();
+        
+        auto begun = beginTransaction();
+        if( !begun.HasValue() )
+        {
+            return result::FromError( begun.Error() );
+        }
+        
+        core::Int32 rc = SQLITE_OK;
+        if( options.clearFirst && ( rc = run( m_sql.removeAll ) ) != SQLITE_OK )
+        {
+            return fail( makeErrorCode( rc ) );
+        }
+        
+        // Deferred index build: once the import is at least as large as the table, one sort
+        // per index after the load is cheaper than maintaining both indexes row by row
+        core::Bool deferIndexes = false;
+        if( options.bulkLoad && expected > 0 )
+        {
+            sqlite3_stmt* countStmt = nullptr;
+            core::Int64 rows = 0;
+            rc = sqlite3_prepare_v2( m_pDB, m_sql.countRows.c_str(), -1, &countStmt, nullptr );
+            if( rc == SQLITE_OK && sqlite3_step( countStmt ) == SQLITE_ROW )
+            {
+                rows = sqlite3_column_int64( countStmt, 0 );
+            }
+            sqlite3_finalize( countStmt );
+            
+            deferIndexes = expected >= static_cast< core::UInt64 >( rows );
+            if( deferIndexes && ( rc = run( m_sql.dropIndexes ) ) != SQLITE_OK )
+            {
+                return fail( makeErrorCode( rc ) );
+            }
+        }
+        
+        core::UInt64 imported = 0;
+        KvsRecordBatch batch;
+        core::String encodedValue;
+        for( ;; )
+        {
+            if( !options.bulkLoad )
+            {
+                // One transaction per batch, other writers get the lock in between
+                auto committed = commitTransaction();
+                if( !committed.HasValue() )
+                {
+                    return fail( committed.Error() );
+                }
+                lock.unlock();
+            }
+            
+            auto read = source.Read( batch, options.batchSize );
+            
+            if( !options.bulkLoad )
+            {
+                lock.lock();
+                auto next = beginTransaction();
+                if( !next.HasValue() )
+                {
+                    return result::FromError( next.Error() );
+                }
+            }
+            if( !read.HasValue() )
+            {
+                return fail( read.Error() );
+            }
+            if( read.Value() == 0 )
+            {
+                break;
+            }
+            
+            for( const auto& record : batch )
+            {
+                sqlite3_reset( m_pStmtInsert );
+                sqlite3_bind_text( m_pStmtInsert, 1, record.key.data(), record.key.size(), SQLITE_STATIC );
+                sqlite3_bind_int( m_pStmtInsert, 2, getTypeIndex( record.value ) );
+                bindValue( m_pStmtInsert, 3, record.value, encodedValue );
+                
+                rc = sqlite3_step( m_pStmtInsert );
+                if( rc != SQLITE_DONE )
+                {
+                    LAP_PER_LOG_ERROR << "Failed to import key '" << record.key << "': " << sqlite3_errmsg( m_pDB );
+                    sqlite3_reset( m_pStmtInsert );
+                    return fail( makeErrorCode( rc ) );
+                }
+            }
+            sqlite3_reset( m_pStmtInsert );  // Drops the bindings into batch before it is refilled
+            imported += batch.size();
+        }
+        
+        if( deferIndexes &&
+            ( ( rc = run( m_sql.createDeletedIndex ) ) != SQLITE_OK || ( rc = run( m_sql.createTypeIndex ) ) != SQLITE_OK ) )
+        {
+            return fail( makeErrorCode( rc ) );
+        }
+        
+        auto committed = commitTransaction();
+        if( !committed.HasValue() )
+        {
+            return fail( committed.Error() );
+        }
+        
+        // Filled per key the filter would saturate and rescan the table repeatedly: rebuild it once, lazily
+        m_bloomValid = false;
+        m_bloomUnfiltered = 0;
+        if( m_pInserts ) ++*m_pInserts;
+        
+        LAP_PER_LOG_INFO << "Imported " << imported << " records" << ( deferIndexes ? " (indexes built after the load)" : "" );
+        return result::FromValue( imported );
+    }
+    
+    core::Result< void > KvsSqliteBackend::ApplyChanges( const KvsRecordBatch& values, const core::Vector< core::String >& removedKeys ) noexcept
+    {
+        using result = core::Result< void >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        auto fail = [this]( sqlite3_stmt* stmt, core::Int32 rc )
+        {
+            sqlite3_reset( stmt );
+            rollbackTransaction();
+            return result::FromError( makeErrorCode( rc ) );
+        };
+        
+        // Lookups stay pending until their next reset and would hold a read transaction open
+        m_pConnection->resetPendingStatements();
+        
+        auto begun = beginTransaction();
+        if( !begun.HasValue() )
+        {
+            return begun;
+        }
+        
+        for( const auto& key : removedKeys )
+        {
+            sqlite3_reset( m_pStmtDelete );
+            sqlite3_bind_text( m_pStmtDelete, 1, key.data(), key.size(), SQLITE_STATIC );
+            core::Int32 rc = sqlite3_step( m_pStmtDelete );
+            if( rc != SQLITE_DONE )
+            {
+                LAP_PER_LOG_ERROR << "Failed to remove key '" << key << "': " << sqlite3_errmsg( m_pDB );
+                return fail( m_pStmtDelete, rc );
+            }
+            ++m_bloomRemoved;
+        }
+        sqlite3_reset( m_pStmtDelete );
+        
+        core::String encodedValue;
+        for( const auto& record : values )
+        {
+            sqlite3_reset( m_pStmtInsert );
+            sqlite3_bind_text( m_pStmtInsert, 1, record.key.data(), record.key.size(), SQLITE_STATIC );
+            sqlite3_bind_int( m_pStmtInsert, 2, getTypeIndex( record.value ) );
+            bindValue( m_pStmtInsert, 3, record.value, encodedValue );
+            
+            core::Int32 rc = sqlite3_step( m_pStmtInsert );
+            if( rc != SQLITE_DONE )
+            {
+                LAP_PER_LOG_ERROR << "Failed to set value for key '" << record.key << "': " << sqlite3_errmsg( m_pDB );
+                return fail( m_pStmtInsert, rc );
+            }
+            // A rolled back key stays a (rare) false positive of the filter
+            bloomAdd( record.key );
+        }
+        sqlite3_reset( m_pStmtInsert );
+        
+        auto committed = commitTransaction();
+        if( !committed.HasValue() )
+        {
+            rollbackTransaction();
+            return committed;
+        }
+        return result::FromValue();
+    }
+    
+    // ==================== Negative-Lookup Filter ====================
+    
+    KvsBloomFilterStats KvsSqliteBackend::GetBloomFilterStats() const noexcept
+    {
+        if( !m_pConnection )
+        {
+            return m_bloomStats;
+        }
+        core::LockGuard lock( m_pConnection->mutex );
+        
+        KvsBloomFilterStats stats = m_bloomStats;
+        stats.keys      = m_bloom.Count();
+        stats.bits      = m_bloom.Bits();
+        stats.fillRatio = m_bloom.FillRatio();
+        return stats;
+    }
+    
+    core::Bool KvsSqliteBackend::readDataVersion( core::Int64& version ) const noexcept
+    {
+        sqlite3_reset( m_pStmtDataVersion );
+        if( sqlite3_step( m_pStmtDataVersion ) != SQLITE_ROW )
+        {
+            sqlite3_reset( m_pStmtDataVersion );
+            return false;
+        }
+        
+        version = sqlite3_column_int64( m_pStmtDataVersion, 0 );
+        sqlite3_reset( m_pStmtDataVersion );
+        return true;
+    }
+    
+    void KvsSqliteBackend::rebuildBloom() const noexcept
+    {
+        m_bloomValid = false;
+        
+        // Version first: a commit racing the scan below leaves the filter marked stale, never wrong
+        core::Int64 version = 0;
+        if( !readDataVersion( version ) )
+        {
+            LAP_PER_LOG_EVERY_N( WARN, 64 ) << "Bloom filter rebuild skipped, data version unavailable: " << sqlite3_errmsg( m_pDB );
+            return;
+        }
+        const core::UInt64 inserts = m_pInserts ? *m_pInserts : 0;
+        
+        try
+        {
+            core::Vector< core::UInt64 > hashes;
+            
+            sqlite3_reset( m_pStmtGetAll );
+            core::Int32 rc;
+            while( ( rc = sqlite3_step( m_pStmtGetAll ) ) == SQLITE_ROW )
+            {
+                const char* key = reinterpret_cast< const char* >( sqlite3_column_text( m_pStmtGetAll, 0 ) );
+                core::Size length = static_cast< core::Size >( sqlite3_column_bytes( m_pStmtGetAll, 0 ) );
+                hashes.push_back( kvsKeyHash( core::StringView( key ? key : "", length ) ) );
+            }
+            sqlite3_reset( m_pStmtGetAll );
+            
+            if( rc != SQLITE_DONE )
+            {
+                LAP_PER_LOG_EVERY_N( WARN, 64 ) << "Bloom filter rebuild failed: " << sqlite3_errmsg( m_pDB );
+                return;
+            }
+            
+            // Twice the live keys, so the filter absorbs as many inserts again before it saturates
+            m_bloom.Reset( hashes.size() * 2 );
+            for( auto hash : hashes )
+            {
+                m_bloom.Add( hash );
+            }
+        }
+        catch( const ::std::bad_alloc& )
+        {
+            LAP_PER_LOG_EVERY_N( WARN, 64 ) << "Bloom filter rebuild failed, out of memory";
+            return;
+        }
+        
+        m_bloomDataVersion  = version;
+        m_bloomInserts      = inserts;
+        m_bloomValid        = true;
+        m_bloomUnfiltered   = 0;
+        m_bloomRemoved      = 0;
+        ++m_bloomStats.rebuilds;
+    }
+    
+    core::Bool KvsSqliteBackend::bloomExcludes( core::StringView key ) const noexcept
+    {
+        m_bloomPassed = false;
+        
+        if( !m_bloomValid )
+        {
+            // Rebuild once the unfiltered lookups have paid for the scan
+            ++m_bloomStats.bypassed;
+            if( ++m_bloomUnfiltered < ::std::max< core::UInt64 >( BLOOM_MIN_REBUILD_INTERVAL, m_bloom.Count() ) )
+            {
+                return false;
+            }
+            rebuildBloom();
+            if( !m_bloomValid )
+            {
+                return false;
+            }
+        }
+        
+        ++m_bloomStats.lookups;
+        if( m_bloom.MayContain( kvsKeyHash( key ) ) )
+        {
+            m_bloomPassed = true;
+            return false;
+        }
+        
+        // The filter only tracks this backend's writes; trust it while no other connection has committed
+        // and, in a shared database, no other backend of the instance has inserted
+        core::Int64 version = 0;
+        if( readDataVersion( version ) && version == m_bloomDataVersion && ( !m_pInserts || *m_pInserts == m_bloomInserts ) )
+        {
+            ++m_bloomStats.negatives;
+            return true;
+        }
+        
+        ++m_bloomStats.bypassed;
+        m_bloomValid        = false;
+        m_bloomUnfiltered   = 1;
+        return false;
+    }
+    
+    void KvsSqliteBackend::bloomMissed() const noexcept
+    {
+        if( m_bloomPassed )
+        {
+            ++m_bloomStats.falsePositives;
+        }
+    }
+    
+    void KvsSqliteBackend::bloomAdd( core::StringView key ) noexcept
+    {
+        if( m_pInserts )
+        {
+            if( *m_pInserts == m_bloomInserts ) ++m_bloomInserts;
+            ++*m_pInserts;
+        }
+        m_bloom.Add( kvsKeyHash( key ) );
+        if( m_bloomValid && m_bloom.Saturated() )
+        {
+            rebuildBloom();
+        }
+    }
+    
+    // ==================== Snapshots ====================
+    
+    /**
+     * @brief Read transaction pinned on a read-only connection of its own
+     *
+     * In WAL mode the open transaction keeps reading the database as of its first
+     * statement while the backend's connection keeps committing.
+     */
+    class KvsSqliteBackend::Snapshot final : public IKvsSnapshot
+    {
+    public:
+        IMP_OPERATOR_NEW(Snapshot)
+        
+        ~Snapshot() noexcept override
+        {
+            if( m_pStmtSelect ) sqlite3_finalize( m_pStmtSelect );
+            if( m_pStmtExists ) sqlite3_finalize( m_pStmtExists );
+            if( m_pStmtGetAll ) sqlite3_finalize( m_pStmtGetAll );
+            if( m_pDB )
+            {
+                sqlite3_exec( m_pDB, "COMMIT;", nullptr, nullptr, nullptr );
+                sqlite3_close( m_pDB );
+            }
+        }
+        
+        core::Result< void > open( const core::String& file, const KvsSqliteBackend& owner ) noexcept
+        {
+            core::Int32 rc = sqlite3_open_v2( file.c_str(), &m_pDB, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr );
+            if( rc != SQLITE_OK )
+            {
+                LAP_PER_LOG_ERROR << "Failed to open SQLite snapshot connection: " << sqlite3_errmsg( m_pDB );
+                return core::Result< void >::FromError( makeErrorCode( rc ) );
+            }
+            
+            // The owner's statements, on its own table in a shared database
+            sqlite3_stmt* countStmt = nullptr;
+            rc = sqlite3_prepare_v2( m_pDB, owner.m_sql.select.c_str(), -1, &m_pStmtSelect, nullptr );
+            if( rc == SQLITE_OK ) rc = sqlite3_prepare_v2( m_pDB, owner.m_sql.exists.c_str(), -1, &m_pStmtExists, nullptr );
+            if( rc == SQLITE_OK ) rc = sqlite3_prepare_v2( m_pDB, owner.m_sql.getAll.c_str(), -1, &m_pStmtGetAll, nullptr );
+            if( rc == SQLITE_OK ) rc = sqlite3_prepare_v2( m_pDB, owner.m_sql.countLive.c_str(), -1, &countStmt, nullptr );
+            if( rc == SQLITE_OK ) rc = sqlite3_exec( m_pDB, "BEGIN;", nullptr, nullptr, nullptr );
+            
+            // The first read starts the transaction's view, later commits stay invisible
+            if( rc == SQLITE_OK )
+            {
+                rc = sqlite3_step( countStmt );
+                if( rc == SQLITE_ROW )
+                {
+                    m_keyCount = static_cast< core::UInt32 >( sqlite3_column_int( countStmt, 0 ) );
+                    rc = SQLITE_OK;
+                }
+            }
+            if( countStmt ) sqlite3_finalize( countStmt );
+            
+            if( rc != SQLITE_OK )
+            {
+                LAP_PER_LOG_ERROR << "Failed to start SQLite snapshot: " << sqlite3_errmsg( m_pDB );
+                return core::Result< void >::FromError( makeErrorCode( rc ) );
+            }
+            
+            return core::Result< void >::FromValue();
+        }
+        
+        core::Result< core::Vector< core::String > > GetAllKeys() const noexcept override
+        {
+            using result = core::Result< core::Vector< core::String > >;
+            
+            core::LockGuard lock( m_mutex );
+            
+            core::Vector< core::String > keys;
+            keys.reserve( m_keyCount );
+            
+            sqlite3_reset( m_pStmtGetAll );
+            core::Int32 rc;
+            while( ( rc = sqlite3_step( m_pStmtGetAll ) ) == SQLITE_ROW )
+            {
+                const char* key = reinterpret_cast<const char*>( sqlite3_column_text( m_pStmtGetAll, 0 ) );
+                if( key )
+                {
+                    keys.push_back( key );
+                }
+            }
+            
+            if( rc != SQLITE_DONE )
+            {
+                return result::FromError( makeErrorCode( rc ) );
+            }
+            
+            return result::FromValue( ::std::move( keys ) );
+        }
+        
+        core::Result< core::Bool > KeyExists( core::StringView key ) const noexcept override
+        {
+            using result = core::Result< core::Bool >;
+            
+            core::LockGuard lock( m_mutex );
+            
+            sqlite3_reset( m_pStmtExists );
+            sqlite3_bind_text( m_pStmtExists, 1, key.data(), key.size(), SQLITE_STATIC );
+            
+            core::Int32 rc = sqlite3_step( m_pStmtExists );
+            if( rc == SQLITE_ROW ) return result::FromValue( true );
+            if( rc == SQLITE_DONE ) return result::FromValue( false );
+            
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
+        core::Result< KvsDataType > GetValue( core::StringView key ) const noexcept override
+        {
+            using result = core::Result< KvsDataType >;
+            
+            core::LockGuard lock( m_mutex );
+            
+            sqlite3_reset( m_pStmtSelect );
+            sqlite3_bind_text( m_pStmtSelect, 1, key.data(), key.size(), SQLITE_STATIC );
+            
+            core::Int32 rc = sqlite3_step( m_pStmtSelect );
+            if( rc == SQLITE_ROW ) return decodeRow( m_pStmtSelect, key );
+            if( rc == SQLITE_DONE ) return result::FromError( PerErrc::kKeyNotFound );
+            
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
+        core::Result< core::UInt32 > GetKeyCount() const noexcept override
+        {
+            return core::Result< core::UInt32 >::FromValue( m_keyCount );
+        }
+        
+    private:
+        mutable core::Mutex                 m_mutex;            // Statements are shared by the snapshot's readers
+        sqlite3*                            m_pDB{ nullptr };
+        sqlite3_stmt*                       m_pStmtSelect{ nullptr };
+        sqlite3_stmt*                       m_pStmtExists{ nullptr };
+        sqlite3_stmt*                       m_pStmtGetAll{ nullptr };
+        core::UInt32                        m_keyCount{ 0 };
+    };
+    
+    core::Result< core::SharedHandle< IKvsSnapshot > > KvsSqliteBackend::CreateSnapshot() const noexcept
+    {
+        using result = core::Result< core::SharedHandle< IKvsSnapshot > >;
+        
+        if( !m_bAvailable )
+        {
+            return result::FromError( PerErrc::kNotInitialized );
+        }
+        
+        core::SharedHandle< Snapshot > snapshot;
+        try
+        {
+            snapshot = ::std::make_shared< Snapshot >();
+        }
+        catch( const ::std::bad_alloc& )
+        {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+        
+        // No connection mutex: the snapshot's connection doesn't touch the backend's
+        auto openResult = snapshot->open( m_strFile, *this );
+        if( !openResult.HasValue() )
+        {
+            return result::FromError( openResult.Error() );
+        }
+        
+        return result::FromValue( ::std::move( snapshot ) );
+    }
+
     // ==================== Utility Methods ====================
     
     core::Result< core::UInt64 > KvsSqliteBackend::GetSize() const noexcept
@@ -730,6 +2116,24 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
+        // The file holds the other instances of a shared database too: count this instance's rows
+        if( m_bShared )
+        {
+            core::LockGuard lock( m_pConnection->mutex );
+            
+            sqlite3_stmt* stmt = nullptr;
+            core::Int32 rc = sqlite3_prepare_v2( m_pDB, m_sql.liveSize.c_str(), -1, &stmt, nullptr );
+            if( rc == SQLITE_OK && ( rc = sqlite3_step( stmt ) ) == SQLITE_ROW )
+            {
+                const core::UInt64 size = static_cast< core::UInt64 >( sqlite3_column_int64( stmt, 0 ) );
+                sqlite3_finalize( stmt );
+                return result::FromValue( size );
+            }
+            sqlite3_finalize( stmt );
+            LAP_PER_LOG_ERROR << "Failed to get instance size: " << sqlite3_errmsg( m_pDB );
+            return result::FromError( makeErrorCode( rc ) );
+        }
+        
         try
         {
             // Get file size of the database
@@ -760,12 +2164,11 @@ namespace per
             return result::FromError( PerErrc::kNotInitialized );
         }
         
-        core::LockGuard lock( m_mutex );
+        core::LockGuard lock( m_pConnection->mutex );
         
-        const char* countSQL = "SELECT COUNT(*) FROM kvs_data WHERE deleted = 0;";
         sqlite3_stmt* stmt = nullptr;
         
-        core::Int32 rc = sqlite3_prepare_v2( m_pDB, countSQL, -1, &stmt, nullptr );
+        core::Int32 rc = sqlite3_prepare_v2( m_pDB, m_sql.countLive.c_str(), -1, &stmt, nullptr );
         if( rc != SQLITE_OK )
         {
             LAP_PER_LOG_ERROR << "Failed to prepare count statement: " << sqlite3_errmsg( m_pDB );
@@ -788,13 +2191,15 @@ namespace per
 
     // ==================== Error Handling ====================
     
-    core::ErrorCode KvsSqliteBackend::makeErrorCode( core::Int32 sqliteCode ) const noexcept
+    core::ErrorCode KvsSqliteBackend::makeErrorCode( core::Int32 sqliteCode ) noexcept
     {
         // Map SQLite error codes to Persistency error codes
         switch( sqliteCode )
         {
             case SQLITE_NOTFOUND:
                 return core::ErrorCode( PerErrc::kKeyNotFound );
+            case SQLITE_NOMEM:
+                return core::ErrorCode( PerErrc::kOutOfMemorySpace );
             case SQLITE_FULL:
             case SQLITE_TOOBIG:
                 return core::ErrorCode( PerErrc::kOutOfStorageSpace );
@@ -0,0 +1,64 @@
+/**
+ * @file CKvsSyncBudget.cpp
+ * @brief Work limits for incremental SyncToStorage calls
+ * @version 1.0
+ * @date 2025-11-30
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <algorithm>
+
+#include "CKvsSyncBudget.hpp"
+
+namespace lap
+{
+namespace per
+{
+    KvsSyncMeter::KvsSyncMeter( const KvsSyncBudget& budget ) noexcept
+        : m_budget( budget )
+        , m_start( Clock::now() )
+        , m_unitStart( m_start )
+    {
+    }
+
+    core::Bool KvsSyncMeter::admit( core::UInt64 records, core::UInt64 bytes, core::UInt64 estimateNs ) const noexcept
+    {
+        // The first unit of a call always runs: one larger than the whole budget would never fit otherwise
+        if ( m_units == 0 ) return true;
+        if ( records > recordsLeft() || bytes > bytesLeft() ) return false;
+        if ( m_budget.microseconds == 0 ) return true;
+
+        const auto limitNs = m_budget.microseconds * 1000u;
+        return elapsedNs() + ::std::max( estimateNs, m_longestUnitNs ) < limitNs;
+    }
+
+    void KvsSyncMeter::spend( core::UInt64 records, core::UInt64 bytes ) noexcept
+    {
+        const auto now  = Clock::now();
+        m_longestUnitNs = ::std::max< core::UInt64 >( m_longestUnitNs,
+                              ::std::chrono::duration_cast< ::std::chrono::nanoseconds >( now - m_unitStart ).count() );
+        m_unitStart     = now;
+        ++m_units;
+        m_records       += records;
+        m_bytes         += bytes;
+    }
+
+    core::UInt64 KvsSyncMeter::bytesLeft() const noexcept
+    {
+        if ( m_budget.bytes == 0 ) return UNLIMITED;
+        return m_budget.bytes > m_bytes ? m_budget.bytes - m_bytes : 0;
+    }
+
+    core::UInt64 KvsSyncMeter::recordsLeft() const noexcept
+    {
+        if ( m_budget.records == 0 ) return UNLIMITED;
+        return m_budget.records > m_records ? m_budget.records - m_records : 0;
+    }
+
+    core::UInt64 KvsSyncMeter::elapsedNs() const noexcept
+    {
+        return ::std::chrono::duration_cast< ::std::chrono::nanoseconds >( Clock::now() - m_start ).count();
+    }
+} // namespace per
+} // namespace lap
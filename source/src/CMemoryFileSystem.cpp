@@ -0,0 +1,271 @@
+/**
+ * @file CMemoryFileSystem.cpp
+ * @brief In-Memory File System Implementation
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "CMemoryFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        // Writes land in the file at once, there is nothing to flush
+        class MemoryFileWriter final : public IVirtualFileWriter
+        {
+        public:
+            IMP_OPERATOR_NEW(MemoryFileWriter)
+
+            MemoryFileWriter( CMemoryFileSystem& fs, core::String path ) noexcept
+                : m_fs( fs )
+                , m_path( ::std::move( path ) )
+            {
+                ;
+            }
+
+            core::Result< void > Write( const core::UInt8* data, core::Size size ) noexcept override
+            {
+                return m_fs.AppendFile( m_path, data, size );
+            }
+
+            core::Result< void > Sync() noexcept override
+            {
+                return core::Result< void >::FromValue();
+            }
+
+        private:
+            CMemoryFileSystem&              m_fs;
+            core::String                    m_path;
+        };
+    } // namespace
+
+    // ==================== Path Helpers ====================
+
+    core::String CMemoryFileSystem::normalize( core::StringView path ) noexcept
+    {
+        // Collapse duplicate separators and drop trailing '/', keep root as "/"
+        core::String out;
+        out.reserve( path.size() );
+        for ( auto c : path ) {
+            if ( c == '/' && !out.empty() && out.back() == '/' ) continue;
+            out.push_back( c );
+        }
+        while ( out.size() > 1 && out.back() == '/' ) out.pop_back();
+        return out;
+    }
+
+    core::String CMemoryFileSystem::parentOf( const core::String& path ) noexcept
+    {
+        auto pos = path.rfind( '/' );
+        if ( pos == core::String::npos ) return core::String();
+        if ( pos == 0 ) return core::String( "/" );
+        return path.substr( 0, pos );
+    }
+
+    void CMemoryFileSystem::addDirectories( const core::String& dirPath ) noexcept
+    {
+        core::String dir = dirPath;
+        while ( !dir.empty() && m_dirs.insert( dir ).second ) {
+            if ( dir == "/" ) break;
+            dir = parentOf( dir );
+        }
+    }
+
+    // ==================== Query ====================
+
+    core::Bool CMemoryFileSystem::Exists( core::StringView path ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto key = normalize( path );
+        return m_files.find( key ) != m_files.end() || m_dirs.find( key ) != m_dirs.end();
+    }
+
+    core::Bool CMemoryFileSystem::IsDirectory( core::StringView path ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return m_dirs.find( normalize( path ) ) != m_dirs.end();
+    }
+
+    core::Result< core::UInt64 > CMemoryFileSystem::GetFileSize( core::StringView path ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto it = m_files.find( normalize( path ) );
+        if ( it == m_files.end() ) return core::Result< core::UInt64 >::FromError( PerErrc::kFileNotFound );
+        return core::Result< core::UInt64 >::FromValue( static_cast< core::UInt64 >( it->second.data.size() ) );
+    }
+
+    core::String CMemoryFileSystem::GetModificationTime( core::StringView path ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto it = m_files.find( normalize( path ) );
+        if ( it == m_files.end() ) return core::String();
+        return core::StringUtil::FromInt( static_cast< core::Int64 >( it->second.mtime ) );
+    }
+
+    core::Vector< core::String > CMemoryFileSystem::ListFiles( core::StringView dirPath ) const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+
+        core::Vector< core::String > names;
+        core::String prefix = normalize( dirPath );
+        if ( prefix != "/" ) prefix.push_back( '/' );
+
+        // std::map is ordered, so all children of a directory are contiguous
+        for ( auto it = m_files.lower_bound( prefix ); it != m_files.end(); ++it ) {
+            const auto& key = it->first;
+            if ( key.compare( 0, prefix.size(), prefix ) != 0 ) break;
+            if ( key.find( '/', prefix.size() ) != core::String::npos ) continue;  // nested file
+            names.emplace_back( key.substr( prefix.size() ) );
+        }
+        return names;
+    }
+
+    // ==================== File I/O ====================
+
+    core::Result< core::Vector< core::UInt8 > > CMemoryFileSystem::ReadFile( core::StringView path ) const noexcept
+    {
+        using result = core::Result< core::Vector< core::UInt8 > >;
+
+        core::LockGuard lock( m_mutex );
+        auto it = m_files.find( normalize( path ) );
+        if ( it == m_files.end() ) return result::FromError( PerErrc::kFileNotFound );
+        return result::FromValue( it->second.data );
+    }
+
+    core::Result< core::Vector< core::UInt8 > > CMemoryFileSystem::ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept
+    {
+        using result = core::Result< core::Vector< core::UInt8 > >;
+
+        core::LockGuard lock( m_mutex );
+        auto it = m_files.find( normalize( path ) );
+        if ( it == m_files.end() ) return result::FromError( PerErrc::kFileNotFound );
+
+        const auto& data = it->second.data;
+        if ( offset > data.size() || size > data.size() - offset ) return result::FromError( PerErrc::kWrongDataSize );
+        return result::FromValue( core::Vector< core::UInt8 >( data.begin() + offset, data.begin() + offset + size ) );
+    }
+
+    core::Result< void > CMemoryFileSystem::WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        if ( !data && size != 0 ) return core::Result< void >::FromError( PerErrc::kInvalidArgument );
+
+        core::LockGuard lock( m_mutex );
+        auto key = normalize( path );
+        if ( m_dirs.find( key ) != m_dirs.end() ) return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+
+        addDirectories( parentOf( key ) );
+        auto& file = m_files[ key ];
+        file.data.assign( data, data + size );
+        file.mtime = ++m_clock;
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CMemoryFileSystem::RemoveFile( core::StringView path ) noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        if ( m_files.erase( normalize( path ) ) == 0 ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CMemoryFileSystem::AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        if ( !data && size != 0 ) return core::Result< void >::FromError( PerErrc::kInvalidArgument );
+
+        core::LockGuard lock( m_mutex );
+        auto key = normalize( path );
+        if ( m_dirs.find( key ) != m_dirs.end() ) return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+
+        addDirectories( parentOf( key ) );
+        auto& file = m_files[ key ];
+        file.data.insert( file.data.end(), data, data + size );
+        file.mtime = ++m_clock;
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< core::UniqueHandle< IVirtualFileWriter > > CMemoryFileSystem::OpenWriter( core::StringView path ) noexcept
+    {
+        using result = core::Result< core::UniqueHandle< IVirtualFileWriter > >;
+
+        auto created = WriteFile( path, nullptr, 0 );
+        if ( !created.HasValue() ) return result::FromError( created.Error() );
+
+        try {
+            core::UniqueHandle< IVirtualFileWriter > writer( ::std::make_unique< MemoryFileWriter >( *this, core::String( path ) ) );
+            return result::FromValue( ::std::move( writer ) );
+        } catch ( const ::std::bad_alloc& ) {
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > CMemoryFileSystem::RenameFile( core::StringView from, core::StringView to ) noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto src = m_files.find( normalize( from ) );
+        if ( src == m_files.end() ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+
+        auto dstKey = normalize( to );
+        if ( m_dirs.find( parentOf( dstKey ) ) == m_dirs.end() ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+        if ( src->first == dstKey ) return core::Result< void >::FromValue();
+
+        MemoryFile moved = ::std::move( src->second );
+        m_files.erase( src );
+        m_files[ dstKey ] = ::std::move( moved );
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CMemoryFileSystem::CopyFile( core::StringView from, core::StringView to ) noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto src = m_files.find( normalize( from ) );
+        if ( src == m_files.end() ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+
+        auto dstKey = normalize( to );
+        addDirectories( parentOf( dstKey ) );
+        MemoryFile copy;
+        copy.data = src->second.data;
+        copy.mtime = ++m_clock;
+        m_files[ dstKey ] = ::std::move( copy );
+        return core::Result< void >::FromValue();
+    }
+
+    // ==================== Directory ====================
+
+    core::Result< void > CMemoryFileSystem::CreateDirectory( core::StringView path ) noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        auto key = normalize( path );
+        if ( m_files.find( key ) != m_files.end() ) return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        addDirectories( key );
+        return core::Result< void >::FromValue();
+    }
+
+    // ==================== Introspection ====================
+
+    core::UInt64 CMemoryFileSystem::GetTotalBytes() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        core::UInt64 total = 0;
+        for ( const auto& entry : m_files ) total += entry.second.data.size();
+        return total;
+    }
+
+    core::Size CMemoryFileSystem::GetFileCount() const noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        return m_files.size();
+    }
+
+    void CMemoryFileSystem::Clear() noexcept
+    {
+        core::LockGuard lock( m_mutex );
+        m_files.clear();
+        m_dirs.clear();
+    }
+
+} // namespace per
+} // namespace lap
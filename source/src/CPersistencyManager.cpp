@@ -13,6 +13,38 @@ namespace lap
 {
 namespace per
 {
+namespace
+{
+    // kvs.sqlite, or an entry of kvs.sqliteInstances on top of it: missing fields keep the defaults
+    KvsSqliteTuning loadSqliteTuning( const nlohmann::json& json, const KvsSqliteTuning& defaults )
+    {
+        KvsSqliteTuning tuning;
+        tuning.journalMode = json.value("journalMode", defaults.journalMode);
+        tuning.synchronous = json.value("synchronous", defaults.synchronous);
+        tuning.cacheSize = json.value("cacheSize", defaults.cacheSize);
+        tuning.mmapSize = json.value("mmapSize", defaults.mmapSize);
+        tuning.pageSize = json.value("pageSize", defaults.pageSize);
+        tuning.walAutocheckpoint = json.value("walAutocheckpoint", defaults.walAutocheckpoint);
+        tuning.tempStore = json.value("tempStore", defaults.tempStore);
+        tuning.exclusiveLocking = json.value("exclusiveLocking", defaults.exclusiveLocking);
+        return tuning;
+    }
+
+    nlohmann::json saveSqliteTuning( const KvsSqliteTuning& tuning )
+    {
+        nlohmann::json json;
+        json["journalMode"] = tuning.journalMode;
+        json["synchronous"] = tuning.synchronous;
+        json["cacheSize"] = tuning.cacheSize;
+        json["mmapSize"] = tuning.mmapSize;
+        json["pageSize"] = tuning.pageSize;
+        json["walAutocheckpoint"] = tuning.walAutocheckpoint;
+        json["tempStore"] = tuning.tempStore;
+        json["exclusiveLocking"] = tuning.exclusiveLocking;
+        return json;
+    }
+} // namespace
+
     core::Bool CPersistencyManager::initialize() noexcept
     {
         if ( m_bInitialized )     return true;
@@ -228,7 +260,7 @@ namespace per
 
                 // make sure folder is exist
                 if ( core::Path::createDirectory( strFolder ) ) {
-                    auto kvs = KeyValueStorage::create( strFolder.data(), type );
+                    auto kvs = KeyValueStorage::create( strFolder.data(), type, m_configLoaded ? &m_config : nullptr );
                     m_kvsMap.emplace( strFolder.data(), kvs );
 
                     return result::FromValue( kvs );
@@ -344,6 +376,15 @@ namespace per
             // Load Property backend specific config
             config.kvs.propertyBackendShmSize = kvsConfigJson.value("propertyBackendShmSize", 1ul << 20);  // 1MB default
             config.kvs.propertyBackendPersistence = kvsConfigJson.value("propertyBackendPersistence", "file");
+            config.kvs.propertyBackendMemoryBudget = kvsConfigJson.value("propertyBackendMemoryBudget", core::Size(0));
+            config.kvs.shardCount = kvsConfigJson.value("shardCount", core::UInt32(1));
+            config.kvs.memoryPoolSize = kvsConfigJson.value("memoryPoolSize", core::Size(0));
+            config.kvs.groupCommitWindowUs = kvsConfigJson.value("groupCommitWindowUs", core::UInt32(0));
+            config.kvs.sqliteSharedDatabase = kvsConfigJson.value("sqliteSharedDatabase", "");
+            config.kvs.sqlite = loadSqliteTuning(kvsConfigJson.value("sqlite", nlohmann::json::object()), KvsSqliteTuning());
+            for (const auto& instance : kvsConfigJson.value("sqliteInstances", nlohmann::json::object()).items()) {
+                config.kvs.sqliteInstances[instance.key()] = loadSqliteTuning(instance.value(), config.kvs.sqlite);
+            }
             
             return result::FromValue(config);
         } catch (const std::exception& e) {
@@ -405,6 +446,16 @@ namespace per
             kvsConfig["dataSourceType"] = config.kvs.dataSourceType;
             kvsConfig["propertyBackendShmSize"] = config.kvs.propertyBackendShmSize;
             kvsConfig["propertyBackendPersistence"] = config.kvs.propertyBackendPersistence;
+            kvsConfig["propertyBackendMemoryBudget"] = config.kvs.propertyBackendMemoryBudget;
+            kvsConfig["shardCount"] = config.kvs.shardCount;
+            kvsConfig["memoryPoolSize"] = config.kvs.memoryPoolSize;
+            kvsConfig["groupCommitWindowUs"] = config.kvs.groupCommitWindowUs;
+            kvsConfig["sqliteSharedDatabase"] = config.kvs.sqliteSharedDatabase;
+            kvsConfig["sqlite"] = saveSqliteTuning(config.kvs.sqlite);
+            kvsConfig["sqliteInstances"] = nlohmann::json::object();
+            for (const auto& instance : config.kvs.sqliteInstances) {
+                kvsConfig["sqliteInstances"][instance.first] = saveSqliteTuning(instance.second);
+            }
             moduleConfig["kvs"] = kvsConfig;
             
             // ConfigManager automatically handles persistence
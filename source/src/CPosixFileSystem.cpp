@@ -0,0 +1,311 @@
+/**
+ * @file CPosixFileSystem.cpp
+ * @brief POSIX File System Implementation
+ * @version 1.0
+ * @date 2025-11-20
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <lap/core/CFile.hpp>
+#include <lap/core/CPath.hpp>
+#include "CPosixFileSystem.hpp"
+
+namespace lap
+{
+namespace per
+{
+    namespace
+    {
+        inline core::String parentOf( core::StringView path ) noexcept
+        {
+            auto pos = path.rfind( '/' );
+            if ( pos == core::StringView::npos || pos == 0 ) return core::String();
+            return core::String( path.substr( 0, pos ) );
+        }
+
+        inline PerErrc errnoToPerErrc( int err ) noexcept
+        {
+            switch ( err ) {
+                case ENOSPC:
+                case EDQUOT:    return PerErrc::kOutOfStorageSpace;
+                case ENOENT:    return PerErrc::kFileNotFound;
+                default:        return PerErrc::kPhysicalStorageFailure;
+            }
+        }
+
+        // A new file's directory entry is durable only once its directory is synced
+        inline int syncDirectoryOf( core::StringView path ) noexcept
+        {
+            auto parent = parentOf( path );
+            if ( parent.empty() ) parent = ( !path.empty() && path[0] == '/' ) ? "/" : ".";
+
+            int fd = ::open( parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+            if ( fd < 0 ) return errno;
+            int err = ::fsync( fd ) != 0 ? errno : 0;
+            ::close( fd );
+            return err;
+        }
+
+        // One descriptor for the writer's whole life, flushed only by Sync()
+        class PosixFileWriter final : public IVirtualFileWriter
+        {
+        public:
+            IMP_OPERATOR_NEW(PosixFileWriter)
+
+            explicit PosixFileWriter( int fd ) noexcept : m_fd( fd ) {}
+            ~PosixFileWriter() noexcept override { ::close( m_fd ); }
+
+            core::Result< void > Write( const core::UInt8* data, core::Size size ) noexcept override
+            {
+                core::Size done = 0;
+                while ( done < size ) {
+                    ssize_t n = ::write( m_fd, data + done, size - done );
+                    if ( n < 0 && errno == EINTR ) continue;
+                    if ( n < 0 ) return core::Result< void >::FromError( errnoToPerErrc( errno ) );
+                    done += static_cast< core::Size >( n );
+                }
+                return core::Result< void >::FromValue();
+            }
+
+            core::Result< void > Sync() noexcept override
+            {
+                if ( ::fdatasync( m_fd ) != 0 ) return core::Result< void >::FromError( errnoToPerErrc( errno ) );
+                return core::Result< void >::FromValue();
+            }
+
+        private:
+            int m_fd;
+        };
+    } // namespace
+
+    core::SharedHandle< IVirtualFileSystem > IVirtualFileSystem::getDefault() noexcept
+    {
+        static core::SharedHandle< IVirtualFileSystem > s_posix = core::MakeShared< CPosixFileSystem >();
+        return s_posix;
+    }
+
+    core::Bool CPosixFileSystem::Exists( core::StringView path ) const noexcept
+    {
+        return core::File::Util::exists( core::String( path ) );
+    }
+
+    core::Bool CPosixFileSystem::IsDirectory( core::StringView path ) const noexcept
+    {
+        return core::Path::isDirectory( core::String( path ) );
+    }
+
+    core::Result< core::UInt64 > CPosixFileSystem::GetFileSize( core::StringView path ) const noexcept
+    {
+        core::String strPath( path );
+        if ( !core::File::Util::exists( strPath ) ) {
+            return core::Result< core::UInt64 >::FromError( PerErrc::kFileNotFound );
+        }
+        return core::Result< core::UInt64 >::FromValue( static_cast< core::UInt64 >( core::File::Util::size( strPath ) ) );
+    }
+
+    core::String CPosixFileSystem::GetModificationTime( core::StringView path ) const noexcept
+    {
+        core::String strPath( path );
+        if ( !core::File::Util::exists( strPath ) ) return core::String();
+        return core::File::Util::getModificationTime( strPath );
+    }
+
+    core::Vector< core::String > CPosixFileSystem::ListFiles( core::StringView dirPath ) const noexcept
+    {
+        core::String strPath( dirPath );
+        if ( !core::Path::isDirectory( strPath ) ) return core::Vector< core::String >();
+        return core::Path::listFiles( strPath );
+    }
+
+    core::Result< core::Vector< core::UInt8 > > CPosixFileSystem::ReadFile( core::StringView path ) const noexcept
+    {
+        using result = core::Result< core::Vector< core::UInt8 > >;
+
+        core::String strPath( path );
+        if ( !core::File::Util::exists( strPath ) ) return result::FromError( PerErrc::kFileNotFound );
+
+        core::Vector< core::UInt8 > data;
+        if ( !core::File::Util::ReadBinary( strPath, data ) ) {
+            return result::FromError( PerErrc::kFileNotFound );
+        }
+        return result::FromValue( ::std::move( data ) );
+    }
+
+    core::Result< core::Vector< core::UInt8 > > CPosixFileSystem::ReadFileRange( core::StringView path, core::UInt64 offset, core::Size size ) const noexcept
+    {
+        using result = core::Result< core::Vector< core::UInt8 > >;
+
+        core::String strPath( path );
+        int fd = ::open( strPath.c_str(), O_RDONLY | O_CLOEXEC );
+        if ( fd < 0 ) return result::FromError( errno == ENOENT ? PerErrc::kFileNotFound : errnoToPerErrc( errno ) );
+
+        core::Vector< core::UInt8 > data;
+        try {
+            data.resize( size );
+        } catch ( const ::std::bad_alloc& ) {
+            ::close( fd );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+
+        core::Size done = 0;
+        while ( done < size ) {
+            ssize_t n = ::pread( fd, data.data() + done, size - done, static_cast< off_t >( offset + done ) );
+            if ( n < 0 && errno == EINTR ) continue;
+            if ( n <= 0 ) break;
+            done += static_cast< core::Size >( n );
+        }
+        ::close( fd );
+
+        if ( done != size ) return result::FromError( PerErrc::kWrongDataSize );
+        return result::FromValue( ::std::move( data ) );
+    }
+
+    core::Result< void > CPosixFileSystem::WriteFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        core::String strPath( path );
+
+        // core::File::Util::WriteBinary requires size > 0, create empty files explicitly
+        if ( size == 0 ) {
+            auto parent = parentOf( path );
+            if ( !parent.empty() && !core::Path::isDirectory( parent ) && !core::Path::createDirectory( parent ) ) {
+                return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+            }
+            if ( core::File::Util::exists( strPath ) ) core::File::Util::remove( strPath );
+            if ( !core::File::Util::create( strPath ) ) {
+                return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+            }
+            return core::Result< void >::FromValue();
+        }
+
+        errno = 0;
+        if ( !core::File::Util::WriteBinary( strPath, data, size, true ) ) {
+            return core::Result< void >::FromError( errno == 0 ? PerErrc::kPhysicalStorageFailure : errnoToPerErrc( errno ) );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CPosixFileSystem::RemoveFile( core::StringView path ) noexcept
+    {
+        core::String strPath( path );
+        if ( !core::File::Util::exists( strPath ) ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+        if ( !core::File::Util::remove( strPath ) ) return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CPosixFileSystem::AppendFile( core::StringView path, const core::UInt8* data, core::Size size ) noexcept
+    {
+        core::String strPath( path );
+
+        auto parent = parentOf( path );
+        if ( !parent.empty() && !core::Path::isDirectory( parent ) && !core::Path::createDirectory( parent ) ) {
+            return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+
+        // Open an existing file first, so a creation is known and its directory entry synced below
+        core::Bool created = false;
+        int fd = ::open( strPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC );
+        while ( fd < 0 && errno == ENOENT ) {
+            fd = ::open( strPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644 );
+            created = fd >= 0;
+            if ( fd < 0 && errno == EEXIST ) fd = ::open( strPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC );
+        }
+        if ( fd < 0 ) return core::Result< void >::FromError( errnoToPerErrc( errno ) );
+
+        core::Size done = 0;
+        while ( done < size ) {
+            ssize_t n = ::write( fd, data + done, size - done );
+            if ( n < 0 && errno == EINTR ) continue;
+            if ( n < 0 ) {
+                int err = errno;
+                ::close( fd );
+                return core::Result< void >::FromError( errnoToPerErrc( err ) );
+            }
+            done += static_cast< core::Size >( n );
+        }
+
+        // Appends are the durability point of log-structured callers
+        if ( ::fdatasync( fd ) != 0 ) {
+            int err = errno;
+            ::close( fd );
+            return core::Result< void >::FromError( errnoToPerErrc( err ) );
+        }
+        ::close( fd );
+
+        if ( created ) {
+            int err = syncDirectoryOf( path );
+            if ( err != 0 ) return core::Result< void >::FromError( errnoToPerErrc( err ) );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< core::UniqueHandle< IVirtualFileWriter > > CPosixFileSystem::OpenWriter( core::StringView path ) noexcept
+    {
+        using result = core::Result< core::UniqueHandle< IVirtualFileWriter > >;
+
+        core::String strPath( path );
+
+        auto parent = parentOf( path );
+        if ( !parent.empty() && !core::Path::isDirectory( parent ) && !core::Path::createDirectory( parent ) ) {
+            return result::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+
+        int fd = ::open( strPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+        if ( fd < 0 ) return result::FromError( errnoToPerErrc( errno ) );
+
+        try {
+            core::UniqueHandle< IVirtualFileWriter > writer( ::std::make_unique< PosixFileWriter >( fd ) );
+            return result::FromValue( ::std::move( writer ) );
+        } catch ( const ::std::bad_alloc& ) {
+            ::close( fd );
+            return result::FromError( PerErrc::kOutOfMemorySpace );
+        }
+    }
+
+    core::Result< void > CPosixFileSystem::RenameFile( core::StringView from, core::StringView to ) noexcept
+    {
+        core::String strFrom( from );
+        core::String strTo( to );
+
+        // POSIX rename() atomically replaces the destination
+        if ( ::rename( strFrom.c_str(), strTo.c_str() ) != 0 ) {
+            LAP_PER_LOG_ERROR << "CPosixFileSystem::RenameFile failed: " << strFrom << " -> " << strTo << " : " << ::strerror( errno );
+            return core::Result< void >::FromError( errnoToPerErrc( errno ) );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CPosixFileSystem::CopyFile( core::StringView from, core::StringView to ) noexcept
+    {
+        core::String strFrom( from );
+        if ( !core::File::Util::exists( strFrom ) ) return core::Result< void >::FromError( PerErrc::kFileNotFound );
+
+        auto parent = parentOf( to );
+        if ( !parent.empty() && !core::Path::isDirectory( parent ) && !core::Path::createDirectory( parent ) ) {
+            return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+
+        errno = 0;
+        if ( !core::File::Util::copy( strFrom, core::String( to ) ) ) {
+            return core::Result< void >::FromError( errno == 0 ? PerErrc::kPhysicalStorageFailure : errnoToPerErrc( errno ) );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+    core::Result< void > CPosixFileSystem::CreateDirectory( core::StringView path ) noexcept
+    {
+        core::String strPath( path );
+        if ( core::Path::isDirectory( strPath ) ) return core::Result< void >::FromValue();
+        if ( !core::Path::createDirectory( strPath ) ) {
+            return core::Result< void >::FromError( PerErrc::kPhysicalStorageFailure );
+        }
+        return core::Result< void >::FromValue();
+    }
+
+} // namespace per
+} // namespace lap
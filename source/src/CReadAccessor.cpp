@@ -41,9 +41,7 @@ namespace per
             if ( !fileExists )   updateCreateTime();
 
             m_fpStream->open( actualPath.c_str(), convert( mode ) );
-#ifdef LAP_DEBUG
             LAP_PER_LOG_DEBUG.logFormat( "ReadAccessor open with %s, mode: 0x%x", actualPath.c_str(), static_cast< core::Int32 >( m_openMode ) );
-#endif
         } catch ( const ::std::ios_base::failure& fail ) {
             LAP_PER_LOG_ERROR << "ReadAccessor open failed " << fail.what();
 
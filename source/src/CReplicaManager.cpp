@@ -71,18 +71,20 @@ static Result<ChecksumResult> CalculateBuffer(
 }
 
 static Result<ChecksumResult> CalculateFile(
+    const IVirtualFileSystem& vfs,
     const String& filePath,
     ChecksumType type
 ) noexcept {
     auto startTime = Time::getCurrentTime();
 
     // Read file content
-    Vector<UInt8> content;
-    if (!File::Util::ReadBinary(filePath, content)) {
+    auto readResult = vfs.ReadFile(filePath);
+    if (!readResult.HasValue()) {
         return Result<ChecksumResult>::FromError(
             MakeErrorCode(PerErrc::kFileNotFound, 0)
         );
     }
+    const auto& content = readResult.Value();
 
     auto result = CalculateBuffer(content.data(), content.size(), type);
 
@@ -98,11 +100,12 @@ static Result<ChecksumResult> CalculateFile(
 }
 
 static Result<Bool> VerifyFile(
+    const IVirtualFileSystem& vfs,
     const String& filePath,
     const String& expectedChecksum,
     ChecksumType type
 ) noexcept {
-    auto checksumResult = CalculateFile(filePath, type);
+    auto checksumResult = CalculateFile(vfs, filePath, type);
     if (!checksumResult.HasValue()) {
         return Result<Bool>::FromError(checksumResult.Error());
     }
@@ -117,12 +120,14 @@ CReplicaManager::CReplicaManager(
     const String& baseStoragePath,
     UInt32 replicaCount,
     UInt32 minValidReplicas,
-    ChecksumType checksumType
+    ChecksumType checksumType,
+    SharedHandle<IVirtualFileSystem> vfs
 ) noexcept
     : m_baseStoragePath(baseStoragePath)
     , m_replicaCount(replicaCount)
     , m_minValidReplicas(minValidReplicas)
     , m_checksumType(checksumType)
+    , m_pVfs(vfs ? vfs : IVirtualFileSystem::getDefault())
 {
     // Validate configuration
     if (m_minValidReplicas > m_replicaCount) {
@@ -138,7 +143,7 @@ CReplicaManager::CReplicaManager(
     }
 
     // Ensure base storage path exists
-    if (!Path::createDirectory(StringView(m_baseStoragePath))) {
+    if (!m_pVfs->CreateDirectory(m_baseStoragePath).HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to create base storage path: " << m_baseStoragePath;
     }
 
@@ -182,13 +187,14 @@ Result<void> CReplicaManager::WriteReplica(
     const String& expectedChecksum
 ) noexcept {
     // Write data to file
-    if (!File::Util::WriteBinary(replicaPath, data, size)) {
+    if (!m_pVfs->WriteFile(replicaPath, data, size).HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to write replica: " << replicaPath;
         return Result<void>::FromError(MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0));
     }
 
     // Verify written data
     auto verifyResult = VerifyFile(
+        *m_pVfs,
         replicaPath,
         expectedChecksum,
         m_checksumType
@@ -196,13 +202,13 @@ Result<void> CReplicaManager::WriteReplica(
 
     if (!verifyResult.HasValue()) {
         // Delete corrupted file
-        File::Util::remove(replicaPath);
+        m_pVfs->RemoveFile(replicaPath);
         LAP_PER_LOG_ERROR << "Replica verification failed";
         return Result<void>::FromError(verifyResult.Error());
     }
 
     if (!verifyResult.Value()) {
-        File::Util::remove(replicaPath);
+        m_pVfs->RemoveFile(replicaPath);
         LAP_PER_LOG_ERROR << "Replica checksum mismatch after write";
         return Result<void>::FromError(MakeErrorCode(PerErrc::kChecksumMismatch, 0));
     }
@@ -216,6 +222,7 @@ Result<Vector<UInt8>> CReplicaManager::ReadReplica(
 ) noexcept {
     // Verify checksum first
     auto verifyResult = VerifyFile(
+        *m_pVfs,
         replicaPath,
         expectedChecksum,
         m_checksumType
@@ -227,13 +234,13 @@ Result<Vector<UInt8>> CReplicaManager::ReadReplica(
     }
 
     // Read file content
-    Vector<UInt8> data;
-    if (!File::Util::ReadBinary(replicaPath, data)) {
+    auto readResult = m_pVfs->ReadFile(replicaPath);
+    if (!readResult.HasValue()) {
         LAP_PER_LOG_ERROR << "Failed to read replica: " << replicaPath;
         return Result<Vector<UInt8>>::FromError(MakeErrorCode(PerErrc::kPhysicalStorageFailure, 0));
     }
 
-    return Result<Vector<UInt8>>::FromValue(std::move(data));
+    return readResult;
 }
 
 Result<void> CReplicaManager::Write(
@@ -282,7 +289,7 @@ Result<void> CReplicaManager::Write(
         return Result<void>::FromError(MakeErrorCode(PerErrc::kOutOfStorageSpace, 0));
     }
 
-    LAP_PER_LOG_INFO << "Successfully wrote " << successCount << "/" << m_replicaCount 
+    LAP_PER_LOG_EVERY_MS( INFO, 1000 ) << "Successfully wrote " << successCount << "/" << m_replicaCount 
                      << " replicas for: " << logicalFileName;
 
     return Result<void>::FromValue();
@@ -305,15 +312,17 @@ Result<ReplicaMetadata> CReplicaManager::ValidateAllReplicas(
         status.replicaPath = GetReplicaPath(logicalFileName, i);
         
         // Check if file exists
-        status.exists = File::Util::exists(status.replicaPath);
+        status.exists = m_pVfs->Exists(status.replicaPath);
 
         if (status.exists) {
             // Get file info
-            status.fileSize = File::Util::size(status.replicaPath);
-            status.lastModified = File::Util::getModificationTime(status.replicaPath);
+            auto sizeResult = m_pVfs->GetFileSize(status.replicaPath);
+            status.fileSize = sizeResult.HasValue() ? sizeResult.Value() : 0;
+            status.lastModified = m_pVfs->GetModificationTime(status.replicaPath);
 
             // Calculate checksum
             auto checksumResult = CalculateFile(
+                *m_pVfs,
                 status.replicaPath,
                 m_checksumType
             );
@@ -390,7 +399,7 @@ Result<Vector<UInt8>> CReplicaManager::Read(
         if (replica.valid && replica.checksum == consensusChecksum) {
             auto readResult = ReadReplica(replica.replicaPath, consensusChecksum);
             if (readResult.HasValue()) {
-                LAP_PER_LOG_INFO << "Successfully read from replica " << replica.replicaIndex;
+                LAP_PER_LOG_VERBOSE << "Successfully read from replica " << replica.replicaIndex;
                 
                 // Trigger background repair if needed
                 UInt32 validCount = 0;
@@ -421,7 +430,7 @@ Result<void> CReplicaManager::Delete(
     UInt32 deletedCount = 0;
     for (UInt32 i = 0; i < m_replicaCount; ++i) {
         String replicaPath = GetReplicaPath(logicalFileName, i);
-        if (File::Util::remove(replicaPath)) {
+        if (m_pVfs->RemoveFile(replicaPath).HasValue()) {
             ++deletedCount;
         }
     }
@@ -503,7 +512,7 @@ Result<UInt32> CReplicaManager::Repair(
 }
 
 Result<Vector<String>> CReplicaManager::ListFiles() noexcept {
-    Vector<String> allFiles = Path::listFiles(StringView(m_baseStoragePath));
+    Vector<String> allFiles = m_pVfs->ListFiles(m_baseStoragePath);
 
     // Extract unique logical names
     std::set<std::string> logicalNames;
@@ -5,19 +5,232 @@
  * @date 2025-11-14
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
 #include "IKvsBackend.hpp"
 
 namespace lap
 {
 namespace per
 {
+    core::Result<void> IKvsBackend::SetValue(core::StringView key, KvsDataType&& value) noexcept
+    {
+        return SetValue(key, static_cast<const KvsDataType&>(value));
+    }
+
+    core::Result<void> IKvsBackend::GetValueAssign(core::StringView key, KvsDataType& out) const noexcept
+    {
+        using result = core::Result<void>;
+
+        auto value = GetValue(key);
+        if (!value.HasValue()) {
+            return result::FromError(value.Error());
+        }
+        if (::lap::core::GetVariantIndex(value.Value()) != ::lap::core::GetVariantIndex(out)) {
+            return result::FromError(PerErrc::kDataTypeMismatch);
+        }
+
+        out = ::std::move(value.Value());
+        return result::FromValue();
+    }
+
+    core::Result<KvsDataType> IKvsBackend::GetValueHashed(core::StringView key, core::UInt64) const noexcept
+    {
+        return GetValue(key);
+    }
+
+    core::Result<void> IKvsBackend::SetValueHashed(core::StringView key, core::UInt64, const KvsDataType& value) noexcept
+    {
+        return SetValue(key, value);
+    }
+
+    void IKvsBackend::ResolveKey(const KvsKeyHandle&) const noexcept
+    {
+    }
+
+    core::Result<KvsDataType> IKvsBackend::GetValueResolved(const KvsKeyHandle& handle) const noexcept
+    {
+        return GetValueHashed(handle.Name(), handle.Hash());
+    }
+
+    core::Result<void> IKvsBackend::SetValueResolved(const KvsKeyHandle& handle, const KvsDataType& value) noexcept
+    {
+        return SetValueHashed(handle.Name(), handle.Hash(), value);
+    }
+
+    core::Result<KvsSyncProgress> IKvsBackend::SyncToStorage(KvsSyncMeter&) noexcept
+    {
+        using result = core::Result<KvsSyncProgress>;
+
+        auto syncResult = SyncToStorage();
+        if (!syncResult.HasValue()) {
+            return result::FromError(syncResult.Error());
+        }
+        return result::FromValue(KvsSyncProgress{});
+    }
+
+    core::Result<core::UInt64> IKvsBackend::Export(IKvsRecordSink& sink, core::Size batchSize) const noexcept
+    {
+        using result = core::Result<core::UInt64>;
+
+        if (batchSize == 0) batchSize = KVS_RECORD_BATCH_SIZE;
+
+        auto keys = GetAllKeys();
+        if (!keys.HasValue()) {
+            return result::FromError(keys.Error());
+        }
+        auto begun = sink.Begin(keys.Value().size());
+        if (!begun.HasValue()) {
+            return result::FromError(begun.Error());
+        }
+
+        core::UInt64 exported = 0;
+        try {
+            KvsRecordBatch batch;
+            batch.reserve(::std::min(batchSize, keys.Value().size()));
+            for (auto& key : keys.Value()) {
+                auto value = GetValue(key);
+                if (!value.HasValue()) {
+                    if (static_cast<PerErrc>(value.Error().Value()) == PerErrc::kKeyNotFound) continue;  // Removed meanwhile
+                    return result::FromError(value.Error());
+                }
+                batch.push_back(KvsRecord{ ::std::move(key), ::std::move(value.Value()) });
+                if (batch.size() == batchSize) {
+                    auto written = sink.Write(batch);
+                    if (!written.HasValue()) {
+                        return result::FromError(written.Error());
+                    }
+                    exported += batch.size();
+                    batch.clear();
+                }
+            }
+            if (!batch.empty()) {
+                auto written = sink.Write(batch);
+                if (!written.HasValue()) {
+                    return result::FromError(written.Error());
+                }
+                exported += batch.size();
+            }
+        } catch (const ::std::bad_alloc&) {
+            return result::FromError(PerErrc::kOutOfMemorySpace);
+        }
+
+        auto finished = sink.Finish();
+        if (!finished.HasValue()) {
+            return result::FromError(finished.Error());
+        }
+        return result::FromValue(exported);
+    }
+
+    core::Result<core::UInt64> IKvsBackend::Import(IKvsRecordSource& source, const KvsImportOptions& options) noexcept
+    {
+        using result = core::Result<core::UInt64>;
+
+        if (options.clearFirst) {
+            auto cleared = RemoveAllKeys();
+            if (!cleared.HasValue()) {
+                return result::FromError(cleared.Error());
+            }
+        }
+
+        core::UInt64 imported = 0;
+        try {
+            KvsRecordBatch batch;
+            for (;;) {
+                auto read = source.Read(batch, options.batchSize);
+                if (!read.HasValue()) {
+                    return result::FromError(read.Error());
+                }
+                if (read.Value() == 0) break;
+
+                for (auto& record : batch) {
+                    auto set = SetValue(record.key, ::std::move(record.value));
+                    if (!set.HasValue()) {
+                        return result::FromError(set.Error());
+                    }
+                }
+                imported += batch.size();
+            }
+        } catch (const ::std::bad_alloc&) {
+            return result::FromError(PerErrc::kOutOfMemorySpace);
+        }
+        return result::FromValue(imported);
+    }
+
+    core::Result<void> IKvsBackend::ApplyChanges(const KvsRecordBatch& values, const core::Vector<core::String>& removedKeys) noexcept
+    {
+        using result = core::Result<void>;
+
+        for (const auto& key : removedKeys) {
+            auto removed = RemoveKey(key);
+            if (!removed.HasValue() && static_cast<PerErrc>(removed.Error().Value()) != PerErrc::kKeyNotFound) {
+                return removed;
+            }
+        }
+        for (const auto& record : values) {
+            auto set = SetValue(record.key, record.value);
+            if (!set.HasValue()) {
+                return set;
+            }
+        }
+        return result::FromValue();
+    }
+
+    core::UInt64 IKvsBackend::nextGeneration() noexcept
+    {
+        // 0 is reserved for "never resolved"
+        static ::std::atomic<core::UInt64> s_generation{ 0 };
+        return ++s_generation;
+    }
+
+    void* IKvsBackend::cachedNode(const KvsKeyHandle& handle, core::UInt64 generation) noexcept
+    {
+        return (handle.m_generation == generation) ? handle.m_pNode : nullptr;
+    }
+
+    void IKvsBackend::cacheNode(const KvsKeyHandle& handle, void* node, core::UInt64 generation) noexcept
+    {
+        handle.m_pNode      = node;
+        handle.m_generation = generation;
+    }
+
+    core::Result<core::Size> IKvsBackend::GetValueInto(core::StringView key,
+                                                       EKvsDataTypeIndicate type,
+                                                       core::Span<core::Byte> buffer) const noexcept
+    {
+        using result = core::Result<core::Size>;
+
+        auto value = GetValue(key);
+        if (!value.HasValue()) {
+            return result::FromError(value.Error());
+        }
+
+        if (static_cast<EKvsDataTypeIndicate>(::lap::core::GetVariantIndex(value.Value())) != type) {
+            return result::FromError(PerErrc::kDataTypeMismatch);
+        }
+
+        const core::Byte* data = nullptr;
+        core::Size size = 0;
+        if (!kvsRawBytes(value.Value(), data, size)) {
+            return result::FromError(PerErrc::kDataTypeMismatch);
+        }
+        if (size > buffer.size()) {
+            return result::FromError(PerErrc::kWrongDataSize);
+        }
+
+        if (size > 0) {
+            ::std::memcpy(buffer.data(), data, size);
+        }
+        return result::FromValue(size);
+    }
+
     void IKvsBackend::formatKey(core::String& key, EKvsDataTypeIndicate valueType)
     {
         // Check if key already has magic prefix
         if (key.size() >= 2 && key[DEF_KVS_MAGIC_KEY_INDEX] == DEF_KVS_MAGIC_KEY) {
-#ifdef LAP_DEBUG
-            LAP_PER_LOG_INFO << "Key is already formatted";
-#endif
+            LAP_PER_LOG_VERBOSE << "Key is already formatted";
             return;
         }
 
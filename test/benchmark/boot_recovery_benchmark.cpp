@@ -0,0 +1,652 @@
+/**
+ * @file boot_recovery_benchmark.cpp
+ * @brief Boot-time and recovery-time benchmark harness for Persistency
+ * @details Measures the two latencies that matter most at ECU start-up:
+ *          - cold / warm open-to-first-read per KVS backend and store size
+ *          - time to recover from a corrupted current/ (truncation, bit flips)
+ *            via RecoverKey, redundancy/ restore, FileStorage RecoverAllFiles
+ *            and M-out-of-N replica Read
+ *
+ * Usage:
+ *   boot_recovery_benchmark [--sizes 100,1000,10000] [--value-size 64]
+ *                           [--backends file,sqlite,property] [--repeat 3]
+ *                           [--files 16] [--file-size 65536] [--flips 8]
+ *                           [--seed 42] [--tmpfs] [--no-drop-cache]
+ *                           [--json report.json]
+ *
+ * Cold start:
+ *   The page cache is dropped via /proc/sys/vm/drop_caches when permitted
+ *   (root), otherwise every file of the instance is evicted with
+ *   posix_fadvise(POSIX_FADV_DONTNEED). With --tmpfs each benchmark instance
+ *   directory is mounted on a fresh tmpfs (requires CAP_SYS_ADMIN) so runs do
+ *   not depend on the state of the underlying file system; cache dropping is
+ *   skipped in that mode because tmpfs pages cannot be evicted.
+ *
+ * @note Property backend is measured with File persistence; its shared memory
+ *       segment is unlinked before every open so data is reloaded from disk.
+ */
+
+#include "CKvsFileBackend.hpp"
+#include "CKvsSqliteBackend.hpp"
+#include "CKvsPropertyBackend.hpp"
+#include "CReplicaManager.hpp"
+#include "CStoragePathManager.hpp"
+#include "CPersistency.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <fcntl.h>
+#include <sys/mount.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lap::per;
+using namespace lap::per::util;
+using namespace lap::core;
+
+namespace fs = ::std::filesystem;
+
+// ============================================================================
+// Benchmark Infrastructure
+// ============================================================================
+
+class BenchmarkTimer {
+public:
+    void Start() { m_start = ::std::chrono::steady_clock::now(); }
+    void Stop() { m_end = ::std::chrono::steady_clock::now(); }
+
+    double GetMilliseconds() const {
+        return ::std::chrono::duration_cast<::std::chrono::microseconds>(
+            m_end - m_start).count() / 1000.0;
+    }
+
+private:
+    ::std::chrono::steady_clock::time_point m_start;
+    ::std::chrono::steady_clock::time_point m_end;
+};
+
+struct BootOptions {
+    ::std::vector<int> sizes{ 100, 1000, 10000 };
+    ::std::set<::std::string> backends{ "file", "sqlite", "property" };
+    int valueSize{ 64 };
+    int repeat{ 3 };
+    int files{ 16 };
+    int fileSize{ 64 * 1024 };
+    int flips{ 8 };
+    unsigned seed{ 42 };
+    bool tmpfs{ false };
+    bool dropCache{ true };
+    ::std::string jsonReport;
+};
+
+struct Sample {
+    ::std::string backend;
+    int size;
+    ::std::string scenario;
+    double ms;
+    bool ok;
+    ::std::string note;
+};
+
+static ::std::vector<Sample> g_samples;
+static ::std::vector<::std::string> g_mounts;
+
+static void Report(const ::std::string& backend, int size, const ::std::string& scenario,
+                   double ms, bool ok, const ::std::string& note = "") {
+    g_samples.push_back({ backend, size, scenario, ms, ok, note });
+    ::std::cout << "  " << ::std::left << ::std::setw(34) << scenario
+                << ::std::right << ::std::fixed << ::std::setprecision(3)
+                << ::std::setw(12) << ms << " ms  "
+                << (ok ? "ok" : "FAILED")
+                << (note.empty() ? "" : "  (" + note + ")") << ::std::endl;
+}
+
+static double Median(::std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    ::std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static ::std::string KeyName(int i) {
+    return "boot_key_" + ::std::to_string(i);
+}
+
+// ============================================================================
+// Storage Environment (tmpfs, page cache, shared memory)
+// ============================================================================
+
+static void PrepareInstanceDir(const ::std::string& dir, const BootOptions& options) {
+    ::std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir, ec);
+
+    if (options.tmpfs) {
+        if (::mount("tmpfs", dir.c_str(), "tmpfs", 0, "size=512m,mode=0755") == 0) {
+            g_mounts.push_back(dir);
+        } else {
+            ::std::cerr << "  [WARN] tmpfs mount on " << dir << " failed: "
+                        << ::std::strerror(errno) << ", using underlying file system" << ::std::endl;
+        }
+    }
+}
+
+static void ReleaseMounts() {
+    for (auto it = g_mounts.rbegin(); it != g_mounts.rend(); ++it) {
+        ::umount2(it->c_str(), MNT_DETACH);
+    }
+    g_mounts.clear();
+}
+
+/**
+ * @brief Evict the pages of all files below dir from the page cache
+ * @return Method used: "drop_caches", "fadvise", "tmpfs" or "none"
+ */
+static ::std::string DropPageCache(const ::std::string& dir, const BootOptions& options) {
+    if (!options.dropCache) return "none";
+    if (options.tmpfs && !g_mounts.empty()) return "tmpfs";
+
+    ::sync();
+    {
+        ::std::ofstream dropCaches("/proc/sys/vm/drop_caches");
+        if (dropCaches && (dropCaches << "3" << ::std::flush)) return "drop_caches";
+    }
+
+    ::std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(dir, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        int fd = ::open(it->path().c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+    return "fadvise";
+}
+
+/**
+ * @brief Unlink this process' Property backend shared memory segments
+ * @note Forces the next KvsPropertyBackend to reload from persistence
+ */
+static void UnlinkPropertyShm() {
+    const ::std::string prefix = "shm_kvs_" + ::std::to_string(::getpid()) + "_";
+    ::std::error_code ec;
+    for (auto it = fs::directory_iterator("/dev/shm", ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->path().filename().string().rfind(prefix, 0) == 0) {
+            fs::remove(it->path(), ec);
+        }
+    }
+}
+
+// ============================================================================
+// Corruption Injection
+// ============================================================================
+
+enum class Corruption { kTruncate, kBitFlip };
+
+static const char* CorruptionName(Corruption mode) {
+    return mode == Corruption::kTruncate ? "truncate" : "bitflip";
+}
+
+static bool ReadAll(const ::std::string& path, ::std::vector<char>& data) {
+    ::std::ifstream in(path, ::std::ios::binary);
+    if (!in) return false;
+    data.assign(::std::istreambuf_iterator<char>(in), ::std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool WriteAll(const ::std::string& path, const ::std::vector<char>& data) {
+    ::std::ofstream out(path, ::std::ios::binary | ::std::ios::trunc);
+    if (!out) return false;
+    out.write(data.data(), static_cast<::std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Corrupt a file in place
+ * @details kTruncate keeps the first half of the file, kBitFlip flips
+ *          options.flips random bits (deterministic for a given seed + salt).
+ */
+static bool InjectCorruption(const ::std::string& path, Corruption mode, const BootOptions& options,
+                             unsigned salt = 0) {
+    ::std::vector<char> data;
+    if (!ReadAll(path, data) || data.empty()) return false;
+
+    if (mode == Corruption::kTruncate) {
+        data.resize(data.size() / 2);
+    } else {
+        ::std::mt19937 rng(options.seed + salt);
+        ::std::uniform_int_distribution<size_t> pos(0, data.size() - 1);
+        ::std::uniform_int_distribution<int> bit(0, 7);
+        for (int i = 0; i < options.flips; ++i) {
+            data[pos(rng)] ^= static_cast<char>(1 << bit(rng));
+        }
+    }
+    return WriteAll(path, data);
+}
+
+// ============================================================================
+// KVS Backends
+// ============================================================================
+
+struct KvsTarget {
+    ::std::string name;
+    ::std::string instance;
+    ::std::string dataFile;         ///< File that holds current/ data
+    ::std::string redundancyFile;   ///< Backup written by SyncToStorage, empty if none
+    ::std::function<::std::unique_ptr<IKvsBackend>()> open;
+};
+
+static KvsTarget MakeTarget(const ::std::string& backend, int size) {
+    KvsTarget target;
+    target.name = backend;
+    target.instance = "boot_bench_" + backend + "_" + ::std::to_string(size);
+
+    const ::std::string dir = CStoragePathManager::getKvsInstancePath(target.instance.c_str()).c_str();
+    const ::std::string instance = target.instance;
+
+    if (backend == "sqlite") {
+        target.dataFile = dir + "/current/db.sqlite";
+        target.open = [instance]() -> ::std::unique_ptr<IKvsBackend> {
+            return ::std::unique_ptr<IKvsBackend>(new KvsSqliteBackend(instance.c_str()));
+        };
+    } else if (backend == "property") {
+        target.dataFile = dir + "/current/kvs_data.json";
+        target.redundancyFile = dir + "/redundancy/kvs_data.json.bak";
+        target.open = [instance]() -> ::std::unique_ptr<IKvsBackend> {
+            UnlinkPropertyShm();
+            return ::std::unique_ptr<IKvsBackend>(
+                new KvsPropertyBackend(instance.c_str(), KvsBackendType::kvsFile, 64ul << 20));
+        };
+    } else {
+        target.dataFile = dir + "/current/kvs_data.json";
+        target.redundancyFile = dir + "/redundancy/kvs_data.json.bak";
+        target.open = [instance]() -> ::std::unique_ptr<IKvsBackend> {
+            return ::std::unique_ptr<IKvsBackend>(new KvsFileBackend(instance.c_str()));
+        };
+    }
+    return target;
+}
+
+/**
+ * @brief Open the store and read the first key
+ * @return true if the first key was readable
+ */
+static bool OpenToFirstRead(const KvsTarget& target, double& ms) {
+    BenchmarkTimer timer;
+    bool ok = false;
+    timer.Start();
+    try {
+        auto backend = target.open();
+        ok = backend->available() && backend->GetValue(KeyName(0)).HasValue();
+        timer.Stop();
+    } catch (const ::std::exception&) {
+        timer.Stop();
+    }
+    ms = timer.GetMilliseconds();
+    return ok;
+}
+
+static void BenchmarkKvsBackend(const ::std::string& backendName, int size, const BootOptions& options) {
+    ::std::cout << "\n=== " << backendName << " backend, " << size << " keys ===" << ::std::endl;
+
+    KvsTarget target = MakeTarget(backendName, size);
+    const ::std::string dir = CStoragePathManager::getKvsInstancePath(target.instance.c_str()).c_str();
+    PrepareInstanceDir(dir, options);
+
+    const ::std::string value(static_cast<size_t>(options.valueSize), 'v');
+    BenchmarkTimer timer;
+
+    // Generate the store; sync twice so redundancy/ holds a valid backup
+    timer.Start();
+    {
+        auto backend = target.open();
+        for (int i = 0; i < size; ++i) {
+            backend->SetValue(KeyName(i), String(value.c_str()));
+        }
+        backend->SyncToStorage();
+        backend->SetValue(KeyName(0), String(value.c_str()));
+        backend->SetValue("boot_generation", Int32(2));
+        backend->SyncToStorage();
+    }
+    timer.Stop();
+    Report(backendName, size, "generate", timer.GetMilliseconds(), true);
+
+    ::std::vector<char> pristine;
+    ReadAll(target.dataFile, pristine);
+
+    // Cold and warm open-to-first-read
+    ::std::vector<double> cold;
+    ::std::vector<double> warm;
+    bool coldOk = true;
+    bool warmOk = true;
+    ::std::string method;
+    for (int r = 0; r < options.repeat; ++r) {
+        double ms = 0.0;
+        method = DropPageCache(dir, options);
+        coldOk &= OpenToFirstRead(target, ms);
+        cold.push_back(ms);
+        warmOk &= OpenToFirstRead(target, ms);
+        warm.push_back(ms);
+    }
+    Report(backendName, size, "open_to_first_read.cold", Median(cold), coldOk, method);
+    Report(backendName, size, "open_to_first_read.warm", Median(warm), warmOk);
+
+    // Logical recovery: RecoverKey on a removed key
+    {
+        auto backend = target.open();
+        backend->RemoveKey(KeyName(0));
+        backend->SyncToStorage();
+        timer.Start();
+        auto recovered = backend->RecoverKey(KeyName(0));
+        timer.Stop();
+        const bool readable = backend->GetValue(KeyName(0)).HasValue();
+        Report(backendName, size, "recover_key.removed", timer.GetMilliseconds(),
+               recovered.HasValue() && readable, readable ? "" : "key not restored");
+    }
+    WriteAll(target.dataFile, pristine);
+
+    // Physical corruption of current/
+    for (Corruption mode : { Corruption::kTruncate, Corruption::kBitFlip }) {
+        const ::std::string tag = CorruptionName(mode);
+        WriteAll(target.dataFile, pristine);
+        if (!InjectCorruption(target.dataFile, mode, options)) {
+            Report(backendName, size, "corrupt." + tag, 0.0, false, "injection failed");
+            continue;
+        }
+
+        // Time until the corruption surfaces; a store that serves the first read
+        // from a damaged current/ missed it, which is the failure to report
+        double ms = 0.0;
+        DropPageCache(dir, options);
+        const bool readable = OpenToFirstRead(target, ms);
+        Report(backendName, size, "corrupt." + tag + ".open_to_first_read", ms, !readable,
+               readable ? "corruption not detected" : "corruption detected");
+
+        // RecoverKey on the corrupted store
+        try {
+            auto backend = target.open();
+            timer.Start();
+            auto recovered = backend->RecoverKey(KeyName(0));
+            timer.Stop();
+            const bool ok = recovered.HasValue() && backend->GetValue(KeyName(0)).HasValue();
+            Report(backendName, size, "corrupt." + tag + ".recover_key", timer.GetMilliseconds(), ok);
+        } catch (const ::std::exception& e) {
+            Report(backendName, size, "corrupt." + tag + ".recover_key", 0.0, false, e.what());
+        }
+
+        // Restore from redundancy/ and reopen (I/O floor of redundancy-based recovery)
+        if (!target.redundancyFile.empty() && fs::exists(target.redundancyFile)) {
+            WriteAll(target.dataFile, pristine);
+            InjectCorruption(target.dataFile, mode, options);
+            DropPageCache(dir, options);
+            timer.Start();
+            ::std::error_code ec;
+            fs::copy_file(target.redundancyFile, target.dataFile, fs::copy_options::overwrite_existing, ec);
+            double openMs = 0.0;
+            const bool ok = !ec && OpenToFirstRead(target, openMs);
+            timer.Stop();
+            Report(backendName, size, "corrupt." + tag + ".redundancy_restore", timer.GetMilliseconds(), ok);
+        }
+    }
+
+    WriteAll(target.dataFile, pristine);
+    ReleaseMounts();
+    ::std::error_code ec;
+    fs::remove_all(dir, ec);
+    if (backendName == "property") UnlinkPropertyShm();
+}
+
+// ============================================================================
+// FileStorage RecoverAllFiles
+// ============================================================================
+
+static void BenchmarkRecoverAllFiles(const BootOptions& options) {
+    ::std::cout << "\n=== FileStorage RecoverAllFiles, " << options.files << " x "
+                << options.fileSize << " bytes ===" << ::std::endl;
+
+    if (!CPersistencyManager::getInstance().initialize()) {
+        Report("fs", options.files, "recover_all_files", 0.0, false, "manager init failed");
+        return;
+    }
+
+    InstanceSpecifier spec("boot_bench_fs");
+    auto fsResult = OpenFileStorage(spec, true);
+    if (!fsResult.HasValue() || fsResult.Value()->GetBackend() == nullptr) {
+        Report("fs", options.files, "recover_all_files", 0.0, false, "open failed");
+        return;
+    }
+    CFileStorageBackend* backend = fsResult.Value()->GetBackend();
+
+    ::std::mt19937 rng(options.seed);
+    Vector<Byte> content(static_cast<size_t>(options.fileSize));
+    for (auto& byte : content) byte = static_cast<Byte>(rng());
+
+    for (int i = 0; i < options.files; ++i) {
+        const String name = ("boot_file_" + ::std::to_string(i) + ".bin").c_str();
+        backend->WriteFile(name, content, LAP_PER_CATEGORY_CURRENT);
+        backend->WriteFile(name, content, LAP_PER_CATEGORY_BACKUP);
+    }
+
+    const ::std::string currentDir = CStoragePathManager::getFileStorageInstancePath("boot_bench_fs").c_str()
+                                   + ::std::string("/") + LAP_PER_CATEGORY_CURRENT;
+
+    for (Corruption mode : { Corruption::kTruncate, Corruption::kBitFlip }) {
+        for (int i = 0; i < options.files; ++i) {
+            InjectCorruption(currentDir + "/boot_file_" + ::std::to_string(i) + ".bin", mode, options);
+        }
+
+        BenchmarkTimer timer;
+        DropPageCache(currentDir, options);
+        timer.Start();
+        auto recovered = RecoverAllFiles(spec);
+        timer.Stop();
+
+        bool ok = recovered.HasValue();
+        for (int i = 0; ok && i < options.files; ++i) {
+            auto data = backend->ReadFile(("boot_file_" + ::std::to_string(i) + ".bin").c_str());
+            ok = data.HasValue() && data.Value() == content;
+        }
+        Report("fs", options.files, ::std::string("recover_all_files.") + CorruptionName(mode),
+               timer.GetMilliseconds(), ok);
+    }
+
+    for (int i = 0; i < options.files; ++i) {
+        const String name = ("boot_file_" + ::std::to_string(i) + ".bin").c_str();
+        backend->DeleteFile(name, LAP_PER_CATEGORY_CURRENT);
+        backend->DeleteFile(name, LAP_PER_CATEGORY_BACKUP);
+    }
+}
+
+// ============================================================================
+// Replica Read
+// ============================================================================
+
+static void BenchmarkReplicaRead(const BootOptions& options) {
+    ::std::cout << "\n=== CReplicaManager Read (3 replicas, M=2), " << options.fileSize
+                << " bytes ===" << ::std::endl;
+
+    const ::std::string dir = CStoragePathManager::getKvsInstancePath("boot_bench_replica").c_str();
+    PrepareInstanceDir(dir, options);
+
+    CReplicaManager manager(dir.c_str(), 3, 2, ChecksumType::kCRC32);
+    ::std::mt19937 rng(options.seed);
+    ::std::vector<UInt8> content(static_cast<size_t>(options.fileSize));
+    for (auto& byte : content) byte = static_cast<UInt8>(rng());
+
+    const String logical = "boot_replica.bin";
+    BenchmarkTimer timer;
+    timer.Start();
+    auto written = manager.Write(logical, content.data(), content.size());
+    timer.Stop();
+    Report("replica", 3, "write", timer.GetMilliseconds(), written.HasValue());
+
+    DropPageCache(dir, options);
+    timer.Start();
+    auto clean = manager.Read(logical);
+    timer.Stop();
+    Report("replica", 3, "read.clean", timer.GetMilliseconds(), clean.HasValue() && clean.Value() == content);
+
+    const ::std::string replica0 = dir + "/boot_replica.bin." + LAP_PER_REPLICA_DIR_PREFIX + "0";
+    const ::std::string replica1 = dir + "/boot_replica.bin." + LAP_PER_REPLICA_DIR_PREFIX + "1";
+
+    for (Corruption mode : { Corruption::kTruncate, Corruption::kBitFlip }) {
+        const ::std::string tag = CorruptionName(mode);
+
+        // One bad replica: consensus must still succeed
+        manager.Write(logical, content.data(), content.size());
+        InjectCorruption(replica0, mode, options);
+        DropPageCache(dir, options);
+        timer.Start();
+        auto oneBad = manager.Read(logical);
+        timer.Stop();
+        Report("replica", 3, "read.one_corrupt." + tag, timer.GetMilliseconds(),
+               oneBad.HasValue() && oneBad.Value() == content);
+
+        timer.Start();
+        auto repaired = manager.Repair(logical);
+        timer.Stop();
+        Report("replica", 3, "repair.one_corrupt." + tag, timer.GetMilliseconds(), repaired.HasValue());
+
+        // Two bad replicas: M=2 cannot be met, measure time to detect
+        manager.Write(logical, content.data(), content.size());
+        InjectCorruption(replica0, mode, options);
+        InjectCorruption(replica1, Corruption::kBitFlip, options, 1);
+        DropPageCache(dir, options);
+        timer.Start();
+        auto twoBad = manager.Read(logical);
+        timer.Stop();
+        Report("replica", 3, "read.two_corrupt." + tag, timer.GetMilliseconds(),
+               !twoBad.HasValue() || twoBad.Value() == content,
+               twoBad.HasValue() ? "" : "consensus lost (expected)");
+    }
+
+    manager.Delete(logical);
+    ReleaseMounts();
+    ::std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static ::std::vector<::std::string> Split(const ::std::string& text) {
+    ::std::vector<::std::string> parts;
+    ::std::stringstream stream(text);
+    ::std::string item;
+    while (::std::getline(stream, item, ',')) {
+        if (!item.empty()) parts.push_back(item);
+    }
+    return parts;
+}
+
+static bool ParseArguments(int argc, char* argv[], BootOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const ::std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--sizes" && hasValue) {
+            options.sizes.clear();
+            for (const auto& s : Split(argv[++i])) options.sizes.push_back(::std::max(1, ::std::atoi(s.c_str())));
+        } else if (arg == "--backends" && hasValue) {
+            auto list = Split(argv[++i]);
+            options.backends = ::std::set<::std::string>(list.begin(), list.end());
+        } else if (arg == "--value-size" && hasValue) {
+            options.valueSize = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (arg == "--files" && hasValue) {
+            options.files = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (arg == "--file-size" && hasValue) {
+            options.fileSize = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (arg == "--flips" && hasValue) {
+            options.flips = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(::std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--json" && hasValue) {
+            options.jsonReport = argv[++i];
+        } else if (arg == "--tmpfs") {
+            options.tmpfs = true;
+        } else if (arg == "--no-drop-cache") {
+            options.dropCache = false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void WriteJsonReport(const BootOptions& options) {
+    nlohmann::json report;
+    report["valueSize"] = options.valueSize;
+    report["repeat"] = options.repeat;
+    report["tmpfs"] = options.tmpfs;
+    report["samples"] = nlohmann::json::array();
+    for (const auto& sample : g_samples) {
+        report["samples"].push_back({
+            { "backend", sample.backend },
+            { "size", sample.size },
+            { "scenario", sample.scenario },
+            { "ms", sample.ms },
+            { "ok", sample.ok },
+            { "note", sample.note }
+        });
+    }
+    ::std::ofstream out(options.jsonReport, ::std::ios::trunc);
+    out << report.dump(4) << ::std::endl;
+    ::std::cout << "\nJSON report: " << options.jsonReport << ::std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BootOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        ::std::cerr << "Usage: " << argv[0]
+                    << " [--sizes a,b,c] [--backends file,sqlite,property] [--value-size N]"
+                    << " [--repeat N] [--files N] [--file-size N] [--flips N] [--seed N]"
+                    << " [--tmpfs] [--no-drop-cache] [--json file]" << ::std::endl;
+        return 2;
+    }
+
+    try {
+        ::std::cout << "========================================" << ::std::endl;
+        ::std::cout << "  Persistency Boot & Recovery Benchmark" << ::std::endl;
+        ::std::cout << "========================================" << ::std::endl;
+
+        for (const auto& backend : { "file", "sqlite", "property" }) {
+            if (options.backends.count(backend) == 0) continue;
+            for (int size : options.sizes) {
+                BenchmarkKvsBackend(backend, size, options);
+            }
+        }
+
+        BenchmarkRecoverAllFiles(options);
+        BenchmarkReplicaRead(options);
+
+        if (!options.jsonReport.empty()) WriteJsonReport(options);
+
+        ::std::cout << "\n========================================" << ::std::endl;
+        ::std::cout << "  Boot & recovery benchmark completed" << ::std::endl;
+        ::std::cout << "========================================" << ::std::endl;
+
+    } catch (const ::std::exception& e) {
+        ReleaseMounts();
+        ::std::cerr << "\nBenchmark failed with exception: " << e.what() << ::std::endl;
+        return 1;
+    }
+
+    return 0;
+}
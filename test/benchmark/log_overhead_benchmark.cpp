@@ -0,0 +1,267 @@
+/**
+ * @file log_overhead_benchmark.cpp
+ * @brief Cost of persistency logging on hot paths at the configured build-time log level
+ * @details Compares a runtime-filtered log statement (the pre-LAP_PER_LOG_LEVEL
+ *          expansion: operands always formatted, logger drops the record) with
+ *          the compile-time gated LAP_PER_LOG_* macros and the sampled /
+ *          rate-limited variants, then times the backend hot paths that used to
+ *          log unconditionally.
+ *
+ * Usage:
+ *   log_overhead_benchmark [--iterations N] [--keys N] [--syncs N]
+ *
+ * Build the module twice to compare end-to-end numbers, e.g.
+ *   cmake -DLAP_PER_LOG_LEVEL=VERBOSE ..   vs   cmake -DLAP_PER_LOG_LEVEL=WARN ..
+ */
+
+#include "CKvsFileBackend.hpp"
+#include "CKvsPropertyBackend.hpp"
+#include "CReplicaManager.hpp"
+#include "CStoragePathManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace lap::per;
+using namespace lap::per::util;
+using namespace lap::core;
+
+// ============================================================================
+// Benchmark Infrastructure
+// ============================================================================
+
+class BenchmarkTimer {
+public:
+    void Start() { m_start = ::std::chrono::steady_clock::now(); }
+    void Stop() { m_end = ::std::chrono::steady_clock::now(); }
+
+    double GetNanoseconds() const {
+        return static_cast<double>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            m_end - m_start).count());
+    }
+
+private:
+    ::std::chrono::steady_clock::time_point m_start;
+    ::std::chrono::steady_clock::time_point m_end;
+};
+
+struct BenchOptions {
+    int iterations{ 1000000 };
+    int keys{ 2000 };
+    int syncs{ 200 };
+};
+
+// Counts how often log operands were actually evaluated
+static ::std::size_t g_evaluations = 0;
+
+static ::std::string Operand(int i) {
+    ++g_evaluations;
+    return "hot_path_key_" + ::std::to_string(i);
+}
+
+static const char* LevelName() {
+    switch (LAP_PER_LOG_LEVEL) {
+        case LAP_PER_LOG_LEVEL_OFF:     return "OFF";
+        case LAP_PER_LOG_LEVEL_FATAL:   return "FATAL";
+        case LAP_PER_LOG_LEVEL_ERROR:   return "ERROR";
+        case LAP_PER_LOG_LEVEL_WARN:    return "WARN";
+        case LAP_PER_LOG_LEVEL_INFO:    return "INFO";
+        case LAP_PER_LOG_LEVEL_DEBUG:   return "DEBUG";
+        default:                        return "VERBOSE";
+    }
+}
+
+static void PrintRow(const char* name, double nsPerOp, ::std::size_t evaluations) {
+    ::std::cout << "  " << ::std::left << ::std::setw(34) << name
+                << ::std::right << ::std::setw(10) << ::std::fixed << ::std::setprecision(2)
+                << nsPerOp << " ns/stmt" << ::std::setw(12) << evaluations << " evals" << ::std::endl;
+}
+
+static void ResetInstance(const char* instance) {
+    ::std::error_code ec;
+    ::std::filesystem::remove_all(CStoragePathManager::getKvsInstancePath(instance).c_str(), ec);
+}
+
+// ============================================================================
+// Statement-level Cost
+// ============================================================================
+
+static void RunStatementBenchmarks(const BenchOptions& options) {
+    BenchmarkTimer timer;
+    const int n = options.iterations;
+
+    ::std::cout << "\n[Statement cost] iterations=" << n << ::std::endl;
+
+    // Pre-change expansion of LAP_PER_LOG_DEBUG: always formats, filtered at runtime
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG.LogDebug().WithLocation(__FILE__, __LINE__) << Operand(i) << " value=" << i;
+    }
+    timer.Stop();
+    PrintRow("runtime-filtered DEBUG <<", timer.GetNanoseconds() / n, g_evaluations);
+
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG.LogDebug().WithLocation(__FILE__, __LINE__).logFormat("key=%s value=%d", Operand(i).c_str(), i);
+    }
+    timer.Stop();
+    PrintRow("runtime-filtered DEBUG logFormat", timer.GetNanoseconds() / n, g_evaluations);
+
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG_DEBUG << Operand(i) << " value=" << i;
+    }
+    timer.Stop();
+    PrintRow("LAP_PER_LOG_DEBUG <<", timer.GetNanoseconds() / n, g_evaluations);
+
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG_DEBUG.logFormat("key=%s value=%d", Operand(i).c_str(), i);
+    }
+    timer.Stop();
+    PrintRow("LAP_PER_LOG_DEBUG logFormat", timer.GetNanoseconds() / n, g_evaluations);
+
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG_EVERY_N( DEBUG, 1024 ) << Operand(i) << " value=" << i;
+    }
+    timer.Stop();
+    PrintRow("LAP_PER_LOG_EVERY_N(DEBUG,1024)", timer.GetNanoseconds() / n, g_evaluations);
+
+    g_evaluations = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        LAP_PER_LOG_EVERY_MS( DEBUG, 1000 ) << Operand(i) << " value=" << i;
+    }
+    timer.Stop();
+    PrintRow("LAP_PER_LOG_EVERY_MS(DEBUG,1000)", timer.GetNanoseconds() / n, g_evaluations);
+
+    // Sampler decision alone, i.e. the cost of a sampled statement whose level is compiled in
+    ::std::atomic<UInt32> counter{ 0 };
+    ::std::size_t taken = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        if (detail::logEveryN(counter, 1024)) ++taken;
+    }
+    timer.Stop();
+    PrintRow("sampler decision (every N)", timer.GetNanoseconds() / n, taken);
+
+    ::std::atomic<Int64> lastMs{ INT64_MIN };
+    taken = 0;
+    timer.Start();
+    for (int i = 0; i < n; ++i) {
+        if (detail::logEveryMs(lastMs, 1000)) ++taken;
+    }
+    timer.Stop();
+    PrintRow("sampler decision (every ms)", timer.GetNanoseconds() / n, taken);
+}
+
+// ============================================================================
+// Backend Hot Paths
+// ============================================================================
+
+static void RunBackendBenchmarks(const BenchOptions& options) {
+    BenchmarkTimer timer;
+
+    ::std::cout << "\n[Hot paths] keys=" << options.keys << " syncs=" << options.syncs << ::std::endl;
+
+    {
+        // KvsPropertyBackend::SetValue (per-key logFormat before this change)
+        ResetInstance("log_bench_property");
+        KvsPropertyBackend backend("log_bench_property", KvsBackendType::kvsNone);
+        timer.Start();
+        for (int i = 0; i < options.keys; ++i) {
+            backend.SetValue("key_" + ::std::to_string(i), Int32(i));
+        }
+        timer.Stop();
+        ::std::cout << "  property.set        " << ::std::setw(10) << timer.GetNanoseconds() / options.keys / 1000.0
+                    << " us/op" << ::std::endl;
+        backend.RemoveAllKeys();
+        ResetInstance("log_bench_property");
+    }
+
+    {
+        // KvsFileBackend::SyncToStorage (per-phase INFO logs before this change)
+        ResetInstance("log_bench_file");
+        KvsFileBackend backend("log_bench_file");
+        backend.SetValue("seed", String("value"));
+        timer.Start();
+        for (int i = 0; i < options.syncs; ++i) {
+            backend.SetValue("counter", Int32(i));
+            backend.SyncToStorage();
+        }
+        timer.Stop();
+        ::std::cout << "  file.sync           " << ::std::setw(10) << timer.GetNanoseconds() / options.syncs / 1000.0
+                    << " us/op" << ::std::endl;
+        ResetInstance("log_bench_file");
+    }
+
+    {
+        // CReplicaManager::Write (per-write INFO log before this change)
+        const String basePath = "/tmp/log_bench_replicas";
+        ::std::error_code ec;
+        ::std::filesystem::remove_all(basePath.c_str(), ec);
+        CReplicaManager replicas(basePath, 3, 2, ChecksumType::kCRC32);
+        const ::std::string payload(256, 'x');
+        timer.Start();
+        for (int i = 0; i < options.syncs; ++i) {
+            replicas.Write("payload", reinterpret_cast<const UInt8*>(payload.data()), payload.size());
+        }
+        timer.Stop();
+        ::std::cout << "  replica.write       " << ::std::setw(10) << timer.GetNanoseconds() / options.syncs / 1000.0
+                    << " us/op" << ::std::endl;
+        ::std::filesystem::remove_all(basePath.c_str(), ec);
+    }
+}
+
+static bool ParseArguments(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1 < argc);
+        if (::std::strcmp(argv[i], "--iterations") == 0 && hasValue) {
+            options.iterations = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (::std::strcmp(argv[i], "--keys") == 0 && hasValue) {
+            options.keys = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (::std::strcmp(argv[i], "--syncs") == 0 && hasValue) {
+            options.syncs = ::std::max(1, ::std::atoi(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        ::std::cerr << "Usage: " << argv[0] << " [--iterations N] [--keys N] [--syncs N]" << ::std::endl;
+        return 2;
+    }
+
+    try {
+        ::std::cout << "========================================" << ::std::endl;
+        ::std::cout << "  Persistency Log Overhead Benchmark" << ::std::endl;
+        ::std::cout << "  LAP_PER_LOG_LEVEL=" << LevelName() << ::std::endl;
+        ::std::cout << "========================================" << ::std::endl;
+
+        RunStatementBenchmarks(options);
+        RunBackendBenchmarks(options);
+
+        ::std::cout << "\nDone." << ::std::endl;
+        return 0;
+
+    } catch (const ::std::exception& e) {
+        ::std::cerr << "\nBenchmark failed with exception: " << e.what() << ::std::endl;
+        return 1;
+    }
+}
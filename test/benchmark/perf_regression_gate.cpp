@@ -0,0 +1,363 @@
+/**
+ * @file perf_regression_gate.cpp
+ * @brief Performance regression gate for Persistency backends (CTest: persistency_perf)
+ * @details Runs a fast, stable subset of the backend benchmarks, compares the
+ *          measured metrics against a checked-in baseline JSON with per-metric
+ *          tolerances and fails (non-zero exit) when a metric regresses.
+ *
+ * Usage:
+ *   perf_regression_gate --baseline <perf_baseline.json> [--report <report.json>]
+ *                        [--keys N] [--rounds N] [--update-baseline]
+ *
+ * Baseline format:
+ * ```json
+ * {
+ *   "defaultTolerance": 1.0,           // allowed relative slowdown (1.0 = +100%)
+ *   "defaultAbsoluteSlack": 0.5,       // allowed absolute slowdown in metric unit
+ *   "metrics": {
+ *     "sqlite.set": { "unit": "us/op", "baseline": 30.0, "tolerance": 1.5 }
+ *   }
+ * }
+ * ```
+ * A metric fails when: measured > baseline * (1 + tolerance) + absoluteSlack.
+ * All metrics are "lower is better". Each metric is the median of several rounds.
+ *
+ * @note Regenerate the baseline on the reference machine with --update-baseline;
+ *       tolerances and slack values of existing entries are preserved.
+ */
+
+#include "CKvsFileBackend.hpp"
+#include "CKvsSqliteBackend.hpp"
+#include "CKvsPropertyBackend.hpp"
+#include "CStoragePathManager.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace lap::per;
+using namespace lap::per::util;
+using namespace lap::core;
+
+// Used when the baseline omits them, and written into a new baseline
+static constexpr double DEFAULT_TOLERANCE = 1.0;
+static constexpr double DEFAULT_ABSOLUTE_SLACK = 0.5;
+
+// ============================================================================
+// Benchmark Infrastructure
+// ============================================================================
+
+class BenchmarkTimer {
+public:
+    void Start() { m_start = ::std::chrono::steady_clock::now(); }
+    void Stop() { m_end = ::std::chrono::steady_clock::now(); }
+
+    double GetMicroseconds() const {
+        return ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            m_end - m_start).count() / 1000.0;
+    }
+
+private:
+    ::std::chrono::steady_clock::time_point m_start;
+    ::std::chrono::steady_clock::time_point m_end;
+};
+
+struct GateOptions {
+    ::std::string baselinePath;
+    ::std::string reportPath{ "persistency_perf_report.json" };
+    int keys{ 500 };
+    int rounds{ 5 };
+    bool updateBaseline{ false };
+};
+
+struct Metric {
+    ::std::string unit;
+    ::std::vector<double> samples;
+
+    double Median() const {
+        if (samples.empty()) return 0.0;
+        ::std::vector<double> sorted(samples);
+        ::std::sort(sorted.begin(), sorted.end());
+        const size_t mid = sorted.size() / 2;
+        return (sorted.size() % 2) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+    }
+};
+
+using MetricMap = ::std::map<::std::string, Metric>;
+
+static ::std::string KeyName(int i) {
+    return "perf_key_" + ::std::to_string(i);
+}
+
+static void ResetInstance(const char* instance) {
+    ::std::error_code ec;
+    ::std::filesystem::remove_all(CStoragePathManager::getKvsInstancePath(instance).c_str(), ec);
+}
+
+static void Record(MetricMap& metrics, const ::std::string& name, const char* unit, double value) {
+    auto& metric = metrics[name];
+    metric.unit = unit;
+    metric.samples.push_back(value);
+}
+
+// ============================================================================
+// Benchmark Subset
+// ============================================================================
+
+/**
+ * @brief set / get per-op latency and full sync time for one backend instance
+ * @note Each round starts from an empty instance so results do not drift with
+ *       the number of rounds.
+ */
+static void RunBackendRound(MetricMap& metrics, const ::std::string& prefix,
+                            IKvsBackend& backend, int keys) {
+    BenchmarkTimer timer;
+
+    timer.Start();
+    for (int i = 0; i < keys; ++i) {
+        backend.SetValue(KeyName(i), String(("value_" + ::std::to_string(i)).c_str()));
+    }
+    timer.Stop();
+    Record(metrics, prefix + ".set", "us/op", timer.GetMicroseconds() / keys);
+
+    int hits = 0;
+    timer.Start();
+    for (int i = 0; i < keys; ++i) {
+        if (backend.GetValue(KeyName(i)).HasValue()) ++hits;
+    }
+    timer.Stop();
+    Record(metrics, prefix + ".get", "us/op", timer.GetMicroseconds() / keys);
+
+    if (hits != keys) {
+        ::std::cerr << "  [WARN] " << prefix << ": only " << hits << "/" << keys
+                    << " keys readable" << ::std::endl;
+    }
+
+    if (backend.SupportsPersistence()) {
+        timer.Start();
+        backend.SyncToStorage();
+        timer.Stop();
+        Record(metrics, prefix + ".sync", "ms", timer.GetMicroseconds() / 1000.0);
+    }
+}
+
+static void RunSubset(MetricMap& metrics, const GateOptions& options) {
+    for (int round = 0; round < options.rounds; ++round) {
+        {
+            ResetInstance("perf_gate_file");
+            KvsFileBackend backend("perf_gate_file");
+            RunBackendRound(metrics, "file", backend, options.keys);
+        }
+        {
+            ResetInstance("perf_gate_sqlite");
+            KvsSqliteBackend backend("perf_gate_sqlite");
+            RunBackendRound(metrics, "sqlite", backend, options.keys);
+        }
+        {
+            ResetInstance("perf_gate_property");
+            KvsPropertyBackend backend("perf_gate_property", KvsBackendType::kvsFile);
+            RunBackendRound(metrics, "property", backend, options.keys);
+            backend.RemoveAllKeys();
+        }
+    }
+
+    ResetInstance("perf_gate_file");
+    ResetInstance("perf_gate_sqlite");
+    ResetInstance("perf_gate_property");
+}
+
+// ============================================================================
+// Baseline Comparison
+// ============================================================================
+
+static bool LoadJson(const ::std::string& path, nlohmann::json& out) {
+    ::std::ifstream in(path);
+    if (!in) return false;
+    out = nlohmann::json::parse(in, nullptr, false);
+    return !out.is_discarded() && out.is_object();
+}
+
+static bool WriteJson(const ::std::string& path, const nlohmann::json& json) {
+    ::std::ofstream out(path, ::std::ios::trunc);
+    if (!out) return false;
+    out << json.dump(4) << ::std::endl;
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Compare measured medians with the baseline and build the diff report
+ * @return true if no metric regressed and no baseline metric is missing
+ */
+static bool Compare(const MetricMap& metrics, const nlohmann::json& baseline, nlohmann::json& report) {
+    const double defaultTolerance = baseline.value("defaultTolerance", DEFAULT_TOLERANCE);
+    const double defaultSlack = baseline.value("defaultAbsoluteSlack", DEFAULT_ABSOLUTE_SLACK);
+    const nlohmann::json emptyMetrics = nlohmann::json::object();
+    const nlohmann::json& expected = baseline.contains("metrics") ? baseline["metrics"] : emptyMetrics;
+
+    bool passed = true;
+    report["metrics"] = nlohmann::json::array();
+
+    ::std::cout << "\n" << ::std::left << ::std::setw(18) << "metric"
+                << ::std::right << ::std::setw(12) << "baseline"
+                << ::std::setw(12) << "measured"
+                << ::std::setw(12) << "limit"
+                << ::std::setw(10) << "delta"
+                << "  status" << ::std::endl;
+
+    for (const auto& entry : metrics) {
+        const double measured = entry.second.Median();
+        nlohmann::json row;
+        row["name"] = entry.first;
+        row["unit"] = entry.second.unit;
+        row["measured"] = measured;
+        row["samples"] = entry.second.samples;
+
+        ::std::string status = "new";
+        double base = 0.0;
+        double limit = 0.0;
+        double delta = 0.0;
+
+        if (expected.contains(entry.first)) {
+            const auto& spec = expected[entry.first];
+            base = spec.value("baseline", 0.0);
+            limit = base * (1.0 + spec.value("tolerance", defaultTolerance))
+                  + spec.value("absoluteSlack", defaultSlack);
+            delta = (base > 0.0) ? (measured - base) / base * 100.0 : 0.0;
+            status = (measured > limit) ? "regression" : "ok";
+            row["baseline"] = base;
+            row["limit"] = limit;
+            row["deltaPercent"] = delta;
+            if (measured > limit) passed = false;
+        }
+        row["status"] = status;
+        report["metrics"].push_back(row);
+
+        ::std::cout << ::std::left << ::std::setw(18) << entry.first
+                    << ::std::right << ::std::fixed << ::std::setprecision(3)
+                    << ::std::setw(12) << base
+                    << ::std::setw(12) << measured
+                    << ::std::setw(12) << limit
+                    << ::std::setprecision(1) << ::std::setw(9) << delta << "%"
+                    << "  " << status << ::std::endl;
+    }
+
+    for (auto it = expected.begin(); it != expected.end(); ++it) {
+        if (metrics.find(it.key()) == metrics.end()) {
+            nlohmann::json row;
+            row["name"] = it.key();
+            row["status"] = "missing";
+            report["metrics"].push_back(row);
+            ::std::cout << ::std::left << ::std::setw(18) << it.key() << "  missing" << ::std::endl;
+            passed = false;
+        }
+    }
+
+    report["status"] = passed ? "pass" : "fail";
+    return passed;
+}
+
+static void UpdateBaseline(const MetricMap& metrics, nlohmann::json& baseline) {
+    if (!baseline.is_object()) baseline = nlohmann::json::object();
+    if (!baseline.contains("defaultTolerance")) baseline["defaultTolerance"] = DEFAULT_TOLERANCE;
+    if (!baseline.contains("defaultAbsoluteSlack")) baseline["defaultAbsoluteSlack"] = DEFAULT_ABSOLUTE_SLACK;
+
+    auto& expected = baseline["metrics"];
+    for (const auto& entry : metrics) {
+        auto& spec = expected[entry.first];
+        spec["unit"] = entry.second.unit;
+        spec["baseline"] = entry.second.Median();
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static bool ParseArguments(int argc, char* argv[], GateOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1 < argc);
+        if (::std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (::std::strcmp(argv[i], "--report") == 0 && hasValue) {
+            options.reportPath = argv[++i];
+        } else if (::std::strcmp(argv[i], "--keys") == 0 && hasValue) {
+            options.keys = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (::std::strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            options.rounds = ::std::max(1, ::std::atoi(argv[++i]));
+        } else if (::std::strcmp(argv[i], "--update-baseline") == 0) {
+            options.updateBaseline = true;
+        } else {
+            return false;
+        }
+    }
+    return !options.baselinePath.empty();
+}
+
+int main(int argc, char* argv[]) {
+    GateOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        ::std::cerr << "Usage: " << argv[0]
+                    << " --baseline <file> [--report <file>] [--keys N] [--rounds N] [--update-baseline]"
+                    << ::std::endl;
+        return 2;
+    }
+
+    try {
+        ::std::cout << "========================================" << ::std::endl;
+        ::std::cout << "  Persistency Performance Regression Gate" << ::std::endl;
+        ::std::cout << "  keys=" << options.keys << " rounds=" << options.rounds << ::std::endl;
+        ::std::cout << "========================================" << ::std::endl;
+
+        MetricMap metrics;
+        RunSubset(metrics, options);
+
+        nlohmann::json baseline;
+        const bool haveBaseline = LoadJson(options.baselinePath, baseline);
+
+        if (options.updateBaseline) {
+            UpdateBaseline(metrics, baseline);
+            if (!WriteJson(options.baselinePath, baseline)) {
+                ::std::cerr << "Failed to write baseline: " << options.baselinePath << ::std::endl;
+                return 1;
+            }
+            ::std::cout << "Baseline updated: " << options.baselinePath << ::std::endl;
+            return 0;
+        }
+
+        if (!haveBaseline) {
+            ::std::cerr << "Failed to load baseline: " << options.baselinePath << ::std::endl;
+            return 1;
+        }
+
+        nlohmann::json report;
+        report["baseline"] = options.baselinePath;
+        report["keys"] = options.keys;
+        report["rounds"] = options.rounds;
+
+        const bool passed = Compare(metrics, baseline, report);
+
+        if (!WriteJson(options.reportPath, report)) {
+            ::std::cerr << "Failed to write report: " << options.reportPath << ::std::endl;
+        } else {
+            ::std::cout << "\nDiff report: " << options.reportPath << ::std::endl;
+        }
+
+        ::std::cout << (passed ? "PERF GATE PASSED" : "PERF GATE FAILED: regression detected") << ::std::endl;
+        return passed ? 0 : 1;
+
+    } catch (const ::std::exception& e) {
+        ::std::cerr << "\nPerf gate failed with exception: " << e.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -7,12 +7,24 @@
 #include "CKvsFileBackend.hpp"
 #include "CKvsSqliteBackend.hpp"
 #include "CKvsPropertyBackend.hpp"
+#include "CKvsLsmBackend.hpp"
+#include "CKvsMmapBackend.hpp"
+#include "CKvsKey.hpp"
+#include "CPersistency.hpp"
+#include "CStoragePathManager.hpp"
 
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <vector>
 #include <numeric>
+#include <thread>
+#include <memory_resource>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <sqlite3.h>
 
 using namespace lap::per;
 using namespace lap::per::util;
@@ -233,6 +245,613 @@ void BenchmarkPropertyWithSqlite() {
                 << timer.GetMilliseconds() << " ms" << ::std::endl;
 }
 
+void BenchmarkTypedKeys() {
+    ::std::cout << "\n=== Property Backend: String Keys vs Typed Keys vs Key Handles ===" 
+                << ::std::endl;
+    
+    KvsPropertyBackend backend("benchmark_typed_keys", KvsBackendType::kvsNone);
+    BenchmarkTimer timer;
+    
+    // Control-loop style: a fixed set of signals read every cycle
+    const int keyCount = 200;
+    const int cycles = 500;
+    ::std::vector<::std::string> names;
+    ::std::vector<KvsKey<Float>> keys;
+    for (int i = 0; i < keyCount; ++i) {
+        names.push_back("signal." + ::std::to_string(i));
+    }
+    for (const auto& name : names) {
+        keys.emplace_back(StringView(name.data(), name.size()));
+        backend.SetValue(keys.back().Name(), Float(1.0f));
+    }
+    
+    timer.Start();
+    for (int c = 0; c < cycles; ++c) {
+        for (const auto& name : names) {
+            auto result = backend.GetValue(name);
+        }
+    }
+    timer.Stop();
+    double stringTime = timer.GetMilliseconds();
+    
+    timer.Start();
+    for (int c = 0; c < cycles; ++c) {
+        for (const auto& key : keys) {
+            auto result = backend.GetValueHashed(key.Name(), key.Hash());
+        }
+    }
+    timer.Stop();
+    double typedTime = timer.GetMilliseconds();
+    
+    ::std::vector<KvsKeyHandle> handles;
+    for (const auto& name : names) {
+        handles.emplace_back(StringView(name.data(), name.size()));
+        backend.ResolveKey(handles.back());
+    }
+    timer.Start();
+    for (int c = 0; c < cycles; ++c) {
+        for (const auto& handle : handles) {
+            auto result = backend.GetValueResolved(handle);
+        }
+    }
+    timer.Stop();
+    double handleTime = timer.GetMilliseconds();
+    
+    ::std::cout << "Read " << keyCount << " keys x " << cycles << " cycles (string): " 
+                << ::std::fixed << ::std::setprecision(2) 
+                << stringTime << " ms" << ::std::endl;
+    ::std::cout << "Read " << keyCount << " keys x " << cycles << " cycles (typed):  " 
+                << typedTime << " ms" << ::std::endl;
+    ::std::cout << "Read " << keyCount << " keys x " << cycles << " cycles (handle): " 
+                << handleTime << " ms" << ::std::endl;
+    
+    backend.RemoveAllKeys();
+}
+
+// Runtime choice as in KeyValueStorage's constructor, so calls stay virtual
+UniqueHandle<IKvsBackend> MakeRuntimeBackend(const char* name, bool shared) {
+    if (shared) {
+        return ::std::make_unique<KvsPropertyBackend>(name, KvsBackendType::kvsNone);
+    }
+    return ::std::make_unique<KvsMemoryBackend>();
+}
+
+void BenchmarkStaticDispatch() {
+    ::std::cout << "\n=== Runtime Dispatch vs BasicKeyValueStorage ===" 
+                << ::std::endl;
+    
+    const int keyCount = 200;
+    const int cycles = 500;
+    ::std::vector<::std::string> names;
+    for (int i = 0; i < keyCount; ++i) {
+        names.push_back("signal." + ::std::to_string(i));
+    }
+    
+    // Set and read back every signal per cycle; the sum keeps the reads from being optimized away
+    auto timed = [&](auto&& setValue, auto&& getValue) {
+        BenchmarkTimer timer;
+        Float sum = 0.0f;
+        timer.Start();
+        for (int c = 0; c < cycles; ++c) {
+            for (const auto& name : names) {
+                setValue(name, Float(c));
+                sum += getValue(name);
+            }
+        }
+        timer.Stop();
+        if (sum < 0.0f) ::std::cout << sum;
+        return timer.GetMilliseconds() * 1e6 / (2.0 * keyCount * cycles);
+    };
+    
+    // What KeyValueStorage does per call: availability check, then a virtual call
+    auto runtime = [&](bool shared) {
+        auto backend = MakeRuntimeBackend("benchmark_dispatch_runtime", shared);
+        double ns = timed(
+            [&](const ::std::string& name, Float value) {
+                if (backend && backend->available()) backend->SetValue(name, KvsDataType(value));
+            },
+            [&](const ::std::string& name) {
+                if (!backend || !backend->available()) return 0.0f;
+                auto result = backend->GetValue(name);
+                return result.HasValue() ? ::std::get<Float>(result.Value()) : 0.0f;
+            });
+        backend->RemoveAllKeys();
+        return ns;
+    };
+    
+    auto facade = [&](auto& kvs) {
+        double ns = timed(
+            [&](const ::std::string& name, Float value) { kvs.SetValue(name, value); },
+            [&](const ::std::string& name) {
+                auto result = kvs.template GetValue<Float>(name);
+                return result.HasValue() ? result.Value() : 0.0f;
+            });
+        kvs.RemoveAllKeys();
+        return ns;
+    };
+    
+    double propertyRuntime = runtime(true);
+    BasicKeyValueStorage<KvsPropertyBackend> property("benchmark_dispatch_static", KvsBackendType::kvsNone);
+    double propertyStatic = facade(property);
+    
+    double memoryRuntime = runtime(false);
+    BasicKeyValueStorage<KvsMemoryBackend> memory;
+    double memoryStatic = facade(memory);
+    
+    ::std::cout << ::std::fixed << ::std::setprecision(1)
+                << "Property (kvsNone) runtime: " << propertyRuntime << " ns/op, static: " << propertyStatic << " ns/op" << ::std::endl
+                << "Memory             runtime: " << memoryRuntime << " ns/op, static: " << memoryStatic << " ns/op" << ::std::endl;
+}
+
+// Heap resource counting the JSON node allocations the pool takes over
+class CountingHeapResource final : public ::std::pmr::memory_resource {
+public:
+    UInt64 allocations{0};
+
+private:
+    void* do_allocate(::std::size_t bytes, ::std::size_t alignment) override {
+        ++allocations;
+        return ::std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, ::std::size_t bytes, ::std::size_t alignment) override {
+        ::std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const ::std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+void BenchmarkMemoryPool() {
+    ::std::cout << "\n=== File Backend: Global Heap vs Per-Storage Memory Pool ===" 
+                << ::std::endl;
+    
+    const int keyCount = 500;
+    const int cycles = 200;
+    ::std::vector<::std::string> names;
+    for (int i = 0; i < keyCount; ++i) {
+        names.push_back("pool." + ::std::to_string(i));
+    }
+    
+    // Insert and remove every key per cycle, so each cycle allocates and frees the nodes again
+    auto run = [&](const char* label, ::std::pmr::memory_resource* resource) {
+        BenchmarkTimer timer;
+        KvsFileBackend backend("benchmark_memory_pool", nullptr, resource);
+        backend.RemoveAllKeys();
+        
+        double best = 0.0;
+        for (int round = 0; round < 3; ++round) {
+            timer.Start();
+            for (int c = 0; c < cycles; ++c) {
+                for (const auto& name : names) {
+                    backend.SetValue(name, KvsDataType(Int32(c)));
+                }
+                for (const auto& name : names) {
+                    backend.RemoveKey(name);
+                }
+            }
+            timer.Stop();
+            best = (round == 0) ? timer.GetMilliseconds() : ::std::min(best, timer.GetMilliseconds());
+        }
+        backend.SyncToStorage();
+        
+        const double ops = 2.0 * keyCount * cycles;
+        ::std::cout << label << ::std::fixed << ::std::setprecision(1)
+                    << (best * 1e6 / ops) << " ns/op (best of 3)" << ::std::endl;
+    };
+    
+    CountingHeapResource heap;
+    run("Global heap          : ", &heap);
+    
+    KvsMemoryResource unbounded;
+    run("Pool over heap       : ", &unbounded);
+    
+    KvsMemoryResource bounded(1u << 20);
+    run("Pool in 1 MiB arena  : ", &bounded);
+    
+    auto stats = bounded.GetStatistics();
+    ::std::cout << "Heap allocations for JSON nodes: " << heap.allocations 
+                << " (pool in arena: none after construction)" << ::std::endl;
+    ::std::cout << "Arena: " << stats.allocations << " allocations served, peak "
+                << (stats.peakBytes / 1024) << " KiB of " << (stats.capacity / 1024) 
+                << " KiB, " << stats.failedAllocations << " refused" << ::std::endl;
+}
+
+void BenchmarkInterning() {
+    ::std::cout << "\n=== Property Backend: Interned Key Prefixes and Values ===" 
+                << ::std::endl;
+    
+    const int keyCount = 2000;
+    const char* modes[] = {"DRIVE_MODE_COMFORT_WITH_ADAPTIVE_DAMPING", "DRIVE_MODE_SPORT_WITH_ADAPTIVE_DAMPING",
+                           "DRIVE_MODE_ECO_WITH_REGENERATIVE_BRAKING", "DRIVE_MODE_OFFROAD_WITH_HILL_DESCENT"};
+    ::std::vector<::std::string> names;
+    size_t textBytes = 0;
+    for (int i = 0; i < keyCount; ++i) {
+        names.push_back("vehicle.chassis.damper.channel." + ::std::to_string(i));
+        textBytes += names.back().size() + ::std::strlen(modes[i % 4]);
+    }
+    
+    KvsPropertyBackend backend("benchmark_interning", KvsBackendType::kvsNone, 4u << 20);
+    backend.RemoveAllKeys();
+    const size_t emptyBytes = backend.GetInternStatistics().Value().segmentBytesUsed;
+    for (int i = 0; i < keyCount; ++i) {
+        backend.SetValue(names[i], KvsDataType(String(modes[i % 4])));
+    }
+    auto stats = backend.GetInternStatistics().Value();
+    
+    BenchmarkTimer timer;
+    KvsDataType out = String();
+    timer.Start();
+    for (int round = 0; round < 50; ++round) {
+        for (const auto& name : names) {
+            backend.GetValueAssign(name, out);
+        }
+    }
+    timer.Stop();
+    
+    ::std::cout << "Keys                 : " << keyCount << " (key + value text "
+                << (textBytes / keyCount) << " bytes/key)" << ::std::endl;
+    ::std::cout << "Segment bytes per key: " << ((stats.segmentBytesUsed - emptyBytes) / keyCount) << ::std::endl;
+    ::std::cout << "Interned strings     : " << stats.strings << ", " << stats.references << " references" << ::std::endl;
+    ::std::cout << "GetValueAssign       : " << ::std::fixed << ::std::setprecision(1)
+                << (timer.GetMilliseconds() * 1e6 / (50.0 * keyCount)) << " ns/op" << ::std::endl;
+    backend.RemoveAllKeys();
+}
+
+void BenchmarkMemoryBudget() {
+    ::std::cout << "\n=== Property Backend: Memory Budget with SQLite Cold Tier ===" 
+                << ::std::endl;
+    
+    const int keyCount = 2000;
+    const int reads = 100000;
+    PersistencyConfig config;
+    config.kvs.propertyBackendPersistence = "sqlite";
+    config.kvs.propertyBackendMemoryBudget = 512 * 1024;  // Keys alone take about half
+    
+    KvsPropertyBackend backend("benchmark_budget", KvsBackendType::kvsSqlite, 4u << 20, &config);
+    backend.RemoveAllKeys();
+    ::std::vector<::std::string> names;
+    for (int i = 0; i < keyCount; ++i) {
+        names.push_back("budget.sensor." + ::std::to_string(i));
+        backend.SetValue(names.back(), KvsDataType(String(400, static_cast<char>('a' + i % 26)) + ::std::to_string(i)));
+    }
+    backend.SyncToStorage();
+    
+    // 90% of reads go to the hottest 10% of keys
+    ::std::vector<int> pattern(reads);
+    unsigned seed = 12345;
+    for (auto& index : pattern) {
+        seed = seed * 1103515245u + 12345u;
+        index = ((seed >> 8) % 10 < 9) ? static_cast<int>((seed >> 12) % (keyCount / 10))
+                                        : static_cast<int>((seed >> 12) % keyCount);
+    }
+    
+    auto before = backend.GetEvictionStatistics().Value();
+    BenchmarkTimer timer;
+    KvsDataType out = String();
+    timer.Start();
+    for (int index : pattern) {
+        backend.GetValueAssign(names[index], out);
+    }
+    timer.Stop();
+    auto after = backend.GetEvictionStatistics().Value();
+    
+    const auto hits = after.hits - before.hits;
+    const auto misses = after.misses - before.misses;
+    ::std::cout << "Data set             : " << (keyCount * 400 / 1024) << " KiB of values, budget "
+                << (after.budget / 1024) << " KiB, segment in use " << (after.segmentBytesUsed / 1024) << " KiB" << ::std::endl;
+    ::std::cout << "Hit rate (90/10 skew): " << ::std::fixed << ::std::setprecision(1)
+                << (100.0 * hits / (hits + misses)) << "% (" << misses << " faults)" << ::std::endl;
+    ::std::cout << "GetValueAssign       : " << (timer.GetMilliseconds() * 1e6 / reads) << " ns/op" << ::std::endl;
+    backend.RemoveAllKeys();
+    backend.SyncToStorage();
+}
+
+void BenchmarkGroupCommit() {
+    ::std::cout << "\n=== File Backend: Concurrent SyncToStorage with Group Commit ===" 
+                << ::std::endl;
+    
+    const int threads = 8;
+    const int syncsPerThread = 25;
+    
+    // Each thread writes its own key and syncs, as a burst of writers would
+    auto run = [&](const char* label, auto&& sync, auto&& set, auto&& physical) {
+        const auto before = physical();
+        BenchmarkTimer timer;
+        timer.Start();
+        ::std::vector<::std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (int i = 0; i < syncsPerThread; ++i) {
+                    set("group." + ::std::to_string(t), Int32(i));
+                    sync();
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        timer.Stop();
+        
+        const double requests = static_cast<double>(threads) * syncsPerThread;
+        ::std::cout << label << ::std::fixed << ::std::setprecision(1)
+                    << (timer.GetMilliseconds() * 1000.0 / requests) << " us/sync, "
+                    << (physical() - before) << " physical syncs for " << (threads * syncsPerThread) << " requests" << ::std::endl;
+    };
+    
+    KvsFileBackend direct("benchmark_group_commit");
+    ::std::atomic<UInt64> directSyncs{0};
+    run("Per-call sync        : ", [&]() { direct.SyncToStorage(); ++directSyncs; },
+        [&](const ::std::string& key, Int32 value) { direct.SetValue(key, KvsDataType(value)); },
+        [&]() { return directSyncs.load(); });
+    
+    auto kvs = OpenKeyValueStorage(InstanceSpecifier("benchmark_group_commit"), true, KvsBackendType::kvsFile).Value();
+    for (UInt32 window : {0u, 500u}) {
+        kvs->SetGroupCommitWindow(window);
+        const ::std::string label = "Group commit, " + ::std::to_string(window) + " us: ";
+        run(label.c_str(), [&]() { kvs->SyncToStorage(); },
+            [&](const ::std::string& key, Int32 value) { kvs->SetValue(key, value); },
+            [&]() { return kvs->GetGroupCommitStatistics().Value().physicalSyncs; });
+    }
+}
+
+void BenchmarkIncrementalSync() {
+    ::std::cout << "\n=== File Backend: Full vs. Time-Budgeted SyncToStorage (20,000 keys) ===" 
+                << ::std::endl;
+    
+    KvsFileBackend backend("benchmark_incremental_sync");
+    auto fill = [&](int round) {
+        for (int i = 0; i < 20000; ++i) {
+            backend.SetValue("sync.key" + ::std::to_string(i), KvsDataType(Int32(i + round)));
+        }
+    };
+    
+    BenchmarkTimer timer;
+    fill(0);
+    timer.Start();
+    backend.SyncToStorage();
+    timer.Stop();
+    ::std::cout << "Full sync            : " << ::std::fixed << ::std::setprecision(2)
+                << timer.GetMilliseconds() << " ms in one call" << ::std::endl;
+    
+    // A 10 ms control cycle granting the sync 1 ms per cycle
+    fill(1);
+    KvsSyncBudget budget;
+    budget.microseconds = 1000;
+    double longest = 0.0;
+    double total = 0.0;
+    int calls = 0;
+    for (bool complete = false; !complete; ++calls) {
+        timer.Start();
+        KvsSyncMeter meter(budget);
+        auto progress = backend.SyncToStorage(meter);
+        timer.Stop();
+        complete = !progress.HasValue() || progress.Value().complete;
+        longest = ::std::max(longest, timer.GetMilliseconds());
+        total += timer.GetMilliseconds();
+    }
+    ::std::cout << "1 ms budget per call : " << calls << " calls, " << total << " ms total, longest call "
+                << longest << " ms" << ::std::endl;
+}
+
+void BenchmarkBulkTransfer() {
+    ::std::cout << "\n=== File -> SQLite: Per-Key Copy vs. Bulk Export/Import (100,000 keys) ===" 
+                << ::std::endl;
+    
+    const int keys = 100000;
+    KvsFileBackend source("benchmark_bulk_source");
+    source.RemoveAllKeys();
+    for (int i = 0; i < keys; ++i) {
+        source.SetValue("bulk.key" + ::std::to_string(i), KvsDataType(String("value_" + ::std::to_string(i))));
+    }
+    
+    auto report = [&](const char* label, const BenchmarkTimer& timer) {
+        ::std::cout << label << ::std::fixed << ::std::setprecision(2) << timer.GetMilliseconds() << " ms, "
+                    << ::std::setprecision(0) << (keys * 1000.0 / timer.GetMilliseconds()) << " records/s" << ::std::endl;
+    };
+    
+    BenchmarkTimer timer;
+    {
+        KvsSqliteBackend target("benchmark_bulk_target");
+        target.RemoveAllKeys();
+        target.SyncToStorage();
+        timer.Start();
+        auto all = source.GetAllKeys();
+        for (const auto& key : all.Value()) {
+            target.SetValue(key, source.GetValue(key).Value());
+        }
+        target.SyncToStorage();
+        timer.Stop();
+        report("Per-key copy         : ", timer);
+    }
+    {
+        KvsSqliteBackend target("benchmark_bulk_target");
+        KvsRecordBuffer buffer;
+        KvsImportOptions options;
+        options.clearFirst = true;
+        timer.Start();
+        source.Export(buffer);
+        target.Import(buffer, options);
+        target.SyncToStorage();
+        timer.Stop();
+        report("Bulk export/import   : ", timer);
+        ::std::cout << "Stream size          : " << (buffer.Data().size() / 1024) << " KB" << ::std::endl;
+        target.RemoveAllKeys();
+        target.SyncToStorage();
+    }
+    source.RemoveAllKeys();
+    source.SyncToStorage();
+}
+
+void BenchmarkSharedDatabase() {
+    ::std::cout << "\n=== SQLite: 150 Small Instances, Dedicated Files vs. One Shared Database ===" 
+                << ::std::endl;
+    
+    const int instances = 150;
+    auto openFiles = []() {
+        return ::std::distance(::std::filesystem::directory_iterator("/proc/self/fd"),
+                               ::std::filesystem::directory_iterator());
+    };
+    
+    BenchmarkTimer timer;
+    for (bool shared : {false, true}) {
+        const ::std::int64_t baseMemory = sqlite3_memory_used();
+        const auto baseFiles = openFiles();
+        ::std::vector<::std::unique_ptr<KvsSqliteBackend>> backends;
+        
+        timer.Start();
+        for (int i = 0; i < instances; ++i) {
+            const ::std::string id = "benchmark_tenant_" + ::std::to_string(i);
+            backends.emplace_back(new KvsSqliteBackend(id, shared ? "benchmark_tenants" : ""));
+        }
+        timer.Stop();
+        const double openMs = timer.GetMilliseconds();
+        
+        timer.Start();
+        for (auto& backend : backends) {
+            for (int k = 0; k < 50; ++k) {
+                backend->SetValue("tenant.key" + ::std::to_string(k), KvsDataType(Int32(k)));
+            }
+            backend->SyncToStorage();
+        }
+        timer.Stop();
+        
+        ::std::cout << (shared ? "Shared database      : " : "Dedicated files      : ")
+                    << ::std::fixed << ::std::setprecision(2) << "open " << openMs << " ms, write+sync "
+                    << timer.GetMilliseconds() << " ms, SQLite heap "
+                    << ((sqlite3_memory_used() - baseMemory) / 1024) << " KB, descriptors "
+                    << (openFiles() - baseFiles) << ::std::endl;
+        for (auto& backend : backends) {
+            backend->RemoveAllKeys();
+            backend->SyncToStorage();
+        }
+    }
+}
+
+// Representative small-store workload: writes synced in batches, reads, updates
+static double RunSqliteWorkload(const KvsSqliteTuning& tuning, int keys, ::std::int64_t& peakHeap) {
+    static int run = 0;
+    const ::std::string id = "benchmark_sqlite_tune_" + ::std::to_string(run++);
+    ::std::filesystem::remove_all(CStoragePathManager::getKvsInstancePath(id).c_str());
+    
+    BenchmarkTimer timer;
+    const ::std::int64_t baseHeap = sqlite3_memory_used();
+    sqlite3_memory_highwater(1);
+    timer.Start();
+    {
+        KvsSqliteBackend backend(id, "", tuning);
+        for (int i = 0; i < keys; ++i) {
+            backend.SetValue("tune.key" + ::std::to_string(i), KvsDataType(String("value_" + ::std::to_string(i))));
+            if (i % 500 == 499) backend.SyncToStorage();
+        }
+        backend.SyncToStorage();
+        for (int pass = 0; pass < 4; ++pass) {
+            for (int i = 0; i < keys; ++i) {
+                backend.GetValue("tune.key" + ::std::to_string((i * 7919) % keys));
+            }
+        }
+        for (int i = 0; i < keys; i += 4) {
+            backend.SetValue("tune.key" + ::std::to_string(i), KvsDataType(Int32(i)));
+        }
+        backend.SyncToStorage();
+    }
+    timer.Stop();
+    peakHeap = sqlite3_memory_highwater(0) - baseHeap;
+    ::std::filesystem::remove_all(CStoragePathManager::getKvsInstancePath(id).c_str());
+    return timer.GetMilliseconds();
+}
+
+void BenchmarkSqliteTuning(int keys) {
+    ::std::cout << "\n=== SQLite PRAGMA Sweep (" << keys << " keys: batched writes + syncs, 4 read passes, updates) ===" 
+                << ::std::endl;
+    
+    struct Candidate {
+        const char* label;
+        ::std::function<void(KvsSqliteTuning&)> apply;
+    };
+    struct Dimension {
+        const char* name;
+        // In order of preference: less memory, more durability, snapshots kept working
+        ::std::vector<Candidate> candidates;
+        const char* caveat = nullptr;  // Measured only, the first candidate is kept
+    };
+    const ::std::vector<Dimension> dimensions = {
+        {"cacheSize", {{"-256", [](KvsSqliteTuning& t) { t.cacheSize = -256; }},
+                       {"-1000", [](KvsSqliteTuning& t) { t.cacheSize = -1000; }},
+                       {"-2000", [](KvsSqliteTuning& t) { t.cacheSize = -2000; }},
+                       {"-10000", [](KvsSqliteTuning& t) { t.cacheSize = -10000; }}}},
+        {"mmapSize", {{"0", [](KvsSqliteTuning& t) { t.mmapSize = 0; }},
+                      {"1048576", [](KvsSqliteTuning& t) { t.mmapSize = 1ul << 20; }},
+                      {"8388608", [](KvsSqliteTuning& t) { t.mmapSize = 8ul << 20; }},
+                      {"67108864", [](KvsSqliteTuning& t) { t.mmapSize = 64ul << 20; }}}},
+        {"pageSize", {{"4096", [](KvsSqliteTuning& t) { t.pageSize = 4096; }},
+                      {"1024", [](KvsSqliteTuning& t) { t.pageSize = 1024; }},
+                      {"8192", [](KvsSqliteTuning& t) { t.pageSize = 8192; }},
+                      {"16384", [](KvsSqliteTuning& t) { t.pageSize = 16384; }}}},
+        {"walAutocheckpoint", {{"1000", [](KvsSqliteTuning& t) { t.walAutocheckpoint = 1000; }},
+                               {"100", [](KvsSqliteTuning& t) { t.walAutocheckpoint = 100; }},
+                               {"10000", [](KvsSqliteTuning& t) { t.walAutocheckpoint = 10000; }}}},
+        {"tempStore", {{"DEFAULT", [](KvsSqliteTuning& t) { t.tempStore = "DEFAULT"; }},
+                       {"MEMORY", [](KvsSqliteTuning& t) { t.tempStore = "MEMORY"; }}}},
+        {"journalMode", {{"WAL", [](KvsSqliteTuning& t) { t.journalMode = "WAL"; }},
+                         {"TRUNCATE", [](KvsSqliteTuning& t) { t.journalMode = "TRUNCATE"; }},
+                         {"DELETE", [](KvsSqliteTuning& t) { t.journalMode = "DELETE"; }}}},
+        {"synchronous", {{"FULL", [](KvsSqliteTuning& t) { t.synchronous = "FULL"; }},
+                         {"NORMAL", [](KvsSqliteTuning& t) { t.synchronous = "NORMAL"; }}}},
+        {"exclusiveLocking", {{"false", [](KvsSqliteTuning& t) { t.exclusiveLocking = false; }},
+                              {"true", [](KvsSqliteTuning& t) { t.exclusiveLocking = true; }}},
+         "only for instances without snapshots or other processes"},
+    };
+    
+    // One setting at a time against the defaults, best of three runs (syncs make single runs noisy);
+    // the first preferred value within 15% of the fastest is recommended
+    const KvsSqliteTuning defaults;
+    KvsSqliteTuning recommended;
+    ::std::int64_t heap = 0;
+    for (const auto& dimension : dimensions) {
+        ::std::cout << dimension.name << ":" << ::std::endl;
+        ::std::vector<double> times;
+        for (const auto& candidate : dimension.candidates) {
+            KvsSqliteTuning tuning = defaults;
+            candidate.apply(tuning);
+            double ms = RunSqliteWorkload(tuning, keys, heap);
+            for (int again = 0; again < 2; ++again) {
+                ::std::int64_t heapAgain = 0;
+                ms = ::std::min(ms, RunSqliteWorkload(tuning, keys, heapAgain));
+                heap = ::std::max(heap, heapAgain);
+            }
+            times.push_back(ms);
+            ::std::cout << "  " << ::std::left << ::std::setw(10) << candidate.label << ::std::right << ::std::fixed
+                        << ::std::setprecision(2) << ::std::setw(10) << ms << " ms, peak SQLite heap "
+                        << (heap / 1024) << " KB" << ::std::endl;
+        }
+        if (dimension.caveat != nullptr) {
+            ::std::cout << "  -> " << dimension.candidates.front().label << " (other values " << dimension.caveat << ")"
+                        << ::std::endl;
+            continue;
+        }
+        const double best = *::std::min_element(times.begin(), times.end());
+        for (size_t i = 0; i < times.size(); ++i) {
+            if (times[i] <= best * 1.15) {
+                dimension.candidates[i].apply(recommended);
+                ::std::cout << "  -> " << dimension.candidates[i].label << ::std::endl;
+                break;
+            }
+        }
+    }
+    
+    ::std::int64_t recommendedHeap = 0;
+    const double defaultMs = RunSqliteWorkload(defaults, keys, heap);
+    const double recommendedMs = RunSqliteWorkload(recommended, keys, recommendedHeap);
+    ::std::cout << "\nDefaults             : " << defaultMs << " ms, peak SQLite heap " << (heap / 1024) << " KB, mmap "
+                << (defaults.mmapSize >> 10) << " KB" << ::std::endl;
+    ::std::cout << "Recommended          : " << recommendedMs << " ms, peak SQLite heap " << (recommendedHeap / 1024)
+                << " KB, mmap " << (recommended.mmapSize >> 10) << " KB" << ::std::endl;
+    ::std::cout << "\"kvs\": { \"sqlite\": { \"journalMode\": \"" << recommended.journalMode
+                << "\", \"synchronous\": \"" << recommended.synchronous
+                << "\", \"cacheSize\": " << recommended.cacheSize
+                << ", \"mmapSize\": " << recommended.mmapSize
+                << ", \"pageSize\": " << recommended.pageSize
+                << ", \"walAutocheckpoint\": " << recommended.walAutocheckpoint
+                << ", \"tempStore\": \"" << recommended.tempStore
+                << "\", \"exclusiveLocking\": " << (recommended.exclusiveLocking ? "true" : "false") << " } }" << ::std::endl;
+}
+
 // ============================================================================
 // Stress Tests
 // ============================================================================
@@ -434,6 +1053,118 @@ void StressTest_RapidUpdates() {
     }
 }
 
+// Write-heavy workload: small batches of updates, each made durable with SyncToStorage()
+template <typename Backend>
+double RunWriteHeavySync(Backend& backend, int batches, int batchSize, int keySpace) {
+    BenchmarkTimer timer;
+    timer.Start();
+    for (int b = 0; b < batches; ++b) {
+        for (int i = 0; i < batchSize; ++i) {
+            ::std::string key = "sensor_" + ::std::to_string((b * batchSize + i * 7919) % keySpace);
+            backend.SetValue(key, KvsDataType(Int64(b * batchSize + i)));
+        }
+        backend.SyncToStorage();
+    }
+    timer.Stop();
+    return timer.GetMilliseconds();
+}
+
+void StressTest_WriteHeavySync() {
+    ::std::cout << "\n=== Stress Test: Write-Heavy Sync (File vs SQLite vs LSM) ===" 
+                << ::std::endl;
+    
+    const int batches = 200;
+    const int batchSize = 50;
+    const int keySpace = 5000;
+    auto report = [&](const char* name, double ms) {
+        ::std::cout << name << " - " << batches << " syncs x " << batchSize << " writes: " 
+                    << ::std::fixed << ::std::setprecision(2) << ms << " ms ("
+                    << (batches * 1000.0 / ms) << " syncs/s)" << ::std::endl;
+    };
+    
+    {
+        KvsFileBackend backend("stress_write_heavy_file");
+        backend.RemoveAllKeys();
+        report("File Backend  ", RunWriteHeavySync(backend, batches, batchSize, keySpace));
+    }
+    {
+        KvsSqliteBackend backend("stress_write_heavy_sqlite");
+        backend.RemoveAllKeys();
+        report("SQLite Backend", RunWriteHeavySync(backend, batches, batchSize, keySpace));
+    }
+    {
+        KvsLsmOptions options;
+        options.memtableBytes = 64ul << 10;     // Small memtable so the run exercises flush and compaction
+        options.level1Bytes = 256ul << 10;
+        KvsLsmBackend backend("stress_write_heavy_lsm", nullptr, options);
+        backend.RemoveAllKeys();
+        report("LSM Backend   ", RunWriteHeavySync(backend, batches, batchSize, keySpace));
+        backend.WaitForBackgroundWork();
+        
+        auto stats = backend.GetStats();
+        ::std::cout << "  LSM write amplification: " << stats.WriteAmplification()
+                    << " (" << stats.flushes << " flushes, " << stats.compactions 
+                    << " compactions, " << stats.stalls << " stalls)" << ::std::endl;
+    }
+}
+
+// Read-mostly workload: reader threads look up random committed keys while one writer syncs a few updates
+template <typename Backend>
+double RunReadMostly(Backend& backend, int readers, int readsPerThread, int keySpace) {
+    for (int i = 0; i < keySpace; ++i) {
+        backend.SetValue("config_" + ::std::to_string(i), KvsDataType(Int64(i)));
+    }
+    backend.SyncToStorage();
+
+    BenchmarkTimer timer;
+    timer.Start();
+    ::std::vector<::std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+        threads.emplace_back([&backend, t, readsPerThread, keySpace]() {
+            for (int i = 0; i < readsPerThread; ++i) {
+                backend.GetValue("config_" + ::std::to_string((i * 7919 + t * 104729) % keySpace));
+            }
+        });
+    }
+    for (int b = 0; b < 20; ++b) {
+        backend.SetValue("config_" + ::std::to_string(b), KvsDataType(Int64(-b)));
+        backend.SyncToStorage();
+    }
+    for (auto& thread : threads) thread.join();
+    timer.Stop();
+    return timer.GetMilliseconds();
+}
+
+void StressTest_ReadMostly() {
+    ::std::cout << "\n=== Stress Test: Read-Mostly (File vs SQLite vs Mmap) ===" 
+                << ::std::endl;
+    
+    const int readers = 4;
+    const int readsPerThread = 50000;
+    const int keySpace = 10000;
+    auto report = [&](const char* name, double ms) {
+        ::std::cout << name << " - " << readers << " readers x " << readsPerThread << " reads: " 
+                    << ::std::fixed << ::std::setprecision(2) << ms << " ms ("
+                    << (readers * readsPerThread / ms) << " reads/ms)" << ::std::endl;
+    };
+    
+    {
+        KvsFileBackend backend("stress_read_mostly_file");
+        backend.RemoveAllKeys();
+        report("File Backend  ", RunReadMostly(backend, readers, readsPerThread, keySpace));
+    }
+    {
+        KvsSqliteBackend backend("stress_read_mostly_sqlite");
+        backend.RemoveAllKeys();
+        report("SQLite Backend", RunReadMostly(backend, readers, readsPerThread, keySpace));
+    }
+    {
+        KvsMmapBackend backend("stress_read_mostly_mmap");
+        backend.RemoveAllKeys();
+        report("Mmap Backend  ", RunReadMostly(backend, readers, readsPerThread, keySpace));
+    }
+}
+
 void StressTest_MemoryPressure() {
     ::std::cout << "\n=== Stress Test: Memory Pressure ===" 
                 << ::std::endl;
@@ -610,7 +1341,13 @@ void PrintComparisonSummary() {
 // Main
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
+    // performance_benchmark --sqlite-tune [keys]: only the PRAGMA sweep, sized like the store to tune
+    if (argc > 1 && ::std::strcmp(argv[1], "--sqlite-tune") == 0) {
+        BenchmarkSqliteTuning(argc > 2 ? ::std::max(1, ::std::atoi(argv[2])) : 5000);
+        return 0;
+    }
+    
     ::std::cout << "============================================================" 
                 << ::std::endl;
     ::std::cout << "Persistency Module - Performance Benchmark Suite" 
@@ -626,6 +1363,15 @@ int main() {
         BenchmarkSqliteBackend();
         BenchmarkPropertyBackend();
         BenchmarkPropertyWithSqlite();
+        BenchmarkTypedKeys();
+        BenchmarkStaticDispatch();
+        BenchmarkMemoryPool();
+        BenchmarkInterning();
+        BenchmarkMemoryBudget();
+        BenchmarkGroupCommit();
+        BenchmarkIncrementalSync();
+        BenchmarkBulkTransfer();
+        BenchmarkSharedDatabase();
         PrintComparisonSummary();
 
         // Stress Tests
@@ -634,6 +1380,8 @@ int main() {
         StressTest_LargeValues();
         StressTest_MixedOperations();
         StressTest_RapidUpdates();
+        StressTest_WriteHeavySync();
+        StressTest_ReadMostly();
         StressTest_MemoryPressure();
         StressTest_PersistenceReload();
         PrintStressSummary();
@@ -265,3 +265,66 @@ TEST_F(DataTypeTest, RoundTrip_Float) {
     
     EXPECT_NEAR(original, result, 0.0001f);
 }
+
+TEST_F(DataTypeTest, RoundTrip_Blob) {
+    // Cover all three padding cases and bytes that are not valid text
+    for (Size length : {0u, 1u, 2u, 3u, 4u, 257u}) {
+        KvsBlob original;
+        for (Size i = 0; i < length; ++i) {
+            original.push_back(static_cast<Byte>((i * 37) & 0xFF));
+        }
+        KvsDataType kvs = original;
+        String str = kvsToStrig(kvs);
+        EXPECT_EQ(str.size(), ((length + 2) / 3) * 4);
+
+        KvsDataType converted = kvsFromString(str, EKvsDataTypeIndicate::DataType_blob);
+        EXPECT_EQ(lap::core::get<KvsBlob>(converted), original);
+    }
+}
+
+TEST_F(DataTypeTest, Base64_KnownVectorsAndInvalidInput) {
+    const char* text = "foobar";
+    EXPECT_EQ(kvsBlobToBase64(reinterpret_cast<const Byte*>(text), 6), "Zm9vYmFy");
+    EXPECT_EQ(kvsBlobToBase64(reinterpret_cast<const Byte*>(text), 4), "Zm9vYg==");
+
+    KvsBlob blob;
+    EXPECT_TRUE(kvsBlobFromBase64("Zm9vYg==", blob));
+    EXPECT_EQ(String(reinterpret_cast<const char*>(blob.data()), blob.size()), "foob");
+    EXPECT_FALSE(kvsBlobFromBase64("Zm9", blob));
+    EXPECT_FALSE(kvsBlobFromBase64("Zm9*", blob));
+}
+
+TEST_F(DataTypeTest, RoundTrip_NumericArrays) {
+    KvsDataType floats = KvsFloatArray{0.1f, -2.5f, 1e-30f};
+    EXPECT_EQ(lap::core::get<KvsFloatArray>(kvsFromString(kvsToStrig(floats), EKvsDataTypeIndicate::DataType_float_array)),
+              lap::core::get<KvsFloatArray>(floats));
+
+    KvsDataType int8s = KvsInt8Array{-128, 0, 127};
+    EXPECT_EQ(kvsToStrig(int8s), "[-128,0,127]");
+    EXPECT_EQ(lap::core::get<KvsInt8Array>(kvsFromString("[-128,0,127]", EKvsDataTypeIndicate::DataType_int8_array)),
+              lap::core::get<KvsInt8Array>(int8s));
+
+    KvsDataType empty = KvsUInt64Array{};
+    EXPECT_EQ(kvsToStrig(empty), "[]");
+    EXPECT_TRUE(lap::core::get<KvsUInt64Array>(kvsFromString("[]", EKvsDataTypeIndicate::DataType_uint64_array)).empty());
+}
+
+TEST_F(DataTypeTest, RawBytes_ArraysAreContiguous) {
+    KvsDataType table = KvsInt16Array{1, -1, 300};
+    const Byte* data = nullptr;
+    Size size = 0;
+    ASSERT_TRUE(kvsRawBytes(table, data, size));
+    EXPECT_EQ(size, 3 * sizeof(Int16));
+    EXPECT_EQ(kvsRawElementSize(EKvsDataTypeIndicate::DataType_int16_array), sizeof(Int16));
+
+    KvsDataType rebuilt;
+    ASSERT_TRUE(kvsFromRawBytes(EKvsDataTypeIndicate::DataType_int16_array, data, size, rebuilt));
+    EXPECT_EQ(lap::core::get<KvsInt16Array>(rebuilt), lap::core::get<KvsInt16Array>(table));
+
+    // Truncated payloads and scalar types are rejected
+    EXPECT_FALSE(kvsFromRawBytes(EKvsDataTypeIndicate::DataType_int16_array, data, size - 1, rebuilt));
+    EXPECT_FALSE(kvsRawBytes(KvsDataType{Int32(5)}, data, size));
+    EXPECT_FALSE(isKvsRawType(EKvsDataTypeIndicate::DataType_string));
+    EXPECT_TRUE(isKvsRawType(EKvsDataTypeIndicate::DataType_double_array));
+}
+
@@ -7,8 +7,16 @@
 #include <gtest/gtest.h>
 #include <lap/core/CCore.hpp>
 #include "CPersistency.hpp"
+#include "CKvsShardedBackend.hpp"
+#include "CKvsFileBackend.hpp"
+#include "CStoragePathManager.hpp"
+#include <fstream>
+#include <atomic>
 #include <thread>
+#include <future>
+#include <mutex>
 #include <chrono>
+#include <algorithm>
 
 using namespace lap::core;
 using namespace lap::per;
@@ -257,6 +265,45 @@ TEST_F(KeyValueStorageTest, GetValue_String) {
     EXPECT_EQ(value.Value(), "Test Value");
 }
 
+TEST_F(KeyValueStorageTest, GetValue_Blob) {
+    KvsBlob blob = {Byte{0xDE}, Byte{0xAD}, Byte{0x00}, Byte{0xBE}, Byte{0xEF}};
+    KvsBlob moved = blob;
+    EXPECT_TRUE(testKVS->SetValue("blob_test", ::std::move(moved)).HasValue());
+
+    auto value = testKVS->GetValue<KvsBlob>("blob_test");
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(value.Value(), blob);
+
+    // Blob and string are distinct alternatives
+    auto asString = testKVS->GetValue<String>("blob_test");
+    ASSERT_FALSE(asString.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(asString.Error().Value()), PerErrc::kDataTypeMismatch);
+}
+
+TEST_F(KeyValueStorageTest, GetValueInto_NumericArray) {
+    KvsDoubleArray table = {1.5, -2.25, 3.125};
+    ASSERT_TRUE(testKVS->SetValue("array_test", table).HasValue());
+
+    auto value = testKVS->GetValue<KvsDoubleArray>("array_test");
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(value.Value(), table);
+
+    Double buffer[8] = {};
+    auto count = testKVS->GetValueInto("array_test", Span<Double>(buffer, 8));
+    ASSERT_TRUE(count.HasValue());
+    EXPECT_EQ(count.Value(), 3u);
+    EXPECT_EQ(buffer[2], 3.125);
+
+    Float wrongType[8] = {};
+    auto mismatch = testKVS->GetValueInto("array_test", Span<Float>(wrongType, 8));
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    auto tooSmall = testKVS->GetValueInto("array_test", Span<Double>(buffer, 2));
+    ASSERT_FALSE(tooSmall.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(tooSmall.Error().Value()), PerErrc::kWrongDataSize);
+}
+
 TEST_F(KeyValueStorageTest, GetValue_NonExistentKey) {
     auto value = testKVS->GetValue<String>("non_existent");
     EXPECT_FALSE(value.HasValue());
@@ -701,6 +748,642 @@ TEST_F(KeyValueStorageTest, AUTOSAR_ThreadSafety_ConcurrentReads) {
     EXPECT_EQ(result3.Value(), 42);
 }
 
+TEST_F(KeyValueStorageTest, TypedKey_GetAndSet) {
+    constexpr KvsKey<Int32> kCounter{ "typed.counter" };
+    constexpr KvsKey<String> kCounterAsString{ "typed.counter" };
+    static_assert(KvsKey<Int32>::Type == EKvsDataTypeIndicate::DataType_int32_t, "index must follow KvsDataType");
+    static_assert(KvsKey<KvsDoubleArray>::Type == EKvsDataTypeIndicate::DataType_double_array, "index must follow KvsDataType");
+
+    ASSERT_TRUE(testKVS->SetValue(kCounter, 7).HasValue());
+
+    auto typed = testKVS->GetValue(kCounter);
+    ASSERT_TRUE(typed.HasValue());
+    EXPECT_EQ(typed.Value(), 7);
+
+    // Interoperable with string keys
+    EXPECT_EQ(testKVS->GetValue<Int32>("typed.counter").Value(), 7);
+
+    auto mismatch = testKVS->GetValue(kCounterAsString);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+}
+
+TEST_F(KeyValueStorageTest, KeyHandle_ResolveAndReResolveAfterRemove) {
+    testKVS->SetValue("handle.temp", Double(21.5));
+
+    auto resolved = testKVS->Resolve("handle.temp");
+    ASSERT_TRUE(resolved.HasValue());
+    auto handle = resolved.Value();
+    EXPECT_EQ(handle.Name(), StringView("handle.temp"));
+
+    ASSERT_TRUE(testKVS->SetValue(handle, Double(22.0)).HasValue());
+    EXPECT_DOUBLE_EQ(testKVS->GetValue<Double>(handle).Value(), 22.0);
+    EXPECT_DOUBLE_EQ(testKVS->GetValue<Double>("handle.temp").Value(), 22.0);
+
+    auto mismatch = testKVS->GetValue<Int32>(handle);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    // Removal invalidates the cached location
+    testKVS->RemoveKey("handle.temp");
+    auto removed = testKVS->GetValue<Double>(handle);
+    ASSERT_FALSE(removed.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(removed.Error().Value()), PerErrc::kKeyNotFound);
+
+    // Setting through the stale handle recreates the key
+    ASSERT_TRUE(testKVS->SetValue(handle, Double(23.0)).HasValue());
+    EXPECT_DOUBLE_EQ(testKVS->GetValue<Double>("handle.temp").Value(), 23.0);
+}
+
+TEST_F(KeyValueStorageTest, MoveSetAndGetIntoExisting) {
+    String payload(1024, 'x');
+    payload[10] = '\0';  // Embedded NUL survives the move path
+    const String expected = payload;
+    ASSERT_TRUE(testKVS->SetValue("move.payload", ::std::move(payload)).HasValue());
+    ASSERT_TRUE(testKVS->SetValue("move.variant", KvsDataType{Int32(5)}).HasValue());
+    EXPECT_EQ(testKVS->GetValue<Int32>("move.variant").Value(), 5);
+
+    String out;
+    out.reserve(4096);
+    const char* buffer = out.data();
+    ASSERT_TRUE(testKVS->GetValue("move.payload", out).HasValue());
+    EXPECT_EQ(out, expected);
+    EXPECT_EQ(out.data(), buffer);  // Capacity reused, no reallocation
+
+    Int32 number = 0;
+    auto mismatch = testKVS->GetValue("move.payload", number);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    auto missing = testKVS->GetValue("move.missing", out);
+    ASSERT_FALSE(missing.HasValue());
+    EXPECT_EQ(out, expected);  // Untouched on error
+}
+
+TEST_F(KeyValueStorageTest, AtomicRmw_FetchAddCompareExchangeSetIfAbsent) {
+    testKVS->RemoveKey("rmw.counter");
+    testKVS->RemoveKey("rmw.state");
+
+    // Missing counter starts at zero
+    auto first = testKVS->FetchAdd("rmw.counter", UInt32(5));
+    ASSERT_TRUE(first.HasValue());
+    EXPECT_EQ(first.Value(), 0u);
+    EXPECT_EQ(testKVS->FetchAdd("rmw.counter", UInt32(3)).Value(), 5u);
+    EXPECT_EQ(testKVS->GetValue<UInt32>("rmw.counter").Value(), 8u);
+
+    // Integers wrap like a hardware counter
+    ASSERT_TRUE(testKVS->SetValue("rmw.counter", UInt8(250)).HasValue());
+    EXPECT_EQ(testKVS->FetchAdd("rmw.counter", UInt8(10)).Value(), 250u);
+    EXPECT_EQ(testKVS->GetValue<UInt8>("rmw.counter").Value(), 4u);
+
+    auto mismatch = testKVS->FetchAdd("rmw.counter", Int32(1));
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    EXPECT_TRUE(testKVS->SetIfAbsent("rmw.state", String("idle")).Value());
+    EXPECT_FALSE(testKVS->SetIfAbsent("rmw.state", String("busy")).Value());
+    EXPECT_EQ(testKVS->GetValue<String>("rmw.state").Value(), "idle");
+
+    EXPECT_FALSE(testKVS->CompareExchange("rmw.state", String("busy"), String("done")).Value());
+    EXPECT_TRUE(testKVS->CompareExchange("rmw.state", String("idle"), String("busy")).Value());
+    EXPECT_EQ(testKVS->GetValue<String>("rmw.state").Value(), "busy");
+
+    auto missing = testKVS->CompareExchange("rmw.missing", Int32(0), Int32(1));
+    ASSERT_FALSE(missing.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(missing.Error().Value()), PerErrc::kKeyNotFound);
+}
+
+TEST_F(KeyValueStorageTest, AtomicRmw_ConcurrentFetchAddLosesNoIncrement) {
+    testKVS->RemoveKey("rmw.shared");
+
+    constexpr int kThreads = 4;
+    constexpr int kIncrements = 500;
+    ::std::vector<::std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([this]() {
+            for (int i = 0; i < kIncrements; ++i) {
+                testKVS->FetchAdd("rmw.shared", Int64(1));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(testKVS->GetValue<Int64>("rmw.shared").Value(), kThreads * kIncrements);
+}
+
+TEST_F(KeyValueStorageTest, Notify_PrefixAndKeySetSubscriptions) {
+    ::std::mutex mutex;
+    ::std::vector<KvsChangeEvent> byPrefix;
+    ::std::vector<KvsChangeEvent> byKeys;
+
+    auto prefixId = testKVS->Subscribe("notify.net.", [&](const KvsChangeEvent& ev) {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        byPrefix.push_back(ev);
+    });
+    auto keysId = testKVS->Subscribe(Vector<String>{"notify.a", "notify.b"}, [&](const KvsChangeEvent& ev) {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        byKeys.push_back(ev);
+    });
+    ASSERT_TRUE(prefixId.HasValue());
+    ASSERT_TRUE(keysId.HasValue());
+
+    testKVS->SetValue("notify.net.ip", String("10.0.0.1"));
+    testKVS->SetValue("notify.a", Int32(1));
+    testKVS->SetValue("notify.other", Int32(2));
+    testKVS->RemoveKey("notify.a");
+    testKVS->FlushNotifications();
+
+    {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        ASSERT_EQ(byPrefix.size(), 1u);
+        EXPECT_EQ(byPrefix[0].key, "notify.net.ip");
+        EXPECT_EQ(byPrefix[0].type, KvsChangeType::kSet);
+        // set then remove before a dispatch may coalesce: the last change always arrives
+        ASSERT_FALSE(byKeys.empty());
+        EXPECT_EQ(byKeys.back().key, "notify.a");
+        EXPECT_EQ(byKeys.back().type, KvsChangeType::kRemove);
+    }
+
+    EXPECT_TRUE(testKVS->Unsubscribe(prefixId.Value()).HasValue());
+    EXPECT_TRUE(testKVS->Unsubscribe(keysId.Value()).HasValue());
+    EXPECT_FALSE(testKVS->Unsubscribe(keysId.Value()).HasValue());
+
+    testKVS->SetValue("notify.net.ip", String("10.0.0.2"));
+    testKVS->FlushNotifications();
+    ::std::lock_guard<::std::mutex> lock(mutex);
+    EXPECT_EQ(byPrefix.size(), 1u);
+    testKVS->RemoveKey("notify.net.ip");
+    testKVS->RemoveKey("notify.other");
+}
+
+TEST_F(KeyValueStorageTest, Notify_CoalescesPerKeyAndReportsStoreWideChanges) {
+    ::std::promise<void> gate;
+    auto gateOpen = gate.get_future().share();
+    ::std::mutex mutex;
+    ::std::vector<KvsChangeEvent> events;
+
+    auto id = testKVS->Subscribe("notify.", [&](const KvsChangeEvent& ev) {
+        if (ev.key == "notify.gate") {
+            gateOpen.wait();        // hold the dispatcher while the next batch queues up
+            return;
+        }
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        events.push_back(ev);
+    });
+    ASSERT_TRUE(id.HasValue());
+
+    testKVS->SetValue("notify.gate", Int32(0));
+    ::std::this_thread::sleep_for(::std::chrono::milliseconds(20));
+    for (Int32 i = 0; i < 10; ++i) {
+        testKVS->SetValue("notify.counter", i);
+    }
+    testKVS->FetchAdd("notify.counter", Int32(1));
+    gate.set_value();
+    testKVS->FlushNotifications();
+
+    {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_EQ(events[0].key, "notify.counter");
+        EXPECT_EQ(events[0].type, KvsChangeType::kSet);
+        events.clear();
+    }
+
+    // Failed CAS / SetIfAbsent change nothing and report nothing
+    EXPECT_FALSE(testKVS->CompareExchange("notify.counter", Int32(-1), Int32(0)).Value());
+    EXPECT_FALSE(testKVS->SetIfAbsent("notify.counter", Int32(0)).Value());
+    testKVS->DiscardPendingChanges();
+    testKVS->FlushNotifications();
+
+    {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_TRUE(events[0].key.empty());
+        EXPECT_EQ(events[0].type, KvsChangeType::kReload);
+    }
+
+    testKVS->Unsubscribe(id.Value());
+    testKVS->RemoveKey("notify.gate");
+    testKVS->RemoveKey("notify.counter");
+}
+
+TEST_F(KeyValueStorageTest, Notify_StoreRecoverAndResetPublishReload) {
+    ::std::mutex mutex;
+    ::std::vector<KvsChangeEvent> events;
+
+    auto id = testKVS->Subscribe("notify.", [&](const KvsChangeEvent& ev) {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        events.push_back(ev);
+    });
+    ASSERT_TRUE(id.HasValue());
+
+    // Flushed in between: store-wide events of one drain coalesce into one
+    ASSERT_TRUE(RecoverKeyValueStorage(InstanceSpecifier("/tmp/test_kvs")).HasValue());
+    testKVS->FlushNotifications();
+    ASSERT_TRUE(ResetKeyValueStorage(InstanceSpecifier("/tmp/test_kvs")).HasValue());
+    testKVS->FlushNotifications();
+    {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        ASSERT_EQ(events.size(), 2u);
+        for (const auto& event : events) {
+            EXPECT_TRUE(event.key.empty());
+            EXPECT_EQ(event.type, KvsChangeType::kReload);
+        }
+    }
+
+    testKVS->Unsubscribe(id.Value());
+}
+
+TEST_F(KeyValueStorageTest, Snapshot_PinsValuesAndTypes) {
+    testKVS->SetValue("snap.speed", Double(12.5));
+    testKVS->SetValue("snap.gear", Int32(3));
+
+    auto snapshot = testKVS->Snapshot();
+    ASSERT_TRUE(snapshot.HasValue());
+    auto view = snapshot.Value();
+
+    testKVS->SetValue("snap.speed", Double(30.0));
+    testKVS->RemoveKey("snap.gear");
+    testKVS->SetValue("snap.brake", true);
+
+    EXPECT_DOUBLE_EQ(view.GetValue<Double>("snap.speed").Value(), 12.5);
+    EXPECT_EQ(view.GetValue<Int32>("snap.gear").Value(), 3);
+    EXPECT_FALSE(view.KeyExists("snap.brake").Value());
+    auto mismatch = view.GetValue<String>("snap.speed");
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    auto later = testKVS->Snapshot().Value();
+    EXPECT_DOUBLE_EQ(later.GetValue<Double>("snap.speed").Value(), 30.0);
+    EXPECT_FALSE(later.KeyExists("snap.gear").Value());
+
+    EXPECT_FALSE(KvsSnapshot().KeyExists("snap.speed").HasValue());
+}
+
+TEST_F(KeyValueStorageTest, Snapshot_MultiKeyReadsAreNeverTorn) {
+    constexpr int kKeys = 100;
+    auto keyName = [](int i) { return "snap.row." + ::std::to_string(i); };
+    for (int i = 0; i < kKeys; ++i) {
+        testKVS->SetValue(keyName(i), Int64(0));
+    }
+
+    // The writer sweeps all keys to generation g, so any point-in-time view is
+    // g on a prefix of the keys and g - 1 on the rest
+    ::std::atomic<bool> stop{false};
+    ::std::thread writer([&]() {
+        for (Int64 generation = 1; !stop.load(); ++generation) {
+            for (int i = 0; i < kKeys; ++i) {
+                testKVS->SetValue(keyName(i), generation);
+            }
+        }
+    });
+
+    for (int round = 0; round < 20; ++round) {
+        auto view = testKVS->Snapshot().Value();
+        Int64 first = view.GetValue<Int64>(keyName(0)).Value();
+        Int64 previous = first;
+        for (int i = 1; i < kKeys; ++i) {
+            Int64 value = view.GetValue<Int64>(keyName(i)).Value();
+            EXPECT_LE(value, previous);
+            EXPECT_GE(value, first - 1);
+            previous = value;
+        }
+    }
+
+    stop = true;
+    writer.join();
+}
+
+TEST_F(KeyValueStorageTest, Shard_RoutesPersistsAndMergesKeys) {
+    auto keyName = [](int i) { return "shard.key." + ::std::to_string(i); };
+    ::std::vector<bool> used(4, false);
+    {
+        KvsShardedBackend backend("/tmp/test_kvs_sharded", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(backend.available());
+        ASSERT_EQ(4u, backend.GetShardCount());
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        for (int i = 0; i < 64; ++i) {
+            ASSERT_TRUE(backend.SetValue(keyName(i), KvsDataType(Int32(i))).HasValue());
+            used[backend.GetShardIndex(keyName(i))] = true;
+        }
+        EXPECT_TRUE(backend.FetchAdd("shard.key.0", KvsDataType(Int32(5))).HasValue());
+        EXPECT_EQ(64u, backend.GetKeyCount().Value());
+
+        auto keys = backend.GetAllKeys().Value();
+        ASSERT_EQ(64u, keys.size());
+        EXPECT_TRUE(::std::is_sorted(keys.begin(), keys.end()));
+
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+    EXPECT_EQ(4, ::std::count(used.begin(), used.end(), true));
+
+    // Every shard reloads its own files
+    KvsShardedBackend backend("/tmp/test_kvs_sharded", KvsBackendType::kvsFile, 4);
+    EXPECT_EQ(64u, backend.GetKeyCount().Value());
+    EXPECT_EQ(5, ::std::get<Int32>(backend.GetValue("shard.key.0").Value()));
+    EXPECT_EQ(63, ::std::get<Int32>(backend.GetValue(keyName(63)).Value()));
+}
+
+TEST_F(KeyValueStorageTest, Shard_SnapshotsAreConsistentAcrossShards) {
+    KvsShardedBackend backend("/tmp/test_kvs_sharded_sqlite", KvsBackendType::kvsSqlite, 4);
+    ASSERT_TRUE(backend.available());
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+
+    constexpr int kKeys = 32;
+    auto keyName = [](int i) { return "shard.row." + ::std::to_string(i); };
+    for (int i = 0; i < kKeys; ++i) {
+        backend.SetValue(keyName(i), KvsDataType(Int64(0)));
+    }
+
+    // Same sweep as Snapshot_MultiKeyReadsAreNeverTorn, now with the keys spread over shards
+    ::std::atomic<bool> stop{false};
+    ::std::thread writer([&]() {
+        for (Int64 generation = 1; !stop.load(); ++generation) {
+            for (int i = 0; i < kKeys; ++i) {
+                backend.SetValue(keyName(i), KvsDataType(generation));
+            }
+        }
+    });
+
+    for (int round = 0; round < 10; ++round) {
+        KvsSnapshot view(backend.CreateSnapshot().Value());
+        EXPECT_EQ(static_cast<UInt32>(kKeys), view.GetKeyCount().Value());
+        Int64 first = view.GetValue<Int64>(keyName(0)).Value();
+        Int64 previous = first;
+        for (int i = 1; i < kKeys; ++i) {
+            Int64 value = view.GetValue<Int64>(keyName(i)).Value();
+            EXPECT_LE(value, previous);
+            EXPECT_GE(value, first - 1);
+            previous = value;
+        }
+    }
+
+    stop = true;
+    writer.join();
+}
+
+TEST_F(KeyValueStorageTest, Shard_ManifestRefusesAnotherLayout) {
+    Path::removeDirectory(CStoragePathManager::getKvsInstancePath("/tmp/test_kvs_shard_manifest"), true);
+    {
+        KvsShardedBackend backend("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.SetValue("manifest.key", KvsDataType(Int32(1))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+    EXPECT_TRUE(KvsShardedBackend::IsSharded("/tmp/test_kvs_shard_manifest"));
+
+    // Keys would route to other shards: refused, not silently lost
+    EXPECT_FALSE(KvsShardedBackend("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsFile, 8).available());
+    EXPECT_FALSE(KvsShardedBackend("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsFile, 1).available());
+    EXPECT_FALSE(KvsShardedBackend("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsSqlite, 4).available());
+
+    // Opened without a config: sharded as the manifest records, never as one backend
+    {
+        KeyValueStorage kvs("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsFile);
+        EXPECT_EQ(1, kvs.GetValue<Int32>("manifest.key").Value());
+        EXPECT_FALSE(KeyValueStorage("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsSqlite).KeyExists("manifest.key").HasValue());
+    }
+
+    KvsShardedBackend reopened("/tmp/test_kvs_shard_manifest", KvsBackendType::kvsFile, 4);
+    ASSERT_TRUE(reopened.available());
+    EXPECT_EQ(1, ::std::get<Int32>(reopened.GetValue("manifest.key").Value()));
+}
+
+TEST_F(KeyValueStorageTest, Shard_MigratesANonShardedInstance) {
+    Path::removeDirectory(CStoragePathManager::getKvsInstancePath("/tmp/test_kvs_shard_migrate"), true);
+    {
+        KvsFileBackend legacy("/tmp/test_kvs_shard_migrate");
+        ASSERT_TRUE(legacy.available());
+        for (int i = 0; i < 32; ++i) {
+            ASSERT_TRUE(legacy.SetValue("migrate.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+        ASSERT_TRUE(legacy.SyncToStorage().HasValue());
+    }
+    EXPECT_FALSE(KvsShardedBackend::IsSharded("/tmp/test_kvs_shard_migrate"));
+    const String legacyFile = CStoragePathManager::getKvsInstancePath("/tmp/test_kvs_shard_migrate") + "/current/kvs_data.json";
+    EXPECT_TRUE(::std::ifstream(legacyFile).good());
+
+    {
+        KvsShardedBackend backend("/tmp/test_kvs_shard_migrate", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(backend.available());
+        EXPECT_EQ(32u, backend.GetKeyCount().Value());
+        EXPECT_FALSE(::std::ifstream(legacyFile).good());
+        ASSERT_TRUE(backend.SetValue("migrate.key0", KvsDataType(Int32(-1))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+
+    // Migrated once: the shards are the instance from now on
+    KvsShardedBackend reopened("/tmp/test_kvs_shard_migrate", KvsBackendType::kvsFile, 4);
+    ASSERT_TRUE(reopened.available());
+    EXPECT_EQ(32u, reopened.GetKeyCount().Value());
+    EXPECT_EQ(-1, ::std::get<Int32>(reopened.GetValue("migrate.key0").Value()));
+    EXPECT_EQ(31, ::std::get<Int32>(reopened.GetValue("migrate.key31").Value()));
+}
+
+TEST_F(KeyValueStorageTest, Shard_BudgetedSyncAndDiscardSettleEveryShard) {
+    Path::removeDirectory(CStoragePathManager::getKvsInstancePath("/tmp/test_kvs_shard_budget"), true);
+    {
+        KvsShardedBackend backend("/tmp/test_kvs_shard_budget", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(backend.available());
+        for (int i = 0; i < 32; ++i) {
+            ASSERT_TRUE(backend.SetValue("budget.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+
+        // One record per call: the shards finish one after the other
+        KvsSyncBudget budget;
+        budget.records = 1;
+        int calls = 0;
+        for (bool complete = false; !complete && calls < 1000; ++calls) {
+            KvsSyncMeter meter(budget);
+            auto progress = backend.SyncToStorage(meter);
+            ASSERT_TRUE(progress.HasValue());
+            complete = progress.Value().complete;
+        }
+        EXPECT_LT(calls, 1000);
+
+        // Discarded shards are clean again, and so are the ones a budgeted sync finished
+        ASSERT_TRUE(backend.SetValue("budget.key0", KvsDataType(Int32(-1))).HasValue());
+        ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+        EXPECT_EQ(0, ::std::get<Int32>(backend.GetValue("budget.key0").Value()));
+        KvsSyncMeter meter(budget);
+        auto progress = backend.SyncToStorage(meter);
+        ASSERT_TRUE(progress.HasValue());
+        EXPECT_TRUE(progress.Value().complete);
+        EXPECT_EQ(0u, progress.Value().remainingRecords);
+
+        // Concurrent syncs reuse the same workers
+        for (int round = 0; round < 8; ++round) {
+            for (int i = 0; i < 32; ++i) {
+                ASSERT_TRUE(backend.SetValue("budget.key" + ::std::to_string(i), KvsDataType(Int32(round))).HasValue());
+            }
+            ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        }
+    }
+    KvsShardedBackend reopened("/tmp/test_kvs_shard_budget", KvsBackendType::kvsFile, 4);
+    ASSERT_TRUE(reopened.available());
+    EXPECT_EQ(7, ::std::get<Int32>(reopened.GetValue("budget.key31").Value()));
+}
+
+TEST_F(KeyValueStorageTest, GroupCommit_ConcurrentSyncsShareOnePhysicalSync) {
+    auto kvs = OpenKeyValueStorage(InstanceSpecifier("/tmp/test_kvs_group_commit"), true, KvsBackendType::kvsFile);
+    ASSERT_TRUE(kvs.HasValue());
+    auto storage = kvs.Value();
+    ASSERT_TRUE(storage->RemoveAllKeys().HasValue());
+    storage->SetGroupCommitWindow(20000);  // 20 ms for the other callers to join
+    const auto before = storage->GetGroupCommitStatistics().Value();
+
+    const int threads = 8;
+    ::std::atomic<int> failures{0};
+    ::std::vector<::std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            if (!storage->SetValue("group.key" + ::std::to_string(t), Int32(t)).HasValue() ||
+                !storage->SyncToStorage().HasValue()) {
+                ++failures;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    const auto after = storage->GetGroupCommitStatistics().Value();
+    EXPECT_EQ(0, failures.load());
+    EXPECT_EQ(static_cast<UInt64>(threads), after.requests - before.requests);
+    EXPECT_GE(after.physicalSyncs - before.physicalSyncs, 1u);
+    EXPECT_LT(after.physicalSyncs - before.physicalSyncs, static_cast<UInt64>(threads));
+
+    // Every caller's write was durable when its sync returned
+    ASSERT_TRUE(storage->DiscardPendingChanges().HasValue());
+    for (int t = 0; t < threads; ++t) {
+        EXPECT_EQ(t, storage->GetValue<Int32>("group.key" + ::std::to_string(t)).Value());
+    }
+    storage->SetGroupCommitWindow(0);
+}
+
+TEST_F(KeyValueStorageTest, IncrementalSync_BudgetedCallsResumeUntilComplete) {
+    struct Case { const char* path; KvsBackendType type; bool sliced; };
+    const ::std::vector<Case> cases = {
+        { "/tmp/test_kvs_incremental_file", KvsBackendType::kvsFile, true },
+#ifdef LAP_ENABLE_SQLITE
+        { "/tmp/test_kvs_incremental_sqlite", KvsBackendType::kvsSqlite, false },
+#endif
+    };
+
+    for (const auto& c : cases) {
+        SCOPED_TRACE(c.path);
+        auto kvs = OpenKeyValueStorage(InstanceSpecifier(c.path), true, c.type);
+        ASSERT_TRUE(kvs.HasValue());
+        auto storage = kvs.Value();
+        ASSERT_TRUE(storage->RemoveAllKeys().HasValue());
+        ASSERT_TRUE(storage->SyncToStorage().HasValue());
+
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(storage->SetValue("slice.key" + ::std::to_string(i), Int32(i)).HasValue());
+        }
+
+        // 16 records and 1 KiB per call: the file backend needs many slices
+        KvsSyncBudget budget;
+        budget.records = 16;
+        budget.bytes = 1024;
+        int calls = 0;
+        for (bool complete = false; !complete && calls < 1000; ++calls) {
+            auto progress = storage->SyncToStorage(budget);
+            ASSERT_TRUE(progress.HasValue());
+            complete = progress.Value().complete;
+            if (!complete) {
+                EXPECT_GT(progress.Value().remainingRecords + progress.Value().remainingBytes, 0u);
+            }
+            if (calls == 0) {
+                // Written after the sync started: kept for the next one
+                ASSERT_TRUE(storage->SetValue("slice.late", Int32(-1)).HasValue());
+            }
+        }
+        if (c.sliced) {
+            EXPECT_GT(calls, 100 / 16);
+        }
+        EXPECT_LT(calls, 1000);
+
+        // A time budget alone, the next sync picks up the late write
+        KvsSyncBudget timed;
+        timed.microseconds = 2000;
+        for (int more = 0; more < 1000; ++more) {
+            auto progress = storage->SyncToStorage(timed);
+            ASSERT_TRUE(progress.HasValue());
+            if (progress.Value().complete) break;
+        }
+
+        ASSERT_TRUE(storage->DiscardPendingChanges().HasValue());
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(i, storage->GetValue<Int32>("slice.key" + ::std::to_string(i)).Value());
+        }
+        EXPECT_EQ(-1, storage->GetValue<Int32>("slice.late").Value());
+    }
+}
+
+TEST_F(KeyValueStorageTest, Memory_FileDocumentStaysInsideItsPool) {
+    KvsMemoryResource pool(256u << 10);
+    {
+        KvsFileBackend backend("/tmp/test_kvs_pool", nullptr, &pool);
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        auto empty = pool.GetStatistics();
+
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(backend.SetValue("pool.key." + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+        auto full = pool.GetStatistics();
+        EXPECT_EQ(256u << 10, full.capacity);
+        EXPECT_GT(full.allocations, empty.allocations + 200);
+        EXPECT_GT(full.bytesInUse, empty.bytesInUse);
+
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        EXPECT_LT(pool.GetStatistics().bytesInUse, full.bytesInUse / 100);    // Only the empty root object is left
+        EXPECT_GE(pool.GetStatistics().peakBytes, full.bytesInUse);
+
+        // Reloading parses the document into the pool again
+        ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+        EXPECT_EQ(200u, backend.GetKeyCount().Value());
+        EXPECT_EQ(199, ::std::get<Int32>(backend.GetValue("pool.key.199").Value()));
+
+        // Strings and binary values are allocated from the pool as well
+        const auto before = pool.GetStatistics().bytesInUse;
+        ASSERT_TRUE(backend.SetValue("pool.text", KvsDataType(String(4096, 't'))).HasValue());
+        ASSERT_TRUE(backend.SetValue("pool.blob", KvsDataType(KvsBlob(4096, 0x5A))).HasValue());
+        EXPECT_GE(pool.GetStatistics().bytesInUse, before + 8192);
+        ASSERT_TRUE(backend.RemoveKey("pool.text").HasValue());
+        ASSERT_TRUE(backend.RemoveKey("pool.blob").HasValue());
+    }
+    EXPECT_EQ(0u, pool.GetStatistics().bytesInUse);
+    EXPECT_EQ(0u, pool.GetStatistics().failedAllocations);
+
+    // A full arena refuses the write without touching the heap; freed blocks are reused
+    KvsMemoryResource small(16u << 10);
+    KvsFileBackend backend("/tmp/test_kvs_pool_small", nullptr, &small);
+    ASSERT_TRUE(backend.available());
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    int stored = 0;
+    for (; stored < 10000; ++stored) {
+        auto result = backend.SetValue("small.key." + ::std::to_string(stored), KvsDataType(Int32(stored)));
+        if (!result.HasValue()) {
+            EXPECT_EQ(PerErrc::kOutOfMemorySpace, static_cast<PerErrc>(result.Error().Value()));
+            break;
+        }
+    }
+    ASSERT_LT(stored, 10000);
+    EXPECT_GT(small.GetStatistics().failedAllocations, 0u);
+    EXPECT_EQ(static_cast<UInt32>(stored), backend.GetKeyCount().Value());
+    EXPECT_EQ(0, ::std::get<Int32>(backend.GetValue("small.key.0").Value()));
+
+    ASSERT_TRUE(backend.RemoveKey("small.key.0").HasValue());
+    ASSERT_TRUE(backend.RemoveKey("small.key.1").HasValue());
+    EXPECT_TRUE(backend.SetValue("small.key.again", KvsDataType(Int32(1))).HasValue());
+
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+}
+
 TEST_F(KeyValueStorageTest, AUTOSAR_AtomicOperations_NoPartialUpdates) {
     // Test that updates are atomic [SWS_PER_00600]
     testKVS->SetValue("atomic_key1", static_cast<Int32>(1));
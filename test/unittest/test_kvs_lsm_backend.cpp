@@ -0,0 +1,358 @@
+/**
+ * @file test_kvs_lsm_backend.cpp
+ * @brief Unit tests for the LSM KVS backend
+ * @details Runs on CMemoryFileSystem: WAL recovery, flush and compaction,
+ *          tombstones across levels, atomic updates and snapshots
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <lap/core/CCore.hpp>
+#include "CMemoryFileSystem.hpp"
+#include "CFaultInjectionFileSystem.hpp"
+#include "CKvsLsmBackend.hpp"
+#include "CStoragePathManager.hpp"
+
+using namespace lap::core;
+using namespace lap::per;
+
+class KvsLsmBackendTest : public ::testing::Test {
+protected:
+    SharedHandle<CMemoryFileSystem> memFs;
+
+    void SetUp() override {
+        memFs = MakeShared<CMemoryFileSystem>();
+    }
+
+    // Run files of @p identifier that still hold @p text
+    int RunsContaining(const String& identifier, const String& text) {
+        String dataPath = CStoragePathManager::getKvsInstancePath(identifier) + "/current";
+        int count = 0;
+        for (const auto& name : memFs->ListFiles(dataPath)) {
+            if (name.size() < 4 || name.compare(name.size() - 4, 4, ".sst") != 0) continue;
+            auto bytes = memFs->ReadFile(dataPath + "/" + name).Value();
+            if (::std::search(bytes.begin(), bytes.end(), text.begin(), text.end()) != bytes.end()) ++count;
+        }
+        return count;
+    }
+};
+
+// ============================================================================
+// Recovery, Flush and Compaction
+// ============================================================================
+
+TEST_F(KvsLsmBackendTest, RecoversSyncedChangesFromWal) {
+    {
+        KvsLsmBackend backend("vfs_kvs_lsm", memFs);
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.SetValue("speed", KvsDataType(Double(12.5))).HasValue());
+        ASSERT_TRUE(backend.SetValue("name", KvsDataType(String("ecu"))).HasValue());
+        ASSERT_TRUE(backend.SetValue("gone", KvsDataType(Int32(1))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        // Unsynced changes are revocable
+        ASSERT_TRUE(backend.RemoveKey("gone").HasValue());
+        EXPECT_FALSE(backend.KeyExists("gone").Value());
+        ASSERT_TRUE(backend.RecoverKey("gone").HasValue());
+        EXPECT_EQ(1, ::std::get<Int32>(backend.GetValue("gone").Value()));
+        backend.SetValue("speed", KvsDataType(Double(99.0)));
+        ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+        EXPECT_DOUBLE_EQ(12.5, ::std::get<Double>(backend.GetValue("speed").Value()));
+
+        ASSERT_TRUE(backend.RemoveKey("gone").HasValue());
+        ASSERT_TRUE(backend.FetchAdd("count", KvsDataType(UInt32(3))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        EXPECT_GT(backend.GetStats().walBytes, 0u);
+    }
+
+    KvsLsmBackend reopened("vfs_kvs_lsm", memFs);
+    ASSERT_TRUE(reopened.available());
+    EXPECT_EQ(3u, reopened.GetKeyCount().Value());
+    EXPECT_EQ("ecu", ::std::get<String>(reopened.GetValue("name").Value()));
+    EXPECT_EQ(3u, ::std::get<UInt32>(reopened.GetValue("count").Value()));
+    auto gone = reopened.GetValue("gone");
+    ASSERT_FALSE(gone.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(gone.Error().Value()), PerErrc::kKeyNotFound);
+}
+
+TEST_F(KvsLsmBackendTest, FlushAndCompactionKeepNewestValues) {
+    KvsLsmOptions options;
+    options.memtableBytes = 512;
+    options.level0Runs = 2;
+    options.level1Bytes = 2048;
+    options.runBytes = 1024;
+    options.indexInterval = 4;
+
+    auto keyName = [](int i) { return "lsm.key." + ::std::to_string(i); };
+    {
+        KvsLsmBackend backend("vfs_kvs_lsm_compact", memFs, options);
+        ASSERT_TRUE(backend.available());
+
+        SharedHandle<IKvsSnapshot> early;
+        for (Int32 round = 0; round < 8; ++round) {
+            for (int i = 0; i < 40; ++i) {
+                backend.SetValue(keyName(i), KvsDataType(round * 100 + i));
+            }
+            if (round % 2 == 1) backend.RemoveKey(keyName(round));
+            ASSERT_TRUE(backend.SyncToStorage().HasValue());
+            if (round == 1) early = backend.CreateSnapshot().Value();
+            backend.WaitForBackgroundWork();
+        }
+
+        auto stats = backend.GetStats();
+        EXPECT_GT(stats.flushes, 0u);
+        EXPECT_GT(stats.compactions, 0u);
+        EXPECT_GT(stats.WriteAmplification(), 1.0);
+        EXPECT_LT(stats.runsPerLevel[0], options.level0Runs);
+
+        // The snapshot still reads the runs compaction replaced
+        EXPECT_EQ(100 + 2, ::std::get<Int32>(early->GetValue(keyName(2)).Value()));
+        EXPECT_FALSE(early->KeyExists(keyName(1)).Value());
+        EXPECT_EQ(39u, early->GetKeyCount().Value());
+
+        EXPECT_EQ(700 + 39, ::std::get<Int32>(backend.GetValue(keyName(39)).Value()));
+        EXPECT_FALSE(backend.KeyExists(keyName(7)).Value());
+        EXPECT_EQ(39u, backend.GetKeyCount().Value());
+    }
+
+    KvsLsmBackend reopened("vfs_kvs_lsm_compact", memFs, options);
+    EXPECT_EQ(39u, reopened.GetKeyCount().Value());
+    EXPECT_FALSE(reopened.KeyExists(keyName(7)).Value());
+    EXPECT_EQ(700 + 8, ::std::get<Int32>(reopened.GetValue(keyName(8)).Value()));
+}
+
+TEST_F(KvsLsmBackendTest, TornWalBatchIsDroppedOnRecovery) {
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs);
+    {
+        KvsLsmBackend backend("vfs_kvs_lsm_torn", faultFs);
+        backend.SetValue("key", KvsDataType(String("v1")));
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        FaultInjectionConfig config;
+        config.pathFilter = ".log";
+        config.tornWriteAt = 1;
+        config.tornWriteFraction = 0.5;
+        config.haltAfterFault = true;
+        faultFs->SetConfig(config);
+
+        backend.SetValue("key", KvsDataType(String("v2")));
+        backend.SetValue("other", KvsDataType(Int32(7)));
+        EXPECT_FALSE(backend.SyncToStorage().HasValue());
+        // The failed batch stays pending
+        EXPECT_EQ("v2", ::std::get<String>(backend.GetValue("key").Value()));
+    }
+    EXPECT_EQ(faultFs->GetStats().tornWrites, 1u);
+
+    KvsLsmBackend rebooted("vfs_kvs_lsm_torn", memFs);
+    ASSERT_TRUE(rebooted.available());
+    EXPECT_EQ("v1", ::std::get<String>(rebooted.GetValue("key").Value()));
+    EXPECT_FALSE(rebooted.KeyExists("other").Value());
+
+    // Later batches never follow the torn tail
+    rebooted.SetValue("other", KvsDataType(Int32(8)));
+    ASSERT_TRUE(rebooted.SyncToStorage().HasValue());
+    KvsLsmBackend again("vfs_kvs_lsm_torn", memFs);
+    EXPECT_EQ(8, ::std::get<Int32>(again.GetValue("other").Value()));
+}
+
+// ============================================================================
+// Tombstones
+// ============================================================================
+
+TEST_F(KvsLsmBackendTest, TombstonesShadowOlderLevelsUntilTheBottom) {
+    // Every sync flushes a run, two level-0 runs are compacted into level 1
+    KvsLsmOptions options;
+    options.memtableBytes = 1;
+    options.level0Runs = 2;
+    options.indexInterval = 4;
+
+    auto keyName = [](int i) { return "tomb.key." + ::std::string(i < 10 ? "00" : "0") + ::std::to_string(i); };
+    {
+        KvsLsmBackend backend("lsm_tombstones", memFs, options);
+        ASSERT_TRUE(backend.available());
+        for (int i = 0; i < 40; ++i) backend.SetValue(keyName(i), KvsDataType(Int32(i)));
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        backend.WaitForBackgroundWork();
+        for (int i = 40; i < 80; ++i) backend.SetValue(keyName(i), KvsDataType(Int32(i)));
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        backend.WaitForBackgroundWork();
+        ASSERT_EQ(backend.GetStats().runsPerLevel[0], 0u);
+        ASSERT_GT(backend.GetStats().runsPerLevel[1], 0u);
+
+        // Tombstones in level 0 over the values in level 1
+        for (int i = 0; i < 10; ++i) ASSERT_TRUE(backend.RemoveKey(keyName(i)).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        backend.WaitForBackgroundWork();
+        ASSERT_EQ(backend.GetStats().runsPerLevel[0], 1u);
+        EXPECT_FALSE(backend.KeyExists(keyName(0)).Value());
+        EXPECT_EQ(static_cast<PerErrc>(backend.GetValue(keyName(9)).Error().Value()), PerErrc::kKeyNotFound);
+        EXPECT_EQ(10, ::std::get<Int32>(backend.GetValue(keyName(10)).Value()));
+        EXPECT_EQ(70u, backend.GetKeyCount().Value());
+        EXPECT_EQ(keyName(10), backend.GetAllKeys().Value().front());
+    }
+
+    KvsLsmBackend reopened("lsm_tombstones", memFs, options);
+    ASSERT_TRUE(reopened.available());
+    EXPECT_FALSE(reopened.KeyExists(keyName(5)).Value());
+    EXPECT_EQ(70u, reopened.GetKeyCount().Value());
+    EXPECT_GT(RunsContaining("lsm_tombstones", "tomb.key.00"), 0);
+
+    // Level 1 is the bottom: compacting into it drops the tombstones with the values they shadow
+    reopened.SetValue("tomb.extra", KvsDataType(Int32(-1)));
+    ASSERT_TRUE(reopened.SyncToStorage().HasValue());
+    reopened.WaitForBackgroundWork();
+    EXPECT_EQ(reopened.GetStats().runsPerLevel[0], 0u);
+    EXPECT_EQ(RunsContaining("lsm_tombstones", "tomb.key.00"), 0);
+    EXPECT_EQ(RunsContaining("lsm_tombstones", "tomb.key.010"), 1);
+    EXPECT_FALSE(reopened.KeyExists(keyName(5)).Value());
+    EXPECT_EQ(71u, reopened.GetKeyCount().Value());
+}
+
+TEST_F(KvsLsmBackendTest, RemoveAllKeysIsDiscardedOrSynced) {
+    KvsLsmBackend backend("lsm_remove_all", memFs);
+    ASSERT_TRUE(backend.available());
+    for (int i = 0; i < 5; ++i) backend.SetValue("all.key" + ::std::to_string(i), KvsDataType(Int32(i)));
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+    // Unsynced, the removal and the writes after it are dropped together
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    EXPECT_EQ(0u, backend.GetKeyCount().Value());
+    EXPECT_TRUE(backend.GetAllKeys().Value().empty());
+    backend.SetValue("all.late", KvsDataType(Int32(9)));
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    EXPECT_EQ(5u, backend.GetKeyCount().Value());
+    EXPECT_FALSE(backend.KeyExists("all.late").Value());
+    EXPECT_EQ(3, ::std::get<Int32>(backend.GetValue("all.key3").Value()));
+
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    backend.SetValue("all.late", KvsDataType(Int32(9)));
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+    KvsLsmBackend reopened("lsm_remove_all", memFs);
+    EXPECT_EQ(1u, reopened.GetKeyCount().Value());
+    EXPECT_EQ(::std::vector<String>{ "all.late" }, reopened.GetAllKeys().Value());
+}
+
+// ============================================================================
+// Reads and Atomic Updates
+// ============================================================================
+
+TEST_F(KvsLsmBackendTest, GetAllKeysMergesMemtableAndRuns) {
+    KvsLsmOptions options;
+    options.memtableBytes = 1;
+    options.level0Runs = 8;
+
+    KvsLsmBackend backend("lsm_all_keys", memFs, options);
+    ASSERT_TRUE(backend.available());
+    backend.SetValue("c", KvsDataType(Int32(1)));
+    backend.SetValue("a", KvsDataType(Int32(1)));
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    backend.WaitForBackgroundWork();
+    backend.SetValue("e", KvsDataType(Int32(1)));
+    backend.SetValue("b", KvsDataType(Int32(1)));
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    backend.WaitForBackgroundWork();
+    ASSERT_EQ(backend.GetStats().runsPerLevel[0], 2u);
+
+    // Memtable: a new key, a rewrite and a removal over the runs
+    backend.SetValue("d", KvsDataType(Int32(2)));
+    backend.SetValue("a", KvsDataType(Int32(2)));
+    ASSERT_TRUE(backend.RemoveKey("e").HasValue());
+
+    const ::std::vector<String> expected{ "a", "b", "c", "d" };
+    EXPECT_EQ(expected, backend.GetAllKeys().Value());
+    EXPECT_EQ(4u, backend.GetKeyCount().Value());
+    EXPECT_EQ(expected, backend.CreateSnapshot().Value()->GetAllKeys().Value());
+}
+
+TEST_F(KvsLsmBackendTest, FetchAddAndCompareExchangeReadEveryLevel) {
+    KvsLsmOptions options;
+    options.memtableBytes = 1;
+    {
+        KvsLsmBackend backend("lsm_atomic", memFs, options);
+        ASSERT_TRUE(backend.available());
+
+        // A missing key counts from zero
+        EXPECT_EQ(0, ::std::get<Int32>(backend.FetchAdd("counter", KvsDataType(Int32(5))).Value()));
+        ASSERT_TRUE(backend.SetValue("mode", KvsDataType(String("eco"))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        backend.WaitForBackgroundWork();
+        ASSERT_GT(backend.GetStats().flushes, 0u);
+
+        // Both values now live in a run
+        EXPECT_EQ(5, ::std::get<Int32>(backend.FetchAdd("counter", KvsDataType(Int32(2))).Value()));
+        EXPECT_EQ(7, ::std::get<Int32>(backend.GetValue("counter").Value()));
+        auto mismatch = backend.FetchAdd("counter", KvsDataType(Double(1.0)));
+        ASSERT_FALSE(mismatch.HasValue());
+        EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+        EXPECT_FALSE(backend.CompareExchange("mode", KvsDataType(String("sport")), KvsDataType(String("comfort"))).Value());
+        EXPECT_EQ("eco", ::std::get<String>(backend.GetValue("mode").Value()));
+        EXPECT_TRUE(backend.CompareExchange("mode", KvsDataType(String("eco")), KvsDataType(String("sport"))).Value());
+        auto missing = backend.CompareExchange("none", KvsDataType(Int32(0)), KvsDataType(Int32(1)));
+        ASSERT_FALSE(missing.HasValue());
+        EXPECT_EQ(static_cast<PerErrc>(missing.Error().Value()), PerErrc::kKeyNotFound);
+
+        // A removed key is missing again, even though a run still holds it
+        ASSERT_TRUE(backend.RemoveKey("mode").HasValue());
+        EXPECT_FALSE(backend.CompareExchange("mode", KvsDataType(String("sport")), KvsDataType(String("eco"))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+
+    KvsLsmBackend reopened("lsm_atomic", memFs, options);
+    EXPECT_EQ(7, ::std::get<Int32>(reopened.GetValue("counter").Value()));
+    EXPECT_FALSE(reopened.KeyExists("mode").Value());
+}
+
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+TEST_F(KvsLsmBackendTest, SnapshotTakenDuringCompactionKeepsItsRuns) {
+    KvsLsmOptions options;
+    options.memtableBytes = 1;
+    options.level0Runs = 2;
+    options.level1Bytes = 1024;
+    options.runBytes = 512;
+    options.indexInterval = 4;
+
+    // Slow run writes keep each flush and compaction running while the snapshot is taken
+    FaultInjectionConfig config;
+    config.pathFilter = ".sst";
+    config.writeLatencyUs = 2000;
+    auto slowFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    KvsLsmBackend backend("lsm_snapshot_compaction", slowFs, options);
+    ASSERT_TRUE(backend.available());
+
+    constexpr int kKeys = 48;
+    auto keyName = [](int i) { return "snap.key." + ::std::to_string(i); };
+    ::std::vector<SharedHandle<IKvsSnapshot>> snapshots;
+    for (Int32 round = 0; round < 12; ++round) {
+        for (int i = 0; i < kKeys; ++i) backend.SetValue(keyName(i), KvsDataType(round));
+        if (round > 0) backend.RemoveKey(keyName(round));
+
+        // Taken while the background thread flushes the previous round and compacts the runs below it
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        snapshots.push_back(backend.CreateSnapshot().Value());
+        if (round % 2 == 1) backend.WaitForBackgroundWork();
+    }
+    backend.WaitForBackgroundWork();
+    EXPECT_GT(backend.GetStats().compactions, 1u);
+
+    // Every snapshot still reads the state it was taken in, from runs compaction has since replaced
+    for (Int32 round = 0; round < 12; ++round) {
+        SCOPED_TRACE(round);
+        const auto& snapshot = snapshots[round];
+        EXPECT_EQ(static_cast<UInt32>(round > 0 ? kKeys - 1 : kKeys), snapshot->GetKeyCount().Value());
+        for (int i = 0; i < kKeys; ++i) {
+            if (round > 0 && i == round) {
+                EXPECT_FALSE(snapshot->KeyExists(keyName(i)).Value());
+            } else {
+                EXPECT_EQ(round, ::std::get<Int32>(snapshot->GetValue(keyName(i)).Value()));
+            }
+        }
+    }
+}
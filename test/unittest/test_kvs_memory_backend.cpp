@@ -0,0 +1,140 @@
+/**
+ * @file test_kvs_memory_backend.cpp
+ * @brief Unit tests for the in-memory KVS backend
+ * @details Values, atomic updates, snapshots, and BasicKeyValueStorage bound to it
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <lap/core/CCore.hpp>
+#include "CBasicKeyValueStorage.hpp"
+#include "CKvsMemoryBackend.hpp"
+
+using namespace lap::core;
+using namespace lap::per;
+
+TEST(KvsMemoryBackendTest, StoresOverwritesAndRemovesValues) {
+    KvsMemoryBackend backend;
+    ASSERT_TRUE(backend.available());
+    EXPECT_FALSE(backend.SupportsPersistence());
+
+    ASSERT_TRUE(backend.SetValue("mem.b", KvsDataType(Int32(1))).HasValue());
+    ASSERT_TRUE(backend.SetValue("mem.a", KvsDataType(String("first"))).HasValue());
+    ASSERT_TRUE(backend.SetValue("mem.a", KvsDataType(String("second"))).HasValue());
+    EXPECT_EQ("second", ::std::get<String>(backend.GetValue("mem.a").Value()));
+    EXPECT_EQ(2u, backend.GetKeyCount().Value());
+    EXPECT_EQ((Vector<String>{"mem.a", "mem.b"}), backend.GetAllKeys().Value());
+
+    // Reads into a value of the stored type, a mismatch leaves it untouched
+    KvsDataType out{String()};
+    ASSERT_TRUE(backend.GetValueAssign("mem.a", out).HasValue());
+    EXPECT_EQ("second", ::std::get<String>(out));
+    KvsDataType number{Int64(7)};
+    auto mismatch = backend.GetValueAssign("mem.a", number);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+    EXPECT_EQ(7, ::std::get<Int64>(number));
+
+    ASSERT_TRUE(backend.RemoveKey("mem.a").HasValue());
+    EXPECT_FALSE(backend.KeyExists("mem.a").Value());
+    auto missing = backend.GetValue("mem.a");
+    ASSERT_FALSE(missing.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(missing.Error().Value()), PerErrc::kKeyNotFound);
+
+    // Nothing is stored: a discard drops everything
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    EXPECT_EQ(0u, backend.GetKeyCount().Value());
+    EXPECT_FALSE(backend.RecoverKey("mem.b").HasValue());
+}
+
+TEST(KvsMemoryBackendTest, AtomicUpdatesAndSnapshots) {
+    KvsMemoryBackend backend;
+
+    EXPECT_EQ(0, ::std::get<Int32>(backend.FetchAdd("mem.count", KvsDataType(Int32(2))).Value()));
+    EXPECT_EQ(2, ::std::get<Int32>(backend.FetchAdd("mem.count", KvsDataType(Int32(3))).Value()));
+    EXPECT_FALSE(backend.FetchAdd("mem.count", KvsDataType(Double(1.0))).HasValue());
+    EXPECT_FALSE(backend.CompareExchange("mem.count", KvsDataType(Int32(4)), KvsDataType(Int32(0))).Value());
+    EXPECT_TRUE(backend.CompareExchange("mem.count", KvsDataType(Int32(5)), KvsDataType(Int32(0))).Value());
+    EXPECT_TRUE(backend.SetIfAbsent("mem.flag", KvsDataType(Bool(true))).Value());
+    EXPECT_FALSE(backend.SetIfAbsent("mem.flag", KvsDataType(Bool(false))).Value());
+
+    KvsSnapshot view(backend.CreateSnapshot().Value());
+    ASSERT_TRUE(backend.SetValue("mem.count", KvsDataType(Int32(9))).HasValue());
+    ASSERT_TRUE(backend.RemoveKey("mem.flag").HasValue());
+    EXPECT_EQ(0, view.GetValue<Int32>("mem.count").Value());
+    EXPECT_TRUE(view.GetValue<Bool>("mem.flag").Value());
+    EXPECT_EQ(2u, view.GetKeyCount().Value());
+
+    // A later snapshot sees the changes, the earlier one still does not
+    KvsSnapshot later(backend.CreateSnapshot().Value());
+    EXPECT_EQ(9, later.GetValue<Int32>("mem.count").Value());
+    EXPECT_FALSE(later.KeyExists("mem.flag").Value());
+    EXPECT_EQ(0, view.GetValue<Int32>("mem.count").Value());
+}
+
+TEST(KvsMemoryBackendTest, ConcurrentCountersLoseNoUpdate) {
+    KvsMemoryBackend backend;
+    constexpr int kThreads = 4;
+    constexpr int kAdds = 2000;
+
+    ::std::vector<::std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&backend, t]() {
+            for (int i = 0; i < kAdds; ++i) {
+                backend.FetchAdd("mem.shared", KvsDataType(Int64(1)));
+                backend.SetValue("mem.own." + ::std::to_string(t), KvsDataType(Int64(i)));
+                backend.GetValue("mem.shared");
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(kThreads * kAdds, ::std::get<Int64>(backend.GetValue("mem.shared").Value()));
+    EXPECT_EQ(static_cast<UInt32>(kThreads + 1), backend.GetKeyCount().Value());
+}
+
+TEST(KvsMemoryBackendTest, StaticFacadeInlinesTheMemoryBackend) {
+    BasicKeyValueStorage<KvsMemoryBackend> kvs;
+    ASSERT_TRUE(kvs.available());
+
+    ::std::mutex mutex;
+    ::std::set<::std::string> changed;
+    auto id = kvs.Subscribe("facade.", [&](const KvsChangeEvent& event) {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        changed.emplace(event.key.data(), event.key.size());
+    });
+    ASSERT_TRUE(id.HasValue());
+
+    constexpr KvsKey<Float> kSpeed{"facade.speed"};
+    ASSERT_TRUE(kvs.SetValue(kSpeed, 12.5f).HasValue());
+    ASSERT_TRUE(kvs.SetValue("facade.name", String("ecu")).HasValue());
+    EXPECT_EQ(12.5f, kvs.GetValue(kSpeed).Value());
+    EXPECT_EQ(12.5f, kvs.GetValue<Float>("facade.speed").Value());
+    EXPECT_EQ(0, kvs.FetchAdd<Int32>("facade.count", 2).Value());
+
+    // Rejected updates publish nothing
+    EXPECT_FALSE(kvs.FetchAdd<Int64>("facade.count", 1).HasValue());
+    EXPECT_FALSE(kvs.FetchAdd<Int32>("facade.name", 1).HasValue());
+
+    String reused;
+    ASSERT_TRUE(kvs.GetValue("facade.name", reused).HasValue());
+    EXPECT_EQ("ecu", reused);
+
+    auto view = kvs.Snapshot();
+    ASSERT_TRUE(view.HasValue());
+    ASSERT_TRUE(kvs.RemoveKey("facade.name").HasValue());
+    EXPECT_EQ("ecu", view.Value().GetValue<String>("facade.name").Value());
+
+    kvs.FlushNotifications();
+    {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        EXPECT_EQ((::std::set<::std::string>{"facade.count", "facade.name", "facade.speed"}), changed);
+    }
+    EXPECT_EQ(KvsBackendType::kvsNone, kvs.GetBackend().GetBackendType());
+    EXPECT_TRUE(kvs.Unsubscribe(id.Value()).HasValue());
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_kvs_mmap_backend.cpp
+ * @brief Unit tests for the memory-mapped B+tree KVS backend
+ * @details Page splits and merges, overflow values, pinned snapshots,
+ *          pending changes and torn meta page recovery
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <lap/core/CCore.hpp>
+#include "CKvsMmapBackend.hpp"
+#include "CStoragePathManager.hpp"
+
+using namespace lap::core;
+using namespace lap::per;
+
+class KvsMmapBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (const char* identifier : { "/tmp/test_kvs_mmap", "/tmp/test_kvs_mmap_view", "/tmp/test_kvs_mmap_torn" }) {
+            Path::removeDirectory(CStoragePathManager::getKvsInstancePath(identifier), true);
+        }
+    }
+};
+
+TEST_F(KvsMmapBackendTest, SplitsMergesAndReopensWithOverflowValues) {
+    auto keyName = [](int i) { return "mmap.key." + ::std::to_string(i); };
+    const String large(20000, 'x');     // Spills into an overflow run
+    KvsBlob blob(6000, Byte{0x5A});
+    UInt64 txn = 0;
+    {
+        KvsMmapBackend backend("/tmp/test_kvs_mmap");
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        for (int i = 0; i < 3000; ++i) {
+            ASSERT_TRUE(backend.SetValue(keyName(i), KvsDataType(Int32(i))).HasValue());
+        }
+        ASSERT_TRUE(backend.SetValue("mmap.large", KvsDataType(large)).HasValue());
+        ASSERT_TRUE(backend.SetValue("mmap.blob", KvsDataType(blob)).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        EXPECT_EQ(3002u, backend.GetKeyCount().Value());
+
+        // Deleting most keys merges the emptied leaves back together
+        for (int i = 0; i < 3000; ++i) {
+            if (i % 10 != 0) ASSERT_TRUE(backend.RemoveKey(keyName(i)).HasValue());
+        }
+        EXPECT_EQ(302u, backend.GetKeyCount().Value());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        txn = backend.GetTransactionId();
+
+        auto tooLong = backend.SetValue(String(KvsMmapBackend::MAX_KEY_SIZE + 1, 'k'), KvsDataType(Int32(1)));
+        ASSERT_FALSE(tooLong.HasValue());
+        EXPECT_EQ(static_cast<PerErrc>(tooLong.Error().Value()), PerErrc::kInvalidKey);
+    }
+
+    KvsMmapBackend backend("/tmp/test_kvs_mmap");
+    ASSERT_TRUE(backend.available());
+    EXPECT_EQ(txn, backend.GetTransactionId());
+    EXPECT_EQ(302u, backend.GetKeyCount().Value());
+    EXPECT_EQ(2990, ::std::get<Int32>(backend.GetValue(keyName(2990)).Value()));
+    EXPECT_FALSE(backend.KeyExists(keyName(2991)).Value());
+    EXPECT_EQ(large, ::std::get<String>(backend.GetValue("mmap.large").Value()));
+
+    auto keys = backend.GetAllKeys().Value();
+    ASSERT_EQ(302u, keys.size());
+    EXPECT_TRUE(::std::is_sorted(keys.begin(), keys.end()));
+
+    // Raw values are copied straight from the mapped overflow pages
+    Vector<Byte> buffer(8000);
+    auto copied = backend.GetValueInto("mmap.blob", EKvsDataTypeIndicate::DataType_blob, Span<Byte>(buffer.data(), buffer.size()));
+    ASSERT_TRUE(copied.HasValue());
+    EXPECT_EQ(blob.size(), copied.Value());
+    EXPECT_EQ(Byte{0x5A}, buffer[5999]);
+
+    // One process-wide writer per file
+    KvsMmapBackend second("/tmp/test_kvs_mmap");
+    EXPECT_FALSE(second.available());
+}
+
+TEST_F(KvsMmapBackendTest, SnapshotsAndPendingChangesKeepTheirView) {
+    KvsMmapBackend backend("/tmp/test_kvs_mmap_view");
+    ASSERT_TRUE(backend.available());
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    for (int i = 0; i < 500; ++i) {
+        backend.SetValue("view." + ::std::to_string(i), KvsDataType(Int64(1)));
+    }
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+    KvsSnapshot view(backend.CreateSnapshot().Value());
+
+    // Several commits free and reuse pages; the pinned tree must stay intact
+    for (Int64 generation = 2; generation <= 5; ++generation) {
+        for (int i = 0; i < 500; ++i) {
+            backend.SetValue("view." + ::std::to_string(i), KvsDataType(generation));
+        }
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    EXPECT_EQ(0u, backend.GetKeyCount().Value());
+
+    EXPECT_EQ(500u, view.GetKeyCount().Value());
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(1, view.GetValue<Int64>("view." + ::std::to_string(i)).Value());
+    }
+
+    // Pending changes overlay the tree until synced or discarded
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    EXPECT_EQ(500u, backend.GetKeyCount().Value());
+    ASSERT_TRUE(backend.RemoveKey("view.7").HasValue());
+    EXPECT_FALSE(backend.KeyExists("view.7").Value());
+    ASSERT_TRUE(backend.RecoverKey("view.7").HasValue());
+    EXPECT_EQ(5, ::std::get<Int64>(backend.GetValue("view.7").Value()));
+    EXPECT_EQ(5, ::std::get<Int64>(backend.FetchAdd("view.7", KvsDataType(Int64(1))).Value()));
+    EXPECT_EQ(6, ::std::get<Int64>(backend.GetValue("view.7").Value()));
+}
+
+TEST_F(KvsMmapBackendTest, TornMetaPageFallsBackToPreviousCommit) {
+    UInt64 txn = 0;
+    {
+        KvsMmapBackend backend("/tmp/test_kvs_mmap_torn");
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.SetValue("torn.key", KvsDataType(String("committed"))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        txn = backend.GetTransactionId();
+        ASSERT_TRUE(backend.SetValue("torn.key", KvsDataType(String("lost"))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        ASSERT_EQ(txn + 1, backend.GetTransactionId());
+    }
+
+    // Damage the meta page of the last commit, as if power failed while writing it
+    String file = Path::appendString(Path::appendString(CStoragePathManager::getKvsInstancePath("/tmp/test_kvs_mmap_torn"), "current"), "kvs_data.mdb");
+    {
+        ::std::fstream stream(file.c_str(), ::std::ios::in | ::std::ios::out | ::std::ios::binary);
+        ASSERT_TRUE(stream.is_open());
+        stream.seekp(static_cast<::std::streamoff>(((txn + 1) % 2) * KvsMmapBackend::PAGE_SIZE + 24));
+        stream.write("\xff\xff\xff\xff", 4);
+    }
+
+    KvsMmapBackend backend("/tmp/test_kvs_mmap_torn");
+    ASSERT_TRUE(backend.available());
+    EXPECT_EQ(txn, backend.GetTransactionId());
+    EXPECT_EQ("committed", ::std::get<String>(backend.GetValue("torn.key").Value()));
+
+    // The next commit overwrites the damaged slot
+    ASSERT_TRUE(backend.SetValue("torn.key", KvsDataType(String("again"))).HasValue());
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    EXPECT_EQ(txn + 1, backend.GetTransactionId());
+}
@@ -8,9 +8,21 @@
 #include "CKvsPropertyBackend.hpp"
 #include "CKvsFileBackend.hpp"
 #include "CKvsSqliteBackend.hpp"
+#include "CKvsShardedBackend.hpp"
+#include "CStoragePathManager.hpp"
+#include "CKvsKey.hpp"
+#include "CBasicKeyValueStorage.hpp"
 #include <lap/core/CPath.hpp>
 #include <lap/core/CFile.hpp>
 #include <boost/interprocess/shared_memory_object.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <set>
+#include <map>
+#include <fstream>
+#include <cstdlib>
 
 using namespace lap::per;
 using namespace lap::per::util;
@@ -297,6 +309,763 @@ TEST_F(PropertyBackendTest, Performance_ReadFromMemoryFast) {
     EXPECT_LT(duration.count(), 5) << "Memory reads should be very fast";
 }
 
+TEST_F(PropertyBackendTest, Blob_RoundTripAndPersist) {
+    KvsBlob blob(300);
+    for (Size i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<Byte>(i & 0xFF);  // Embedded zero bytes included
+    }
+
+    {
+        KvsPropertyBackend backend("test_property_persist_file", KvsBackendType::kvsFile);
+        ASSERT_TRUE(backend.SetValue("calib.table", blob).HasValue());
+
+        auto inMemory = backend.GetValue("calib.table");
+        ASSERT_TRUE(inMemory.HasValue());
+        ASSERT_NE(::std::get_if<KvsBlob>(&inMemory.Value()), nullptr);
+        EXPECT_EQ(*::std::get_if<KvsBlob>(&inMemory.Value()), blob);
+
+        backend.SyncToStorage();
+    }
+
+    KvsPropertyBackend backend("test_property_persist_file", KvsBackendType::kvsFile);
+    auto reloaded = backend.GetValue("calib.table");
+    ASSERT_TRUE(reloaded.HasValue());
+    ASSERT_NE(::std::get_if<KvsBlob>(&reloaded.Value()), nullptr);
+    EXPECT_EQ(*::std::get_if<KvsBlob>(&reloaded.Value()), blob);
+}
+
+TEST_F(PropertyBackendTest, Array_GetValueIntoAndPersist) {
+    KvsInt16Array table(1024);
+    for (Size i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<Int16>(i - 512);
+    }
+
+    {
+        KvsPropertyBackend backend("test_property_persist_sqlite", KvsBackendType::kvsSqlite);
+        ASSERT_TRUE(backend.SetValue("lut.int16", table).HasValue());
+
+        Int16 buffer[1024] = {};
+        auto copied = backend.GetValueInto("lut.int16", EKvsDataTypeIndicate::DataType_int16_array,
+                                           Span<Byte>(reinterpret_cast<Byte*>(buffer), sizeof(buffer)));
+        ASSERT_TRUE(copied.HasValue());
+        EXPECT_EQ(copied.Value(), sizeof(buffer));
+        EXPECT_EQ(buffer[0], -512);
+        EXPECT_EQ(buffer[1023], 511);
+
+        backend.SyncToStorage();
+    }
+
+    KvsPropertyBackend backend("test_property_persist_sqlite", KvsBackendType::kvsSqlite);
+    auto reloaded = backend.GetValue("lut.int16");
+    ASSERT_TRUE(reloaded.HasValue());
+    ASSERT_NE(::std::get_if<KvsInt16Array>(&reloaded.Value()), nullptr);
+    EXPECT_EQ(*::std::get_if<KvsInt16Array>(&reloaded.Value()), table);
+}
+
+TEST_F(PropertyBackendTest, TypedKey_HashedAccessMatchesStringAccess) {
+    KvsPropertyBackend backend("test_property_basic", KvsBackendType::kvsFile);
+
+    constexpr KvsKey<Float> kSpeed{ "vehicle.speed" };
+    static_assert(kSpeed.Hash() == kvsKeyHash("vehicle.speed"), "hash must be computed at compile time");
+
+    backend.RemoveKey("vehicle.speed");
+    const Size keysBefore = backend.GetAllKeys().Value().size();
+    ASSERT_TRUE(backend.SetValueHashed(kSpeed.Name(), kSpeed.Hash(), Float(12.5f)).HasValue());
+
+    // Both lookup paths resolve to the same entry
+    auto byName = backend.GetValue("vehicle.speed");
+    ASSERT_TRUE(byName.HasValue());
+    EXPECT_FLOAT_EQ(*::std::get_if<Float>(&byName.Value()), 12.5f);
+
+    backend.SetValue("vehicle.speed", Float(13.0f));
+    auto byHash = backend.GetValueHashed(kSpeed.Name(), kSpeed.Hash());
+    ASSERT_TRUE(byHash.HasValue());
+    EXPECT_FLOAT_EQ(*::std::get_if<Float>(&byHash.Value()), 13.0f);
+    EXPECT_EQ(backend.GetAllKeys().Value().size(), keysBefore + 1);
+
+    auto missing = backend.GetValueHashed("vehicle.rpm", kvsKeyHash("vehicle.rpm"));
+    ASSERT_FALSE(missing.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(missing.Error().Value()), PerErrc::kKeyNotFound);
+}
+
+TEST_F(PropertyBackendTest, KeyHandle_CachesNodeUntilRemove) {
+    KvsPropertyBackend backend("test_property_memory", KvsBackendType::kvsNone);
+
+    KvsKeyHandle handle("engine.rpm");
+    backend.ResolveKey(handle);
+    EXPECT_FALSE(handle.IsResolved());  // Missing keys resolve lazily
+
+    ASSERT_TRUE(backend.SetValueResolved(handle, UInt32(800)).HasValue());
+    auto value = backend.GetValueResolved(handle);
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(*::std::get_if<UInt32>(&value.Value()), 800u);
+    EXPECT_TRUE(handle.IsResolved());
+
+    // Inserts (and the rehashes they cause) keep the cached node valid
+    for (int i = 0; i < 256; ++i) {
+        backend.SetValue("filler_" + ::std::to_string(i), Int32(i));
+    }
+    ASSERT_TRUE(backend.SetValueResolved(handle, UInt32(900)).HasValue());
+    auto updated = backend.GetValue("engine.rpm");
+    EXPECT_EQ(*::std::get_if<UInt32>(&updated.Value()), 900u);
+
+    // Remove and re-insert: the handle must follow the new node
+    backend.RemoveKey("engine.rpm");
+    EXPECT_FALSE(backend.GetValueResolved(handle).HasValue());
+    backend.SetValue("engine.rpm", UInt32(1000));
+    auto reinserted = backend.GetValueResolved(handle);
+    ASSERT_TRUE(reinserted.HasValue());
+    EXPECT_EQ(*::std::get_if<UInt32>(&reinserted.Value()), 1000u);
+
+    backend.RemoveAllKeys();
+    EXPECT_FALSE(backend.GetValueResolved(handle).HasValue());
+}
+
+TEST_F(PropertyBackendTest, AtomicRmw_ConcurrentUpdatesInPlace) {
+    KvsPropertyBackend backend("test_property_memory", KvsBackendType::kvsNone);
+    backend.RemoveKey("rmw.count");
+    backend.RemoveKey("rmw.owner");
+
+    KvsKeyHandle handle("rmw.count");
+    ASSERT_TRUE(backend.SetIfAbsent("rmw.count", KvsDataType{UInt64(0)}).Value());
+    ASSERT_TRUE(backend.GetValueResolved(handle).HasValue());
+
+    constexpr int kThreads = 4;
+    constexpr int kIncrements = 1000;
+    ::std::atomic<int> claims{0};
+    ::std::vector<::std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&backend, &claims]() {
+            if (backend.SetIfAbsent("rmw.owner", KvsDataType{String("worker")}).Value()) {
+                ++claims;
+            }
+            for (int i = 0; i < kIncrements; ++i) {
+                backend.FetchAdd("rmw.count", KvsDataType{UInt64(1)});
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(claims.load(), 1);
+    auto count = backend.GetValue("rmw.count");
+    ASSERT_TRUE(count.HasValue());
+    EXPECT_EQ(*::std::get_if<UInt64>(&count.Value()), static_cast<UInt64>(kThreads * kIncrements));
+
+    // Updates replace the value in place, the cached node stays valid
+    EXPECT_TRUE(handle.IsResolved());
+    EXPECT_TRUE(backend.CompareExchange("rmw.count", KvsDataType{UInt64(kThreads * kIncrements)}, KvsDataType{UInt64(7)}).Value());
+    auto viaHandle = backend.GetValueResolved(handle);
+    EXPECT_EQ(*::std::get_if<UInt64>(&viaHandle.Value()), 7u);
+}
+
+TEST_F(PropertyBackendTest, Snapshot_SharedPerVersionAndIsolated) {
+    KvsPropertyBackend backend("test_property_memory", KvsBackendType::kvsNone);
+    backend.RemoveKey("snap.a");
+    backend.RemoveKey("snap.b");
+    ASSERT_TRUE(backend.SetValue("snap.a", KvsDataType{Int32(1)}).HasValue());
+
+    auto first = backend.CreateSnapshot();
+    auto second = backend.CreateSnapshot();
+    ASSERT_TRUE(first.HasValue());
+    ASSERT_TRUE(second.HasValue());
+
+    backend.SetValue("snap.a", KvsDataType{Int32(2)});
+    backend.SetValue("snap.b", KvsDataType{String("new")});
+
+    auto pinned = first.Value()->GetValue("snap.a");
+    EXPECT_EQ(*::std::get_if<Int32>(&pinned.Value()), 1);
+    EXPECT_FALSE(second.Value()->KeyExists("snap.b").Value());
+    EXPECT_EQ(first.Value()->GetKeyCount().Value(), second.Value()->GetKeyCount().Value());
+
+    auto third = backend.CreateSnapshot();
+    auto current = third.Value()->GetValue("snap.a");
+    EXPECT_EQ(*::std::get_if<Int32>(&current.Value()), 2);
+    EXPECT_TRUE(third.Value()->KeyExists("snap.b").Value());
+}
+
+TEST_F(PropertyBackendTest, Snapshot_LayersChangedKeysOverTheBase) {
+    KvsPropertyBackend backend("test_property_memory", KvsBackendType::kvsNone);
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    auto keyName = [](int i) { return "layer." + ::std::to_string(i); };
+
+    ::std::map<String, Int32> model;
+    for (int i = 0; i < 1500; ++i) {
+        ASSERT_TRUE(backend.SetValue(keyName(i), KvsDataType{Int32(i)}).HasValue());
+        model[keyName(i)] = i;
+    }
+    auto matches = [](const SharedHandle<IKvsSnapshot>& view, const ::std::map<String, Int32>& expected) {
+        auto keys = view->GetAllKeys().Value();
+        if (keys.size() != expected.size() || view->GetKeyCount().Value() != expected.size()) return false;
+        auto key = keys.begin();
+        for (const auto& entry : expected) {
+            if (*key++ != entry.first) return false;
+            if (::std::get<Int32>(view->GetValue(entry.first).Value()) != entry.second) return false;
+        }
+        return true;
+    };
+
+    auto first = backend.CreateSnapshot().Value();
+    const auto firstModel = model;
+    for (int round = 1; round <= 12; ++round) {
+        for (int i = round; i < 1500; i += 61) {
+            backend.SetValue(keyName(i), KvsDataType{Int32(-round)});
+            model[keyName(i)] = -round;
+        }
+        backend.RemoveKey(keyName(round * 7));
+        model.erase(keyName(round * 7));
+
+        ASSERT_TRUE(matches(backend.CreateSnapshot().Value(), model)) << "round " << round;
+    }
+
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    backend.SetValue("after.clear", KvsDataType{Int32(1)});
+    EXPECT_TRUE(matches(backend.CreateSnapshot().Value(), {{"after.clear", 1}}));
+    EXPECT_TRUE(matches(first, firstModel));
+    backend.RemoveAllKeys();
+}
+
+TEST_F(PropertyBackendTest, StaticFacade_SameApiWithoutVirtualDispatch) {
+    BasicKeyValueStorage<KvsPropertyBackend> kvs("test_property_memory", KvsBackendType::kvsNone);
+    ASSERT_TRUE(kvs.available());
+    ASSERT_TRUE(kvs.RemoveAllKeys().HasValue());
+
+    ::std::mutex mutex;
+    ::std::set<::std::string> changed;
+    auto id = kvs.Subscribe("facade.", [&](const KvsChangeEvent& event) {
+        ::std::lock_guard<::std::mutex> lock(mutex);
+        changed.emplace(event.key.data(), event.key.size());
+    });
+    ASSERT_TRUE(id.HasValue());
+
+    constexpr KvsKey<Float> kSpeed{"facade.speed"};
+    ASSERT_TRUE(kvs.SetValue(kSpeed, 12.5f).HasValue());
+    ASSERT_TRUE(kvs.SetValue("facade.name", String("ecu")).HasValue());
+    EXPECT_EQ(12.5f, kvs.GetValue(kSpeed).Value());
+    EXPECT_EQ(12.5f, kvs.GetValue<Float>("facade.speed").Value());
+    EXPECT_EQ(0, kvs.FetchAdd<Int32>("facade.count", 2).Value());
+    EXPECT_EQ(2, kvs.GetValue<Int32>("facade.count").Value());
+
+    String reused;
+    ASSERT_TRUE(kvs.GetValue("facade.name", reused).HasValue());
+    EXPECT_EQ("ecu", reused);
+
+    auto mismatch = kvs.GetValue<Int32>("facade.name");
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    auto view = kvs.Snapshot();
+    ASSERT_TRUE(view.HasValue());
+    ASSERT_TRUE(kvs.RemoveKey("facade.name").HasValue());
+    EXPECT_EQ("ecu", view.Value().GetValue<String>("facade.name").Value());
+    EXPECT_FALSE(kvs.KeyExists("facade.name").Value());
+
+    kvs.FlushNotifications();
+    ::std::lock_guard<::std::mutex> lock(mutex);
+    EXPECT_EQ((::std::set<::std::string>{"facade.count", "facade.name", "facade.speed"}), changed);
+    EXPECT_EQ(KvsBackendType::kvsProperty, kvs.GetBackend().GetBackendType());
+}
+
+TEST_F(PropertyBackendTest, Interning_SharedPrefixesAndLongValuesStoredOnce) {
+    KvsPropertyBackend backend("test_property_memory", KvsBackendType::kvsNone);
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+
+    const String mode("DRIVE_MODE_COMFORT_WITH_ADAPTIVE_DAMPING");
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(backend.SetValue("vehicle.chassis.damper." + ::std::to_string(i), mode).HasValue());
+    }
+    ASSERT_TRUE(backend.SetValue("short", String("inline")).HasValue());
+    ASSERT_TRUE(backend.SetValue(String("\x01raw", 4), Int32(7)).HasValue());
+
+    // One prefix and one value shared by 50 keys each
+    auto stats = backend.GetInternStatistics();
+    ASSERT_TRUE(stats.HasValue());
+    EXPECT_EQ(2u, stats.Value().strings);
+    EXPECT_EQ(100u, stats.Value().references);
+
+    EXPECT_EQ(mode, ::lap::core::get<String>(backend.GetValue("vehicle.chassis.damper.7").Value()));
+    KvsDataType reused = String();
+    ASSERT_TRUE(backend.GetValueAssign("vehicle.chassis.damper.49", reused).HasValue());
+    EXPECT_EQ(mode, ::lap::core::get<String>(reused));
+    EXPECT_EQ(7, ::lap::core::get<Int32>(backend.GetValue(String("\x01raw", 4)).Value()));
+    EXPECT_EQ(52u, backend.GetAllKeys().Value().size());
+    EXPECT_TRUE(backend.KeyExists("vehicle.chassis.damper.0").Value());
+    EXPECT_FALSE(backend.KeyExists("vehicle.chassis.damper.50").Value());
+
+    // Overwrites and removals drop references, the last one frees the string
+    ASSERT_TRUE(backend.SetValue("vehicle.chassis.damper.0", Int32(1)).HasValue());
+    ASSERT_TRUE(backend.RemoveKey("vehicle.chassis.damper.1").HasValue());
+    EXPECT_EQ(97u, backend.GetInternStatistics().Value().references);
+    for (int i = 2; i < 50; ++i) {
+        ASSERT_TRUE(backend.RemoveKey("vehicle.chassis.damper." + ::std::to_string(i)).HasValue());
+    }
+    EXPECT_EQ(1u, backend.GetInternStatistics().Value().strings);
+    EXPECT_EQ(1, ::lap::core::get<Int32>(backend.GetValue("vehicle.chassis.damper.0").Value()));
+
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    EXPECT_EQ(0u, backend.GetInternStatistics().Value().strings);
+}
+
+TEST_F(PropertyBackendTest, MemoryBudget_EvictsColdValuesAndFaultsThemBack) {
+    PersistencyConfig config;
+    config.kvs.propertyBackendPersistence = "sqlite";
+    config.kvs.propertyBackendMemoryBudget = 64 * 1024;
+
+    auto valueOf = [](int i) { return String(1000, static_cast<char>('a' + i % 26)) + ::std::to_string(i); };
+    {
+        KvsPropertyBackend backend("test_property_budget", KvsBackendType::kvsSqlite, KvsPropertyBackend::DEFAULT_SHM_SIZE, &config);
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        // 300 KB of values against a 64 KB budget
+        for (int i = 0; i < 300; ++i) {
+            ASSERT_TRUE(backend.SetValue("budget.key" + ::std::to_string(i), valueOf(i)).HasValue());
+        }
+        auto stats = backend.GetEvictionStatistics().Value();
+        EXPECT_EQ(64u * 1024, stats.budget);
+        EXPECT_LE(stats.segmentBytesUsed, stats.budget);
+        EXPECT_GT(stats.evictions, 0u);
+        EXPECT_EQ(stats.evictions, stats.writeBacks);  // Nothing was synced yet
+        EXPECT_EQ(300u, backend.GetKeyCount().Value());
+
+        // Cold values come back from SQLite, hot ones stay resident
+        for (int i = 0; i < 300; ++i) {
+            EXPECT_EQ(valueOf(i), ::lap::core::get<String>(backend.GetValue("budget.key" + ::std::to_string(i)).Value()));
+        }
+        const auto missesBefore = backend.GetEvictionStatistics().Value().misses;
+        EXPECT_GT(missesBefore, 0u);
+        for (int round = 0; round < 10; ++round) {
+            KvsDataType out = String();
+            ASSERT_TRUE(backend.GetValueAssign("budget.key299", out).HasValue());
+            EXPECT_EQ(valueOf(299), ::lap::core::get<String>(out));
+        }
+        stats = backend.GetEvictionStatistics().Value();
+        EXPECT_EQ(missesBefore, stats.misses);
+        EXPECT_GE(stats.hits, 10u);
+        EXPECT_LE(stats.segmentBytesUsed, stats.budget);
+
+        // Updates of evicted keys and removals reach the persistence backend on sync
+        EXPECT_EQ(0, ::lap::core::get<Int32>(backend.FetchAdd("budget.counter", KvsDataType(Int32(5))).Value()));
+        ASSERT_TRUE(backend.SetValue("budget.key0", String("updated")).HasValue());
+        ASSERT_TRUE(backend.RemoveKey("budget.key1").HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        // Snapshots read evicted values through without faulting them in
+        auto snapshot = backend.CreateSnapshot();
+        ASSERT_TRUE(snapshot.HasValue());
+        EXPECT_EQ(valueOf(2), ::lap::core::get<String>(snapshot.Value()->GetValue("budget.key2").Value()));
+        EXPECT_EQ(300u, snapshot.Value()->GetAllKeys().Value().size());
+    }
+
+    KvsPropertyBackend reloaded("test_property_budget", KvsBackendType::kvsSqlite);
+    EXPECT_EQ(300u, reloaded.GetKeyCount().Value());
+    EXPECT_EQ(String("updated"), ::lap::core::get<String>(reloaded.GetValue("budget.key0").Value()));
+    EXPECT_FALSE(reloaded.KeyExists("budget.key1").Value());
+    EXPECT_EQ(valueOf(150), ::lap::core::get<String>(reloaded.GetValue("budget.key150").Value()));
+    EXPECT_EQ(5, ::lap::core::get<Int32>(reloaded.GetValue("budget.counter").Value()));
+    ASSERT_TRUE(reloaded.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(reloaded.SyncToStorage().HasValue());
+}
+
+TEST_F(PropertyBackendTest, MemoryBudget_DiscardDropsUnsyncedEvictions) {
+    PersistencyConfig config;
+    config.kvs.propertyBackendPersistence = "sqlite";
+    config.kvs.propertyBackendMemoryBudget = 64 * 1024;
+
+    {
+        KvsPropertyBackend backend("test_property_budget_discard", KvsBackendType::kvsSqlite, KvsPropertyBackend::DEFAULT_SHM_SIZE, &config);
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        ASSERT_TRUE(backend.SetValue("discard.base", KvsDataType(Int32(1))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        // Evicted before any sync: staged, SQLite commits nothing
+        for (int i = 0; i < 300; ++i) {
+            ASSERT_TRUE(backend.SetValue("discard.key" + ::std::to_string(i), String(1000, 'd')).HasValue());
+        }
+        ASSERT_TRUE(backend.SetValue("discard.base", KvsDataType(Int32(2))).HasValue());
+        auto stats = backend.GetEvictionStatistics().Value();
+        EXPECT_GT(stats.writeBacks, 0u);
+        EXPECT_EQ(String(1000, 'd'), ::lap::core::get<String>(backend.GetValue("discard.key0").Value()));
+        {
+            KvsSqliteBackend committed("test_property_budget_discard");
+            EXPECT_EQ(1u, committed.GetKeyCount().Value());
+            EXPECT_FALSE(committed.KeyExists("discard.key1").Value());
+        }
+
+        ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+        EXPECT_EQ(1u, backend.GetKeyCount().Value());
+        EXPECT_FALSE(backend.KeyExists("discard.key1").Value());
+        EXPECT_EQ(1, ::lap::core::get<Int32>(backend.GetValue("discard.base").Value()));
+    }
+
+    KvsPropertyBackend reloaded("test_property_budget_discard", KvsBackendType::kvsSqlite);
+    EXPECT_EQ(1u, reloaded.GetKeyCount().Value());
+    EXPECT_EQ(1, ::lap::core::get<Int32>(reloaded.GetValue("discard.base").Value()));
+    ASSERT_TRUE(reloaded.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(reloaded.SyncToStorage().HasValue());
+}
+
+TEST_F(PropertyBackendTest, MemoryBudget_KeysOverBudgetStillServeAllValues) {
+    PersistencyConfig config;
+    config.kvs.propertyBackendPersistence = "file";
+    config.kvs.propertyBackendMemoryBudget = 4 * 1024;    // Below the map's own footprint
+
+    KvsPropertyBackend backend("test_property_budget_keys", KvsBackendType::kvsFile, KvsPropertyBackend::DEFAULT_SHM_SIZE, &config);
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(backend.SetValue("over.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+    }
+
+    // Nothing is left to evict between scans, new values are evicted a batch at a time
+    auto stats = backend.GetEvictionStatistics().Value();
+    EXPECT_GT(stats.segmentBytesUsed, stats.budget);
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_LT(stats.evictions, 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i, ::lap::core::get<Int32>(backend.GetValue("over.key" + ::std::to_string(i)).Value()));
+    }
+
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    EXPECT_EQ(0u, backend.GetKeyCount().Value());
+}
+
+TEST_F(PropertyBackendTest, IncrementalSync_FlushesDirtyKeysInSlices) {
+    {
+        KvsPropertyBackend backend("test_property_incremental", KvsBackendType::kvsFile);
+        ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_TRUE(backend.SetValue("inc.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+        // Only the changed keys are flushed, 4 records per call
+        ASSERT_TRUE(backend.RemoveKey("inc.key0").HasValue());
+        for (int i = 1; i <= 20; ++i) {
+            ASSERT_TRUE(backend.SetValue("inc.key" + ::std::to_string(i), KvsDataType(Int32(-i))).HasValue());
+        }
+        KvsSyncBudget budget;
+        budget.records = 4;
+        int calls = 0;
+        for (bool complete = false; !complete && calls < 1000; ++calls) {
+            KvsSyncMeter meter(budget);
+            auto progress = backend.SyncToStorage(meter);
+            ASSERT_TRUE(progress.HasValue());
+            complete = progress.Value().complete;
+        }
+        EXPECT_GE(calls, 21 / 4);
+        EXPECT_LT(calls, 1000);
+
+        // An unfinished sync is abandoned by a discard, its staged values with it
+        ASSERT_TRUE(backend.SetValue("inc.key30", KvsDataType(Int32(0))).HasValue());
+        ASSERT_TRUE(backend.SetValue("inc.key31", KvsDataType(Int32(0))).HasValue());
+        budget.records = 1;
+        KvsSyncMeter meter(budget);
+        auto partial = backend.SyncToStorage(meter);
+        ASSERT_TRUE(partial.HasValue());
+        EXPECT_FALSE(partial.Value().complete);
+        EXPECT_GT(partial.Value().remainingRecords, 0u);
+        ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+        EXPECT_EQ(30, ::lap::core::get<Int32>(backend.GetValue("inc.key30").Value()));
+        EXPECT_EQ(31, ::lap::core::get<Int32>(backend.GetValue("inc.key31").Value()));
+    }
+
+    KvsPropertyBackend reloaded("test_property_incremental", KvsBackendType::kvsFile);
+    EXPECT_EQ(49u, reloaded.GetKeyCount().Value());
+    EXPECT_FALSE(reloaded.KeyExists("inc.key0").Value());
+    EXPECT_EQ(-20, ::lap::core::get<Int32>(reloaded.GetValue("inc.key20").Value()));
+    EXPECT_EQ(21, ::lap::core::get<Int32>(reloaded.GetValue("inc.key21").Value()));
+    ASSERT_TRUE(reloaded.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(reloaded.SyncToStorage().HasValue());
+}
+
+TEST_F(PropertyBackendTest, IncrementalSync_SqliteCommitsOnlyWholeRounds) {
+    KvsPropertyBackend backend("test_property_incremental_sqlite", KvsBackendType::kvsSqlite);
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(backend.SetValue("inc.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+    }
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+    auto change = [&backend]() {
+        ASSERT_TRUE(backend.RemoveKey("inc.key0").HasValue());
+        for (int i = 1; i <= 10; ++i) {
+            ASSERT_TRUE(backend.SetValue("inc.key" + ::std::to_string(i), KvsDataType(Int32(-i))).HasValue());
+        }
+    };
+    KvsSyncBudget budget;
+    budget.records = 2;
+
+    // Interrupted after a few slices: SQLite holds none of the round, the discard restores all of it
+    change();
+    for (int call = 0; call < 3; ++call) {
+        KvsSyncMeter meter(budget);
+        auto progress = backend.SyncToStorage(meter);
+        ASSERT_TRUE(progress.HasValue());
+        EXPECT_FALSE(progress.Value().complete);
+    }
+    {
+        KvsSqliteBackend committed("test_property_incremental_sqlite");
+        EXPECT_TRUE(committed.KeyExists("inc.key0").Value());
+        for (int i = 1; i <= 10; ++i) {
+            EXPECT_EQ(i, ::lap::core::get<Int32>(committed.GetValue("inc.key" + ::std::to_string(i)).Value()));
+        }
+    }
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    EXPECT_EQ(20u, backend.GetKeyCount().Value());
+    EXPECT_EQ(1, ::lap::core::get<Int32>(backend.GetValue("inc.key1").Value()));
+
+    // Run to the end, the last slice commits the whole round
+    change();
+    int calls = 0;
+    for (bool complete = false; !complete && calls < 1000; ++calls) {
+        KvsSyncMeter meter(budget);
+        auto progress = backend.SyncToStorage(meter);
+        ASSERT_TRUE(progress.HasValue());
+        complete = progress.Value().complete;
+    }
+    EXPECT_GE(calls, 10 / 2);
+    {
+        KvsSqliteBackend committed("test_property_incremental_sqlite");
+        EXPECT_FALSE(committed.KeyExists("inc.key0").Value());
+        for (int i = 1; i <= 10; ++i) {
+            EXPECT_EQ(-i, ::lap::core::get<Int32>(committed.GetValue("inc.key" + ::std::to_string(i)).Value()));
+        }
+        EXPECT_EQ(11, ::lap::core::get<Int32>(committed.GetValue("inc.key11").Value()));
+    }
+
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+}
+
+TEST_F(PropertyBackendTest, BulkTransfer_RoundTripsThroughAllBackendsAndStreams) {
+    ::std::map<String, KvsDataType> expected;
+    expected["type.i8"] = Int8(-8);
+    expected["type.u8"] = UInt8(8);
+    expected["type.i16"] = Int16(-16);
+    expected["type.u16"] = UInt16(16);
+    expected["type.i32"] = Int32(-32);
+    expected["type.u32"] = UInt32(32);
+    expected["type.i64"] = Int64(-64);
+    expected["type.u64"] = UInt64(64);
+    expected["type.bool"] = Bool(true);
+    expected["type.float"] = Float(1.5f);
+    expected["type.double"] = Double(-2.25);
+    expected["type.string"] = String("with\0nul", 8);
+    expected["type.empty"] = String();
+    expected["type.blob"] = KvsBlob{0, 1, 254, 255};
+    expected["type.i8array"] = KvsInt8Array{-1, 2};
+    expected["type.i16array"] = KvsInt16Array{-3, 4};
+    expected["type.u16array"] = KvsUInt16Array{5, 6};
+    expected["type.i32array"] = KvsInt32Array{-7, 8};
+    expected["type.u32array"] = KvsUInt32Array{9, 10};
+    expected["type.i64array"] = KvsInt64Array{-11, 12};
+    expected["type.u64array"] = KvsUInt64Array{13, 14};
+    expected["type.floatarray"] = KvsFloatArray{0.5f, -0.5f};
+    expected["type.doublearray"] = KvsDoubleArray{};
+    for (int i = 0; i < 2500; ++i) {
+        expected["bulk.key" + ::std::to_string(i)] = Int32(i);
+    }
+    auto verify = [&expected](IKvsBackend& backend) {
+        EXPECT_EQ(expected.size(), backend.GetKeyCount().Value());
+        for (const auto& entry : expected) {
+            auto value = backend.GetValue(entry.first);
+            ASSERT_TRUE(value.HasValue()) << entry.first;
+            EXPECT_TRUE(value.Value() == entry.second) << entry.first;
+        }
+    };
+
+    KvsFileBackend file("test_bulk_file");
+    ASSERT_TRUE(file.RemoveAllKeys().HasValue());
+    for (const auto& entry : expected) {
+        ASSERT_TRUE(file.SetValue(entry.first, entry.second).HasValue());
+    }
+
+    // File -> SQLite through memory, replacing what the target held
+    KvsRecordBuffer buffer;
+    auto exported = file.Export(buffer, 1000);
+    ASSERT_TRUE(exported.HasValue());
+    EXPECT_EQ(expected.size(), exported.Value());
+    EXPECT_EQ(expected.size(), buffer.ExpectedRecords());
+
+    KvsSqliteBackend sqlite("test_bulk_sqlite");
+    ASSERT_TRUE(sqlite.SetValue("stale.key", Int32(1)).HasValue());
+    KvsImportOptions options;
+    options.clearFirst = true;
+    options.batchSize = 700;
+    auto imported = sqlite.Import(buffer, options);
+    ASSERT_TRUE(imported.HasValue());
+    EXPECT_EQ(expected.size(), imported.Value());
+    EXPECT_FALSE(sqlite.KeyExists("stale.key").Value());
+    verify(sqlite);
+
+    // SQLite -> Property through a stream file, one batch per transaction
+    const char* path = "/tmp/test_bulk_transfer.kvr";
+    {
+        KvsRecordFileWriter writer(nullptr, path);
+        ASSERT_TRUE(sqlite.Export(writer, 512).HasValue());
+    }
+    {
+        KvsPropertyBackend property("test_bulk_property", KvsBackendType::kvsFile);
+        ASSERT_TRUE(property.RemoveAllKeys().HasValue());
+        KvsRecordFileReader reader(nullptr, path);
+        EXPECT_EQ(expected.size(), reader.ExpectedRecords());
+        options.clearFirst = false;
+        options.bulkLoad = false;
+        ASSERT_TRUE(property.Import(reader, options).HasValue());
+        verify(property);
+        ASSERT_TRUE(property.SyncToStorage().HasValue());
+    }
+    KvsPropertyBackend property("test_bulk_property", KvsBackendType::kvsFile);
+    verify(property);
+
+    // Truncated and damaged streams are detected
+    auto detectsCorruption = [](IKvsRecordSource& source) {
+        KvsRecordBatch batch;
+        for (;;) {
+            auto read = source.Read(batch, 1000);
+            if (!read.HasValue()) return static_cast<PerErrc>(read.Error().Value()) == PerErrc::kIntegrityCorrupted;
+            if (read.Value() == 0) return false;
+        }
+    };
+    const auto& data = buffer.Data();
+    auto writeFile = [path](const UInt8* bytes, Size size) {
+        ::std::ofstream stream(path, ::std::ios::binary | ::std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(bytes), static_cast<::std::streamsize>(size));
+    };
+
+    writeFile(data.data(), data.size() - 12);   // End block lost
+    KvsRecordFileReader truncated(nullptr, path);
+    EXPECT_TRUE(detectsCorruption(truncated));
+
+    ::std::vector<UInt8> flipped(data.begin(), data.end());
+    flipped[flipped.size() / 2] ^= 0x5a;
+    writeFile(flipped.data(), flipped.size());
+    KvsRecordFileReader corrupt(nullptr, path);
+    EXPECT_TRUE(detectsCorruption(corrupt));
+
+    KvsRecordFileReader rejected(nullptr, path);
+    EXPECT_FALSE(property.Import(rejected).HasValue());
+
+    ::std::remove(path);
+    ASSERT_TRUE(property.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(property.SyncToStorage().HasValue());
+    ASSERT_TRUE(sqlite.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(file.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(file.SyncToStorage().HasValue());
+}
+
+// kvs_bulk_tool is built with the library; the build passes its path in KVS_BULK_TOOL
+TEST_F(PropertyBackendTest, BulkTool_ExportImportRoundTrip) {
+#ifndef KVS_BULK_TOOL
+    GTEST_SKIP() << "kvs_bulk_tool path not configured";
+#else
+    const ::std::string tool = KVS_BULK_TOOL;
+    const ::std::string stream = "/tmp/test_bulk_tool.kvr";
+    auto run = [&tool](const ::std::string& arguments) {
+        return ::std::system(("\"" + tool + "\" " + arguments + " > /dev/null").c_str());
+    };
+
+    {
+        KvsFileBackend source("test_bulk_tool_source");
+        ASSERT_TRUE(source.RemoveAllKeys().HasValue());
+        for (int i = 0; i < 500; ++i) {
+            ASSERT_TRUE(source.SetValue("tool.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+        ASSERT_TRUE(source.SetValue("tool.name", KvsDataType(String("bulk tool"))).HasValue());
+        ASSERT_TRUE(source.SetValue("tool.blob", KvsDataType(KvsBlob{0x00, 0xff, 0x10})).HasValue());
+        ASSERT_TRUE(source.SyncToStorage().HasValue());
+    }
+
+    // Separate processes, the instances are found by identifier below the KVS root
+    ASSERT_EQ(0, run("export file test_bulk_tool_source " + stream));
+    ASSERT_EQ(0, run("info " + stream));
+    ASSERT_EQ(0, run("import sqlite test_bulk_tool_target " + stream + " --clear --batch 64"));
+    EXPECT_NE(0, run("info /tmp/test_bulk_tool_missing.kvr"));
+
+    KvsSqliteBackend target("test_bulk_tool_target");
+    EXPECT_EQ(502u, target.GetKeyCount().Value());
+    EXPECT_EQ(499, ::std::get<Int32>(target.GetValue("tool.key499").Value()));
+    EXPECT_EQ(String("bulk tool"), ::std::get<String>(target.GetValue("tool.name").Value()));
+    EXPECT_EQ((KvsBlob{0x00, 0xff, 0x10}), ::std::get<KvsBlob>(target.GetValue("tool.blob").Value()));
+
+    ::std::remove(stream.c_str());
+    ASSERT_TRUE(target.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(target.SyncToStorage().HasValue());
+    KvsFileBackend source("test_bulk_tool_source");
+    ASSERT_TRUE(source.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(source.SyncToStorage().HasValue());
+#endif
+}
+
+TEST_F(PropertyBackendTest, BulkTool_RoundTripsShardedAndSharedInstances) {
+#ifndef KVS_BULK_TOOL
+    GTEST_SKIP() << "kvs_bulk_tool path not configured";
+#else
+    const ::std::string tool = KVS_BULK_TOOL;
+    const ::std::string stream = "/tmp/test_bulk_tool_sharded.kvr";
+    auto run = [&tool](const ::std::string& arguments) {
+        return ::std::system(("\"" + tool + "\" " + arguments + " > /dev/null 2>&1").c_str());
+    };
+    const String shardedPath = CStoragePathManager::getKvsInstancePath("test_bulk_tool_sharded");
+    Path::removeDirectory(shardedPath, true);
+
+    {
+        KvsShardedBackend sharded("test_bulk_tool_sharded", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(sharded.available());
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(sharded.SetValue("tool.key" + ::std::to_string(i), KvsDataType(Int32(i))).HasValue());
+        }
+        ASSERT_TRUE(sharded.SyncToStorage().HasValue());
+    }
+
+    // Opened with the manifest's layout: every shard is exported, other backends are refused
+    ASSERT_EQ(0, run("export file test_bulk_tool_sharded " + stream));
+    EXPECT_NE(0, run("export sqlite test_bulk_tool_sharded " + stream + ".refused"));
+    EXPECT_NE(0, run("import property test_bulk_tool_sharded " + stream));
+    ASSERT_EQ(0, run("import sqlite test_bulk_tool_tenant " + stream + " --clear --shared-db test_bulk_tool_shared"));
+
+    {
+        KvsSqliteBackend tenant("test_bulk_tool_tenant", "test_bulk_tool_shared");
+        EXPECT_EQ(200u, tenant.GetKeyCount().Value());
+        EXPECT_EQ(199, ::std::get<Int32>(tenant.GetValue("tool.key199").Value()));
+        ASSERT_TRUE(tenant.SetValue("tool.extra", KvsDataType(String("from tenant"))).HasValue());
+        ASSERT_TRUE(tenant.SyncToStorage().HasValue());
+    }
+
+    // Back into the shards, nothing is written where the sharded open would remove it
+    ASSERT_EQ(0, run("export sqlite test_bulk_tool_tenant " + stream + " --shared-db test_bulk_tool_shared"));
+    ASSERT_EQ(0, run("import file test_bulk_tool_sharded " + stream + " --clear"));
+    EXPECT_FALSE(::std::ifstream((shardedPath + "/current/kvs_data.json").c_str()).good());
+
+    {
+        KvsShardedBackend sharded("test_bulk_tool_sharded", KvsBackendType::kvsFile, 4);
+        ASSERT_TRUE(sharded.available());
+        EXPECT_EQ(201u, sharded.GetKeyCount().Value());
+        EXPECT_EQ(0, ::std::get<Int32>(sharded.GetValue("tool.key0").Value()));
+        EXPECT_EQ(String("from tenant"), ::std::get<String>(sharded.GetValue("tool.extra").Value()));
+    }
+
+    ::std::remove(stream.c_str());
+    Path::removeDirectory(shardedPath, true);
+    KvsSqliteBackend tenant("test_bulk_tool_tenant", "test_bulk_tool_shared");
+    ASSERT_TRUE(tenant.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(tenant.SyncToStorage().HasValue());
+#endif
+}
+
+TEST_F(PropertyBackendTest, EdgeCase_StringWithEmbeddedNul) {
+    KvsPropertyBackend backend("test_property_basic", KvsBackendType::kvsFile);
+
+    String value("a\0b", 3);
+    backend.SetValue("nul", value);
+
+    auto getValue = backend.GetValue("nul");
+    ASSERT_TRUE(getValue.HasValue());
+    EXPECT_EQ(*::std::get_if<String>(&getValue.Value()), value);
+}
+
 // ============================================================================
 // Edge Cases Tests
 // ============================================================================
@@ -6,9 +6,12 @@
 
 #include <gtest/gtest.h>
 #include "CKvsSqliteBackend.hpp"
+#include "CStoragePathManager.hpp"
 #include <lap/core/CPath.hpp>
 #include <lap/core/CFile.hpp>
 #include <sqlite3.h>
+#include <filesystem>
+#include <thread>
 
 using namespace lap::per;
 using namespace lap::core;
@@ -16,10 +19,14 @@ using namespace lap::core;
 class SqliteBackendEnhancedTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        // Clean up test databases
-        ::std::remove("/tmp/test_sqlite_enhanced.db");
-        ::std::remove("/tmp/test_sqlite_wal.db");
-        ::std::remove("/tmp/test_sqlite_transaction.db");
+        // Every test starts without the databases (and WAL files) of earlier tests or runs
+        for (const char* instance : {"test_sqlite_enhanced", "test_sqlite_wal", "test_sqlite_transaction",
+                                     "test_sqlite_many_keys", "test_sqlite_bloom", "test_sqlite_bloom_shared",
+                                     "test_sqlite_shared", "test_sqlite_tenant_a", "test_sqlite_tuned",
+                                     "instance1", "instance2"}) {
+            ::std::error_code ignored;
+            ::std::filesystem::remove_all(CStoragePathManager::getKvsInstancePath(instance).c_str(), ignored);
+        }
     }
     
     void TearDown() override {
@@ -66,6 +73,131 @@ TEST_F(SqliteBackendEnhancedTest, MultipleInstances_DifferentDatabases) {
     EXPECT_STREQ(str2->data(), "value2");
 }
 
+TEST_F(SqliteBackendEnhancedTest, SharedDatabase_InstancesKeepTheirOwnTablesInOneFile) {
+    const String sharedFile = CStoragePathManager::getKvsInstancePath("test_sqlite_shared") + "/current/db.sqlite";
+    // Quotes, slashes and schema names stay inside the table name
+    const char* quoted = "test_sqlite_shared \"b\"/x:idx_type kvs_data";
+    {
+        KvsSqliteBackend a("test_sqlite_tenant_a", "test_sqlite_shared");
+        KvsSqliteBackend b(quoted, "test_sqlite_shared");
+        ASSERT_TRUE(a.available());
+        ASSERT_TRUE(b.available());
+        EXPECT_TRUE(a.IsShared());
+        ASSERT_TRUE(a.RemoveAllKeys().HasValue());
+        ASSERT_TRUE(b.RemoveAllKeys().HasValue());
+
+        // Same keys, separate values; concurrent writers serialize on the shared connection
+        ::std::thread writerA([&a]() {
+            for (int i = 0; i < 200; ++i) a.SetValue("key" + ::std::to_string(i), KvsDataType(Int32(i)));
+        });
+        ::std::thread writerB([&b]() {
+            for (int i = 0; i < 100; ++i) b.SetValue("key" + ::std::to_string(i), KvsDataType(String("b")));
+        });
+        writerA.join();
+        writerB.join();
+        EXPECT_EQ(200u, a.GetKeyCount().Value());
+        EXPECT_EQ(100u, b.GetKeyCount().Value());
+        EXPECT_EQ(7, ::std::get<Int32>(a.GetValue("key7").Value()));
+        EXPECT_EQ(String("b"), ::std::get<String>(b.GetValue("key7").Value()));
+
+        // A second backend of an instance sees inserts its filter did not make
+        KvsSqliteBackend a2("test_sqlite_tenant_a", "test_sqlite_shared");
+        EXPECT_FALSE(a2.KeyExists("late.key").Value());
+        ASSERT_TRUE(a.SetValue("late.key", KvsDataType(Int32(1))).HasValue());
+        EXPECT_TRUE(a2.KeyExists("late.key").Value());
+
+        // Snapshots, bulk import (indexes dropped and rebuilt) and removal stay per instance
+        auto snapshot = b.CreateSnapshot();
+        ASSERT_TRUE(snapshot.HasValue());
+        KvsRecordBuffer buffer;
+        ASSERT_TRUE(a.Export(buffer).HasValue());
+        KvsImportOptions options;
+        options.clearFirst = true;
+        ASSERT_TRUE(b.Import(buffer, options).HasValue());
+        EXPECT_EQ(201u, b.GetKeyCount().Value());
+        EXPECT_EQ(100u, snapshot.Value()->GetKeyCount().Value());
+        EXPECT_EQ(String("b"), ::std::get<String>(snapshot.Value()->GetValue("key7").Value()));
+        ASSERT_TRUE(b.RemoveAllKeys().HasValue());
+        EXPECT_EQ(201u, a.GetKeyCount().Value());
+        ASSERT_TRUE(a.SyncToStorage().HasValue());
+        ASSERT_TRUE(b.SyncToStorage().HasValue());
+    }
+
+    // One file in the shared database's directory, none per instance
+    EXPECT_TRUE(::std::filesystem::exists(sharedFile.c_str()));
+    EXPECT_FALSE(::std::filesystem::exists((CStoragePathManager::getKvsInstancePath("test_sqlite_tenant_a") + "/current/db.sqlite").c_str()));
+    sqlite3* db = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open_v2(sharedFile.c_str(), &db, SQLITE_OPEN_READONLY, nullptr));
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name LIKE 'kvs_data:%';", -1, &stmt, nullptr));
+    ASSERT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    EXPECT_EQ(2, sqlite3_column_int(stmt, 0));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+
+    KvsSqliteBackend reopened("test_sqlite_tenant_a", "test_sqlite_shared");
+    EXPECT_EQ(201u, reopened.GetKeyCount().Value());
+    EXPECT_GT(reopened.GetSize().Value(), 0u);
+    ASSERT_TRUE(reopened.RemoveAllKeys().HasValue());
+    ASSERT_TRUE(reopened.SyncToStorage().HasValue());
+}
+
+TEST_F(SqliteBackendEnhancedTest, Tuning_AppliesConfiguredPragmas) {
+    const String file = CStoragePathManager::getKvsInstancePath("test_sqlite_tuned") + "/current/db.sqlite";
+
+    KvsSqliteTuning tuning;
+    tuning.journalMode = "delete";      // Keywords in any case
+    tuning.synchronous = "SOMETIMES";   // Invalid, keeps NORMAL
+    tuning.cacheSize = -256;
+    tuning.mmapSize = 0;
+    tuning.pageSize = 8192;
+    tuning.tempStore = "MEMORY";
+    tuning.exclusiveLocking = true;
+    {
+        KvsSqliteBackend backend("test_sqlite_tuned", StringView(), tuning);
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.SetValue("key", KvsDataType(Int32(1))).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+        // The exclusive lock keeps other connections, snapshots among them, out
+        EXPECT_FALSE(backend.CreateSnapshot().HasValue());
+    }
+    EXPECT_FALSE(::std::filesystem::exists((file + "-wal").c_str()));
+
+    // Page size and journal mode are recorded in the file
+    auto pragma = [&file](const char* sql) {
+        sqlite3* db = nullptr;
+        String value;
+        if (sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+            sqlite3_exec(db, sql, [](void* out, int, char** values, char**) {
+                *static_cast<String*>(out) = values[0] ? values[0] : "";
+                return 0;
+            }, &value, nullptr);
+        }
+        sqlite3_close(db);
+        return value;
+    };
+    EXPECT_EQ(String("8192"), pragma("PRAGMA page_size;"));
+    EXPECT_EQ(String("delete"), pragma("PRAGMA journal_mode;"));
+
+    // Defaults again on reopen: WAL, the page size stays
+    {
+        KvsSqliteBackend reopened("test_sqlite_tuned");
+        ASSERT_TRUE(reopened.available());
+        EXPECT_EQ(1, ::std::get<Int32>(reopened.GetValue("key").Value()));
+        EXPECT_TRUE(reopened.CreateSnapshot().HasValue());
+        ASSERT_TRUE(reopened.RemoveAllKeys().HasValue());
+        ASSERT_TRUE(reopened.SyncToStorage().HasValue());
+    }
+    EXPECT_EQ(String("wal"), pragma("PRAGMA journal_mode;"));
+    EXPECT_EQ(String("8192"), pragma("PRAGMA page_size;"));
+
+    // Per-instance overrides of the configuration, a shared database by its own identifier
+    PersistencyConfig config;
+    config.kvs.sqliteInstances["test_sqlite_tuned"] = tuning;
+    EXPECT_EQ(-256, config.kvs.sqliteTuning("test_sqlite_tuned").cacheSize);
+    EXPECT_EQ(-10000, config.kvs.sqliteTuning("test_sqlite_other").cacheSize);
+}
+
 // ============================================================================
 // WAL Mode Tests
 // ============================================================================
@@ -186,6 +318,226 @@ TEST_F(SqliteBackendEnhancedTest, DataIntegrity_PersistenceAfterClose) {
     EXPECT_STREQ(strVal->data(), "should_persist");
 }
 
+TEST_F(SqliteBackendEnhancedTest, DataIntegrity_BlobStoredNatively) {
+    KvsBlob blob = {Byte{0x00}, Byte{0xFF}, Byte{0x00}, Byte{0x7F}, Byte{0x80}};
+    {
+        KvsSqliteBackend backend("test_sqlite_enhanced");
+        ASSERT_TRUE(backend.SetValue("calib.blob", blob).HasValue());
+        ASSERT_TRUE(backend.SetValue("calib.empty", KvsBlob{}).HasValue());
+    }
+
+    KvsSqliteBackend backend("test_sqlite_enhanced");
+    auto result = backend.GetValue("calib.blob");
+    ASSERT_TRUE(result.HasValue());
+    auto blobVal = ::std::get_if<KvsBlob>(&result.Value());
+    ASSERT_NE(blobVal, nullptr);
+    EXPECT_EQ(*blobVal, blob);
+
+    auto emptyResult = backend.GetValue("calib.empty");
+    ASSERT_TRUE(emptyResult.HasValue());
+    ASSERT_NE(::std::get_if<KvsBlob>(&emptyResult.Value()), nullptr);
+    EXPECT_TRUE(::std::get_if<KvsBlob>(&emptyResult.Value())->empty());
+
+    // Raw bytes land in the BLOB storage class, not as encoded text
+    sqlite3* db = nullptr;
+    String dbPath = CStoragePathManager::getKvsInstancePath("test_sqlite_enhanced") + "/current/db.sqlite";
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &db), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "SELECT typeof(value), length(value) FROM kvs_data WHERE key = 'calib.blob'", -1, &stmt, nullptr);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), "blob");
+    EXPECT_EQ(sqlite3_column_int(stmt, 1), 5);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+TEST_F(SqliteBackendEnhancedTest, DataIntegrity_NumericArraysAndGetValueInto) {
+    KvsFloatArray table(256);
+    for (Size i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<Float>(i) * 0.5f;
+    }
+
+    KvsSqliteBackend backend("test_sqlite_enhanced");
+    ASSERT_TRUE(backend.SetValue("lut.float", table).HasValue());
+    ASSERT_TRUE(backend.SetValue("lut.int16", KvsInt16Array{-1, 2, -3}).HasValue());
+
+    auto result = backend.GetValue("lut.float");
+    ASSERT_TRUE(result.HasValue());
+    ASSERT_NE(::std::get_if<KvsFloatArray>(&result.Value()), nullptr);
+    EXPECT_EQ(*::std::get_if<KvsFloatArray>(&result.Value()), table);
+
+    Float buffer[256] = {};
+    auto copied = backend.GetValueInto("lut.float", EKvsDataTypeIndicate::DataType_float_array,
+                                       Span<Byte>(reinterpret_cast<Byte*>(buffer), sizeof(buffer)));
+    ASSERT_TRUE(copied.HasValue());
+    EXPECT_EQ(copied.Value(), sizeof(buffer));
+    EXPECT_EQ(buffer[255], table[255]);
+
+    // Wrong element type and undersized buffer
+    auto mismatch = backend.GetValueInto("lut.int16", EKvsDataTypeIndicate::DataType_float_array,
+                                         Span<Byte>(reinterpret_cast<Byte*>(buffer), sizeof(buffer)));
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+
+    auto tooSmall = backend.GetValueInto("lut.float", EKvsDataTypeIndicate::DataType_float_array,
+                                         Span<Byte>(reinterpret_cast<Byte*>(buffer), 16));
+    ASSERT_FALSE(tooSmall.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(tooSmall.Error().Value()), PerErrc::kWrongDataSize);
+}
+
+TEST_F(SqliteBackendEnhancedTest, DataIntegrity_GetValueAssignReusesBuffer) {
+    KvsSqliteBackend backend("test_sqlite_enhanced");
+    const String text(4096, 'q');
+    ASSERT_TRUE(backend.SetValue("big.text", KvsDataType{String(text)}).HasValue());
+    ASSERT_TRUE(backend.SetValue("lut.int32", KvsInt32Array{1, 2, 3}).HasValue());
+
+    KvsDataType out{String()};
+    ::lap::core::get<String>(out).reserve(8192);
+    const char* buffer = ::lap::core::get<String>(out).data();
+
+    ASSERT_TRUE(backend.GetValueAssign("big.text", out).HasValue());
+    EXPECT_EQ(::lap::core::get<String>(out), text);
+    EXPECT_EQ(::lap::core::get<String>(out).data(), buffer);
+
+    // Type is taken from the held alternative; a mismatch leaves the value alone
+    auto mismatch = backend.GetValueAssign("lut.int32", out);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+    EXPECT_EQ(::lap::core::get<String>(out), text);
+
+    KvsDataType array{KvsInt32Array(16)};
+    ASSERT_TRUE(backend.GetValueAssign("lut.int32", array).HasValue());
+    EXPECT_EQ(::lap::core::get<KvsInt32Array>(array), (KvsInt32Array{1, 2, 3}));
+}
+
+TEST_F(SqliteBackendEnhancedTest, DataIntegrity_SnapshotReadTransaction) {
+    auto backend = ::std::make_unique<KvsSqliteBackend>("test_sqlite_enhanced");
+    backend->RemoveKey("snap.new");
+    ASSERT_TRUE(backend->SetValue("snap.lut", KvsInt32Array{1, 2, 3}).HasValue());
+    ASSERT_TRUE(backend->SetValue("snap.mode", String("eco")).HasValue());
+
+    auto snapshot = backend->CreateSnapshot();
+    ASSERT_TRUE(snapshot.HasValue());
+    auto view = snapshot.Value();
+    const UInt32 count = view->GetKeyCount().Value();
+
+    // Writers commit while the snapshot's transaction is open
+    ASSERT_TRUE(backend->SetValue("snap.mode", String("sport")).HasValue());
+    ASSERT_TRUE(backend->SetValue("snap.new", Int32(1)).HasValue());
+    ASSERT_TRUE(backend->RemoveKey("snap.lut").HasValue());
+    EXPECT_TRUE(backend->SyncToStorage().HasValue());
+
+    auto mode = view->GetValue("snap.mode");
+    EXPECT_EQ(*::std::get_if<String>(&mode.Value()), "eco");
+    auto lut = view->GetValue("snap.lut");
+    EXPECT_EQ(*::std::get_if<KvsInt32Array>(&lut.Value()), (KvsInt32Array{1, 2, 3}));
+    EXPECT_FALSE(view->KeyExists("snap.new").Value());
+    EXPECT_EQ(view->GetAllKeys().Value().size(), count);
+
+    // The snapshot owns its connection and outlives the backend
+    backend.reset();
+    EXPECT_TRUE(view->KeyExists("snap.lut").Value());
+}
+
+TEST_F(SqliteBackendEnhancedTest, DataIntegrity_AtomicRmwStatements) {
+    KvsSqliteBackend backend("test_sqlite_enhanced");
+
+    // SetIfAbsent never overwrites a live row but revives a soft-deleted one
+    EXPECT_TRUE(backend.SetIfAbsent("rmw.mode", String("eco")).Value());
+    EXPECT_FALSE(backend.SetIfAbsent("rmw.mode", String("sport")).Value());
+    ASSERT_TRUE(backend.RemoveKey("rmw.mode").HasValue());
+    EXPECT_TRUE(backend.SetIfAbsent("rmw.mode", String("sport")).Value());
+    auto mode = backend.GetValue("rmw.mode");
+    EXPECT_EQ(*::std::get_if<String>(&mode.Value()), "sport");
+
+    // CompareExchange matches type and value
+    EXPECT_FALSE(backend.CompareExchange("rmw.mode", KvsDataType{String("eco")}, KvsDataType{String("comfort")}).Value());
+    EXPECT_TRUE(backend.CompareExchange("rmw.mode", KvsDataType{String("sport")}, KvsDataType{Int32(3)}).Value());
+    EXPECT_FALSE(backend.CompareExchange("rmw.mode", KvsDataType{Int64(3)}, KvsDataType{Int32(4)}).Value());
+    auto missing = backend.CompareExchange("rmw.none", KvsDataType{Int32(0)}, KvsDataType{Int32(1)});
+    ASSERT_FALSE(missing.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(missing.Error().Value()), PerErrc::kKeyNotFound);
+
+    ASSERT_TRUE(backend.SetValue("rmw.lut", KvsInt32Array{1, 2}).HasValue());
+    EXPECT_TRUE(backend.CompareExchange("rmw.lut", KvsDataType{KvsInt32Array{1, 2}}, KvsDataType{KvsInt32Array{3}}).Value());
+
+    // FetchAdd on a missing, soft-deleted and existing key
+    auto created = backend.FetchAdd("rmw.odometer", KvsDataType{Double(1.5)});
+    ASSERT_TRUE(created.HasValue());
+    EXPECT_DOUBLE_EQ(*::std::get_if<Double>(&created.Value()), 0.0);
+    auto previous = backend.FetchAdd("rmw.odometer", KvsDataType{Double(2.25)});
+    EXPECT_DOUBLE_EQ(*::std::get_if<Double>(&previous.Value()), 1.5);
+    ASSERT_TRUE(backend.RemoveKey("rmw.odometer").HasValue());
+    auto revived = backend.FetchAdd("rmw.odometer", KvsDataType{Double(4.0)});
+    EXPECT_DOUBLE_EQ(*::std::get_if<Double>(&revived.Value()), 0.0);
+    auto total = backend.GetValue("rmw.odometer");
+    EXPECT_DOUBLE_EQ(*::std::get_if<Double>(&total.Value()), 4.0);
+
+    ASSERT_TRUE(backend.SetValue("rmw.errors", Int16(32767)).HasValue());
+    auto wrapped = backend.FetchAdd("rmw.errors", KvsDataType{Int16(1)});
+    EXPECT_EQ(*::std::get_if<Int16>(&wrapped.Value()), 32767);
+    auto afterWrap = backend.GetValue("rmw.errors");
+    EXPECT_EQ(*::std::get_if<Int16>(&afterWrap.Value()), -32768);
+
+    auto mismatch = backend.FetchAdd("rmw.errors", KvsDataType{Int32(1)});
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+    auto notNumeric = backend.FetchAdd("rmw.text", KvsDataType{String("1")});
+    ASSERT_FALSE(notNumeric.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(notNumeric.Error().Value()), PerErrc::kDataTypeMismatch);
+    EXPECT_FALSE(backend.KeyExists("rmw.text").Value());
+}
+
+TEST_F(SqliteBackendEnhancedTest, BloomFilter_AnswersMissesAndTracksFalsePositives) {
+    KvsSqliteBackend backend("test_sqlite_bloom");
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(backend.SetValue("flag.on." + ::std::to_string(i), KvsDataType{Bool(true)}).HasValue());
+    }
+    auto before = backend.GetBloomFilterStats();
+
+    for (int i = 0; i < 5000; ++i) {
+        ::std::string key = "flag.off." + ::std::to_string(i);
+        EXPECT_FALSE(backend.KeyExists(key).Value());
+        auto miss = backend.GetValue(key);
+        ASSERT_FALSE(miss.HasValue());
+        EXPECT_EQ(static_cast<PerErrc>(miss.Error().Value()), PerErrc::kKeyNotFound);
+    }
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_TRUE(backend.KeyExists("flag.on." + ::std::to_string(i)).Value());
+    }
+
+    auto stats = backend.GetBloomFilterStats();
+    EXPECT_EQ(10500u, stats.lookups - before.lookups);
+    EXPECT_EQ(10000u, (stats.negatives - before.negatives) + (stats.falsePositives - before.falsePositives));
+    EXPECT_LT(stats.FalsePositiveRate(), 0.05);
+    EXPECT_GT(stats.bits, 0u);
+
+    // Removed keys stay in the filter until enough removals trigger a rebuild on sync
+    for (int i = 0; i < 400; ++i) {
+        ASSERT_TRUE(backend.RemoveKey("flag.on." + ::std::to_string(i)).HasValue());
+    }
+    EXPECT_FALSE(backend.KeyExists("flag.on.0").Value());
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    stats = backend.GetBloomFilterStats();
+    EXPECT_EQ(before.rebuilds + 1, stats.rebuilds);
+    EXPECT_EQ(100u, stats.keys);
+}
+
+TEST_F(SqliteBackendEnhancedTest, BloomFilter_SeesCommitsOfOtherConnections) {
+    KvsSqliteBackend writer("test_sqlite_bloom_shared");
+    ASSERT_TRUE(writer.ResetKey("shared.key").HasValue());
+    KvsSqliteBackend reader("test_sqlite_bloom_shared");
+
+    // A miss the reader's filter answered must not hide the other connection's insert
+    EXPECT_FALSE(reader.KeyExists("shared.key").Value());
+    ASSERT_TRUE(writer.SetValue("shared.key", KvsDataType{Int32(7)}).HasValue());
+    EXPECT_TRUE(reader.KeyExists("shared.key").Value());
+    EXPECT_EQ(7, ::std::get<Int32>(reader.GetValue("shared.key").Value()));
+    EXPECT_GT(reader.GetBloomFilterStats().bypassed, 0u);
+}
+
 // ============================================================================
 // Performance Tests
 // ============================================================================
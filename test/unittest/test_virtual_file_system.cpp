@@ -0,0 +1,538 @@
+/**
+ * @file test_virtual_file_system.cpp
+ * @brief Unit tests for IVirtualFileSystem implementations and backend injection
+ * @details Covers CMemoryFileSystem, CFaultInjectionFileSystem (latency, ENOSPC,
+ *          torn writes, halt) and the file-based backends running on top of them
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <lap/core/CCore.hpp>
+#include "CMemoryFileSystem.hpp"
+#include "CFaultInjectionFileSystem.hpp"
+#include "CPosixFileSystem.hpp"
+#include "CKvsFileBackend.hpp"
+#include "CFileStorageBackend.hpp"
+#include "CReplicaManager.hpp"
+#include "CStoragePathManager.hpp"
+
+using namespace lap::core;
+using namespace lap::per;
+
+namespace {
+
+Vector<UInt8> Bytes(const String& text) {
+    return Vector<UInt8>(text.begin(), text.end());
+}
+
+} // namespace
+
+class VirtualFileSystemTest : public ::testing::Test {
+protected:
+    SharedHandle<CMemoryFileSystem> memFs;
+
+    void SetUp() override {
+        memFs = MakeShared<CMemoryFileSystem>();
+    }
+};
+
+// ============================================================================
+// CMemoryFileSystem
+// ============================================================================
+
+TEST_F(VirtualFileSystemTest, Memory_WriteCreatesParentsAndReadsBack) {
+    auto data = Bytes("hello");
+    ASSERT_TRUE(memFs->WriteFile("/a/b/c.txt", data.data(), data.size()).HasValue());
+
+    EXPECT_TRUE(memFs->IsDirectory("/a"));
+    EXPECT_TRUE(memFs->IsDirectory("/a/b/"));
+    EXPECT_TRUE(memFs->Exists("/a//b/c.txt"));
+
+    auto readResult = memFs->ReadFile("/a/b/c.txt");
+    ASSERT_TRUE(readResult.HasValue());
+    EXPECT_EQ(readResult.Value(), data);
+    EXPECT_EQ(memFs->GetFileSize("/a/b/c.txt").Value(), 5u);
+}
+
+TEST_F(VirtualFileSystemTest, Memory_MissingFileReturnsFileNotFound) {
+    auto readResult = memFs->ReadFile("/nope");
+    ASSERT_FALSE(readResult.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(readResult.Error().Value()), PerErrc::kFileNotFound);
+    EXPECT_FALSE(memFs->RemoveFile("/nope").HasValue());
+}
+
+TEST_F(VirtualFileSystemTest, Memory_RenameReplacesDestination) {
+    auto oldData = Bytes("old");
+    auto newData = Bytes("new-content");
+    memFs->WriteFile("/d/current", oldData.data(), oldData.size());
+    memFs->WriteFile("/d/current.tmp", newData.data(), newData.size());
+
+    ASSERT_TRUE(memFs->RenameFile("/d/current.tmp", "/d/current").HasValue());
+    EXPECT_FALSE(memFs->Exists("/d/current.tmp"));
+    EXPECT_EQ(memFs->ReadFile("/d/current").Value(), newData);
+}
+
+TEST_F(VirtualFileSystemTest, Memory_ListFilesReturnsDirectChildrenOnly) {
+    auto data = Bytes("x");
+    memFs->WriteFile("/dir/a", data.data(), data.size());
+    memFs->WriteFile("/dir/b", data.data(), data.size());
+    memFs->WriteFile("/dir/sub/c", data.data(), data.size());
+    memFs->WriteFile("/dir2/d", data.data(), data.size());
+
+    auto files = memFs->ListFiles("/dir");
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0], "a");
+    EXPECT_EQ(files[1], "b");
+    EXPECT_EQ(memFs->GetFileCount(), 4u);
+}
+
+TEST_F(VirtualFileSystemTest, Memory_AppendAndReadRange) {
+    auto head = Bytes("0123");
+    auto tail = Bytes("4567");
+    ASSERT_TRUE(memFs->AppendFile("/log/wal", head.data(), head.size()).HasValue());
+    ASSERT_TRUE(memFs->AppendFile("/log/wal", tail.data(), tail.size()).HasValue());
+    EXPECT_EQ(memFs->GetFileSize("/log/wal").Value(), 8u);
+
+    auto range = memFs->ReadFileRange("/log/wal", 2, 4);
+    ASSERT_TRUE(range.HasValue());
+    EXPECT_EQ(range.Value(), Bytes("2345"));
+
+    auto pastEnd = memFs->ReadFileRange("/log/wal", 6, 4);
+    ASSERT_FALSE(pastEnd.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(pastEnd.Error().Value()), PerErrc::kWrongDataSize);
+    EXPECT_FALSE(memFs->ReadFileRange("/log/none", 0, 1).HasValue());
+}
+
+TEST_F(VirtualFileSystemTest, Memory_WriterTruncatesThenAppends) {
+    auto old = Bytes("old contents");
+    ASSERT_TRUE(memFs->WriteFile("/out/doc", old.data(), old.size()).HasValue());
+
+    auto writer = memFs->OpenWriter("/out/doc");
+    ASSERT_TRUE(writer.HasValue());
+    EXPECT_EQ(memFs->GetFileSize("/out/doc").Value(), 0u);
+
+    auto head = Bytes("new ");
+    auto tail = Bytes("doc");
+    ASSERT_TRUE(writer.Value()->Write(head.data(), head.size()).HasValue());
+    ASSERT_TRUE(writer.Value()->Write(tail.data(), tail.size()).HasValue());
+    ASSERT_TRUE(writer.Value()->Sync().HasValue());
+    EXPECT_EQ(memFs->ReadFile("/out/doc").Value(), Bytes("new doc"));
+}
+
+// ============================================================================
+// CFaultInjectionFileSystem
+// ============================================================================
+
+TEST_F(VirtualFileSystemTest, Fault_WriteBudgetReturnsOutOfStorageSpace) {
+    FaultInjectionConfig config;
+    config.writeBudgetBytes = 8;
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    auto data = Bytes("12345");
+    EXPECT_TRUE(faultFs->WriteFile("/f1", data.data(), data.size()).HasValue());
+
+    auto result = faultFs->WriteFile("/f2", data.data(), data.size());
+    ASSERT_FALSE(result.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(result.Error().Value()), PerErrc::kOutOfStorageSpace);
+
+    // Only the bytes that fit were persisted
+    EXPECT_EQ(memFs->GetFileSize("/f2").Value(), 3u);
+    EXPECT_EQ(faultFs->GetStats().outOfSpaceErrors, 1u);
+}
+
+TEST_F(VirtualFileSystemTest, Fault_TornWritePersistsPrefixAndHalts) {
+    FaultInjectionConfig config;
+    config.tornWriteAt = 2;
+    config.tornWriteFraction = 0.5;
+    config.haltAfterFault = true;
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    auto data = Bytes("0123456789");
+    EXPECT_TRUE(faultFs->WriteFile("/t1", data.data(), data.size()).HasValue());
+    EXPECT_FALSE(faultFs->WriteFile("/t2", data.data(), data.size()).HasValue());
+    EXPECT_EQ(memFs->GetFileSize("/t2").Value(), 5u);
+
+    // Simulated crash: every mutation fails until Reset()
+    EXPECT_TRUE(faultFs->IsHalted());
+    EXPECT_FALSE(faultFs->WriteFile("/t3", data.data(), data.size()).HasValue());
+    EXPECT_FALSE(faultFs->RemoveFile("/t1").HasValue());
+    EXPECT_TRUE(faultFs->ReadFile("/t1").HasValue());
+
+    faultFs->Reset();
+    EXPECT_FALSE(faultFs->IsHalted());
+    EXPECT_TRUE(faultFs->WriteFile("/t3", data.data(), data.size()).HasValue());
+}
+
+TEST_F(VirtualFileSystemTest, Fault_WriterTearsOneWriteAndHalts) {
+    FaultInjectionConfig config;
+    config.tornWriteAt = 2;
+    config.tornWriteFraction = 0.5;
+    config.haltAfterFault = true;
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    auto writer = faultFs->OpenWriter("/doc");
+    ASSERT_TRUE(writer.HasValue());
+    auto data = Bytes("abcd");
+    EXPECT_TRUE(writer.Value()->Write(data.data(), data.size()).HasValue());
+    EXPECT_FALSE(writer.Value()->Write(data.data(), data.size()).HasValue());
+    EXPECT_EQ(memFs->ReadFile("/doc").Value(), Bytes("abcdab"));
+
+    // Halted: the flush fails like any other mutation
+    EXPECT_FALSE(writer.Value()->Sync().HasValue());
+    EXPECT_FALSE(faultFs->OpenWriter("/other").HasValue());
+    EXPECT_EQ(faultFs->GetStats().tornWrites, 1u);
+}
+
+TEST_F(VirtualFileSystemTest, Fault_PathFilterAndLatency) {
+    FaultInjectionConfig config;
+    config.tornWriteProbability = 1.0;
+    config.pathFilter = "/victim/";
+    config.writeLatencyUs = 100;
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    auto data = Bytes("abcd");
+    EXPECT_TRUE(faultFs->WriteFile("/safe/x", data.data(), data.size()).HasValue());
+    EXPECT_FALSE(faultFs->WriteFile("/victim/x", data.data(), data.size()).HasValue());
+
+    auto stats = faultFs->GetStats();
+    EXPECT_EQ(stats.writes, 2u);
+    EXPECT_EQ(stats.tornWrites, 1u);
+    EXPECT_EQ(stats.injectedDelayUs, 100u);
+}
+
+// ============================================================================
+// Backend Injection
+// ============================================================================
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_RunsOnMemoryFileSystem) {
+    String instancePath = CStoragePathManager::getKvsInstancePath("vfs_kvs_memory");
+    {
+        KvsFileBackend backend("vfs_kvs_memory", memFs);
+        ASSERT_TRUE(backend.available());
+        ASSERT_TRUE(backend.SetValue("answer", Int32(42)).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+
+    EXPECT_TRUE(memFs->Exists(instancePath + "/current/kvs_data.json"));
+    EXPECT_TRUE(memFs->IsDirectory(instancePath + "/recovery"));
+
+    KvsFileBackend reopened("vfs_kvs_memory", memFs);
+    auto value = reopened.GetValue("answer");
+    ASSERT_TRUE(value.HasValue());
+    ASSERT_NE(::std::get_if<Int32>(&value.Value()), nullptr);
+    EXPECT_EQ(*::std::get_if<Int32>(&value.Value()), 42);
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_TornCommitKeepsCurrentIntact) {
+    String currentPath = CStoragePathManager::getKvsInstancePath("vfs_kvs_torn") + "/current/kvs_data.json";
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs);
+    {
+        KvsFileBackend backend("vfs_kvs_torn", faultFs);
+        backend.SetValue("key", String("v1"));
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+    auto committed = memFs->ReadFile(currentPath).Value();
+
+    // Tear the temp file written right before the atomic rename, then "crash"
+    FaultInjectionConfig config;
+    config.pathFilter = "kvs_data.json.tmp";
+    config.tornWriteAt = 1;
+    config.haltAfterFault = true;
+    faultFs->SetConfig(config);
+    {
+        KvsFileBackend backend("vfs_kvs_torn", faultFs);
+        backend.SetValue("key", String("v2-with-a-much-longer-value"));
+        EXPECT_FALSE(backend.SyncToStorage().HasValue());
+    }
+    EXPECT_EQ(faultFs->GetStats().tornWrites, 1u);
+    EXPECT_EQ(memFs->ReadFile(currentPath).Value(), committed);
+
+    // Reboot on the surviving storage
+    KvsFileBackend rebooted("vfs_kvs_torn", memFs);
+    auto value = rebooted.GetValue("key");
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(*::std::get_if<String>(&value.Value()), "v1");
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_SyncSurfacesOutOfStorageSpace) {
+    FaultInjectionConfig config;
+    config.writeBudgetBytes = 4;
+    config.pathFilter = "/update/";
+    auto faultFs = MakeShared<CFaultInjectionFileSystem>(memFs, config);
+
+    KvsFileBackend backend("vfs_kvs_enospc", faultFs);
+    backend.SetValue("key", String("value"));
+    auto result = backend.SyncToStorage();
+    ASSERT_FALSE(result.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(result.Error().Value()), PerErrc::kOutOfStorageSpace);
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_BudgetedSyncWritesThePinnedState) {
+    KvsFileBackend backend("vfs_kvs_pinned", memFs);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(backend.SetValue("pin.key" + ::std::to_string(100 + i), Int32(1)).HasValue());
+    }
+
+    // Every key is rewritten between the units of the sync: none of it may reach the file
+    KvsSyncBudget budget;
+    budget.records = 4;
+    budget.bytes = 256;
+    int calls = 0;
+    for (bool complete = false; !complete && calls < 1000; ++calls) {
+        KvsSyncMeter meter(budget);
+        auto progress = backend.SyncToStorage(meter);
+        ASSERT_TRUE(progress.HasValue());
+        complete = progress.Value().complete;
+        for (int i = 0; i < 64; ++i) {
+            ASSERT_TRUE(backend.SetValue("pin.key" + ::std::to_string(100 + i), Int32(calls + 2)).HasValue());
+        }
+    }
+    EXPECT_GT(calls, 64 / 4);
+
+    KvsFileBackend committed("vfs_kvs_pinned", memFs);
+    ASSERT_EQ(committed.GetKeyCount().Value(), 64u);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(::std::get<Int32>(committed.GetValue("pin.key" + ::std::to_string(100 + i)).Value()), 1);
+    }
+
+    // The writes made during the sync are left for the next one
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    KvsFileBackend next("vfs_kvs_pinned", memFs);
+    EXPECT_EQ(::std::get<Int32>(next.GetValue("pin.key100").Value()), calls + 1);
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_KeyHandleSurvivesReload) {
+    KvsFileBackend backend("vfs_kvs_handle", memFs);
+    backend.SetValue("mode", String("eco"));
+    ASSERT_TRUE(backend.SyncToStorage().HasValue());
+
+    KvsKeyHandle handle("mode");
+    backend.ResolveKey(handle);
+    EXPECT_TRUE(handle.IsResolved());
+
+    ASSERT_TRUE(backend.SetValueResolved(handle, String("sport")).HasValue());
+    auto updated = backend.GetValue("mode");
+    EXPECT_EQ(*::std::get_if<String>(&updated.Value()), "sport");
+
+    // Reload replaces every JSON member, the handle must not touch the freed one
+    ASSERT_TRUE(backend.DiscardPendingChanges().HasValue());
+    auto value = backend.GetValueResolved(handle);
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(*::std::get_if<String>(&value.Value()), "eco");
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_BlobIsBase64OnlyInTheFile) {
+    const String currentPath = CStoragePathManager::getKvsInstancePath("vfs_kvs_blob") + "/current/kvs_data.json";
+    const KvsBlob blob{0x00, 0x01, 0xFE, 0xFF, 0x22};
+    {
+        KvsFileBackend backend("vfs_kvs_blob", memFs);
+        ASSERT_TRUE(backend.SetValue("blob", KvsDataType{blob}).HasValue());
+
+        Byte buffer[8] = {};
+        auto copied = backend.GetValueInto("blob", EKvsDataTypeIndicate::DataType_blob, Span<Byte>(buffer, sizeof(buffer)));
+        ASSERT_TRUE(copied.HasValue());
+        EXPECT_EQ(KvsBlob(buffer, buffer + copied.Value()), blob);
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+
+    auto file = memFs->ReadFile(currentPath).Value();
+    EXPECT_NE(String(file.begin(), file.end()).find(kvsBlobToBase64(blob.data(), blob.size())), String::npos);
+
+    KvsFileBackend reopened("vfs_kvs_blob", memFs);
+    auto value = reopened.GetValue("blob");
+    ASSERT_TRUE(value.HasValue());
+    EXPECT_EQ(::std::get<KvsBlob>(value.Value()), blob);
+
+    // Invalid base64 is rejected at load, not at the first read
+    const auto corrupt = Bytes("{\"blob\": {\"type\":\"m\",\"value\":\"A*==\"}}");
+    memFs->WriteFile(currentPath, corrupt.data(), corrupt.size());
+    EXPECT_FALSE(reopened.DiscardPendingChanges().HasValue());
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_ArraysAreLittleEndianInTheFile) {
+    const String currentPath = CStoragePathManager::getKvsInstancePath("vfs_kvs_array") + "/current/kvs_data.json";
+    {
+        KvsFileBackend backend("vfs_kvs_array", memFs);
+        ASSERT_TRUE(backend.SetValue("u16", KvsDataType{KvsUInt16Array{0x0102, 0xA0B0}}).HasValue());
+        ASSERT_TRUE(backend.SetValue("f64", KvsDataType{KvsDoubleArray{1.5, -2.0}}).HasValue());
+        ASSERT_TRUE(backend.SyncToStorage().HasValue());
+    }
+
+    // Elements are written little-endian whatever the host order
+    const Byte littleEndian[] = {0x02, 0x01, 0xB0, 0xA0};
+    auto file = memFs->ReadFile(currentPath).Value();
+    EXPECT_NE(String(file.begin(), file.end()).find(kvsBlobToBase64(littleEndian, sizeof(littleEndian))), String::npos);
+
+    KvsFileBackend reopened("vfs_kvs_array", memFs);
+    EXPECT_EQ(::std::get<KvsUInt16Array>(reopened.GetValue("u16").Value()), (KvsUInt16Array{0x0102, 0xA0B0}));
+    EXPECT_EQ(::std::get<KvsDoubleArray>(reopened.GetValue("f64").Value()), (KvsDoubleArray{1.5, -2.0}));
+
+    // A length that is no multiple of the element size is rejected at load
+    const auto corrupt = Bytes("{\"u16\": {\"type\":\"p\",\"value\":\"AgEC\"}}");
+    memFs->WriteFile(currentPath, corrupt.data(), corrupt.size());
+    EXPECT_FALSE(reopened.DiscardPendingChanges().HasValue());
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_GetValueAssignReusesVectors) {
+    KvsFileBackend backend("vfs_kvs_assign", memFs);
+    ASSERT_TRUE(backend.SetValue("lut", KvsDataType{KvsFloatArray{0.5f, 1.5f, 2.5f}}).HasValue());
+    ASSERT_TRUE(backend.SetValue("blob", KvsDataType{KvsBlob{7, 8, 9}}).HasValue());
+
+    KvsDataType array{KvsFloatArray(64)};
+    const Float* elements = ::std::get<KvsFloatArray>(array).data();
+    ASSERT_TRUE(backend.GetValueAssign("lut", array).HasValue());
+    EXPECT_EQ(::std::get<KvsFloatArray>(array), (KvsFloatArray{0.5f, 1.5f, 2.5f}));
+    EXPECT_EQ(::std::get<KvsFloatArray>(array).data(), elements);
+
+    KvsDataType blob{KvsBlob(64)};
+    const Byte* bytes = ::std::get<KvsBlob>(blob).data();
+    ASSERT_TRUE(backend.GetValueAssign("blob", blob).HasValue());
+    EXPECT_EQ(::std::get<KvsBlob>(blob), (KvsBlob{7, 8, 9}));
+    EXPECT_EQ(::std::get<KvsBlob>(blob).data(), bytes);
+
+    auto mismatch = backend.GetValueAssign("blob", array);
+    ASSERT_FALSE(mismatch.HasValue());
+    EXPECT_EQ(static_cast<PerErrc>(mismatch.Error().Value()), PerErrc::kDataTypeMismatch);
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_SnapshotsLayerChangesOverASharedBase) {
+    KvsFileBackend backend("vfs_kvs_layers", memFs);
+    auto keyName = [](int i) { return "layer.key." + ::std::to_string(i); };
+
+    // More keys than one chunk, so the first base is copied in several
+    ::std::map<String, Int32> model;
+    for (int i = 0; i < 2500; ++i) {
+        ASSERT_TRUE(backend.SetValue(keyName(i), KvsDataType(Int32(i))).HasValue());
+        model[keyName(i)] = i;
+    }
+    auto matches = [](const SharedHandle<IKvsSnapshot>& view, const ::std::map<String, Int32>& expected) {
+        auto keys = view->GetAllKeys().Value();
+        if (keys.size() != expected.size() || view->GetKeyCount().Value() != expected.size()) return false;
+        auto key = keys.begin();
+        for (const auto& entry : expected) {
+            if (*key++ != entry.first) return false;
+            if (::std::get<Int32>(view->GetValue(entry.first).Value()) != entry.second) return false;
+        }
+        return true;
+    };
+
+    auto first = backend.CreateSnapshot().Value();
+    const auto firstModel = model;
+
+    // Enough rounds to merge the layers into a new base more than once
+    for (int round = 1; round <= 24; ++round) {
+        for (int i = round; i < 2500; i += 97) {
+            backend.SetValue(keyName(i), KvsDataType(Int32(-round)));
+            model[keyName(i)] = -round;
+        }
+        backend.RemoveKey(keyName(round * 53));
+        model.erase(keyName(round * 53));
+        backend.SetValue(keyName(10000 + round), KvsDataType(Int32(round)));
+        model[keyName(10000 + round)] = round;
+
+        auto view = backend.CreateSnapshot().Value();
+        ASSERT_TRUE(matches(view, model)) << "round " << round;
+        EXPECT_FALSE(view->KeyExists(keyName(round * 53)).Value());
+    }
+    EXPECT_TRUE(matches(first, firstModel));
+
+    // A clear starts the layers over from an empty base
+    ASSERT_TRUE(backend.RemoveAllKeys().HasValue());
+    backend.SetValue("after.clear", KvsDataType(Int32(1)));
+    auto cleared = backend.CreateSnapshot().Value();
+    EXPECT_TRUE(matches(cleared, {{"after.clear", 1}}));
+    EXPECT_TRUE(matches(first, firstModel));
+}
+
+TEST_F(VirtualFileSystemTest, KvsFileBackend_SnapshotCopiedInChunksIsNeverTorn) {
+    KvsFileBackend backend("vfs_kvs_chunks", memFs);
+    constexpr int kKeys = 3000;
+    auto keyName = [](int i) { return "chunk.row." + ::std::to_string(10000 + i); };
+    for (int i = 0; i < kKeys; ++i) {
+        backend.SetValue(keyName(i), KvsDataType(Int64(0)));
+    }
+
+    // Writes land between the chunks of the first copy; the keys they changed are
+    // applied on top, so every view is still generation g on a prefix, g - 1 after
+    ::std::atomic<bool> stop{false};
+    ::std::thread writer([&]() {
+        for (Int64 generation = 1; !stop.load(); ++generation) {
+            for (int i = 0; i < kKeys; ++i) {
+                backend.SetValue(keyName(i), KvsDataType(generation));
+            }
+        }
+    });
+
+    for (int round = 0; round < 10; ++round) {
+        auto view = backend.CreateSnapshot().Value();
+        ASSERT_EQ(static_cast<UInt32>(kKeys), view->GetKeyCount().Value());
+        Int64 first = ::std::get<Int64>(view->GetValue(keyName(0)).Value());
+        Int64 previous = first;
+        for (int i = 1; i < kKeys; ++i) {
+            Int64 value = ::std::get<Int64>(view->GetValue(keyName(i)).Value());
+            EXPECT_LE(value, previous);
+            EXPECT_GE(value, first - 1);
+            previous = value;
+        }
+    }
+
+    stop = true;
+    writer.join();
+}
+
+TEST_F(VirtualFileSystemTest, FileStorageBackend_RunsOnMemoryFileSystem) {
+    CFileStorageBackend backend("/vfs/fs/instance", memFs);
+
+    Vector<Byte> data = {Byte{0x01}, Byte{0x02}, Byte{0x03}};
+    ASSERT_TRUE(backend.WriteFile("blob.bin", data).HasValue());
+    ASSERT_TRUE(backend.CopyFile("blob.bin", "current", "backup").HasValue());
+
+    EXPECT_TRUE(memFs->Exists("/vfs/fs/instance/backup/blob.bin"));
+    EXPECT_EQ(backend.GetFileSize("blob.bin").Value(), 3u);
+    EXPECT_EQ(backend.ListFiles().Value().size(), 1u);
+
+    auto readResult = backend.ReadFile("blob.bin", "backup");
+    ASSERT_TRUE(readResult.HasValue());
+    EXPECT_EQ(readResult.Value(), data);
+}
+
+TEST_F(VirtualFileSystemTest, ReplicaManager_RepairsTornReplicaOnMemoryFileSystem) {
+    CReplicaManager replicas("/vfs/replicas", 3, 2, ChecksumType::kCRC32, memFs);
+
+    auto data = Bytes("replicated payload");
+    ASSERT_TRUE(replicas.Write("cfg", data.data(), data.size()).HasValue());
+    EXPECT_EQ(replicas.ListFiles().Value().size(), 1u);
+
+    // Truncate one replica behind the manager's back
+    memFs->WriteFile("/vfs/replicas/cfg.replica_1", data.data(), data.size() / 2);
+
+    auto readResult = replicas.Read("cfg");
+    ASSERT_TRUE(readResult.HasValue());
+    EXPECT_EQ(readResult.Value(), data);
+
+    auto repaired = replicas.Repair("cfg");
+    ASSERT_TRUE(repaired.HasValue());
+    EXPECT_EQ(memFs->ReadFile("/vfs/replicas/cfg.replica_1").Value(), data);
+}
+
+TEST_F(VirtualFileSystemTest, Posix_DefaultIsShared) {
+    auto first = IVirtualFileSystem::getDefault();
+    auto second = IVirtualFileSystem::getDefault();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first.get(), second.get());
+}
+
+TEST_F(VirtualFileSystemTest, Posix_AppendCreatesThenExtends) {
+    CPosixFileSystem posixFs;
+    const String dir = "/tmp/test_vfs_posix_append";
+    posixFs.RemoveFile(dir + "/log");
+
+    auto head = Bytes("0123");
+    auto tail = Bytes("4567");
+    ASSERT_TRUE(posixFs.AppendFile(dir + "/log", head.data(), head.size()).HasValue());
+    ASSERT_TRUE(posixFs.AppendFile(dir + "/log", tail.data(), tail.size()).HasValue());
+    EXPECT_EQ(posixFs.ReadFile(dir + "/log").Value(), Bytes("01234567"));
+    EXPECT_TRUE(posixFs.RemoveFile(dir + "/log").HasValue());
+}
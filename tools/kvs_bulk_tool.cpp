@@ -0,0 +1,271 @@
+/**
+ * @file kvs_bulk_tool.cpp
+ * @brief Bulk export, import and conversion of KVS instances
+ * @details Moves whole stores through IKvsBackend::Export() / Import() in the
+ *          shared record format of CKvsRecordStream.hpp, for end-of-line
+ *          provisioning and for migrating an instance to another backend.
+ *
+ * Usage:
+ *   kvs_bulk_tool export  <backend> <instance> <file>  [options]
+ *   kvs_bulk_tool import  <backend> <instance> <file>  [options]
+ *   kvs_bulk_tool convert <backend> <instance> <backend> <instance>  [options]
+ *   kvs_bulk_tool info    <file>
+ *
+ *   backend:  file | sqlite | lsm | mmap | property (File persistence)
+ *   options:  --clear           remove all keys of the target first
+ *             --no-bulk         one SQLite transaction per batch, no pre-sizing
+ *             --batch N         records per batch (default 4096)
+ *             --shm-size MiB    shared memory of a property target (default 64)
+ *             --shared-db NAME  SQLite instances live in the shared database NAME
+ *
+ * Instances are opened by their identifier, as KeyValueStorage does, below
+ * the KVS root of CStoragePathManager. An instance with a shard manifest is
+ * opened sharded, with the backend and shard count recorded in it; any other
+ * backend is refused for it. Imports end with SyncToStorage().
+ */
+
+#include "CKvsFileBackend.hpp"
+#include "CKvsLsmBackend.hpp"
+#include "CKvsMmapBackend.hpp"
+#include "CKvsPropertyBackend.hpp"
+#include "CKvsRecordStream.hpp"
+#include "CKvsShardedBackend.hpp"
+#include "CKvsSqliteBackend.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace lap::per;
+using namespace lap::per::util;
+using namespace lap::core;
+
+struct ToolOptions {
+    KvsImportOptions import;
+    Size shmSize = 64ul << 20;
+    ::std::string sharedDatabase;
+};
+
+/**
+ * @brief Open a sharded instance with the layout of its manifest, as KeyValueStorage does
+ * @note Opened as one backend, its shards would not be read and an import would be
+ *       removed as a leftover of the migration the next time it opens sharded
+ */
+static ::std::unique_ptr<IKvsBackend> OpenSharded(const ::std::string& backend, const ::std::string& instance,
+                                                  const ToolOptions& options) {
+    KvsBackendType shardBackend = KvsBackendType::kvsFile;
+    UInt32 shardCount = 0;
+    auto manifest = KvsShardedBackend::ReadManifest(instance.c_str(), shardBackend, shardCount);
+    if (!manifest.HasValue()) {
+        ::std::cerr << "Shard manifest of " << instance << " unreadable: " << manifest.Error().Message().data() << ::std::endl;
+        return nullptr;
+    }
+
+    const char* recorded = shardBackend == KvsBackendType::kvsSqlite ? "sqlite" : "file";
+    if (backend != recorded) {
+        ::std::cerr << "Instance " << instance << " has " << shardCount << " " << recorded << " shards, refused to open it as "
+                    << backend << ::std::endl;
+        return nullptr;
+    }
+    if (!options.sharedDatabase.empty()) {
+        ::std::cerr << "Instance " << instance << " is sharded, its shards have no shared database" << ::std::endl;
+        return nullptr;
+    }
+    return ::std::unique_ptr<IKvsBackend>(new KvsShardedBackend(instance.c_str(), shardBackend, shardCount));
+}
+
+static ::std::unique_ptr<IKvsBackend> OpenBackend(const ::std::string& backend, const ::std::string& instance,
+                                                  const ToolOptions& options) {
+    try {
+        if (KvsShardedBackend::IsSharded(instance.c_str())) return OpenSharded(backend, instance, options);
+
+        if (backend == "file") return ::std::unique_ptr<IKvsBackend>(new KvsFileBackend(instance.c_str()));
+        if (backend == "sqlite") {
+            return ::std::unique_ptr<IKvsBackend>(new KvsSqliteBackend(instance.c_str(), options.sharedDatabase.c_str()));
+        }
+        if (backend == "lsm") return ::std::unique_ptr<IKvsBackend>(new KvsLsmBackend(instance.c_str()));
+        if (backend == "mmap") return ::std::unique_ptr<IKvsBackend>(new KvsMmapBackend(instance.c_str()));
+        if (backend == "property") {
+            return ::std::unique_ptr<IKvsBackend>(
+                new KvsPropertyBackend(instance.c_str(), KvsBackendType::kvsFile, options.shmSize));
+        }
+        ::std::cerr << "Unknown backend: " << backend << ::std::endl;
+    } catch (const ::std::exception& e) {
+        ::std::cerr << "Failed to open " << backend << " instance " << instance << ": " << e.what() << ::std::endl;
+        return nullptr;
+    }
+    return nullptr;
+}
+
+static bool Available(const ::std::unique_ptr<IKvsBackend>& backend, const ::std::string& instance) {
+    if (backend && backend->available()) return true;
+    if (backend) ::std::cerr << "Instance not available: " << instance << ::std::endl;
+    return false;
+}
+
+static const char* ErrorText(const ErrorCode& error) {
+    return error.Message().data();
+}
+
+class Stopwatch {
+public:
+    Stopwatch() : m_start(::std::chrono::steady_clock::now()) {}
+    double Seconds() const {
+        return ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    ::std::chrono::steady_clock::time_point m_start;
+};
+
+static void Report(const char* what, UInt64 records, const Stopwatch& watch) {
+    const double seconds = watch.Seconds();
+    ::std::cout << what << " " << records << " records in " << seconds << " s";
+    if (seconds > 0) ::std::cout << " (" << static_cast<UInt64>(records / seconds) << " records/s)";
+    ::std::cout << ::std::endl;
+}
+
+/**
+ * @brief Import from a source and make the result durable
+ */
+static int ImportInto(IKvsBackend& target, IKvsRecordSource& source, const ToolOptions& options) {
+    Stopwatch watch;
+    auto imported = target.Import(source, options.import);
+    if (!imported.HasValue()) {
+        ::std::cerr << "Import failed: " << ErrorText(imported.Error()) << ::std::endl;
+        return 1;
+    }
+    auto synced = target.SyncToStorage();
+    if (!synced.HasValue()) {
+        ::std::cerr << "Sync failed: " << ErrorText(synced.Error()) << ::std::endl;
+        return 1;
+    }
+    Report("Imported", imported.Value(), watch);
+    return 0;
+}
+
+static int Export(const ::std::string& backend, const ::std::string& instance, const ::std::string& file,
+                  const ToolOptions& options) {
+    auto source = OpenBackend(backend, instance, options);
+    if (!Available(source, instance)) return 1;
+
+    KvsRecordFileWriter writer(nullptr, file);
+    Stopwatch watch;
+    auto exported = source->Export(writer, options.import.batchSize);
+    if (!exported.HasValue()) {
+        ::std::cerr << "Export failed: " << ErrorText(exported.Error()) << ::std::endl;
+        return 1;
+    }
+    Report("Exported", exported.Value(), watch);
+    return 0;
+}
+
+static int Import(const ::std::string& backend, const ::std::string& instance, const ::std::string& file,
+                  const ToolOptions& options) {
+    auto target = OpenBackend(backend, instance, options);
+    if (!Available(target, instance)) return 1;
+
+    KvsRecordFileReader reader(nullptr, file);
+    return ImportInto(*target, reader, options);
+}
+
+static int Convert(const ::std::string& fromBackend, const ::std::string& fromInstance,
+                   const ::std::string& toBackend, const ::std::string& toInstance, const ToolOptions& options) {
+    KvsRecordBuffer buffer;
+    {
+        // Closed before the target opens, the two may share the instance directory
+        auto source = OpenBackend(fromBackend, fromInstance, options);
+        if (!Available(source, fromInstance)) return 1;
+
+        Stopwatch watch;
+        auto exported = source->Export(buffer, options.import.batchSize);
+        if (!exported.HasValue()) {
+            ::std::cerr << "Export failed: " << ErrorText(exported.Error()) << ::std::endl;
+            return 1;
+        }
+        Report("Exported", exported.Value(), watch);
+    }
+
+    auto target = OpenBackend(toBackend, toInstance, options);
+    if (!Available(target, toInstance)) return 1;
+    return ImportInto(*target, buffer, options);
+}
+
+static int Info(const ::std::string& file, const ToolOptions& options) {
+    KvsRecordFileReader reader(nullptr, file);
+    KvsRecordBatch batch;
+    UInt64 records = 0;
+    UInt64 bytes = 0;
+    for (;;) {
+        auto read = reader.Read(batch, options.import.batchSize);
+        if (!read.HasValue()) {
+            ::std::cerr << file << ": " << ErrorText(read.Error()) << " (after " << records << " records)" << ::std::endl;
+            return 1;
+        }
+        if (read.Value() == 0) break;
+        for (const auto& record : batch) {
+            const Byte* data = nullptr;
+            Size size = 0;
+            kvsValueBytes(record.value, data, size);
+            bytes += record.key.size() + size;
+        }
+        records += batch.size();
+    }
+    ::std::cout << file << ": " << records << " records (expected " << reader.ExpectedRecords() << "), "
+                << bytes << " bytes of keys and values, checksums valid" << ::std::endl;
+    return 0;
+}
+
+static bool ParseOptions(int argc, char* argv[], int first, ToolOptions& options) {
+    for (int i = first; i < argc; ++i) {
+        const ::std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--clear") {
+            options.import.clearFirst = true;
+        } else if (arg == "--no-bulk") {
+            options.import.bulkLoad = false;
+        } else if (arg == "--batch" && hasValue) {
+            options.import.batchSize = static_cast<Size>(::std::max(1L, ::std::atol(argv[++i])));
+        } else if (arg == "--shm-size" && hasValue) {
+            options.shmSize = static_cast<Size>(::std::max(1L, ::std::atol(argv[++i]))) << 20;
+        } else if (arg == "--shared-db" && hasValue) {
+            options.sharedDatabase = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int Usage(const char* program) {
+    ::std::cerr << "Usage: " << program << " export  <backend> <instance> <file>  [options]\n"
+                << "       " << program << " import  <backend> <instance> <file>  [options]\n"
+                << "       " << program << " convert <backend> <instance> <backend> <instance>  [options]\n"
+                << "       " << program << " info    <file>\n"
+                << "backend: file | sqlite | lsm | mmap | property\n"
+                << "options: --clear --no-bulk --batch N --shm-size MiB --shared-db NAME" << ::std::endl;
+    return 2;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) return Usage(argv[0]);
+
+    const ::std::string command = argv[1];
+    ToolOptions options;
+
+    if (command == "export" && argc >= 5 && ParseOptions(argc, argv, 5, options)) {
+        return Export(argv[2], argv[3], argv[4], options);
+    }
+    if (command == "import" && argc >= 5 && ParseOptions(argc, argv, 5, options)) {
+        return Import(argv[2], argv[3], argv[4], options);
+    }
+    if (command == "convert" && argc >= 6 && ParseOptions(argc, argv, 6, options)) {
+        return Convert(argv[2], argv[3], argv[4], argv[5], options);
+    }
+    if (command == "info" && ParseOptions(argc, argv, 3, options)) {
+        return Info(argv[2], options);
+    }
+    return Usage(argv[0]);
+}